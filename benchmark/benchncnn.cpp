@@ -40,6 +40,23 @@ static bool g_enable_cooling_down = true;
 static ncnn::UnlockedPoolAllocator g_blob_pool_allocator;
 static ncnn::PoolAllocator g_workspace_pool_allocator;
 
+// layers on parallel branches allocate blobs concurrently
+static ncnn::PoolAllocator g_blob_locked_pool_allocator;
+
+#if NCNN_THREADS
+// busy threads competing with the inference threads for cpu time
+static volatile int g_contention_quit = 0;
+
+static void* contention_spin(void* /*args*/)
+{
+    while (!g_contention_quit)
+    {
+    }
+
+    return 0;
+}
+#endif // NCNN_THREADS
+
 #if NCNN_VULKAN
 static ncnn::VulkanDevice* g_vkdev = 0;
 static ncnn::VkAllocator* g_blob_vkallocator = 0;
@@ -58,6 +75,7 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
 
     g_blob_pool_allocator.clear();
     g_workspace_pool_allocator.clear();
+    g_blob_locked_pool_allocator.clear();
 
 #if NCNN_VULKAN
     if (opt.use_vulkan_compute)
@@ -140,6 +158,7 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
     double time_min = DBL_MAX;
     double time_max = -DBL_MAX;
     double time_avg = 0;
+    size_t blob_arena_size = 0;
 
     for (int i = 0; i < g_loop_count; i++)
     {
@@ -157,6 +176,8 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
                 ncnn::Mat out;
                 ex.extract(output_names[j], out);
             }
+
+            blob_arena_size = ex.blob_arena_size();
         }
 
         double end = ncnn::get_current_time();
@@ -170,7 +191,19 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
 
     time_avg /= g_loop_count;
 
-    fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f\n", comment, time_min, time_max, time_avg);
+    fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f", comment, time_min, time_max, time_avg);
+    if (opt.use_blob_arena)
+    {
+        fprintf(stderr, "  arena = %7.2fMB", blob_arena_size / 1048576.0);
+    }
+    if (net.numa_replica_size() > 0)
+    {
+        // extractors take the nodes in turn, without replicas the ones off node 0 read all weights across nodes
+        const int numa_node_count = ncnn::get_numa_node_count();
+        const double numa_saved = net.numa_replica_size() / 1048576.0 * (numa_node_count - 1) / numa_node_count;
+        fprintf(stderr, "  numa_saved = %7.2fMB", numa_saved);
+    }
+    fprintf(stderr, "\n");
 }
 
 void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& opt, bool fixed_path = true)
@@ -180,11 +213,136 @@ void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& op
     return benchmark(comment, inputs, opt, fixed_path);
 }
 
+static void decode_sequence(const ncnn::Net& net, int embed_dim, int num_heads, int prompt_len, int decode_len, double& prefill_time, double& decode_time)
+{
+    // the hidden state is the last input and output, the past key value pairs come before it
+    const std::vector<const char*>& input_names = net.input_names();
+    const std::vector<const char*>& output_names = net.output_names();
+
+    // caches with zero rows start a new sequence, reserve room for the whole sequence up front
+    std::vector<ncnn::Mat> caches(input_names.size() - 1);
+    for (size_t j = 0; j < caches.size(); j++)
+    {
+        caches[j].create(embed_dim / num_heads, prompt_len + decode_len, num_heads);
+        caches[j].h = 0;
+    }
+
+    double start = ncnn::get_current_time();
+
+    for (int i = 0; i <= decode_len; i++)
+    {
+        // prompt prefill, then one token per step
+        ncnn::Mat in(embed_dim, i == 0 ? prompt_len : 1);
+        in.fill(0.01f);
+
+        ncnn::Extractor ex = net.create_extractor();
+        for (size_t j = 0; j < caches.size(); j++)
+        {
+            ex.input(input_names[j], caches[j]);
+        }
+        ex.input(input_names[caches.size()], in);
+
+        // the updated caches are fed back to the next step and appended in place
+        for (size_t j = 0; j < caches.size(); j++)
+        {
+            ex.extract(output_names[j], caches[j]);
+        }
+
+        ncnn::Mat out;
+        ex.extract(output_names[caches.size()], out);
+
+        if (i == 0)
+        {
+            double end = ncnn::get_current_time();
+            prefill_time = end - start;
+            start = end;
+        }
+    }
+
+    decode_time = ncnn::get_current_time() - start;
+}
+
+void benchmark_decode(const char* comment, int embed_dim, int num_heads, int prompt_len, int decode_len, const ncnn::Option& opt)
+{
+    g_blob_pool_allocator.clear();
+    g_workspace_pool_allocator.clear();
+    g_blob_locked_pool_allocator.clear();
+
+#if NCNN_VULKAN
+    if (opt.use_vulkan_compute)
+    {
+        g_blob_vkallocator->clear();
+        g_staging_vkallocator->clear();
+    }
+#endif // NCNN_VULKAN
+
+    ncnn::Net net;
+
+    net.opt = opt;
+
+#if NCNN_VULKAN
+    if (net.opt.use_vulkan_compute)
+    {
+        net.set_vulkan_device(g_vkdev);
+    }
+#endif // NCNN_VULKAN
+
+    char parampath[256];
+    sprintf(parampath, MODEL_DIR "%s.param", comment);
+    net.load_param(parampath);
+
+    DataReaderFromEmpty dr;
+    net.load_model(dr);
+
+    if (net.input_names().size() != net.output_names().size())
+    {
+        fprintf(stderr, "%s has %ld inputs while %ld outputs\n", comment, net.input_names().size(), net.output_names().size());
+        return;
+    }
+
+    if (g_enable_cooling_down)
+    {
+        // sleep 10 seconds for cooling down SOC  :(
+        ncnn::sleep(10 * 1000);
+    }
+
+    // warm up
+    {
+        double prefill_time;
+        double decode_time;
+        decode_sequence(net, embed_dim, num_heads, prompt_len, decode_len, prefill_time, decode_time);
+    }
+
+    double prefill_time_avg = 0;
+    double decode_time_avg = 0;
+
+    for (int i = 0; i < g_loop_count; i++)
+    {
+        double prefill_time;
+        double decode_time;
+        decode_sequence(net, embed_dim, num_heads, prompt_len, decode_len, prefill_time, decode_time);
+
+        prefill_time_avg += prefill_time;
+        decode_time_avg += decode_time;
+    }
+
+    prefill_time_avg /= g_loop_count;
+    decode_time_avg /= g_loop_count;
+
+    fprintf(stderr, "%20s  prefill = %7.2f  decode = %7.2f  tokens/s = %7.2f\n", comment, prefill_time_avg, decode_time_avg, decode_len * 1000.0 / decode_time_avg);
+}
+
 void show_usage()
 {
     fprintf(stderr, "Usage: benchncnn [loop count] [num threads] [powersave] [gpu device] [cooling down] [(key=value)...]\n");
     fprintf(stderr, "  param=model.param\n");
     fprintf(stderr, "  shape=[227,227,3],...\n");
+    fprintf(stderr, "  branch_parallel=0\n");
+    fprintf(stderr, "  blob_arena=0\n");
+    fprintf(stderr, "  work_stealing=0\n");
+    fprintf(stderr, "  contention=0\n");
+    fprintf(stderr, "  numa=0\n");
+    fprintf(stderr, "  numa_topology=0-3;4-7\n");
 }
 
 static std::vector<ncnn::Mat> parse_shape_list(char* s)
@@ -258,6 +416,12 @@ int main(int argc, char** argv)
     int cooling_down = 1;
     char* model = 0;
     std::vector<ncnn::Mat> inputs;
+    int branch_parallel = 0;
+    int blob_arena = 0;
+    int work_stealing = 0;
+    int contention = 0;
+    int numa = 0;
+    const char* numa_topology = 0;
 
     for (int i = 1; i < argc; i++)
     {
@@ -316,6 +480,18 @@ int main(int argc, char** argv)
             model = value;
         if (strcmp(key, "shape") == 0)
             inputs = parse_shape_list(value);
+        if (strcmp(key, "branch_parallel") == 0)
+            branch_parallel = atoi(value);
+        if (strcmp(key, "blob_arena") == 0)
+            blob_arena = atoi(value);
+        if (strcmp(key, "work_stealing") == 0)
+            work_stealing = atoi(value);
+        if (strcmp(key, "contention") == 0)
+            contention = atoi(value);
+        if (strcmp(key, "numa") == 0)
+            numa = atoi(value);
+        if (strcmp(key, "numa_topology") == 0)
+            numa_topology = value;
     }
 
     if (model && inputs.empty())
@@ -338,6 +514,7 @@ int main(int argc, char** argv)
 
     g_blob_pool_allocator.set_size_compare_ratio(0.f);
     g_workspace_pool_allocator.set_size_compare_ratio(0.f);
+    g_blob_locked_pool_allocator.set_size_compare_ratio(0.f);
 
 #if NCNN_VULKAN
     if (use_vulkan_compute)
@@ -351,6 +528,11 @@ int main(int argc, char** argv)
     }
 #endif // NCNN_VULKAN
 
+    if (numa_topology)
+    {
+        ncnn::set_numa_topology_override(numa_topology);
+    }
+
     ncnn::set_cpu_powersave(powersave);
 
     ncnn::set_omp_dynamic(0);
@@ -377,12 +559,42 @@ int main(int argc, char** argv)
     opt.use_int8_storage = true;
     opt.use_int8_arithmetic = true;
     opt.use_packing_layout = true;
+    opt.use_branch_parallel = branch_parallel != 0;
+    opt.use_blob_arena = blob_arena != 0;
+    opt.use_work_stealing = work_stealing != 0;
+    opt.use_numa_replica = numa != 0;
+
+    if (opt.use_branch_parallel)
+    {
+        opt.blob_allocator = &g_blob_locked_pool_allocator;
+    }
+
+    if (opt.use_numa_replica)
+    {
+        // the net keeps pool allocators per numa node
+        opt.blob_allocator = 0;
+        opt.workspace_allocator = 0;
+    }
 
     fprintf(stderr, "loop_count = %d\n", g_loop_count);
     fprintf(stderr, "num_threads = %d\n", num_threads);
     fprintf(stderr, "powersave = %d\n", ncnn::get_cpu_powersave());
     fprintf(stderr, "gpu_device = %d\n", gpu_device);
     fprintf(stderr, "cooling_down = %d\n", (int)g_enable_cooling_down);
+    fprintf(stderr, "branch_parallel = %d\n", (int)opt.use_branch_parallel);
+    fprintf(stderr, "blob_arena = %d\n", (int)opt.use_blob_arena);
+    fprintf(stderr, "work_stealing = %d\n", (int)opt.use_work_stealing);
+    fprintf(stderr, "contention = %d\n", contention);
+    fprintf(stderr, "numa = %d\n", (int)opt.use_numa_replica);
+    fprintf(stderr, "numa_nodes = %d\n", ncnn::get_numa_node_count());
+
+#if NCNN_THREADS
+    std::vector<ncnn::Thread*> contention_threads;
+    for (int i = 0; i < contention; i++)
+    {
+        contention_threads.push_back(new ncnn::Thread(contention_spin));
+    }
+#endif // NCNN_THREADS
 
     if (model != 0)
     {
@@ -463,7 +675,19 @@ int main(int argc, char** argv)
         benchmark("vision_transformer", ncnn::Mat(384, 384, 3), opt);
 
         benchmark("FastestDet", ncnn::Mat(352, 352, 3), opt);
+
+        benchmark_decode("transformer_decoder", 512, 8, 32, 64, opt);
+    }
+
+#if NCNN_THREADS
+    g_contention_quit = 1;
+    for (size_t i = 0; i < contention_threads.size(); i++)
+    {
+        contention_threads[i]->join();
+        delete contention_threads[i];
     }
+#endif // NCNN_THREADS
+
 #if NCNN_VULKAN
     delete g_blob_vkallocator;
     delete g_staging_vkallocator;
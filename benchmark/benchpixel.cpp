@@ -0,0 +1,356 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// compare the pixel resize, warpaffine and rotate routines against plain scalar versions
+// the scalar versions use the same fixed point arithmetic, so the outputs must be identical
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "benchmark.h"
+#include "mat.h"
+
+static int g_loop_count = 10;
+static int g_num_threads = 1;
+
+#if NCNN_PIXEL
+static void resize_bilinear_ref(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn)
+{
+    const int INTER_RESIZE_COEF_BITS = 11;
+    const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
+
+#define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X + (X >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX)
+
+    double scale_x = (double)srcw / w;
+    double scale_y = (double)srch / h;
+
+    std::vector<int> xofs(w);
+    std::vector<short> ialpha(w * 2);
+    for (int dx = 0; dx < w; dx++)
+    {
+        float fx = (float)((dx + 0.5) * scale_x - 0.5);
+        int sx = static_cast<int>(floor(fx));
+        fx -= sx;
+
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= srcw - 1)
+        {
+            sx = srcw - 2;
+            fx = 1.f;
+        }
+
+        xofs[dx] = sx * cn;
+
+        float a0 = (1.f - fx) * INTER_RESIZE_COEF_SCALE;
+        float a1 = fx * INTER_RESIZE_COEF_SCALE;
+
+        ialpha[dx * 2] = SATURATE_CAST_SHORT(a0);
+        ialpha[dx * 2 + 1] = SATURATE_CAST_SHORT(a1);
+    }
+
+    std::vector<short> rows0(w * cn);
+    std::vector<short> rows1(w * cn);
+    for (int dy = 0; dy < h; dy++)
+    {
+        float fy = (float)((dy + 0.5) * scale_y - 0.5);
+        int sy = static_cast<int>(floor(fy));
+        fy -= sy;
+
+        if (sy < 0)
+        {
+            sy = 0;
+            fy = 0.f;
+        }
+        if (sy >= srch - 1)
+        {
+            sy = srch - 2;
+            fy = 1.f;
+        }
+
+        float b0 = (1.f - fy) * INTER_RESIZE_COEF_SCALE;
+        float b1 = fy * INTER_RESIZE_COEF_SCALE;
+
+        short ib0 = SATURATE_CAST_SHORT(b0);
+        short ib1 = SATURATE_CAST_SHORT(b1);
+
+        const unsigned char* S0 = src + srcw * cn * sy;
+        const unsigned char* S1 = src + srcw * cn * (sy + 1);
+        for (int dx = 0; dx < w; dx++)
+        {
+            short a0 = ialpha[dx * 2];
+            short a1 = ialpha[dx * 2 + 1];
+            for (int c = 0; c < cn; c++)
+            {
+                rows0[dx * cn + c] = (S0[xofs[dx] + c] * a0 + S0[xofs[dx] + cn + c] * a1) >> 4;
+                rows1[dx * cn + c] = (S1[xofs[dx] + c] * a0 + S1[xofs[dx] + cn + c] * a1) >> 4;
+            }
+        }
+
+        unsigned char* Dp = dst + w * cn * dy;
+        for (int dx = 0; dx < w * cn; dx++)
+        {
+            Dp[dx] = (unsigned char)(((short)((ib0 * rows0[dx]) >> 16) + (short)((ib1 * rows1[dx]) >> 16) + 2) >> 2);
+        }
+    }
+
+#undef SATURATE_CAST_SHORT
+}
+
+static void resize_bilinear(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn)
+{
+    if (cn == 1)
+        ncnn::resize_bilinear_c1(src, srcw, srch, srcw, dst, w, h, w, g_num_threads);
+    if (cn == 2)
+        ncnn::resize_bilinear_c2(src, srcw, srch, srcw * 2, dst, w, h, w * 2, g_num_threads);
+    if (cn == 3)
+        ncnn::resize_bilinear_c3(src, srcw, srch, srcw * 3, dst, w, h, w * 3, g_num_threads);
+    if (cn == 4)
+        ncnn::resize_bilinear_c4(src, srcw, srch, srcw * 4, dst, w, h, w * 4, g_num_threads);
+}
+#endif // NCNN_PIXEL
+
+#if NCNN_PIXEL_AFFINE
+static void warpaffine_bilinear_ref(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int cn)
+{
+#define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X), SHRT_MIN), SHRT_MAX)
+#define SATURATE_CAST_INT(X)   (int)::std::min(::std::max((int)((X) + ((X) >= 0.f ? 0.5f : -0.5f)), INT_MIN), INT_MAX)
+
+    std::vector<int> adelta(w);
+    std::vector<int> bdelta(w);
+    for (int x = 0; x < w; x++)
+    {
+        adelta[x] = SATURATE_CAST_INT(tm[0] * x * (1 << 10));
+        bdelta[x] = SATURATE_CAST_INT(tm[3] * x * (1 << 10));
+    }
+
+    // zero border
+    const unsigned char border_color[4] = {0, 0, 0, 0};
+
+    for (int y = 0; y < h; y++)
+    {
+        int X0 = SATURATE_CAST_INT((tm[1] * y + tm[2]) * (1 << 10));
+        int Y0 = SATURATE_CAST_INT((tm[4] * y + tm[5]) * (1 << 10));
+
+        unsigned char* dst0 = dst + w * cn * y;
+        for (int x = 0; x < w; x++)
+        {
+            int X = X0 + adelta[x];
+            int Y = Y0 + bdelta[x];
+
+            short sx = SATURATE_CAST_SHORT((X >> 10));
+            short sy = SATURATE_CAST_SHORT((Y >> 10));
+
+            if (sx < -1 || sx >= srcw || sy < -1 || sy >= srch)
+            {
+                for (int c = 0; c < cn; c++)
+                {
+                    dst0[x * cn + c] = border_color[c];
+                }
+                continue;
+            }
+
+            short fx = X & ((1 << 10) - 1);
+            short fy = Y & ((1 << 10) - 1);
+
+            short alpha0 = (1 << 10) - fx;
+            short alpha1 = fx;
+
+            short beta0 = (1 << 10) - fy;
+            short beta1 = fy;
+
+            short sx1 = sx + 1;
+            short sy1 = sy + 1;
+
+            const unsigned char* a0 = (unsigned short)sx < srcw && (unsigned short)sy < srch ? src + srcw * cn * sy + sx * cn : border_color;
+            const unsigned char* a1 = (unsigned short)sx1 < srcw && (unsigned short)sy < srch ? src + srcw * cn * sy + sx1 * cn : border_color;
+            const unsigned char* b0 = (unsigned short)sx < srcw && (unsigned short)sy1 < srch ? src + srcw * cn * sy1 + sx * cn : border_color;
+            const unsigned char* b1 = (unsigned short)sx1 < srcw && (unsigned short)sy1 < srch ? src + srcw * cn * sy1 + sx1 * cn : border_color;
+
+            for (int c = 0; c < cn; c++)
+            {
+                dst0[x * cn + c] = (unsigned char)(((((unsigned short)((a0[c] * alpha0 + a1[c] * alpha1) >> 5) * beta0)) + (((unsigned short)((b0[c] * alpha0 + b1[c] * alpha1) >> 5) * beta1))) >> 15);
+            }
+        }
+    }
+
+#undef SATURATE_CAST_SHORT
+#undef SATURATE_CAST_INT
+}
+
+static void warpaffine_bilinear(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int cn)
+{
+    if (cn == 1)
+        ncnn::warpaffine_bilinear_c1(src, srcw, srch, srcw, dst, w, h, w, tm, 0, 0, g_num_threads);
+    if (cn == 2)
+        ncnn::warpaffine_bilinear_c2(src, srcw, srch, srcw * 2, dst, w, h, w * 2, tm, 0, 0, g_num_threads);
+    if (cn == 3)
+        ncnn::warpaffine_bilinear_c3(src, srcw, srch, srcw * 3, dst, w, h, w * 3, tm, 0, 0, g_num_threads);
+    if (cn == 4)
+        ncnn::warpaffine_bilinear_c4(src, srcw, srch, srcw * 4, dst, w, h, w * 4, tm, 0, 0, g_num_threads);
+}
+#endif // NCNN_PIXEL_AFFINE
+
+#if NCNN_PIXEL_ROTATE
+static void kanna_rotate_ref(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, int cn)
+{
+    for (int y = 0; y < srch; y++)
+    {
+        for (int x = 0; x < srcw; x++)
+        {
+            // dst pixel (dx, dy) of src pixel (x, y)
+            const bool transpose = type >= 5;
+            const bool flipx = type == 2 || type == 3 || type == 6 || type == 7;
+            const bool flipy = type == 3 || type == 4 || type == 7 || type == 8;
+            int dx = transpose ? y : x;
+            int dy = transpose ? x : y;
+            if (flipx)
+                dx = w - 1 - dx;
+            if (flipy)
+                dy = h - 1 - dy;
+
+            memcpy(dst + (dy * w + dx) * cn, src + (y * srcw + x) * cn, cn);
+        }
+    }
+}
+
+static void kanna_rotate(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int type, int cn)
+{
+    if (cn == 1)
+        ncnn::kanna_rotate_c1(src, srcw, srch, dst, w, h, type);
+    if (cn == 2)
+        ncnn::kanna_rotate_c2(src, srcw, srch, dst, w, h, type);
+    if (cn == 3)
+        ncnn::kanna_rotate_c3(src, srcw, srch, dst, w, h, type);
+    if (cn == 4)
+        ncnn::kanna_rotate_c4(src, srcw, srch, dst, w, h, type);
+}
+#endif // NCNN_PIXEL_ROTATE
+
+// run stmt once for warmup then g_loop_count times, store the minimal milliseconds in time_min
+#define BENCH_MIN(time_min, stmt)                          \
+    do                                                     \
+    {                                                      \
+        stmt;                                              \
+        time_min = DBL_MAX;                                \
+        for (int loop = 0; loop < g_loop_count; loop++)    \
+        {                                                  \
+            double start = ncnn::get_current_time();       \
+            stmt;                                          \
+            double end = ncnn::get_current_time();         \
+            time_min = std::min(time_min, end - start);    \
+        }                                                  \
+    } while (0)
+
+static void report(const char* comment, double time_ref, double time_ncnn, const std::vector<unsigned char>& out_ref, const std::vector<unsigned char>& out_ncnn)
+{
+    const bool same = out_ref == out_ncnn;
+    fprintf(stderr, "%-40s  ref = %8.2f  ncnn = %8.2f  speedup = %6.2f  %s\n", comment, time_ref, time_ncnn, time_ref / time_ncnn, same ? "ok" : "MISMATCH");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc >= 2)
+    {
+        g_loop_count = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        g_num_threads = atoi(argv[2]);
+    }
+
+    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    fprintf(stderr, "num_threads = %d\n", g_num_threads);
+
+    static const int frames[][4] = {
+        {640, 480, 320, 240},
+        {1920, 1080, 1280, 720},
+        {3840, 2160, 1920, 1080},
+    };
+
+    for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); i++)
+    {
+        const int srcw = frames[i][0];
+        const int srch = frames[i][1];
+        const int w = frames[i][2];
+        const int h = frames[i][3];
+
+        for (int cn = 1; cn <= 4; cn++)
+        {
+            if (cn == 2)
+                continue;
+
+            std::vector<unsigned char> src(srcw * srch * cn);
+            for (size_t j = 0; j < src.size(); j++)
+            {
+                src[j] = (unsigned char)(rand() & 255);
+            }
+
+            char comment[64];
+
+#if NCNN_PIXEL
+            {
+                std::vector<unsigned char> out_ref(w * h * cn);
+                std::vector<unsigned char> out_ncnn(w * h * cn);
+                double time_ref;
+                BENCH_MIN(time_ref, resize_bilinear_ref(src.data(), srcw, srch, out_ref.data(), w, h, cn));
+                double time_ncnn;
+                BENCH_MIN(time_ncnn, resize_bilinear(src.data(), srcw, srch, out_ncnn.data(), w, h, cn));
+                sprintf(comment, "resize c%d %dx%d -> %dx%d", cn, srcw, srch, w, h);
+                report(comment, time_ref, time_ncnn, out_ref, out_ncnn);
+            }
+#endif // NCNN_PIXEL
+
+#if NCNN_PIXEL_AFFINE
+            {
+                // rotate 30 degree around the center and scale to the dst size
+                float tm[6];
+                float tm_inv[6];
+                ncnn::get_rotation_matrix(30.f, (float)w / srcw, srcw / 2.f, srch / 2.f, tm);
+                tm[2] += w / 2.f - srcw / 2.f;
+                tm[5] += h / 2.f - srch / 2.f;
+                ncnn::invert_affine_transform(tm, tm_inv);
+
+                std::vector<unsigned char> out_ref(w * h * cn);
+                std::vector<unsigned char> out_ncnn(w * h * cn);
+                double time_ref;
+                BENCH_MIN(time_ref, warpaffine_bilinear_ref(src.data(), srcw, srch, out_ref.data(), w, h, tm_inv, cn));
+                double time_ncnn;
+                BENCH_MIN(time_ncnn, warpaffine_bilinear(src.data(), srcw, srch, out_ncnn.data(), w, h, tm_inv, cn));
+                sprintf(comment, "warpaffine c%d %dx%d -> %dx%d", cn, srcw, srch, w, h);
+                report(comment, time_ref, time_ncnn, out_ref, out_ncnn);
+            }
+#endif // NCNN_PIXEL_AFFINE
+
+#if NCNN_PIXEL_ROTATE
+            for (int type = 2; type <= 8; type += 4)
+            {
+                // horizontal flip and rotate 90 cw
+                const int rw = type <= 4 ? srcw : srch;
+                const int rh = type <= 4 ? srch : srcw;
+
+                std::vector<unsigned char> out_ref(srcw * srch * cn);
+                std::vector<unsigned char> out_ncnn(srcw * srch * cn);
+                double time_ref;
+                BENCH_MIN(time_ref, kanna_rotate_ref(src.data(), srcw, srch, out_ref.data(), rw, rh, type, cn));
+                double time_ncnn;
+                BENCH_MIN(time_ncnn, kanna_rotate(src.data(), srcw, srch, out_ncnn.data(), rw, rh, type, cn));
+                sprintf(comment, "rotate%d c%d %dx%d", type, cn, srcw, srch);
+                report(comment, time_ref, time_ncnn, out_ref, out_ncnn);
+            }
+#endif // NCNN_PIXEL_ROTATE
+        }
+    }
+
+    return 0;
+}
@@ -202,7 +202,12 @@ PYBIND11_MODULE(ncnn, m)
     .def_readwrite("use_int8_arithmetic", &Option::use_int8_arithmetic)
     .def_readwrite("use_packing_layout", &Option::use_packing_layout)
     .def_readwrite("use_subgroup_ops", &Option::use_subgroup_ops)
-    .def_readwrite("use_tensor_storage", &Option::use_tensor_storage);
+    .def_readwrite("use_tensor_storage", &Option::use_tensor_storage)
+    .def_readwrite("use_branch_parallel", &Option::use_branch_parallel)
+    .def_readwrite("use_blob_arena", &Option::use_blob_arena)
+    .def_readwrite("use_work_stealing", &Option::use_work_stealing)
+    .def_readwrite("use_numa_replica", &Option::use_numa_replica)
+    .def_readwrite("use_sparse_weight", &Option::use_sparse_weight);
 
     py::class_<Mat> mat(m, "Mat", py::buffer_protocol());
     mat.def(py::init<>())
@@ -842,6 +847,8 @@ PYBIND11_MODULE(ncnn, m)
     .def("set_num_threads", &Extractor::set_num_threads, py::arg("num_threads"))
     .def("set_blob_allocator", &Extractor::set_blob_allocator, py::arg("allocator"))
     .def("set_workspace_allocator", &Extractor::set_workspace_allocator, py::arg("allocator"))
+    .def("set_streaming", &Extractor::set_streaming, py::arg("enable"))
+    .def("reset_streaming", &Extractor::reset_streaming)
 #if NCNN_STRING
     .def("input", (int (Extractor::*)(const char*, const Mat&)) & Extractor::input, py::arg("blob_name"), py::arg("in"))
     .def("extract", (int (Extractor::*)(const char*, Mat&, int)) & Extractor::extract, py::arg("blob_name"), py::arg("feat"), py::arg("type") = 0)
@@ -852,6 +859,18 @@ PYBIND11_MODULE(ncnn, m)
         return py::make_tuple(ret, feat.clone());
     },
     py::arg("blob_name"), py::arg("type") = 0)
+    .def("input_batch", (int (Extractor::*)(const char*, const std::vector<Mat>&)) & Extractor::input_batch, py::arg("blob_name"), py::arg("ins"))
+    .def(
+    "extract_batch", [](Extractor& ex, const char* blob_name, int type) {
+        std::vector<ncnn::Mat> feats;
+        int ret = ex.extract_batch(blob_name, feats, type);
+        for (size_t i = 0; i < feats.size(); i++)
+        {
+            feats[i] = feats[i].clone();
+        }
+        return py::make_tuple(ret, feats);
+    },
+    py::arg("blob_name"), py::arg("type") = 0)
 #endif
     .def("input", (int (Extractor::*)(int, const Mat&)) & Extractor::input)
     .def("extract", (int (Extractor::*)(int, Mat&, int)) & Extractor::extract, py::arg("blob_index"), py::arg("feat"), py::arg("type") = 0)
@@ -861,6 +880,18 @@ PYBIND11_MODULE(ncnn, m)
         int ret = ex.extract(blob_index, feat, type);
         return py::make_tuple(ret, feat.clone());
     },
+    py::arg("blob_index"), py::arg("type") = 0)
+    .def("input_batch", (int (Extractor::*)(int, const std::vector<Mat>&)) & Extractor::input_batch, py::arg("blob_index"), py::arg("ins"))
+    .def(
+    "extract_batch", [](Extractor& ex, int blob_index, int type) {
+        std::vector<ncnn::Mat> feats;
+        int ret = ex.extract_batch(blob_index, feats, type);
+        for (size_t i = 0; i < feats.size(); i++)
+        {
+            feats[i] = feats[i].clone();
+        }
+        return py::make_tuple(ret, feats);
+    },
     py::arg("blob_index"), py::arg("type") = 0);
 
     py::class_<Layer, PyLayer>(m, "Layer")
@@ -875,6 +906,9 @@ PYBIND11_MODULE(ncnn, m)
     .def_readwrite("support_packing", &Layer::support_packing)
     .def_readwrite("support_bf16_storage", &Layer::support_bf16_storage)
     .def_readwrite("support_fp16_storage", &Layer::support_fp16_storage)
+    .def_readwrite("support_batch_rows", &Layer::support_batch_rows)
+    .def_readwrite("support_batch_pixels", &Layer::support_batch_pixels)
+    .def_readwrite("support_streaming", &Layer::support_streaming)
     .def("forward", (int (Layer::*)(const std::vector<Mat>&, std::vector<Mat>&, const Option&) const) & Layer::forward,
          py::arg("bottom_blobs"), py::arg("top_blobs"), py::arg("opt"))
     .def("forward", (int (Layer::*)(const Mat&, Mat&, const Option&) const) & Layer::forward,
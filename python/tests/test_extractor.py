@@ -40,6 +40,34 @@ def test_extractor():
         assert ret == 0 and out_mat.dims == 1 and out_mat.w == 1
 
 
+def test_extractor_batch():
+    dr = ncnn.DataReaderFromEmpty()
+
+    net = ncnn.Net()
+    net.load_param("tests/test.param")
+    net.load_model(dr)
+
+    in_mats = [ncnn.Mat((227, 227, 3)) for i in range(3)]
+    with net.create_extractor() as ex:
+        ret = ex.input_batch("data", in_mats)
+        assert ret == 0
+
+        ret, out_mats = ex.extract_batch("conv0_fwd")
+        assert ret == 0 and len(out_mats) == 3
+        for out_mat in out_mats:
+            assert (
+                out_mat.dims == 3
+                and out_mat.w == 225
+                and out_mat.h == 225
+                and out_mat.c == 3
+            )
+
+        ret, out_mats = ex.extract_batch("output")
+        assert ret == 0 and len(out_mats) == 3
+        for out_mat in out_mats:
+            assert out_mat.dims == 1 and out_mat.w == 1
+
+
 def test_extractor_index():
     with pytest.raises(TypeError, match="No constructor"):
         ex = ncnn.Extractor()
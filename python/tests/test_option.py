@@ -101,3 +101,23 @@ def test_option():
     assert opt.use_tensor_storage == True
     opt.use_tensor_storage = False
     assert opt.use_tensor_storage == False
+
+    opt.use_branch_parallel = True
+    assert opt.use_branch_parallel == True
+    opt.use_branch_parallel = False
+    assert opt.use_branch_parallel == False
+
+    opt.use_blob_arena = True
+    assert opt.use_blob_arena == True
+    opt.use_blob_arena = False
+    assert opt.use_blob_arena == False
+
+    opt.use_work_stealing = True
+    assert opt.use_work_stealing == True
+    opt.use_work_stealing = False
+    assert opt.use_work_stealing == False
+
+    opt.use_numa_replica = True
+    assert opt.use_numa_replica == True
+    opt.use_numa_replica = False
+    assert opt.use_numa_replica == False
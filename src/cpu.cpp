@@ -185,6 +185,8 @@ static int g_powersave;
 static ncnn::CpuSet g_cpu_affinity_mask_all;
 static ncnn::CpuSet g_cpu_affinity_mask_little;
 static ncnn::CpuSet g_cpu_affinity_mask_big;
+static std::vector<ncnn::CpuSet> g_numa_node_masks;
+static std::vector<ncnn::CpuSet> g_numa_node_masks_discovered;
 
 // isa info
 #if defined _WIN32
@@ -235,6 +237,8 @@ static int g_cpu_support_x86_avx512;
 static int g_cpu_support_x86_avx512_vnni;
 static int g_cpu_support_x86_avx512_bf16;
 static int g_cpu_support_x86_avx512_fp16;
+static int g_cpu_support_x86_amx_int8;
+static int g_cpu_support_x86_amx_bf16;
 #endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
 
 #if defined __ANDROID__ || defined __linux__
@@ -864,6 +868,62 @@ static int get_cpu_support_x86_avx512_fp16()
     return cpu_info[3] & (1u << 23);
 #endif
 }
+
+static int get_cpu_support_x86_amx_tile()
+{
+#if __APPLE__
+    return 0;
+#else
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(0, cpu_info);
+
+    int nIds = cpu_info[0];
+    if (nIds < 7)
+        return 0;
+
+    x86_cpuid(1, cpu_info);
+    // check XSAVE OSXSAVE
+    if (!(cpu_info[2] & (1u << 26)) || !(cpu_info[2] & (1u << 27)))
+        return 0;
+
+    x86_cpuid_sublevel(7, 0, cpu_info);
+    if (!(cpu_info[3] & (1u << 24)))
+        return 0;
+
+    // check amx XTILECFG XTILEDATA enabled by kernel
+    if ((x86_get_xcr0() & 0x60000) != 0x60000)
+        return 0;
+
+#if defined __linux__ && defined __x86_64__
+    // linux requires the process to request XTILEDATA permission before using tile registers
+    // ARCH_REQ_XCOMP_PERM = 0x1023, XFEATURE_XTILEDATA = 18
+    if (syscall(SYS_arch_prctl, 0x1023, 18) != 0)
+        return 0;
+#endif
+
+    return 1;
+#endif
+}
+
+static int get_cpu_support_x86_amx_int8()
+{
+    if (!get_cpu_support_x86_amx_tile())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid_sublevel(7, 0, cpu_info);
+    return cpu_info[3] & (1u << 25);
+}
+
+static int get_cpu_support_x86_amx_bf16()
+{
+    if (!get_cpu_support_x86_amx_tile())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid_sublevel(7, 0, cpu_info);
+    return cpu_info[3] & (1u << 22);
+}
 #endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
 
 static int get_cpucount()
@@ -2139,6 +2199,102 @@ static int detect_cpu_is_arm_a53_a55()
 #endif // __aarch64__
 #endif // defined __ANDROID__ || defined __linux__
 
+// parse cpu list like 0-3,8,10-11
+// return the number of cpus enabled, -1 if malformed
+static int parse_cpu_list(const char* s, ncnn::CpuSet& mask)
+{
+    const int max_cpu_count = (int)sizeof(ncnn::CpuSet) * 8;
+
+    mask.disable_all();
+
+    int count = 0;
+    while (*s)
+    {
+        int id0;
+        int nconsumed = 0;
+        int nscan = sscanf(s, "%d%n", &id0, &nconsumed);
+        if (nscan != 1)
+            break;
+
+        s += nconsumed;
+
+        int id1 = id0;
+        if (*s == '-')
+        {
+            s++;
+            nscan = sscanf(s, "%d%n", &id1, &nconsumed);
+            if (nscan != 1)
+                return -1;
+
+            s += nconsumed;
+        }
+
+        if (id0 < 0 || id1 < id0 || id1 >= max_cpu_count)
+            return -1;
+
+        for (int i = id0; i <= id1; i++)
+        {
+            mask.enable(i);
+            count++;
+        }
+
+        if (*s != ',')
+            break;
+
+        s++;
+    }
+
+    return count;
+}
+
+static void initialize_numa_node_masks(std::vector<ncnn::CpuSet>& masks)
+{
+    masks.clear();
+
+#if defined __ANDROID__ || defined __linux__
+    FILE* fp = fopen("/sys/devices/system/node/online", "rb");
+    if (fp)
+    {
+        char line[1024];
+        char* l = fgets(line, 1024, fp);
+        fclose(fp);
+
+        ncnn::CpuSet nodes;
+        if (l && parse_cpu_list(line, nodes) > 0)
+        {
+            for (int i = 0; i < (int)sizeof(ncnn::CpuSet) * 8; i++)
+            {
+                if (!nodes.is_enabled(i))
+                    continue;
+
+                char path[256];
+                sprintf(path, "/sys/devices/system/node/node%d/cpulist", i);
+
+                fp = fopen(path, "rb");
+                if (!fp)
+                    continue;
+
+                l = fgets(line, 1024, fp);
+                fclose(fp);
+
+                // memory only nodes have no cpu
+                ncnn::CpuSet mask;
+                if (l && parse_cpu_list(line, mask) > 0)
+                {
+                    masks.push_back(mask);
+                }
+            }
+        }
+    }
+#endif // defined __ANDROID__ || defined __linux__
+
+    if (masks.empty())
+    {
+        // treat all cpus as one node
+        masks.push_back(g_cpu_affinity_mask_all);
+    }
+}
+
 // the initialization
 static void initialize_global_cpu_info()
 {
@@ -2150,6 +2306,8 @@ static void initialize_global_cpu_info()
     g_physical_cpucount = get_physical_cpucount();
     g_powersave = 0;
     initialize_cpu_thread_affinity_mask(g_cpu_affinity_mask_all, g_cpu_affinity_mask_little, g_cpu_affinity_mask_big);
+    initialize_numa_node_masks(g_numa_node_masks_discovered);
+    g_numa_node_masks = g_numa_node_masks_discovered;
 
 #if (defined _WIN32 && (__aarch64__ || __arm__)) || ((defined __ANDROID__ || defined __linux__) && __riscv)
     if (!is_being_debugged())
@@ -2232,6 +2390,8 @@ static void initialize_global_cpu_info()
     g_cpu_support_x86_avx512_vnni = get_cpu_support_x86_avx512_vnni();
     g_cpu_support_x86_avx512_bf16 = get_cpu_support_x86_avx512_bf16();
     g_cpu_support_x86_avx512_fp16 = get_cpu_support_x86_avx512_fp16();
+    g_cpu_support_x86_amx_int8 = get_cpu_support_x86_amx_int8();
+    g_cpu_support_x86_amx_bf16 = get_cpu_support_x86_amx_bf16();
 #endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
 
 #if defined __ANDROID__ || defined __linux__
@@ -2790,6 +2950,26 @@ int cpu_support_x86_avx512_fp16()
 #endif
 }
 
+int cpu_support_x86_amx_int8()
+{
+    try_initialize_global_cpu_info();
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_amx_int8;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_amx_bf16()
+{
+    try_initialize_global_cpu_info();
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_amx_bf16;
+#else
+    return 0;
+#endif
+}
+
 int cpu_support_mips_msa()
 {
     try_initialize_global_cpu_info();
@@ -3107,6 +3287,74 @@ int set_cpu_thread_affinity(const CpuSet& thread_affinity_mask)
 #endif
 }
 
+int set_current_thread_affinity(const CpuSet& thread_affinity_mask)
+{
+    try_initialize_global_cpu_info();
+#if defined __ANDROID__ || defined __linux__ || defined _WIN32 || __APPLE__
+    return set_sched_affinity(thread_affinity_mask);
+#else
+    // TODO
+    (void)thread_affinity_mask;
+    return -1;
+#endif
+}
+
+int get_numa_node_count()
+{
+    try_initialize_global_cpu_info();
+    return (int)g_numa_node_masks.size();
+}
+
+const CpuSet& get_numa_node_cpu_mask(int node)
+{
+    try_initialize_global_cpu_info();
+    if (node < 0 || node >= (int)g_numa_node_masks.size())
+    {
+        NCNN_LOGE("numa node %d not exists", node);
+
+        // fallback to all cores anyway
+        return g_cpu_affinity_mask_all;
+    }
+
+    return g_numa_node_masks[node];
+}
+
+int set_numa_topology_override(const char* topology)
+{
+    try_initialize_global_cpu_info();
+    if (!topology || topology[0] == '\0')
+    {
+        g_numa_node_masks = g_numa_node_masks_discovered;
+        return 0;
+    }
+
+    std::vector<CpuSet> masks;
+
+    const char* p = topology;
+    while (true)
+    {
+        CpuSet mask;
+        int count = parse_cpu_list(p, mask);
+        if (count <= 0)
+        {
+            NCNN_LOGE("numa topology %s malformed", topology);
+            return -1;
+        }
+
+        masks.push_back(mask);
+
+        p = strchr(p, ';');
+        if (!p)
+            break;
+
+        p++;
+    }
+
+    g_numa_node_masks = masks;
+
+    return 0;
+}
+
 int is_current_thread_running_on_a53_a55()
 {
     try_initialize_global_cpu_info();
@@ -3226,6 +3474,24 @@ void set_kmp_blocktime(int time_ms)
 #endif
 }
 
+int get_kmp_work_stealing()
+{
+#if defined(_OPENMP) && NCNN_SIMPLEOMP
+    return kmp_get_work_stealing();
+#else
+    return 0;
+#endif
+}
+
+void set_kmp_work_stealing(int work_stealing)
+{
+#if defined(_OPENMP) && NCNN_SIMPLEOMP
+    kmp_set_work_stealing(work_stealing);
+#else
+    (void)work_stealing;
+#endif
+}
+
 static ncnn::ThreadLocalStorage tls_flush_denormals;
 
 int get_flush_denormals()
@@ -96,6 +96,10 @@ NCNN_EXPORT int cpu_support_x86_avx512_vnni();
 NCNN_EXPORT int cpu_support_x86_avx512_bf16();
 // avx512_fp16 = x86 avx512 fp16
 NCNN_EXPORT int cpu_support_x86_avx512_fp16();
+// amx_int8 = x86 amx tile + amx int8
+NCNN_EXPORT int cpu_support_x86_amx_int8();
+// amx_bf16 = x86 amx tile + amx bf16
+NCNN_EXPORT int cpu_support_x86_amx_bf16();
 
 // lsx = loongarch lsx
 NCNN_EXPORT int cpu_support_loongarch_lsx();
@@ -148,6 +152,21 @@ NCNN_EXPORT const CpuSet& get_cpu_thread_affinity_mask(int powersave);
 // set explicit thread affinity
 NCNN_EXPORT int set_cpu_thread_affinity(const CpuSet& thread_affinity_mask);
 
+// set explicit thread affinity of the calling thread only
+NCNN_EXPORT int set_current_thread_affinity(const CpuSet& thread_affinity_mask);
+
+// numa nodes having cpus, discovered from /sys/devices/system/node
+// all cpus form node 0 when the topology is unknown
+NCNN_EXPORT int get_numa_node_count();
+NCNN_EXPORT const CpuSet& get_numa_node_cpu_mask(int node);
+
+// replace the discovered numa topology, mainly for exercising numa paths on single node machines
+// topology lists the cpus of every node separated by semicolon, such as "0-7;8-15" or "0;0"
+// null or empty string restores the discovered topology
+// not thread-safe, call it before loading any net
+// return 0 if success
+NCNN_EXPORT int set_numa_topology_override(const char* topology);
+
 // runtime thread affinity info
 NCNN_EXPORT int is_current_thread_running_on_a53_a55();
 
@@ -163,6 +182,10 @@ NCNN_EXPORT int get_omp_thread_num();
 NCNN_EXPORT int get_kmp_blocktime();
 NCNN_EXPORT void set_kmp_blocktime(int time_ms);
 
+// only implemented in simpleomp, no-op for other openmp runtimes
+NCNN_EXPORT int get_kmp_work_stealing();
+NCNN_EXPORT void set_kmp_work_stealing(int work_stealing);
+
 // need to flush denormals on Intel Chipset.
 // Other architectures such as ARM can be added as needed.
 // 0 = DAZ OFF, FTZ OFF
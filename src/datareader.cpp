@@ -3,8 +3,22 @@
 
 #include "datareader.h"
 
+#include "allocator.h"
+
 #include <string.h>
 
+#if NCNN_STDIO
+#if defined __unix__ || defined __APPLE__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NCNN_DATAREADER_MMAP 1
+#else
+#define NCNN_DATAREADER_MMAP 0
+#endif
+#endif // NCNN_STDIO
+
 namespace ncnn {
 
 DataReader::DataReader()
@@ -74,6 +88,148 @@ size_t DataReaderFromStdio::read(void* buf, size_t size) const
 {
     return fread(buf, 1, size, d->fp);
 }
+
+class DataReaderFromMmapPrivate
+{
+public:
+    DataReaderFromMmapPrivate()
+        : base(0), base_size(0), mem(0), size(0), offset(0)
+    {
+    }
+    void* base;
+    size_t base_size;
+    const unsigned char* mem;
+    size_t size;
+    mutable size_t offset;
+};
+
+DataReaderFromMmap::DataReaderFromMmap(const char* path)
+    : DataReader(), d(new DataReaderFromMmapPrivate)
+{
+#if NCNN_DATAREADER_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        NCNN_LOGE("open %s failed", path);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        NCNN_LOGE("fstat %s failed", path);
+        close(fd);
+        return;
+    }
+
+    const size_t size = (size_t)st.st_size;
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    // reserve zero pages behind the file for the over-read of simd kernels
+    const size_t base_size = alignSize(size + NCNN_MALLOC_OVERREAD, page_size);
+    void* base = mmap(0, base_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        NCNN_LOGE("mmap %s reserve failed", path);
+        close(fd);
+        return;
+    }
+
+    // private mapping shares the page cache with other processes until a page is written
+    void* mem = mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);
+
+    if (mem == MAP_FAILED)
+    {
+        NCNN_LOGE("mmap %s failed", path);
+        munmap(base, base_size);
+        return;
+    }
+
+    d->base = base;
+    d->base_size = base_size;
+    d->mem = (const unsigned char*)mem;
+    d->size = size;
+#else
+    // no mmap on this platform, load the whole file at once
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    rewind(fp);
+
+    if (size > 0)
+    {
+        unsigned char* mem = (unsigned char*)fastMalloc(size);
+        if (mem && fread(mem, 1, size, fp) == (size_t)size)
+        {
+            d->base = mem;
+            d->mem = mem;
+            d->size = size;
+        }
+        else
+        {
+            NCNN_LOGE("fread %s failed", path);
+            fastFree(mem);
+        }
+    }
+
+    fclose(fp);
+#endif
+}
+
+DataReaderFromMmap::~DataReaderFromMmap()
+{
+    if (d->base)
+    {
+#if NCNN_DATAREADER_MMAP
+        munmap(d->base, d->base_size);
+#else
+        fastFree(d->base);
+#endif
+    }
+
+    delete d;
+}
+
+DataReaderFromMmap::DataReaderFromMmap(const DataReaderFromMmap&)
+    : d(0)
+{
+}
+
+DataReaderFromMmap& DataReaderFromMmap::operator=(const DataReaderFromMmap&)
+{
+    return *this;
+}
+
+bool DataReaderFromMmap::empty() const
+{
+    return d->mem == 0;
+}
+
+size_t DataReaderFromMmap::read(void* buf, size_t size) const
+{
+    const size_t remain = d->size - d->offset;
+    const size_t nread = size < remain ? size : remain;
+    memcpy(buf, d->mem + d->offset, nread);
+    d->offset += nread;
+    return nread;
+}
+
+size_t DataReaderFromMmap::reference(size_t size, const void** buf) const
+{
+    if (size > d->size - d->offset)
+        return 0;
+
+    *buf = d->mem + d->offset;
+    d->offset += size;
+    return size;
+}
 #endif // NCNN_STDIO
 
 class DataReaderFromMemoryPrivate
@@ -26,6 +26,11 @@ Layer::Layer()
     support_reserved_000 = false;
     support_reserved_00 = false;
 
+    support_batch_rows = false;
+    support_batch_pixels = false;
+
+    support_streaming = false;
+
     featmask = 0;
 
 #if NCNN_VULKAN
@@ -60,6 +65,16 @@ int Layer::destroy_pipeline(const Option& /*opt*/)
     return 0;
 }
 
+int Layer::export_pipeline(std::vector<Mat>& /*pipeline_data*/) const
+{
+    return -1;
+}
+
+int Layer::import_pipeline(const std::vector<Mat>& /*pipeline_data*/, const Option& /*opt*/)
+{
+    return -1;
+}
+
 int Layer::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     if (!support_inplace)
@@ -98,6 +113,16 @@ int Layer::forward_inplace(Mat& /*bottom_top_blob*/, const Option& /*opt*/) cons
     return -1;
 }
 
+int Layer::forward_streaming(const std::vector<Mat>& /*bottom_blobs*/, std::vector<Mat>& /*top_blobs*/, std::vector<Mat>& /*states*/, const Option& /*opt*/) const
+{
+    return -1;
+}
+
+int Layer::forward_streaming(const Mat& /*bottom_blob*/, Mat& /*top_blob*/, std::vector<Mat>& /*states*/, const Option& /*opt*/) const
+{
+    return -1;
+}
+
 #if NCNN_VULKAN
 int Layer::upload_model(VkTransfer& /*cmd*/, const Option& /*opt*/)
 {
@@ -238,6 +263,9 @@ public:
         support_bf16_storage = layer_cpu->support_bf16_storage;
         support_fp16_storage = layer_cpu->support_fp16_storage;
         support_int8_storage = layer_cpu->support_int8_storage;
+        support_batch_rows = layer_cpu->support_batch_rows;
+        support_batch_pixels = layer_cpu->support_batch_pixels;
+        support_streaming = layer_cpu->support_streaming;
 
         support_vulkan = 0;
         support_tensor_storage = 0;
@@ -346,6 +374,32 @@ public:
         return layer_cpu->destroy_pipeline(opt);
     }
 
+    virtual int export_pipeline(std::vector<Mat>& pipeline_data) const
+    {
+#if NCNN_VULKAN
+        if (layer_vulkan)
+            return -1;
+#endif // NCNN_VULKAN
+
+        return layer_cpu->export_pipeline(pipeline_data);
+    }
+
+    virtual int import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt)
+    {
+        set_layer_properties();
+#if NCNN_VULKAN
+        if (layer_vulkan)
+        {
+            // fallback to create_pipeline
+            return -1;
+        }
+#endif // NCNN_VULKAN
+
+        int ret = layer_cpu->import_pipeline(pipeline_data, opt);
+        get_layer_properties();
+        return ret;
+    }
+
 public:
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
     {
@@ -367,6 +421,16 @@ public:
         return layer_cpu->forward_inplace(bottom_top_blob, opt);
     }
 
+    virtual int forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& states, const Option& opt) const
+    {
+        return layer_cpu->forward_streaming(bottom_blobs, top_blobs, states, opt);
+    }
+
+    virtual int forward_streaming(const Mat& bottom_blob, Mat& top_blob, std::vector<Mat>& states, const Option& opt) const
+    {
+        return layer_cpu->forward_streaming(bottom_blob, top_blob, states, opt);
+    }
+
 #if NCNN_VULKAN
 public:
     virtual int upload_model(VkTransfer& cmd, const Option& opt)
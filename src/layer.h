@@ -41,6 +41,15 @@ public:
     // return 0 if success
     virtual int destroy_pipeline(const Option& opt);
 
+    // export the weight data transformed in create_pipeline for caching
+    // return 0 if success, -1 if the layer pipeline could not be cached
+    virtual int export_pipeline(std::vector<Mat>& pipeline_data) const;
+
+    // layer implementation specific setup from the exported pipeline data
+    // it replaces create_pipeline, the weight data transform is skipped
+    // return 0 if success, -1 to fallback to create_pipeline
+    virtual int import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt);
+
 public:
     // one input and one output blob
     bool one_blob_only;
@@ -70,9 +79,17 @@ public:
 
     bool support_reserved_00;
 
-    bool support_reserved_0;
-    bool support_reserved_1;
-    bool support_reserved_2;
+    // output rows only depend on the input rows at the same position
+    // same-shaped 1d inputs of a batch could be stacked as the rows of one 2d input
+    bool support_batch_rows;
+
+    // output pixels only depend on the input pixels at the same position
+    // same-shaped 3d inputs of a batch could be stacked along height
+    bool support_batch_pixels;
+
+    // keep context across the chunks of a stream in forward_streaming
+    bool support_streaming;
+
     bool support_reserved_3;
     bool support_reserved_4;
     bool support_reserved_5;
@@ -95,6 +112,12 @@ public:
     virtual int forward_inplace(std::vector<Mat>& bottom_top_blobs, const Option& opt) const;
     virtual int forward_inplace(Mat& bottom_top_blob, const Option& opt) const;
 
+    // implement inference on one chunk of a stream
+    // states carry the context of this layer from the previous chunk, empty at the start of a stream
+    // return 0 if success
+    virtual int forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& states, const Option& opt) const;
+    virtual int forward_streaming(const Mat& bottom_blob, Mat& top_blob, std::vector<Mat>& states, const Option& opt) const;
+
 #if NCNN_VULKAN
 public:
     // upload weight blob from host to device
@@ -40,6 +40,9 @@ int MatMul_arm::create_pipeline(const Option& opt)
     pd.set(10, -1);    // constant_broadcast_type_C = null
     pd.set(11, 0);     // output_N1M
     pd.set(12, 1);     // output_elempack
+    pd.set(20, constant_TILE_M);
+    pd.set(21, constant_TILE_N);
+    pd.set(22, constant_TILE_K);
 
     gemm->load_param(pd);
 
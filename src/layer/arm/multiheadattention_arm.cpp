@@ -3,11 +3,21 @@
 
 #include "multiheadattention_arm.h"
 
+#include <float.h>
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#include "neon_mathfun.h"
+#endif // __ARM_NEON
+
 #include "cpu.h"
 #include "layer_type.h"
+#include "profiler.h"
 
 namespace ncnn {
 
+#include "multiheadattention_flash.h"
+
 MultiHeadAttention_arm::MultiHeadAttention_arm()
 {
 #if __ARM_NEON
@@ -33,6 +43,14 @@ MultiHeadAttention_arm::MultiHeadAttention_arm()
 int MultiHeadAttention_arm::create_pipeline(const Option& _opt)
 {
     Option opt = _opt;
+    if (kv_cache)
+    {
+        // the caches are appended row by row in plain fp32 layout
+        support_packing = false;
+        support_fp16_storage = false;
+
+        opt.use_packing_layout = false;
+    }
     opt.use_fp16_storage &= support_fp16_storage;
     opt.use_bf16_storage &= support_bf16_storage;
 
@@ -99,7 +117,7 @@ int MultiHeadAttention_arm::create_pipeline(const Option& _opt)
         pd.set(10, 1);        // constant_broadcast_type_C
         pd.set(11, 0);        // output_N1M
         pd.set(12, 1);        // output_elempack
-        pd.set(14, 0);        // output_transpose
+        pd.set(14, kv_cache); // output_transpose
 #if NCNN_INT8
         pd.set(18, int8_scale_term);
 #endif
@@ -134,7 +152,7 @@ int MultiHeadAttention_arm::create_pipeline(const Option& _opt)
         pd.set(10, 1);        // constant_broadcast_type_C
         pd.set(11, 0);        // output_N1M
         pd.set(12, 1);        // output_elempack
-        pd.set(14, 0);        // output_transpose
+        pd.set(14, kv_cache); // output_transpose
 #if NCNN_INT8
         pd.set(18, int8_scale_term);
 #endif
@@ -194,7 +212,7 @@ int MultiHeadAttention_arm::create_pipeline(const Option& _opt)
         qk_gemm = ncnn::create_layer_cpu(ncnn::LayerType::Gemm);
         ncnn::ParamDict pd;
         pd.set(2, 1);                   // transA
-        pd.set(3, 0);                   // transB
+        pd.set(3, kv_cache);            // transB
         pd.set(4, 0);                   // constantA
         pd.set(5, 0);                   // constantB
         pd.set(6, attn_mask ? 0 : 1);   // constantC
@@ -217,18 +235,18 @@ int MultiHeadAttention_arm::create_pipeline(const Option& _opt)
     {
         qkv_gemm = ncnn::create_layer_cpu(ncnn::LayerType::Gemm);
         ncnn::ParamDict pd;
-        pd.set(2, 0);   // transA
-        pd.set(3, 1);   // transB
-        pd.set(4, 0);   // constantA
-        pd.set(5, 0);   // constantB
-        pd.set(6, 1);   // constantC
-        pd.set(7, 0);   // M
-        pd.set(8, 0);   // N
-        pd.set(9, 0);   // K
-        pd.set(10, -1); // constant_broadcast_type_C
-        pd.set(11, 0);  // output_N1M
-        pd.set(12, 1);  // output_elempack
-        pd.set(14, 1);  // output_transpose
+        pd.set(2, 0);                // transA
+        pd.set(3, kv_cache ? 0 : 1); // transB
+        pd.set(4, 0);                // constantA
+        pd.set(5, 0);                // constantB
+        pd.set(6, 1);                // constantC
+        pd.set(7, 0);                // M
+        pd.set(8, 0);                // N
+        pd.set(9, 0);                // K
+        pd.set(10, -1);              // constant_broadcast_type_C
+        pd.set(11, 0);               // output_N1M
+        pd.set(12, 1);               // output_elempack
+        pd.set(14, 1);               // output_transpose
 #if NCNN_INT8
         pd.set(18, int8_scale_term);
 #endif
@@ -245,6 +263,10 @@ int MultiHeadAttention_arm::create_pipeline(const Option& _opt)
 int MultiHeadAttention_arm::destroy_pipeline(const Option& _opt)
 {
     Option opt = _opt;
+    if (kv_cache)
+    {
+        opt.use_packing_layout = false;
+    }
     opt.use_fp16_storage &= support_fp16_storage;
     opt.use_bf16_storage &= support_bf16_storage;
 
@@ -300,14 +322,44 @@ int MultiHeadAttention_arm::destroy_pipeline(const Option& _opt)
     return 0;
 }
 
+static void append_kv_cache(const Mat& affine, Mat& cache, int past_seqlen, const Option& opt)
+{
+    // affine (embed_dim, seqlen)
+    // cache  (embed_dim_per_head, past_seqlen + seqlen, num_heads)
+    const int embed_dim_per_head = cache.w;
+    const int num_heads = cache.c;
+    const int seqlen = affine.h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < num_heads; q++)
+    {
+        Mat outm = cache.channel(q);
+
+        for (int i = 0; i < seqlen; i++)
+        {
+            const float* ptr = (const float*)affine.row(i) + q * embed_dim_per_head;
+            float* outptr = outm.row(past_seqlen + i);
+
+            memcpy(outptr, ptr, embed_dim_per_head * sizeof(float));
+        }
+    }
+}
+
 int MultiHeadAttention_arm::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& _opt) const
 {
+    // the past caches always come last
+    const size_t input_count = kv_cache ? bottom_blobs.size() - 2 : bottom_blobs.size();
+
     const Mat& q_blob = bottom_blobs[0];
-    const Mat& k_blob = (bottom_blobs.size() == 1 || (bottom_blobs.size() == 2 && attn_mask)) ? q_blob : bottom_blobs[1];
-    const Mat& v_blob = (bottom_blobs.size() == 1 || (bottom_blobs.size() == 2 && attn_mask)) ? q_blob : (bottom_blobs.size() == 2 || (bottom_blobs.size() == 3 && attn_mask)) ? k_blob : bottom_blobs[2];
-    const Mat& attn_mask_blob = attn_mask ? bottom_blobs[bottom_blobs.size() - 1] : Mat();
+    const Mat& k_blob = (input_count == 1 || (input_count == 2 && attn_mask)) ? q_blob : bottom_blobs[1];
+    const Mat& v_blob = (input_count == 1 || (input_count == 2 && attn_mask)) ? q_blob : (input_count == 2 || (input_count == 3 && attn_mask)) ? k_blob : bottom_blobs[2];
+    const Mat& attn_mask_blob = attn_mask ? bottom_blobs[input_count - 1] : Mat();
 
     Option opt = _opt;
+    if (kv_cache)
+    {
+        opt.use_packing_layout = false;
+    }
     opt.use_fp16_storage &= support_fp16_storage;
     opt.use_bf16_storage &= support_bf16_storage;
 
@@ -325,7 +377,9 @@ int MultiHeadAttention_arm::forward(const std::vector<Mat>& bottom_blobs, std::v
 
     const int embed_dim_per_head = embed_dim / num_heads;
     const int src_seqlen = q_blob.h * q_blob.elempack;
-    const int dst_seqlen = k_blob.h * k_blob.elempack;
+    const int cur_seqlen = k_blob.h * k_blob.elempack;
+    const int past_seqlen = kv_cache && bottom_blobs[input_count].dims == 3 ? bottom_blobs[input_count].h : 0;
+    const int dst_seqlen = past_seqlen + cur_seqlen;
 
     // const int elembits = q_blob.elembits();
 
@@ -341,71 +395,159 @@ int MultiHeadAttention_arm::forward(const std::vector<Mat>& bottom_blobs, std::v
     if (retk != 0)
         return retk;
 
-    Mat qk_cross(dst_seqlen, src_seqlen * num_heads, elemsize, opt.blob_allocator);
-    if (qk_cross.empty())
-        return -100;
-
-    std::vector<int> retqks;
-    retqks.resize(num_heads);
-    #pragma omp parallel for num_threads(opt.num_threads)
-    for (int i = 0; i < num_heads; i++)
+    if (kv_cache)
     {
-        std::vector<Mat> qk_bottom_blobs(2);
-        qk_bottom_blobs[0] = q_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
-        qk_bottom_blobs[1] = k_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
-        if (attn_mask)
-        {
-            const Mat& maskm = attn_mask_blob_unpacked.dims == 3 ? attn_mask_blob_unpacked.channel(i) : attn_mask_blob_unpacked;
-            qk_bottom_blobs.push_back(maskm);
-        }
-        std::vector<Mat> qk_top_blobs(1);
-        qk_top_blobs[0] = qk_cross.row_range(i * src_seqlen, src_seqlen);
-        Option opt1 = opt;
-        opt1.num_threads = 1;
-        retqks[i] = qk_gemm->forward(qk_bottom_blobs, qk_top_blobs, opt1);
-    }
-    for (int i = 0; i < num_heads; i++)
-    {
-        if (retqks[i] != 0)
-            return retqks[i];
-    }
-
-    q_affine.release();
-    k_affine.release();
+        retk = resize_kv_cache(bottom_blobs[input_count], cur_seqlen, 4u, top_blobs[1], opt);
+        if (retk != 0)
+            return retk;
 
-    int retqk = qk_softmax->forward_inplace(qk_cross, opt);
-    if (retqk != 0)
-        return retqk;
+        append_kv_cache(k_affine, top_blobs[1], past_seqlen, opt);
+    }
 
     Mat v_affine;
     int retv = v_gemm->forward(v_blob, v_affine, opt);
     if (retv != 0)
         return retv;
 
+    if (kv_cache)
+    {
+        retv = resize_kv_cache(bottom_blobs[input_count + 1], cur_seqlen, 4u, top_blobs[2], opt);
+        if (retv != 0)
+            return retv;
+
+        append_kv_cache(v_affine, top_blobs[2], past_seqlen, opt);
+    }
+
     Mat qkv_cross(src_seqlen, embed_dim_per_head * num_heads, elemsize, opt.blob_allocator);
     if (qkv_cross.empty())
         return -100;
 
-    std::vector<int> retqkvs;
-    retqkvs.resize(num_heads);
-    #pragma omp parallel for num_threads(opt.num_threads)
-    for (int i = 0; i < num_heads; i++)
+    // the fused kernel never materializes the (dst_seqlen, src_seqlen) score matrix
+    // incremental decoding and short sequences gain nothing from it, leave them to gemm
+    const bool use_flash_attention = !int8_scale_term && elemsize == 4u && src_seqlen >= FLASH_ATTENTION_MIN_SRC_SEQLEN && dst_seqlen >= FLASH_ATTENTION_MIN_DST_SEQLEN;
+
+    if (use_flash_attention)
     {
-        std::vector<Mat> qkv_bottom_blobs(2);
-        qkv_bottom_blobs[0] = qk_cross.row_range(i * src_seqlen, src_seqlen);
-        qkv_bottom_blobs[1] = v_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
-        std::vector<Mat> qkv_top_blobs(1);
-        qkv_top_blobs[0] = qkv_cross.row_range(i * embed_dim_per_head, embed_dim_per_head);
-        Option opt1 = opt;
-        opt1.num_threads = 1;
-        retqkvs[i] = qkv_gemm->forward(qkv_bottom_blobs, qkv_top_blobs, opt1);
+        profiler_set_kernel("flash_attention");
+
+        // keys feature major and values token major
+        Mat k_affine_t;
+        Mat v_affine_t;
+        if (kv_cache)
+        {
+            k_affine_t.create(dst_seqlen, embed_dim, 4u, opt.workspace_allocator);
+            if (k_affine_t.empty())
+                return -100;
+        }
+        else
+        {
+            v_affine_t.create(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
+            if (v_affine_t.empty())
+                return -100;
+        }
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_heads; i++)
+        {
+            if (kv_cache)
+            {
+                Mat outm = k_affine_t.row_range(i * embed_dim_per_head, embed_dim_per_head);
+                flash_attention_transpose(top_blobs[1].channel(i), outm);
+            }
+            else
+            {
+                Mat outm = v_affine_t.channel(i);
+                flash_attention_transpose(v_affine.row_range(i * embed_dim_per_head, embed_dim_per_head), outm);
+            }
+        }
+
+        const int nn_block = (src_seqlen + FLASH_ATTENTION_QUERY_BLOCK - 1) / FLASH_ATTENTION_QUERY_BLOCK;
+
+        Mat workspace(flash_attention_workspace_size(embed_dim_per_head), 1, opt.num_threads, 4u, opt.workspace_allocator);
+        if (workspace.empty())
+            return -100;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int ib = 0; ib < num_heads * nn_block; ib++)
+        {
+            const int i = ib / nn_block;
+            const int i0 = ib % nn_block * FLASH_ATTENTION_QUERY_BLOCK;
+            const int i1 = std::min(i0 + FLASH_ATTENTION_QUERY_BLOCK, src_seqlen);
+
+            const Mat q = q_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
+            const Mat k = kv_cache ? k_affine_t.row_range(i * embed_dim_per_head, embed_dim_per_head) : k_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
+            const Mat v = kv_cache ? top_blobs[2].channel(i) : v_affine_t.channel(i);
+            Mat out = qkv_cross.row_range(i * embed_dim_per_head, embed_dim_per_head);
+
+            Mat maskm;
+            if (attn_mask)
+            {
+                maskm = attn_mask_blob_unpacked.dims == 3 ? attn_mask_blob_unpacked.channel(i) : attn_mask_blob_unpacked;
+            }
+
+            flash_attention(q, k, v, maskm, out, i0, i1, workspace.channel(get_omp_thread_num()));
+        }
     }
-    for (int i = 0; i < num_heads; i++)
+    else
     {
-        if (retqkvs[i] != 0)
-            return retqkvs[i];
+        profiler_set_kernel("gemm_softmax_gemm");
+
+        Mat qk_cross(dst_seqlen, src_seqlen * num_heads, elemsize, opt.blob_allocator);
+        if (qk_cross.empty())
+            return -100;
+
+        std::vector<int> retqks;
+        retqks.resize(num_heads);
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_heads; i++)
+        {
+            std::vector<Mat> qk_bottom_blobs(2);
+            qk_bottom_blobs[0] = q_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
+            qk_bottom_blobs[1] = kv_cache ? top_blobs[1].channel(i) : k_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
+            if (attn_mask)
+            {
+                const Mat& maskm = attn_mask_blob_unpacked.dims == 3 ? attn_mask_blob_unpacked.channel(i) : attn_mask_blob_unpacked;
+                qk_bottom_blobs.push_back(maskm);
+            }
+            std::vector<Mat> qk_top_blobs(1);
+            qk_top_blobs[0] = qk_cross.row_range(i * src_seqlen, src_seqlen);
+            Option opt1 = opt;
+            opt1.num_threads = 1;
+            retqks[i] = qk_gemm->forward(qk_bottom_blobs, qk_top_blobs, opt1);
+        }
+        for (int i = 0; i < num_heads; i++)
+        {
+            if (retqks[i] != 0)
+                return retqks[i];
+        }
+
+        int retqk = qk_softmax->forward_inplace(qk_cross, opt);
+        if (retqk != 0)
+            return retqk;
+
+        std::vector<int> retqkvs;
+        retqkvs.resize(num_heads);
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < num_heads; i++)
+        {
+            std::vector<Mat> qkv_bottom_blobs(2);
+            qkv_bottom_blobs[0] = qk_cross.row_range(i * src_seqlen, src_seqlen);
+            qkv_bottom_blobs[1] = kv_cache ? top_blobs[2].channel(i) : v_affine.row_range(i * embed_dim_per_head, embed_dim_per_head);
+            std::vector<Mat> qkv_top_blobs(1);
+            qkv_top_blobs[0] = qkv_cross.row_range(i * embed_dim_per_head, embed_dim_per_head);
+            Option opt1 = opt;
+            opt1.num_threads = 1;
+            retqkvs[i] = qkv_gemm->forward(qkv_bottom_blobs, qkv_top_blobs, opt1);
+        }
+        for (int i = 0; i < num_heads; i++)
+        {
+            if (retqkvs[i] != 0)
+                return retqkvs[i];
+        }
     }
 
+    q_affine.release();
+    k_affine.release();
     v_affine.release();
 
     int reto = o_gemm->forward(qkv_cross, top_blobs[0], opt);
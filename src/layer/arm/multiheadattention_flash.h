@@ -0,0 +1,360 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// fused qk softmax qkv, one group of queries runs through all keys with an online softmax
+// queries sit in vector lanes so that the running max and sum need no horizontal reduction
+// two vectors of queries share every key and value broadcast
+#if __ARM_NEON
+#define FLASH_ATTENTION_LANES 8
+#else
+#define FLASH_ATTENTION_LANES 1
+#endif
+
+// keys per online softmax step
+#define FLASH_ATTENTION_BLOCK 64
+
+// queries per parallel task
+#define FLASH_ATTENTION_QUERY_BLOCK 64
+
+// short sequences go through the gemm path
+#define FLASH_ATTENTION_MIN_SRC_SEQLEN 16
+#define FLASH_ATTENTION_MIN_DST_SEQLEN 256
+
+static int flash_attention_workspace_size(int embed_dim_per_head)
+{
+    // qbuf + obuf + sbuf + max + sum
+    return (embed_dim_per_head * 2 + FLASH_ATTENTION_BLOCK + 2) * FLASH_ATTENTION_LANES;
+}
+
+static void flash_attention_transpose(const Mat& in, Mat& out)
+{
+    // in (w, h) to out (h, w)
+    for (int i = 0; i < in.h; i++)
+    {
+        const float* ptr = in.row(i);
+
+        for (int j = 0; j < in.w; j++)
+        {
+            out.row(j)[i] = ptr[j];
+        }
+    }
+}
+
+// q    (src_seqlen, embed_dim_per_head) already scaled
+// k    (dst_seqlen, embed_dim_per_head)
+// v    (embed_dim_per_head, dst_seqlen)
+// mask (dst_seqlen, src_seqlen) or empty
+// out  (src_seqlen, embed_dim_per_head)
+// handles queries [i0, i1)
+static void flash_attention(const Mat& q, const Mat& k, const Mat& v, const Mat& mask, Mat& out, int i0, int i1, float* workspace)
+{
+    const int L = FLASH_ATTENTION_LANES;
+    const int embed_dim_per_head = q.h;
+    const int dst_seqlen = k.w;
+
+    float* qbuf = workspace;
+    float* obuf = qbuf + embed_dim_per_head * L;
+    float* sbuf = obuf + embed_dim_per_head * L;
+    float* mbuf = sbuf + FLASH_ATTENTION_BLOCK * L;
+    float* lbuf = mbuf + L;
+
+    for (int i = i0; i < i1; i += L)
+    {
+        const int max_ii = std::min(L, i1 - i);
+
+        const float* qptr = q.row(0) + i;
+        int qstride = q.w;
+        if (max_ii < L)
+        {
+            // zero padded tail
+            for (int d = 0; d < embed_dim_per_head; d++)
+            {
+                const float* ptr = q.row(d) + i;
+                for (int ii = 0; ii < L; ii++)
+                {
+                    qbuf[d * L + ii] = ii < max_ii ? ptr[ii] : 0.f;
+                }
+            }
+
+            qptr = qbuf;
+            qstride = L;
+        }
+
+        for (int ii = 0; ii < L; ii++)
+        {
+            mbuf[ii] = -FLT_MAX;
+            lbuf[ii] = 0.f;
+        }
+        memset(obuf, 0, embed_dim_per_head * L * sizeof(float));
+
+        for (int j = 0; j < dst_seqlen; j += FLASH_ATTENTION_BLOCK)
+        {
+            const int max_jj = std::min(FLASH_ATTENTION_BLOCK, dst_seqlen - j);
+
+            // s = q * k
+            int jj = 0;
+#if __ARM_NEON
+            for (; jj + 3 < max_jj; jj += 4)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                float32x4_t _s00 = vdupq_n_f32(0.f);
+                float32x4_t _s01 = vdupq_n_f32(0.f);
+                float32x4_t _s10 = vdupq_n_f32(0.f);
+                float32x4_t _s11 = vdupq_n_f32(0.f);
+                float32x4_t _s20 = vdupq_n_f32(0.f);
+                float32x4_t _s21 = vdupq_n_f32(0.f);
+                float32x4_t _s30 = vdupq_n_f32(0.f);
+                float32x4_t _s31 = vdupq_n_f32(0.f);
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    float32x4_t _q0 = vld1q_f32(qp);
+                    float32x4_t _q1 = vld1q_f32(qp + 4);
+                    float32x4_t _k = vld1q_f32(kp);
+#if __aarch64__
+                    _s00 = vfmaq_laneq_f32(_s00, _q0, _k, 0);
+                    _s01 = vfmaq_laneq_f32(_s01, _q1, _k, 0);
+                    _s10 = vfmaq_laneq_f32(_s10, _q0, _k, 1);
+                    _s11 = vfmaq_laneq_f32(_s11, _q1, _k, 1);
+                    _s20 = vfmaq_laneq_f32(_s20, _q0, _k, 2);
+                    _s21 = vfmaq_laneq_f32(_s21, _q1, _k, 2);
+                    _s30 = vfmaq_laneq_f32(_s30, _q0, _k, 3);
+                    _s31 = vfmaq_laneq_f32(_s31, _q1, _k, 3);
+#else
+                    _s00 = vmlaq_lane_f32(_s00, _q0, vget_low_f32(_k), 0);
+                    _s01 = vmlaq_lane_f32(_s01, _q1, vget_low_f32(_k), 0);
+                    _s10 = vmlaq_lane_f32(_s10, _q0, vget_low_f32(_k), 1);
+                    _s11 = vmlaq_lane_f32(_s11, _q1, vget_low_f32(_k), 1);
+                    _s20 = vmlaq_lane_f32(_s20, _q0, vget_high_f32(_k), 0);
+                    _s21 = vmlaq_lane_f32(_s21, _q1, vget_high_f32(_k), 0);
+                    _s30 = vmlaq_lane_f32(_s30, _q0, vget_high_f32(_k), 1);
+                    _s31 = vmlaq_lane_f32(_s31, _q1, vget_high_f32(_k), 1);
+#endif
+                    qp += qstride;
+                    kp += k.w;
+                }
+                vst1q_f32(sbuf + jj * L, _s00);
+                vst1q_f32(sbuf + jj * L + 4, _s01);
+                vst1q_f32(sbuf + (jj + 1) * L, _s10);
+                vst1q_f32(sbuf + (jj + 1) * L + 4, _s11);
+                vst1q_f32(sbuf + (jj + 2) * L, _s20);
+                vst1q_f32(sbuf + (jj + 2) * L + 4, _s21);
+                vst1q_f32(sbuf + (jj + 3) * L, _s30);
+                vst1q_f32(sbuf + (jj + 3) * L + 4, _s31);
+            }
+            for (; jj < max_jj; jj++)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                float32x4_t _s00 = vdupq_n_f32(0.f);
+                float32x4_t _s01 = vdupq_n_f32(0.f);
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    float32x4_t _q0 = vld1q_f32(qp);
+                    float32x4_t _q1 = vld1q_f32(qp + 4);
+                    float32x4_t _k = vdupq_n_f32(kp[0]);
+#if __aarch64__
+                    _s00 = vfmaq_f32(_s00, _q0, _k);
+                    _s01 = vfmaq_f32(_s01, _q1, _k);
+#else
+                    _s00 = vmlaq_f32(_s00, _q0, _k);
+                    _s01 = vmlaq_f32(_s01, _q1, _k);
+#endif
+                    qp += qstride;
+                    kp += k.w;
+                }
+                vst1q_f32(sbuf + jj * L, _s00);
+                vst1q_f32(sbuf + jj * L + 4, _s01);
+            }
+#else
+            for (; jj < max_jj; jj++)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                float s0 = 0.f;
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    s0 += qp[0] * kp[0];
+                    qp += qstride;
+                    kp += k.w;
+                }
+                sbuf[jj] = s0;
+            }
+#endif
+
+            // s = s + mask
+            if (!mask.empty())
+            {
+                for (int ii = 0; ii < max_ii; ii++)
+                {
+                    const float* mptr = mask.row(i + ii) + j;
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        sbuf[jj * L + ii] += mptr[jj];
+                    }
+                }
+            }
+
+            // p = exp(s - max)
+            // o = o * exp(max_old - max) + p * v
+#if __ARM_NEON
+            {
+                float32x4_t _max00 = vld1q_f32(mbuf);
+                float32x4_t _max01 = vld1q_f32(mbuf + 4);
+                float32x4_t _max0 = _max00;
+                float32x4_t _max1 = _max01;
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    _max0 = vmaxq_f32(_max0, vld1q_f32(sbuf + jj * L));
+                    _max1 = vmaxq_f32(_max1, vld1q_f32(sbuf + jj * L + 4));
+                }
+
+                float32x4_t _alpha0 = exp_ps(vsubq_f32(_max00, _max0));
+                float32x4_t _alpha1 = exp_ps(vsubq_f32(_max01, _max1));
+                float32x4_t _sum0 = vdupq_n_f32(0.f);
+                float32x4_t _sum1 = vdupq_n_f32(0.f);
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    float32x4_t _p0 = exp_ps(vsubq_f32(vld1q_f32(sbuf + jj * L), _max0));
+                    float32x4_t _p1 = exp_ps(vsubq_f32(vld1q_f32(sbuf + jj * L + 4), _max1));
+                    vst1q_f32(sbuf + jj * L, _p0);
+                    vst1q_f32(sbuf + jj * L + 4, _p1);
+                    _sum0 = vaddq_f32(_sum0, _p0);
+                    _sum1 = vaddq_f32(_sum1, _p1);
+                }
+
+                vst1q_f32(mbuf, _max0);
+                vst1q_f32(mbuf + 4, _max1);
+                vst1q_f32(lbuf, vaddq_f32(vmulq_f32(vld1q_f32(lbuf), _alpha0), _sum0));
+                vst1q_f32(lbuf + 4, vaddq_f32(vmulq_f32(vld1q_f32(lbuf + 4), _alpha1), _sum1));
+
+                int d = 0;
+                for (; d + 3 < embed_dim_per_head; d += 4)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    float32x4_t _o00 = vmulq_f32(vld1q_f32(op), _alpha0);
+                    float32x4_t _o01 = vmulq_f32(vld1q_f32(op + 4), _alpha1);
+                    float32x4_t _o10 = vmulq_f32(vld1q_f32(op + L), _alpha0);
+                    float32x4_t _o11 = vmulq_f32(vld1q_f32(op + L + 4), _alpha1);
+                    float32x4_t _o20 = vmulq_f32(vld1q_f32(op + L * 2), _alpha0);
+                    float32x4_t _o21 = vmulq_f32(vld1q_f32(op + L * 2 + 4), _alpha1);
+                    float32x4_t _o30 = vmulq_f32(vld1q_f32(op + L * 3), _alpha0);
+                    float32x4_t _o31 = vmulq_f32(vld1q_f32(op + L * 3 + 4), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        float32x4_t _p0 = vld1q_f32(sbuf + jj * L);
+                        float32x4_t _p1 = vld1q_f32(sbuf + jj * L + 4);
+                        float32x4_t _v = vld1q_f32(vp);
+#if __aarch64__
+                        _o00 = vfmaq_laneq_f32(_o00, _p0, _v, 0);
+                        _o01 = vfmaq_laneq_f32(_o01, _p1, _v, 0);
+                        _o10 = vfmaq_laneq_f32(_o10, _p0, _v, 1);
+                        _o11 = vfmaq_laneq_f32(_o11, _p1, _v, 1);
+                        _o20 = vfmaq_laneq_f32(_o20, _p0, _v, 2);
+                        _o21 = vfmaq_laneq_f32(_o21, _p1, _v, 2);
+                        _o30 = vfmaq_laneq_f32(_o30, _p0, _v, 3);
+                        _o31 = vfmaq_laneq_f32(_o31, _p1, _v, 3);
+#else
+                        _o00 = vmlaq_lane_f32(_o00, _p0, vget_low_f32(_v), 0);
+                        _o01 = vmlaq_lane_f32(_o01, _p1, vget_low_f32(_v), 0);
+                        _o10 = vmlaq_lane_f32(_o10, _p0, vget_low_f32(_v), 1);
+                        _o11 = vmlaq_lane_f32(_o11, _p1, vget_low_f32(_v), 1);
+                        _o20 = vmlaq_lane_f32(_o20, _p0, vget_high_f32(_v), 0);
+                        _o21 = vmlaq_lane_f32(_o21, _p1, vget_high_f32(_v), 0);
+                        _o30 = vmlaq_lane_f32(_o30, _p0, vget_high_f32(_v), 1);
+                        _o31 = vmlaq_lane_f32(_o31, _p1, vget_high_f32(_v), 1);
+#endif
+                        vp += v.w;
+                    }
+                    vst1q_f32(op, _o00);
+                    vst1q_f32(op + 4, _o01);
+                    vst1q_f32(op + L, _o10);
+                    vst1q_f32(op + L + 4, _o11);
+                    vst1q_f32(op + L * 2, _o20);
+                    vst1q_f32(op + L * 2 + 4, _o21);
+                    vst1q_f32(op + L * 3, _o30);
+                    vst1q_f32(op + L * 3 + 4, _o31);
+                }
+                for (; d < embed_dim_per_head; d++)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    float32x4_t _o00 = vmulq_f32(vld1q_f32(op), _alpha0);
+                    float32x4_t _o01 = vmulq_f32(vld1q_f32(op + 4), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        float32x4_t _p0 = vld1q_f32(sbuf + jj * L);
+                        float32x4_t _p1 = vld1q_f32(sbuf + jj * L + 4);
+                        float32x4_t _v = vdupq_n_f32(vp[0]);
+#if __aarch64__
+                        _o00 = vfmaq_f32(_o00, _p0, _v);
+                        _o01 = vfmaq_f32(_o01, _p1, _v);
+#else
+                        _o00 = vmlaq_f32(_o00, _p0, _v);
+                        _o01 = vmlaq_f32(_o01, _p1, _v);
+#endif
+                        vp += v.w;
+                    }
+                    vst1q_f32(op, _o00);
+                    vst1q_f32(op + 4, _o01);
+                }
+            }
+#else
+            {
+                float max = mbuf[0];
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    max = std::max(max, sbuf[jj]);
+                }
+
+                const float alpha = expf(mbuf[0] - max);
+                float sum = 0.f;
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    sbuf[jj] = expf(sbuf[jj] - max);
+                    sum += sbuf[jj];
+                }
+
+                mbuf[0] = max;
+                lbuf[0] = lbuf[0] * alpha + sum;
+
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    const float* vp = v.row(j) + d;
+
+                    float o = obuf[d] * alpha;
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        o += sbuf[jj] * vp[0];
+                        vp += v.w;
+                    }
+                    obuf[d] = o;
+                }
+            }
+#endif
+        }
+
+        // out = o / sum
+        for (int ii = 0; ii < L; ii++)
+        {
+            lbuf[ii] = 1.f / lbuf[ii];
+        }
+
+        for (int d = 0; d < embed_dim_per_head; d++)
+        {
+            const float* op = obuf + d * L;
+            float* outptr = out.row(d) + i;
+
+            for (int ii = 0; ii < max_ii; ii++)
+            {
+                outptr[ii] = op[ii] * lbuf[ii];
+            }
+        }
+    }
+}
@@ -9,6 +9,7 @@ BatchNorm::BatchNorm()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_pixels = true;
 }
 
 int BatchNorm::load_param(const ParamDict& pd)
@@ -9,6 +9,8 @@ BinaryOp::BinaryOp()
 {
     one_blob_only = false;
     support_inplace = false;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int BinaryOp::load_param(const ParamDict& pd)
@@ -11,6 +11,8 @@ Clip::Clip()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int Clip::load_param(const ParamDict& pd)
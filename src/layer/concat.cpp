@@ -15,6 +15,9 @@ int Concat::load_param(const ParamDict& pd)
 {
     axis = pd.get(0, 0);
 
+    // channel concat keeps pixels independent
+    support_batch_pixels = axis == 0 || axis == -3;
+
     return 0;
 }
 
@@ -42,6 +42,10 @@ int Convolution::load_param(const ParamDict& pd)
         one_blob_only = false;
     }
 
+    // pointwise convolution keeps pixels independent
+    support_batch_pixels = kernel_w == 1 && kernel_h == 1 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1
+                           && pad_left == 0 && pad_right == 0 && pad_top == 0 && pad_bottom == 0 && !dynamic_weight;
+
     if (int8_scale_term)
     {
 #if NCNN_INT8
@@ -4,6 +4,7 @@
 #include "convolution1d.h"
 
 #include "fused_activation.h"
+#include "streaming.h"
 
 namespace ncnn {
 
@@ -34,6 +35,8 @@ int Convolution1D::load_param(const ParamDict& pd)
         one_blob_only = false;
     }
 
+    support_streaming = !dynamic_weight && (stride_w == 1 || (pad_left >= 0 && pad_right >= 0));
+
     return 0;
 }
 
@@ -175,6 +178,20 @@ int Convolution1D::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat
     return 0;
 }
 
+int Convolution1D::forward_streaming(const Mat& bottom_blob, Mat& top_blob, std::vector<Mat>& states, const Option& opt) const
+{
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+
+    // auto padding of stride 1 does not depend on the input width
+    int streaming_pad_left = pad_left;
+    if (pad_left == -233)
+        streaming_pad_left = (kernel_extent_w - 1) / 2;
+    if (pad_left == -234)
+        streaming_pad_left = kernel_extent_w - 1 - (kernel_extent_w - 1) / 2;
+
+    return forward_streaming_window(this, bottom_blob, top_blob, states, kernel_extent_w, stride_w, streaming_pad_left, opt);
+}
+
 void Convolution1D::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const
 {
     make_padding(bottom_blob, bottom_blob_bordered, kernel_w, opt);
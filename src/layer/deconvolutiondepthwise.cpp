@@ -33,6 +33,7 @@ int DeconvolutionDepthWise::load_param(const ParamDict& pd)
     bias_term = pd.get(5, 0);
     weight_data_size = pd.get(6, 0);
     group = pd.get(7, 1);
+    int8_scale_term = pd.get(8, 0);
     activation_type = pd.get(9, 0);
     activation_params = pd.get(10, Mat());
 
@@ -43,6 +44,16 @@ int DeconvolutionDepthWise::load_param(const ParamDict& pd)
         one_blob_only = false;
     }
 
+    if (int8_scale_term)
+    {
+#if NCNN_INT8
+        support_int8_storage = true;
+#else
+        NCNN_LOGE("please build ncnn with NCNN_INT8 enabled for int8 inference");
+        return -1;
+#endif
+    }
+
     return 0;
 }
 
@@ -62,6 +73,51 @@ int DeconvolutionDepthWise::load_model(const ModelBin& mb)
             return -100;
     }
 
+#if NCNN_INT8
+    if (int8_scale_term == 1)
+    {
+        weight_data_int8_scales = mb.load(group, 1);
+        bottom_blob_int8_scales = mb.load(1, 1);
+    }
+    else if (int8_scale_term == 2)
+    {
+        weight_data_int8_scales = mb.load(1, 1);
+        bottom_blob_int8_scales = mb.load(1, 1);
+
+        // extend group if only one provided
+        float weight_data_int8_scale = weight_data_int8_scales[0];
+        weight_data_int8_scales = Mat(group);
+        weight_data_int8_scales.fill(weight_data_int8_scale);
+    }
+#endif // NCNN_INT8
+
+#if NCNN_INT8
+    // runtime quantize the weight data
+    if (weight_data.elemsize == (size_t)4u && int8_scale_term)
+    {
+        Mat int8_weight_data(weight_data_size, (size_t)1u);
+        if (int8_weight_data.empty())
+            return -100;
+
+        const int weight_data_size_g = weight_data_size / group;
+
+        for (int g = 0; g < group; g++)
+        {
+            Option opt_q;
+            opt_q.num_threads = 1;
+            opt_q.blob_allocator = int8_weight_data.allocator;
+            opt_q.use_packing_layout = false;
+
+            const Mat weight_data_g = weight_data.range(weight_data_size_g * g, weight_data_size_g);
+            Mat int8_weight_data_g = int8_weight_data.range(weight_data_size_g * g, weight_data_size_g);
+            const Mat weight_data_int8_scales_g = weight_data_int8_scales.range(g, 1);
+            quantize_to_int8(weight_data_g, int8_weight_data_g, weight_data_int8_scales_g, opt_q);
+        }
+
+        weight_data = int8_weight_data;
+    }
+#endif // NCNN_INT8
+
     return 0;
 }
 
@@ -208,6 +264,13 @@ static int deconvolutiondepthwise(const Mat& bottom_blob, Mat& top_blob, const M
 
 int DeconvolutionDepthWise::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if NCNN_INT8
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    {
+        return forward_int8(bottom_blob, top_blob, opt);
+    }
+#endif
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     size_t elemsize = bottom_blob.elemsize;
@@ -357,4 +420,125 @@ void DeconvolutionDepthWise::cut_padding(const Mat& top_blob_bordered, Mat& top_
     }
 }
 
+#if NCNN_INT8
+int DeconvolutionDepthWise::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int inch = bottom_blob.c;
+
+    Mat bottom_blob_int8 = bottom_blob;
+    if (bottom_blob.elemsize != 1)
+    {
+        Option opt_g = opt;
+        opt_g.blob_allocator = opt.workspace_allocator;
+
+        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_g);
+        if (bottom_blob_int8.empty())
+            return -100;
+    }
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w - 1) * stride_w + kernel_extent_w + output_pad_right;
+    const int outh = (h - 1) * stride_h + kernel_extent_h + output_pad_bottom;
+
+    const int maxk = kernel_w * kernel_h;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = outw * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    Mat top_blob_bordered;
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || (output_w > 0 && output_h > 0))
+    {
+        top_blob_bordered.create(outw, outh, num_output, 4u, opt.workspace_allocator);
+    }
+    else
+    {
+        top_blob_bordered = top_blob;
+        top_blob_bordered.create(outw, outh, num_output, 4u, opt.blob_allocator);
+    }
+    if (top_blob_bordered.empty())
+        return -100;
+
+    const int inch_g = inch / group;
+    const int outch_g = num_output / group;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        const int g = p / outch_g;
+
+        Mat out = top_blob_bordered.channel(p);
+
+        // accumulate int32 sums in place of the fp32 output
+        int* outptr0 = out;
+        memset(outptr0, 0, out.w * out.h * sizeof(int));
+
+        const signed char* weight_data_ptr = (const signed char*)weight_data + maxk * inch_g * outch_g * g;
+
+        for (int i = 0; i < h; i++)
+        {
+            for (int j = 0; j < w; j++)
+            {
+                int* outptr = outptr0 + i * stride_h * outw + j * stride_w;
+
+                const signed char* kptr = weight_data_ptr + maxk * inch_g * (p - g * outch_g);
+
+                for (int q = 0; q < inch_g; q++)
+                {
+                    const int val = bottom_blob_int8.channel(inch_g * g + q).row<const signed char>(i)[j];
+
+                    for (int k = 0; k < maxk; k++)
+                    {
+                        outptr[space_ofs[k]] += val * kptr[k];
+                    }
+
+                    kptr += maxk;
+                }
+            }
+        }
+
+        float scale_in;
+        if (weight_data_int8_scales[g] == 0)
+            scale_in = 0;
+        else
+            scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[g]);
+
+        const float bias = bias_term ? bias_data[p] : 0.f;
+
+        float* outptr = out;
+        const int size = outw * outh;
+        for (int i = 0; i < size; i++)
+        {
+            float sumfp32 = outptr0[i] * scale_in + bias;
+            outptr[i] = activation_ss(sumfp32, activation_type, activation_params);
+        }
+    }
+
+    cut_padding(top_blob_bordered, top_blob, opt);
+    if (top_blob.empty())
+        return -100;
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
@@ -9,6 +9,8 @@ Dropout::Dropout()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int Dropout::load_param(const ParamDict& pd)
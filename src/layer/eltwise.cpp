@@ -9,6 +9,8 @@ Eltwise::Eltwise()
 {
     one_blob_only = false;
     support_inplace = false; // TODO inplace reduction
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int Eltwise::load_param(const ParamDict& pd)
@@ -9,6 +9,8 @@ ELU::ELU()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int ELU::load_param(const ParamDict& pd)
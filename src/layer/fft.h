@@ -0,0 +1,615 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_FFT_H
+#define LAYER_FFT_H
+
+#include "platform.h"
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#endif // __ARM_NEON
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+namespace ncnn {
+
+// mixed radix fft shared by Spectrogram and InverseSpectrogram
+//
+// a batch of sequences is transformed at once in split complex layout,
+// element t of sequence b lives at re[t * batch + b] and im[t * batch + b]
+// every butterfly then runs over contiguous runs of the whole batch with simd
+//
+// self-sorting stockham stages, radix 4 and 2 first, then 3 and any other prime
+
+// radices and stage twiddles of a complex fft of size n
+struct FFTPlan
+{
+    int n;
+    std::vector<int> radices;
+
+    // per stage, (re, im) of w(n_stage)^(p * u) for p in [0, n_stage / r) and u in [1, r)
+    // then w(r)^k for k in [0, r) for the generic radix
+    std::vector<float> twiddles;
+};
+
+// complex fft of size n / 2 and the twiddles w(n)^k for k in [0, n / 2] unpacking real input of even size n
+// plain complex fft of size n for odd n
+struct RFFTPlan
+{
+    int n;
+    FFTPlan plan;
+    std::vector<float> twiddles;
+};
+
+static inline void fft_create_plan(FFTPlan& plan, int n)
+{
+    plan.n = n;
+    plan.radices.clear();
+    plan.twiddles.clear();
+
+    int rest = n;
+    while (rest % 4 == 0)
+    {
+        plan.radices.push_back(4);
+        rest /= 4;
+    }
+    while (rest % 2 == 0)
+    {
+        plan.radices.push_back(2);
+        rest /= 2;
+    }
+    for (int r = 3; r * r <= rest; r += 2)
+    {
+        while (rest % r == 0)
+        {
+            plan.radices.push_back(r);
+            rest /= r;
+        }
+    }
+    if (rest > 1)
+    {
+        plan.radices.push_back(rest);
+    }
+
+    int n_stage = n;
+    for (size_t i = 0; i < plan.radices.size(); i++)
+    {
+        const int r = plan.radices[i];
+        const int m = n_stage / r;
+
+        for (int p = 0; p < m; p++)
+        {
+            for (int u = 1; u < r; u++)
+            {
+                double angle = -2 * 3.14159265358979323846 * p * u / n_stage;
+                plan.twiddles.push_back((float)cos(angle));
+                plan.twiddles.push_back((float)sin(angle));
+            }
+        }
+
+        if (r != 2 && r != 3 && r != 4)
+        {
+            for (int k = 0; k < r; k++)
+            {
+                double angle = -2 * 3.14159265358979323846 * k / r;
+                plan.twiddles.push_back((float)cos(angle));
+                plan.twiddles.push_back((float)sin(angle));
+            }
+        }
+
+        n_stage = m;
+    }
+}
+
+static inline void rfft_create_plan(RFFTPlan& plan, int n)
+{
+    plan.n = n;
+    plan.twiddles.clear();
+
+    if (n % 2 != 0)
+    {
+        fft_create_plan(plan.plan, n);
+        return;
+    }
+
+    fft_create_plan(plan.plan, n / 2);
+
+    for (int k = 0; k <= n / 2; k++)
+    {
+        double angle = -2 * 3.14159265358979323846 * k / n;
+        plan.twiddles.push_back((float)cos(angle));
+        plan.twiddles.push_back((float)sin(angle));
+    }
+}
+
+// y0 = x0 + x1, y1 = (x0 - x1) * w1
+static inline void fft_radix2(const float* xr, const float* xi, int xstep, float* yr, float* yi, int ystep, const float* w, int size)
+{
+    const float* x0r = xr;
+    const float* x0i = xi;
+    const float* x1r = xr + xstep;
+    const float* x1i = xi + xstep;
+    float* y0r = yr;
+    float* y0i = yi;
+    float* y1r = yr + ystep;
+    float* y1i = yi + ystep;
+
+    const float w1r = w[0];
+    const float w1i = w[1];
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+    {
+        __m256 _w1r = _mm256_set1_ps(w1r);
+        __m256 _w1i = _mm256_set1_ps(w1i);
+        for (; i + 7 < size; i += 8)
+        {
+            __m256 _ar = _mm256_loadu_ps(x0r + i);
+            __m256 _ai = _mm256_loadu_ps(x0i + i);
+            __m256 _br = _mm256_loadu_ps(x1r + i);
+            __m256 _bi = _mm256_loadu_ps(x1i + i);
+            __m256 _dr = _mm256_sub_ps(_ar, _br);
+            __m256 _di = _mm256_sub_ps(_ai, _bi);
+            _mm256_storeu_ps(y0r + i, _mm256_add_ps(_ar, _br));
+            _mm256_storeu_ps(y0i + i, _mm256_add_ps(_ai, _bi));
+            _mm256_storeu_ps(y1r + i, _mm256_sub_ps(_mm256_mul_ps(_dr, _w1r), _mm256_mul_ps(_di, _w1i)));
+            _mm256_storeu_ps(y1i + i, _mm256_add_ps(_mm256_mul_ps(_dr, _w1i), _mm256_mul_ps(_di, _w1r)));
+        }
+    }
+#endif // __AVX__
+    {
+        __m128 _w1r = _mm_set1_ps(w1r);
+        __m128 _w1i = _mm_set1_ps(w1i);
+        for (; i + 3 < size; i += 4)
+        {
+            __m128 _ar = _mm_loadu_ps(x0r + i);
+            __m128 _ai = _mm_loadu_ps(x0i + i);
+            __m128 _br = _mm_loadu_ps(x1r + i);
+            __m128 _bi = _mm_loadu_ps(x1i + i);
+            __m128 _dr = _mm_sub_ps(_ar, _br);
+            __m128 _di = _mm_sub_ps(_ai, _bi);
+            _mm_storeu_ps(y0r + i, _mm_add_ps(_ar, _br));
+            _mm_storeu_ps(y0i + i, _mm_add_ps(_ai, _bi));
+            _mm_storeu_ps(y1r + i, _mm_sub_ps(_mm_mul_ps(_dr, _w1r), _mm_mul_ps(_di, _w1i)));
+            _mm_storeu_ps(y1i + i, _mm_add_ps(_mm_mul_ps(_dr, _w1i), _mm_mul_ps(_di, _w1r)));
+        }
+    }
+#endif // __SSE2__
+#if __ARM_NEON
+    {
+        float32x4_t _w1r = vdupq_n_f32(w1r);
+        float32x4_t _w1i = vdupq_n_f32(w1i);
+        for (; i + 3 < size; i += 4)
+        {
+            float32x4_t _ar = vld1q_f32(x0r + i);
+            float32x4_t _ai = vld1q_f32(x0i + i);
+            float32x4_t _br = vld1q_f32(x1r + i);
+            float32x4_t _bi = vld1q_f32(x1i + i);
+            float32x4_t _dr = vsubq_f32(_ar, _br);
+            float32x4_t _di = vsubq_f32(_ai, _bi);
+            vst1q_f32(y0r + i, vaddq_f32(_ar, _br));
+            vst1q_f32(y0i + i, vaddq_f32(_ai, _bi));
+            vst1q_f32(y1r + i, vmlsq_f32(vmulq_f32(_dr, _w1r), _di, _w1i));
+            vst1q_f32(y1i + i, vmlaq_f32(vmulq_f32(_dr, _w1i), _di, _w1r));
+        }
+    }
+#endif // __ARM_NEON
+    for (; i < size; i++)
+    {
+        float ar = x0r[i];
+        float ai = x0i[i];
+        float br = x1r[i];
+        float bi = x1i[i];
+        float dr = ar - br;
+        float di = ai - bi;
+        y0r[i] = ar + br;
+        y0i[i] = ai + bi;
+        y1r[i] = dr * w1r - di * w1i;
+        y1i[i] = dr * w1i + di * w1r;
+    }
+}
+
+// y0 = t0 + t2, y1 = (t1 - i t3) * w1, y2 = (t0 - t2) * w2, y3 = (t1 + i t3) * w3
+// with t0 = x0 + x2, t1 = x0 - x2, t2 = x1 + x3, t3 = x1 - x3
+static inline void fft_radix4(const float* xr, const float* xi, int xstep, float* yr, float* yi, int ystep, const float* w, int size)
+{
+    const float* x0r = xr;
+    const float* x0i = xi;
+    const float* x1r = xr + xstep;
+    const float* x1i = xi + xstep;
+    const float* x2r = xr + xstep * 2;
+    const float* x2i = xi + xstep * 2;
+    const float* x3r = xr + xstep * 3;
+    const float* x3i = xi + xstep * 3;
+    float* y0r = yr;
+    float* y0i = yi;
+    float* y1r = yr + ystep;
+    float* y1i = yi + ystep;
+    float* y2r = yr + ystep * 2;
+    float* y2i = yi + ystep * 2;
+    float* y3r = yr + ystep * 3;
+    float* y3i = yi + ystep * 3;
+
+    const float w1r = w[0];
+    const float w1i = w[1];
+    const float w2r = w[2];
+    const float w2i = w[3];
+    const float w3r = w[4];
+    const float w3i = w[5];
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+    {
+        __m256 _w1r = _mm256_set1_ps(w1r);
+        __m256 _w1i = _mm256_set1_ps(w1i);
+        __m256 _w2r = _mm256_set1_ps(w2r);
+        __m256 _w2i = _mm256_set1_ps(w2i);
+        __m256 _w3r = _mm256_set1_ps(w3r);
+        __m256 _w3i = _mm256_set1_ps(w3i);
+        for (; i + 7 < size; i += 8)
+        {
+            __m256 _x0r = _mm256_loadu_ps(x0r + i);
+            __m256 _x0i = _mm256_loadu_ps(x0i + i);
+            __m256 _x1r = _mm256_loadu_ps(x1r + i);
+            __m256 _x1i = _mm256_loadu_ps(x1i + i);
+            __m256 _x2r = _mm256_loadu_ps(x2r + i);
+            __m256 _x2i = _mm256_loadu_ps(x2i + i);
+            __m256 _x3r = _mm256_loadu_ps(x3r + i);
+            __m256 _x3i = _mm256_loadu_ps(x3i + i);
+            __m256 _t0r = _mm256_add_ps(_x0r, _x2r);
+            __m256 _t0i = _mm256_add_ps(_x0i, _x2i);
+            __m256 _t1r = _mm256_sub_ps(_x0r, _x2r);
+            __m256 _t1i = _mm256_sub_ps(_x0i, _x2i);
+            __m256 _t2r = _mm256_add_ps(_x1r, _x3r);
+            __m256 _t2i = _mm256_add_ps(_x1i, _x3i);
+            __m256 _t3r = _mm256_sub_ps(_x1r, _x3r);
+            __m256 _t3i = _mm256_sub_ps(_x1i, _x3i);
+            __m256 _ar = _mm256_add_ps(_t1r, _t3i);
+            __m256 _ai = _mm256_sub_ps(_t1i, _t3r);
+            __m256 _br = _mm256_sub_ps(_t0r, _t2r);
+            __m256 _bi = _mm256_sub_ps(_t0i, _t2i);
+            __m256 _cr = _mm256_sub_ps(_t1r, _t3i);
+            __m256 _ci = _mm256_add_ps(_t1i, _t3r);
+            _mm256_storeu_ps(y0r + i, _mm256_add_ps(_t0r, _t2r));
+            _mm256_storeu_ps(y0i + i, _mm256_add_ps(_t0i, _t2i));
+            _mm256_storeu_ps(y1r + i, _mm256_sub_ps(_mm256_mul_ps(_ar, _w1r), _mm256_mul_ps(_ai, _w1i)));
+            _mm256_storeu_ps(y1i + i, _mm256_add_ps(_mm256_mul_ps(_ar, _w1i), _mm256_mul_ps(_ai, _w1r)));
+            _mm256_storeu_ps(y2r + i, _mm256_sub_ps(_mm256_mul_ps(_br, _w2r), _mm256_mul_ps(_bi, _w2i)));
+            _mm256_storeu_ps(y2i + i, _mm256_add_ps(_mm256_mul_ps(_br, _w2i), _mm256_mul_ps(_bi, _w2r)));
+            _mm256_storeu_ps(y3r + i, _mm256_sub_ps(_mm256_mul_ps(_cr, _w3r), _mm256_mul_ps(_ci, _w3i)));
+            _mm256_storeu_ps(y3i + i, _mm256_add_ps(_mm256_mul_ps(_cr, _w3i), _mm256_mul_ps(_ci, _w3r)));
+        }
+    }
+#endif // __AVX__
+    {
+        __m128 _w1r = _mm_set1_ps(w1r);
+        __m128 _w1i = _mm_set1_ps(w1i);
+        __m128 _w2r = _mm_set1_ps(w2r);
+        __m128 _w2i = _mm_set1_ps(w2i);
+        __m128 _w3r = _mm_set1_ps(w3r);
+        __m128 _w3i = _mm_set1_ps(w3i);
+        for (; i + 3 < size; i += 4)
+        {
+            __m128 _x0r = _mm_loadu_ps(x0r + i);
+            __m128 _x0i = _mm_loadu_ps(x0i + i);
+            __m128 _x1r = _mm_loadu_ps(x1r + i);
+            __m128 _x1i = _mm_loadu_ps(x1i + i);
+            __m128 _x2r = _mm_loadu_ps(x2r + i);
+            __m128 _x2i = _mm_loadu_ps(x2i + i);
+            __m128 _x3r = _mm_loadu_ps(x3r + i);
+            __m128 _x3i = _mm_loadu_ps(x3i + i);
+            __m128 _t0r = _mm_add_ps(_x0r, _x2r);
+            __m128 _t0i = _mm_add_ps(_x0i, _x2i);
+            __m128 _t1r = _mm_sub_ps(_x0r, _x2r);
+            __m128 _t1i = _mm_sub_ps(_x0i, _x2i);
+            __m128 _t2r = _mm_add_ps(_x1r, _x3r);
+            __m128 _t2i = _mm_add_ps(_x1i, _x3i);
+            __m128 _t3r = _mm_sub_ps(_x1r, _x3r);
+            __m128 _t3i = _mm_sub_ps(_x1i, _x3i);
+            __m128 _ar = _mm_add_ps(_t1r, _t3i);
+            __m128 _ai = _mm_sub_ps(_t1i, _t3r);
+            __m128 _br = _mm_sub_ps(_t0r, _t2r);
+            __m128 _bi = _mm_sub_ps(_t0i, _t2i);
+            __m128 _cr = _mm_sub_ps(_t1r, _t3i);
+            __m128 _ci = _mm_add_ps(_t1i, _t3r);
+            _mm_storeu_ps(y0r + i, _mm_add_ps(_t0r, _t2r));
+            _mm_storeu_ps(y0i + i, _mm_add_ps(_t0i, _t2i));
+            _mm_storeu_ps(y1r + i, _mm_sub_ps(_mm_mul_ps(_ar, _w1r), _mm_mul_ps(_ai, _w1i)));
+            _mm_storeu_ps(y1i + i, _mm_add_ps(_mm_mul_ps(_ar, _w1i), _mm_mul_ps(_ai, _w1r)));
+            _mm_storeu_ps(y2r + i, _mm_sub_ps(_mm_mul_ps(_br, _w2r), _mm_mul_ps(_bi, _w2i)));
+            _mm_storeu_ps(y2i + i, _mm_add_ps(_mm_mul_ps(_br, _w2i), _mm_mul_ps(_bi, _w2r)));
+            _mm_storeu_ps(y3r + i, _mm_sub_ps(_mm_mul_ps(_cr, _w3r), _mm_mul_ps(_ci, _w3i)));
+            _mm_storeu_ps(y3i + i, _mm_add_ps(_mm_mul_ps(_cr, _w3i), _mm_mul_ps(_ci, _w3r)));
+        }
+    }
+#endif // __SSE2__
+#if __ARM_NEON
+    {
+        float32x4_t _w1r = vdupq_n_f32(w1r);
+        float32x4_t _w1i = vdupq_n_f32(w1i);
+        float32x4_t _w2r = vdupq_n_f32(w2r);
+        float32x4_t _w2i = vdupq_n_f32(w2i);
+        float32x4_t _w3r = vdupq_n_f32(w3r);
+        float32x4_t _w3i = vdupq_n_f32(w3i);
+        for (; i + 3 < size; i += 4)
+        {
+            float32x4_t _x0r = vld1q_f32(x0r + i);
+            float32x4_t _x0i = vld1q_f32(x0i + i);
+            float32x4_t _x1r = vld1q_f32(x1r + i);
+            float32x4_t _x1i = vld1q_f32(x1i + i);
+            float32x4_t _x2r = vld1q_f32(x2r + i);
+            float32x4_t _x2i = vld1q_f32(x2i + i);
+            float32x4_t _x3r = vld1q_f32(x3r + i);
+            float32x4_t _x3i = vld1q_f32(x3i + i);
+            float32x4_t _t0r = vaddq_f32(_x0r, _x2r);
+            float32x4_t _t0i = vaddq_f32(_x0i, _x2i);
+            float32x4_t _t1r = vsubq_f32(_x0r, _x2r);
+            float32x4_t _t1i = vsubq_f32(_x0i, _x2i);
+            float32x4_t _t2r = vaddq_f32(_x1r, _x3r);
+            float32x4_t _t2i = vaddq_f32(_x1i, _x3i);
+            float32x4_t _t3r = vsubq_f32(_x1r, _x3r);
+            float32x4_t _t3i = vsubq_f32(_x1i, _x3i);
+            float32x4_t _ar = vaddq_f32(_t1r, _t3i);
+            float32x4_t _ai = vsubq_f32(_t1i, _t3r);
+            float32x4_t _br = vsubq_f32(_t0r, _t2r);
+            float32x4_t _bi = vsubq_f32(_t0i, _t2i);
+            float32x4_t _cr = vsubq_f32(_t1r, _t3i);
+            float32x4_t _ci = vaddq_f32(_t1i, _t3r);
+            vst1q_f32(y0r + i, vaddq_f32(_t0r, _t2r));
+            vst1q_f32(y0i + i, vaddq_f32(_t0i, _t2i));
+            vst1q_f32(y1r + i, vmlsq_f32(vmulq_f32(_ar, _w1r), _ai, _w1i));
+            vst1q_f32(y1i + i, vmlaq_f32(vmulq_f32(_ar, _w1i), _ai, _w1r));
+            vst1q_f32(y2r + i, vmlsq_f32(vmulq_f32(_br, _w2r), _bi, _w2i));
+            vst1q_f32(y2i + i, vmlaq_f32(vmulq_f32(_br, _w2i), _bi, _w2r));
+            vst1q_f32(y3r + i, vmlsq_f32(vmulq_f32(_cr, _w3r), _ci, _w3i));
+            vst1q_f32(y3i + i, vmlaq_f32(vmulq_f32(_cr, _w3i), _ci, _w3r));
+        }
+    }
+#endif // __ARM_NEON
+    for (; i < size; i++)
+    {
+        float t0r = x0r[i] + x2r[i];
+        float t0i = x0i[i] + x2i[i];
+        float t1r = x0r[i] - x2r[i];
+        float t1i = x0i[i] - x2i[i];
+        float t2r = x1r[i] + x3r[i];
+        float t2i = x1i[i] + x3i[i];
+        float t3r = x1r[i] - x3r[i];
+        float t3i = x1i[i] - x3i[i];
+        float ar = t1r + t3i;
+        float ai = t1i - t3r;
+        float br = t0r - t2r;
+        float bi = t0i - t2i;
+        float cr = t1r - t3i;
+        float ci = t1i + t3r;
+        y0r[i] = t0r + t2r;
+        y0i[i] = t0i + t2i;
+        y1r[i] = ar * w1r - ai * w1i;
+        y1i[i] = ar * w1i + ai * w1r;
+        y2r[i] = br * w2r - bi * w2i;
+        y2i[i] = br * w2i + bi * w2r;
+        y3r[i] = cr * w3r - ci * w3i;
+        y3i[i] = cr * w3i + ci * w3r;
+    }
+}
+
+// y0 = x0 + x1 + x2, y1 = (x0 - s / 2 - i sqrt(3) / 2 d) * w1, y2 = (x0 - s / 2 + i sqrt(3) / 2 d) * w2
+// with s = x1 + x2, d = x1 - x2
+static inline void fft_radix3(const float* xr, const float* xi, int xstep, float* yr, float* yi, int ystep, const float* w, int size)
+{
+    const float* x0r = xr;
+    const float* x0i = xi;
+    const float* x1r = xr + xstep;
+    const float* x1i = xi + xstep;
+    const float* x2r = xr + xstep * 2;
+    const float* x2i = xi + xstep * 2;
+    float* y0r = yr;
+    float* y0i = yi;
+    float* y1r = yr + ystep;
+    float* y1i = yi + ystep;
+    float* y2r = yr + ystep * 2;
+    float* y2i = yi + ystep * 2;
+
+    const float w1r = w[0];
+    const float w1i = w[1];
+    const float w2r = w[2];
+    const float w2i = w[3];
+
+    const float sin60 = 0.86602540378443864676f;
+
+    for (int i = 0; i < size; i++)
+    {
+        float sr = x1r[i] + x2r[i];
+        float si = x1i[i] + x2i[i];
+        float dr = (x1r[i] - x2r[i]) * sin60;
+        float di = (x1i[i] - x2i[i]) * sin60;
+        float mr = x0r[i] - sr * 0.5f;
+        float mi = x0i[i] - si * 0.5f;
+        float ar = mr + di;
+        float ai = mi - dr;
+        float br = mr - di;
+        float bi = mi + dr;
+        y0r[i] = x0r[i] + sr;
+        y0i[i] = x0i[i] + si;
+        y1r[i] = ar * w1r - ai * w1i;
+        y1i[i] = ar * w1i + ai * w1r;
+        y2r[i] = br * w2r - bi * w2i;
+        y2i[i] = br * w2i + bi * w2r;
+    }
+}
+
+// y(u) = sum x(t) * wr^(t * u), then times w(u)
+static inline void fft_radix_generic(int r, const float* xr, const float* xi, int xstep, float* yr, float* yi, int ystep, const float* w, const float* wr, int size)
+{
+    for (int u = 0; u < r; u++)
+    {
+        float* outr = yr + ystep * u;
+        float* outi = yi + ystep * u;
+
+        memcpy(outr, xr, size * sizeof(float));
+        memcpy(outi, xi, size * sizeof(float));
+
+        for (int t = 1; t < r; t++)
+        {
+            const float* ptrr = xr + xstep * t;
+            const float* ptri = xi + xstep * t;
+            const int k = t * u % r;
+            const float cr = wr[k * 2];
+            const float ci = wr[k * 2 + 1];
+
+            for (int i = 0; i < size; i++)
+            {
+                float vr = ptrr[i];
+                float vi = ptri[i];
+                outr[i] += vr * cr - vi * ci;
+                outi[i] += vr * ci + vi * cr;
+            }
+        }
+
+        if (u == 0)
+            continue;
+
+        const float tr = w[(u - 1) * 2];
+        const float ti = w[(u - 1) * 2 + 1];
+        for (int i = 0; i < size; i++)
+        {
+            float vr = outr[i];
+            float vi = outi[i];
+            outr[i] = vr * tr - vi * ti;
+            outi[i] = vr * ti + vi * tr;
+        }
+    }
+}
+
+// forward transform of batch sequences in place
+// tmp holds 2 * n * batch floats
+static inline void fft_forward(const FFTPlan& plan, int batch, float* re, float* im, float* tmp)
+{
+    float* srcr = re;
+    float* srci = im;
+    float* dstr = tmp;
+    float* dsti = tmp + plan.n * batch;
+
+    const float* tw = plan.twiddles.empty() ? 0 : &plan.twiddles[0];
+
+    int n_stage = plan.n;
+    int s = 1;
+    for (size_t i = 0; i < plan.radices.size(); i++)
+    {
+        const int r = plan.radices[i];
+        const int m = n_stage / r;
+        const int size = s * batch;
+        const int xstep = m * size;
+
+        const float* wr = tw + m * (r - 1) * 2;
+
+        for (int p = 0; p < m; p++)
+        {
+            const float* xr = srcr + p * size;
+            const float* xi = srci + p * size;
+            float* yr = dstr + p * r * size;
+            float* yi = dsti + p * r * size;
+            const float* w = tw + p * (r - 1) * 2;
+
+            if (r == 4)
+                fft_radix4(xr, xi, xstep, yr, yi, size, w, size);
+            else if (r == 2)
+                fft_radix2(xr, xi, xstep, yr, yi, size, w, size);
+            else if (r == 3)
+                fft_radix3(xr, xi, xstep, yr, yi, size, w, size);
+            else
+                fft_radix_generic(r, xr, xi, xstep, yr, yi, size, w, wr, size);
+        }
+
+        tw = wr;
+        if (r != 2 && r != 3 && r != 4)
+            tw += r * 2;
+
+        n_stage = m;
+        s *= r;
+
+        std::swap(srcr, dstr);
+        std::swap(srci, dsti);
+    }
+
+    if (srcr != re)
+    {
+        memcpy(re, srcr, plan.n * batch * sizeof(float));
+        memcpy(im, srci, plan.n * batch * sizeof(float));
+    }
+}
+
+// forward transform of batch real sequences x[t * batch + b]
+// writes the bins [0, n / 2] to outr and outi
+// tmp holds 4 * n * batch floats
+static inline void rfft_forward(const RFFTPlan& plan, int batch, const float* x, float* outr, float* outi, float* tmp)
+{
+    const int n = plan.n;
+
+    if (n % 2 != 0)
+    {
+        float* zr = tmp;
+        float* zi = tmp + n * batch;
+
+        memcpy(zr, x, n * batch * sizeof(float));
+        memset(zi, 0, n * batch * sizeof(float));
+
+        fft_forward(plan.plan, batch, zr, zi, tmp + n * batch * 2);
+
+        memcpy(outr, zr, (n / 2 + 1) * batch * sizeof(float));
+        memcpy(outi, zi, (n / 2 + 1) * batch * sizeof(float));
+        return;
+    }
+
+    // z(t) = x(2t) + i x(2t + 1)
+    const int h = n / 2;
+    float* zr = tmp;
+    float* zi = tmp + h * batch;
+    for (int t = 0; t < h; t++)
+    {
+        memcpy(zr + t * batch, x + t * 2 * batch, batch * sizeof(float));
+        memcpy(zi + t * batch, x + (t * 2 + 1) * batch, batch * sizeof(float));
+    }
+
+    fft_forward(plan.plan, batch, zr, zi, tmp + h * batch * 2);
+
+    // X(k) = (Z(k) + conj(Z(h - k))) / 2 - i w(n)^k (Z(k) - conj(Z(h - k))) / 2
+    for (int k = 0; k <= h; k++)
+    {
+        const float* ar = zr + (k % h) * batch;
+        const float* ai = zi + (k % h) * batch;
+        const float* br = zr + ((h - k) % h) * batch;
+        const float* bi = zi + ((h - k) % h) * batch;
+        float* yr = outr + k * batch;
+        float* yi = outi + k * batch;
+
+        const float wr = plan.twiddles[k * 2];
+        const float wi = plan.twiddles[k * 2 + 1];
+
+        for (int i = 0; i < batch; i++)
+        {
+            float er = (ar[i] + br[i]) * 0.5f;
+            float ei = (ai[i] - bi[i]) * 0.5f;
+            float odr = (ai[i] + bi[i]) * 0.5f;
+            float odi = (br[i] - ar[i]) * 0.5f;
+            yr[i] = er + odr * wr - odi * wi;
+            yi[i] = ei + odr * wi + odi * wr;
+        }
+    }
+}
+
+} // namespace ncnn
+
+#endif // LAYER_FFT_H
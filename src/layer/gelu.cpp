@@ -9,6 +9,8 @@ GELU::GELU()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int GELU::load_param(const ParamDict& pd)
@@ -3,6 +3,8 @@
 
 #include "gru.h"
 
+#include "streaming.h"
+
 namespace ncnn {
 
 GRU::GRU()
@@ -26,6 +28,8 @@ int GRU::load_param(const ParamDict& pd)
 #endif
     }
 
+    support_streaming = direction == 0;
+
     return 0;
 }
 
@@ -541,4 +545,9 @@ int GRU::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blo
     return 0;
 }
 
+int GRU::forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& states, const Option& opt) const
+{
+    return forward_streaming_recurrent(this, bottom_blobs, top_blobs, states, 1, opt);
+}
+
 } // namespace ncnn
@@ -9,6 +9,8 @@ HardSwish::HardSwish()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int HardSwish::load_param(const ParamDict& pd)
@@ -13,6 +13,7 @@ InnerProduct::InnerProduct()
 {
     one_blob_only = true;
     support_inplace = false;
+    support_batch_rows = true;
 }
 
 int InnerProduct::load_param(const ParamDict& pd)
@@ -3,6 +3,8 @@
 
 #include "inversespectrogram.h"
 
+#include "cpu.h"
+
 namespace ncnn {
 
 InverseSpectrogram::InverseSpectrogram()
@@ -71,6 +73,8 @@ int InverseSpectrogram::load_param(const ParamDict& pd)
         }
     }
 
+    fft_create_plan(fft_plan, n_fft);
+
     return 0;
 }
 
@@ -109,70 +113,76 @@ int InverseSpectrogram::forward(const Mat& bottom_blob, Mat& top_blob, const Opt
     top_blob.fill(0.f);
     window_sumsquare.fill(0.f);
 
-    for (int j = 0; j < frames; j++)
+    float norm = 1.f;
+    if (normalized == 1)
+        norm = sqrt(n_fft);
+    if (normalized == 2)
+        norm = window_data[n_fft];
+
+    // windowed time domain frames
+    Mat frames_re(n_fft, frames, 4u, opt.workspace_allocator);
+    Mat frames_im(n_fft, frames, 4u, opt.workspace_allocator);
+    if (frames_re.empty() || frames_im.empty())
+        return -100;
+
+    // frames are transformed in batches, bins of one batch are contiguous
+    const int batch = 8;
+    const int nn_batch = (frames + batch - 1) / batch;
+
+    // spectrum and fft scratch for each thread
+    const int workspace_size = n_fft * 4 * batch;
+    Mat workspace(workspace_size, 1, opt.num_threads, 4u, opt.workspace_allocator);
+    if (workspace.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ii = 0; ii < nn_batch; ii++)
     {
-        // collect complex
-        Mat sp(2, n_fft);
-        if (onesided == 1)
-        {
-            for (int k = 0; k < n_fft / 2 + 1; k++)
-            {
-                sp.row(k)[0] = bottom_blob.channel(k).row(j)[0];
-                sp.row(k)[1] = bottom_blob.channel(k).row(j)[1];
-            }
-            for (int k = n_fft / 2 + 1; k < n_fft; k++)
-            {
-                sp.row(k)[0] = bottom_blob.channel(n_fft - k).row(j)[0];
-                sp.row(k)[1] = -bottom_blob.channel(n_fft - k).row(j)[1];
-            }
-        }
-        else
-        {
-            for (int k = 0; k < n_fft; k++)
-            {
-                sp.row(k)[0] = bottom_blob.channel(k).row(j)[0];
-                sp.row(k)[1] = bottom_blob.channel(k).row(j)[1];
-            }
-        }
+        const int j0 = ii * batch;
+        const int bsize = std::min(batch, frames - j0);
+
+        float* zr = workspace.channel(get_omp_thread_num());
+        float* zi = zr + n_fft * bsize;
+        float* tmp = zi + n_fft * bsize;
 
-        if (normalized == 1)
+        // collect conjugated complex
+        // ifft(X) = conj(fft(conj(X))) / n_fft
+        for (int k = 0; k < n_fft; k++)
         {
-            float norm = sqrt(n_fft);
-            for (int i = 0; i < 2 * n_fft; i++)
+            const bool mirror = onesided == 1 && k >= n_fft / 2 + 1;
+            const float* ptr = bottom_blob.channel(mirror ? n_fft - k : k).row(j0);
+            const float sign = mirror ? norm : -norm;
+            for (int b = 0; b < bsize; b++)
             {
-                sp[i] *= norm;
+                zr[k * bsize + b] = ptr[0] * norm;
+                zi[k * bsize + b] = ptr[1] * sign;
+                ptr += 2;
             }
         }
-        if (normalized == 2)
+
+        fft_forward(fft_plan, bsize, zr, zi, tmp);
+
+        // apply window
+        for (int b = 0; b < bsize; b++)
         {
-            float norm = window_data[n_fft];
-            for (int i = 0; i < 2 * n_fft; i++)
+            float* outre = frames_re.row(j0 + b);
+            float* outim = frames_im.row(j0 + b);
+            for (int i = 0; i < n_fft; i++)
             {
-                sp[i] *= norm;
+                outre[i] = zr[i * bsize + b] / n_fft * window_data[i];
+                outim[i] = -zi[i * bsize + b] / n_fft * window_data[i];
             }
         }
+    }
+
+    // overlap add
+    for (int j = 0; j < frames; j++)
+    {
+        const float* ptrre = frames_re.row(j);
+        const float* ptrim = frames_im.row(j);
 
-        #pragma omp parallel for num_threads(opt.num_threads)
         for (int i = 0; i < n_fft; i++)
         {
-            // inverse dft
-            float re = 0.f;
-            float im = 0.f;
-            for (int k = 0; k < n_fft; k++)
-            {
-                double angle = 2 * 3.14159265358979323846 * i * k / n_fft;
-
-                re += sp.row(k)[0] * cosf(angle) - sp.row(k)[1] * sinf(angle);
-                im += sp.row(k)[0] * sinf(angle) + sp.row(k)[1] * cosf(angle);
-            }
-
-            re /= n_fft;
-            im /= n_fft;
-
-            // apply window
-            re *= window_data[i];
-            im *= window_data[i];
-
             int output_index = j * hoplen + i;
             if (center == 1)
             {
@@ -185,16 +195,16 @@ int InverseSpectrogram::forward(const Mat& bottom_blob, Mat& top_blob, const Opt
 
                 if (returns == 0)
                 {
-                    top_blob.row(output_index)[0] += re;
-                    top_blob.row(output_index)[1] += im;
+                    top_blob.row(output_index)[0] += ptrre[i];
+                    top_blob.row(output_index)[1] += ptrim[i];
                 }
                 if (returns == 1)
                 {
-                    top_blob[output_index] += re;
+                    top_blob[output_index] += ptrre[i];
                 }
                 if (returns == 2)
                 {
-                    top_blob[output_index] += im;
+                    top_blob[output_index] += ptrim[i];
                 }
             }
         }
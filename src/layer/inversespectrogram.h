@@ -6,6 +6,8 @@
 
 #include "layer.h"
 
+#include "fft.h"
+
 namespace ncnn {
 
 class InverseSpectrogram : public Layer
@@ -27,6 +29,8 @@ public:
     int normalized; // 0=disabled 1=sqrt(n_fft) 2=window-l2-energy
 
     Mat window_data;
+
+    FFTPlan fft_plan;
 };
 
 } // namespace ncnn
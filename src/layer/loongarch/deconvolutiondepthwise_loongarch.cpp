@@ -26,6 +26,17 @@ int DeconvolutionDepthWise_loongarch::create_pipeline(const Option& opt)
     if (dynamic_weight)
         return 0;
 
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        // int8 inference uses the reference implementation
+        support_packing = false;
+        support_fp16_storage = false;
+        support_bf16_storage = false;
+        return 0;
+    }
+#endif
+
     const int maxk = kernel_w * kernel_h;
     int channels = (weight_data_size / group) / maxk / (num_output / group) * group;
 
@@ -170,6 +181,13 @@ int DeconvolutionDepthWise_loongarch::destroy_pipeline(const Option& opt)
 
 int DeconvolutionDepthWise_loongarch::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return DeconvolutionDepthWise::forward(bottom_blob, top_blob, opt);
+    }
+#endif
+
     // convolv with NxN kernel
     // value = value + bias
 
@@ -3,6 +3,8 @@
 
 #include "lstm.h"
 
+#include "streaming.h"
+
 namespace ncnn {
 
 LSTM::LSTM()
@@ -27,6 +29,8 @@ int LSTM::load_param(const ParamDict& pd)
 #endif
     }
 
+    support_streaming = direction == 0;
+
     return 0;
 }
 
@@ -645,4 +649,9 @@ int LSTM::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_bl
     return 0;
 }
 
+int LSTM::forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& states, const Option& opt) const
+{
+    return forward_streaming_recurrent(this, bottom_blobs, top_blobs, states, 2, opt);
+}
+
 } // namespace ncnn
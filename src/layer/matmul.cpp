@@ -14,6 +14,9 @@ MatMul::MatMul()
 int MatMul::load_param(const ParamDict& pd)
 {
     transB = pd.get(0, 0);
+    constant_TILE_M = pd.get(20, 0);
+    constant_TILE_N = pd.get(21, 0);
+    constant_TILE_K = pd.get(22, 0);
 
     return 0;
 }
@@ -19,6 +19,10 @@ public:
 
 public:
     int transB;
+
+    int constant_TILE_M;
+    int constant_TILE_N;
+    int constant_TILE_K;
 };
 
 } // namespace ncnn
@@ -20,6 +20,7 @@ int MultiHeadAttention::load_param(const ParamDict& pd)
     vdim = pd.get(4, embed_dim);
     attn_mask = pd.get(5, 0);
     scale = pd.get(6, 1.f / sqrtf(embed_dim / num_heads));
+    kv_cache = pd.get(7, 0);
     int8_scale_term = pd.get(18, 0);
 
     return 0;
@@ -84,13 +85,18 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
     }
 #endif
 
+    // the past caches always come last
+    const size_t input_count = kv_cache ? bottom_blobs.size() - 2 : bottom_blobs.size();
+
     const Mat& q_blob = bottom_blobs[0];
-    const Mat& k_blob = (bottom_blobs.size() == 1 || (bottom_blobs.size() == 2 && attn_mask)) ? q_blob : bottom_blobs[1];
-    const Mat& v_blob = (bottom_blobs.size() == 1 || (bottom_blobs.size() == 2 && attn_mask)) ? q_blob : (bottom_blobs.size() == 2 || (bottom_blobs.size() == 3 && attn_mask)) ? k_blob : bottom_blobs[2];
-    const Mat& attn_mask_blob = attn_mask ? bottom_blobs[bottom_blobs.size() - 1] : Mat();
+    const Mat& k_blob = (input_count == 1 || (input_count == 2 && attn_mask)) ? q_blob : bottom_blobs[1];
+    const Mat& v_blob = (input_count == 1 || (input_count == 2 && attn_mask)) ? q_blob : (input_count == 2 || (input_count == 3 && attn_mask)) ? k_blob : bottom_blobs[2];
+    const Mat& attn_mask_blob = attn_mask ? bottom_blobs[input_count - 1] : Mat();
 
     const int src_seqlen = q_blob.h;
-    const int dst_seqlen = k_blob.h;
+    const int cur_seqlen = k_blob.h;
+    const int past_seqlen = kv_cache && bottom_blobs[input_count].dims == 3 ? bottom_blobs[input_count].h : 0;
+    const int dst_seqlen = past_seqlen + cur_seqlen;
     const int embed_dim_per_head = embed_dim / num_heads;
     const int qdim = weight_data_size / embed_dim;
 
@@ -104,12 +110,32 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
     Mat xq(embed_dim_per_head, src_seqlen, num_heads, 4u, opt.workspace_allocator);
     if (xq.empty())
         return -100;
-    Mat xk(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
-    if (xk.empty())
-        return -100;
-    Mat xv(dst_seqlen, embed_dim_per_head, num_heads, 4u, opt.workspace_allocator);
-    if (xv.empty())
-        return -100;
+
+    // xk and xv hold the past rows followed by the current ones
+    Mat xk;
+    Mat xv;
+    if (kv_cache)
+    {
+        int ret = resize_kv_cache(bottom_blobs[input_count], cur_seqlen, 4u, top_blobs[1], opt);
+        if (ret != 0)
+            return ret;
+
+        ret = resize_kv_cache(bottom_blobs[input_count + 1], cur_seqlen, 4u, top_blobs[2], opt);
+        if (ret != 0)
+            return ret;
+
+        xk = top_blobs[1];
+        xv = top_blobs[2];
+    }
+    else
+    {
+        xk.create(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
+        if (xk.empty())
+            return -100;
+        xv.create(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
+        if (xv.empty())
+            return -100;
+    }
 
     Mat xqk(dst_seqlen, src_seqlen, num_heads, 4u, opt.workspace_allocator);
     if (xqk.empty())
@@ -150,9 +176,9 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
         {
             Mat outm = xk.channel(q);
 
-            for (int i = 0; i < dst_seqlen; i++)
+            for (int i = 0; i < cur_seqlen; i++)
             {
-                float* outptr = outm.row(i);
+                float* outptr = outm.row(past_seqlen + i);
 
                 for (int j = 0; j < embed_dim_per_head; j++)
                 {
@@ -174,21 +200,21 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
         {
             Mat outm = xv.channel(q);
 
-            for (int i = 0; i < embed_dim_per_head; i++)
+            for (int i = 0; i < cur_seqlen; i++)
             {
-                for (int j = 0; j < dst_seqlen; j++)
+                float* outptr = outm.row(past_seqlen + i);
+
+                for (int j = 0; j < embed_dim_per_head; j++)
                 {
-                    const float* ptr = v_blob.row(j);
-                    const float* kptr = (const float*)v_weight_data + vdim * (q * embed_dim_per_head + i);
+                    const float* ptr = v_blob.row(i);
+                    const float* kptr = (const float*)v_weight_data + vdim * (q * embed_dim_per_head + j);
 
-                    float sum = v_bias_data[q * embed_dim_per_head + i];
+                    float sum = v_bias_data[q * embed_dim_per_head + j];
                     for (int k = 0; k < vdim; k++)
                     {
                         sum += *ptr++ * *kptr++;
                     }
 
-                    float* outptr = outm.row(i);
-
                     outptr[j] = sum;
                 }
             }
@@ -271,7 +297,7 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
 
         // xqkv = xqk * xv
         // xqk (dst_seqlen, src_seqlen)
-        // xv  (dst_seqlen, embed_dim_per_head)
+        // xv  (embed_dim_per_head, dst_seqlen)
         // out (embed_dim_per_head, num_heads, src_seqlen)
         {
             const Mat xqkm = xqk.channel(q);
@@ -284,12 +310,11 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
                 for (int j = 0; j < embed_dim_per_head; j++)
                 {
                     const float* qkptr = xqkm.row(i);
-                    const float* vptr = xvm.row(j);
 
                     float sum = 0.f;
                     for (int k = 0; k < dst_seqlen; k++)
                     {
-                        sum += *qkptr++ * *vptr++;
+                        sum += qkptr[k] * xvm.row(k)[j];
                     }
 
                     outptr[j] = sum;
@@ -323,6 +348,47 @@ int MultiHeadAttention::forward(const std::vector<Mat>& bottom_blobs, std::vecto
     return 0;
 }
 
+int MultiHeadAttention::resize_kv_cache(const Mat& past_cache, int seqlen, size_t elemsize, Mat& cache, const Option& opt) const
+{
+    // cache (embed_dim_per_head, past_seqlen + seqlen, num_heads)
+    // the rows beyond h up to cstep are spare capacity for the following steps
+    const int embed_dim_per_head = embed_dim / num_heads;
+    const int past_seqlen = past_cache.dims == 3 ? past_cache.h : 0;
+    const int total_seqlen = past_seqlen + seqlen;
+
+    // a past still referenced elsewhere may be fed again with another token, e.g. in beam search
+    // writing into its spare rows would then clobber the other continuation
+    const bool past_exclusive = past_cache.refcount && *past_cache.refcount == 1;
+
+    if ((kv_cache == 2 || past_exclusive) && past_cache.dims == 3 && past_cache.w == embed_dim_per_head && past_cache.c == num_heads && past_cache.elemsize == elemsize && past_cache.elempack == 1 && past_cache.cstep >= (size_t)embed_dim_per_head * total_seqlen)
+    {
+        // append in place, the output shares memory with past_cache
+        cache = past_cache;
+        cache.h = total_seqlen;
+        return 0;
+    }
+
+    // grow geometrically so that decoding token by token reallocates rarely
+    int capacity = std::max(total_seqlen, past_seqlen * 2);
+    capacity = (capacity + 15) / 16 * 16;
+
+    cache.create(embed_dim_per_head, capacity, num_heads, elemsize, opt.blob_allocator);
+    if (cache.empty())
+        return -100;
+
+    cache.h = total_seqlen;
+
+    if (past_seqlen > 0)
+    {
+        for (int q = 0; q < num_heads; q++)
+        {
+            memcpy(cache.channel(q), past_cache.channel(q), (size_t)embed_dim_per_head * past_seqlen * elemsize);
+        }
+    }
+
+    return 0;
+}
+
 #if NCNN_INT8
 static inline signed char float2int8(float v)
 {
@@ -394,13 +460,18 @@ static void dynamic_quantize_2d_per_h(const Mat& blob, Mat& blob_int8, Mat& scal
 
 int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+    // the past caches always come last
+    const size_t input_count = kv_cache ? bottom_blobs.size() - 2 : bottom_blobs.size();
+
     const Mat& q_blob = bottom_blobs[0];
-    const Mat& k_blob = (bottom_blobs.size() == 1 || (bottom_blobs.size() == 2 && attn_mask)) ? q_blob : bottom_blobs[1];
-    const Mat& v_blob = (bottom_blobs.size() == 1 || (bottom_blobs.size() == 2 && attn_mask)) ? q_blob : (bottom_blobs.size() == 2 || (bottom_blobs.size() == 3 && attn_mask)) ? k_blob : bottom_blobs[2];
-    const Mat& attn_mask_blob = attn_mask ? bottom_blobs[bottom_blobs.size() - 1] : Mat();
+    const Mat& k_blob = (input_count == 1 || (input_count == 2 && attn_mask)) ? q_blob : bottom_blobs[1];
+    const Mat& v_blob = (input_count == 1 || (input_count == 2 && attn_mask)) ? q_blob : (input_count == 2 || (input_count == 3 && attn_mask)) ? k_blob : bottom_blobs[2];
+    const Mat& attn_mask_blob = attn_mask ? bottom_blobs[input_count - 1] : Mat();
 
     const int src_seqlen = q_blob.h;
-    const int dst_seqlen = k_blob.h;
+    const int cur_seqlen = k_blob.h;
+    const int past_seqlen = kv_cache && bottom_blobs[input_count].dims == 3 ? bottom_blobs[input_count].h : 0;
+    const int dst_seqlen = past_seqlen + cur_seqlen;
     const int embed_dim_per_head = embed_dim / num_heads;
     const int qdim = weight_data_size / embed_dim;
 
@@ -414,12 +485,32 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
     Mat xq(embed_dim_per_head, src_seqlen, num_heads, 4u, opt.workspace_allocator);
     if (xq.empty())
         return -100;
-    Mat xk(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
-    if (xk.empty())
-        return -100;
-    Mat xv(dst_seqlen, embed_dim_per_head, num_heads, 4u, opt.workspace_allocator);
-    if (xv.empty())
-        return -100;
+
+    // xk and xv hold the past rows followed by the current ones
+    Mat xk;
+    Mat xv;
+    if (kv_cache)
+    {
+        int ret = resize_kv_cache(bottom_blobs[input_count], cur_seqlen, 4u, top_blobs[1], opt);
+        if (ret != 0)
+            return ret;
+
+        ret = resize_kv_cache(bottom_blobs[input_count + 1], cur_seqlen, 4u, top_blobs[2], opt);
+        if (ret != 0)
+            return ret;
+
+        xk = top_blobs[1];
+        xv = top_blobs[2];
+    }
+    else
+    {
+        xk.create(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
+        if (xk.empty())
+            return -100;
+        xv.create(embed_dim_per_head, dst_seqlen, num_heads, 4u, opt.workspace_allocator);
+        if (xv.empty())
+            return -100;
+    }
 
     Mat xqk(dst_seqlen, src_seqlen, num_heads, 4u, opt.workspace_allocator);
     if (xqk.empty())
@@ -437,7 +528,7 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
     // dynamic quantize k_blob
     Mat k_blob_int8;
     float k_blob_int8_scale;
-    if (bottom_blobs.size() == 1)
+    if (input_count == 1)
     {
         k_blob_int8 = q_blob_int8;
         k_blob_int8_scale = q_blob_int8_scale;
@@ -450,12 +541,12 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
     // dynamic quantize v_blob
     Mat v_blob_int8;
     float v_blob_int8_scale;
-    if (bottom_blobs.size() == 1)
+    if (input_count == 1)
     {
         v_blob_int8 = q_blob_int8;
         v_blob_int8_scale = q_blob_int8_scale;
     }
-    else if (bottom_blobs.size() == 2)
+    else if (input_count == 2)
     {
         v_blob_int8 = k_blob_int8;
         v_blob_int8_scale = k_blob_int8_scale;
@@ -498,7 +589,7 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
 
         // xk = affine(k)
         {
-            float* outptr = xk.channel(q);
+            float* outptr = xk.channel(q).row(past_seqlen);
 
             for (int i = 0; i < k_blob_int8.h; i++)
             {
@@ -522,24 +613,22 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
 
         // xv = affine(v)
         {
-            Mat outm = xv.channel(q);
+            float* outptr = xv.channel(q).row(past_seqlen);
 
-            for (int i = 0; i < embed_dim_per_head; i++)
+            for (int i = 0; i < v_blob_int8.h; i++)
             {
-                float* outptr = outm.row(i);
-
-                for (int j = 0; j < v_blob_int8.h; j++)
+                for (int j = 0; j < embed_dim_per_head; j++)
                 {
-                    const signed char* ptr = v_blob_int8.row<const signed char>(j);
-                    const signed char* kptr = (const signed char*)v_weight_data + vdim * (q * embed_dim_per_head + i);
+                    const signed char* ptr = v_blob_int8.row<const signed char>(i);
+                    const signed char* kptr = (const signed char*)v_weight_data + vdim * (q * embed_dim_per_head + j);
 
                     int sum = 0;
                     for (int k = 0; k < vdim; k++)
                     {
                         sum += *ptr++ * *kptr++;
                     }
-                    const float v_descale = 1.f / (v_weight_data_int8_scales[q * embed_dim_per_head + i] * v_blob_int8_scale);
-                    float sum_fp32 = sum * v_descale + v_bias_data[q * embed_dim_per_head + i];
+                    const float v_descale = 1.f / (v_weight_data_int8_scales[q * embed_dim_per_head + j] * v_blob_int8_scale);
+                    float sum_fp32 = sum * v_descale + v_bias_data[q * embed_dim_per_head + j];
 
                     *outptr++ = sum_fp32;
                 }
@@ -635,7 +724,7 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
 
         // xqkv = xqk * xv
         // xqk (dst_seqlen, src_seqlen)
-        // xv  (dst_seqlen, embed_dim_per_head)
+        // xv  (embed_dim_per_head, dst_seqlen)
         // out (embed_dim_per_head, num_heads, src_seqlen)
         {
             const Mat xqkm = xqk.channel(q);
@@ -659,12 +748,11 @@ int MultiHeadAttention::forward_int8(const std::vector<Mat>& bottom_blobs, std::
                 for (int j = 0; j < embed_dim_per_head; j++)
                 {
                     const signed char* qkptr = xqkm_int8.row<const signed char>(i);
-                    const signed char* vptr = xvm_int8.row<const signed char>(j);
 
                     int sum = 0;
                     for (int k = 0; k < dst_seqlen; k++)
                     {
-                        sum += *qkptr++ * *vptr++;
+                        sum += qkptr[k] * xvm_int8.row<const signed char>(k)[j];
                     }
                     float sum_fp32 = sum * xqkv_descale;
 
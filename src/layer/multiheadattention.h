@@ -24,6 +24,9 @@ protected:
     int forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 #endif
 
+    // append seqlen rows to past_cache, reusing its spare capacity in place when it is exclusively owned or kv_cache is 2
+    int resize_kv_cache(const Mat& past_cache, int seqlen, size_t elemsize, Mat& cache, const Option& opt) const;
+
 public:
     int embed_dim;
     int num_heads;
@@ -33,6 +36,10 @@ public:
     int attn_mask;
     float scale;
 
+    // 1 = consume past_k past_v as the last two inputs and produce the updated caches as extra outputs
+    // 2 = as 1, and always append into the spare rows of past_k past_v in place
+    int kv_cache;
+
     int int8_scale_term;
 
     Mat q_weight_data;
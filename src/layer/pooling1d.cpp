@@ -4,6 +4,7 @@
 #include "pooling1d.h"
 
 #include "layer_type.h"
+#include "streaming.h"
 
 #include <float.h>
 
@@ -28,6 +29,8 @@ int Pooling1D::load_param(const ParamDict& pd)
     adaptive_pooling = pd.get(7, 0);
     out_w = pd.get(8, 0);
 
+    support_streaming = !global_pooling && !adaptive_pooling && (pad_mode == 0 || pad_mode == 1 || stride_w == 1);
+
     return 0;
 }
 
@@ -251,6 +254,18 @@ int Pooling1D::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
     return 0;
 }
 
+int Pooling1D::forward_streaming(const Mat& bottom_blob, Mat& top_blob, std::vector<Mat>& states, const Option& opt) const
+{
+    // auto padding of stride 1 does not depend on the input width
+    int streaming_pad_left = pad_left;
+    if (pad_mode == 2)
+        streaming_pad_left = (kernel_w - 1) / 2;
+    if (pad_mode == 3)
+        streaming_pad_left = kernel_w - 1 - (kernel_w - 1) / 2;
+
+    return forward_streaming_window(this, bottom_blob, top_blob, states, kernel_w, stride_w, streaming_pad_left, opt);
+}
+
 void Pooling1D::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const
 {
     int w = bottom_blob.w;
@@ -9,6 +9,7 @@ PReLU::PReLU()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_pixels = true;
 }
 
 int PReLU::load_param(const ParamDict& pd)
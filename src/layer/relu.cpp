@@ -9,6 +9,8 @@ ReLU::ReLU()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int ReLU::load_param(const ParamDict& pd)
@@ -40,6 +40,17 @@ int Deconvolution_riscv::create_pipeline(const Option& opt)
     if (dynamic_weight)
         return 0;
 
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        // int8 inference uses the reference implementation
+        support_packing = false;
+        support_fp16_storage = false;
+        support_bf16_storage = false;
+        return 0;
+    }
+#endif
+
 #if NCNN_ZFH
     if (support_fp16_storage && opt.use_fp16_storage)
     {
@@ -147,6 +158,13 @@ int Deconvolution_riscv::destroy_pipeline(const Option& opt)
 
 int Deconvolution_riscv::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return Deconvolution::forward(bottom_blob, top_blob, opt);
+    }
+#endif
+
 #if NCNN_ZFH
     int elembits = bottom_blob.elembits();
 
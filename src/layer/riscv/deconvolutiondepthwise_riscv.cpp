@@ -34,6 +34,17 @@ int DeconvolutionDepthWise_riscv::create_pipeline(const Option& opt)
     if (dynamic_weight)
         return 0;
 
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        // int8 inference uses the reference implementation
+        support_packing = false;
+        support_fp16_storage = false;
+        support_bf16_storage = false;
+        return 0;
+    }
+#endif
+
 #if NCNN_ZFH
     if (support_fp16_storage && opt.use_fp16_storage)
     {
@@ -189,6 +200,13 @@ int DeconvolutionDepthWise_riscv::destroy_pipeline(const Option& opt)
 
 int DeconvolutionDepthWise_riscv::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return DeconvolutionDepthWise::forward(bottom_blob, top_blob, opt);
+    }
+#endif
+
 #if NCNN_ZFH
     int elembits = bottom_blob.elembits();
 
@@ -3,6 +3,8 @@
 
 #include "rnn.h"
 
+#include "streaming.h"
+
 namespace ncnn {
 
 RNN::RNN()
@@ -26,6 +28,8 @@ int RNN::load_param(const ParamDict& pd)
 #endif
     }
 
+    support_streaming = direction == 0;
+
     return 0;
 }
 
@@ -427,4 +431,9 @@ int RNN::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blo
     return 0;
 }
 
+int RNN::forward_streaming(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, std::vector<Mat>& states, const Option& opt) const
+{
+    return forward_streaming_recurrent(this, bottom_blobs, top_blobs, states, 1, opt);
+}
+
 } // namespace ncnn
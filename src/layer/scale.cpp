@@ -9,6 +9,7 @@ Scale::Scale()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_pixels = true;
 }
 
 int Scale::load_param(const ParamDict& pd)
@@ -9,6 +9,8 @@ Sigmoid::Sigmoid()
 {
     one_blob_only = true;
     support_inplace = true;
+    support_batch_rows = true;
+    support_batch_pixels = true;
 }
 
 int Sigmoid::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
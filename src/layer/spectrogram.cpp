@@ -3,12 +3,16 @@
 
 #include "spectrogram.h"
 
+#include "cpu.h"
+#include "streaming.h"
+
 namespace ncnn {
 
 Spectrogram::Spectrogram()
 {
     one_blob_only = true;
     support_inplace = false;
+    support_streaming = true;
 }
 
 int Spectrogram::load_param(const ParamDict& pd)
@@ -73,6 +77,8 @@ int Spectrogram::load_param(const ParamDict& pd)
         }
     }
 
+    rfft_create_plan(rfft_plan, n_fft);
+
     return 0;
 }
 
@@ -115,63 +121,84 @@ int Spectrogram::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
     if (top_blob.empty())
         return -100;
 
+    float norm = 1.f;
+    if (normalized == 1)
+        norm = 1.f / sqrt(n_fft);
+    if (normalized == 2)
+        norm = window_data[n_fft];
+
+    // frames are transformed in batches, bins of one batch are contiguous
+    const int batch = 8;
+    const int nn_batch = (frames + batch - 1) / batch;
+
+    // windowed frames, onesided bins and fft scratch for each thread
+    const int workspace_size = (n_fft + freqs_onesided * 2 + n_fft * 4) * batch;
+    Mat workspace(workspace_size, 1, opt.num_threads, 4u, opt.workspace_allocator);
+    if (workspace.empty())
+        return -100;
+
     #pragma omp parallel for num_threads(opt.num_threads)
-    for (int i = 0; i < freqs_onesided; i++)
+    for (int ii = 0; ii < nn_batch; ii++)
     {
-        const float* ptr = bottom_blob_bordered;
-        float* outptr = power == 0 ? top_blob.channel(i) : top_blob.row(i);
+        const int j0 = ii * batch;
+        const int bsize = std::min(batch, frames - j0);
 
-        for (int j = 0; j < frames; j++)
+        float* x = workspace.channel(get_omp_thread_num());
+        float* outr = x + n_fft * bsize;
+        float* outi = outr + freqs_onesided * bsize;
+        float* tmp = outi + freqs_onesided * bsize;
+
+        // apply window
+        const float* ptr = (const float*)bottom_blob_bordered + j0 * hoplen;
+        for (int b = 0; b < bsize; b++)
         {
-            float re = 0.f;
-            float im = 0.f;
             for (int k = 0; k < n_fft; k++)
             {
-                float v = ptr[k];
-
-                // apply window
-                v *= window_data[k];
+                x[k * bsize + b] = ptr[k] * window_data[k];
+            }
 
-                // dft
-                double angle = 2 * 3.14159265358979323846 * i * k / n_fft;
+            ptr += hoplen;
+        }
 
-                re += v * cosf(angle); // + imag * sinf(angle);
-                im -= v * sinf(angle); // + imag * cosf(angle);
-            }
+        rfft_forward(rfft_plan, bsize, x, outr, outi, tmp);
 
-            if (normalized == 1)
-            {
-                float norm = 1.f / sqrt(n_fft);
-                re *= norm;
-                im *= norm;
-            }
-            if (normalized == 2)
-            {
-                float norm = window_data[n_fft];
-                re *= norm;
-                im *= norm;
-            }
+        for (int i = 0; i < freqs_onesided; i++)
+        {
+            const float* ptrr = outr + i * bsize;
+            const float* ptri = outi + i * bsize;
 
             if (power == 0)
             {
                 // complex as real
-                outptr[0] = re;
-                outptr[1] = im;
-                outptr += 2;
+                float* outptr = top_blob.channel(i).row(j0);
+                for (int b = 0; b < bsize; b++)
+                {
+                    outptr[0] = ptrr[b] * norm;
+                    outptr[1] = ptri[b] * norm;
+                    outptr += 2;
+                }
             }
             if (power == 1)
             {
                 // magnitude
-                outptr[0] = sqrt(re * re + im * im);
-                outptr += 1;
+                float* outptr = top_blob.row(i) + j0;
+                for (int b = 0; b < bsize; b++)
+                {
+                    float re = ptrr[b] * norm;
+                    float im = ptri[b] * norm;
+                    outptr[b] = sqrt(re * re + im * im);
+                }
             }
             if (power == 2)
             {
-                outptr[0] = re * re + im * im;
-                outptr += 1;
+                float* outptr = top_blob.row(i) + j0;
+                for (int b = 0; b < bsize; b++)
+                {
+                    float re = ptrr[b] * norm;
+                    float im = ptri[b] * norm;
+                    outptr[b] = re * re + im * im;
+                }
             }
-
-            ptr += hoplen;
         }
     }
 
@@ -207,4 +234,9 @@ int Spectrogram::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
     return 0;
 }
 
+int Spectrogram::forward_streaming(const Mat& bottom_blob, Mat& top_blob, std::vector<Mat>& states, const Option& opt) const
+{
+    return forward_streaming_window(this, bottom_blob, top_blob, states, n_fft, hoplen, center == 1 ? n_fft / 2 : 0, opt);
+}
+
 } // namespace ncnn
@@ -6,6 +6,8 @@
 
 #include "layer.h"
 
+#include "fft.h"
+
 namespace ncnn {
 
 class Spectrogram : public Layer
@@ -17,6 +19,8 @@ public:
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+    virtual int forward_streaming(const Mat& bottom_blob, Mat& top_blob, std::vector<Mat>& states, const Option& opt) const;
+
 public:
     int n_fft;
     int power;
@@ -29,6 +33,8 @@ public:
     int onesided;
 
     Mat window_data;
+
+    RFFTPlan rfft_plan;
 };
 
 } // namespace ncnn
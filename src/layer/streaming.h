@@ -0,0 +1,172 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_STREAMING_H
+#define LAYER_STREAMING_H
+
+#include "layer.h"
+
+#include <algorithm>
+#include <string.h>
+
+// streaming forward of a layer sliding a window along w
+// states[0] holds the input frames not consumed yet, states[1] the index of the next output window over them
+// the layer runs on the cached frames followed by the chunk and only the new complete windows are kept
+// windows start at multiples of stride from the beginning of the stream, left padding only applies there
+// frames run along w of 1d/2d outputs and along h of 3d outputs
+static inline int forward_streaming_window(const ncnn::Layer* layer, const ncnn::Mat& bottom_blob, ncnn::Mat& top_blob, std::vector<ncnn::Mat>& states, int kernel_extent_w, int stride_w, int pad_left, const ncnn::Option& opt)
+{
+    using namespace ncnn;
+
+    if (bottom_blob.dims == 1 && bottom_blob.elempack != 1)
+        return -1;
+
+    top_blob.release();
+    if (bottom_blob.empty())
+        return 0;
+
+    const int h = bottom_blob.h;
+    const size_t elemsize = bottom_blob.elemsize;
+    const int elempack = bottom_blob.elempack;
+
+    if (states.size() != 2)
+    {
+        states.resize(2);
+        states[0].release();
+        states[1].create(1, 4u, (Allocator*)0);
+        if (states[1].empty())
+            return -100;
+
+        ((int*)states[1].data)[0] = 0;
+    }
+
+    const Mat& cache = states[0];
+    const int k0 = ((const int*)states[1].data)[0];
+
+    if (!cache.empty() && (cache.dims != bottom_blob.dims || cache.h != h || cache.elemsize != elemsize || cache.elempack != elempack))
+    {
+        NCNN_LOGE("streaming chunk shape changed");
+        return -1;
+    }
+
+    const int m = cache.w;
+    const int size = m + bottom_blob.w;
+
+    // cached frames followed by the chunk
+    Mat buffer = bottom_blob;
+    if (m > 0)
+    {
+        if (bottom_blob.dims == 1)
+            buffer.create(size, elemsize, elempack, opt.workspace_allocator);
+        else
+            buffer.create(size, h, elemsize, elempack, opt.workspace_allocator);
+        if (buffer.empty())
+            return -100;
+
+        for (int i = 0; i < h; i++)
+        {
+            unsigned char* outptr = buffer.row<unsigned char>(i);
+            memcpy(outptr, cache.row<const unsigned char>(i), m * elemsize);
+            memcpy(outptr + m * elemsize, bottom_blob.row<const unsigned char>(i), bottom_blob.w * elemsize);
+        }
+    }
+
+    // windows that end inside the buffer
+    const int k1 = size + pad_left >= kernel_extent_w ? (size + pad_left - kernel_extent_w) / stride_w + 1 : 0;
+
+    if (k1 > k0)
+    {
+        Mat out;
+        int ret = layer->forward(buffer, out, opt);
+        if (ret != 0)
+            return ret;
+
+        const int outsize = k1 - k0;
+        if (out.dims == 3)
+        {
+            top_blob.create(out.w, outsize, out.c, out.elemsize, out.elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            const size_t rowsize = out.w * out.elemsize;
+            for (int q = 0; q < out.c; q++)
+            {
+                const unsigned char* ptr = out.channel(q);
+                unsigned char* outptr = top_blob.channel(q);
+                memcpy(outptr, ptr + k0 * rowsize, outsize * rowsize);
+            }
+        }
+        else
+        {
+            if (out.dims == 1)
+                top_blob.create(outsize, out.elemsize, out.elempack, opt.blob_allocator);
+            else
+                top_blob.create(outsize, out.h, out.elemsize, out.elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            for (int i = 0; i < out.h; i++)
+            {
+                memcpy(top_blob.row<unsigned char>(i), out.row<const unsigned char>(i) + k0 * out.elemsize, outsize * out.elemsize);
+            }
+        }
+    }
+
+    // keep the frames from the stride-aligned start of the next window
+    const int knext = std::max(k0, k1);
+    const int start = std::max(knext * stride_w - pad_left, 0) / stride_w * stride_w;
+    const int keep = size - start;
+
+    Mat cache_next;
+    if (keep > 0)
+    {
+        if (bottom_blob.dims == 1)
+            cache_next.create(keep, elemsize, elempack, (Allocator*)0);
+        else
+            cache_next.create(keep, h, elemsize, elempack, (Allocator*)0);
+        if (cache_next.empty())
+            return -100;
+
+        for (int i = 0; i < h; i++)
+        {
+            memcpy(cache_next.row<unsigned char>(i), buffer.row<const unsigned char>(i) + start * elemsize, keep * elemsize);
+        }
+    }
+
+    states[0] = cache_next;
+    ((int*)states[1].data)[0] = knext - start / stride_w;
+
+    return 0;
+}
+
+// streaming forward of a recurrent layer taking and producing its initial states as extra blobs
+// states hold the last hidden and cell states, the initial states of the graph take over if given
+static inline int forward_streaming_recurrent(const ncnn::Layer* layer, const std::vector<ncnn::Mat>& bottom_blobs, std::vector<ncnn::Mat>& top_blobs, std::vector<ncnn::Mat>& states, int state_count, const ncnn::Option& opt)
+{
+    using namespace ncnn;
+
+    if ((int)bottom_blobs.size() == 1 + state_count)
+        return layer->forward(bottom_blobs, top_blobs, opt);
+
+    std::vector<Mat> bottom_blobs_streaming(1, bottom_blobs[0]);
+    if ((int)states.size() == state_count)
+    {
+        bottom_blobs_streaming.insert(bottom_blobs_streaming.end(), states.begin(), states.end());
+    }
+
+    std::vector<Mat> top_blobs_streaming(1 + state_count);
+    int ret = layer->forward(bottom_blobs_streaming, top_blobs_streaming, opt);
+    if (ret != 0)
+        return ret;
+
+    for (size_t i = 0; i < top_blobs.size(); i++)
+    {
+        top_blobs[i] = top_blobs_streaming[i];
+    }
+
+    states.assign(top_blobs_streaming.begin() + 1, top_blobs_streaming.end());
+
+    return 0;
+}
+
+#endif // LAYER_STREAMING_H
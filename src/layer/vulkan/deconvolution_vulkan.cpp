@@ -40,6 +40,12 @@ int Deconvolution_vulkan::load_param(const ParamDict& pd)
         support_vulkan = false;
     }
 
+    if (int8_scale_term)
+    {
+        // int8 deconvolution runs on cpu
+        support_vulkan = false;
+    }
+
     return ret;
 }
 
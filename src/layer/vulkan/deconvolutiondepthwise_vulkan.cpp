@@ -33,6 +33,12 @@ int DeconvolutionDepthWise_vulkan::load_param(const ParamDict& pd)
         support_vulkan = false;
     }
 
+    if (int8_scale_term)
+    {
+        // int8 deconvolution runs on cpu
+        support_vulkan = false;
+    }
+
     return ret;
 }
 
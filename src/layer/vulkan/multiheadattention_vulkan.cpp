@@ -40,6 +40,12 @@ int MultiHeadAttention_vulkan::load_param(const ParamDict& pd)
         support_vulkan = false;
     }
 
+    if (kv_cache)
+    {
+        // TODO kv cache on gpu
+        support_vulkan = false;
+    }
+
     return ret;
 }
 
@@ -0,0 +1,204 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// reuses the tile packing and gemm kernels from convolution_im2col_gemm.h
+// only the im2col input gather knows about the depth dimension
+
+template<int nb>
+static void convolution3d_im2col_input_tile_nb(const Mat& bottom_blob, float* pp, int j, int k, int max_kk, int outw, int outh, int kernel_w, int kernel_h, int kernel_d, int dilation_w, int dilation_h, int dilation_d, int stride_w, int stride_h, int stride_d)
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int elempack = bottom_blob.elempack;
+
+    const int maxk = kernel_w * kernel_h * kernel_d;
+    const int outwh = outw * outh;
+
+    // input offset of each output column
+    int offset[nb];
+    for (int c = 0; c < nb; c++)
+    {
+        const int dz = (j + c) / outwh;
+        const int dy = (j + c) % outwh / outw;
+        const int dx = (j + c) % outw;
+
+        offset[c] = ((stride_d * dz * h + stride_h * dy) * w + stride_w * dx) * elempack;
+    }
+
+    for (int kk = 0; kk < max_kk / elempack; kk++)
+    {
+        const int p = (k / elempack + kk) / maxk;
+        const int uvw = (k / elempack + kk) % maxk;
+        const int z = uvw / (kernel_h * kernel_w);
+        const int u = uvw / kernel_w % kernel_h;
+        const int v = uvw % kernel_w;
+
+        const float* sptr = (const float*)bottom_blob.channel(p) + ((dilation_d * z * h + dilation_h * u) * w + dilation_w * v) * elempack;
+
+        // pp = elempack-nb
+#if __SSE2__
+        if (elempack >= 4 && nb % 4 == 0)
+        {
+            for (int l = 0; l < elempack; l += 4)
+            {
+                for (int c = 0; c < nb; c += 4)
+                {
+                    __m128 _r0 = _mm_load_ps(sptr + offset[c] + l);
+                    __m128 _r1 = _mm_load_ps(sptr + offset[c + 1] + l);
+                    __m128 _r2 = _mm_load_ps(sptr + offset[c + 2] + l);
+                    __m128 _r3 = _mm_load_ps(sptr + offset[c + 3] + l);
+                    _MM_TRANSPOSE4_PS(_r0, _r1, _r2, _r3);
+                    _mm_storeu_ps(pp + l * nb + c, _r0);
+                    _mm_storeu_ps(pp + (l + 1) * nb + c, _r1);
+                    _mm_storeu_ps(pp + (l + 2) * nb + c, _r2);
+                    _mm_storeu_ps(pp + (l + 3) * nb + c, _r3);
+                }
+            }
+        }
+        else
+#endif // __SSE2__
+        {
+            for (int l = 0; l < elempack; l++)
+            {
+                for (int c = 0; c < nb; c++)
+                {
+                    pp[l * nb + c] = sptr[offset[c] + l];
+                }
+            }
+        }
+
+        pp += nb * elempack;
+    }
+}
+
+static void convolution3d_im2col_input_tile(const Mat& bottom_blob, Mat& B, int j, int max_jj, int k, int max_kk, int outw, int outh, int kernel_w, int kernel_h, int kernel_d, int dilation_w, int dilation_h, int dilation_d, int stride_w, int stride_h, int stride_d)
+{
+    if (kernel_w == 1 && kernel_h == 1 && kernel_d == 1 && stride_w == 1 && stride_h == 1 && stride_d == 1)
+    {
+        // spatial dims are contiguous within each channel
+        convolution_im2col_input_tile_conv1x1s1d1(bottom_blob, B, j, max_jj, k, max_kk);
+        return;
+    }
+
+    // j max_jj     outw*outh*outd    split w h and d
+
+    // k max_kk     pa*maxk*(inch/pa)    split inch
+
+    float* pp = B;
+
+    int jj = 0;
+#if __SSE2__
+#if defined(__x86_64__) || defined(_M_X64)
+    for (; jj + 11 < max_jj; jj += 12)
+    {
+        convolution3d_im2col_input_tile_nb<12>(bottom_blob, pp, j + jj, k, max_kk, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d);
+        pp += 12 * max_kk;
+    }
+    for (; jj + 7 < max_jj; jj += 8)
+    {
+        convolution3d_im2col_input_tile_nb<8>(bottom_blob, pp, j + jj, k, max_kk, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d);
+        pp += 8 * max_kk;
+    }
+#endif // defined(__x86_64__) || defined(_M_X64)
+    for (; jj + 3 < max_jj; jj += 4)
+    {
+        convolution3d_im2col_input_tile_nb<4>(bottom_blob, pp, j + jj, k, max_kk, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d);
+        pp += 4 * max_kk;
+    }
+#endif // __SSE2__
+    for (; jj + 1 < max_jj; jj += 2)
+    {
+        convolution3d_im2col_input_tile_nb<2>(bottom_blob, pp, j + jj, k, max_kk, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d);
+        pp += 2 * max_kk;
+    }
+    for (; jj < max_jj; jj++)
+    {
+        convolution3d_im2col_input_tile_nb<1>(bottom_blob, pp, j + jj, k, max_kk, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d);
+        pp += max_kk;
+    }
+}
+
+static int convolution3d_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const Mat& AT, const Mat& bias, int kernel_w, int kernel_h, int kernel_d, int dilation_w, int dilation_h, int dilation_d, int stride_w, int stride_h, int stride_d, int nT, const Option& opt)
+{
+    const int maxk = kernel_w * kernel_h * kernel_d;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+
+    const int M = top_blob.c * top_blob.elempack;
+    const int N = top_blob.w * top_blob.h * top_blob.d;
+    const int K = bottom_blob.c * bottom_blob.elempack * maxk;
+
+    int TILE_M, TILE_N, TILE_K;
+    convolution_im2col_gemm_get_optimal_tile_mnk(M, N, K, TILE_M, TILE_N, TILE_K, nT);
+
+    const int nn_M = (M + TILE_M - 1) / TILE_M;
+    const int nn_N = (N + TILE_N - 1) / TILE_N;
+    const int nn_K = (K + TILE_K - 1) / TILE_K;
+
+    Mat BT(TILE_K * TILE_N, (K + TILE_K - 1) / TILE_K, (N + TILE_N - 1) / TILE_N, 4u, opt.workspace_allocator);
+    if (BT.empty())
+        return -100;
+
+    const int nn_NK = nn_N * nn_K;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int ppjk = 0; ppjk < nn_NK; ppjk++)
+    {
+        const int ppj = ppjk / nn_K;
+        const int ppk = ppjk % nn_K;
+
+        const int j = ppj * TILE_N;
+        const int k = ppk * TILE_K;
+
+        const int max_jj = std::min((N - j), TILE_N);
+        const int max_kk = std::min((K - k), TILE_K);
+
+        Mat BT_tile = BT.channel(j / TILE_N).row_range(k / TILE_K, 1);
+
+        // im2col
+        convolution3d_im2col_input_tile(bottom_blob, BT_tile, j, max_jj, k, max_kk, outw, outh, kernel_w, kernel_h, kernel_d, dilation_w, dilation_h, dilation_d, stride_w, stride_h, stride_d);
+    }
+
+    Mat topT_tileX;
+    if (K > TILE_K)
+    {
+        topT_tileX.create(TILE_N * TILE_M, 1, nT, 4u, opt.workspace_allocator);
+        if (topT_tileX.empty())
+            return -100;
+    }
+
+    #pragma omp parallel for num_threads(nT)
+    for (int ppj = 0; ppj < nn_M; ppj++)
+    {
+        const int i = ppj * TILE_M;
+
+        Mat topT_tile;
+        if (K > TILE_K)
+            topT_tile = topT_tileX.channel(get_omp_thread_num());
+
+        const int max_ii = std::min((M - i), TILE_M);
+
+        const Mat ATi = AT.channel(i / TILE_M);
+
+        for (int j = 0; j < N; j += TILE_N)
+        {
+            const int max_jj = std::min((N - j), TILE_N);
+
+            for (int k = 0; k < K; k += TILE_K)
+            {
+                const int max_kk = std::min((K - k), TILE_K);
+
+                const Mat AT_tile = ATi.row_range(k / TILE_K, 1);
+
+                const Mat BT_tile = BT.channel(j / TILE_N).row_range(k / TILE_K, 1);
+
+                bool k_end = k + TILE_K >= K;
+
+                convolution_gemm_transB_packed_tile(AT_tile, BT_tile, bias, topT_tile, top_blob, i, max_ii, j, max_jj, k, max_kk, k_end);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,300 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+static void convolution3d_transform_kernel_packed(const Mat& kernel, Mat& kernel_tm, int inch, int outch, int maxk, int elempack, int out_elempack)
+{
+    // src = maxk-inch-outch
+    // dst = pb-pa-maxk-inch/pa-outch/pb
+    Mat weight_data_r2 = kernel.reshape(maxk, inch, outch);
+
+    kernel_tm.create(maxk * inch * out_elempack, outch / out_elempack);
+
+    for (int q = 0; q + (out_elempack - 1) < outch; q += out_elempack)
+    {
+        float* g00 = kernel_tm.row(q / out_elempack);
+
+        for (int p = 0; p + (elempack - 1) < inch; p += elempack)
+        {
+            for (int k = 0; k < maxk; k++)
+            {
+                for (int i = 0; i < elempack; i++)
+                {
+                    for (int j = 0; j < out_elempack; j++)
+                    {
+                        const float* k00 = weight_data_r2.channel(q + j).row(p + i);
+                        g00[0] = k00[k];
+                        g00++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void convolution3d_packed(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int kernel_w, int kernel_h, int kernel_d, int dilation_w, int dilation_h, int dilation_d, int stride_w, int stride_h, int stride_d, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int channels = bottom_blob.c;
+    const int elempack = bottom_blob.elempack;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+    const int outd = top_blob.d;
+    const int outch = top_blob.c;
+    const int out_elempack = top_blob.elempack;
+
+    const int maxk = kernel_w * kernel_h * kernel_d;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap0 = w * dilation_h - kernel_w * dilation_w;
+        int gap1 = h * w * dilation_d - w * kernel_h * dilation_h;
+        for (int z = 0; z < kernel_d; z++)
+        {
+            for (int i = 0; i < kernel_h; i++)
+            {
+                for (int j = 0; j < kernel_w; j++)
+                {
+                    space_ofs[p1] = p2 * elempack;
+                    p1++;
+                    p2 += dilation_w;
+                }
+                p2 += gap0;
+            }
+            p2 += gap1;
+        }
+    }
+
+    const float* bias_data_ptr = bias_data;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (out_elempack == 16)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < outch; p++)
+        {
+            float* outptr = top_blob.channel(p);
+
+            for (int z = 0; z < outd; z++)
+            {
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
+                    {
+                        __m512 _sum = _mm512_setzero_ps();
+
+                        if (bias_data_ptr)
+                        {
+                            _sum = _mm512_loadu_ps(bias_data_ptr + p * 16);
+                        }
+
+                        const float* kptr = weight_data_tm.row(p);
+
+                        for (int q = 0; q < channels; q++)
+                        {
+                            const float* sptr = bottom_blob.channel(q).depth(z * stride_d).row(i * stride_h) + j * stride_w * elempack;
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                const float* slptr = sptr + space_ofs[k];
+
+                                for (int l = 0; l < elempack; l++)
+                                {
+                                    __m512 _val = _mm512_set1_ps(slptr[l]);
+                                    __m512 _w = _mm512_loadu_ps(kptr);
+                                    _sum = _mm512_fmadd_ps(_val, _w, _sum);
+
+                                    kptr += 16;
+                                }
+                            }
+                        }
+
+                        _sum = activation_avx512(_sum, activation_type, activation_params);
+
+                        _mm512_storeu_ps(outptr, _sum);
+                        outptr += 16;
+                    }
+                }
+            }
+        }
+    }
+#endif // __AVX512F__
+
+    if (out_elempack == 8)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < outch; p++)
+        {
+            float* outptr = top_blob.channel(p);
+
+            for (int z = 0; z < outd; z++)
+            {
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
+                    {
+                        __m256 _sum = _mm256_setzero_ps();
+
+                        if (bias_data_ptr)
+                        {
+                            _sum = _mm256_loadu_ps(bias_data_ptr + p * 8);
+                        }
+
+                        const float* kptr = weight_data_tm.row(p);
+
+                        for (int q = 0; q < channels; q++)
+                        {
+                            const float* sptr = bottom_blob.channel(q).depth(z * stride_d).row(i * stride_h) + j * stride_w * elempack;
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                const float* slptr = sptr + space_ofs[k];
+
+                                for (int l = 0; l < elempack; l++)
+                                {
+                                    __m256 _val = _mm256_broadcast_ss(slptr + l);
+                                    __m256 _w = _mm256_loadu_ps(kptr);
+                                    _sum = _mm256_comp_fmadd_ps(_val, _w, _sum);
+
+                                    kptr += 8;
+                                }
+                            }
+                        }
+
+                        _sum = activation_avx(_sum, activation_type, activation_params);
+
+                        _mm256_storeu_ps(outptr, _sum);
+                        outptr += 8;
+                    }
+                }
+            }
+        }
+    }
+#endif // __AVX__
+
+    if (out_elempack == 4)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < outch; p++)
+        {
+            float* outptr = top_blob.channel(p);
+
+            for (int z = 0; z < outd; z++)
+            {
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
+                    {
+                        __m128 _sum = _mm_setzero_ps();
+
+                        if (bias_data_ptr)
+                        {
+                            _sum = _mm_loadu_ps(bias_data_ptr + p * 4);
+                        }
+
+                        const float* kptr = weight_data_tm.row(p);
+
+                        for (int q = 0; q < channels; q++)
+                        {
+                            const float* sptr = bottom_blob.channel(q).depth(z * stride_d).row(i * stride_h) + j * stride_w * elempack;
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                const float* slptr = sptr + space_ofs[k];
+
+                                for (int l = 0; l < elempack; l++)
+                                {
+                                    __m128 _val = _mm_load1_ps(slptr + l);
+                                    __m128 _w = _mm_loadu_ps(kptr);
+                                    _sum = _mm_comp_fmadd_ps(_val, _w, _sum);
+
+                                    kptr += 4;
+                                }
+                            }
+                        }
+
+                        _sum = activation_sse(_sum, activation_type, activation_params);
+
+                        _mm_storeu_ps(outptr, _sum);
+                        outptr += 4;
+                    }
+                }
+            }
+        }
+    }
+#endif // __SSE2__
+
+    if (out_elempack == 1)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < outch; p++)
+        {
+            float* outptr = top_blob.channel(p);
+
+            for (int z = 0; z < outd; z++)
+            {
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
+                    {
+                        float sum = 0.f;
+
+                        if (bias_data_ptr)
+                        {
+                            sum = bias_data_ptr[p];
+                        }
+
+                        const float* kptr = weight_data_tm.row(p);
+
+#if __SSE2__
+                        __m128 _sum = _mm_setzero_ps();
+#endif // __SSE2__
+
+                        for (int q = 0; q < channels; q++)
+                        {
+                            const float* sptr = bottom_blob.channel(q).depth(z * stride_d).row(i * stride_h) + j * stride_w * elempack;
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                const float* slptr = sptr + space_ofs[k];
+
+                                int l = 0;
+#if __SSE2__
+                                for (; l + 3 < elempack; l += 4)
+                                {
+                                    __m128 _val = _mm_loadu_ps(slptr + l);
+                                    __m128 _w = _mm_loadu_ps(kptr);
+                                    _sum = _mm_comp_fmadd_ps(_val, _w, _sum);
+
+                                    kptr += 4;
+                                }
+#endif // __SSE2__
+                                for (; l < elempack; l++)
+                                {
+                                    sum += slptr[l] * kptr[0];
+
+                                    kptr += 1;
+                                }
+                            }
+                        }
+
+#if __SSE2__
+                        sum += _mm_reduce_add_ps(_sum);
+#endif // __SSE2__
+
+                        outptr[j] = activation_ss(sum, activation_type, activation_params);
+                    }
+
+                    outptr += outw;
+                }
+            }
+        }
+    }
+}
@@ -4595,6 +4595,37 @@ static void convolution_im2col_gemm_transform_kernel(const Mat& kernel, Mat& AT,
     }
 }
 
+static void convolution_im2col_unpack_fp16s_tiles(const Mat& AT_fp16, Mat& AT)
+{
+    // one row of fp16 storage weight tiles to fp32, called inside the thread loop
+    const unsigned short* ptr = AT_fp16;
+    float* outptr = AT;
+
+    const int size = AT_fp16.w * AT_fp16.h;
+
+    int i = 0;
+#if __F16C__
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        _mm512_storeu_ps(outptr, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)ptr)));
+        ptr += 16;
+        outptr += 16;
+    }
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
+    {
+        _mm256_storeu_ps(outptr, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr)));
+        ptr += 8;
+        outptr += 8;
+    }
+#endif // __F16C__
+    for (; i < size; i++)
+    {
+        *outptr++ = float16_to_float32(*ptr++);
+    }
+}
+
 static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const Mat& AT, const Mat& bias, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int nT, const Option& opt)
 {
     const int maxk = kernel_w * kernel_h;
@@ -4644,6 +4675,14 @@ static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const
             return -100;
     }
 
+    Mat ATX;
+    if (AT.elemsize == 2u)
+    {
+        ATX.create(TILE_K * TILE_M, (K + TILE_K - 1) / TILE_K, nT, 4u, opt.workspace_allocator);
+        if (ATX.empty())
+            return -100;
+    }
+
     #pragma omp parallel for num_threads(nT)
     for (int ppj = 0; ppj < nn_M; ppj++)
     {
@@ -4655,6 +4694,14 @@ static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const
 
         const int max_ii = std::min((M - i), TILE_M);
 
+        Mat ATi = AT.channel(i / TILE_M);
+        if (AT.elemsize == 2u)
+        {
+            Mat ATi_fp32 = ATX.channel(get_omp_thread_num());
+            convolution_im2col_unpack_fp16s_tiles(ATi, ATi_fp32);
+            ATi = ATi_fp32;
+        }
+
         for (int j = 0; j < N; j += TILE_N)
         {
             const int max_jj = std::min((N - j), TILE_N);
@@ -4663,7 +4710,7 @@ static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const
             {
                 const int max_kk = std::min((K - k), TILE_K);
 
-                const Mat AT_tile = AT.channel(i / TILE_M).row_range(k / TILE_K, 1);
+                const Mat AT_tile = ATi.row_range(k / TILE_K, 1);
 
                 const Mat BT_tile = BT.channel(j / TILE_N).row_range(k / TILE_K, 1);
 
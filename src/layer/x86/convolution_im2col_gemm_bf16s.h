@@ -0,0 +1,104 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+static int convolution_im2col_gemm_transform_kernel_bf16s(const Mat& kernel, Mat& BT, int inch, int outch, int kernel_w, int kernel_h, const Option& opt)
+{
+    // src = maxk-inch-outch
+    // dst = packed (maxk-inch)-outch, broadcast side of the bf16 gemm
+    const int maxk = kernel_w * kernel_h;
+    const int K = inch * maxk;
+
+    Mat kernel_bf16;
+    cast_float32_to_bfloat16(kernel.reshape(K, outch), kernel_bf16);
+    if (kernel_bf16.empty())
+        return -100;
+
+    BT.create((K + 1) / 2 * 2, outch, 2u, (Allocator*)0);
+    if (BT.empty())
+        return -100;
+
+    pack_B_bf16s(kernel_bf16, BT, outch, K, 0, opt.num_threads);
+
+    return 0;
+}
+
+static int convolution_im2col_gemm_bf16s(const Mat& bottom_blob, Mat& top_blob, const Mat& BT, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, int nT, const Option& opt)
+{
+    // bottom_blob is bordered and unpacked bf16
+    const int w = bottom_blob.w;
+    const int inch = bottom_blob.c;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+    const int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+    const int size = outw * outh;
+    const int K = inch * maxk;
+
+    // im2col = (maxk-inch) x size
+    Mat im2col;
+    if (kernel_w == 1 && kernel_h == 1 && stride_w == 1 && stride_h == 1)
+    {
+        // the bordered input is already laid out as inch x size
+        im2col = bottom_blob;
+    }
+    else
+    {
+        im2col.create(size, K, 2u, opt.workspace_allocator);
+        if (im2col.empty())
+            return -100;
+
+        const int gap = w * stride_h - outw * stride_w;
+
+        #pragma omp parallel for num_threads(nT)
+        for (int p = 0; p < inch; p++)
+        {
+            const Mat img = bottom_blob.channel(p);
+            unsigned short* ptr = im2col.row<unsigned short>(p * maxk);
+
+            for (int u = 0; u < kernel_h; u++)
+            {
+                for (int v = 0; v < kernel_w; v++)
+                {
+                    const unsigned short* sptr = img.row<const unsigned short>(dilation_h * u) + dilation_w * v;
+
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            ptr[0] = sptr[0];
+
+                            sptr += stride_w;
+                            ptr += 1;
+                        }
+
+                        sptr += gap;
+                    }
+                }
+            }
+        }
+    }
+
+    Mat AT((K + 1) / 2 * 2, size, 2u, opt.workspace_allocator);
+    if (AT.empty())
+        return -100;
+
+    pack_A_bf16s(im2col, AT, size, K, 1, nT);
+
+    Mat topT(size, outch, 4u, opt.workspace_allocator);
+    if (topT.empty())
+        return -100;
+
+    gemm_transB_packed_bf16s(AT, BT, topT, size, outch, K, nT);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int p = 0; p < outch; p++)
+    {
+        const float bias = bias_data.empty() ? 0.f : bias_data[p];
+
+        gemm_bf16s_store_output(topT.row(p), top_blob.channel(p), size, bias, 0, activation_type, activation_params);
+    }
+
+    return 0;
+}
@@ -21,6 +21,7 @@
 #include "benchmark.h"
 #include "cpu.h"
 #include "layer_type.h"
+#include "profiler.h"
 
 namespace ncnn {
 
@@ -30,6 +31,7 @@ namespace ncnn {
 #include "convolution_3x3_winograd.h"
 #include "convolution_packed.h"
 #include "convolution_im2col_gemm.h"
+#include "gemm_sparse.h"
 
 #if NCNN_INT8
 #include "convolution_3x3_int8.h"
@@ -40,6 +42,11 @@ namespace ncnn {
 #include "convolution_3x3_winograd_int8.h"
 #endif // NCNN_INT8
 
+#if NCNN_BF16
+#include "gemm_bf16s_utility.h"
+#include "convolution_im2col_gemm_bf16s.h"
+#endif // NCNN_BF16
+
 #if __SSE2__
 #include "convolution_3x3_pack1to4.h"
 
@@ -60,6 +67,9 @@ Convolution_x86::Convolution_x86()
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_BF16
+    support_bf16_storage = true;
+#endif
 
     activation = 0;
     nT = 0;
@@ -277,13 +287,35 @@ int Convolution_x86::create_pipeline(const Option& opt)
 #if NCNN_INT8
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
+        support_bf16_storage = false;
         return create_pipeline_int8_x86(opt);
     }
 #endif
 
+#if NCNN_BF16
+    if (support_bf16_storage && opt.use_bf16_storage)
+    {
+        return create_pipeline_bf16s(opt);
+    }
+#endif
+
     int kernel_size = kernel_w * kernel_h;
     int num_input = weight_data_size / kernel_size / num_output;
 
+    if (opt.use_sparse_weight && kernel_w == 1 && kernel_h == 1 && stride_w == 1 && stride_h == 1)
+    {
+        if (sparse_gemm_transform_kernel(weight_data, weight_sparse_data, weight_sparse_index, num_output, num_input))
+        {
+            // sparse kernels take unpacked blobs
+            support_packing = false;
+
+            if (opt.lightmode)
+                weight_data.release();
+
+            return 0;
+        }
+    }
+
     if (!opt.use_packing_layout && kernel_w == kernel_h && dilation_w != 1 && dilation_h == dilation_w && stride_w == 1 && stride_h == 1)
     {
         convolution_dilation1 = ncnn::create_layer_cpu(ncnn::LayerType::Convolution);
@@ -454,6 +486,19 @@ int Convolution_x86::create_pipeline(const Option& opt)
     {
         convolution_im2col_gemm_transform_kernel(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h, opt);
 
+#if NCNN_F16C && __F16C__
+        if (cpu_support_x86_f16c() && opt.use_fp16_storage)
+        {
+            // fp16 weight tiles, converted back row by row in convolution_im2col_gemm
+            Mat weight_sgemm_data_fp16;
+            ncnn::cast_float32_to_float16(weight_sgemm_data, weight_sgemm_data_fp16, opt);
+            if (weight_sgemm_data_fp16.empty())
+                return -100;
+
+            weight_sgemm_data = weight_sgemm_data_fp16;
+        }
+#endif // NCNN_F16C && __F16C__
+
         if (opt.lightmode)
             weight_data.release();
 
@@ -501,6 +546,69 @@ int Convolution_x86::destroy_pipeline(const Option& opt)
     return 0;
 }
 
+int Convolution_x86::export_pipeline(std::vector<Mat>& pipeline_data) const
+{
+    if (dynamic_weight || convolution_dilation1)
+        return -1;
+
+    pipeline_data.clear();
+    pipeline_data.push_back(weight_data_tm);
+    pipeline_data.push_back(weight_sgemm_data);
+    pipeline_data.push_back(weight_winograd23_data);
+    pipeline_data.push_back(weight_winograd43_data);
+    pipeline_data.push_back(weight_winograd63_data);
+    pipeline_data.push_back(weight_sparse_data);
+    pipeline_data.push_back(weight_sparse_index);
+#if NCNN_INT8
+    pipeline_data.push_back(scale_in_data);
+#endif
+
+    return 0;
+}
+
+int Convolution_x86::import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt)
+{
+#if NCNN_BF16
+    // bf16 pipeline is not cached
+    if (support_bf16_storage && opt.use_bf16_storage)
+        return -1;
+#endif
+
+#if NCNN_INT8
+    const size_t pipeline_data_count = 8;
+#else
+    const size_t pipeline_data_count = 7;
+#endif
+
+    if (dynamic_weight || pipeline_data.size() != pipeline_data_count)
+        return -1;
+
+    activation = create_activation_layer(activation_type, activation_params, opt);
+    nT = opt.num_threads;
+
+    weight_data_tm = pipeline_data[0];
+    weight_sgemm_data = pipeline_data[1];
+    weight_winograd23_data = pipeline_data[2];
+    weight_winograd43_data = pipeline_data[3];
+    weight_winograd63_data = pipeline_data[4];
+    weight_sparse_data = pipeline_data[5];
+    weight_sparse_index = pipeline_data[6];
+#if NCNN_INT8
+    scale_in_data = pipeline_data[7];
+#endif
+
+    if (!weight_sparse_index.empty())
+    {
+        // sparse kernels take unpacked blobs
+        support_packing = false;
+    }
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
 int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
 #if NCNN_INT8
@@ -554,6 +662,13 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         return 0;
     }
 
+#if NCNN_BF16
+    if (support_bf16_storage && opt.use_bf16_storage)
+    {
+        return forward_bf16s(bottom_blob, top_blob, opt);
+    }
+#endif
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
@@ -573,6 +688,23 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
 
     int outw = (w - kernel_extent_w) / stride_w + 1;
     int outh = (h - kernel_extent_h) / stride_h + 1;
+
+    if (!weight_sparse_index.empty())
+    {
+        top_blob.create(outw, outh, num_output, elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        profiler_set_kernel("sparse");
+        sparse_gemm(weight_sparse_data, weight_sparse_index, bias_data, bottom_blob_bordered, bottom_blob_bordered.cstep, top_blob, top_blob.cstep, num_output, outw * outh, opt.num_threads);
+
+        if (activation)
+        {
+            activation->forward_inplace(top_blob, opt);
+        }
+        return 0;
+    }
+
     int out_elempack = 1;
 #if __SSE2__
     if (opt.use_packing_layout)
@@ -649,14 +781,17 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         int ret = 0;
         if (prefer_winograd23)
         {
+            profiler_set_kernel("winograd23");
             ret = conv3x3s1_winograd23(bottom_blob_bordered, top_blob, weight_winograd23_data, bias_data, _nT, opt);
         }
         else if (prefer_winograd43)
         {
+            profiler_set_kernel("winograd43");
             ret = conv3x3s1_winograd43(bottom_blob_bordered, top_blob, weight_winograd43_data, bias_data, _nT, opt);
         }
         else if (prefer_winograd63)
         {
+            profiler_set_kernel("winograd63");
             ret = conv3x3s1_winograd63(bottom_blob_bordered, top_blob, weight_winograd63_data, bias_data, _nT, opt);
         }
         else
@@ -686,6 +821,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
             NCNN_LOGE("opt.num_threads %d changed, convolution gemm will use load-time value %d", opt.num_threads, nT);
         }
 
+        profiler_set_kernel(weight_sgemm_data.elemsize == 2u ? "im2col_gemm_fp16s" : "im2col_gemm");
         int ret = convolution_im2col_gemm(bottom_blob_bordered, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, _nT, opt);
         if (ret != 0)
             return ret;
@@ -704,6 +840,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     {
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
+            profiler_set_kernel("conv3x3s1_pack16to1_avx512");
             conv3x3s1_pack16to1_avx512(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -719,6 +856,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     {
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
+            profiler_set_kernel("conv3x3s1_pack8_avx");
             conv3x3s1_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -729,6 +867,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         }
         if (kernel_w == 2 && kernel_h == 2 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
+            profiler_set_kernel("conv2x2s1_pack8_avx");
             conv2x2s1_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -743,6 +882,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     {
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
+            profiler_set_kernel("conv3x3s1_pack1to8_avx");
             conv3x3s1_pack1to8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -753,6 +893,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         }
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
         {
+            profiler_set_kernel("conv3x3s2_pack1to8_avx");
             conv3x3s2_pack1to8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -767,6 +908,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     {
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
+            profiler_set_kernel("conv3x3s1_pack8to1_avx");
             conv3x3s1_pack8to1_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -782,6 +924,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     {
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
+            profiler_set_kernel("conv3x3s1_pack1to4_sse");
             conv3x3s1_pack1to4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -792,6 +935,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         }
         if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
         {
+            profiler_set_kernel("conv3x3s2_pack1to4_sse");
             conv3x3s2_pack1to4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
 
             if (activation)
@@ -803,6 +947,7 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     }
 #endif // __SSE2__
 
+    profiler_set_kernel("packed");
     convolution_packed(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, opt);
 
     return 0;
@@ -811,9 +956,22 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
 int Convolution_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     const Mat& bottom_blob = bottom_blobs[0];
-    const Mat& _weight_data = bottom_blobs[1];
+    Mat _weight_data = bottom_blobs[1];
     Mat& top_blob = top_blobs[0];
 
+#if NCNN_BF16
+    if (opt.use_bf16_storage && _weight_data.elembits() == 16)
+    {
+        // flatten weight in fp32, it is cast to bf16 again in create_pipeline
+        Mat _weight_data_fp32;
+        cast_bfloat16_to_float32(_weight_data, _weight_data_fp32, opt);
+        if (_weight_data_fp32.empty())
+            return -100;
+
+        _weight_data = _weight_data_fp32;
+    }
+#endif
+
     const int _kernel_w = _weight_data.w;
     const int _kernel_h = _weight_data.h;
     const int _num_output = _weight_data.c * _weight_data.elempack;
@@ -831,7 +989,18 @@ int Convolution_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
     Mat bias_data_flattened;
     if (bias_term)
     {
-        const Mat& _bias_data = bottom_blobs[2];
+        Mat _bias_data = bottom_blobs[2];
+#if NCNN_BF16
+        if (opt.use_bf16_storage && _bias_data.elembits() == 16)
+        {
+            Mat _bias_data_fp32;
+            cast_bfloat16_to_float32(_bias_data, _bias_data_fp32, opt);
+            if (_bias_data_fp32.empty())
+                return -100;
+
+            _bias_data = _bias_data_fp32;
+        }
+#endif
         flatten(_bias_data, bias_data_flattened, opt);
         if (bias_data_flattened.empty())
             return -100;
@@ -882,6 +1051,65 @@ int Convolution_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
     return 0;
 }
 
+#if NCNN_BF16
+int Convolution_x86::create_pipeline_bf16s(const Option& opt)
+{
+    // bf16 kernels take unpacked blobs
+    support_packing = false;
+
+    const int maxk = kernel_w * kernel_h;
+    const int num_input = weight_data_size / maxk / num_output;
+
+    int ret = convolution_im2col_gemm_transform_kernel_bf16s(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h, opt);
+    if (ret != 0)
+        return ret;
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int Convolution_x86::forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    Mat bottom_blob_bf16;
+    convert_packing(bottom_blob, bottom_blob_bf16, 1, opt_ws);
+    if (bottom_blob_bf16.elembits() == 32)
+    {
+        Mat bottom_blob_fp32 = bottom_blob_bf16;
+        cast_float32_to_bfloat16(bottom_blob_fp32, bottom_blob_bf16, opt_ws);
+    }
+    if (bottom_blob_bf16.empty())
+        return -100;
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob_bf16, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    const int w = bottom_blob_bordered.w;
+    const int h = bottom_blob_bordered.h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w - kernel_extent_w) / stride_w + 1;
+    const int outh = (h - kernel_extent_h) / stride_h + 1;
+
+    top_blob.create(outw, outh, num_output, 2u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    int _nT = nT ? nT : opt.num_threads;
+
+    profiler_set_kernel("im2col_gemm_bf16s");
+    return convolution_im2col_gemm_bf16s(bottom_blob_bordered, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, _nT, opt);
+}
+#endif // NCNN_BF16
+
 #if NCNN_INT8
 int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
 {
@@ -1041,16 +1269,24 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
     if (opt.use_winograd_convolution && prefer_winograd && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
     {
         if (opt.use_winograd43_convolution && !weight_winograd43_data.empty())
+        {
+            profiler_set_kernel("winograd43_int8");
             ret = conv3x3s1_winograd43_int8(bottom_blob_bordered, top_blob_int32, weight_winograd43_data, _nT, opt);
+        }
         else
+        {
+            profiler_set_kernel("winograd23_int8");
             ret = conv3x3s1_winograd23_int8(bottom_blob_bordered, top_blob_int32, weight_winograd23_data, _nT, opt);
+        }
     }
     else if (opt.use_sgemm_convolution)
     {
+        profiler_set_kernel("im2col_gemm_int8");
         ret = convolution_im2col_gemm_int8(bottom_blob_bordered, top_blob_int32, weight_sgemm_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, _nT, opt);
     }
     else
     {
+        profiler_set_kernel("packed_int8");
         convolution_packed_int8(bottom_blob_bordered, top_blob_int32, weight_data_tm, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, opt);
     }
     if (ret != 0)
@@ -16,6 +16,9 @@ public:
     virtual int create_pipeline(const Option& opt);
     virtual int destroy_pipeline(const Option& opt);
 
+    virtual int export_pipeline(std::vector<Mat>& pipeline_data) const;
+    virtual int import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
@@ -24,6 +27,10 @@ protected:
 #if NCNN_INT8
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif
+#if NCNN_BF16
+    int create_pipeline_bf16s(const Option& opt);
+    int forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #endif
     int forwardDilation_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
@@ -37,6 +44,10 @@ public:
     Mat weight_winograd43_data;
     Mat weight_winograd63_data;
 
+    // sparse weight blocks of convolution 1x1
+    Mat weight_sparse_data;
+    Mat weight_sparse_index;
+
     // forwardDilation
     Layer* convolution_dilation1;
 
@@ -13,10 +13,13 @@
 #include "x86_activation.h"
 #include "x86_usability.h"
 
+#include "cpu.h"
 #include "layer_type.h"
 
 namespace ncnn {
 
+#include "cast_fp16.h"
+
 #if __SSE2__
 #include "convolutiondepthwise_3x3_pack4.h"
 #include "convolutiondepthwise_5x5_pack4.h"
@@ -121,6 +124,19 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
             }
         }
 
+#if NCNN_F16C && __F16C__
+        if (cpu_support_x86_f16c() && opt.use_fp16_storage && !weight_data_tm.empty())
+        {
+            Mat weight_data_tm_fp16;
+            weight_data_tm_fp16.create(weight_data_tm.w, weight_data_tm.h, (size_t)2u * weight_data_tm.elempack, weight_data_tm.elempack, (Allocator*)0);
+            if (weight_data_tm_fp16.empty())
+                return -100;
+
+            cast_fp32_to_fp16_sse(weight_data_tm, weight_data_tm_fp16, opt);
+            weight_data_tm = weight_data_tm_fp16;
+        }
+#endif // NCNN_F16C && __F16C__
+
         if (opt.lightmode)
             weight_data.release();
 
@@ -160,6 +176,8 @@ int ConvolutionDepthWise_x86::create_group_ops(const Option& opt)
             bias_data_g = bias_data.range(num_output_g * g, num_output_g);
 
         ncnn::Layer* op = ncnn::create_layer_cpu(ncnn::LayerType::Convolution);
+        // group convolution stays in fp32 like this layer
+        op->support_bf16_storage = false;
 
         // set param
         ncnn::ParamDict pd;
@@ -300,442 +318,519 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
         return -100;
 
     // depth-wise
-    if (channels * elempack == group && group == num_output)
+    if (channels * elempack == group && group == num_output && !weight_data_tm.empty())
+    {
+#if NCNN_F16C && __F16C__
+        if (weight_data_tm.elembits() == 16)
+        {
+            return forward_depthwise_fp16s(bottom_blob_bordered, top_blob, opt);
+        }
+#endif // NCNN_F16C && __F16C__
+
+        return forward_depthwise(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+    }
+
+    // group convolution
+    const int channels_g = channels * elempack / group;
+    const int num_output_g = num_output / group;
+
+    int g_elempack = 1;
+    int out_g_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        g_elempack = channels_g % 16 == 0 ? 16 : channels_g % 8 == 0 ? 8 : channels_g % 4 == 0 ? 4 : 1;
+        out_g_elempack = num_output_g % 16 == 0 ? 16 : num_output_g % 8 == 0 ? 8 : num_output_g % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        g_elempack = channels_g % 8 == 0 ? 8 : channels_g % 4 == 0 ? 4 : 1;
+        out_g_elempack = num_output_g % 8 == 0 ? 8 : num_output_g % 4 == 0 ? 4 : 1;
+#else
+        g_elempack = channels_g % 4 == 0 ? 4 : 1;
+        out_g_elempack = num_output_g % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    // unpacking
+    Mat bottom_blob_bordered_unpacked = bottom_blob_bordered;
+    if (elempack > g_elempack)
+    {
+        Option opt_p = opt;
+        opt_p.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_blob_bordered, bottom_blob_bordered_unpacked, g_elempack, opt_p);
+        if (bottom_blob_bordered_unpacked.empty())
+            return -100;
+    }
+
+    Mat top_blob_unpacked = top_blob;
+    if (out_g_elempack < out_elempack)
+    {
+        top_blob_unpacked.create(outw, outh, num_output / out_g_elempack, out_elemsize / out_elempack * out_g_elempack, out_g_elempack, opt.workspace_allocator);
+        if (top_blob_unpacked.empty())
+            return -100;
+    }
+
+    for (int g = 0; g < group; g++)
+    {
+        const Mat bottom_blob_bordered_g = bottom_blob_bordered_unpacked.channel_range(channels_g * g / g_elempack, channels_g / g_elempack);
+        Mat top_blob_g = top_blob_unpacked.channel_range(num_output_g * g / out_g_elempack, num_output_g / out_g_elempack);
+
+        const ncnn::Layer* op = group_ops[g];
+
+        Option opt_g = opt;
+        opt_g.blob_allocator = top_blob_unpacked.allocator;
+
+        // forward
+        int ret = op->forward(bottom_blob_bordered_g, top_blob_g, opt_g);
+        if (ret != 0)
+            return ret;
+    }
+
+    // packing
+    if (out_g_elempack < out_elempack)
     {
+        convert_packing(top_blob_unpacked, top_blob, out_elempack, opt);
+        if (top_blob.empty())
+            return -100;
+    }
+    else
+    {
+        top_blob = top_blob_unpacked;
+    }
+
+    return 0;
+}
+
+int ConvolutionDepthWise_x86::forward_depthwise(const Mat& bottom_blob_bordered, Mat& top_blob, const Mat& kernel_tm, const Mat& bias, const Option& opt) const
+{
+    const int w = bottom_blob_bordered.w;
+    const int channels = bottom_blob_bordered.c;
+    const int elempack = bottom_blob_bordered.elempack;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+
 #if __SSE2__
 #if __AVX__
 #if __AVX512F__
-        if (elempack == 16)
+    if (elempack == 16)
+    {
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            convdw3x3s1_pack16_avx512(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
+
+            if (activation)
             {
-                convdw3x3s1_pack16_avx512(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw3x3s2_pack16_avx512(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw3x3s2_pack16_avx512(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+        {
+            convdw5x5s1_pack16_avx512(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            if (activation)
             {
-                convdw5x5s1_pack16_avx512(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw5x5s2_pack16_avx512(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw5x5s2_pack16_avx512(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        else
+        {
+            const int maxk = kernel_w * kernel_h;
 
-                return 0;
-            }
-            else
+            // kernel offsets
+            std::vector<int> _space_ofs(maxk);
+            int* space_ofs = &_space_ofs[0];
             {
-                const int maxk = kernel_w * kernel_h;
-
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
+                int p1 = 0;
+                int p2 = 0;
+                int gap = w * dilation_h - kernel_w * dilation_w;
+                for (int i = 0; i < kernel_h; i++)
                 {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
+                    for (int j = 0; j < kernel_w; j++)
                     {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
+                        space_ofs[p1] = p2;
+                        p1++;
+                        p2 += dilation_w;
                     }
+                    p2 += gap;
                 }
+            }
 
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    float* outptr = top_blob.channel(g);
-                    const float* kptr = (const float*)weight_data_tm + maxk * g * 16;
-                    const Mat m = bottom_blob_bordered.channel(g);
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int g = 0; g < channels; g++)
+            {
+                float* outptr = top_blob.channel(g);
+                const float* kptr = (const float*)kernel_tm + maxk * g * 16;
+                const Mat m = bottom_blob_bordered.channel(g);
 
-                    for (int i = 0; i < outh; i++)
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
                     {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m512 _sum = _mm512_set1_ps(0.f);
+                        __m512 _sum = _mm512_set1_ps(0.f);
 
-                            if (bias_term)
-                            {
-                                _sum = _mm512_loadu_ps(((const float*)bias_data) + g * 16);
-                            }
+                        if (bias_term)
+                        {
+                            _sum = _mm512_loadu_ps(((const float*)bias) + g * 16);
+                        }
 
-                            const float* sptr = m.row(i * stride_h) + j * stride_w * 16;
+                        const float* sptr = m.row(i * stride_h) + j * stride_w * 16;
 
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                __m512 _val = _mm512_loadu_ps(sptr + space_ofs[k] * 16);
-                                __m512 _w = _mm512_loadu_ps(kptr + k * 16);
-                                _sum = _mm512_fmadd_ps(_val, _w, _sum);
-                            }
-
-                            _mm512_storeu_ps(outptr, _sum);
-                            outptr += 16;
+                        for (int k = 0; k < maxk; k++)
+                        {
+                            __m512 _val = _mm512_loadu_ps(sptr + space_ofs[k] * 16);
+                            __m512 _w = _mm512_loadu_ps(kptr + k * 16);
+                            _sum = _mm512_fmadd_ps(_val, _w, _sum);
                         }
-                    }
-                }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
+                        _mm512_storeu_ps(outptr, _sum);
+                        outptr += 16;
+                    }
                 }
+            }
 
-                return 0;
+            if (activation)
+            {
+                activation->forward_inplace(top_blob, opt);
             }
+
+            return 0;
         }
+    }
 #endif // __AVX512F__
-        if (elempack == 8)
+    if (elempack == 8)
+    {
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            convdw3x3s1_pack8_avx(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
+
+            if (activation)
             {
-                convdw3x3s1_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw3x3s2_pack8_avx(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw3x3s2_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+        {
+            convdw5x5s1_pack8_avx(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            if (activation)
             {
-                convdw5x5s1_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw5x5s2_pack8_avx(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw5x5s2_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        else
+        {
+            const int maxk = kernel_w * kernel_h;
 
-                return 0;
-            }
-            else
+            // kernel offsets
+            std::vector<int> _space_ofs(maxk);
+            int* space_ofs = &_space_ofs[0];
             {
-                const int maxk = kernel_w * kernel_h;
-
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
+                int p1 = 0;
+                int p2 = 0;
+                int gap = w * dilation_h - kernel_w * dilation_w;
+                for (int i = 0; i < kernel_h; i++)
                 {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
+                    for (int j = 0; j < kernel_w; j++)
                     {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
+                        space_ofs[p1] = p2;
+                        p1++;
+                        p2 += dilation_w;
                     }
+                    p2 += gap;
                 }
+            }
 
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    float* outptr = top_blob.channel(g);
-                    const float* kptr = (const float*)weight_data_tm + maxk * g * 8;
-                    const Mat m = bottom_blob_bordered.channel(g);
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int g = 0; g < channels; g++)
+            {
+                float* outptr = top_blob.channel(g);
+                const float* kptr = (const float*)kernel_tm + maxk * g * 8;
+                const Mat m = bottom_blob_bordered.channel(g);
 
-                    for (int i = 0; i < outh; i++)
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
                     {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m256 _sum = _mm256_set1_ps(0.f);
+                        __m256 _sum = _mm256_set1_ps(0.f);
 
-                            if (bias_term)
-                            {
-                                _sum = _mm256_loadu_ps(((const float*)bias_data) + g * 8);
-                            }
+                        if (bias_term)
+                        {
+                            _sum = _mm256_loadu_ps(((const float*)bias) + g * 8);
+                        }
 
-                            const float* sptr = m.row(i * stride_h) + j * stride_w * 8;
+                        const float* sptr = m.row(i * stride_h) + j * stride_w * 8;
 
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                __m256 _val = _mm256_loadu_ps(sptr + space_ofs[k] * 8);
-                                __m256 _w = _mm256_loadu_ps(kptr + k * 8);
-                                _sum = _mm256_comp_fmadd_ps(_val, _w, _sum);
-                            }
-
-                            _mm256_storeu_ps(outptr + j * 8, _sum);
+                        for (int k = 0; k < maxk; k++)
+                        {
+                            __m256 _val = _mm256_loadu_ps(sptr + space_ofs[k] * 8);
+                            __m256 _w = _mm256_loadu_ps(kptr + k * 8);
+                            _sum = _mm256_comp_fmadd_ps(_val, _w, _sum);
                         }
 
-                        outptr += outw * 8;
+                        _mm256_storeu_ps(outptr + j * 8, _sum);
                     }
-                }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
+                    outptr += outw * 8;
                 }
+            }
 
-                return 0;
+            if (activation)
+            {
+                activation->forward_inplace(top_blob, opt);
             }
+
+            return 0;
         }
+    }
 #endif // __AVX__
 
-        if (elempack == 4)
+    if (elempack == 4)
+    {
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            convdw3x3s1_pack4_sse(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
+
+            if (activation)
             {
-                convdw3x3s1_pack4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw3x3s2_pack4_sse(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw3x3s2_pack4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+        {
+            convdw5x5s1_pack4_sse(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
+            if (activation)
             {
-                convdw5x5s1_pack4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw5x5s2_pack4_sse(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 5 && kernel_h == 5 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw5x5s2_pack4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        {
+            const int maxk = kernel_w * kernel_h;
 
-                return 0;
-            }
+            // kernel offsets
+            std::vector<int> _space_ofs(maxk);
+            int* space_ofs = &_space_ofs[0];
             {
-                const int maxk = kernel_w * kernel_h;
-
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
+                int p1 = 0;
+                int p2 = 0;
+                int gap = w * dilation_h - kernel_w * dilation_w;
+                for (int i = 0; i < kernel_h; i++)
                 {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
+                    for (int j = 0; j < kernel_w; j++)
                     {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
+                        space_ofs[p1] = p2;
+                        p1++;
+                        p2 += dilation_w;
                     }
+                    p2 += gap;
                 }
+            }
 
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    float* outptr = top_blob.channel(g);
-                    const float* kptr = (const float*)weight_data_tm + maxk * g * 4;
-                    const Mat m = bottom_blob_bordered.channel(g);
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int g = 0; g < channels; g++)
+            {
+                float* outptr = top_blob.channel(g);
+                const float* kptr = (const float*)kernel_tm + maxk * g * 4;
+                const Mat m = bottom_blob_bordered.channel(g);
 
-                    for (int i = 0; i < outh; i++)
+                for (int i = 0; i < outh; i++)
+                {
+                    for (int j = 0; j < outw; j++)
                     {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m128 _sum = _mm_set1_ps(0.f);
-
-                            if (bias_term)
-                            {
-                                _sum = _mm_loadu_ps(((const float*)bias_data) + g * 4);
-                            }
+                        __m128 _sum = _mm_set1_ps(0.f);
 
-                            const float* sptr = m.row(i * stride_h) + j * stride_w * 4;
-
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                __m128 _val = _mm_loadu_ps(sptr + space_ofs[k] * 4);
-                                __m128 _w = _mm_loadu_ps(kptr + k * 4);
-                                _sum = _mm_add_ps(_mm_mul_ps(_val, _w), _sum);
-                            }
+                        if (bias_term)
+                        {
+                            _sum = _mm_loadu_ps(((const float*)bias) + g * 4);
+                        }
 
-                            _sum = activation_sse(_sum, activation_type, activation_params);
+                        const float* sptr = m.row(i * stride_h) + j * stride_w * 4;
 
-                            _mm_storeu_ps(outptr + j * 4, _sum);
+                        for (int k = 0; k < maxk; k++)
+                        {
+                            __m128 _val = _mm_loadu_ps(sptr + space_ofs[k] * 4);
+                            __m128 _w = _mm_loadu_ps(kptr + k * 4);
+                            _sum = _mm_add_ps(_mm_mul_ps(_val, _w), _sum);
                         }
 
-                        outptr += outw * 4;
+                        _sum = activation_sse(_sum, activation_type, activation_params);
+
+                        _mm_storeu_ps(outptr + j * 4, _sum);
                     }
-                }
 
-                return 0;
+                    outptr += outw * 4;
+                }
             }
+
+            return 0;
         }
+    }
 #endif // __SSE2__
 
-        if (elempack == 1)
+    if (elempack == 1)
+    {
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
         {
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-            {
-                convdw3x3s1_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
-
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            convdw3x3s1_sse(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
-            }
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+            if (activation)
             {
-                convdw3x3s2_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, opt);
+                activation->forward_inplace(top_blob, opt);
+            }
 
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+            return 0;
+        }
+        if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
+        {
+            convdw3x3s2_sse(bottom_blob_bordered, top_blob, kernel_tm, bias, opt);
 
-                return 0;
+            if (activation)
+            {
+                activation->forward_inplace(top_blob, opt);
             }
+
+            return 0;
         }
     }
 
-    // group convolution
-    const int channels_g = channels * elempack / group;
-    const int num_output_g = num_output / group;
+    return 0;
+}
 
-    int g_elempack = 1;
-    int out_g_elempack = 1;
-#if __SSE2__
-    if (opt.use_packing_layout)
-    {
+#if NCNN_F16C && __F16C__
+static void convolutiondepthwise_unpack_fp16s(const unsigned short* ptr, float* outptr, int size)
+{
+    int i = 0;
 #if __AVX512F__
-        g_elempack = channels_g % 16 == 0 ? 16 : channels_g % 8 == 0 ? 8 : channels_g % 4 == 0 ? 4 : 1;
-        out_g_elempack = num_output_g % 16 == 0 ? 16 : num_output_g % 8 == 0 ? 8 : num_output_g % 4 == 0 ? 4 : 1;
-#elif __AVX__
-        g_elempack = channels_g % 8 == 0 ? 8 : channels_g % 4 == 0 ? 4 : 1;
-        out_g_elempack = num_output_g % 8 == 0 ? 8 : num_output_g % 4 == 0 ? 4 : 1;
-#else
-        g_elempack = channels_g % 4 == 0 ? 4 : 1;
-        out_g_elempack = num_output_g % 4 == 0 ? 4 : 1;
-#endif
+    for (; i + 15 < size; i += 16)
+    {
+        _mm512_storeu_ps(outptr, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)ptr)));
+        ptr += 16;
+        outptr += 16;
     }
-#endif // __SSE2__
-
-    // unpacking
-    Mat bottom_blob_bordered_unpacked = bottom_blob_bordered;
-    if (elempack > g_elempack)
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
     {
-        Option opt_p = opt;
-        opt_p.blob_allocator = opt.workspace_allocator;
-        convert_packing(bottom_blob_bordered, bottom_blob_bordered_unpacked, g_elempack, opt_p);
-        if (bottom_blob_bordered_unpacked.empty())
-            return -100;
+        _mm256_storeu_ps(outptr, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr)));
+        ptr += 8;
+        outptr += 8;
     }
-
-    Mat top_blob_unpacked = top_blob;
-    if (out_g_elempack < out_elempack)
+    for (; i < size; i++)
     {
-        top_blob_unpacked.create(outw, outh, num_output / out_g_elempack, out_elemsize / out_elempack * out_g_elempack, out_g_elempack, opt.workspace_allocator);
-        if (top_blob_unpacked.empty())
-            return -100;
+        *outptr++ = float16_to_float32(*ptr++);
     }
+}
 
-    for (int g = 0; g < group; g++)
-    {
-        const Mat bottom_blob_bordered_g = bottom_blob_bordered_unpacked.channel_range(channels_g * g / g_elempack, channels_g / g_elempack);
-        Mat top_blob_g = top_blob_unpacked.channel_range(num_output_g * g / out_g_elempack, num_output_g / out_g_elempack);
+int ConvolutionDepthWise_x86::forward_depthwise_fp16s(const Mat& bottom_blob_bordered, Mat& top_blob, const Option& opt) const
+{
+    const int channels = bottom_blob_bordered.c;
+    const int elempack = bottom_blob_bordered.elempack;
+    const int maxk = kernel_w * kernel_h;
 
-        const ncnn::Layer* op = group_ops[g];
+    const int nT = std::min(opt.num_threads, channels);
 
-        Option opt_g = opt;
-        opt_g.blob_allocator = top_blob_unpacked.allocator;
+    // the weight stays in fp16, each thread converts the one channel it runs right before use
+    Mat kernel_tm_fp32(maxk, 1, nT, 4u * elempack, elempack, opt.workspace_allocator);
+    if (kernel_tm_fp32.empty())
+        return -100;
 
-        // forward
-        int ret = op->forward(bottom_blob_bordered_g, top_blob_g, opt_g);
-        if (ret != 0)
-            return ret;
-    }
+    Option opt_g = opt;
+    opt_g.num_threads = 1;
 
-    // packing
-    if (out_g_elempack < out_elempack)
-    {
-        convert_packing(top_blob_unpacked, top_blob, out_elempack, opt);
-        if (top_blob.empty())
-            return -100;
-    }
-    else
+    #pragma omp parallel for num_threads(nT)
+    for (int g = 0; g < channels; g++)
     {
-        top_blob = top_blob_unpacked;
+        Mat kernel_tm = kernel_tm_fp32.channel(get_omp_thread_num());
+        convolutiondepthwise_unpack_fp16s((const unsigned short*)weight_data_tm + maxk * elempack * g, kernel_tm, maxk * elempack);
+
+        const Mat bias = bias_term ? bias_data.range(g * elempack, elempack) : Mat();
+
+        Mat top_blob_g = top_blob.channel_range(g, 1);
+        forward_depthwise(bottom_blob_bordered.channel_range(g, 1), top_blob_g, kernel_tm, bias, opt_g);
     }
 
     return 0;
 }
+#endif // NCNN_F16C && __F16C__
 
 int ConvolutionDepthWise_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
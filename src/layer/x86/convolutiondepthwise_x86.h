@@ -22,6 +22,8 @@ public:
 
 protected:
     int create_group_ops(const Option& opt);
+    int forward_depthwise(const Mat& bottom_blob_bordered, Mat& top_blob, const Mat& kernel_tm, const Mat& bias, const Option& opt) const;
+    int forward_depthwise_fp16s(const Mat& bottom_blob_bordered, Mat& top_blob, const Option& opt) const;
 #if NCNN_INT8
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
@@ -4,6 +4,7 @@
 #include "deconvolution_x86.h"
 
 #include "layer_type.h"
+#include "profiler.h"
 
 #if __SSE2__
 #include <emmintrin.h>
@@ -15,8 +16,14 @@
 #include "x86_activation.h"
 #include "x86_usability.h"
 
+#include "cpu.h"
+
 namespace ncnn {
 
+#if NCNN_INT8
+#include "convolution_im2col_gemm_int8.h"
+#endif
+
 #if __SSE2__
 #include "deconvolution_pack4.h"
 #include "deconvolution_pack1to4.h"
@@ -49,6 +56,7 @@ Deconvolution_x86::Deconvolution_x86()
 
     activation = 0;
     gemm = 0;
+    nT = 0;
 }
 
 int Deconvolution_x86::create_pipeline(const Option& opt)
@@ -57,6 +65,14 @@ int Deconvolution_x86::create_pipeline(const Option& opt)
         return 0;
 
     activation = create_activation_layer(activation_type, activation_params, opt);
+    nT = opt.num_threads;
+
+#if NCNN_INT8
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    {
+        return create_pipeline_int8_x86(opt);
+    }
+#endif
 
     const int maxk = kernel_w * kernel_h;
     int num_input = weight_data_size / maxk / num_output;
@@ -84,6 +100,8 @@ int Deconvolution_x86::create_pipeline(const Option& opt)
         const int maxk = kernel_w * kernel_h;
 
         gemm = ncnn::create_layer_cpu(ncnn::LayerType::Gemm);
+        // the sgemm path is fp32 only
+        gemm->support_bf16_storage = false;
 
         ncnn::ParamDict pd;
         pd.set(2, 1);                 // transA
@@ -209,6 +227,13 @@ int Deconvolution_x86::destroy_pipeline(const Option& opt)
 
 int Deconvolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if NCNN_INT8
+    if (opt.use_int8_inference && int8_scale_term)
+    {
+        return forward_int8_x86(bottom_blob, top_blob, opt);
+    }
+#endif
+
     // deconvolv with NxN kernel
     // value = value + bias
 
@@ -259,6 +284,7 @@ int Deconvolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Opti
     if (opt.use_sgemm_convolution)
     {
         // sgemm
+        profiler_set_kernel("gemm_col2im");
         Mat bottom_blob_2 = bottom_blob;
         {
             bottom_blob_2.w = bottom_blob.w * bottom_blob.h;
@@ -452,6 +478,7 @@ int Deconvolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Opti
     }
     else
     {
+        profiler_set_kernel("packed");
 #if __SSE2__
 #if __AVX__
 #if __AVX512F__
@@ -725,4 +752,222 @@ int Deconvolution_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector
     return 0;
 }
 
+#if NCNN_INT8
+int Deconvolution_x86::create_pipeline_int8_x86(const Option& opt)
+{
+    const int maxk = kernel_w * kernel_h;
+    const int num_input = weight_data_size / maxk / num_output;
+
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    // the column matrix is produced by a 1x1 int8 convolution with maxk*outch outputs
+    // maxk-inch-outch to inch-pb-maxk-outch/pb
+    Mat weight_data_col(num_input, maxk * num_output, (size_t)1u);
+    {
+        Mat weight_data_r2 = weight_data.reshape(maxk, num_input, num_output);
+
+        for (int q = 0; q + (out_elempack - 1) < num_output; q += out_elempack)
+        {
+            for (int k = 0; k < maxk; k++)
+            {
+                for (int i = 0; i < out_elempack; i++)
+                {
+                    signed char* g00 = weight_data_col.row<signed char>(q * maxk + k * out_elempack + i);
+
+                    for (int p = 0; p < num_input; p++)
+                    {
+                        g00[p] = weight_data_r2.channel(q + i).row<const signed char>(p)[k];
+                    }
+                }
+            }
+        }
+    }
+
+    convolution_im2col_gemm_transform_kernel_int8(weight_data_col, weight_data_tm, num_input, maxk * num_output, 1, 1, opt);
+
+    scale_in_data.create(num_output);
+    for (int p = 0; p < num_output; p++)
+    {
+        float scale_in;
+        if (weight_data_int8_scales[p] == 0)
+            scale_in = 0;
+        else
+            scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[p]);
+
+        scale_in_data[p] = scale_in;
+    }
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int Deconvolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int elembits = bottom_blob.elembits();
+
+    Mat bottom_blob_int8 = bottom_blob;
+    if (elembits != 8)
+    {
+        Option opt_q = opt;
+        opt_q.blob_allocator = opt.workspace_allocator;
+        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_q);
+        if (bottom_blob_int8.empty())
+            return -100;
+    }
+
+    const int w = bottom_blob_int8.w;
+    const int h = bottom_blob_int8.h;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w - 1) * stride_w + kernel_extent_w + output_pad_right;
+    const int outh = (h - 1) * stride_h + kernel_extent_h + output_pad_bottom;
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+
+    const int out_channels = num_output / out_elempack;
+
+    const int maxk = kernel_w * kernel_h;
+
+    Mat top_col2im;
+    top_col2im.create(w, h, maxk * out_channels, (size_t)(4u * out_elempack), out_elempack, opt.workspace_allocator);
+    if (top_col2im.empty())
+        return -100;
+
+    int _nT = nT ? nT : opt.num_threads;
+    if (nT != 0 && opt.num_threads != nT)
+    {
+        // force num_threads the same as in create_pipeline
+        // so we could use pre-packed A/B from the same tile config
+        NCNN_LOGE("opt.num_threads %d changed, deconvolution gemm will use load-time value %d", opt.num_threads, nT);
+    }
+
+    profiler_set_kernel("gemm_col2im_int8");
+    int ret = convolution_im2col_gemm_int8(bottom_blob_int8, top_col2im, weight_data_tm, 1, 1, 1, 1, 1, 1, _nT, opt);
+    if (ret != 0)
+        return ret;
+
+    bottom_blob_int8.release();
+
+    Mat top_blob_int32;
+    top_blob_int32.create(outw, outh, out_channels, (size_t)(4u * out_elempack), out_elempack, opt.workspace_allocator);
+    if (top_blob_int32.empty())
+        return -100;
+
+    // col2im
+    {
+        const int gap = (outw * stride_h - w * stride_w) * out_elempack;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int p = 0; p < out_channels; p++)
+        {
+            Mat outm = top_blob_int32.channel(p);
+
+            memset(outm.data, 0, outm.w * outm.h * out_elempack * sizeof(int));
+
+            for (int u = 0; u < kernel_h; u++)
+            {
+                for (int v = 0; v < kernel_w; v++)
+                {
+                    const int* sptr = top_col2im.channel(p * maxk + u * kernel_w + v);
+                    int* ptr = outm.row<int>(dilation_h * u) + dilation_w * v * out_elempack;
+
+                    for (int i = 0; i < h; i++)
+                    {
+                        for (int j = 0; j < w; j++)
+                        {
+                            int e = 0;
+#if __SSE2__
+#if __AVX512F__
+                            for (; e + 15 < out_elempack; e += 16)
+                            {
+                                __m512i _val = _mm512_loadu_si512((const __m512i*)(ptr + e));
+                                __m512i _s = _mm512_loadu_si512((const __m512i*)(sptr + e));
+                                _mm512_storeu_si512((__m512i*)(ptr + e), _mm512_add_epi32(_val, _s));
+                            }
+#endif // __AVX512F__
+                            for (; e + 3 < out_elempack; e += 4)
+                            {
+                                __m128i _val = _mm_loadu_si128((const __m128i*)(ptr + e));
+                                __m128i _s = _mm_loadu_si128((const __m128i*)(sptr + e));
+                                _mm_storeu_si128((__m128i*)(ptr + e), _mm_add_epi32(_val, _s));
+                            }
+#endif // __SSE2__
+                            for (; e < out_elempack; e++)
+                            {
+                                ptr[e] += sptr[e];
+                            }
+
+                            ptr += stride_w * out_elempack;
+                            sptr += out_elempack;
+                        }
+
+                        ptr += gap;
+                    }
+                }
+            }
+        }
+    }
+
+    top_col2im.release();
+
+    Mat top_blob_bordered;
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || (output_w > 0 && output_h > 0))
+    {
+        top_blob_bordered.create(outw, outh, out_channels, (size_t)(4u * out_elempack), out_elempack, opt.workspace_allocator);
+    }
+    else
+    {
+        top_blob_bordered = top_blob;
+        top_blob_bordered.create(outw, outh, out_channels, (size_t)(4u * out_elempack), out_elempack, opt.blob_allocator);
+    }
+    if (top_blob_bordered.empty())
+        return -100;
+
+    // dequantize in place of top_blob_bordered, which may be a channel range of the group output
+    Option opt_b = opt;
+    opt_b.blob_allocator = top_blob_bordered.allocator;
+    dequantize_from_int32(top_blob_int32, top_blob_bordered, scale_in_data, bias_data, opt_b);
+    if (top_blob_bordered.empty())
+        return -100;
+
+    if (activation)
+    {
+        activation->forward_inplace(top_blob_bordered, opt);
+    }
+
+    cut_padding(top_blob_bordered, top_blob, opt);
+    if (top_blob.empty())
+        return -100;
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
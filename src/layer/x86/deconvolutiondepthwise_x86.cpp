@@ -29,6 +29,13 @@ int DeconvolutionDepthWise_x86::create_pipeline(const Option& opt)
     if (dynamic_weight)
         return 0;
 
+#if NCNN_INT8
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    {
+        return create_pipeline_int8_x86(opt);
+    }
+#endif
+
     const int maxk = kernel_w * kernel_h;
     int channels = (weight_data_size / group) / maxk / (num_output / group) * group;
 
@@ -153,6 +160,7 @@ int DeconvolutionDepthWise_x86::create_group_ops(const Option& opt)
         pd.set(19, output_pad_bottom);
         pd.set(5, bias_term);
         pd.set(6, maxk * channels_g * num_output_g); // weight_data_size
+        pd.set(8, int8_scale_term);
         pd.set(9, activation_type);
         pd.set(10, activation_params);
 
@@ -161,17 +169,37 @@ int DeconvolutionDepthWise_x86::create_group_ops(const Option& opt)
         // set weights
         if (bias_term)
         {
-            ncnn::Mat weights[2];
+            ncnn::Mat weights[4];
             weights[0] = weight_data_g;
             weights[1] = bias_data_g;
 
+#if NCNN_INT8
+            if (int8_scale_term)
+            {
+                Mat weight_data_int8_scales_g(num_output_g);
+                weight_data_int8_scales_g.fill(weight_data_int8_scales[g]);
+                weights[2] = weight_data_int8_scales_g;
+                weights[3] = bottom_blob_int8_scales;
+            }
+#endif
+
             op->load_model(ModelBinFromMatArray(weights));
         }
         else
         {
-            ncnn::Mat weights[1];
+            ncnn::Mat weights[3];
             weights[0] = weight_data_g;
 
+#if NCNN_INT8
+            if (int8_scale_term)
+            {
+                Mat weight_data_int8_scales_g(num_output_g);
+                weight_data_int8_scales_g.fill(weight_data_int8_scales[g]);
+                weights[1] = weight_data_int8_scales_g;
+                weights[2] = bottom_blob_int8_scales;
+            }
+#endif
+
             op->load_model(ModelBinFromMatArray(weights));
         }
 
@@ -197,6 +225,13 @@ int DeconvolutionDepthWise_x86::destroy_pipeline(const Option& opt)
 
 int DeconvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+#if NCNN_INT8
+    if (opt.use_int8_inference && int8_scale_term && bottom_blob.c * bottom_blob.elempack == group && group == num_output)
+    {
+        return forward_int8_x86(bottom_blob, top_blob, opt);
+    }
+#endif
+
     // convolv with NxN kernel
     // value = value + bias
 
@@ -225,6 +260,13 @@ int DeconvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, c
     }
 #endif // __SSE2__
     size_t out_elemsize = elemsize / elempack * out_elempack;
+#if NCNN_INT8
+    if (opt.use_int8_inference && int8_scale_term)
+    {
+        // group ops dequantize to fp32
+        out_elemsize = 4u * out_elempack;
+    }
+#endif
 
     Mat top_blob_bordered;
     if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || (output_w > 0 && output_h > 0))
@@ -518,6 +560,14 @@ int DeconvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, c
         }
 #endif // __SSE2__
 
+#if NCNN_INT8
+        if (bottom_blob.elembits() == 8)
+        {
+            // int8 input comes in pack8 or pack1
+            g_elempack = elempack == 8 && channels_g % 8 == 0 ? 8 : 1;
+        }
+#endif
+
         // unpacking
         Mat bottom_blob_unpacked = bottom_blob;
         if (elempack > g_elempack)
@@ -680,4 +730,282 @@ int DeconvolutionDepthWise_x86::forward(const std::vector<Mat>& bottom_blobs, st
     return 0;
 }
 
+#if NCNN_INT8
+int DeconvolutionDepthWise_x86::create_pipeline_int8_x86(const Option& opt)
+{
+    const int maxk = kernel_w * kernel_h;
+    int channels = (weight_data_size / group) / maxk / (num_output / group) * group;
+
+    // depth-wise
+    if (channels == group && group == num_output)
+    {
+        int elempack = 1;
+#if __SSE2__
+        if (opt.use_packing_layout)
+        {
+            elempack = channels % 8 == 0 ? 8 : 1;
+        }
+#endif // __SSE2__
+
+        Mat weight_data_transposed(weight_data.w, (size_t)1u);
+        {
+            signed char* pt = weight_data_transposed;
+            const signed char* p = weight_data;
+
+            for (int i = 0; i < channels; i++)
+            {
+                for (int k = 0; k < maxk; k++)
+                {
+                    pt[maxk - 1 - k] = p[k];
+                }
+
+                p += maxk;
+                pt += maxk;
+            }
+        }
+
+        if (elempack == 8)
+        {
+            Mat weight_data_r2 = weight_data_transposed.reshape(maxk, group);
+            convert_packing(weight_data_r2, weight_data_tm, 8, opt);
+        }
+
+        if (elempack == 1)
+        {
+            weight_data_tm = weight_data_transposed;
+        }
+
+        scale_in_data.create(group);
+        for (int g = 0; g < group; g++)
+        {
+            float scale_in;
+            if (weight_data_int8_scales[g] == 0)
+                scale_in = 0;
+            else
+                scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[g]);
+
+            scale_in_data[g] = scale_in;
+        }
+
+        if (opt.lightmode)
+            weight_data.release();
+
+        return 0;
+    }
+
+    // group deconvolution
+    create_group_ops(opt);
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int DeconvolutionDepthWise_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int elembits = bottom_blob.elembits();
+
+    Mat bottom_blob_int8 = bottom_blob;
+    if (elembits != 8)
+    {
+        Option opt_q = opt;
+        opt_q.blob_allocator = opt.workspace_allocator;
+        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_q);
+        if (bottom_blob_int8.empty())
+            return -100;
+    }
+
+    int elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+        elempack = group % 8 == 0 ? 8 : 1;
+    }
+#endif // __SSE2__
+
+    if (bottom_blob_int8.elempack != elempack)
+    {
+        Option opt_p = opt;
+        opt_p.blob_allocator = opt.workspace_allocator;
+        Mat tmp;
+        convert_packing(bottom_blob_int8, tmp, elempack, opt_p);
+        if (tmp.empty())
+            return -100;
+
+        bottom_blob_int8 = tmp;
+    }
+
+    const int w = bottom_blob_int8.w;
+    const int h = bottom_blob_int8.h;
+    const int channels = bottom_blob_int8.c;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (w - 1) * stride_w + kernel_extent_w + output_pad_right;
+    const int outh = (h - 1) * stride_h + kernel_extent_h + output_pad_bottom;
+
+    Mat top_blob_bordered;
+    if (pad_left > 0 || pad_right > 0 || pad_top > 0 || pad_bottom > 0 || (output_w > 0 && output_h > 0))
+    {
+        top_blob_bordered.create(outw, outh, channels, 4u * elempack, elempack, opt.workspace_allocator);
+    }
+    else
+    {
+        top_blob_bordered = top_blob;
+        top_blob_bordered.create(outw, outh, channels, 4u * elempack, elempack, opt.blob_allocator);
+    }
+    if (top_blob_bordered.empty())
+        return -100;
+
+    const int maxk = kernel_w * kernel_h;
+
+#if __SSE2__
+    if (elempack == 8)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int g = 0; g < channels; g++)
+        {
+            float* outptr = top_blob_bordered.channel(g);
+            const signed char* kptr = (const signed char*)weight_data_tm + maxk * g * 8;
+            const Mat m = bottom_blob_int8.channel(g);
+
+            __m128 _scale_in0 = _mm_loadu_ps((const float*)scale_in_data + g * 8);
+            __m128 _scale_in1 = _mm_loadu_ps((const float*)scale_in_data + g * 8 + 4);
+
+            __m128 _bias0 = _mm_setzero_ps();
+            __m128 _bias1 = _mm_setzero_ps();
+            if (bias_term)
+            {
+                _bias0 = _mm_loadu_ps((const float*)bias_data + g * 8);
+                _bias1 = _mm_loadu_ps((const float*)bias_data + g * 8 + 4);
+            }
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    __m128i _sum0 = _mm_setzero_si128();
+                    __m128i _sum1 = _mm_setzero_si128();
+
+                    for (int y = 0; y < kernel_h; y++)
+                    {
+                        int sys = (i + y * dilation_h - (kernel_extent_h - 1));
+                        if (sys < 0 || sys % stride_h != 0)
+                            continue;
+
+                        int sy = sys / stride_h;
+                        if (sy >= h)
+                            continue;
+
+                        for (int x = 0; x < kernel_w; x++)
+                        {
+                            int sxs = (j + x * dilation_w - (kernel_extent_w - 1));
+                            if (sxs < 0 || sxs % stride_w != 0)
+                                continue;
+
+                            int sx = sxs / stride_w;
+                            if (sx >= w)
+                                continue;
+
+                            const signed char* sptr = m.row<const signed char>(sy) + sx * 8;
+
+                            int k = y * kernel_w + x;
+
+                            __m128i _val = _mm_loadl_epi64((const __m128i*)sptr);
+                            _val = _mm_unpacklo_epi8(_val, _mm_cmpgt_epi8(_mm_setzero_si128(), _val));
+
+                            __m128i _w = _mm_loadl_epi64((const __m128i*)(kptr + k * 8));
+                            _w = _mm_unpacklo_epi8(_w, _mm_cmpgt_epi8(_mm_setzero_si128(), _w));
+
+                            __m128i _sl = _mm_mullo_epi16(_val, _w);
+                            __m128i _sh = _mm_mulhi_epi16(_val, _w);
+                            __m128i _s0 = _mm_unpacklo_epi16(_sl, _sh);
+                            __m128i _s1 = _mm_unpackhi_epi16(_sl, _sh);
+
+                            _sum0 = _mm_add_epi32(_sum0, _s0);
+                            _sum1 = _mm_add_epi32(_sum1, _s1);
+                        }
+                    }
+
+                    __m128 _sumfp32_0 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum0), _scale_in0), _bias0);
+                    __m128 _sumfp32_1 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum1), _scale_in1), _bias1);
+
+                    _sumfp32_0 = activation_sse(_sumfp32_0, activation_type, activation_params);
+                    _sumfp32_1 = activation_sse(_sumfp32_1, activation_type, activation_params);
+
+                    _mm_storeu_ps(outptr, _sumfp32_0);
+                    _mm_storeu_ps(outptr + 4, _sumfp32_1);
+                    outptr += 8;
+                }
+            }
+        }
+    }
+#endif // __SSE2__
+
+    if (elempack == 1)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int g = 0; g < channels; g++)
+        {
+            float* outptr = top_blob_bordered.channel(g);
+            const signed char* kptr = (const signed char*)weight_data_tm + maxk * g;
+            const Mat m = bottom_blob_int8.channel(g);
+
+            const float scale_in = scale_in_data[g];
+            const float bias = bias_term ? bias_data[g] : 0.f;
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    int sum = 0;
+
+                    for (int y = 0; y < kernel_h; y++)
+                    {
+                        int sys = (i + y * dilation_h - (kernel_extent_h - 1));
+                        if (sys < 0 || sys % stride_h != 0)
+                            continue;
+
+                        int sy = sys / stride_h;
+                        if (sy >= h)
+                            continue;
+
+                        const signed char* sptr = m.row<const signed char>(sy);
+
+                        for (int x = 0; x < kernel_w; x++)
+                        {
+                            int sxs = (j + x * dilation_w - (kernel_extent_w - 1));
+                            if (sxs < 0 || sxs % stride_w != 0)
+                                continue;
+
+                            int sx = sxs / stride_w;
+                            if (sx >= w)
+                                continue;
+
+                            int k = y * kernel_w + x;
+
+                            sum += sptr[sx] * kptr[k];
+                        }
+                    }
+
+                    float sumfp32 = sum * scale_in + bias;
+
+                    outptr[j] = activation_ss(sumfp32, activation_type, activation_params);
+                }
+
+                outptr += outw;
+            }
+        }
+    }
+
+    cut_padding(top_blob_bordered, top_blob, opt);
+    if (top_blob.empty())
+        return -100;
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
@@ -124,6 +124,8 @@ int DeformableConv2D_x86::create_pipeline(const Option& opt)
         const int maxk = kernel_w * kernel_h;
 
         gemm = ncnn::create_layer_cpu(ncnn::LayerType::Gemm);
+        // the im2col blob is fp32
+        gemm->support_bf16_storage = false;
 
         ncnn::ParamDict pd;
         pd.set(2, 0);                   // transA
@@ -0,0 +1,677 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AMX && __AVX512F__ && !__AVX512BF16__ && !__AMX_BF16__
+void gemm_transB_packed_bf16s_amx(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+void gemm_transB_packed_bf16s_avx512bf16(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT);
+#endif
+
+// packed bf16 layout
+// rows are grouped into blocks of 16 8 4 1, blocks of A are no wider than the simd width
+// each block stores k pairs interleaved, (k0 k1) of one row occupy one 32-bit lane
+// so one lane of A against one broadcast lane of B feeds a vdpbf16ps dot product
+// odd K is padded with zero
+// the block starting at row i is located at AT.row(i), AT is (K2 * 2) x M
+
+static void pack_tile_bf16s(const Mat& A, Mat& AT, int i, int max_ii, int K, int k_major)
+{
+    const size_t A_hstep = A.dims == 3 ? A.cstep : (size_t)A.w;
+    const int K2 = (K + 1) / 2;
+
+    unsigned short* pp = AT.row<unsigned short>(i);
+
+    if (k_major)
+    {
+        // A = K x M
+        for (int kk = 0; kk < K2; kk++)
+        {
+            const unsigned short* p0 = (const unsigned short*)A + (size_t)(kk * 2) * A_hstep + i;
+            const unsigned short* p1 = kk * 2 + 1 < K ? p0 + A_hstep : 0;
+
+            int ii = 0;
+#if __SSE2__
+            for (; ii + 7 < max_ii; ii += 8)
+            {
+                __m128i _r0 = _mm_loadu_si128((const __m128i*)(p0 + ii));
+                __m128i _r1 = p1 ? _mm_loadu_si128((const __m128i*)(p1 + ii)) : _mm_setzero_si128();
+                _mm_storeu_si128((__m128i*)pp, _mm_unpacklo_epi16(_r0, _r1));
+                _mm_storeu_si128((__m128i*)(pp + 8), _mm_unpackhi_epi16(_r0, _r1));
+                pp += 16;
+            }
+#endif // __SSE2__
+            for (; ii < max_ii; ii++)
+            {
+                pp[0] = p0[ii];
+                pp[1] = p1 ? p1[ii] : 0;
+                pp += 2;
+            }
+        }
+    }
+    else
+    {
+        // A = M x K
+        for (int kk = 0; kk < K2; kk++)
+        {
+            for (int ii = 0; ii < max_ii; ii++)
+            {
+                const unsigned short* p0 = (const unsigned short*)A + (size_t)(i + ii) * A_hstep + kk * 2;
+
+                pp[0] = p0[0];
+                pp[1] = kk * 2 + 1 < K ? p0[1] : 0;
+                pp += 2;
+            }
+        }
+    }
+}
+
+static void pack_bf16s(const Mat& A, Mat& AT, int M, int K, int k_major, int max_pack, int nT)
+{
+    int ii = 0;
+    for (int pk = 16; pk >= 4; pk /= 2)
+    {
+        if (pk > max_pack)
+            continue;
+
+        const int nn_M = (M - ii) / pk;
+
+        #pragma omp parallel for num_threads(nT)
+        for (int ppi = 0; ppi < nn_M; ppi++)
+        {
+            pack_tile_bf16s(A, AT, ii + ppi * pk, pk, K, k_major);
+        }
+
+        ii += nn_M * pk;
+    }
+
+    const int remain_M_start = ii;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int i = remain_M_start; i < M; i++)
+    {
+        pack_tile_bf16s(A, AT, i, 1, K, k_major);
+    }
+}
+
+static void pack_A_bf16s(const Mat& A, Mat& AT, int M, int K, int k_major, int nT)
+{
+#if __AVX512F__
+    pack_bf16s(A, AT, M, K, k_major, 16, nT);
+#elif __AVX__
+    pack_bf16s(A, AT, M, K, k_major, 8, nT);
+#elif __SSE2__
+    pack_bf16s(A, AT, M, K, k_major, 4, nT);
+#else
+    pack_bf16s(A, AT, M, K, k_major, 1, nT);
+#endif
+}
+
+static void pack_B_bf16s(const Mat& B, Mat& BT, int N, int K, int k_major, int nT)
+{
+    pack_bf16s(B, BT, N, K, k_major, 8, nT);
+}
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+static NCNN_FORCEINLINE __m512 dpbf16_ps_avx512(const __m512& _sum, const __m512i& _a, const unsigned short* pb)
+{
+#if __AVX512BF16__
+    return _mm512_dpbf16_ps(_sum, (__m512bh)_a, (__m512bh)_mm512_set1_epi32(*(const int*)pb));
+#else
+    __m512 _a0 = _mm512_castsi512_ps(_mm512_slli_epi32(_a, 16));
+    __m512 _a1 = _mm512_castsi512_ps(_mm512_and_si512(_a, _mm512_set1_epi32((int)0xffff0000)));
+    __m512 _s = _mm512_fmadd_ps(_a0, _mm512_set1_ps(bfloat16_to_float32(pb[0])), _sum);
+    return _mm512_fmadd_ps(_a1, _mm512_set1_ps(bfloat16_to_float32(pb[1])), _s);
+#endif
+}
+#endif // __AVX512F__
+
+static NCNN_FORCEINLINE __m256 dpbf16_ps_avx(const __m256& _sum, const __m256i& _a, const unsigned short* pb)
+{
+#if __AVX512BF16__
+    return _mm256_dpbf16_ps(_sum, (__m256bh)_a, (__m256bh)_mm256_set1_epi32(*(const int*)pb));
+#else
+#if __AVX2__
+    __m256 _a0 = _mm256_castsi256_ps(_mm256_slli_epi32(_a, 16));
+#else
+    __m128i _a0l = _mm_slli_epi32(_mm256_extractf128_si256(_a, 0), 16);
+    __m128i _a0h = _mm_slli_epi32(_mm256_extractf128_si256(_a, 1), 16);
+    __m256 _a0 = _mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(_a0l), _a0h, 1));
+#endif
+    __m256 _a1 = _mm256_and_ps(_mm256_castsi256_ps(_a), _mm256_castsi256_ps(_mm256_set1_epi32((int)0xffff0000)));
+    __m256 _s = _mm256_comp_fmadd_ps(_a0, _mm256_set1_ps(bfloat16_to_float32(pb[0])), _sum);
+    return _mm256_comp_fmadd_ps(_a1, _mm256_set1_ps(bfloat16_to_float32(pb[1])), _s);
+#endif
+}
+#endif // __AVX__
+
+static NCNN_FORCEINLINE __m128 dpbf16_ps_sse(const __m128& _sum, const __m128i& _a, const unsigned short* pb)
+{
+#if __AVX512BF16__
+    return _mm_dpbf16_ps(_sum, (__m128bh)_a, (__m128bh)_mm_set1_epi32(*(const int*)pb));
+#else
+    __m128 _a0 = _mm_castsi128_ps(_mm_slli_epi32(_a, 16));
+    __m128 _a1 = _mm_castsi128_ps(_mm_and_si128(_a, _mm_set1_epi32((int)0xffff0000)));
+    __m128 _s = _mm_comp_fmadd_ps(_a0, _mm_set1_ps(bfloat16_to_float32(pb[0])), _sum);
+    return _mm_comp_fmadd_ps(_a1, _mm_set1_ps(bfloat16_to_float32(pb[1])), _s);
+#endif
+}
+#endif // __SSE2__
+
+static void gemm_transB_packed_tile_bf16s(const Mat& AT, const Mat& BT, Mat& topT, int i, int max_ii, int N, int K)
+{
+    // topT = N x M, topT[j][i] = sum A[i][k] * B[j][k]
+    const int K2 = (K + 1) / 2;
+
+    const unsigned short* pA0 = AT.row<const unsigned short>(i);
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (max_ii == 16)
+    {
+        int jj = 0;
+        for (; jj + 7 < N; jj += 8)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m512 _sum0 = _mm512_setzero_ps();
+            __m512 _sum1 = _mm512_setzero_ps();
+            __m512 _sum2 = _mm512_setzero_ps();
+            __m512 _sum3 = _mm512_setzero_ps();
+            __m512 _sum4 = _mm512_setzero_ps();
+            __m512 _sum5 = _mm512_setzero_ps();
+            __m512 _sum6 = _mm512_setzero_ps();
+            __m512 _sum7 = _mm512_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m512i _pA = _mm512_loadu_si512((const __m512i*)pA);
+
+                _sum0 = dpbf16_ps_avx512(_sum0, _pA, pB);
+                _sum1 = dpbf16_ps_avx512(_sum1, _pA, pB + 2);
+                _sum2 = dpbf16_ps_avx512(_sum2, _pA, pB + 4);
+                _sum3 = dpbf16_ps_avx512(_sum3, _pA, pB + 6);
+                _sum4 = dpbf16_ps_avx512(_sum4, _pA, pB + 8);
+                _sum5 = dpbf16_ps_avx512(_sum5, _pA, pB + 10);
+                _sum6 = dpbf16_ps_avx512(_sum6, _pA, pB + 12);
+                _sum7 = dpbf16_ps_avx512(_sum7, _pA, pB + 14);
+
+                pA += 32;
+                pB += 16;
+            }
+
+            _mm512_storeu_ps(topT.row(jj) + i, _sum0);
+            _mm512_storeu_ps(topT.row(jj + 1) + i, _sum1);
+            _mm512_storeu_ps(topT.row(jj + 2) + i, _sum2);
+            _mm512_storeu_ps(topT.row(jj + 3) + i, _sum3);
+            _mm512_storeu_ps(topT.row(jj + 4) + i, _sum4);
+            _mm512_storeu_ps(topT.row(jj + 5) + i, _sum5);
+            _mm512_storeu_ps(topT.row(jj + 6) + i, _sum6);
+            _mm512_storeu_ps(topT.row(jj + 7) + i, _sum7);
+        }
+        for (; jj + 3 < N; jj += 4)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m512 _sum0 = _mm512_setzero_ps();
+            __m512 _sum1 = _mm512_setzero_ps();
+            __m512 _sum2 = _mm512_setzero_ps();
+            __m512 _sum3 = _mm512_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m512i _pA = _mm512_loadu_si512((const __m512i*)pA);
+
+                _sum0 = dpbf16_ps_avx512(_sum0, _pA, pB);
+                _sum1 = dpbf16_ps_avx512(_sum1, _pA, pB + 2);
+                _sum2 = dpbf16_ps_avx512(_sum2, _pA, pB + 4);
+                _sum3 = dpbf16_ps_avx512(_sum3, _pA, pB + 6);
+
+                pA += 32;
+                pB += 8;
+            }
+
+            _mm512_storeu_ps(topT.row(jj) + i, _sum0);
+            _mm512_storeu_ps(topT.row(jj + 1) + i, _sum1);
+            _mm512_storeu_ps(topT.row(jj + 2) + i, _sum2);
+            _mm512_storeu_ps(topT.row(jj + 3) + i, _sum3);
+        }
+        for (; jj < N; jj++)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m512 _sum0 = _mm512_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m512i _pA = _mm512_loadu_si512((const __m512i*)pA);
+
+                _sum0 = dpbf16_ps_avx512(_sum0, _pA, pB);
+
+                pA += 32;
+                pB += 2;
+            }
+
+            _mm512_storeu_ps(topT.row(jj) + i, _sum0);
+        }
+
+        return;
+    }
+#endif // __AVX512F__
+    if (max_ii == 8)
+    {
+        int jj = 0;
+        for (; jj + 7 < N; jj += 8)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m256 _sum0 = _mm256_setzero_ps();
+            __m256 _sum1 = _mm256_setzero_ps();
+            __m256 _sum2 = _mm256_setzero_ps();
+            __m256 _sum3 = _mm256_setzero_ps();
+            __m256 _sum4 = _mm256_setzero_ps();
+            __m256 _sum5 = _mm256_setzero_ps();
+            __m256 _sum6 = _mm256_setzero_ps();
+            __m256 _sum7 = _mm256_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m256i _pA = _mm256_loadu_si256((const __m256i*)pA);
+
+                _sum0 = dpbf16_ps_avx(_sum0, _pA, pB);
+                _sum1 = dpbf16_ps_avx(_sum1, _pA, pB + 2);
+                _sum2 = dpbf16_ps_avx(_sum2, _pA, pB + 4);
+                _sum3 = dpbf16_ps_avx(_sum3, _pA, pB + 6);
+                _sum4 = dpbf16_ps_avx(_sum4, _pA, pB + 8);
+                _sum5 = dpbf16_ps_avx(_sum5, _pA, pB + 10);
+                _sum6 = dpbf16_ps_avx(_sum6, _pA, pB + 12);
+                _sum7 = dpbf16_ps_avx(_sum7, _pA, pB + 14);
+
+                pA += 16;
+                pB += 16;
+            }
+
+            _mm256_storeu_ps(topT.row(jj) + i, _sum0);
+            _mm256_storeu_ps(topT.row(jj + 1) + i, _sum1);
+            _mm256_storeu_ps(topT.row(jj + 2) + i, _sum2);
+            _mm256_storeu_ps(topT.row(jj + 3) + i, _sum3);
+            _mm256_storeu_ps(topT.row(jj + 4) + i, _sum4);
+            _mm256_storeu_ps(topT.row(jj + 5) + i, _sum5);
+            _mm256_storeu_ps(topT.row(jj + 6) + i, _sum6);
+            _mm256_storeu_ps(topT.row(jj + 7) + i, _sum7);
+        }
+        for (; jj + 3 < N; jj += 4)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m256 _sum0 = _mm256_setzero_ps();
+            __m256 _sum1 = _mm256_setzero_ps();
+            __m256 _sum2 = _mm256_setzero_ps();
+            __m256 _sum3 = _mm256_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m256i _pA = _mm256_loadu_si256((const __m256i*)pA);
+
+                _sum0 = dpbf16_ps_avx(_sum0, _pA, pB);
+                _sum1 = dpbf16_ps_avx(_sum1, _pA, pB + 2);
+                _sum2 = dpbf16_ps_avx(_sum2, _pA, pB + 4);
+                _sum3 = dpbf16_ps_avx(_sum3, _pA, pB + 6);
+
+                pA += 16;
+                pB += 8;
+            }
+
+            _mm256_storeu_ps(topT.row(jj) + i, _sum0);
+            _mm256_storeu_ps(topT.row(jj + 1) + i, _sum1);
+            _mm256_storeu_ps(topT.row(jj + 2) + i, _sum2);
+            _mm256_storeu_ps(topT.row(jj + 3) + i, _sum3);
+        }
+        for (; jj < N; jj++)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m256 _sum0 = _mm256_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m256i _pA = _mm256_loadu_si256((const __m256i*)pA);
+
+                _sum0 = dpbf16_ps_avx(_sum0, _pA, pB);
+
+                pA += 16;
+                pB += 2;
+            }
+
+            _mm256_storeu_ps(topT.row(jj) + i, _sum0);
+        }
+
+        return;
+    }
+#endif // __AVX__
+    if (max_ii == 4)
+    {
+        int jj = 0;
+        for (; jj + 7 < N; jj += 8)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m128 _sum0 = _mm_setzero_ps();
+            __m128 _sum1 = _mm_setzero_ps();
+            __m128 _sum2 = _mm_setzero_ps();
+            __m128 _sum3 = _mm_setzero_ps();
+            __m128 _sum4 = _mm_setzero_ps();
+            __m128 _sum5 = _mm_setzero_ps();
+            __m128 _sum6 = _mm_setzero_ps();
+            __m128 _sum7 = _mm_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m128i _pA = _mm_loadu_si128((const __m128i*)pA);
+
+                _sum0 = dpbf16_ps_sse(_sum0, _pA, pB);
+                _sum1 = dpbf16_ps_sse(_sum1, _pA, pB + 2);
+                _sum2 = dpbf16_ps_sse(_sum2, _pA, pB + 4);
+                _sum3 = dpbf16_ps_sse(_sum3, _pA, pB + 6);
+                _sum4 = dpbf16_ps_sse(_sum4, _pA, pB + 8);
+                _sum5 = dpbf16_ps_sse(_sum5, _pA, pB + 10);
+                _sum6 = dpbf16_ps_sse(_sum6, _pA, pB + 12);
+                _sum7 = dpbf16_ps_sse(_sum7, _pA, pB + 14);
+
+                pA += 8;
+                pB += 16;
+            }
+
+            _mm_storeu_ps(topT.row(jj) + i, _sum0);
+            _mm_storeu_ps(topT.row(jj + 1) + i, _sum1);
+            _mm_storeu_ps(topT.row(jj + 2) + i, _sum2);
+            _mm_storeu_ps(topT.row(jj + 3) + i, _sum3);
+            _mm_storeu_ps(topT.row(jj + 4) + i, _sum4);
+            _mm_storeu_ps(topT.row(jj + 5) + i, _sum5);
+            _mm_storeu_ps(topT.row(jj + 6) + i, _sum6);
+            _mm_storeu_ps(topT.row(jj + 7) + i, _sum7);
+        }
+        for (; jj + 3 < N; jj += 4)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m128 _sum0 = _mm_setzero_ps();
+            __m128 _sum1 = _mm_setzero_ps();
+            __m128 _sum2 = _mm_setzero_ps();
+            __m128 _sum3 = _mm_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m128i _pA = _mm_loadu_si128((const __m128i*)pA);
+
+                _sum0 = dpbf16_ps_sse(_sum0, _pA, pB);
+                _sum1 = dpbf16_ps_sse(_sum1, _pA, pB + 2);
+                _sum2 = dpbf16_ps_sse(_sum2, _pA, pB + 4);
+                _sum3 = dpbf16_ps_sse(_sum3, _pA, pB + 6);
+
+                pA += 8;
+                pB += 8;
+            }
+
+            _mm_storeu_ps(topT.row(jj) + i, _sum0);
+            _mm_storeu_ps(topT.row(jj + 1) + i, _sum1);
+            _mm_storeu_ps(topT.row(jj + 2) + i, _sum2);
+            _mm_storeu_ps(topT.row(jj + 3) + i, _sum3);
+        }
+        for (; jj < N; jj++)
+        {
+            const unsigned short* pA = pA0;
+            const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+            __m128 _sum0 = _mm_setzero_ps();
+
+            for (int kk = 0; kk < K2; kk++)
+            {
+                __m128i _pA = _mm_loadu_si128((const __m128i*)pA);
+
+                _sum0 = dpbf16_ps_sse(_sum0, _pA, pB);
+
+                pA += 8;
+                pB += 2;
+            }
+
+            _mm_storeu_ps(topT.row(jj) + i, _sum0);
+        }
+
+        return;
+    }
+#endif // __SSE2__
+
+    // max_ii == 1
+    int jj = 0;
+    while (jj < N)
+    {
+        // same blocking as pack_B_bf16s
+        const int max_jj = jj + 7 < N ? 8 : jj + 3 < N ? 4 : 1;
+
+        const unsigned short* pA = pA0;
+        const unsigned short* pB = BT.row<const unsigned short>(jj);
+
+        float sum[8] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+
+        for (int kk = 0; kk < K2; kk++)
+        {
+            const float a0 = bfloat16_to_float32(pA[0]);
+            const float a1 = bfloat16_to_float32(pA[1]);
+
+            for (int r = 0; r < max_jj; r++)
+            {
+                sum[r] += a0 * bfloat16_to_float32(pB[0]);
+                sum[r] += a1 * bfloat16_to_float32(pB[1]);
+                pB += 2;
+            }
+
+            pA += 2;
+        }
+
+        for (int r = 0; r < max_jj; r++)
+        {
+            topT.row(jj + r)[i] = sum[r];
+        }
+
+        jj += max_jj;
+    }
+}
+
+#if __AMX_BF16__
+static void transpose_pack_B_bf16s_amx16(const Mat& BT, Mat& BT_amx, int N, int K, int nT)
+{
+    // BT_amx = rows of contiguous k pairs, N padded to 16 with zero rows
+    // 16 rows of it form the A operand of tdpbf16ps
+    const int K2 = (K + 1) / 2;
+    const int N8 = N / 8 * 8;
+    const int N4 = N8 + (N - N8) / 4 * 4;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int jj = 0; jj < BT_amx.h; jj++)
+    {
+        int* pp = BT_amx.row<int>(jj);
+
+        if (jj >= N)
+        {
+            for (int kk = 0; kk < K2; kk++)
+            {
+                pp[kk] = 0;
+            }
+            continue;
+        }
+
+        // same blocking as pack_B_bf16s
+        const int j = jj < N8 ? jj / 8 * 8 : jj < N4 ? N8 + (jj - N8) / 4 * 4 : jj;
+        const int max_jj = jj < N8 ? 8 : jj < N4 ? 4 : 1;
+
+        const int* p0 = (const int*)BT.row<const unsigned short>(j) + (jj - j);
+
+        for (int kk = 0; kk < K2; kk++)
+        {
+            pp[kk] = p0[kk * max_jj];
+        }
+    }
+}
+
+static void gemm_transB_packed_tile_bf16s_amx16(const Mat& AT, const Mat& BT_amx, Mat& topT, int i, int N, int K)
+{
+    // topT^T block = BT_amx x AT block, 16 j x 16 i per tile
+    // the 16-row AT block is already a valid B operand, k pair rows of 16 x 2 bf16
+    const int K2 = (K + 1) / 2;
+    const int tail2 = K2 % 16;
+
+    amx_tilecfg cfg;
+    amx_tilecfg_init(cfg);
+    amx_tilecfg_set(cfg, 0, 16, 64);
+    amx_tilecfg_set(cfg, 1, 16, 64);
+    amx_tilecfg_set(cfg, 2, 16, 64);
+    amx_tilecfg_set(cfg, 3, 16, tail2 ? tail2 * 4 : 64);
+    amx_tilecfg_set(cfg, 4, tail2 ? tail2 : 16, 64);
+    _tile_loadconfig(&cfg);
+
+    const unsigned short* pA = AT.row<const unsigned short>(i);
+    const int A_stride = (int)(BT_amx.w * sizeof(int));
+    const int out_stride = (int)(topT.w * sizeof(float));
+
+    for (int jj = 0; jj < N; jj += 16)
+    {
+        const int* pB = BT_amx.row<const int>(jj);
+
+        _tile_zero(0);
+
+        int kk = 0;
+        for (; kk + 15 < K2; kk += 16)
+        {
+            _tile_loadd(1, pB + kk, A_stride);
+            _tile_loadd(2, pA + kk * 32, 64);
+            _tile_dpbf16ps(0, 1, 2);
+        }
+        if (kk < K2)
+        {
+            _tile_loadd(3, pB + kk, A_stride);
+            _tile_loadd(4, pA + kk * 32, 64);
+            _tile_dpbf16ps(0, 3, 4);
+        }
+
+        if (jj + 15 < N)
+        {
+            _tile_stored(0, topT.row(jj) + i, out_stride);
+        }
+        else
+        {
+            float tmp[256];
+            _tile_stored(0, tmp, 64);
+
+            for (int r = 0; r < N - jj; r++)
+            {
+                _mm512_storeu_ps(topT.row(jj + r) + i, _mm512_loadu_ps(tmp + r * 16));
+            }
+        }
+    }
+
+    _tile_release();
+}
+#endif // __AMX_BF16__
+
+static void gemm_transB_packed_bf16s(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AMX && __AVX512F__ && !__AVX512BF16__ && !__AMX_BF16__
+    if (ncnn::cpu_support_x86_amx_bf16())
+    {
+        gemm_transB_packed_bf16s_amx(AT, BT, topT, M, N, K, nT);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+    if (ncnn::cpu_support_x86_avx512_bf16())
+    {
+        gemm_transB_packed_bf16s_avx512bf16(AT, BT, topT, M, N, K, nT);
+        return;
+    }
+#endif
+
+    // AT packed by pack_A_bf16s, BT packed by pack_B_bf16s
+    // topT = N x M
+    int ii = 0;
+#if __AMX_BF16__
+    if (ncnn::cpu_support_x86_amx_bf16() && M >= 16)
+    {
+        Mat BT_amx((K + 1) / 2, (N + 15) / 16 * 16, (size_t)4u);
+        if (!BT_amx.empty())
+        {
+            transpose_pack_B_bf16s_amx16(BT, BT_amx, N, K, nT);
+
+            const int nn_M = M / 16;
+
+            #pragma omp parallel for num_threads(nT)
+            for (int ppi = 0; ppi < nn_M; ppi++)
+            {
+                gemm_transB_packed_tile_bf16s_amx16(AT, BT_amx, topT, ppi * 16, N, K);
+            }
+
+            ii += nn_M * 16;
+        }
+    }
+#endif // __AMX_BF16__
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        const int nn_M = (M - ii) / 16;
+
+        #pragma omp parallel for num_threads(nT)
+        for (int ppi = 0; ppi < nn_M; ppi++)
+        {
+            gemm_transB_packed_tile_bf16s(AT, BT, topT, ii + ppi * 16, 16, N, K);
+        }
+
+        ii += nn_M * 16;
+    }
+#endif // __AVX512F__
+    {
+        const int nn_M = (M - ii) / 8;
+
+        #pragma omp parallel for num_threads(nT)
+        for (int ppi = 0; ppi < nn_M; ppi++)
+        {
+            gemm_transB_packed_tile_bf16s(AT, BT, topT, ii + ppi * 8, 8, N, K);
+        }
+
+        ii += nn_M * 8;
+    }
+#endif // __AVX__
+    {
+        const int nn_M = (M - ii) / 4;
+
+        #pragma omp parallel for num_threads(nT)
+        for (int ppi = 0; ppi < nn_M; ppi++)
+        {
+            gemm_transB_packed_tile_bf16s(AT, BT, topT, ii + ppi * 4, 4, N, K);
+        }
+
+        ii += nn_M * 4;
+    }
+#endif // __SSE2__
+
+    const int remain_M_start = ii;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int i = remain_M_start; i < M; i++)
+    {
+        gemm_transB_packed_tile_bf16s(AT, BT, topT, i, 1, N, K);
+    }
+}
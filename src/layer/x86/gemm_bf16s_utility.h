@@ -0,0 +1,99 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// gemm_x86.h
+#if NCNN_RUNTIME_CPU && __AVX512F__
+namespace Gemm_x86_avx512_utility {
+#elif NCNN_RUNTIME_CPU && __FMA__
+namespace Gemm_x86_fma_utility {
+#elif NCNN_RUNTIME_CPU && __AVX__
+namespace Gemm_x86_avx_utility {
+#else
+namespace Gemm_x86_utility {
+#endif
+void pack_A_bf16s(const Mat& A, Mat& AT, int M, int K, int k_major, int nT);
+void pack_B_bf16s(const Mat& B, Mat& BT, int N, int K, int k_major, int nT);
+void gemm_transB_packed_bf16s(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT);
+}
+
+static void pack_A_bf16s(const Mat& A, Mat& AT, int M, int K, int k_major, int nT)
+{
+#if NCNN_RUNTIME_CPU && __AVX512F__
+    Gemm_x86_avx512_utility::pack_A_bf16s(A, AT, M, K, k_major, nT);
+#elif NCNN_RUNTIME_CPU && __FMA__
+    Gemm_x86_fma_utility::pack_A_bf16s(A, AT, M, K, k_major, nT);
+#elif NCNN_RUNTIME_CPU && __AVX__
+    Gemm_x86_avx_utility::pack_A_bf16s(A, AT, M, K, k_major, nT);
+#else
+    Gemm_x86_utility::pack_A_bf16s(A, AT, M, K, k_major, nT);
+#endif
+}
+
+static void pack_B_bf16s(const Mat& B, Mat& BT, int N, int K, int k_major, int nT)
+{
+#if NCNN_RUNTIME_CPU && __AVX512F__
+    Gemm_x86_avx512_utility::pack_B_bf16s(B, BT, N, K, k_major, nT);
+#elif NCNN_RUNTIME_CPU && __FMA__
+    Gemm_x86_fma_utility::pack_B_bf16s(B, BT, N, K, k_major, nT);
+#elif NCNN_RUNTIME_CPU && __AVX__
+    Gemm_x86_avx_utility::pack_B_bf16s(B, BT, N, K, k_major, nT);
+#else
+    Gemm_x86_utility::pack_B_bf16s(B, BT, N, K, k_major, nT);
+#endif
+}
+
+static void gemm_transB_packed_bf16s(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT)
+{
+#if NCNN_RUNTIME_CPU && __AVX512F__
+    Gemm_x86_avx512_utility::gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+#elif NCNN_RUNTIME_CPU && __FMA__
+    Gemm_x86_fma_utility::gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+#elif NCNN_RUNTIME_CPU && __AVX__
+    Gemm_x86_avx_utility::gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+#else
+    Gemm_x86_utility::gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+#endif
+}
+
+static void gemm_bf16s_store_output(const float* ptr, unsigned short* outptr, int size, float bias, const float* biasptr, int activation_type, const Mat& activation_params)
+{
+    // outptr = activation(ptr + bias + biasptr) in bf16
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _v = _mm512_add_ps(_mm512_loadu_ps(ptr + i), _mm512_set1_ps(bias));
+        if (biasptr)
+            _v = _mm512_add_ps(_v, _mm512_loadu_ps(biasptr + i));
+        _v = activation_avx512(_v, activation_type, activation_params);
+        _mm256_storeu_si256((__m256i*)(outptr + i), float2bfloat_avx512(_v));
+    }
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _v = _mm256_add_ps(_mm256_loadu_ps(ptr + i), _mm256_set1_ps(bias));
+        if (biasptr)
+            _v = _mm256_add_ps(_v, _mm256_loadu_ps(biasptr + i));
+        _v = activation_avx(_v, activation_type, activation_params);
+        _mm_storeu_si128((__m128i*)(outptr + i), float2bfloat_avx(_v));
+    }
+#endif // __AVX__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128 _v = _mm_add_ps(_mm_loadu_ps(ptr + i), _mm_set1_ps(bias));
+        if (biasptr)
+            _v = _mm_add_ps(_v, _mm_loadu_ps(biasptr + i));
+        _v = activation_sse(_v, activation_type, activation_params);
+        _mm_storel_epi64((__m128i*)(outptr + i), float2bfloat_sse(_v, _v));
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        float v = ptr[i] + bias;
+        if (biasptr)
+            v += biasptr[i];
+        outptr[i] = float32_to_bfloat16(activation_ss(v, activation_type, activation_params));
+    }
+}
@@ -1,6 +1,10 @@
 // Copyright 2024 Tencent
 // SPDX-License-Identifier: BSD-3-Clause
 
+#if NCNN_RUNTIME_CPU && NCNN_AMX && __AVX512F__ && !__AVX512VNNI__ && !__AMX_INT8__
+void gemm_transB_packed_tile_int8_amx(const Mat& AT_tile, const Mat& BT_tile, Mat& topT_tile, int i, int max_ii, int j, int max_jj, int k, int max_kk);
+#endif
+
 #if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
 void pack_A_tile_int8_avx512vnni(const Mat& A, Mat& AT, int i, int max_ii, int k, int max_kk);
 void transpose_pack_A_tile_int8_avx512vnni(const Mat& A, Mat& AT, int i, int max_ii, int k, int max_kk);
@@ -12469,8 +12473,99 @@ static void unpack_output_tile_int32_to_fp32(const Mat& topT, const Mat& C, Mat&
     }
 }
 
+#if __AMX_INT8__
+static void gemm_transB_packed_tile_int8_amx16x16(const signed char* pA, const signed char* pB, const int* pw_shift, int* outptr, int max_kk, int k)
+{
+    // pA = 16 rows of contiguous s8 k, transposed from the vnni packed A block and zero padded to whole 64 byte rows
+    // pB = vnni packed B block, max_kk / 4 rows of 16 x 4 u8 loaded as is
+    // tile 0 = C, tile 1 2 = 16 rows of 64 bytes, configured by the caller
+    const int nn4 = max_kk / 4;
+    const int A_hstep = (nn4 + 15) / 16 * 64;
+
+    _tile_zero(0);
+
+    int g = 0;
+    for (; g + 15 < nn4; g += 16)
+    {
+        _tile_loadd(1, pA + g * 4, A_hstep);
+        _tile_loadd(2, pB + g * 64, 64);
+        _tile_dpbsud(0, 1, 2);
+    }
+    if (g < nn4)
+    {
+        // k tail, the padded A is zero so copy the remaining B rows into a zero padded block instead of reading past B
+#ifdef _MSC_VER
+        __declspec(align(64))
+#else
+        __attribute__((aligned(64)))
+#endif
+        signed char tmpB[16 * 64];
+        memcpy(tmpB, pB + g * 64, (nn4 - g) * 64);
+        memset(tmpB + (nn4 - g) * 64, 0, (16 - (nn4 - g)) * 64);
+
+        _tile_loadd(1, pA + g * 4, A_hstep);
+        _tile_loadd(2, tmpB, 64);
+        _tile_dpbsud(0, 1, 2);
+    }
+
+    int tmp[256];
+    _tile_stored(0, tmp, 64);
+
+    // tmp = row-major C[ii][jj], remove the u8 shift of B
+    for (int r = 0; r < 16; r++)
+    {
+        __m512i _c = _mm512_loadu_si512((const __m512i*)(tmp + r * 16));
+        _mm512_storeu_si512((__m512i*)(tmp + r * 16), _mm512_sub_epi32(_c, _mm512_set1_epi32(pw_shift[r])));
+    }
+
+    // scatter C into the lane rotated order of the vnni kernel
+    // 0123 4567 89ab cdef  A0 / B0
+    // 2301 6745 ab89 efcd  A1
+    // 4567 0123 cdef 89ab  A2
+    // 6745 2301 efcd ab89  A3
+    // 1230 5674 9ab8 defc  B1
+    // 89ab cdef 0123 4567  B2
+    // 9ab8 defc 1230 5674  B3
+    const __m512i _a0 = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i _a1 = _mm512_shuffle_epi32(_a0, _MM_PERM_BADC);
+    const __m512i _a2 = _mm512_shuffle_i32x4(_a0, _a0, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m512i _a3 = _mm512_shuffle_epi32(_a2, _MM_PERM_BADC);
+    const __m512i _b0 = _a0;
+    const __m512i _b1 = _mm512_shuffle_epi32(_b0, _MM_PERM_ADCB);
+    const __m512i _b2 = _mm512_shuffle_i32x4(_b0, _b0, _MM_SHUFFLE(1, 0, 3, 2));
+    const __m512i _b3 = _mm512_shuffle_epi32(_b2, _MM_PERM_ADCB);
+
+    const __m512i _ra[4] = {_mm512_slli_epi32(_a0, 4), _mm512_slli_epi32(_a1, 4), _mm512_slli_epi32(_a2, 4), _mm512_slli_epi32(_a3, 4)};
+    const __m512i _rb[4] = {_b0, _b1, _b2, _b3};
+
+    // sum0 .. sumf = (A0,B0) (A0,B1) (A1,B0) (A1,B1) (A0,B2) (A0,B3) (A1,B2) (A1,B3)
+    //                (A2,B0) (A2,B1) (A3,B0) (A3,B1) (A2,B2) (A2,B3) (A3,B2) (A3,B3)
+    static const int sum_a[16] = {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 3, 3, 2, 2, 3, 3};
+    static const int sum_b[16] = {0, 1, 0, 1, 2, 3, 2, 3, 0, 1, 0, 1, 2, 3, 2, 3};
+
+    for (int q = 0; q < 16; q++)
+    {
+        __m512i _index = _mm512_add_epi32(_ra[sum_a[q]], _rb[sum_b[q]]);
+        __m512i _sum = _mm512_i32gather_epi32(_index, tmp, sizeof(int));
+        if (k != 0)
+        {
+            _sum = _mm512_add_epi32(_sum, _mm512_load_si512((const __m512i*)(outptr + q * 16)));
+        }
+        _mm512_store_si512((__m512i*)(outptr + q * 16), _sum);
+    }
+}
+#endif // __AMX_INT8__
+
 static void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile, Mat& topT_tile, int i, int max_ii, int j, int max_jj, int k, int max_kk)
 {
+#if NCNN_RUNTIME_CPU && NCNN_AMX && __AVX512F__ && !__AVX512VNNI__ && !__AMX_INT8__
+    if (ncnn::cpu_support_x86_amx_int8())
+    {
+        gemm_transB_packed_tile_int8_amx(AT_tile, BT_tile, topT_tile, i, max_ii, j, max_jj, k, max_kk);
+        return;
+    }
+#endif
+
 #if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
     if (ncnn::cpu_support_x86_avx512_vnni())
     {
@@ -12522,6 +12617,30 @@ static void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile,
 
     int* outptr = topT_tile;
 
+#if __AMX_INT8__
+    // amx takes over the 16x16 blocks when all of k comes in vnni groups of 4
+    // and the transposed A row tile fits the staging buffer
+    const bool use_amx = ncnn::cpu_support_x86_amx_int8() && max_ii >= 16 && max_jj >= 16 && max_kk >= 4 && max_kk % 4 == 0 && max_kk <= 1024;
+
+#ifdef _MSC_VER
+    __declspec(align(64))
+#else
+    __attribute__((aligned(64)))
+#endif
+    signed char AT_amx[16 * 1024];
+
+    if (use_amx)
+    {
+        // k tails are zero padded, so one fixed config serves every k tile
+        amx_tilecfg cfg;
+        amx_tilecfg_init(cfg);
+        amx_tilecfg_set(cfg, 0, 16, 64);
+        amx_tilecfg_set(cfg, 1, 16, 64);
+        amx_tilecfg_set(cfg, 2, 16, 64);
+        _tile_loadconfig(&cfg);
+    }
+#endif // __AMX_INT8__
+
     int ii = 0;
 #if __SSE2__
 #if __AVX2__
@@ -12530,10 +12649,43 @@ static void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile,
     {
         const signed char* pB = pBT;
 
+#if __AMX_INT8__
+        if (use_amx)
+        {
+            // transpose the 4-byte groups so that each row of A has contiguous k
+            const int nn4 = max_kk / 4;
+            const int nn4_padded = (nn4 + 15) / 16 * 16;
+            const int* p0 = (const int*)pAT;
+            int* pp = (int*)AT_amx;
+            for (int r = 0; r < 16; r++)
+            {
+                int g = 0;
+                for (; g < nn4; g++)
+                {
+                    pp[r * nn4_padded + g] = p0[g * 16 + r];
+                }
+                for (; g < nn4_padded; g++)
+                {
+                    pp[r * nn4_padded + g] = 0;
+                }
+            }
+        }
+#endif // __AMX_INT8__
+
         int jj = 0;
 #if defined(__x86_64__) || defined(_M_X64)
         for (; jj + 15 < max_jj; jj += 16)
         {
+#if __AMX_INT8__
+            if (use_amx)
+            {
+                gemm_transB_packed_tile_int8_amx16x16(AT_amx, pB, (const int*)(pAT + max_kk * 16), outptr, max_kk, k);
+                pB += max_kk * 16;
+                outptr += 256;
+                continue;
+            }
+#endif // __AMX_INT8__
+
             const signed char* pA = pAT;
 
             __m512i _sum0;
@@ -13146,6 +13298,12 @@ static void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile,
 #endif // __AVX512VNNI__
     }
 #endif // __AVX512F__
+#if __AMX_INT8__
+    if (use_amx)
+    {
+        _tile_release();
+    }
+#endif // __AMX_INT8__
     for (; ii + 7 < max_ii; ii += 8)
     {
         const signed char* pB = pBT;
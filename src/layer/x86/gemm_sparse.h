@@ -0,0 +1,411 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// sparse weight kernels shared by InnerProduct, Convolution 1x1 and Gemm with constant B
+//
+// the weight of M rows and K columns is cut into blocks of nr consecutive rows
+// a block keeps only the columns where any of its rows is nonzero, with the nr weights of each
+// weight_sparse_index = nr, the start of every block in the kept columns, block count + 1 entries, then the column indexes
+// weight_sparse_data = the nr weights of every kept column, rows past M are zero
+//
+// y = w x runs over the kept columns only, so the compute scales with the nonzero blocks
+
+// pack into the sparse layout if enough weight blocks are zero for the sparse kernel to win
+// nr is 4 for pruned blocks of 4 output rows, 1 for unstructured and 2:4 sparsity
+// return false and leave the outputs untouched otherwise
+static bool sparse_gemm_transform_kernel(const Mat& kernel, Mat& weight_sparse_data, Mat& weight_sparse_index, int M, int K)
+{
+    const float* kptr = kernel;
+
+    double nnz1 = 0;
+    double nnz4 = 0;
+    for (int i = 0; i < M; i += 4)
+    {
+        const int max_ii = std::min(M - i, 4);
+        for (int k = 0; k < K; k++)
+        {
+            int nz = 0;
+            for (int ii = 0; ii < max_ii; ii++)
+            {
+                nz += kptr[(i + ii) * K + k] != 0.f ? 1 : 0;
+            }
+            nnz1 += nz;
+            nnz4 += nz != 0 ? 1 : 0;
+        }
+    }
+
+    const double density1 = nnz1 / ((double)M * K);
+    const double density4 = nnz4 * 4 / ((double)((M + 3) / 4 * 4) * K);
+
+    // the relative cost against the dense kernel, a block of 4 rows shares the input loads
+    const double cost4 = density4 / 0.3;
+    const double cost1 = density1 / 0.2;
+    if (std::min(cost4, cost1) >= 1.0)
+        return false;
+
+    const int nr = cost4 <= cost1 ? 4 : 1;
+
+    const int nb = (M + nr - 1) / nr;
+    const int nnz = (int)(nr == 4 ? nnz4 : nnz1);
+
+    weight_sparse_index.create(2 + nb + nnz, 4u, (Allocator*)0);
+    weight_sparse_data.create(std::max(nnz * nr, 1), 4u, (Allocator*)0);
+    if (weight_sparse_index.empty() || weight_sparse_data.empty())
+        return false;
+
+    int* index = weight_sparse_index;
+    int* offsets = index + 1;
+    int* cols = index + 2 + nb;
+    float* wptr = weight_sparse_data;
+
+    index[0] = nr;
+
+    int n = 0;
+    for (int b = 0; b < nb; b++)
+    {
+        const int i = b * nr;
+        const int max_ii = std::min(M - i, nr);
+
+        offsets[b] = n;
+        for (int k = 0; k < K; k++)
+        {
+            bool nz = false;
+            for (int ii = 0; ii < max_ii; ii++)
+            {
+                nz = nz || kptr[(i + ii) * K + k] != 0.f;
+            }
+            if (!nz)
+                continue;
+
+            cols[n] = k;
+            for (int ii = 0; ii < nr; ii++)
+            {
+                wptr[n * nr + ii] = ii < max_ii ? kptr[(i + ii) * K + k] : 0.f;
+            }
+            n++;
+        }
+    }
+    offsets[nb] = n;
+
+    return true;
+}
+
+static void sparse_gemm_nr4(const float* wptr, const int* cols, int nnz, const float* bias, const float* X, size_t x_stride, float* Y, size_t y_stride, int max_ii, int j, int max_jj)
+{
+    float* outptr0 = Y;
+    float* outptr1 = Y + y_stride;
+    float* outptr2 = Y + y_stride * 2;
+    float* outptr3 = Y + y_stride * 3;
+
+    int jj = j;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; jj + 15 < j + max_jj; jj += 16)
+    {
+        __m512 _sum0 = _mm512_set1_ps(bias[0]);
+        __m512 _sum1 = _mm512_set1_ps(bias[1]);
+        __m512 _sum2 = _mm512_set1_ps(bias[2]);
+        __m512 _sum3 = _mm512_set1_ps(bias[3]);
+
+        const float* w = wptr;
+        for (int c = 0; c < nnz; c++)
+        {
+            __m512 _x = _mm512_loadu_ps(X + cols[c] * x_stride + jj);
+            _sum0 = _mm512_fmadd_ps(_mm512_set1_ps(w[0]), _x, _sum0);
+            _sum1 = _mm512_fmadd_ps(_mm512_set1_ps(w[1]), _x, _sum1);
+            _sum2 = _mm512_fmadd_ps(_mm512_set1_ps(w[2]), _x, _sum2);
+            _sum3 = _mm512_fmadd_ps(_mm512_set1_ps(w[3]), _x, _sum3);
+            w += 4;
+        }
+
+        _mm512_storeu_ps(outptr0 + jj, _sum0);
+        if (max_ii > 1) _mm512_storeu_ps(outptr1 + jj, _sum1);
+        if (max_ii > 2) _mm512_storeu_ps(outptr2 + jj, _sum2);
+        if (max_ii > 3) _mm512_storeu_ps(outptr3 + jj, _sum3);
+    }
+#endif // __AVX512F__
+    for (; jj + 7 < j + max_jj; jj += 8)
+    {
+        __m256 _sum0 = _mm256_set1_ps(bias[0]);
+        __m256 _sum1 = _mm256_set1_ps(bias[1]);
+        __m256 _sum2 = _mm256_set1_ps(bias[2]);
+        __m256 _sum3 = _mm256_set1_ps(bias[3]);
+
+        const float* w = wptr;
+        for (int c = 0; c < nnz; c++)
+        {
+            __m256 _x = _mm256_loadu_ps(X + cols[c] * x_stride + jj);
+            _sum0 = _mm256_comp_fmadd_ps(_mm256_set1_ps(w[0]), _x, _sum0);
+            _sum1 = _mm256_comp_fmadd_ps(_mm256_set1_ps(w[1]), _x, _sum1);
+            _sum2 = _mm256_comp_fmadd_ps(_mm256_set1_ps(w[2]), _x, _sum2);
+            _sum3 = _mm256_comp_fmadd_ps(_mm256_set1_ps(w[3]), _x, _sum3);
+            w += 4;
+        }
+
+        _mm256_storeu_ps(outptr0 + jj, _sum0);
+        if (max_ii > 1) _mm256_storeu_ps(outptr1 + jj, _sum1);
+        if (max_ii > 2) _mm256_storeu_ps(outptr2 + jj, _sum2);
+        if (max_ii > 3) _mm256_storeu_ps(outptr3 + jj, _sum3);
+    }
+#endif // __AVX__
+    for (; jj + 3 < j + max_jj; jj += 4)
+    {
+        __m128 _sum0 = _mm_set1_ps(bias[0]);
+        __m128 _sum1 = _mm_set1_ps(bias[1]);
+        __m128 _sum2 = _mm_set1_ps(bias[2]);
+        __m128 _sum3 = _mm_set1_ps(bias[3]);
+
+        const float* w = wptr;
+        for (int c = 0; c < nnz; c++)
+        {
+            __m128 _x = _mm_loadu_ps(X + cols[c] * x_stride + jj);
+            _sum0 = _mm_comp_fmadd_ps(_mm_set1_ps(w[0]), _x, _sum0);
+            _sum1 = _mm_comp_fmadd_ps(_mm_set1_ps(w[1]), _x, _sum1);
+            _sum2 = _mm_comp_fmadd_ps(_mm_set1_ps(w[2]), _x, _sum2);
+            _sum3 = _mm_comp_fmadd_ps(_mm_set1_ps(w[3]), _x, _sum3);
+            w += 4;
+        }
+
+        _mm_storeu_ps(outptr0 + jj, _sum0);
+        if (max_ii > 1) _mm_storeu_ps(outptr1 + jj, _sum1);
+        if (max_ii > 2) _mm_storeu_ps(outptr2 + jj, _sum2);
+        if (max_ii > 3) _mm_storeu_ps(outptr3 + jj, _sum3);
+    }
+#endif // __SSE2__
+    for (; jj < j + max_jj; jj++)
+    {
+        // the 4 rows of one column at once
+        float sum[4];
+#if __SSE2__
+        __m128 _sum = _mm_loadu_ps(bias);
+
+        const float* w = wptr;
+        int c = 0;
+#if __AVX__
+#if __AVX512F__
+        {
+            // 4 columns of 4 rows per step
+            const __m512i _idx = _mm512_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+
+            __m512 _sum16 = _mm512_setzero_ps();
+            for (; c + 3 < nnz; c += 4)
+            {
+                __m128 _x4 = _mm_setr_ps(X[cols[c] * x_stride + jj], X[cols[c + 1] * x_stride + jj], X[cols[c + 2] * x_stride + jj], X[cols[c + 3] * x_stride + jj]);
+                __m512 _x = _mm512_permutexvar_ps(_idx, _mm512_castps128_ps512(_x4));
+                _sum16 = _mm512_fmadd_ps(_mm512_loadu_ps(w), _x, _sum16);
+                w += 16;
+            }
+
+            __m256 _sum8 = _mm256_add_ps(_mm512_castps512_ps256(_sum16), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(_sum16), 1)));
+            _sum = _mm_add_ps(_sum, _mm_add_ps(_mm256_castps256_ps128(_sum8), _mm256_extractf128_ps(_sum8, 1)));
+        }
+#endif // __AVX512F__
+        {
+            // 2 columns of 4 rows per step
+            __m256 _sum8 = _mm256_setzero_ps();
+            for (; c + 1 < nnz; c += 2)
+            {
+                __m256 _x = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(X[cols[c] * x_stride + jj])), _mm_set1_ps(X[cols[c + 1] * x_stride + jj]), 1);
+                _sum8 = _mm256_comp_fmadd_ps(_mm256_loadu_ps(w), _x, _sum8);
+                w += 8;
+            }
+
+            _sum = _mm_add_ps(_sum, _mm_add_ps(_mm256_castps256_ps128(_sum8), _mm256_extractf128_ps(_sum8, 1)));
+        }
+#endif // __AVX__
+        for (; c < nnz; c++)
+        {
+            _sum = _mm_comp_fmadd_ps(_mm_loadu_ps(w), _mm_set1_ps(X[cols[c] * x_stride + jj]), _sum);
+            w += 4;
+        }
+
+        _mm_storeu_ps(sum, _sum);
+#else
+        sum[0] = bias[0];
+        sum[1] = bias[1];
+        sum[2] = bias[2];
+        sum[3] = bias[3];
+
+        const float* w = wptr;
+        for (int c = 0; c < nnz; c++)
+        {
+            const float x = X[cols[c] * x_stride + jj];
+            sum[0] += w[0] * x;
+            sum[1] += w[1] * x;
+            sum[2] += w[2] * x;
+            sum[3] += w[3] * x;
+            w += 4;
+        }
+#endif // __SSE2__
+
+        outptr0[jj] = sum[0];
+        if (max_ii > 1) outptr1[jj] = sum[1];
+        if (max_ii > 2) outptr2[jj] = sum[2];
+        if (max_ii > 3) outptr3[jj] = sum[3];
+    }
+}
+
+static void sparse_gemm_nr1(const float* wptr, const int* cols, int nnz, float bias, const float* X, size_t x_stride, float* Y, int j, int max_jj)
+{
+    int jj = j;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; jj + 31 < j + max_jj; jj += 32)
+    {
+        __m512 _sum0 = _mm512_set1_ps(bias);
+        __m512 _sum1 = _mm512_set1_ps(bias);
+
+        for (int c = 0; c < nnz; c++)
+        {
+            const float* xptr = X + cols[c] * x_stride + jj;
+            __m512 _w = _mm512_set1_ps(wptr[c]);
+            _sum0 = _mm512_fmadd_ps(_w, _mm512_loadu_ps(xptr), _sum0);
+            _sum1 = _mm512_fmadd_ps(_w, _mm512_loadu_ps(xptr + 16), _sum1);
+        }
+
+        _mm512_storeu_ps(Y + jj, _sum0);
+        _mm512_storeu_ps(Y + jj + 16, _sum1);
+    }
+    for (; jj + 15 < j + max_jj; jj += 16)
+    {
+        __m512 _sum = _mm512_set1_ps(bias);
+
+        for (int c = 0; c < nnz; c++)
+        {
+            _sum = _mm512_fmadd_ps(_mm512_set1_ps(wptr[c]), _mm512_loadu_ps(X + cols[c] * x_stride + jj), _sum);
+        }
+
+        _mm512_storeu_ps(Y + jj, _sum);
+    }
+#endif // __AVX512F__
+    for (; jj + 15 < j + max_jj; jj += 16)
+    {
+        __m256 _sum0 = _mm256_set1_ps(bias);
+        __m256 _sum1 = _mm256_set1_ps(bias);
+
+        for (int c = 0; c < nnz; c++)
+        {
+            const float* xptr = X + cols[c] * x_stride + jj;
+            __m256 _w = _mm256_set1_ps(wptr[c]);
+            _sum0 = _mm256_comp_fmadd_ps(_w, _mm256_loadu_ps(xptr), _sum0);
+            _sum1 = _mm256_comp_fmadd_ps(_w, _mm256_loadu_ps(xptr + 8), _sum1);
+        }
+
+        _mm256_storeu_ps(Y + jj, _sum0);
+        _mm256_storeu_ps(Y + jj + 8, _sum1);
+    }
+    for (; jj + 7 < j + max_jj; jj += 8)
+    {
+        __m256 _sum = _mm256_set1_ps(bias);
+
+        for (int c = 0; c < nnz; c++)
+        {
+            _sum = _mm256_comp_fmadd_ps(_mm256_set1_ps(wptr[c]), _mm256_loadu_ps(X + cols[c] * x_stride + jj), _sum);
+        }
+
+        _mm256_storeu_ps(Y + jj, _sum);
+    }
+#endif // __AVX__
+    for (; jj + 3 < j + max_jj; jj += 4)
+    {
+        __m128 _sum = _mm_set1_ps(bias);
+
+        for (int c = 0; c < nnz; c++)
+        {
+            _sum = _mm_comp_fmadd_ps(_mm_set1_ps(wptr[c]), _mm_loadu_ps(X + cols[c] * x_stride + jj), _sum);
+        }
+
+        _mm_storeu_ps(Y + jj, _sum);
+    }
+#endif // __SSE2__
+    for (; jj < j + max_jj; jj++)
+    {
+        float sum0 = bias;
+        float sum1 = 0.f;
+        float sum2 = 0.f;
+        float sum3 = 0.f;
+
+        int c = 0;
+        for (; c + 3 < nnz; c += 4)
+        {
+            sum0 += wptr[c] * X[cols[c] * x_stride + jj];
+            sum1 += wptr[c + 1] * X[cols[c + 1] * x_stride + jj];
+            sum2 += wptr[c + 2] * X[cols[c + 2] * x_stride + jj];
+            sum3 += wptr[c + 3] * X[cols[c + 3] * x_stride + jj];
+        }
+        for (; c < nnz; c++)
+        {
+            sum0 += wptr[c] * X[cols[c] * x_stride + jj];
+        }
+
+        Y[jj] = sum0 + sum1 + sum2 + sum3;
+    }
+}
+
+// Y = W X + bias
+// X has K rows of N, row k at X + k * x_stride
+// Y has M rows of N, row i at Y + i * y_stride
+static void sparse_gemm(const Mat& weight_sparse_data, const Mat& weight_sparse_index, const Mat& bias_data, const float* X, size_t x_stride, float* Y, size_t y_stride, int M, int N, int nT)
+{
+    const int* index = weight_sparse_index;
+    const int nr = index[0];
+    const int nb = (M + nr - 1) / nr;
+    const int* offsets = index + 1;
+    const int* cols = index + 2 + nb;
+    const float* weights = weight_sparse_data;
+    const float* bias = bias_data;
+
+    // tiles of columns keep the rows of x in use within cache
+    const int TILE_N = 256;
+    const int nn_N = (N + TILE_N - 1) / TILE_N;
+    const int nn = nb * nn_N;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int ppij = 0; ppij < nn; ppij++)
+    {
+        const int b = ppij / nn_N;
+        const int j = ppij % nn_N * TILE_N;
+
+        const int i = b * nr;
+        const int max_ii = std::min(M - i, nr);
+        const int max_jj = std::min(N - j, TILE_N);
+
+        const int nnz = offsets[b + 1] - offsets[b];
+        const float* wptr = weights + offsets[b] * nr;
+        const int* cptr = cols + offsets[b];
+
+        if (nr == 4)
+        {
+            float bias4[4] = {0.f, 0.f, 0.f, 0.f};
+            if (bias)
+            {
+                for (int ii = 0; ii < max_ii; ii++)
+                {
+                    bias4[ii] = bias[i + ii];
+                }
+            }
+
+            sparse_gemm_nr4(wptr, cptr, nnz, bias4, X, x_stride, Y + i * y_stride, y_stride, max_ii, j, max_jj);
+        }
+        else
+        {
+            sparse_gemm_nr1(wptr, cptr, nnz, bias ? bias[i] : 0.f, X, x_stride, Y + i * y_stride, j, max_jj);
+        }
+    }
+}
+
+// out of M rows of N from in of N rows of M
+static void sparse_gemm_transpose(const float* in, size_t in_stride, float* out, size_t out_stride, int M, int N, int nT)
+{
+    #pragma omp parallel for num_threads(nT)
+    for (int i = 0; i < M; i++)
+    {
+        float* outptr = out + i * out_stride;
+        for (int j = 0; j < N; j++)
+        {
+            outptr[j] = in[j * in_stride + i];
+        }
+    }
+}
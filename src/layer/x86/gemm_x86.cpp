@@ -17,6 +17,7 @@
 #include "x86_usability.h"
 
 #include "cpu.h"
+#include "profiler.h"
 
 namespace ncnn {
 
@@ -24,11 +25,20 @@ namespace ncnn {
 #include "gemm_int8.h"
 #endif
 
+#if NCNN_BF16
+#include "gemm_bf16s.h"
+#endif
+
+#include "gemm_sparse.h"
+
 Gemm_x86::Gemm_x86()
 {
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_BF16
+    support_bf16_storage = true;
+#endif
 
     nT = 0;
 }
@@ -6839,6 +6849,38 @@ static void get_optimal_tile_mnk(int M, int N, int K, int constant_TILE_M, int c
     }
 }
 
+static void unpack_fp16s_tiles(const Mat& tiles_fp16, Mat& tiles)
+{
+    // one row of fp16 storage weight tiles to fp32 for the packed kernels
+    // called inside the thread loop, so no nested openmp here
+    const unsigned short* ptr = tiles_fp16;
+    float* outptr = tiles;
+
+    const int size = tiles_fp16.w * tiles_fp16.h;
+
+    int i = 0;
+#if __F16C__
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        _mm512_storeu_ps(outptr, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)ptr)));
+        ptr += 16;
+        outptr += 16;
+    }
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
+    {
+        _mm256_storeu_ps(outptr, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr)));
+        ptr += 8;
+        outptr += 8;
+    }
+#endif // __F16C__
+    for (; i < size; i++)
+    {
+        *outptr++ = float16_to_float32(*ptr++);
+    }
+}
+
 static int gemm_x86(const Mat& A, const Mat& B, const Mat& C, Mat& top_blob, int broadcast_type_C, int transA, int transB, int output_transpose, int constant_TILE_M, int constant_TILE_N, int constant_TILE_K, int nT, const Option& opt)
 {
     const int M = transA ? A.w : (A.dims == 3 ? A.c : A.h) * A.elempack;
@@ -7015,6 +7057,14 @@ static int gemm_AT_x86(const Mat& AT, const Mat& B, const Mat& C, Mat& top_blob,
             return -100;
     }
 
+    Mat ATX;
+    if (AT.elemsize == 2u)
+    {
+        ATX.create(TILE_K * TILE_M, (K + TILE_K - 1) / TILE_K, nT, 4u, opt.workspace_allocator);
+        if (ATX.empty())
+            return -100;
+    }
+
     #pragma omp parallel for num_threads(nT)
     for (int ppi = 0; ppi < nn_M; ppi++)
     {
@@ -7026,6 +7076,14 @@ static int gemm_AT_x86(const Mat& AT, const Mat& B, const Mat& C, Mat& top_blob,
         if (K > TILE_K || broadcast_type_C == 3 || output_transpose)
             topT_tile = topT.channel(get_omp_thread_num());
 
+        Mat ATi = AT.channel(i / TILE_M);
+        if (AT.elemsize == 2u)
+        {
+            Mat ATi_fp32 = ATX.channel(get_omp_thread_num());
+            unpack_fp16s_tiles(ATi, ATi_fp32);
+            ATi = ATi_fp32;
+        }
+
         for (int j = 0; j < N; j += TILE_N)
         {
             const int max_jj = std::min((N - j), TILE_N);
@@ -7043,7 +7101,7 @@ static int gemm_AT_x86(const Mat& AT, const Mat& B, const Mat& C, Mat& top_blob,
 
                 // NCNN_LOGE("max_ii/jj/kk = %d %d %d", max_ii, max_jj, max_kk);
 
-                Mat AT_tile = AT.channel(i / TILE_M).row_range(k / TILE_K, 1);
+                Mat AT_tile = ATi.row_range(k / TILE_K, 1);
 
                 Mat BT_tile = BT.channel(j / TILE_N).row_range(k / TILE_K, 1);
 
@@ -7088,6 +7146,14 @@ static int gemm_BT_x86(const Mat& A, const Mat& BT, const Mat& C, Mat& top_blob,
             return -100;
     }
 
+    Mat BTX;
+    if (BT.elemsize == 2u)
+    {
+        BTX.create(TILE_K * TILE_N, (K + TILE_K - 1) / TILE_K, nT, 4u, opt.workspace_allocator);
+        if (BTX.empty())
+            return -100;
+    }
+
     #pragma omp parallel for num_threads(nT)
     for (int ppi = 0; ppi < nn_M; ppi++)
     {
@@ -7114,6 +7180,14 @@ static int gemm_BT_x86(const Mat& A, const Mat& BT, const Mat& C, Mat& top_blob,
 
             const Mat& CT_tile = broadcast_type_C == 3 ? topT_tile : C;
 
+            Mat BTj = BT.channel(j / TILE_N);
+            if (BT.elemsize == 2u)
+            {
+                Mat BTj_fp32 = BTX.channel(get_omp_thread_num());
+                unpack_fp16s_tiles(BTj, BTj_fp32);
+                BTj = BTj_fp32;
+            }
+
             for (int k = 0; k < K; k += TILE_K)
             {
                 const int max_kk = std::min((K - k), TILE_K);
@@ -7122,7 +7196,7 @@ static int gemm_BT_x86(const Mat& A, const Mat& BT, const Mat& C, Mat& top_blob,
 
                 Mat AT_tile = ATX.channel(get_omp_thread_num()).row_range(k / TILE_K, 1);
 
-                Mat BT_tile = BT.channel(j / TILE_N).row_range(k / TILE_K, 1);
+                Mat BT_tile = BTj.row_range(k / TILE_K, 1);
 
                 if (j == 0)
                 {
@@ -7171,6 +7245,22 @@ static int gemm_AT_BT_x86(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_b
             return -100;
     }
 
+    Mat ATX;
+    if (AT.elemsize == 2u)
+    {
+        ATX.create(TILE_K * TILE_M, (K + TILE_K - 1) / TILE_K, nT, 4u, opt.workspace_allocator);
+        if (ATX.empty())
+            return -100;
+    }
+
+    Mat BTX;
+    if (BT.elemsize == 2u)
+    {
+        BTX.create(TILE_K * TILE_N, (K + TILE_K - 1) / TILE_K, nT, 4u, opt.workspace_allocator);
+        if (BTX.empty())
+            return -100;
+    }
+
     #pragma omp parallel for num_threads(nT)
     for (int ppi = 0; ppi < nn_M; ppi++)
     {
@@ -7182,6 +7272,14 @@ static int gemm_AT_BT_x86(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_b
         if (K > TILE_K || broadcast_type_C == 3 || output_transpose)
             topT_tile = topT.channel(get_omp_thread_num());
 
+        Mat ATi = AT.channel(i / TILE_M);
+        if (AT.elemsize == 2u)
+        {
+            Mat ATi_fp32 = ATX.channel(get_omp_thread_num());
+            unpack_fp16s_tiles(ATi, ATi_fp32);
+            ATi = ATi_fp32;
+        }
+
         for (int j = 0; j < N; j += TILE_N)
         {
             const int max_jj = std::min((N - j), TILE_N);
@@ -7193,15 +7291,23 @@ static int gemm_AT_BT_x86(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_b
 
             const Mat& CT_tile = broadcast_type_C == 3 ? topT_tile : C;
 
+            Mat BTj = BT.channel(j / TILE_N);
+            if (BT.elemsize == 2u)
+            {
+                Mat BTj_fp32 = BTX.channel(get_omp_thread_num());
+                unpack_fp16s_tiles(BTj, BTj_fp32);
+                BTj = BTj_fp32;
+            }
+
             for (int k = 0; k < K; k += TILE_K)
             {
                 const int max_kk = std::min((K - k), TILE_K);
 
                 // NCNN_LOGE("max_ii/jj/kk = %d %d %d", max_ii, max_jj, max_kk);
 
-                Mat AT_tile = AT.channel(i / TILE_M).row_range(k / TILE_K, 1);
+                Mat AT_tile = ATi.row_range(k / TILE_K, 1);
 
-                Mat BT_tile = BT.channel(j / TILE_N).row_range(k / TILE_K, 1);
+                Mat BT_tile = BTj.row_range(k / TILE_K, 1);
 
                 bool k_end = !output_transpose && k + TILE_K >= K;
 
@@ -7223,10 +7329,76 @@ int Gemm_x86::create_pipeline(const Option& opt)
 #if NCNN_INT8
     if (int8_scale_term)
     {
+        support_bf16_storage = false;
         return create_pipeline_int8(opt);
     }
 #endif
 
+#if NCNN_BF16
+    if (support_bf16_storage && opt.use_bf16_storage)
+    {
+        return create_pipeline_bf16s(opt);
+    }
+#endif
+
+    if (opt.use_sparse_weight && constantB && !constantA)
+    {
+        // the sparse kernel takes B transposed as the weight of N rows and K columns
+        const size_t B_hstep = B_data.dims == 3 ? B_data.cstep : (size_t)B_data.w;
+
+        Mat BT;
+        if (transB)
+        {
+            BT = B_data.reshape(constantK, constantN);
+        }
+        else
+        {
+            BT.create(constantK, constantN, 4u, (Allocator*)0);
+            if (BT.empty())
+                return -100;
+
+            sparse_gemm_transpose(B_data, B_hstep, BT, constantK, constantN, constantK, opt.num_threads);
+        }
+        if (BT.empty())
+            return -100;
+
+        if (sparse_gemm_transform_kernel(BT, weight_sparse_data, weight_sparse_index, constantN, constantK))
+        {
+            // sparse kernels take unpacked blobs
+            support_packing = false;
+
+            if (constantC && constant_broadcast_type_C != -1)
+            {
+                CT_data = C_data;
+
+                // pre-multiply C with beta
+                if (beta != 1.f)
+                {
+                    Mat C2;
+                    C2.create_like(CT_data);
+
+                    const int size = CT_data.total();
+                    for (int i = 0; i < size; i++)
+                    {
+                        C2[i] = CT_data[i] * beta;
+                    }
+
+                    CT_data = C2;
+                }
+
+                if (opt.lightmode)
+                    C_data.release();
+            }
+
+            if (opt.lightmode)
+                B_data.release();
+
+            nT = opt.num_threads;
+
+            return 0;
+        }
+    }
+
     if (constantA)
     {
         const int M = constantM;
@@ -7313,6 +7485,32 @@ int Gemm_x86::create_pipeline(const Option& opt)
             B_data.release();
     }
 
+#if NCNN_F16C && __F16C__
+    if (cpu_support_x86_f16c() && opt.use_fp16_storage)
+    {
+        // keep the packed weight tiles in fp16, the kernels expand them per row of tiles
+        if (constantA)
+        {
+            Mat AT_data_fp16;
+            ncnn::cast_float32_to_float16(AT_data, AT_data_fp16, opt);
+            if (AT_data_fp16.empty())
+                return -100;
+
+            AT_data = AT_data_fp16;
+        }
+
+        if (constantB)
+        {
+            Mat BT_data_fp16;
+            ncnn::cast_float32_to_float16(BT_data, BT_data_fp16, opt);
+            if (BT_data_fp16.empty())
+                return -100;
+
+            BT_data = BT_data_fp16;
+        }
+    }
+#endif // NCNN_F16C && __F16C__
+
     if (constantC && constant_broadcast_type_C != -1)
     {
         CT_data = C_data;
@@ -7358,6 +7556,70 @@ int Gemm_x86::create_pipeline(const Option& opt)
     return 0;
 }
 
+int Gemm_x86::export_pipeline(std::vector<Mat>& pipeline_data) const
+{
+    pipeline_data.clear();
+    pipeline_data.push_back(AT_data);
+    pipeline_data.push_back(BT_data);
+    pipeline_data.push_back(CT_data);
+    pipeline_data.push_back(weight_sparse_data);
+    pipeline_data.push_back(weight_sparse_index);
+
+    return 0;
+}
+
+int Gemm_x86::import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt)
+{
+#if NCNN_BF16
+    // bf16 pipeline is not cached
+    if (support_bf16_storage && opt.use_bf16_storage)
+        return -1;
+#endif
+
+    if (pipeline_data.size() != 5)
+        return -1;
+
+    weight_sparse_data = pipeline_data[3];
+    weight_sparse_index = pipeline_data[4];
+
+    if (!weight_sparse_index.empty())
+    {
+        // sparse kernels take unpacked blobs
+        support_packing = false;
+    }
+
+    if (constantA)
+    {
+        AT_data = pipeline_data[0];
+
+        if (opt.lightmode)
+            A_data.release();
+    }
+
+    if (constantB)
+    {
+        BT_data = pipeline_data[1];
+
+        if (opt.lightmode)
+            B_data.release();
+    }
+
+    if (constantC && constant_broadcast_type_C != -1)
+    {
+        CT_data = pipeline_data[2];
+
+        if (opt.lightmode)
+            C_data.release();
+    }
+
+    if (constantA || constantB || constantC)
+    {
+        nT = opt.num_threads;
+    }
+
+    return 0;
+}
+
 int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
 #if NCNN_INT8
@@ -7368,6 +7630,13 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     }
 #endif
 
+#if NCNN_BF16
+    if (support_bf16_storage && opt.use_bf16_storage)
+    {
+        return forward_bf16s(bottom_blobs, top_blobs, opt);
+    }
+#endif
+
     int M;
     int N;
     if (constantA && constantB)
@@ -7472,6 +7741,11 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
         }
     }
 
+    if (!weight_sparse_index.empty())
+    {
+        return forward_sparse(bottom_blobs, top_blobs[0], C, broadcast_type_C, opt);
+    }
+
     int out_elempack = 1;
 #if __SSE2__
     if (opt.use_packing_layout)
@@ -7555,6 +7829,121 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     return 0;
 }
 
+int Gemm_x86::forward_sparse(const std::vector<Mat>& bottom_blobs, Mat& top_blob, const Mat& C, int broadcast_type_C, const Option& opt) const
+{
+    const Mat& A = bottom_blobs[0];
+
+    const int M = transA ? A.w : (A.dims == 3 ? A.c : A.h);
+    const int N = constantN;
+    const int K = constantK;
+
+    const size_t A_hstep = A.dims == 3 ? A.cstep : (size_t)A.w;
+
+    Mat top_blob_unpacked = top_blob;
+    if (output_transpose)
+    {
+        if (output_N1M)
+            top_blob_unpacked.create(M, 1, N, 4u, opt.blob_allocator);
+        else
+            top_blob_unpacked.create(M, N, 4u, opt.blob_allocator);
+    }
+    else
+    {
+        if (output_N1M)
+            top_blob_unpacked.create(N, 1, M, 4u, opt.blob_allocator);
+        else
+            top_blob_unpacked.create(N, M, 4u, opt.blob_allocator);
+    }
+    if (top_blob_unpacked.empty())
+        return -100;
+
+    const size_t out_hstep = top_blob_unpacked.dims == 3 ? top_blob_unpacked.cstep : (size_t)top_blob_unpacked.w;
+
+    profiler_set_kernel("sparse");
+
+    // the kernel computes the transposed output of N rows from the transposed A of K rows
+    Mat AT;
+    size_t AT_hstep = A_hstep;
+    if (transA)
+    {
+        AT = A;
+    }
+    else
+    {
+        AT.create(M, K, 4u, opt.workspace_allocator);
+        if (AT.empty())
+            return -100;
+
+        sparse_gemm_transpose(A, A_hstep, AT, M, K, M, opt.num_threads);
+        AT_hstep = M;
+    }
+
+    Mat topT;
+    size_t topT_hstep = out_hstep;
+    if (output_transpose)
+    {
+        topT = top_blob_unpacked;
+    }
+    else
+    {
+        topT.create(M, N, 4u, opt.workspace_allocator);
+        if (topT.empty())
+            return -100;
+
+        topT_hstep = M;
+    }
+
+    sparse_gemm(weight_sparse_data, weight_sparse_index, Mat(), AT, AT_hstep, topT, topT_hstep, N, M, opt.num_threads);
+
+    if (!output_transpose)
+    {
+        sparse_gemm_transpose(topT, M, top_blob_unpacked, out_hstep, M, N, opt.num_threads);
+    }
+
+    // add C and multiply with alpha
+    if (!C.empty() || alpha != 1.f)
+    {
+        const size_t C_hstep = C.dims == 3 ? C.cstep : (size_t)C.w;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < M; i++)
+        {
+            for (int j = 0; j < N; j++)
+            {
+                float* outptr = output_transpose ? (float*)top_blob_unpacked + j * out_hstep + i : (float*)top_blob_unpacked + i * out_hstep + j;
+
+                float c = 0.f;
+                if (!C.empty())
+                {
+                    if (broadcast_type_C == 0)
+                        c = C[0];
+                    if (broadcast_type_C == 1 || broadcast_type_C == 2)
+                        c = C[i];
+                    if (broadcast_type_C == 3)
+                        c = ((const float*)C)[i * C_hstep + j];
+                    if (broadcast_type_C == 4)
+                        c = C[j];
+                }
+
+                outptr[0] = (outptr[0] + c) * alpha;
+            }
+        }
+    }
+
+    if (output_elempack > 1)
+    {
+        convert_packing(top_blob_unpacked, top_blob, output_elempack, opt);
+        if (top_blob.empty())
+            return -100;
+    }
+    else
+    {
+        top_blob = top_blob_unpacked;
+    }
+
+    return 0;
+}
+
 #if NCNN_INT8
 static void compute_A_tile_int8_scales(const Mat& A, Mat& scales, float B_scale, Mat& out_descales, int i, int max_ii)
 {
@@ -8359,6 +8748,280 @@ int Gemm_x86::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat
 }
 #endif
 
+#if NCNN_BF16
+int Gemm_x86::create_pipeline_bf16s(const Option& opt)
+{
+    // bf16 kernels take unpacked blobs
+    support_packing = false;
+
+    // out = A * B
+    // the rows of the operand which spans the output width are packed as AT
+    // the rows of the other operand are packed as BT and broadcast in the kernel
+    if (constantA)
+    {
+        const int M = constantM;
+        const int K = constantK;
+
+        Mat A_data_bf16;
+        cast_float32_to_bfloat16(A_data, A_data_bf16);
+        if (A_data_bf16.empty())
+            return -100;
+
+        AT_data.create((K + 1) / 2 * 2, M, 2u, (Allocator*)0);
+        if (AT_data.empty())
+            return -100;
+
+        if (output_transpose)
+            pack_A_bf16s(A_data_bf16, AT_data, M, K, transA, opt.num_threads);
+        else
+            pack_B_bf16s(A_data_bf16, AT_data, M, K, transA, opt.num_threads);
+
+        if (opt.lightmode)
+            A_data.release();
+    }
+
+    if (constantB)
+    {
+        const int N = constantN;
+        const int K = constantK;
+
+        Mat B_data_bf16;
+        cast_float32_to_bfloat16(B_data, B_data_bf16);
+        if (B_data_bf16.empty())
+            return -100;
+
+        BT_data.create((K + 1) / 2 * 2, N, 2u, (Allocator*)0);
+        if (BT_data.empty())
+            return -100;
+
+        if (output_transpose)
+            pack_B_bf16s(B_data_bf16, BT_data, N, K, transB ? 0 : 1, opt.num_threads);
+        else
+            pack_A_bf16s(B_data_bf16, BT_data, N, K, transB ? 0 : 1, opt.num_threads);
+
+        if (opt.lightmode)
+            B_data.release();
+    }
+
+    if (constantC && constant_broadcast_type_C != -1)
+    {
+        CT_data = C_data;
+
+        // pre-multiply C with beta
+        if (beta != 1.f)
+        {
+            Mat C2;
+            C2.create_like(CT_data);
+
+            const int size = CT_data.total();
+            for (int i = 0; i < size; i++)
+            {
+                C2[i] = CT_data[i] * beta;
+            }
+
+            CT_data = C2;
+        }
+
+        if (opt.lightmode)
+            C_data.release();
+    }
+
+    if (constantA || constantB || constantC)
+    {
+        nT = opt.num_threads;
+    }
+
+    return 0;
+}
+
+int Gemm_x86::forward_bf16s(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    // A and B in unpacked bf16, C in unpacked fp32
+    size_t input_index = 0;
+    Mat A;
+    Mat B;
+    Mat C;
+    if (!constantA)
+    {
+        convert_packing(bottom_blobs[input_index++], A, 1, opt_ws);
+        if (A.elembits() == 32)
+        {
+            Mat A_bf16;
+            cast_float32_to_bfloat16(A, A_bf16, opt_ws);
+            A = A_bf16;
+        }
+        if (A.empty())
+            return -100;
+    }
+    if (!constantB)
+    {
+        convert_packing(bottom_blobs[input_index++], B, 1, opt_ws);
+        if (B.elembits() == 32)
+        {
+            Mat B_bf16;
+            cast_float32_to_bfloat16(B, B_bf16, opt_ws);
+            B = B_bf16;
+        }
+        if (B.empty())
+            return -100;
+    }
+    if (constantC)
+    {
+        C = CT_data;
+    }
+    else if (bottom_blobs.size() > input_index)
+    {
+        convert_packing(bottom_blobs[input_index], C, 1, opt_ws);
+        if (C.elembits() == 16)
+        {
+            Mat C_fp32;
+            cast_bfloat16_to_float32(C, C_fp32, opt_ws);
+            C = C_fp32;
+        }
+        if (C.empty())
+            return -100;
+    }
+
+    const int M = constantA ? constantM : transA ? A.w : (A.dims == 3 ? A.c : A.h);
+    const int K = constantA ? constantK : transA ? (A.dims == 3 ? A.c : A.h) : A.w;
+    const int N = constantB ? constantN : transB ? (B.dims == 3 ? B.c : B.h) : B.w;
+
+    int broadcast_type_C = 0;
+    if (constantC)
+    {
+        broadcast_type_C = constant_broadcast_type_C;
+    }
+    else if (!C.empty())
+    {
+        if (C.dims == 1 && C.w == 1)
+        {
+            // scalar
+            broadcast_type_C = 0;
+        }
+        if (C.dims == 1 && C.w == M)
+        {
+            // M
+            // auto broadcast from h to w is the ncnn-style convention
+            broadcast_type_C = 1;
+        }
+        if (C.dims == 1 && C.w == N)
+        {
+            // N
+            broadcast_type_C = 4;
+        }
+        if (C.dims == 2 && C.w == 1 && C.h == M)
+        {
+            // Mx1
+            broadcast_type_C = 2;
+        }
+        if (C.dims == 2 && C.w == N && C.h == M)
+        {
+            // MxN
+            broadcast_type_C = 3;
+        }
+        if (C.dims == 2 && C.w == N && C.h == 1)
+        {
+            // 1xN
+            broadcast_type_C = 4;
+        }
+    }
+
+    // constant C has been pre-multiplied with beta
+    const float beta_C = constantC ? 1.f : beta;
+
+    Mat AT = AT_data;
+    if (!constantA)
+    {
+        AT.create((K + 1) / 2 * 2, M, 2u, opt.workspace_allocator);
+        if (AT.empty())
+            return -100;
+
+        if (output_transpose)
+            pack_A_bf16s(A, AT, M, K, transA, opt.num_threads);
+        else
+            pack_B_bf16s(A, AT, M, K, transA, opt.num_threads);
+    }
+
+    Mat BT = BT_data;
+    if (!constantB)
+    {
+        BT.create((K + 1) / 2 * 2, N, 2u, opt.workspace_allocator);
+        if (BT.empty())
+            return -100;
+
+        if (output_transpose)
+            pack_B_bf16s(B, BT, N, K, transB ? 0 : 1, opt.num_threads);
+        else
+            pack_A_bf16s(B, BT, N, K, transB ? 0 : 1, opt.num_threads);
+    }
+
+    const int outw = output_transpose ? M : N;
+    const int outh = output_transpose ? N : M;
+
+    Mat topT(outw, outh, 4u, opt.workspace_allocator);
+    if (topT.empty())
+        return -100;
+
+    if (output_transpose)
+        gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, opt.num_threads);
+    else
+        gemm_transB_packed_bf16s(BT, AT, topT, N, M, K, opt.num_threads);
+
+    // output_elemtype 1 asks for fp32 output, bf16 follows the input otherwise
+    const size_t out_elemsize = output_elemtype == 1 ? 4u : 2u;
+
+    Mat& top_blob = top_blobs[0];
+    if (output_N1M)
+        top_blob.create(outw, 1, outh, out_elemsize, opt.blob_allocator);
+    else
+        top_blob.create(outw, outh, out_elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const size_t out_hstep = top_blob.dims == 3 ? top_blob.cstep : (size_t)top_blob.w;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = 0; r < outh; r++)
+    {
+        const float* ptr = topT.row(r);
+        float* outptr_fp32 = (float*)top_blob.data + r * out_hstep;
+        unsigned short* outptr = (unsigned short*)top_blob.data + r * out_hstep;
+
+        for (int c = 0; c < outw; c++)
+        {
+            const int i = output_transpose ? c : r;
+            const int j = output_transpose ? r : c;
+
+            float sum = ptr[c];
+            if (!C.empty())
+            {
+                float v = 0.f;
+                if (broadcast_type_C == 0)
+                    v = C[0];
+                if (broadcast_type_C == 1 || broadcast_type_C == 2)
+                    v = C[i];
+                if (broadcast_type_C == 3)
+                    v = C[i * N + j];
+                if (broadcast_type_C == 4)
+                    v = C[j];
+
+                sum += v * beta_C;
+            }
+
+            if (out_elemsize == 4u)
+                outptr_fp32[c] = sum * alpha;
+            else
+                outptr[c] = float32_to_bfloat16(sum * alpha);
+        }
+    }
+
+    return 0;
+}
+#endif // NCNN_BF16
+
 namespace Gemm_x86_utility {
 #if NCNN_INT8
 void pack_A_tile_int8(const Mat& A, Mat& AT, int i, int max_ii, int k, int max_kk)
@@ -8371,6 +9034,22 @@ void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile, Mat& t
     ncnn::gemm_transB_packed_tile_int8(AT_tile, BT_tile, topT_tile, i, max_ii, j, max_jj, k, max_kk);
 }
 #endif
+#if NCNN_BF16
+void pack_A_bf16s(const Mat& A, Mat& AT, int M, int K, int k_major, int nT)
+{
+    ncnn::pack_A_bf16s(A, AT, M, K, k_major, nT);
+}
+
+void pack_B_bf16s(const Mat& B, Mat& BT, int N, int K, int k_major, int nT)
+{
+    ncnn::pack_B_bf16s(B, BT, N, K, k_major, nT);
+}
+
+void gemm_transB_packed_bf16s(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT)
+{
+    ncnn::gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+}
+#endif
 } // namespace Gemm_x86_utility
 
 } // namespace ncnn
@@ -15,19 +15,31 @@ public:
 
     virtual int create_pipeline(const Option& opt);
 
+    virtual int export_pipeline(std::vector<Mat>& pipeline_data) const;
+    virtual int import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt);
+
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
 protected:
+    int forward_sparse(const std::vector<Mat>& bottom_blobs, Mat& top_blob, const Mat& C, int broadcast_type_C, const Option& opt) const;
 #if NCNN_INT8
     int create_pipeline_int8(const Option& opt);
     int forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 #endif
+#if NCNN_BF16
+    int create_pipeline_bf16s(const Option& opt);
+    int forward_bf16s(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+#endif
 
 public:
     int nT;
     Mat AT_data;
     Mat BT_data;
     Mat CT_data;
+
+    // sparse weight blocks of constant B, transposed
+    Mat weight_sparse_data;
+    Mat weight_sparse_index;
 };
 
 // expose some gemm internal routines for convolution uses
@@ -36,6 +48,11 @@ namespace Gemm_x86_utility {
 void pack_A_tile_int8(const Mat& A, Mat& AT, int i, int max_ii, int k, int max_kk);
 void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile, Mat& topT_tile, int i, int max_ii, int j, int max_jj, int k, int max_kk);
 #endif
+#if NCNN_BF16
+void pack_A_bf16s(const Mat& A, Mat& AT, int M, int K, int k_major, int nT);
+void pack_B_bf16s(const Mat& B, Mat& BT, int N, int K, int k_major, int nT);
+void gemm_transB_packed_bf16s(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT);
+#endif
 } // namespace Gemm_x86_utility
 
 } // namespace ncnn
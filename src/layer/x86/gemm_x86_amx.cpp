@@ -0,0 +1,34 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "mat.h"
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "gemm_int8.h"
+#include "gemm_bf16s.h"
+
+void gemm_transB_packed_tile_int8_amx(const Mat& AT_tile, const Mat& BT_tile, Mat& topT_tile, int i, int max_ii, int j, int max_jj, int k, int max_kk)
+{
+    gemm_transB_packed_tile_int8(AT_tile, BT_tile, topT_tile, i, max_ii, j, max_jj, k, max_kk);
+}
+
+void gemm_transB_packed_bf16s_amx(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT)
+{
+    gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+}
+
+} // namespace ncnn
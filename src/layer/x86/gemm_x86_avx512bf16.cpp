@@ -0,0 +1,23 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "mat.h"
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "gemm_bf16s.h"
+
+void gemm_transB_packed_bf16s_avx512bf16(const Mat& AT, const Mat& BT, Mat& topT, int M, int N, int K, int nT)
+{
+    gemm_transB_packed_bf16s(AT, BT, topT, M, N, K, nT);
+}
+
+} // namespace ncnn
@@ -0,0 +1,664 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+void gru_int8_avx512vnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+void gru_transform_weight_int8_avxvnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_data_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+void gru_int8_avxvnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+void gru_transform_weight_int8_avx2(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_data_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+void gru_int8_avx2(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_XOP && __SSE2__ && !__XOP__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+void gru_int8_xop(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+static inline int gru_int8_weight_row(int q)
+{
+    // units are packed in groups of 16 / 8 / 4 / 1, q is the first unit of a group
+#if __AVX512F__
+    return q / 16 + (q % 16) / 8 + (q % 8) / 4 + q % 4;
+#elif __AVX2__
+    return q / 8 + (q % 8) / 4 + q % 4;
+#elif __SSE2__
+    return q / 4 + q % 4;
+#else
+    return q;
+#endif
+}
+
+static void gru_transform_weight_int8_group(const Mat& weight_xc, const float* weight_xc_int8_scales, const Mat& weight_hc, const float* weight_hc_int8_scales, const Mat& bias_c, int q, int n, int size, int num_output, signed char* kptr, float* descales_ptr, float* bias_c_RUBNWN)
+{
+    // gate R U N of n units interleaved, two adjacent k per unit for madd on sign extended int16
+    for (int i = 0; i < size; i += 2)
+    {
+        for (int g = 0; g < 3; g++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                const signed char* weight_xc_ptr = weight_xc.row<const signed char>(num_output * g + q + j);
+
+                kptr[0] = weight_xc_ptr[i];
+                kptr[1] = i + 1 < size ? weight_xc_ptr[i + 1] : 0;
+                kptr += 2;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_output; i += 2)
+    {
+        for (int g = 0; g < 3; g++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                const signed char* weight_hc_ptr = weight_hc.row<const signed char>(num_output * g + q + j);
+
+                kptr[0] = weight_hc_ptr[i];
+                kptr[1] = i + 1 < num_output ? weight_hc_ptr[i + 1] : 0;
+                kptr += 2;
+            }
+        }
+    }
+
+    for (int g = 0; g < 3; g++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            descales_ptr[n * g + j] = 1.f / weight_xc_int8_scales[num_output * g + q + j];
+            descales_ptr[n * (3 + g) + j] = 1.f / weight_hc_int8_scales[num_output * g + q + j];
+        }
+    }
+
+    // R U WN BN
+    for (int g = 0; g < 4; g++)
+    {
+        const float* bias_c_ptr = bias_c.row(g);
+
+        for (int j = 0; j < n; j++)
+        {
+            bias_c_RUBNWN[n * g + j] = bias_c_ptr[q + j];
+        }
+    }
+}
+
+static void gru_transform_weight_int8(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_data_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        gru_transform_weight_int8_avxvnni(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_data_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        gru_transform_weight_int8_avx2(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_data_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+    const int size2 = (size + 1) / 2 * 2;
+    const int num_output2 = (num_output + 1) / 2 * 2;
+
+#if __AVX512F__
+    const int elempack = 16;
+#elif __AVX2__
+    const int elempack = 8;
+#elif __SSE2__
+    const int elempack = 4;
+#else
+    const int elempack = 1;
+#endif
+
+    const int rows = gru_int8_weight_row(num_output);
+
+    weight_data_tm.create(3 * (size2 + num_output2), rows, num_directions, (size_t)elempack, elempack);
+    weight_data_tm_int8_descales.create(6 * elempack, rows, num_directions);
+    bias_c_tm.create(num_output * 4, 1, num_directions);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const Mat weight_xc_dr = weight_xc.channel(dr);
+        const Mat weight_hc_dr = weight_hc.channel(dr);
+        const Mat bias_c_dr = bias_c.channel(dr);
+        const float* weight_xc_int8_scales_ptr = weight_xc_int8_scales.row(dr);
+        const float* weight_hc_int8_scales_ptr = weight_hc_int8_scales.row(dr);
+
+        Mat weight_data_tm_dr = weight_data_tm.channel(dr);
+        Mat weight_data_tm_int8_descales_dr = weight_data_tm_int8_descales.channel(dr);
+        float* bias_c_RUBNWN = bias_c_tm.channel(dr);
+
+        int q = 0;
+#if __AVX512F__
+        for (; q + 15 < num_output; q += 16)
+        {
+            const int row = gru_int8_weight_row(q);
+            gru_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 16, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+#endif // __AVX512F__
+#if __AVX2__
+        for (; q + 7 < num_output; q += 8)
+        {
+            const int row = gru_int8_weight_row(q);
+            gru_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 8, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+#endif // __AVX2__
+#if __SSE2__
+        for (; q + 3 < num_output; q += 4)
+        {
+            const int row = gru_int8_weight_row(q);
+            gru_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 4, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+#endif // __SSE2__
+        for (; q < num_output; q++)
+        {
+            const int row = gru_int8_weight_row(q);
+            gru_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 1, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+    }
+}
+
+static float gru_dynamic_quantize_get_absmax(const float* ptr, int size)
+{
+    float absmax = 0.f;
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _absmax_avx512 = _mm512_set1_ps(0.f);
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_loadu_ps(ptr);
+        _absmax_avx512 = _mm512_max_ps(_absmax_avx512, abs512_ps(_p));
+        ptr += 16;
+    }
+    absmax = std::max(absmax, _mm512_comp_reduce_max_ps(_absmax_avx512));
+#endif // __AVX512F__
+    __m256 _absmax_avx = _mm256_set1_ps(0.f);
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_loadu_ps(ptr);
+        _absmax_avx = _mm256_max_ps(_absmax_avx, abs256_ps(_p));
+        ptr += 8;
+    }
+    absmax = std::max(absmax, _mm256_reduce_max_ps(_absmax_avx));
+#endif // __AVX__
+    __m128 _absmax = _mm_set1_ps(0.f);
+    for (; i + 3 < size; i += 4)
+    {
+        __m128 _p = _mm_loadu_ps(ptr);
+        _absmax = _mm_max_ps(_absmax, abs_ps(_p));
+        ptr += 4;
+    }
+    absmax = std::max(absmax, _mm_reduce_max_ps(_absmax));
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        absmax = std::max(absmax, (float)fabs(*ptr));
+        ptr++;
+    }
+
+    return absmax;
+}
+
+static void gru_dynamic_quantize_scale2int8(const float* ptr, int size, float scale, signed char* outptr)
+{
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _scale_avx512 = _mm512_set1_ps(scale);
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_loadu_ps(ptr);
+        _p = _mm512_mul_ps(_p, _scale_avx512);
+        _mm_storeu_si128((__m128i*)outptr, float2int8_avx512(_p));
+        ptr += 16;
+        outptr += 16;
+    }
+#endif // __AVX512F__
+    __m256 _scale_avx = _mm256_set1_ps(scale);
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_loadu_ps(ptr);
+        _p = _mm256_mul_ps(_p, _scale_avx);
+        *(int64_t*)outptr = float2int8_avx(_p);
+        ptr += 8;
+        outptr += 8;
+    }
+#endif // __AVX__
+    __m128 _scale = _mm_set1_ps(scale);
+    for (; i + 3 < size; i += 4)
+    {
+        __m128 _p = _mm_loadu_ps(ptr);
+        _p = _mm_mul_ps(_p, _scale);
+        *(int32_t*)outptr = float2int8_sse(_p);
+        ptr += 4;
+        outptr += 4;
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        *outptr++ = float2int8(*ptr++ * scale);
+    }
+}
+
+static void gru_int8_widen(const signed char* ptr, int size, short* outptr)
+{
+    int i = 0;
+#if __SSE2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m128i _p = _mm_loadl_epi64((const __m128i*)ptr);
+#if __SSE4_1__
+        _p = _mm_cvtepi8_epi16(_p);
+#else
+        _p = _mm_unpacklo_epi8(_p, _mm_cmpgt_epi8(_mm_setzero_si128(), _p));
+#endif
+        _mm_storeu_si128((__m128i*)outptr, _p);
+        ptr += 8;
+        outptr += 8;
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        *outptr++ = *ptr++;
+    }
+
+    // zero the odd tail of the last k pair
+    if (size % 2 == 1)
+        *outptr = 0;
+}
+
+static void gru_int8(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        gru_int8_avx512vnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        gru_int8_avxvnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        gru_int8_avx2(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_XOP && __SSE2__ && !__XOP__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_xop())
+    {
+        gru_int8_xop(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+    int size = bottom_blob_int8.w;
+    int T = bottom_blob_int8.h;
+
+    int num_output = top_blob.w;
+
+    const int size2 = (size + 1) / 2 * 2;
+    const int num_output2 = (num_output + 1) / 2 * 2;
+
+    // x_t and quantized h_{t-1} sign extended to int16
+    Mat xh_int16(size2 + num_output2, (size_t)2u, 1, opt.workspace_allocator);
+
+    Mat hidden_state_int8(num_output, (size_t)1u, 1, opt.workspace_allocator);
+
+    // unroll
+    for (int t = 0; t < T; t++)
+    {
+        int ti = reverse ? T - 1 - t : t;
+
+        // dynamic quantize hidden_state
+        float descale_h = 1.f;
+        {
+            const float absmax = gru_dynamic_quantize_get_absmax(hidden_state, num_output);
+
+            if (absmax == 0.f)
+            {
+                hidden_state_int8.fill<signed char>(0);
+            }
+            else
+            {
+                descale_h = absmax / 127.f;
+                gru_dynamic_quantize_scale2int8(hidden_state, num_output, 127.f / absmax, hidden_state_int8);
+            }
+        }
+
+        short* x16 = xh_int16;
+        short* h16 = x16 + size2;
+        gru_int8_widen(bottom_blob_int8.row<const signed char>(ti), size, x16);
+        gru_int8_widen(hidden_state_int8, num_output, h16);
+
+        const int* xx = (const int*)x16;
+        const int* hh = (const int*)h16;
+
+        const float descale_x = bottom_blob_int8_descales[ti];
+
+        float* hidden_ptr = hidden_state;
+        float* output_data = top_blob.row(ti);
+
+        // every unit only reads the quantized hidden state
+        // so h_t can be written in place
+        int remain_num_output_start = 0;
+#if __SSE2__
+#if __AVX2__
+#if __AVX512F__
+        int nn_num_output = num_output >> 4;
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = qq * 16;
+
+            const signed char* kptr = weight_data_tm.row<const signed char>(gru_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(gru_int8_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            __m512i _Rx = _mm512_setzero_si512();
+            __m512i _Ux = _mm512_setzero_si512();
+            __m512i _Nx = _mm512_setzero_si512();
+            for (int i = 0; i < size2 / 2; i++)
+            {
+                __m512i _xi = _mm512_set1_epi32(xx[i]);
+                __m512i _w0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+                __m512i _w1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 32)));
+                __m512i _w2 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 64)));
+                _Rx = _mm512_comp_dpwssd_epi32(_Rx, _w0, _xi);
+                _Ux = _mm512_comp_dpwssd_epi32(_Ux, _w1, _xi);
+                _Nx = _mm512_comp_dpwssd_epi32(_Nx, _w2, _xi);
+
+                kptr += 96;
+            }
+
+            __m512i _Rh = _mm512_setzero_si512();
+            __m512i _Uh = _mm512_setzero_si512();
+            __m512i _Nh = _mm512_setzero_si512();
+            for (int i = 0; i < num_output2 / 2; i++)
+            {
+                __m512i _h_cont = _mm512_set1_epi32(hh[i]);
+                __m512i _w0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+                __m512i _w1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 32)));
+                __m512i _w2 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 64)));
+                _Rh = _mm512_comp_dpwssd_epi32(_Rh, _w0, _h_cont);
+                _Uh = _mm512_comp_dpwssd_epi32(_Uh, _w1, _h_cont);
+                _Nh = _mm512_comp_dpwssd_epi32(_Nh, _w2, _h_cont);
+
+                kptr += 96;
+            }
+
+            __m512 _descale_x = _mm512_set1_ps(descale_x);
+            __m512 _descale_h = _mm512_set1_ps(descale_h);
+
+            __m512 _R = _mm512_loadu_ps(bias_c_RUBNWN);
+            __m512 _U = _mm512_loadu_ps(bias_c_RUBNWN + 16);
+            _R = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Rx), _mm512_mul_ps(_descale_x, _mm512_loadu_ps(descales_ptr)), _R);
+            _U = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Ux), _mm512_mul_ps(_descale_x, _mm512_loadu_ps(descales_ptr + 16)), _U);
+            _R = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Rh), _mm512_mul_ps(_descale_h, _mm512_loadu_ps(descales_ptr + 48)), _R);
+            _U = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Uh), _mm512_mul_ps(_descale_h, _mm512_loadu_ps(descales_ptr + 64)), _U);
+
+            // sigmoid(R)
+            // sigmoid(U)
+            _R = sigmoid_avx512(_R);
+            _U = sigmoid_avx512(_U);
+
+            // gate new
+            __m512 _N = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Nh), _mm512_mul_ps(_descale_h, _mm512_loadu_ps(descales_ptr + 80)), _mm512_loadu_ps(bias_c_RUBNWN + 48));
+            _N = _mm512_fmadd_ps(_R, _N, _mm512_loadu_ps(bias_c_RUBNWN + 32));
+            _N = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Nx), _mm512_mul_ps(_descale_x, _mm512_loadu_ps(descales_ptr + 32)), _N);
+
+            // tanh(N)
+            _N = tanh_avx512(_N);
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            __m512 _H = _mm512_fmadd_ps(_U, _mm512_sub_ps(_mm512_loadu_ps(hidden_ptr + q), _N), _N);
+
+            _mm512_storeu_ps(hidden_ptr + q, _H);
+            _mm512_storeu_ps(output_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 4;
+        nn_num_output = (num_output - remain_num_output_start) >> 3;
+#else
+        int nn_num_output = num_output >> 3;
+#endif // __AVX512F__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = remain_num_output_start + qq * 8;
+
+            const signed char* kptr = weight_data_tm.row<const signed char>(gru_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(gru_int8_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            __m256i _Rx = _mm256_setzero_si256();
+            __m256i _Ux = _mm256_setzero_si256();
+            __m256i _Nx = _mm256_setzero_si256();
+            for (int i = 0; i < size2 / 2; i++)
+            {
+                __m256i _xi = _mm256_set1_epi32(xx[i]);
+                __m256i _w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+                __m256i _w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 16)));
+                __m256i _w2 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 32)));
+                _Rx = _mm256_comp_dpwssd_epi32(_Rx, _w0, _xi);
+                _Ux = _mm256_comp_dpwssd_epi32(_Ux, _w1, _xi);
+                _Nx = _mm256_comp_dpwssd_epi32(_Nx, _w2, _xi);
+
+                kptr += 48;
+            }
+
+            __m256i _Rh = _mm256_setzero_si256();
+            __m256i _Uh = _mm256_setzero_si256();
+            __m256i _Nh = _mm256_setzero_si256();
+            for (int i = 0; i < num_output2 / 2; i++)
+            {
+                __m256i _h_cont = _mm256_set1_epi32(hh[i]);
+                __m256i _w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+                __m256i _w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 16)));
+                __m256i _w2 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 32)));
+                _Rh = _mm256_comp_dpwssd_epi32(_Rh, _w0, _h_cont);
+                _Uh = _mm256_comp_dpwssd_epi32(_Uh, _w1, _h_cont);
+                _Nh = _mm256_comp_dpwssd_epi32(_Nh, _w2, _h_cont);
+
+                kptr += 48;
+            }
+
+            __m256 _descale_x = _mm256_set1_ps(descale_x);
+            __m256 _descale_h = _mm256_set1_ps(descale_h);
+
+            __m256 _R = _mm256_loadu_ps(bias_c_RUBNWN);
+            __m256 _U = _mm256_loadu_ps(bias_c_RUBNWN + 8);
+            _R = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Rx), _mm256_mul_ps(_descale_x, _mm256_loadu_ps(descales_ptr)), _R);
+            _U = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Ux), _mm256_mul_ps(_descale_x, _mm256_loadu_ps(descales_ptr + 8)), _U);
+            _R = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Rh), _mm256_mul_ps(_descale_h, _mm256_loadu_ps(descales_ptr + 24)), _R);
+            _U = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Uh), _mm256_mul_ps(_descale_h, _mm256_loadu_ps(descales_ptr + 32)), _U);
+
+            // sigmoid(R)
+            // sigmoid(U)
+            _R = sigmoid_avx(_R);
+            _U = sigmoid_avx(_U);
+
+            // gate new
+            __m256 _N = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Nh), _mm256_mul_ps(_descale_h, _mm256_loadu_ps(descales_ptr + 40)), _mm256_loadu_ps(bias_c_RUBNWN + 24));
+            _N = _mm256_comp_fmadd_ps(_R, _N, _mm256_loadu_ps(bias_c_RUBNWN + 16));
+            _N = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Nx), _mm256_mul_ps(_descale_x, _mm256_loadu_ps(descales_ptr + 16)), _N);
+
+            // tanh(N)
+            _N = tanh_avx(_N);
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            __m256 _H = _mm256_comp_fmadd_ps(_U, _mm256_sub_ps(_mm256_loadu_ps(hidden_ptr + q), _N), _N);
+
+            _mm256_storeu_ps(hidden_ptr + q, _H);
+            _mm256_storeu_ps(output_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 3;
+        nn_num_output = (num_output - remain_num_output_start) >> 2;
+#else
+        int nn_num_output = num_output >> 2;
+#endif // __AVX2__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = remain_num_output_start + qq * 4;
+
+            const signed char* kptr = weight_data_tm.row<const signed char>(gru_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(gru_int8_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            __m128i _Rx = _mm_setzero_si128();
+            __m128i _Ux = _mm_setzero_si128();
+            __m128i _Nx = _mm_setzero_si128();
+            for (int i = 0; i < size2 / 2; i++)
+            {
+                __m128i _xi = _mm_set1_epi32(xx[i]);
+                __m128i _w01 = _mm_loadu_si128((const __m128i*)kptr);
+                __m128i _w2 = _mm_loadl_epi64((const __m128i*)(kptr + 16));
+#if __SSE4_1__
+                __m128i _w0 = _mm_cvtepi8_epi16(_w01);
+                __m128i _w1 = _mm_cvtepi8_epi16(_mm_unpackhi_epi64(_w01, _w01));
+                _w2 = _mm_cvtepi8_epi16(_w2);
+#else
+                __m128i _extw01 = _mm_cmpgt_epi8(_mm_setzero_si128(), _w01);
+                __m128i _w0 = _mm_unpacklo_epi8(_w01, _extw01);
+                __m128i _w1 = _mm_unpackhi_epi8(_w01, _extw01);
+                _w2 = _mm_unpacklo_epi8(_w2, _mm_cmpgt_epi8(_mm_setzero_si128(), _w2));
+#endif
+                _Rx = _mm_comp_dpwssd_epi32(_Rx, _w0, _xi);
+                _Ux = _mm_comp_dpwssd_epi32(_Ux, _w1, _xi);
+                _Nx = _mm_comp_dpwssd_epi32(_Nx, _w2, _xi);
+
+                kptr += 24;
+            }
+
+            __m128i _Rh = _mm_setzero_si128();
+            __m128i _Uh = _mm_setzero_si128();
+            __m128i _Nh = _mm_setzero_si128();
+            for (int i = 0; i < num_output2 / 2; i++)
+            {
+                __m128i _h_cont = _mm_set1_epi32(hh[i]);
+                __m128i _w01 = _mm_loadu_si128((const __m128i*)kptr);
+                __m128i _w2 = _mm_loadl_epi64((const __m128i*)(kptr + 16));
+#if __SSE4_1__
+                __m128i _w0 = _mm_cvtepi8_epi16(_w01);
+                __m128i _w1 = _mm_cvtepi8_epi16(_mm_unpackhi_epi64(_w01, _w01));
+                _w2 = _mm_cvtepi8_epi16(_w2);
+#else
+                __m128i _extw01 = _mm_cmpgt_epi8(_mm_setzero_si128(), _w01);
+                __m128i _w0 = _mm_unpacklo_epi8(_w01, _extw01);
+                __m128i _w1 = _mm_unpackhi_epi8(_w01, _extw01);
+                _w2 = _mm_unpacklo_epi8(_w2, _mm_cmpgt_epi8(_mm_setzero_si128(), _w2));
+#endif
+                _Rh = _mm_comp_dpwssd_epi32(_Rh, _w0, _h_cont);
+                _Uh = _mm_comp_dpwssd_epi32(_Uh, _w1, _h_cont);
+                _Nh = _mm_comp_dpwssd_epi32(_Nh, _w2, _h_cont);
+
+                kptr += 24;
+            }
+
+            __m128 _descale_x = _mm_set1_ps(descale_x);
+            __m128 _descale_h = _mm_set1_ps(descale_h);
+
+            __m128 _R = _mm_loadu_ps(bias_c_RUBNWN);
+            __m128 _U = _mm_loadu_ps(bias_c_RUBNWN + 4);
+            _R = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Rx), _mm_mul_ps(_descale_x, _mm_loadu_ps(descales_ptr)), _R);
+            _U = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Ux), _mm_mul_ps(_descale_x, _mm_loadu_ps(descales_ptr + 4)), _U);
+            _R = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Rh), _mm_mul_ps(_descale_h, _mm_loadu_ps(descales_ptr + 12)), _R);
+            _U = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Uh), _mm_mul_ps(_descale_h, _mm_loadu_ps(descales_ptr + 16)), _U);
+
+            // sigmoid(R)
+            // sigmoid(U)
+            _R = sigmoid_sse(_R);
+            _U = sigmoid_sse(_U);
+
+            // gate new
+            __m128 _N = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Nh), _mm_mul_ps(_descale_h, _mm_loadu_ps(descales_ptr + 20)), _mm_loadu_ps(bias_c_RUBNWN + 12));
+            _N = _mm_comp_fmadd_ps(_R, _N, _mm_loadu_ps(bias_c_RUBNWN + 8));
+            _N = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Nx), _mm_mul_ps(_descale_x, _mm_loadu_ps(descales_ptr + 8)), _N);
+
+            // tanh(N)
+            _N = tanh_sse(_N);
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            __m128 _H = _mm_comp_fmadd_ps(_U, _mm_sub_ps(_mm_loadu_ps(hidden_ptr + q), _N), _N);
+
+            _mm_storeu_ps(hidden_ptr + q, _H);
+            _mm_storeu_ps(output_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 2;
+#endif // __SSE2__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = remain_num_output_start; q < num_output; q++)
+        {
+            const signed char* kptr = weight_data_tm.row<const signed char>(gru_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(gru_int8_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            int Rx = 0;
+            int Ux = 0;
+            int Nx = 0;
+            for (int i = 0; i < size2; i += 2)
+            {
+                Rx += kptr[0] * x16[i] + kptr[1] * x16[i + 1];
+                Ux += kptr[2] * x16[i] + kptr[3] * x16[i + 1];
+                Nx += kptr[4] * x16[i] + kptr[5] * x16[i + 1];
+
+                kptr += 6;
+            }
+
+            int Rh = 0;
+            int Uh = 0;
+            int Nh = 0;
+            for (int i = 0; i < num_output2; i += 2)
+            {
+                Rh += kptr[0] * h16[i] + kptr[1] * h16[i + 1];
+                Uh += kptr[2] * h16[i] + kptr[3] * h16[i + 1];
+                Nh += kptr[4] * h16[i] + kptr[5] * h16[i + 1];
+
+                kptr += 6;
+            }
+
+            float R = bias_c_RUBNWN[0] + Rx * (descale_x * descales_ptr[0]) + Rh * (descale_h * descales_ptr[3]);
+            float U = bias_c_RUBNWN[1] + Ux * (descale_x * descales_ptr[1]) + Uh * (descale_h * descales_ptr[4]);
+
+            // sigmoid(R)
+            // sigmoid(U)
+            R = 1.f / (1.f + expf(-R));
+            U = 1.f / (1.f + expf(-U));
+
+            // gate new
+            float N = bias_c_RUBNWN[3] + Nh * (descale_h * descales_ptr[5]);
+            N = bias_c_RUBNWN[2] + R * N + Nx * (descale_x * descales_ptr[2]);
+
+            // tanh(N)
+            N = tanhf(N);
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            float H = (1 - U) * N + U * hidden_ptr[q];
+
+            hidden_ptr[q] = H;
+            output_data[q] = H;
+        }
+    }
+}
@@ -0,0 +1,745 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "gru_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+#include "cpu.h"
+
+namespace ncnn {
+
+#include "gru_int8.h"
+
+GRU_x86::GRU_x86()
+{
+    one_blob_only = false;
+    support_inplace = false;
+}
+
+static inline int gru_weight_row(int q)
+{
+    // units are packed in groups of 16 / 8 / 4 / 1, q is the first unit of a group
+#if __AVX512F__
+    return q / 16 + (q % 16) / 8 + (q % 8) / 4 + q % 4;
+#elif __AVX__
+    return q / 8 + (q % 8) / 4 + q % 4;
+#elif __SSE2__
+    return q / 4 + q % 4;
+#else
+    return q;
+#endif
+}
+
+static void gru_transform_weight_group(const Mat& weight_xc, const Mat& weight_hc, const Mat& bias_c, int q, int n, int size, int num_output, float* weight_xc_RUN, float* weight_hc_RUN, float* bias_c_RUBNWN)
+{
+    for (int i = 0; i < size; i++)
+    {
+        for (int g = 0; g < 3; g++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                *weight_xc_RUN++ = weight_xc.row(num_output * g + q + j)[i];
+            }
+        }
+    }
+
+    for (int i = 0; i < num_output; i++)
+    {
+        for (int g = 0; g < 3; g++)
+        {
+            for (int j = 0; j < n; j++)
+            {
+                *weight_hc_RUN++ = weight_hc.row(num_output * g + q + j)[i];
+            }
+        }
+    }
+
+    // R U WN BN
+    for (int g = 0; g < 4; g++)
+    {
+        const float* bias_c_ptr = bias_c.row(g);
+
+        for (int j = 0; j < n; j++)
+        {
+            *bias_c_RUBNWN++ = bias_c_ptr[q + j];
+        }
+    }
+}
+
+int GRU_x86::create_pipeline(const Option& opt)
+{
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return create_pipeline_int8(opt);
+    }
+#endif
+
+    // pack RUN
+    int num_directions = direction == 2 ? 2 : 1;
+    int size = weight_data_size / num_directions / num_output / 3;
+
+#if __AVX512F__
+    const int elempack = 16;
+#elif __AVX__
+    const int elempack = 8;
+#elif __SSE2__
+    const int elempack = 4;
+#else
+    const int elempack = 1;
+#endif
+
+    const int rows = gru_weight_row(num_output);
+
+    weight_xc_data_packed.create(size * 3, rows, num_directions, 4u * elempack, elempack);
+    bias_c_data_packed.create(num_output * 4, 1, num_directions);
+    weight_hc_data_packed.create(num_output * 3, rows, num_directions, 4u * elempack, elempack);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const Mat weight_xc = weight_xc_data.channel(dr);
+        const Mat bias_c = bias_c_data.channel(dr);
+        const Mat weight_hc = weight_hc_data.channel(dr);
+
+        Mat weight_xc_data_packed_dr = weight_xc_data_packed.channel(dr);
+        Mat weight_hc_data_packed_dr = weight_hc_data_packed.channel(dr);
+        float* bias_c_RUBNWN = bias_c_data_packed.channel(dr);
+
+        int q = 0;
+#if __AVX512F__
+        for (; q + 15 < num_output; q += 16)
+        {
+            const int row = gru_weight_row(q);
+            gru_transform_weight_group(weight_xc, weight_hc, bias_c, q, 16, size, num_output, weight_xc_data_packed_dr.row(row), weight_hc_data_packed_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+#endif // __AVX512F__
+#if __AVX__
+        for (; q + 7 < num_output; q += 8)
+        {
+            const int row = gru_weight_row(q);
+            gru_transform_weight_group(weight_xc, weight_hc, bias_c, q, 8, size, num_output, weight_xc_data_packed_dr.row(row), weight_hc_data_packed_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+#endif // __AVX__
+#if __SSE2__
+        for (; q + 3 < num_output; q += 4)
+        {
+            const int row = gru_weight_row(q);
+            gru_transform_weight_group(weight_xc, weight_hc, bias_c, q, 4, size, num_output, weight_xc_data_packed_dr.row(row), weight_hc_data_packed_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+#endif // __SSE2__
+        for (; q < num_output; q++)
+        {
+            const int row = gru_weight_row(q);
+            gru_transform_weight_group(weight_xc, weight_hc, bias_c, q, 1, size, num_output, weight_xc_data_packed_dr.row(row), weight_hc_data_packed_dr.row(row), bias_c_RUBNWN + q * 4);
+        }
+    }
+
+    if (opt.lightmode)
+    {
+        weight_xc_data.release();
+        bias_c_data.release();
+        weight_hc_data.release();
+    }
+
+    return 0;
+}
+
+static int gru(const Mat& bottom_blob, Mat& top_blob, int reverse, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, Mat& hidden_state, const Option& opt)
+{
+    int size = bottom_blob.w;
+    int T = bottom_blob.h;
+
+    int num_output = top_blob.w;
+
+    // h_t of all units, written back after every unit has read h_{t-1}
+    Mat gates(num_output, 4u, opt.workspace_allocator);
+    if (gates.empty())
+        return -100;
+
+    // unroll
+    for (int t = 0; t < T; t++)
+    {
+        int ti = reverse ? T - 1 - t : t;
+
+        const float* x = bottom_blob.row(ti);
+        const float* hidden_ptr = hidden_state;
+        float* gates_data = gates;
+
+        int remain_num_output_start = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+        int nn_num_output = num_output >> 4;
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = qq * 16;
+
+            const float* weight_xc_RUN = weight_xc.row(gru_weight_row(q));
+            const float* weight_hc_RUN = weight_hc.row(gru_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            __m512 _R = _mm512_loadu_ps(bias_c_RUBNWN);
+            __m512 _U = _mm512_loadu_ps(bias_c_RUBNWN + 16);
+            __m512 _Nx = _mm512_loadu_ps(bias_c_RUBNWN + 32);
+            __m512 _Nh = _mm512_loadu_ps(bias_c_RUBNWN + 48);
+
+            for (int i = 0; i < size; i++)
+            {
+                __m512 _xi = _mm512_set1_ps(x[i]);
+                _R = _mm512_fmadd_ps(_mm512_loadu_ps(weight_xc_RUN), _xi, _R);
+                _U = _mm512_fmadd_ps(_mm512_loadu_ps(weight_xc_RUN + 16), _xi, _U);
+                _Nx = _mm512_fmadd_ps(_mm512_loadu_ps(weight_xc_RUN + 32), _xi, _Nx);
+
+                weight_xc_RUN += 48;
+            }
+
+            for (int i = 0; i < num_output; i++)
+            {
+                __m512 _h_cont = _mm512_set1_ps(hidden_ptr[i]);
+                _R = _mm512_fmadd_ps(_mm512_loadu_ps(weight_hc_RUN), _h_cont, _R);
+                _U = _mm512_fmadd_ps(_mm512_loadu_ps(weight_hc_RUN + 16), _h_cont, _U);
+                _Nh = _mm512_fmadd_ps(_mm512_loadu_ps(weight_hc_RUN + 32), _h_cont, _Nh);
+
+                weight_hc_RUN += 48;
+            }
+
+            // sigmoid(R)
+            // sigmoid(U)
+            _R = sigmoid_avx512(_R);
+            _U = sigmoid_avx512(_U);
+
+            // tanh(N)
+            __m512 _N = tanh_avx512(_mm512_fmadd_ps(_R, _Nh, _Nx));
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            __m512 _H = _mm512_fmadd_ps(_U, _mm512_sub_ps(_mm512_loadu_ps(hidden_ptr + q), _N), _N);
+
+            _mm512_storeu_ps(gates_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 4;
+        nn_num_output = (num_output - remain_num_output_start) >> 3;
+#else
+        int nn_num_output = num_output >> 3;
+#endif // __AVX512F__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = remain_num_output_start + qq * 8;
+
+            const float* weight_xc_RUN = weight_xc.row(gru_weight_row(q));
+            const float* weight_hc_RUN = weight_hc.row(gru_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            __m256 _R = _mm256_loadu_ps(bias_c_RUBNWN);
+            __m256 _U = _mm256_loadu_ps(bias_c_RUBNWN + 8);
+            __m256 _Nx = _mm256_loadu_ps(bias_c_RUBNWN + 16);
+            __m256 _Nh = _mm256_loadu_ps(bias_c_RUBNWN + 24);
+
+            for (int i = 0; i < size; i++)
+            {
+                __m256 _xi = _mm256_broadcast_ss(x + i);
+                _R = _mm256_comp_fmadd_ps(_mm256_loadu_ps(weight_xc_RUN), _xi, _R);
+                _U = _mm256_comp_fmadd_ps(_mm256_loadu_ps(weight_xc_RUN + 8), _xi, _U);
+                _Nx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(weight_xc_RUN + 16), _xi, _Nx);
+
+                weight_xc_RUN += 24;
+            }
+
+            for (int i = 0; i < num_output; i++)
+            {
+                __m256 _h_cont = _mm256_broadcast_ss(hidden_ptr + i);
+                _R = _mm256_comp_fmadd_ps(_mm256_loadu_ps(weight_hc_RUN), _h_cont, _R);
+                _U = _mm256_comp_fmadd_ps(_mm256_loadu_ps(weight_hc_RUN + 8), _h_cont, _U);
+                _Nh = _mm256_comp_fmadd_ps(_mm256_loadu_ps(weight_hc_RUN + 16), _h_cont, _Nh);
+
+                weight_hc_RUN += 24;
+            }
+
+            // sigmoid(R)
+            // sigmoid(U)
+            _R = sigmoid_avx(_R);
+            _U = sigmoid_avx(_U);
+
+            // tanh(N)
+            __m256 _N = tanh_avx(_mm256_comp_fmadd_ps(_R, _Nh, _Nx));
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            __m256 _H = _mm256_comp_fmadd_ps(_U, _mm256_sub_ps(_mm256_loadu_ps(hidden_ptr + q), _N), _N);
+
+            _mm256_storeu_ps(gates_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 3;
+        nn_num_output = (num_output - remain_num_output_start) >> 2;
+#else
+        int nn_num_output = num_output >> 2;
+#endif // __AVX__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = remain_num_output_start + qq * 4;
+
+            const float* weight_xc_RUN = weight_xc.row(gru_weight_row(q));
+            const float* weight_hc_RUN = weight_hc.row(gru_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            __m128 _R = _mm_loadu_ps(bias_c_RUBNWN);
+            __m128 _U = _mm_loadu_ps(bias_c_RUBNWN + 4);
+            __m128 _Nx = _mm_loadu_ps(bias_c_RUBNWN + 8);
+            __m128 _Nh = _mm_loadu_ps(bias_c_RUBNWN + 12);
+
+            for (int i = 0; i < size; i++)
+            {
+                __m128 _xi = _mm_load1_ps(x + i);
+                _R = _mm_comp_fmadd_ps(_mm_loadu_ps(weight_xc_RUN), _xi, _R);
+                _U = _mm_comp_fmadd_ps(_mm_loadu_ps(weight_xc_RUN + 4), _xi, _U);
+                _Nx = _mm_comp_fmadd_ps(_mm_loadu_ps(weight_xc_RUN + 8), _xi, _Nx);
+
+                weight_xc_RUN += 12;
+            }
+
+            for (int i = 0; i < num_output; i++)
+            {
+                __m128 _h_cont = _mm_load1_ps(hidden_ptr + i);
+                _R = _mm_comp_fmadd_ps(_mm_loadu_ps(weight_hc_RUN), _h_cont, _R);
+                _U = _mm_comp_fmadd_ps(_mm_loadu_ps(weight_hc_RUN + 4), _h_cont, _U);
+                _Nh = _mm_comp_fmadd_ps(_mm_loadu_ps(weight_hc_RUN + 8), _h_cont, _Nh);
+
+                weight_hc_RUN += 12;
+            }
+
+            // sigmoid(R)
+            // sigmoid(U)
+            _R = sigmoid_sse(_R);
+            _U = sigmoid_sse(_U);
+
+            // tanh(N)
+            __m128 _N = tanh_sse(_mm_comp_fmadd_ps(_R, _Nh, _Nx));
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            __m128 _H = _mm_comp_fmadd_ps(_U, _mm_sub_ps(_mm_loadu_ps(hidden_ptr + q), _N), _N);
+
+            _mm_storeu_ps(gates_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 2;
+#endif // __SSE2__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = remain_num_output_start; q < num_output; q++)
+        {
+            const float* weight_xc_RUN = weight_xc.row(gru_weight_row(q));
+            const float* weight_hc_RUN = weight_hc.row(gru_weight_row(q));
+            const float* bias_c_RUBNWN = (const float*)bias_c + q * 4;
+
+            float R = bias_c_RUBNWN[0];
+            float U = bias_c_RUBNWN[1];
+            float Nx = bias_c_RUBNWN[2];
+            float Nh = bias_c_RUBNWN[3];
+
+            for (int i = 0; i < size; i++)
+            {
+                float xi = x[i];
+
+                R += weight_xc_RUN[0] * xi;
+                U += weight_xc_RUN[1] * xi;
+                Nx += weight_xc_RUN[2] * xi;
+
+                weight_xc_RUN += 3;
+            }
+
+            for (int i = 0; i < num_output; i++)
+            {
+                float h_cont = hidden_ptr[i];
+
+                R += weight_hc_RUN[0] * h_cont;
+                U += weight_hc_RUN[1] * h_cont;
+                Nh += weight_hc_RUN[2] * h_cont;
+
+                weight_hc_RUN += 3;
+            }
+
+            // sigmoid(R)
+            // sigmoid(U)
+            R = 1.f / (1.f + expf(-R));
+            U = 1.f / (1.f + expf(-U));
+
+            // tanh(N)
+            float N = tanhf(Nx + R * Nh);
+
+            // h_t := (1 - update) .* new + update .* h_{t-1}
+            gates_data[q] = (1 - U) * N + U * hidden_ptr[q];
+        }
+
+        float* output_data = top_blob.row(ti);
+        memcpy(hidden_state, gates_data, num_output * sizeof(float));
+        memcpy(output_data, gates_data, num_output * sizeof(float));
+    }
+
+    return 0;
+}
+
+int GRU_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return forward_int8(bottom_blob, top_blob, opt);
+    }
+#endif
+
+    int T = bottom_blob.h;
+
+    int num_directions = direction == 2 ? 2 : 1;
+
+    // initial hidden state
+    Mat hidden(num_output, 4u, opt.workspace_allocator);
+    if (hidden.empty())
+        return -100;
+    hidden.fill(0.f);
+
+    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    // Uni directional
+    if (direction == 0 || direction == 1)
+    {
+        int ret = gru(bottom_blob, top_blob, direction, weight_xc_data_packed.channel(0), bias_c_data_packed.channel(0), weight_hc_data_packed.channel(0), hidden, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    if (direction == 2)
+    {
+        Mat top_blob_forward(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_forward.empty())
+            return -100;
+
+        Mat top_blob_reverse(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_reverse.empty())
+            return -100;
+
+        {
+            int ret = gru(bottom_blob, top_blob_forward, 0, weight_xc_data_packed.channel(0), bias_c_data_packed.channel(0), weight_hc_data_packed.channel(0), hidden, opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        hidden.fill(0.0f);
+
+        {
+            int ret = gru(bottom_blob, top_blob_reverse, 1, weight_xc_data_packed.channel(1), bias_c_data_packed.channel(1), weight_hc_data_packed.channel(1), hidden, opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        // concat w
+        for (int i = 0; i < T; i++)
+        {
+            const float* pf = top_blob_forward.row(i);
+            const float* pr = top_blob_reverse.row(i);
+            float* ptr = top_blob.row(i);
+
+            memcpy(ptr, pf, num_output * sizeof(float));
+            memcpy(ptr + num_output, pr, num_output * sizeof(float));
+        }
+    }
+
+    return 0;
+}
+
+int GRU_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return forward_int8(bottom_blobs, top_blobs, opt);
+    }
+#endif
+
+    const Mat& bottom_blob = bottom_blobs[0];
+    int T = bottom_blob.h;
+    int num_directions = direction == 2 ? 2 : 1;
+
+    Mat hidden;
+    Allocator* hidden_allocator = top_blobs.size() == 2 ? opt.blob_allocator : opt.workspace_allocator;
+    if (bottom_blobs.size() == 2)
+    {
+        hidden = bottom_blobs[1].clone(hidden_allocator);
+    }
+    else
+    {
+        hidden.create(num_output, num_directions, 4u, hidden_allocator);
+        if (hidden.empty())
+            return -100;
+        hidden.fill(0.f);
+    }
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    // Uni directional
+    if (direction == 0 || direction == 1)
+    {
+        int ret = gru(bottom_blob, top_blob, direction, weight_xc_data_packed.channel(0), bias_c_data_packed.channel(0), weight_hc_data_packed.channel(0), hidden, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    if (direction == 2)
+    {
+        Mat top_blob_forward(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_forward.empty())
+            return -100;
+
+        Mat top_blob_reverse(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_reverse.empty())
+            return -100;
+
+        Mat hidden0 = hidden.row_range(0, 1);
+        {
+            int ret = gru(bottom_blob, top_blob_forward, 0, weight_xc_data_packed.channel(0), bias_c_data_packed.channel(0), weight_hc_data_packed.channel(0), hidden0, opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        Mat hidden1 = hidden.row_range(1, 1);
+        {
+            int ret = gru(bottom_blob, top_blob_reverse, 1, weight_xc_data_packed.channel(1), bias_c_data_packed.channel(1), weight_hc_data_packed.channel(1), hidden1, opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        // concat w
+        for (int i = 0; i < T; i++)
+        {
+            const float* pf = top_blob_forward.row(i);
+            const float* pr = top_blob_reverse.row(i);
+            float* ptr = top_blob.row(i);
+
+            memcpy(ptr, pf, num_output * sizeof(float));
+            memcpy(ptr + num_output, pr, num_output * sizeof(float));
+        }
+    }
+
+    if (top_blobs.size() == 2)
+    {
+        top_blobs[1] = hidden;
+    }
+
+    return 0;
+}
+
+#if NCNN_INT8
+int GRU_x86::create_pipeline_int8(const Option& opt)
+{
+    // pack RUN
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int size = weight_data_size / num_directions / num_output / 3;
+
+    gru_transform_weight_int8(weight_xc_data, weight_xc_data_int8_scales, weight_hc_data, weight_hc_data_int8_scales, bias_c_data, weight_data_tm, weight_data_tm_int8_descales, bias_c_data_packed, size, num_output, num_directions, opt);
+
+    if (opt.lightmode)
+    {
+        weight_xc_data.release();
+        bias_c_data.release();
+        weight_hc_data.release();
+        weight_xc_data_int8_scales.release();
+        weight_hc_data_int8_scales.release();
+    }
+
+    return 0;
+}
+
+static void gru_dynamic_quantize(const Mat& bottom_blob, Mat& bottom_blob_int8, Mat& bottom_blob_int8_descales, const Option& opt)
+{
+    int size = bottom_blob.w;
+    int T = bottom_blob.h;
+
+    // dynamic quantize bottom_blob
+    bottom_blob_int8_descales.create(T, (size_t)4u, 1, opt.blob_allocator);
+
+    bottom_blob_int8.create(size, T, (size_t)1u, opt.blob_allocator);
+
+    // fp32
+    for (int t = 0; t < T; t++)
+    {
+        const float* ptr = bottom_blob.row(t);
+        signed char* outptr = bottom_blob_int8.row<signed char>(t);
+
+        const float absmax = gru_dynamic_quantize_get_absmax(ptr, size);
+
+        bottom_blob_int8_descales[t] = absmax / 127.f;
+
+        const float scale = 127.f / absmax;
+        gru_dynamic_quantize_scale2int8(ptr, size, scale, outptr);
+    }
+}
+
+int GRU_x86::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    int T = bottom_blob.h;
+
+    int num_directions = direction == 2 ? 2 : 1;
+
+    // initial hidden state
+    Mat hidden(num_output, 4u, opt.workspace_allocator);
+    if (hidden.empty())
+        return -100;
+    hidden.fill(0.f);
+
+    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    // dynamic quantize bottom_blob
+    Mat bottom_blob_int8;
+    Mat bottom_blob_int8_descales;
+    {
+        Option opt_quant = opt;
+        opt_quant.blob_allocator = opt.workspace_allocator;
+        opt_quant.use_packing_layout = false;
+        gru_dynamic_quantize(bottom_blob, bottom_blob_int8, bottom_blob_int8_descales, opt_quant);
+    }
+
+    // Uni directional
+    if (direction == 0 || direction == 1)
+    {
+        gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob, direction, weight_data_tm.channel(0), weight_data_tm_int8_descales.channel(0), bias_c_data_packed.channel(0), hidden, opt);
+    }
+
+    if (direction == 2)
+    {
+        Mat top_blob_forward(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_forward.empty())
+            return -100;
+
+        Mat top_blob_reverse(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_reverse.empty())
+            return -100;
+
+        {
+            gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob_forward, 0, weight_data_tm.channel(0), weight_data_tm_int8_descales.channel(0), bias_c_data_packed.channel(0), hidden, opt);
+        }
+
+        hidden.fill(0.f);
+
+        {
+            gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob_reverse, 1, weight_data_tm.channel(1), weight_data_tm_int8_descales.channel(1), bias_c_data_packed.channel(1), hidden, opt);
+        }
+
+        // concat w
+        for (int i = 0; i < T; i++)
+        {
+            const float* pf = top_blob_forward.row(i);
+            const float* pr = top_blob_reverse.row(i);
+            float* ptr = top_blob.row(i);
+
+            memcpy(ptr, pf, num_output * sizeof(float));
+            memcpy(ptr + num_output, pr, num_output * sizeof(float));
+        }
+    }
+
+    return 0;
+}
+
+int GRU_x86::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+
+    int T = bottom_blob.h;
+    int num_directions = direction == 2 ? 2 : 1;
+
+    Mat hidden;
+    Allocator* hidden_allocator = top_blobs.size() == 2 ? opt.blob_allocator : opt.workspace_allocator;
+    if (bottom_blobs.size() == 2)
+    {
+        hidden = bottom_blobs[1].clone(hidden_allocator);
+    }
+    else
+    {
+        hidden.create(num_output, num_directions, 4u, hidden_allocator);
+        if (hidden.empty())
+            return -100;
+        hidden.fill(0.f);
+    }
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    // dynamic quantize bottom_blob
+    Mat bottom_blob_int8;
+    Mat bottom_blob_int8_descales;
+    {
+        Option opt_quant = opt;
+        opt_quant.blob_allocator = opt.workspace_allocator;
+        opt_quant.use_packing_layout = false;
+        gru_dynamic_quantize(bottom_blob, bottom_blob_int8, bottom_blob_int8_descales, opt_quant);
+    }
+
+    // Uni directional
+    if (direction == 0 || direction == 1)
+    {
+        gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob, direction, weight_data_tm.channel(0), weight_data_tm_int8_descales.channel(0), bias_c_data_packed.channel(0), hidden, opt);
+    }
+
+    if (direction == 2)
+    {
+        Mat top_blob_forward(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_forward.empty())
+            return -100;
+
+        Mat top_blob_reverse(num_output, T, 4u, opt.workspace_allocator);
+        if (top_blob_reverse.empty())
+            return -100;
+
+        Mat hidden0 = hidden.row_range(0, 1);
+        {
+            gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob_forward, 0, weight_data_tm.channel(0), weight_data_tm_int8_descales.channel(0), bias_c_data_packed.channel(0), hidden0, opt);
+        }
+
+        Mat hidden1 = hidden.row_range(1, 1);
+        {
+            gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob_reverse, 1, weight_data_tm.channel(1), weight_data_tm_int8_descales.channel(1), bias_c_data_packed.channel(1), hidden1, opt);
+        }
+
+        // concat w
+        for (int i = 0; i < T; i++)
+        {
+            const float* pf = top_blob_forward.row(i);
+            const float* pr = top_blob_reverse.row(i);
+            float* ptr = top_blob.row(i);
+
+            memcpy(ptr, pf, num_output * sizeof(float));
+            memcpy(ptr + num_output, pr, num_output * sizeof(float));
+        }
+    }
+
+    if (top_blobs.size() == 2)
+    {
+        top_blobs[1] = hidden;
+    }
+
+    return 0;
+}
+#endif // NCNN_INT8
+
+} // namespace ncnn
@@ -16,11 +16,13 @@
 #include "layer_type.h"
 
 #include "cpu.h"
+#include "profiler.h"
 
 namespace ncnn {
 
 #include "innerproduct_fp.h"
 #include "innerproduct_gemm_fp.h"
+#include "gemm_sparse.h"
 
 #if NCNN_F16C && __AVX__
 #define NCNN_IMPL_FP16S 1
@@ -29,11 +31,18 @@ namespace ncnn {
 #undef NCNN_IMPL_FP16S
 #endif
 
+#if NCNN_BF16
+#include "gemm_bf16s_utility.h"
+#endif
+
 InnerProduct_x86::InnerProduct_x86()
 {
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_BF16
+    support_bf16_storage = true;
+#endif
 
     flatten = 0;
 }
@@ -54,10 +63,31 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
 #if NCNN_INT8
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
+        support_bf16_storage = false;
         return create_pipeline_int8_x86(opt);
     }
 #endif
 
+#if NCNN_BF16
+    if (support_bf16_storage && opt.use_bf16_storage)
+    {
+        return create_pipeline_bf16s(opt);
+    }
+#endif
+
+    const int num_input = weight_data_size / num_output;
+
+    if (opt.use_sparse_weight && sparse_gemm_transform_kernel(weight_data, weight_sparse_data, weight_sparse_index, num_output, num_input))
+    {
+        // sparse kernels take unpacked blobs
+        support_packing = false;
+
+        if (opt.lightmode)
+            weight_data.release();
+
+        return 0;
+    }
+
 #if NCNN_F16C && __AVX__
     if (cpu_support_x86_f16c() && opt.use_fp16_storage)
     {
@@ -65,8 +95,6 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
     }
 #endif
 
-    const int num_input = weight_data_size / num_output;
-
     innerproduct_transform_kernel_sse(weight_data, weight_data_tm, num_input, num_output, opt);
 
     if (opt.lightmode)
@@ -87,6 +115,65 @@ int InnerProduct_x86::destroy_pipeline(const Option& opt)
     return 0;
 }
 
+int InnerProduct_x86::export_pipeline(std::vector<Mat>& pipeline_data) const
+{
+    pipeline_data.clear();
+    pipeline_data.push_back(weight_data_tm);
+    pipeline_data.push_back(weight_sparse_data);
+    pipeline_data.push_back(weight_sparse_index);
+#if NCNN_INT8
+    pipeline_data.push_back(scale_in_data);
+#endif
+
+    return 0;
+}
+
+int InnerProduct_x86::import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt)
+{
+#if NCNN_BF16
+    // bf16 pipeline is not cached
+    if (support_bf16_storage && opt.use_bf16_storage)
+        return -1;
+#endif
+
+#if NCNN_INT8
+    const size_t pipeline_data_count = 4;
+#else
+    const size_t pipeline_data_count = 3;
+#endif
+
+    if (pipeline_data.size() != pipeline_data_count)
+        return -1;
+
+    {
+        flatten = ncnn::create_layer_cpu(ncnn::LayerType::Flatten);
+
+        ncnn::ParamDict pd;
+
+        flatten->load_param(pd);
+
+        flatten->create_pipeline(opt);
+    }
+
+    weight_data_tm = pipeline_data[0];
+    weight_sparse_data = pipeline_data[1];
+    weight_sparse_index = pipeline_data[2];
+#if NCNN_INT8
+    scale_in_data = pipeline_data[3];
+#endif
+
+    if (!weight_sparse_index.empty())
+    {
+        // sparse kernels take unpacked blobs
+        support_packing = false;
+    }
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
 int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
 #if NCNN_INT8
@@ -96,6 +183,18 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     }
 #endif
 
+#if NCNN_BF16
+    if (support_bf16_storage && opt.use_bf16_storage)
+    {
+        return forward_bf16s(bottom_blob, top_blob, opt);
+    }
+#endif
+
+    if (!weight_sparse_index.empty())
+    {
+        return forward_sparse(bottom_blob, top_blob, opt);
+    }
+
 #if NCNN_F16C && __AVX__
     if (cpu_support_x86_f16c() && opt.use_fp16_storage)
     {
@@ -160,6 +259,70 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     return 0;
 }
 
+int InnerProduct_x86::forward_sparse(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int num_input = weight_data_size / num_output;
+
+    profiler_set_kernel("sparse");
+
+    if (bottom_blob.dims == 2 && bottom_blob.w == num_input)
+    {
+        // gemm
+        int h = bottom_blob.h;
+        size_t elemsize = bottom_blob.elemsize;
+
+        top_blob.create(num_output, h, elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        // the kernel runs along the columns of transposed input and output
+        Mat bottom_blob_t(h, num_input, 4u, opt.workspace_allocator);
+        Mat top_blob_t(h, num_output, 4u, opt.workspace_allocator);
+        if (bottom_blob_t.empty() || top_blob_t.empty())
+            return -100;
+
+        sparse_gemm_transpose(bottom_blob, num_input, bottom_blob_t, h, num_input, h, opt.num_threads);
+
+        sparse_gemm(weight_sparse_data, weight_sparse_index, bias_data, bottom_blob_t, h, top_blob_t, h, num_output, h, opt.num_threads);
+
+        sparse_gemm_transpose(top_blob_t, h, top_blob, num_output, h, num_output, opt.num_threads);
+    }
+    else
+    {
+        // flatten
+        Mat bottom_blob_flattened = bottom_blob;
+        if (bottom_blob.dims != 1)
+        {
+            Option opt_flatten = opt;
+            opt_flatten.blob_allocator = opt.workspace_allocator;
+
+            flatten->forward(bottom_blob, bottom_blob_flattened, opt_flatten);
+            if (bottom_blob_flattened.empty())
+                return -100;
+        }
+
+        top_blob.create(num_output, bottom_blob_flattened.elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        sparse_gemm(weight_sparse_data, weight_sparse_index, bias_data, bottom_blob_flattened, 1, top_blob, 1, num_output, 1, opt.num_threads);
+    }
+
+    if (activation_type)
+    {
+        float* ptr = top_blob;
+        const int size = (int)top_blob.total();
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < size; i++)
+        {
+            ptr[i] = activation_ss(ptr[i], activation_type, activation_params);
+        }
+    }
+
+    return 0;
+}
+
 #if NCNN_F16C && __AVX__
 int InnerProduct_x86::create_pipeline_fp16s(const Option& opt)
 {
@@ -229,6 +392,94 @@ int InnerProduct_x86::forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const
 }
 #endif // NCNN_F16C && __AVX__
 
+#if NCNN_BF16
+int InnerProduct_x86::create_pipeline_bf16s(const Option& opt)
+{
+    // bf16 kernels take unpacked blobs
+    support_packing = false;
+
+    const int num_input = weight_data_size / num_output;
+
+    Mat weight_data_bf16;
+    cast_float32_to_bfloat16(weight_data.reshape(num_input, num_output), weight_data_bf16);
+    if (weight_data_bf16.empty())
+        return -100;
+
+    weight_data_tm.create((num_input + 1) / 2 * 2, num_output, 2u, (Allocator*)0);
+    if (weight_data_tm.empty())
+        return -100;
+
+    pack_A_bf16s(weight_data_bf16, weight_data_tm, num_output, num_input, 0, opt.num_threads);
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int num_input = weight_data_size / num_output;
+
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    Mat bottom_blob_bf16;
+    convert_packing(bottom_blob, bottom_blob_bf16, 1, opt_ws);
+    if (bottom_blob_bf16.elembits() == 32)
+    {
+        Mat bottom_blob_fp32 = bottom_blob_bf16;
+        cast_float32_to_bfloat16(bottom_blob_fp32, bottom_blob_bf16, opt_ws);
+    }
+    if (bottom_blob_bf16.empty())
+        return -100;
+
+    // gemm for 2d input, flatten for the others
+    int N = 1;
+    if (bottom_blob_bf16.dims == 2 && bottom_blob_bf16.w == num_input)
+    {
+        N = bottom_blob_bf16.h;
+    }
+    else if (bottom_blob_bf16.dims != 1)
+    {
+        Mat bottom_blob_flattened = bottom_blob_bf16.reshape(num_input, opt.workspace_allocator);
+        if (bottom_blob_flattened.empty())
+            return -100;
+
+        bottom_blob_bf16 = bottom_blob_flattened;
+    }
+
+    Mat BT((num_input + 1) / 2 * 2, N, 2u, opt.workspace_allocator);
+    if (BT.empty())
+        return -100;
+
+    pack_B_bf16s(bottom_blob_bf16, BT, N, num_input, 0, opt.num_threads);
+
+    Mat topT(num_output, N, 4u, opt.workspace_allocator);
+    if (topT.empty())
+        return -100;
+
+    gemm_transB_packed_bf16s(weight_data_tm, BT, topT, num_output, N, num_input, opt.num_threads);
+
+    if (bottom_blob_bf16.dims == 2)
+        top_blob.create(num_output, N, 2u, opt.blob_allocator);
+    else
+        top_blob.create(num_output, 2u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const float* biasptr = bias_term ? (const float*)bias_data : 0;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int j = 0; j < N; j++)
+    {
+        gemm_bf16s_store_output(topT.row(j), top_blob.row<unsigned short>(j), num_output, 0.f, biasptr, activation_type, activation_params);
+    }
+
+    return 0;
+}
+#endif // NCNN_BF16
+
 #if NCNN_INT8
 int InnerProduct_x86::create_pipeline_int8_x86(const Option& opt)
 {
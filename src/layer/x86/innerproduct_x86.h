@@ -16,9 +16,13 @@ public:
     virtual int create_pipeline(const Option& opt);
     virtual int destroy_pipeline(const Option& opt);
 
+    virtual int export_pipeline(std::vector<Mat>& pipeline_data) const;
+    virtual int import_pipeline(const std::vector<Mat>& pipeline_data, const Option& opt);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 protected:
+    int forward_sparse(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #if NCNN_F16C && __AVX__
     int create_pipeline_fp16s(const Option& opt);
     int forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
@@ -27,12 +31,20 @@ protected:
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #endif
+#if NCNN_BF16
+    int create_pipeline_bf16s(const Option& opt);
+    int forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif
 
 public:
     Layer* flatten;
 
     Mat weight_data_tm;
 
+    // sparse weight blocks
+    Mat weight_sparse_data;
+    Mat weight_sparse_index;
+
 #if NCNN_INT8
     Mat scale_in_data;
 #endif
@@ -15,6 +15,8 @@ MatMul_x86::MatMul_x86()
 int MatMul_x86::create_pipeline(const Option& opt)
 {
     gemm = ncnn::create_layer_cpu(ncnn::LayerType::Gemm);
+    // matmul takes and gives fp32 blobs
+    gemm->support_bf16_storage = false;
 
     ncnn::ParamDict pd;
     pd.set(2, 0);      // transA
@@ -28,6 +30,9 @@ int MatMul_x86::create_pipeline(const Option& opt)
     pd.set(10, -1);    // constant_broadcast_type_C = null
     pd.set(11, 0);     // output_N1M
     pd.set(12, 1);     // output_elempack
+    pd.set(20, constant_TILE_M);
+    pd.set(21, constant_TILE_N);
+    pd.set(22, constant_TILE_K);
 
     gemm->load_param(pd);
 
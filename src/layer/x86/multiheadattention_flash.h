@@ -0,0 +1,703 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// fused qk softmax qkv, one group of queries runs through all keys with an online softmax
+// queries sit in vector lanes so that the running max and sum need no horizontal reduction
+// two vectors of queries share every key and value broadcast
+#if __AVX512F__
+#define FLASH_ATTENTION_LANES 32
+#elif __AVX__
+#define FLASH_ATTENTION_LANES 16
+#elif __SSE2__
+#define FLASH_ATTENTION_LANES 8
+#else
+#define FLASH_ATTENTION_LANES 1
+#endif
+
+// keys per online softmax step
+#define FLASH_ATTENTION_BLOCK 64
+
+// queries per parallel task
+#define FLASH_ATTENTION_QUERY_BLOCK 64
+
+// short sequences go through the gemm path
+#define FLASH_ATTENTION_MIN_SRC_SEQLEN 16
+#define FLASH_ATTENTION_MIN_DST_SEQLEN 256
+
+static int flash_attention_workspace_size(int embed_dim_per_head)
+{
+    // qbuf + obuf + sbuf + max + sum
+    return (embed_dim_per_head * 2 + FLASH_ATTENTION_BLOCK + 2) * FLASH_ATTENTION_LANES;
+}
+
+static void flash_attention_transpose(const Mat& in, Mat& out)
+{
+    // in (w, h) to out (h, w)
+    for (int i = 0; i < in.h; i++)
+    {
+        const float* ptr = in.row(i);
+
+        for (int j = 0; j < in.w; j++)
+        {
+            out.row(j)[i] = ptr[j];
+        }
+    }
+}
+
+// q    (src_seqlen, embed_dim_per_head) already scaled
+// k    (dst_seqlen, embed_dim_per_head)
+// v    (embed_dim_per_head, dst_seqlen)
+// mask (dst_seqlen, src_seqlen) or empty
+// out  (src_seqlen, embed_dim_per_head)
+// handles queries [i0, i1)
+static void flash_attention(const Mat& q, const Mat& k, const Mat& v, const Mat& mask, Mat& out, int i0, int i1, float* workspace)
+{
+    const int L = FLASH_ATTENTION_LANES;
+    const int embed_dim_per_head = q.h;
+    const int dst_seqlen = k.w;
+
+    float* qbuf = workspace;
+    float* obuf = qbuf + embed_dim_per_head * L;
+    float* sbuf = obuf + embed_dim_per_head * L;
+    float* mbuf = sbuf + FLASH_ATTENTION_BLOCK * L;
+    float* lbuf = mbuf + L;
+
+    for (int i = i0; i < i1; i += L)
+    {
+        const int max_ii = std::min(L, i1 - i);
+
+        const float* qptr = q.row(0) + i;
+        int qstride = q.w;
+        if (max_ii < L)
+        {
+            // zero padded tail
+            for (int d = 0; d < embed_dim_per_head; d++)
+            {
+                const float* ptr = q.row(d) + i;
+                for (int ii = 0; ii < L; ii++)
+                {
+                    qbuf[d * L + ii] = ii < max_ii ? ptr[ii] : 0.f;
+                }
+            }
+
+            qptr = qbuf;
+            qstride = L;
+        }
+
+        for (int ii = 0; ii < L; ii++)
+        {
+            mbuf[ii] = -FLT_MAX;
+            lbuf[ii] = 0.f;
+        }
+        memset(obuf, 0, embed_dim_per_head * L * sizeof(float));
+
+        for (int j = 0; j < dst_seqlen; j += FLASH_ATTENTION_BLOCK)
+        {
+            const int max_jj = std::min(FLASH_ATTENTION_BLOCK, dst_seqlen - j);
+
+            // s = q * k
+            int jj = 0;
+
+#if __AVX512F__
+            for (; jj + 7 < max_jj; jj += 8)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                __m512 _s00 = _mm512_setzero_ps();
+                __m512 _s01 = _mm512_setzero_ps();
+                __m512 _s10 = _mm512_setzero_ps();
+                __m512 _s11 = _mm512_setzero_ps();
+                __m512 _s20 = _mm512_setzero_ps();
+                __m512 _s21 = _mm512_setzero_ps();
+                __m512 _s30 = _mm512_setzero_ps();
+                __m512 _s31 = _mm512_setzero_ps();
+                __m512 _s40 = _mm512_setzero_ps();
+                __m512 _s41 = _mm512_setzero_ps();
+                __m512 _s50 = _mm512_setzero_ps();
+                __m512 _s51 = _mm512_setzero_ps();
+                __m512 _s60 = _mm512_setzero_ps();
+                __m512 _s61 = _mm512_setzero_ps();
+                __m512 _s70 = _mm512_setzero_ps();
+                __m512 _s71 = _mm512_setzero_ps();
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    __m512 _q0 = _mm512_loadu_ps(qp);
+                    __m512 _q1 = _mm512_loadu_ps(qp + 16);
+                    __m512 _k0 = _mm512_set1_ps(kp[0]);
+                    _s00 = _mm512_fmadd_ps(_q0, _k0, _s00);
+                    _s01 = _mm512_fmadd_ps(_q1, _k0, _s01);
+                    __m512 _k1 = _mm512_set1_ps(kp[1]);
+                    _s10 = _mm512_fmadd_ps(_q0, _k1, _s10);
+                    _s11 = _mm512_fmadd_ps(_q1, _k1, _s11);
+                    __m512 _k2 = _mm512_set1_ps(kp[2]);
+                    _s20 = _mm512_fmadd_ps(_q0, _k2, _s20);
+                    _s21 = _mm512_fmadd_ps(_q1, _k2, _s21);
+                    __m512 _k3 = _mm512_set1_ps(kp[3]);
+                    _s30 = _mm512_fmadd_ps(_q0, _k3, _s30);
+                    _s31 = _mm512_fmadd_ps(_q1, _k3, _s31);
+                    __m512 _k4 = _mm512_set1_ps(kp[4]);
+                    _s40 = _mm512_fmadd_ps(_q0, _k4, _s40);
+                    _s41 = _mm512_fmadd_ps(_q1, _k4, _s41);
+                    __m512 _k5 = _mm512_set1_ps(kp[5]);
+                    _s50 = _mm512_fmadd_ps(_q0, _k5, _s50);
+                    _s51 = _mm512_fmadd_ps(_q1, _k5, _s51);
+                    __m512 _k6 = _mm512_set1_ps(kp[6]);
+                    _s60 = _mm512_fmadd_ps(_q0, _k6, _s60);
+                    _s61 = _mm512_fmadd_ps(_q1, _k6, _s61);
+                    __m512 _k7 = _mm512_set1_ps(kp[7]);
+                    _s70 = _mm512_fmadd_ps(_q0, _k7, _s70);
+                    _s71 = _mm512_fmadd_ps(_q1, _k7, _s71);
+                    qp += qstride;
+                    kp += k.w;
+                }
+                _mm512_storeu_ps(sbuf + jj * L, _s00);
+                _mm512_storeu_ps(sbuf + jj * L + 16, _s01);
+                _mm512_storeu_ps(sbuf + (jj + 1) * L, _s10);
+                _mm512_storeu_ps(sbuf + (jj + 1) * L + 16, _s11);
+                _mm512_storeu_ps(sbuf + (jj + 2) * L, _s20);
+                _mm512_storeu_ps(sbuf + (jj + 2) * L + 16, _s21);
+                _mm512_storeu_ps(sbuf + (jj + 3) * L, _s30);
+                _mm512_storeu_ps(sbuf + (jj + 3) * L + 16, _s31);
+                _mm512_storeu_ps(sbuf + (jj + 4) * L, _s40);
+                _mm512_storeu_ps(sbuf + (jj + 4) * L + 16, _s41);
+                _mm512_storeu_ps(sbuf + (jj + 5) * L, _s50);
+                _mm512_storeu_ps(sbuf + (jj + 5) * L + 16, _s51);
+                _mm512_storeu_ps(sbuf + (jj + 6) * L, _s60);
+                _mm512_storeu_ps(sbuf + (jj + 6) * L + 16, _s61);
+                _mm512_storeu_ps(sbuf + (jj + 7) * L, _s70);
+                _mm512_storeu_ps(sbuf + (jj + 7) * L + 16, _s71);
+            }
+            for (; jj < max_jj; jj++)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                __m512 _s00 = _mm512_setzero_ps();
+                __m512 _s01 = _mm512_setzero_ps();
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    __m512 _q0 = _mm512_loadu_ps(qp);
+                    __m512 _q1 = _mm512_loadu_ps(qp + 16);
+                    __m512 _k0 = _mm512_set1_ps(kp[0]);
+                    _s00 = _mm512_fmadd_ps(_q0, _k0, _s00);
+                    _s01 = _mm512_fmadd_ps(_q1, _k0, _s01);
+                    qp += qstride;
+                    kp += k.w;
+                }
+                _mm512_storeu_ps(sbuf + jj * L, _s00);
+                _mm512_storeu_ps(sbuf + jj * L + 16, _s01);
+            }
+#elif __AVX__
+            for (; jj + 3 < max_jj; jj += 4)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                __m256 _s00 = _mm256_setzero_ps();
+                __m256 _s01 = _mm256_setzero_ps();
+                __m256 _s10 = _mm256_setzero_ps();
+                __m256 _s11 = _mm256_setzero_ps();
+                __m256 _s20 = _mm256_setzero_ps();
+                __m256 _s21 = _mm256_setzero_ps();
+                __m256 _s30 = _mm256_setzero_ps();
+                __m256 _s31 = _mm256_setzero_ps();
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    __m256 _q0 = _mm256_loadu_ps(qp);
+                    __m256 _q1 = _mm256_loadu_ps(qp + 8);
+                    __m256 _k0 = _mm256_set1_ps(kp[0]);
+                    _s00 = _mm256_comp_fmadd_ps(_q0, _k0, _s00);
+                    _s01 = _mm256_comp_fmadd_ps(_q1, _k0, _s01);
+                    __m256 _k1 = _mm256_set1_ps(kp[1]);
+                    _s10 = _mm256_comp_fmadd_ps(_q0, _k1, _s10);
+                    _s11 = _mm256_comp_fmadd_ps(_q1, _k1, _s11);
+                    __m256 _k2 = _mm256_set1_ps(kp[2]);
+                    _s20 = _mm256_comp_fmadd_ps(_q0, _k2, _s20);
+                    _s21 = _mm256_comp_fmadd_ps(_q1, _k2, _s21);
+                    __m256 _k3 = _mm256_set1_ps(kp[3]);
+                    _s30 = _mm256_comp_fmadd_ps(_q0, _k3, _s30);
+                    _s31 = _mm256_comp_fmadd_ps(_q1, _k3, _s31);
+                    qp += qstride;
+                    kp += k.w;
+                }
+                _mm256_storeu_ps(sbuf + jj * L, _s00);
+                _mm256_storeu_ps(sbuf + jj * L + 8, _s01);
+                _mm256_storeu_ps(sbuf + (jj + 1) * L, _s10);
+                _mm256_storeu_ps(sbuf + (jj + 1) * L + 8, _s11);
+                _mm256_storeu_ps(sbuf + (jj + 2) * L, _s20);
+                _mm256_storeu_ps(sbuf + (jj + 2) * L + 8, _s21);
+                _mm256_storeu_ps(sbuf + (jj + 3) * L, _s30);
+                _mm256_storeu_ps(sbuf + (jj + 3) * L + 8, _s31);
+            }
+            for (; jj < max_jj; jj++)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                __m256 _s00 = _mm256_setzero_ps();
+                __m256 _s01 = _mm256_setzero_ps();
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    __m256 _q0 = _mm256_loadu_ps(qp);
+                    __m256 _q1 = _mm256_loadu_ps(qp + 8);
+                    __m256 _k0 = _mm256_set1_ps(kp[0]);
+                    _s00 = _mm256_comp_fmadd_ps(_q0, _k0, _s00);
+                    _s01 = _mm256_comp_fmadd_ps(_q1, _k0, _s01);
+                    qp += qstride;
+                    kp += k.w;
+                }
+                _mm256_storeu_ps(sbuf + jj * L, _s00);
+                _mm256_storeu_ps(sbuf + jj * L + 8, _s01);
+            }
+#elif __SSE2__
+            for (; jj + 3 < max_jj; jj += 4)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                __m128 _s00 = _mm_setzero_ps();
+                __m128 _s01 = _mm_setzero_ps();
+                __m128 _s10 = _mm_setzero_ps();
+                __m128 _s11 = _mm_setzero_ps();
+                __m128 _s20 = _mm_setzero_ps();
+                __m128 _s21 = _mm_setzero_ps();
+                __m128 _s30 = _mm_setzero_ps();
+                __m128 _s31 = _mm_setzero_ps();
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    __m128 _q0 = _mm_loadu_ps(qp);
+                    __m128 _q1 = _mm_loadu_ps(qp + 4);
+                    __m128 _k0 = _mm_set1_ps(kp[0]);
+                    _s00 = _mm_comp_fmadd_ps(_q0, _k0, _s00);
+                    _s01 = _mm_comp_fmadd_ps(_q1, _k0, _s01);
+                    __m128 _k1 = _mm_set1_ps(kp[1]);
+                    _s10 = _mm_comp_fmadd_ps(_q0, _k1, _s10);
+                    _s11 = _mm_comp_fmadd_ps(_q1, _k1, _s11);
+                    __m128 _k2 = _mm_set1_ps(kp[2]);
+                    _s20 = _mm_comp_fmadd_ps(_q0, _k2, _s20);
+                    _s21 = _mm_comp_fmadd_ps(_q1, _k2, _s21);
+                    __m128 _k3 = _mm_set1_ps(kp[3]);
+                    _s30 = _mm_comp_fmadd_ps(_q0, _k3, _s30);
+                    _s31 = _mm_comp_fmadd_ps(_q1, _k3, _s31);
+                    qp += qstride;
+                    kp += k.w;
+                }
+                _mm_storeu_ps(sbuf + jj * L, _s00);
+                _mm_storeu_ps(sbuf + jj * L + 4, _s01);
+                _mm_storeu_ps(sbuf + (jj + 1) * L, _s10);
+                _mm_storeu_ps(sbuf + (jj + 1) * L + 4, _s11);
+                _mm_storeu_ps(sbuf + (jj + 2) * L, _s20);
+                _mm_storeu_ps(sbuf + (jj + 2) * L + 4, _s21);
+                _mm_storeu_ps(sbuf + (jj + 3) * L, _s30);
+                _mm_storeu_ps(sbuf + (jj + 3) * L + 4, _s31);
+            }
+            for (; jj < max_jj; jj++)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                __m128 _s00 = _mm_setzero_ps();
+                __m128 _s01 = _mm_setzero_ps();
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    __m128 _q0 = _mm_loadu_ps(qp);
+                    __m128 _q1 = _mm_loadu_ps(qp + 4);
+                    __m128 _k0 = _mm_set1_ps(kp[0]);
+                    _s00 = _mm_comp_fmadd_ps(_q0, _k0, _s00);
+                    _s01 = _mm_comp_fmadd_ps(_q1, _k0, _s01);
+                    qp += qstride;
+                    kp += k.w;
+                }
+                _mm_storeu_ps(sbuf + jj * L, _s00);
+                _mm_storeu_ps(sbuf + jj * L + 4, _s01);
+            }
+#else
+            for (; jj < max_jj; jj++)
+            {
+                const float* kp = k.row(0) + j + jj;
+                const float* qp = qptr;
+
+                float s0 = 0.f;
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    s0 += qp[0] * kp[0];
+                    qp += qstride;
+                    kp += k.w;
+                }
+                sbuf[jj] = s0;
+            }
+#endif
+
+            // s = s + mask
+            if (!mask.empty())
+            {
+                for (int ii = 0; ii < max_ii; ii++)
+                {
+                    const float* mptr = mask.row(i + ii) + j;
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        sbuf[jj * L + ii] += mptr[jj];
+                    }
+                }
+            }
+
+            // p = exp(s - max)
+            // o = o * exp(max_old - max) + p * v
+#if __AVX512F__
+            {
+                __m512 _max00 = _mm512_loadu_ps(mbuf);
+                __m512 _max01 = _mm512_loadu_ps(mbuf + 16);
+                __m512 _max0 = _max00;
+                __m512 _max1 = _max01;
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    _max0 = _mm512_max_ps(_max0, _mm512_loadu_ps(sbuf + jj * L));
+                    _max1 = _mm512_max_ps(_max1, _mm512_loadu_ps(sbuf + jj * L + 16));
+                }
+
+                __m512 _alpha0 = exp512_ps(_mm512_sub_ps(_max00, _max0));
+                __m512 _alpha1 = exp512_ps(_mm512_sub_ps(_max01, _max1));
+                __m512 _sum0 = _mm512_setzero_ps();
+                __m512 _sum1 = _mm512_setzero_ps();
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    __m512 _p0 = exp512_ps(_mm512_sub_ps(_mm512_loadu_ps(sbuf + jj * L), _max0));
+                    __m512 _p1 = exp512_ps(_mm512_sub_ps(_mm512_loadu_ps(sbuf + jj * L + 16), _max1));
+                    _mm512_storeu_ps(sbuf + jj * L, _p0);
+                    _mm512_storeu_ps(sbuf + jj * L + 16, _p1);
+                    _sum0 = _mm512_add_ps(_sum0, _p0);
+                    _sum1 = _mm512_add_ps(_sum1, _p1);
+                }
+
+                _mm512_storeu_ps(mbuf, _max0);
+                _mm512_storeu_ps(mbuf + 16, _max1);
+                _mm512_storeu_ps(lbuf, _mm512_fmadd_ps(_mm512_loadu_ps(lbuf), _alpha0, _sum0));
+                _mm512_storeu_ps(lbuf + 16, _mm512_fmadd_ps(_mm512_loadu_ps(lbuf + 16), _alpha1, _sum1));
+
+                int d = 0;
+                for (; d + 7 < embed_dim_per_head; d += 8)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    __m512 _o00 = _mm512_mul_ps(_mm512_loadu_ps(op), _alpha0);
+                    __m512 _o01 = _mm512_mul_ps(_mm512_loadu_ps(op + 16), _alpha1);
+                    __m512 _o10 = _mm512_mul_ps(_mm512_loadu_ps(op + L), _alpha0);
+                    __m512 _o11 = _mm512_mul_ps(_mm512_loadu_ps(op + L + 16), _alpha1);
+                    __m512 _o20 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 2), _alpha0);
+                    __m512 _o21 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 2 + 16), _alpha1);
+                    __m512 _o30 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 3), _alpha0);
+                    __m512 _o31 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 3 + 16), _alpha1);
+                    __m512 _o40 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 4), _alpha0);
+                    __m512 _o41 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 4 + 16), _alpha1);
+                    __m512 _o50 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 5), _alpha0);
+                    __m512 _o51 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 5 + 16), _alpha1);
+                    __m512 _o60 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 6), _alpha0);
+                    __m512 _o61 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 6 + 16), _alpha1);
+                    __m512 _o70 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 7), _alpha0);
+                    __m512 _o71 = _mm512_mul_ps(_mm512_loadu_ps(op + L * 7 + 16), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        __m512 _p0 = _mm512_loadu_ps(sbuf + jj * L);
+                        __m512 _p1 = _mm512_loadu_ps(sbuf + jj * L + 16);
+                        __m512 _v0 = _mm512_set1_ps(vp[0]);
+                        _o00 = _mm512_fmadd_ps(_p0, _v0, _o00);
+                        _o01 = _mm512_fmadd_ps(_p1, _v0, _o01);
+                        __m512 _v1 = _mm512_set1_ps(vp[1]);
+                        _o10 = _mm512_fmadd_ps(_p0, _v1, _o10);
+                        _o11 = _mm512_fmadd_ps(_p1, _v1, _o11);
+                        __m512 _v2 = _mm512_set1_ps(vp[2]);
+                        _o20 = _mm512_fmadd_ps(_p0, _v2, _o20);
+                        _o21 = _mm512_fmadd_ps(_p1, _v2, _o21);
+                        __m512 _v3 = _mm512_set1_ps(vp[3]);
+                        _o30 = _mm512_fmadd_ps(_p0, _v3, _o30);
+                        _o31 = _mm512_fmadd_ps(_p1, _v3, _o31);
+                        __m512 _v4 = _mm512_set1_ps(vp[4]);
+                        _o40 = _mm512_fmadd_ps(_p0, _v4, _o40);
+                        _o41 = _mm512_fmadd_ps(_p1, _v4, _o41);
+                        __m512 _v5 = _mm512_set1_ps(vp[5]);
+                        _o50 = _mm512_fmadd_ps(_p0, _v5, _o50);
+                        _o51 = _mm512_fmadd_ps(_p1, _v5, _o51);
+                        __m512 _v6 = _mm512_set1_ps(vp[6]);
+                        _o60 = _mm512_fmadd_ps(_p0, _v6, _o60);
+                        _o61 = _mm512_fmadd_ps(_p1, _v6, _o61);
+                        __m512 _v7 = _mm512_set1_ps(vp[7]);
+                        _o70 = _mm512_fmadd_ps(_p0, _v7, _o70);
+                        _o71 = _mm512_fmadd_ps(_p1, _v7, _o71);
+                        vp += v.w;
+                    }
+                    _mm512_storeu_ps(op, _o00);
+                    _mm512_storeu_ps(op + 16, _o01);
+                    _mm512_storeu_ps(op + L, _o10);
+                    _mm512_storeu_ps(op + L + 16, _o11);
+                    _mm512_storeu_ps(op + L * 2, _o20);
+                    _mm512_storeu_ps(op + L * 2 + 16, _o21);
+                    _mm512_storeu_ps(op + L * 3, _o30);
+                    _mm512_storeu_ps(op + L * 3 + 16, _o31);
+                    _mm512_storeu_ps(op + L * 4, _o40);
+                    _mm512_storeu_ps(op + L * 4 + 16, _o41);
+                    _mm512_storeu_ps(op + L * 5, _o50);
+                    _mm512_storeu_ps(op + L * 5 + 16, _o51);
+                    _mm512_storeu_ps(op + L * 6, _o60);
+                    _mm512_storeu_ps(op + L * 6 + 16, _o61);
+                    _mm512_storeu_ps(op + L * 7, _o70);
+                    _mm512_storeu_ps(op + L * 7 + 16, _o71);
+                }
+                for (; d < embed_dim_per_head; d++)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    __m512 _o00 = _mm512_mul_ps(_mm512_loadu_ps(op), _alpha0);
+                    __m512 _o01 = _mm512_mul_ps(_mm512_loadu_ps(op + 16), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        __m512 _p0 = _mm512_loadu_ps(sbuf + jj * L);
+                        __m512 _p1 = _mm512_loadu_ps(sbuf + jj * L + 16);
+                        __m512 _v0 = _mm512_set1_ps(vp[0]);
+                        _o00 = _mm512_fmadd_ps(_p0, _v0, _o00);
+                        _o01 = _mm512_fmadd_ps(_p1, _v0, _o01);
+                        vp += v.w;
+                    }
+                    _mm512_storeu_ps(op, _o00);
+                    _mm512_storeu_ps(op + 16, _o01);
+                }
+            }
+#elif __AVX__
+            {
+                __m256 _max00 = _mm256_loadu_ps(mbuf);
+                __m256 _max01 = _mm256_loadu_ps(mbuf + 8);
+                __m256 _max0 = _max00;
+                __m256 _max1 = _max01;
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    _max0 = _mm256_max_ps(_max0, _mm256_loadu_ps(sbuf + jj * L));
+                    _max1 = _mm256_max_ps(_max1, _mm256_loadu_ps(sbuf + jj * L + 8));
+                }
+
+                __m256 _alpha0 = exp256_ps(_mm256_sub_ps(_max00, _max0));
+                __m256 _alpha1 = exp256_ps(_mm256_sub_ps(_max01, _max1));
+                __m256 _sum0 = _mm256_setzero_ps();
+                __m256 _sum1 = _mm256_setzero_ps();
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    __m256 _p0 = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(sbuf + jj * L), _max0));
+                    __m256 _p1 = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(sbuf + jj * L + 8), _max1));
+                    _mm256_storeu_ps(sbuf + jj * L, _p0);
+                    _mm256_storeu_ps(sbuf + jj * L + 8, _p1);
+                    _sum0 = _mm256_add_ps(_sum0, _p0);
+                    _sum1 = _mm256_add_ps(_sum1, _p1);
+                }
+
+                _mm256_storeu_ps(mbuf, _max0);
+                _mm256_storeu_ps(mbuf + 8, _max1);
+                _mm256_storeu_ps(lbuf, _mm256_comp_fmadd_ps(_mm256_loadu_ps(lbuf), _alpha0, _sum0));
+                _mm256_storeu_ps(lbuf + 8, _mm256_comp_fmadd_ps(_mm256_loadu_ps(lbuf + 8), _alpha1, _sum1));
+
+                int d = 0;
+                for (; d + 3 < embed_dim_per_head; d += 4)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    __m256 _o00 = _mm256_mul_ps(_mm256_loadu_ps(op), _alpha0);
+                    __m256 _o01 = _mm256_mul_ps(_mm256_loadu_ps(op + 8), _alpha1);
+                    __m256 _o10 = _mm256_mul_ps(_mm256_loadu_ps(op + L), _alpha0);
+                    __m256 _o11 = _mm256_mul_ps(_mm256_loadu_ps(op + L + 8), _alpha1);
+                    __m256 _o20 = _mm256_mul_ps(_mm256_loadu_ps(op + L * 2), _alpha0);
+                    __m256 _o21 = _mm256_mul_ps(_mm256_loadu_ps(op + L * 2 + 8), _alpha1);
+                    __m256 _o30 = _mm256_mul_ps(_mm256_loadu_ps(op + L * 3), _alpha0);
+                    __m256 _o31 = _mm256_mul_ps(_mm256_loadu_ps(op + L * 3 + 8), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        __m256 _p0 = _mm256_loadu_ps(sbuf + jj * L);
+                        __m256 _p1 = _mm256_loadu_ps(sbuf + jj * L + 8);
+                        __m256 _v0 = _mm256_set1_ps(vp[0]);
+                        _o00 = _mm256_comp_fmadd_ps(_p0, _v0, _o00);
+                        _o01 = _mm256_comp_fmadd_ps(_p1, _v0, _o01);
+                        __m256 _v1 = _mm256_set1_ps(vp[1]);
+                        _o10 = _mm256_comp_fmadd_ps(_p0, _v1, _o10);
+                        _o11 = _mm256_comp_fmadd_ps(_p1, _v1, _o11);
+                        __m256 _v2 = _mm256_set1_ps(vp[2]);
+                        _o20 = _mm256_comp_fmadd_ps(_p0, _v2, _o20);
+                        _o21 = _mm256_comp_fmadd_ps(_p1, _v2, _o21);
+                        __m256 _v3 = _mm256_set1_ps(vp[3]);
+                        _o30 = _mm256_comp_fmadd_ps(_p0, _v3, _o30);
+                        _o31 = _mm256_comp_fmadd_ps(_p1, _v3, _o31);
+                        vp += v.w;
+                    }
+                    _mm256_storeu_ps(op, _o00);
+                    _mm256_storeu_ps(op + 8, _o01);
+                    _mm256_storeu_ps(op + L, _o10);
+                    _mm256_storeu_ps(op + L + 8, _o11);
+                    _mm256_storeu_ps(op + L * 2, _o20);
+                    _mm256_storeu_ps(op + L * 2 + 8, _o21);
+                    _mm256_storeu_ps(op + L * 3, _o30);
+                    _mm256_storeu_ps(op + L * 3 + 8, _o31);
+                }
+                for (; d < embed_dim_per_head; d++)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    __m256 _o00 = _mm256_mul_ps(_mm256_loadu_ps(op), _alpha0);
+                    __m256 _o01 = _mm256_mul_ps(_mm256_loadu_ps(op + 8), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        __m256 _p0 = _mm256_loadu_ps(sbuf + jj * L);
+                        __m256 _p1 = _mm256_loadu_ps(sbuf + jj * L + 8);
+                        __m256 _v0 = _mm256_set1_ps(vp[0]);
+                        _o00 = _mm256_comp_fmadd_ps(_p0, _v0, _o00);
+                        _o01 = _mm256_comp_fmadd_ps(_p1, _v0, _o01);
+                        vp += v.w;
+                    }
+                    _mm256_storeu_ps(op, _o00);
+                    _mm256_storeu_ps(op + 8, _o01);
+                }
+            }
+#elif __SSE2__
+            {
+                __m128 _max00 = _mm_loadu_ps(mbuf);
+                __m128 _max01 = _mm_loadu_ps(mbuf + 4);
+                __m128 _max0 = _max00;
+                __m128 _max1 = _max01;
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    _max0 = _mm_max_ps(_max0, _mm_loadu_ps(sbuf + jj * L));
+                    _max1 = _mm_max_ps(_max1, _mm_loadu_ps(sbuf + jj * L + 4));
+                }
+
+                __m128 _alpha0 = exp_ps(_mm_sub_ps(_max00, _max0));
+                __m128 _alpha1 = exp_ps(_mm_sub_ps(_max01, _max1));
+                __m128 _sum0 = _mm_setzero_ps();
+                __m128 _sum1 = _mm_setzero_ps();
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    __m128 _p0 = exp_ps(_mm_sub_ps(_mm_loadu_ps(sbuf + jj * L), _max0));
+                    __m128 _p1 = exp_ps(_mm_sub_ps(_mm_loadu_ps(sbuf + jj * L + 4), _max1));
+                    _mm_storeu_ps(sbuf + jj * L, _p0);
+                    _mm_storeu_ps(sbuf + jj * L + 4, _p1);
+                    _sum0 = _mm_add_ps(_sum0, _p0);
+                    _sum1 = _mm_add_ps(_sum1, _p1);
+                }
+
+                _mm_storeu_ps(mbuf, _max0);
+                _mm_storeu_ps(mbuf + 4, _max1);
+                _mm_storeu_ps(lbuf, _mm_comp_fmadd_ps(_mm_loadu_ps(lbuf), _alpha0, _sum0));
+                _mm_storeu_ps(lbuf + 4, _mm_comp_fmadd_ps(_mm_loadu_ps(lbuf + 4), _alpha1, _sum1));
+
+                int d = 0;
+                for (; d + 3 < embed_dim_per_head; d += 4)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    __m128 _o00 = _mm_mul_ps(_mm_loadu_ps(op), _alpha0);
+                    __m128 _o01 = _mm_mul_ps(_mm_loadu_ps(op + 4), _alpha1);
+                    __m128 _o10 = _mm_mul_ps(_mm_loadu_ps(op + L), _alpha0);
+                    __m128 _o11 = _mm_mul_ps(_mm_loadu_ps(op + L + 4), _alpha1);
+                    __m128 _o20 = _mm_mul_ps(_mm_loadu_ps(op + L * 2), _alpha0);
+                    __m128 _o21 = _mm_mul_ps(_mm_loadu_ps(op + L * 2 + 4), _alpha1);
+                    __m128 _o30 = _mm_mul_ps(_mm_loadu_ps(op + L * 3), _alpha0);
+                    __m128 _o31 = _mm_mul_ps(_mm_loadu_ps(op + L * 3 + 4), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        __m128 _p0 = _mm_loadu_ps(sbuf + jj * L);
+                        __m128 _p1 = _mm_loadu_ps(sbuf + jj * L + 4);
+                        __m128 _v0 = _mm_set1_ps(vp[0]);
+                        _o00 = _mm_comp_fmadd_ps(_p0, _v0, _o00);
+                        _o01 = _mm_comp_fmadd_ps(_p1, _v0, _o01);
+                        __m128 _v1 = _mm_set1_ps(vp[1]);
+                        _o10 = _mm_comp_fmadd_ps(_p0, _v1, _o10);
+                        _o11 = _mm_comp_fmadd_ps(_p1, _v1, _o11);
+                        __m128 _v2 = _mm_set1_ps(vp[2]);
+                        _o20 = _mm_comp_fmadd_ps(_p0, _v2, _o20);
+                        _o21 = _mm_comp_fmadd_ps(_p1, _v2, _o21);
+                        __m128 _v3 = _mm_set1_ps(vp[3]);
+                        _o30 = _mm_comp_fmadd_ps(_p0, _v3, _o30);
+                        _o31 = _mm_comp_fmadd_ps(_p1, _v3, _o31);
+                        vp += v.w;
+                    }
+                    _mm_storeu_ps(op, _o00);
+                    _mm_storeu_ps(op + 4, _o01);
+                    _mm_storeu_ps(op + L, _o10);
+                    _mm_storeu_ps(op + L + 4, _o11);
+                    _mm_storeu_ps(op + L * 2, _o20);
+                    _mm_storeu_ps(op + L * 2 + 4, _o21);
+                    _mm_storeu_ps(op + L * 3, _o30);
+                    _mm_storeu_ps(op + L * 3 + 4, _o31);
+                }
+                for (; d < embed_dim_per_head; d++)
+                {
+                    float* op = obuf + d * L;
+                    const float* vp = v.row(j) + d;
+
+                    __m128 _o00 = _mm_mul_ps(_mm_loadu_ps(op), _alpha0);
+                    __m128 _o01 = _mm_mul_ps(_mm_loadu_ps(op + 4), _alpha1);
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        __m128 _p0 = _mm_loadu_ps(sbuf + jj * L);
+                        __m128 _p1 = _mm_loadu_ps(sbuf + jj * L + 4);
+                        __m128 _v0 = _mm_set1_ps(vp[0]);
+                        _o00 = _mm_comp_fmadd_ps(_p0, _v0, _o00);
+                        _o01 = _mm_comp_fmadd_ps(_p1, _v0, _o01);
+                        vp += v.w;
+                    }
+                    _mm_storeu_ps(op, _o00);
+                    _mm_storeu_ps(op + 4, _o01);
+                }
+            }
+#else
+            {
+                float max = mbuf[0];
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    max = std::max(max, sbuf[jj]);
+                }
+
+                const float alpha = expf(mbuf[0] - max);
+                float sum = 0.f;
+                for (int jj = 0; jj < max_jj; jj++)
+                {
+                    sbuf[jj] = expf(sbuf[jj] - max);
+                    sum += sbuf[jj];
+                }
+
+                mbuf[0] = max;
+                lbuf[0] = lbuf[0] * alpha + sum;
+
+                for (int d = 0; d < embed_dim_per_head; d++)
+                {
+                    const float* vp = v.row(j) + d;
+
+                    float o = obuf[d] * alpha;
+                    for (int jj = 0; jj < max_jj; jj++)
+                    {
+                        o += sbuf[jj] * vp[0];
+                        vp += v.w;
+                    }
+                    obuf[d] = o;
+                }
+            }
+#endif
+        }
+
+        // out = o / sum
+        for (int ii = 0; ii < L; ii++)
+        {
+            lbuf[ii] = 1.f / lbuf[ii];
+        }
+
+        for (int d = 0; d < embed_dim_per_head; d++)
+        {
+            const float* op = obuf + d * L;
+            float* outptr = out.row(d) + i;
+
+            for (int ii = 0; ii < max_ii; ii++)
+            {
+                outptr[ii] = op[ii] * lbuf[ii];
+            }
+        }
+    }
+}
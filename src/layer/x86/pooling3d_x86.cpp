@@ -0,0 +1,811 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "pooling3d_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif
+#endif // __SSE2__
+
+namespace ncnn {
+
+Pooling3D_x86::Pooling3D_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+int Pooling3D_x86::create_pipeline(const Option& /*opt*/)
+{
+    if (adaptive_pooling)
+    {
+        support_packing = false;
+
+        support_bf16_storage = false;
+        support_fp16_storage = false;
+        support_int8_storage = false;
+        support_tensor_storage = false;
+    }
+    return 0;
+}
+
+int Pooling3D_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    // max value in NxNxN window
+    // avg value in NxNxN window
+
+    if (adaptive_pooling)
+    {
+        return Pooling3D::forward(bottom_blob, top_blob, opt);
+    }
+
+#if __SSE2__
+    int elempack = bottom_blob.elempack;
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int d = bottom_blob.d;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        if (global_pooling)
+        {
+            top_blob.create(channels, elemsize, elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            int size = w * h * d;
+
+            if (pooling_type == PoolMethod_MAX)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m512 _max = _mm512_loadu_ps(ptr);
+                    for (int i = 0; i < size; i++)
+                    {
+                        __m512 _val = _mm512_loadu_ps(ptr);
+                        _max = _mm512_max_ps(_max, _val);
+                        ptr += 16;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm512_storeu_ps(outptr + q * 16, _max);
+                }
+            }
+            else if (pooling_type == PoolMethod_AVE)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m512 _sum = _mm512_set1_ps(0.f);
+                    for (int i = 0; i < size; i++)
+                    {
+                        __m512 _val = _mm512_loadu_ps(ptr);
+                        _sum = _mm512_add_ps(_sum, _val);
+                        ptr += 16;
+                    }
+
+                    __m512 _inv_size = _mm512_set1_ps(1.f / size);
+                    __m512 _avg = _mm512_mul_ps(_sum, _inv_size);
+
+                    float* outptr = top_blob;
+                    _mm512_storeu_ps(outptr + q * 16, _avg);
+                }
+            }
+
+            return 0;
+        }
+
+        Mat bottom_blob_bordered;
+        make_padding(bottom_blob, bottom_blob_bordered, opt);
+        if (bottom_blob_bordered.empty())
+            return -100;
+
+        w = bottom_blob_bordered.w;
+        h = bottom_blob_bordered.h;
+        d = bottom_blob_bordered.d;
+
+        int outw = (w - kernel_w) / stride_w + 1;
+        int outh = (h - kernel_h) / stride_h + 1;
+        int outd = (d - kernel_d) / stride_d + 1;
+
+        top_blob.create(outw, outh, outd, channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int maxk = kernel_w * kernel_h * kernel_d;
+
+        // kernel offsets
+        std::vector<int> _space_ofs(maxk);
+        int* space_ofs = &_space_ofs[0];
+        {
+            int p1 = 0;
+            int p2 = 0;
+            int gap0 = w - kernel_w;
+            int gap1 = h * w - w * kernel_h;
+            for (int z = 0; z < kernel_d; z++)
+            {
+                for (int i = 0; i < kernel_h; i++)
+                {
+                    for (int j = 0; j < kernel_w; j++)
+                    {
+                        space_ofs[p1] = p2;
+                        p1++;
+                        p2++;
+                    }
+                    p2 += gap0;
+                }
+                p2 += gap1;
+            }
+        }
+
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 16;
+
+                            __m512 _max = _mm512_loadu_ps(sptr);
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                __m512 _val = _mm512_loadu_ps(sptr + space_ofs[k] * 16);
+                                _max = _mm512_max_ps(_max, _val);
+                            }
+
+                            _mm512_storeu_ps(outptr, _max);
+                            outptr += 16;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            if (avgpool_count_include_pad == 0)
+            {
+                int wtailpad = 0;
+                int htailpad = 0;
+                int dtailpad = 0;
+
+                if (pad_mode == 0) // full padding
+                {
+                    wtailpad = bottom_blob_bordered.w - bottom_blob.w - pad_left - pad_right;
+                    htailpad = bottom_blob_bordered.h - bottom_blob.h - pad_top - pad_bottom;
+                    dtailpad = bottom_blob_bordered.d - bottom_blob.d - pad_front - pad_behind;
+                }
+
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_bordered.channel(q);
+                    float* outptr = top_blob.channel(q);
+
+                    for (int z = 0; z < outd; z++)
+                    {
+                        int sz0 = z * stride_d;
+
+                        for (int i = 0; i < outh; i++)
+                        {
+                            int sy0 = i * stride_h;
+
+                            for (int j = 0; j < outw; j++)
+                            {
+                                int sx0 = j * stride_w;
+
+                                __m512 _sum = _mm512_set1_ps(0.f);
+                                int area = 0;
+
+                                for (int kd = 0; kd < kernel_d; kd++)
+                                {
+                                    int sz = sz0 + kd;
+
+                                    if (sz < pad_front)
+                                        continue;
+
+                                    if (sz >= d - pad_behind - dtailpad)
+                                        break;
+
+                                    for (int ki = 0; ki < kernel_h; ki++)
+                                    {
+                                        int sy = sy0 + ki;
+
+                                        if (sy < pad_top)
+                                            continue;
+
+                                        if (sy >= h - pad_bottom - htailpad)
+                                            break;
+
+                                        for (int kj = 0; kj < kernel_w; kj++)
+                                        {
+                                            int sx = sx0 + kj;
+
+                                            if (sx < pad_left)
+                                                continue;
+
+                                            if (sx >= w - pad_right - wtailpad)
+                                                break;
+
+                                            __m512 _val = _mm512_loadu_ps(m.depth(sz).row(sy) + sx * 16);
+                                            _sum = _mm512_add_ps(_sum, _val);
+                                            area += 1;
+                                        }
+                                    }
+                                }
+
+                                __m512 _inv_area = _mm512_set1_ps(1.f / area);
+                                __m512 _avg = _mm512_mul_ps(_sum, _inv_area);
+                                _mm512_storeu_ps(outptr, _avg);
+                                outptr += 16;
+                            }
+                        }
+                    }
+                }
+            }
+            else // if (avgpool_count_include_pad == 1)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_bordered.channel(q);
+                    float* outptr = top_blob.channel(q);
+
+                    __m512 _inv_maxk = _mm512_set1_ps(1.f / maxk);
+
+                    for (int z = 0; z < outd; z++)
+                    {
+                        for (int i = 0; i < outh; i++)
+                        {
+                            for (int j = 0; j < outw; j++)
+                            {
+                                const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 16;
+
+                                __m512 _sum = _mm512_set1_ps(0.f);
+
+                                for (int k = 0; k < maxk; k++)
+                                {
+                                    __m512 _val = _mm512_loadu_ps(sptr + space_ofs[k] * 16);
+                                    _sum = _mm512_add_ps(_sum, _val);
+                                }
+
+                                __m512 _avg = _mm512_mul_ps(_sum, _inv_maxk);
+                                _mm512_storeu_ps(outptr, _avg);
+                                outptr += 16;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX512F__
+
+    if (elempack == 8)
+    {
+        if (global_pooling)
+        {
+            top_blob.create(channels, elemsize, elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            int size = w * h * d;
+
+            if (pooling_type == PoolMethod_MAX)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m256 _max = _mm256_loadu_ps(ptr);
+                    for (int i = 0; i < size; i++)
+                    {
+                        __m256 _val = _mm256_loadu_ps(ptr);
+                        _max = _mm256_max_ps(_max, _val);
+                        ptr += 8;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm256_storeu_ps(outptr + q * 8, _max);
+                }
+            }
+            else if (pooling_type == PoolMethod_AVE)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m256 _sum = _mm256_set1_ps(0.f);
+                    for (int i = 0; i < size; i++)
+                    {
+                        __m256 _val = _mm256_loadu_ps(ptr);
+                        _sum = _mm256_add_ps(_sum, _val);
+                        ptr += 8;
+                    }
+
+                    __m256 _inv_size = _mm256_set1_ps(1.f / size);
+                    __m256 _avg = _mm256_mul_ps(_sum, _inv_size);
+
+                    float* outptr = top_blob;
+                    _mm256_storeu_ps(outptr + q * 8, _avg);
+                }
+            }
+
+            return 0;
+        }
+
+        Mat bottom_blob_bordered;
+        make_padding(bottom_blob, bottom_blob_bordered, opt);
+        if (bottom_blob_bordered.empty())
+            return -100;
+
+        w = bottom_blob_bordered.w;
+        h = bottom_blob_bordered.h;
+        d = bottom_blob_bordered.d;
+
+        int outw = (w - kernel_w) / stride_w + 1;
+        int outh = (h - kernel_h) / stride_h + 1;
+        int outd = (d - kernel_d) / stride_d + 1;
+
+        top_blob.create(outw, outh, outd, channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int maxk = kernel_w * kernel_h * kernel_d;
+
+        // kernel offsets
+        std::vector<int> _space_ofs(maxk);
+        int* space_ofs = &_space_ofs[0];
+        {
+            int p1 = 0;
+            int p2 = 0;
+            int gap0 = w - kernel_w;
+            int gap1 = h * w - w * kernel_h;
+            for (int z = 0; z < kernel_d; z++)
+            {
+                for (int i = 0; i < kernel_h; i++)
+                {
+                    for (int j = 0; j < kernel_w; j++)
+                    {
+                        space_ofs[p1] = p2;
+                        p1++;
+                        p2++;
+                    }
+                    p2 += gap0;
+                }
+                p2 += gap1;
+            }
+        }
+
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 8;
+
+                            __m256 _max = _mm256_loadu_ps(sptr);
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                __m256 _val = _mm256_loadu_ps(sptr + space_ofs[k] * 8);
+                                _max = _mm256_max_ps(_max, _val);
+                            }
+
+                            _mm256_storeu_ps(outptr, _max);
+                            outptr += 8;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            if (avgpool_count_include_pad == 0)
+            {
+                int wtailpad = 0;
+                int htailpad = 0;
+                int dtailpad = 0;
+
+                if (pad_mode == 0) // full padding
+                {
+                    wtailpad = bottom_blob_bordered.w - bottom_blob.w - pad_left - pad_right;
+                    htailpad = bottom_blob_bordered.h - bottom_blob.h - pad_top - pad_bottom;
+                    dtailpad = bottom_blob_bordered.d - bottom_blob.d - pad_front - pad_behind;
+                }
+
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_bordered.channel(q);
+                    float* outptr = top_blob.channel(q);
+
+                    for (int z = 0; z < outd; z++)
+                    {
+                        int sz0 = z * stride_d;
+
+                        for (int i = 0; i < outh; i++)
+                        {
+                            int sy0 = i * stride_h;
+
+                            for (int j = 0; j < outw; j++)
+                            {
+                                int sx0 = j * stride_w;
+
+                                __m256 _sum = _mm256_set1_ps(0.f);
+                                int area = 0;
+
+                                for (int kd = 0; kd < kernel_d; kd++)
+                                {
+                                    int sz = sz0 + kd;
+
+                                    if (sz < pad_front)
+                                        continue;
+
+                                    if (sz >= d - pad_behind - dtailpad)
+                                        break;
+
+                                    for (int ki = 0; ki < kernel_h; ki++)
+                                    {
+                                        int sy = sy0 + ki;
+
+                                        if (sy < pad_top)
+                                            continue;
+
+                                        if (sy >= h - pad_bottom - htailpad)
+                                            break;
+
+                                        for (int kj = 0; kj < kernel_w; kj++)
+                                        {
+                                            int sx = sx0 + kj;
+
+                                            if (sx < pad_left)
+                                                continue;
+
+                                            if (sx >= w - pad_right - wtailpad)
+                                                break;
+
+                                            __m256 _val = _mm256_loadu_ps(m.depth(sz).row(sy) + sx * 8);
+                                            _sum = _mm256_add_ps(_sum, _val);
+                                            area += 1;
+                                        }
+                                    }
+                                }
+
+                                __m256 _inv_area = _mm256_set1_ps(1.f / area);
+                                __m256 _avg = _mm256_mul_ps(_sum, _inv_area);
+                                _mm256_storeu_ps(outptr, _avg);
+                                outptr += 8;
+                            }
+                        }
+                    }
+                }
+            }
+            else // if (avgpool_count_include_pad == 1)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_bordered.channel(q);
+                    float* outptr = top_blob.channel(q);
+
+                    __m256 _inv_maxk = _mm256_set1_ps(1.f / maxk);
+
+                    for (int z = 0; z < outd; z++)
+                    {
+                        for (int i = 0; i < outh; i++)
+                        {
+                            for (int j = 0; j < outw; j++)
+                            {
+                                const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 8;
+
+                                __m256 _sum = _mm256_set1_ps(0.f);
+
+                                for (int k = 0; k < maxk; k++)
+                                {
+                                    __m256 _val = _mm256_loadu_ps(sptr + space_ofs[k] * 8);
+                                    _sum = _mm256_add_ps(_sum, _val);
+                                }
+
+                                __m256 _avg = _mm256_mul_ps(_sum, _inv_maxk);
+                                _mm256_storeu_ps(outptr, _avg);
+                                outptr += 8;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __AVX__
+
+    if (elempack == 4)
+    {
+        if (global_pooling)
+        {
+            top_blob.create(channels, elemsize, elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            int size = w * h * d;
+
+            if (pooling_type == PoolMethod_MAX)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m128 _max = _mm_loadu_ps(ptr);
+                    for (int i = 0; i < size; i++)
+                    {
+                        __m128 _val = _mm_loadu_ps(ptr);
+                        _max = _mm_max_ps(_max, _val);
+                        ptr += 4;
+                    }
+
+                    float* outptr = top_blob;
+                    _mm_storeu_ps(outptr + q * 4, _max);
+                }
+            }
+            else if (pooling_type == PoolMethod_AVE)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const float* ptr = bottom_blob.channel(q);
+
+                    __m128 _sum = _mm_set1_ps(0.f);
+                    for (int i = 0; i < size; i++)
+                    {
+                        __m128 _val = _mm_loadu_ps(ptr);
+                        _sum = _mm_add_ps(_sum, _val);
+                        ptr += 4;
+                    }
+
+                    __m128 _inv_size = _mm_set1_ps(1.f / size);
+                    __m128 _avg = _mm_mul_ps(_sum, _inv_size);
+
+                    float* outptr = top_blob;
+                    _mm_storeu_ps(outptr + q * 4, _avg);
+                }
+            }
+
+            return 0;
+        }
+
+        Mat bottom_blob_bordered;
+        make_padding(bottom_blob, bottom_blob_bordered, opt);
+        if (bottom_blob_bordered.empty())
+            return -100;
+
+        w = bottom_blob_bordered.w;
+        h = bottom_blob_bordered.h;
+        d = bottom_blob_bordered.d;
+
+        int outw = (w - kernel_w) / stride_w + 1;
+        int outh = (h - kernel_h) / stride_h + 1;
+        int outd = (d - kernel_d) / stride_d + 1;
+
+        top_blob.create(outw, outh, outd, channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int maxk = kernel_w * kernel_h * kernel_d;
+
+        // kernel offsets
+        std::vector<int> _space_ofs(maxk);
+        int* space_ofs = &_space_ofs[0];
+        {
+            int p1 = 0;
+            int p2 = 0;
+            int gap0 = w - kernel_w;
+            int gap1 = h * w - w * kernel_h;
+            for (int z = 0; z < kernel_d; z++)
+            {
+                for (int i = 0; i < kernel_h; i++)
+                {
+                    for (int j = 0; j < kernel_w; j++)
+                    {
+                        space_ofs[p1] = p2;
+                        p1++;
+                        p2++;
+                    }
+                    p2 += gap0;
+                }
+                p2 += gap1;
+            }
+        }
+
+        if (pooling_type == PoolMethod_MAX)
+        {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int q = 0; q < channels; q++)
+            {
+                const Mat m = bottom_blob_bordered.channel(q);
+                float* outptr = top_blob.channel(q);
+
+                for (int z = 0; z < outd; z++)
+                {
+                    for (int i = 0; i < outh; i++)
+                    {
+                        for (int j = 0; j < outw; j++)
+                        {
+                            const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 4;
+
+                            __m128 _max = _mm_loadu_ps(sptr);
+
+                            for (int k = 0; k < maxk; k++)
+                            {
+                                __m128 _val = _mm_loadu_ps(sptr + space_ofs[k] * 4);
+                                _max = _mm_max_ps(_max, _val);
+                            }
+
+                            _mm_storeu_ps(outptr, _max);
+                            outptr += 4;
+                        }
+                    }
+                }
+            }
+        }
+        else if (pooling_type == PoolMethod_AVE)
+        {
+            if (avgpool_count_include_pad == 0)
+            {
+                int wtailpad = 0;
+                int htailpad = 0;
+                int dtailpad = 0;
+
+                if (pad_mode == 0) // full padding
+                {
+                    wtailpad = bottom_blob_bordered.w - bottom_blob.w - pad_left - pad_right;
+                    htailpad = bottom_blob_bordered.h - bottom_blob.h - pad_top - pad_bottom;
+                    dtailpad = bottom_blob_bordered.d - bottom_blob.d - pad_front - pad_behind;
+                }
+
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_bordered.channel(q);
+                    float* outptr = top_blob.channel(q);
+
+                    for (int z = 0; z < outd; z++)
+                    {
+                        int sz0 = z * stride_d;
+
+                        for (int i = 0; i < outh; i++)
+                        {
+                            int sy0 = i * stride_h;
+
+                            for (int j = 0; j < outw; j++)
+                            {
+                                int sx0 = j * stride_w;
+
+                                __m128 _sum = _mm_set1_ps(0.f);
+                                int area = 0;
+
+                                for (int kd = 0; kd < kernel_d; kd++)
+                                {
+                                    int sz = sz0 + kd;
+
+                                    if (sz < pad_front)
+                                        continue;
+
+                                    if (sz >= d - pad_behind - dtailpad)
+                                        break;
+
+                                    for (int ki = 0; ki < kernel_h; ki++)
+                                    {
+                                        int sy = sy0 + ki;
+
+                                        if (sy < pad_top)
+                                            continue;
+
+                                        if (sy >= h - pad_bottom - htailpad)
+                                            break;
+
+                                        for (int kj = 0; kj < kernel_w; kj++)
+                                        {
+                                            int sx = sx0 + kj;
+
+                                            if (sx < pad_left)
+                                                continue;
+
+                                            if (sx >= w - pad_right - wtailpad)
+                                                break;
+
+                                            __m128 _val = _mm_loadu_ps(m.depth(sz).row(sy) + sx * 4);
+                                            _sum = _mm_add_ps(_sum, _val);
+                                            area += 1;
+                                        }
+                                    }
+                                }
+
+                                __m128 _inv_area = _mm_set1_ps(1.f / area);
+                                __m128 _avg = _mm_mul_ps(_sum, _inv_area);
+                                _mm_storeu_ps(outptr, _avg);
+                                outptr += 4;
+                            }
+                        }
+                    }
+                }
+            }
+            else // if (avgpool_count_include_pad == 1)
+            {
+                #pragma omp parallel for num_threads(opt.num_threads)
+                for (int q = 0; q < channels; q++)
+                {
+                    const Mat m = bottom_blob_bordered.channel(q);
+                    float* outptr = top_blob.channel(q);
+
+                    __m128 _inv_maxk = _mm_set1_ps(1.f / maxk);
+
+                    for (int z = 0; z < outd; z++)
+                    {
+                        for (int i = 0; i < outh; i++)
+                        {
+                            for (int j = 0; j < outw; j++)
+                            {
+                                const float* sptr = m.depth(z * stride_d).row(i * stride_h) + j * stride_w * 4;
+
+                                __m128 _sum = _mm_set1_ps(0.f);
+
+                                for (int k = 0; k < maxk; k++)
+                                {
+                                    __m128 _val = _mm_loadu_ps(sptr + space_ofs[k] * 4);
+                                    _sum = _mm_add_ps(_sum, _val);
+                                }
+
+                                __m128 _avg = _mm_mul_ps(_sum, _inv_maxk);
+                                _mm_storeu_ps(outptr, _avg);
+                                outptr += 4;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        return 0;
+    }
+#endif // __SSE2__
+
+    return Pooling3D::forward(bottom_blob, top_blob, opt);
+}
+
+} // namespace ncnn
@@ -0,0 +1,596 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+void rnn_int8_avx512vnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+void rnn_transform_weight_int8_avxvnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_data_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+void rnn_int8_avxvnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+void rnn_transform_weight_int8_avx2(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_data_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+void rnn_int8_avx2(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_XOP && __SSE2__ && !__XOP__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+void rnn_int8_xop(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt);
+#endif
+
+static inline int rnn_int8_weight_row(int q)
+{
+    // units are packed in groups of 16 / 8 / 4 / 1, q is the first unit of a group
+#if __AVX512F__
+    return q / 16 + (q % 16) / 8 + (q % 8) / 4 + q % 4;
+#elif __AVX2__
+    return q / 8 + (q % 8) / 4 + q % 4;
+#elif __SSE2__
+    return q / 4 + q % 4;
+#else
+    return q;
+#endif
+}
+
+static void rnn_transform_weight_int8_group(const Mat& weight_xc, const float* weight_xc_int8_scales, const Mat& weight_hc, const float* weight_hc_int8_scales, const float* bias_c, int q, int n, int size, int num_output, signed char* kptr, float* descales_ptr, float* bias_c_tm)
+{
+    // n units interleaved, two adjacent k per unit for madd on sign extended int16
+    for (int i = 0; i < size; i += 2)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            const signed char* weight_xc_ptr = weight_xc.row<const signed char>(q + j);
+
+            kptr[0] = weight_xc_ptr[i];
+            kptr[1] = i + 1 < size ? weight_xc_ptr[i + 1] : 0;
+            kptr += 2;
+        }
+    }
+
+    for (int i = 0; i < num_output; i += 2)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            const signed char* weight_hc_ptr = weight_hc.row<const signed char>(q + j);
+
+            kptr[0] = weight_hc_ptr[i];
+            kptr[1] = i + 1 < num_output ? weight_hc_ptr[i + 1] : 0;
+            kptr += 2;
+        }
+    }
+
+    for (int j = 0; j < n; j++)
+    {
+        descales_ptr[j] = 1.f / weight_xc_int8_scales[q + j];
+        descales_ptr[n + j] = 1.f / weight_hc_int8_scales[q + j];
+        bias_c_tm[j] = bias_c[q + j];
+    }
+}
+
+static void rnn_transform_weight_int8(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_data_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        rnn_transform_weight_int8_avxvnni(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_data_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        rnn_transform_weight_int8_avx2(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_data_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+    const int size2 = (size + 1) / 2 * 2;
+    const int num_output2 = (num_output + 1) / 2 * 2;
+
+#if __AVX512F__
+    const int elempack = 16;
+#elif __AVX2__
+    const int elempack = 8;
+#elif __SSE2__
+    const int elempack = 4;
+#else
+    const int elempack = 1;
+#endif
+
+    const int rows = rnn_int8_weight_row(num_output);
+
+    weight_data_tm.create(size2 + num_output2, rows, num_directions, (size_t)elempack, elempack);
+    weight_data_tm_int8_descales.create(2 * elempack, rows, num_directions);
+    bias_c_tm.create(num_output, 1, num_directions);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const Mat weight_xc_dr = weight_xc.channel(dr);
+        const Mat weight_hc_dr = weight_hc.channel(dr);
+        const float* bias_c_dr = bias_c.channel(dr);
+        const float* weight_xc_int8_scales_ptr = weight_xc_int8_scales.row(dr);
+        const float* weight_hc_int8_scales_ptr = weight_hc_int8_scales.row(dr);
+
+        Mat weight_data_tm_dr = weight_data_tm.channel(dr);
+        Mat weight_data_tm_int8_descales_dr = weight_data_tm_int8_descales.channel(dr);
+        float* bias_c_tm_dr = bias_c_tm.channel(dr);
+
+        int q = 0;
+#if __AVX512F__
+        for (; q + 15 < num_output; q += 16)
+        {
+            const int row = rnn_int8_weight_row(q);
+            rnn_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 16, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_tm_dr + q);
+        }
+#endif // __AVX512F__
+#if __AVX2__
+        for (; q + 7 < num_output; q += 8)
+        {
+            const int row = rnn_int8_weight_row(q);
+            rnn_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 8, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_tm_dr + q);
+        }
+#endif // __AVX2__
+#if __SSE2__
+        for (; q + 3 < num_output; q += 4)
+        {
+            const int row = rnn_int8_weight_row(q);
+            rnn_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 4, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_tm_dr + q);
+        }
+#endif // __SSE2__
+        for (; q < num_output; q++)
+        {
+            const int row = rnn_int8_weight_row(q);
+            rnn_transform_weight_int8_group(weight_xc_dr, weight_xc_int8_scales_ptr, weight_hc_dr, weight_hc_int8_scales_ptr, bias_c_dr, q, 1, size, num_output, weight_data_tm_dr.row<signed char>(row), weight_data_tm_int8_descales_dr.row(row), bias_c_tm_dr + q);
+        }
+    }
+}
+
+static float rnn_dynamic_quantize_get_absmax(const float* ptr, int size)
+{
+    float absmax = 0.f;
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _absmax_avx512 = _mm512_set1_ps(0.f);
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_loadu_ps(ptr);
+        _absmax_avx512 = _mm512_max_ps(_absmax_avx512, abs512_ps(_p));
+        ptr += 16;
+    }
+    absmax = std::max(absmax, _mm512_comp_reduce_max_ps(_absmax_avx512));
+#endif // __AVX512F__
+    __m256 _absmax_avx = _mm256_set1_ps(0.f);
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_loadu_ps(ptr);
+        _absmax_avx = _mm256_max_ps(_absmax_avx, abs256_ps(_p));
+        ptr += 8;
+    }
+    absmax = std::max(absmax, _mm256_reduce_max_ps(_absmax_avx));
+#endif // __AVX__
+    __m128 _absmax = _mm_set1_ps(0.f);
+    for (; i + 3 < size; i += 4)
+    {
+        __m128 _p = _mm_loadu_ps(ptr);
+        _absmax = _mm_max_ps(_absmax, abs_ps(_p));
+        ptr += 4;
+    }
+    absmax = std::max(absmax, _mm_reduce_max_ps(_absmax));
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        absmax = std::max(absmax, (float)fabs(*ptr));
+        ptr++;
+    }
+
+    return absmax;
+}
+
+static void rnn_dynamic_quantize_scale2int8(const float* ptr, int size, float scale, signed char* outptr)
+{
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _scale_avx512 = _mm512_set1_ps(scale);
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_loadu_ps(ptr);
+        _p = _mm512_mul_ps(_p, _scale_avx512);
+        _mm_storeu_si128((__m128i*)outptr, float2int8_avx512(_p));
+        ptr += 16;
+        outptr += 16;
+    }
+#endif // __AVX512F__
+    __m256 _scale_avx = _mm256_set1_ps(scale);
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_loadu_ps(ptr);
+        _p = _mm256_mul_ps(_p, _scale_avx);
+        *(int64_t*)outptr = float2int8_avx(_p);
+        ptr += 8;
+        outptr += 8;
+    }
+#endif // __AVX__
+    __m128 _scale = _mm_set1_ps(scale);
+    for (; i + 3 < size; i += 4)
+    {
+        __m128 _p = _mm_loadu_ps(ptr);
+        _p = _mm_mul_ps(_p, _scale);
+        *(int32_t*)outptr = float2int8_sse(_p);
+        ptr += 4;
+        outptr += 4;
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        *outptr++ = float2int8(*ptr++ * scale);
+    }
+}
+
+static void rnn_int8_widen(const signed char* ptr, int size, short* outptr)
+{
+    int i = 0;
+#if __SSE2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m128i _p = _mm_loadl_epi64((const __m128i*)ptr);
+#if __SSE4_1__
+        _p = _mm_cvtepi8_epi16(_p);
+#else
+        _p = _mm_unpacklo_epi8(_p, _mm_cmpgt_epi8(_mm_setzero_si128(), _p));
+#endif
+        _mm_storeu_si128((__m128i*)outptr, _p);
+        ptr += 8;
+        outptr += 8;
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        *outptr++ = *ptr++;
+    }
+
+    // zero the odd tail of the last k pair
+    if (size % 2 == 1)
+        *outptr = 0;
+}
+
+static void rnn_int8(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int reverse, const Mat& weight_data_tm, const Mat& weight_data_tm_int8_descales, const Mat& bias_c, Mat& hidden_state, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        rnn_int8_avx512vnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        rnn_int8_avxvnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        rnn_int8_avx2(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_XOP && __SSE2__ && !__XOP__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_xop())
+    {
+        rnn_int8_xop(bottom_blob_int8, bottom_blob_int8_descales, top_blob, reverse, weight_data_tm, weight_data_tm_int8_descales, bias_c, hidden_state, opt);
+        return;
+    }
+#endif
+
+    int size = bottom_blob_int8.w;
+    int T = bottom_blob_int8.h;
+
+    int num_output = top_blob.w;
+
+    const int size2 = (size + 1) / 2 * 2;
+    const int num_output2 = (num_output + 1) / 2 * 2;
+
+    // x_t and quantized h_{t-1} sign extended to int16
+    Mat xh_int16(size2 + num_output2, (size_t)2u, 1, opt.workspace_allocator);
+
+    Mat hidden_state_int8(num_output, (size_t)1u, 1, opt.workspace_allocator);
+
+    // unroll
+    for (int t = 0; t < T; t++)
+    {
+        int ti = reverse ? T - 1 - t : t;
+
+        // dynamic quantize hidden_state
+        float descale_h = 1.f;
+        {
+            const float absmax = rnn_dynamic_quantize_get_absmax(hidden_state, num_output);
+
+            if (absmax == 0.f)
+            {
+                hidden_state_int8.fill<signed char>(0);
+            }
+            else
+            {
+                descale_h = absmax / 127.f;
+                rnn_dynamic_quantize_scale2int8(hidden_state, num_output, 127.f / absmax, hidden_state_int8);
+            }
+        }
+
+        short* x16 = xh_int16;
+        short* h16 = x16 + size2;
+        rnn_int8_widen(bottom_blob_int8.row<const signed char>(ti), size, x16);
+        rnn_int8_widen(hidden_state_int8, num_output, h16);
+
+        const int* xx = (const int*)x16;
+        const int* hh = (const int*)h16;
+
+        const float descale_x = bottom_blob_int8_descales[ti];
+
+        float* hidden_ptr = hidden_state;
+        float* output_data = top_blob.row(ti);
+
+        // every unit only reads the quantized hidden state
+        // so h_t can be written in place
+        int remain_num_output_start = 0;
+#if __SSE2__
+#if __AVX2__
+#if __AVX512F__
+        int nn_num_output = num_output >> 4;
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = qq * 16;
+
+            const signed char* kptr = weight_data_tm.row<const signed char>(rnn_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(rnn_int8_weight_row(q));
+
+            __m512i _Hx0 = _mm512_setzero_si512();
+            __m512i _Hx1 = _mm512_setzero_si512();
+            int i = 0;
+            for (; i + 1 < size2 / 2; i += 2)
+            {
+                __m512i _w0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+                __m512i _w1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 32)));
+                _Hx0 = _mm512_comp_dpwssd_epi32(_Hx0, _w0, _mm512_set1_epi32(xx[i]));
+                _Hx1 = _mm512_comp_dpwssd_epi32(_Hx1, _w1, _mm512_set1_epi32(xx[i + 1]));
+
+                kptr += 64;
+            }
+            for (; i < size2 / 2; i++)
+            {
+                __m512i _w = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+                _Hx0 = _mm512_comp_dpwssd_epi32(_Hx0, _w, _mm512_set1_epi32(xx[i]));
+
+                kptr += 32;
+            }
+
+            __m512i _Hh0 = _mm512_setzero_si512();
+            __m512i _Hh1 = _mm512_setzero_si512();
+            i = 0;
+            for (; i + 1 < num_output2 / 2; i += 2)
+            {
+                __m512i _w0 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+                __m512i _w1 = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 32)));
+                _Hh0 = _mm512_comp_dpwssd_epi32(_Hh0, _w0, _mm512_set1_epi32(hh[i]));
+                _Hh1 = _mm512_comp_dpwssd_epi32(_Hh1, _w1, _mm512_set1_epi32(hh[i + 1]));
+
+                kptr += 64;
+            }
+            for (; i < num_output2 / 2; i++)
+            {
+                __m512i _w = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+                _Hh0 = _mm512_comp_dpwssd_epi32(_Hh0, _w, _mm512_set1_epi32(hh[i]));
+
+                kptr += 32;
+            }
+
+            __m512i _Hx = _mm512_add_epi32(_Hx0, _Hx1);
+            __m512i _Hh = _mm512_add_epi32(_Hh0, _Hh1);
+
+            __m512 _H = _mm512_loadu_ps((const float*)bias_c + q);
+            _H = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Hx), _mm512_mul_ps(_mm512_set1_ps(descale_x), _mm512_loadu_ps(descales_ptr)), _H);
+            _H = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_Hh), _mm512_mul_ps(_mm512_set1_ps(descale_h), _mm512_loadu_ps(descales_ptr + 16)), _H);
+
+            _H = tanh_avx512(_H);
+
+            _mm512_storeu_ps(hidden_ptr + q, _H);
+            _mm512_storeu_ps(output_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 4;
+        nn_num_output = (num_output - remain_num_output_start) >> 3;
+#else
+        int nn_num_output = num_output >> 3;
+#endif // __AVX512F__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = remain_num_output_start + qq * 8;
+
+            const signed char* kptr = weight_data_tm.row<const signed char>(rnn_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(rnn_int8_weight_row(q));
+
+            __m256i _Hx0 = _mm256_setzero_si256();
+            __m256i _Hx1 = _mm256_setzero_si256();
+            int i = 0;
+            for (; i + 1 < size2 / 2; i += 2)
+            {
+                __m256i _w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+                __m256i _w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 16)));
+                _Hx0 = _mm256_comp_dpwssd_epi32(_Hx0, _w0, _mm256_set1_epi32(xx[i]));
+                _Hx1 = _mm256_comp_dpwssd_epi32(_Hx1, _w1, _mm256_set1_epi32(xx[i + 1]));
+
+                kptr += 32;
+            }
+            for (; i < size2 / 2; i++)
+            {
+                __m256i _w = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+                _Hx0 = _mm256_comp_dpwssd_epi32(_Hx0, _w, _mm256_set1_epi32(xx[i]));
+
+                kptr += 16;
+            }
+
+            __m256i _Hh0 = _mm256_setzero_si256();
+            __m256i _Hh1 = _mm256_setzero_si256();
+            i = 0;
+            for (; i + 1 < num_output2 / 2; i += 2)
+            {
+                __m256i _w0 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+                __m256i _w1 = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 16)));
+                _Hh0 = _mm256_comp_dpwssd_epi32(_Hh0, _w0, _mm256_set1_epi32(hh[i]));
+                _Hh1 = _mm256_comp_dpwssd_epi32(_Hh1, _w1, _mm256_set1_epi32(hh[i + 1]));
+
+                kptr += 32;
+            }
+            for (; i < num_output2 / 2; i++)
+            {
+                __m256i _w = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+                _Hh0 = _mm256_comp_dpwssd_epi32(_Hh0, _w, _mm256_set1_epi32(hh[i]));
+
+                kptr += 16;
+            }
+
+            __m256i _Hx = _mm256_add_epi32(_Hx0, _Hx1);
+            __m256i _Hh = _mm256_add_epi32(_Hh0, _Hh1);
+
+            __m256 _H = _mm256_loadu_ps((const float*)bias_c + q);
+            _H = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Hx), _mm256_mul_ps(_mm256_set1_ps(descale_x), _mm256_loadu_ps(descales_ptr)), _H);
+            _H = _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_Hh), _mm256_mul_ps(_mm256_set1_ps(descale_h), _mm256_loadu_ps(descales_ptr + 8)), _H);
+
+            _H = tanh_avx(_H);
+
+            _mm256_storeu_ps(hidden_ptr + q, _H);
+            _mm256_storeu_ps(output_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 3;
+        nn_num_output = (num_output - remain_num_output_start) >> 2;
+#else
+        int nn_num_output = num_output >> 2;
+#endif // __AVX2__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int qq = 0; qq < nn_num_output; qq++)
+        {
+            int q = remain_num_output_start + qq * 4;
+
+            const signed char* kptr = weight_data_tm.row<const signed char>(rnn_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(rnn_int8_weight_row(q));
+
+            __m128i _Hx0 = _mm_setzero_si128();
+            __m128i _Hx1 = _mm_setzero_si128();
+            int i = 0;
+            for (; i + 1 < size2 / 2; i += 2)
+            {
+                __m128i _w01 = _mm_loadu_si128((const __m128i*)kptr);
+#if __SSE4_1__
+                __m128i _w0 = _mm_cvtepi8_epi16(_w01);
+                __m128i _w1 = _mm_cvtepi8_epi16(_mm_unpackhi_epi64(_w01, _w01));
+#else
+                __m128i _extw01 = _mm_cmpgt_epi8(_mm_setzero_si128(), _w01);
+                __m128i _w0 = _mm_unpacklo_epi8(_w01, _extw01);
+                __m128i _w1 = _mm_unpackhi_epi8(_w01, _extw01);
+#endif
+                _Hx0 = _mm_comp_dpwssd_epi32(_Hx0, _w0, _mm_set1_epi32(xx[i]));
+                _Hx1 = _mm_comp_dpwssd_epi32(_Hx1, _w1, _mm_set1_epi32(xx[i + 1]));
+
+                kptr += 16;
+            }
+            for (; i < size2 / 2; i++)
+            {
+                __m128i _w = _mm_loadl_epi64((const __m128i*)kptr);
+#if __SSE4_1__
+                _w = _mm_cvtepi8_epi16(_w);
+#else
+                _w = _mm_unpacklo_epi8(_w, _mm_cmpgt_epi8(_mm_setzero_si128(), _w));
+#endif
+                _Hx0 = _mm_comp_dpwssd_epi32(_Hx0, _w, _mm_set1_epi32(xx[i]));
+
+                kptr += 8;
+            }
+
+            __m128i _Hh0 = _mm_setzero_si128();
+            __m128i _Hh1 = _mm_setzero_si128();
+            i = 0;
+            for (; i + 1 < num_output2 / 2; i += 2)
+            {
+                __m128i _w01 = _mm_loadu_si128((const __m128i*)kptr);
+#if __SSE4_1__
+                __m128i _w0 = _mm_cvtepi8_epi16(_w01);
+                __m128i _w1 = _mm_cvtepi8_epi16(_mm_unpackhi_epi64(_w01, _w01));
+#else
+                __m128i _extw01 = _mm_cmpgt_epi8(_mm_setzero_si128(), _w01);
+                __m128i _w0 = _mm_unpacklo_epi8(_w01, _extw01);
+                __m128i _w1 = _mm_unpackhi_epi8(_w01, _extw01);
+#endif
+                _Hh0 = _mm_comp_dpwssd_epi32(_Hh0, _w0, _mm_set1_epi32(hh[i]));
+                _Hh1 = _mm_comp_dpwssd_epi32(_Hh1, _w1, _mm_set1_epi32(hh[i + 1]));
+
+                kptr += 16;
+            }
+            for (; i < num_output2 / 2; i++)
+            {
+                __m128i _w = _mm_loadl_epi64((const __m128i*)kptr);
+#if __SSE4_1__
+                _w = _mm_cvtepi8_epi16(_w);
+#else
+                _w = _mm_unpacklo_epi8(_w, _mm_cmpgt_epi8(_mm_setzero_si128(), _w));
+#endif
+                _Hh0 = _mm_comp_dpwssd_epi32(_Hh0, _w, _mm_set1_epi32(hh[i]));
+
+                kptr += 8;
+            }
+
+            __m128i _Hx = _mm_add_epi32(_Hx0, _Hx1);
+            __m128i _Hh = _mm_add_epi32(_Hh0, _Hh1);
+
+            __m128 _H = _mm_loadu_ps((const float*)bias_c + q);
+            _H = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Hx), _mm_mul_ps(_mm_set1_ps(descale_x), _mm_loadu_ps(descales_ptr)), _H);
+            _H = _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_Hh), _mm_mul_ps(_mm_set1_ps(descale_h), _mm_loadu_ps(descales_ptr + 4)), _H);
+
+            _H = tanh_sse(_H);
+
+            _mm_storeu_ps(hidden_ptr + q, _H);
+            _mm_storeu_ps(output_data + q, _H);
+        }
+        remain_num_output_start += nn_num_output << 2;
+#endif // __SSE2__
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = remain_num_output_start; q < num_output; q++)
+        {
+            const signed char* kptr = weight_data_tm.row<const signed char>(rnn_int8_weight_row(q));
+            const float* descales_ptr = weight_data_tm_int8_descales.row(rnn_int8_weight_row(q));
+
+            int Hx = 0;
+            for (int i = 0; i < size2; i += 2)
+            {
+                Hx += kptr[0] * x16[i] + kptr[1] * x16[i + 1];
+                kptr += 2;
+            }
+
+            int Hh = 0;
+            for (int i = 0; i < num_output2; i += 2)
+            {
+                Hh += kptr[0] * h16[i] + kptr[1] * h16[i + 1];
+                kptr += 2;
+            }
+
+            float H = bias_c[q] + Hx * (descale_x * descales_ptr[0]) + Hh * (descale_h * descales_ptr[1]);
+
+            H = tanhf(H);
+
+            hidden_ptr[q] = H;
+            output_data[q] = H;
+        }
+    }
+}
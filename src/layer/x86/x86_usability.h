@@ -1819,6 +1819,37 @@ static NCNN_FORCEINLINE __m512i float2bfloat_avx512(const __m512& v0, const __m5
     return _v;
 }
 
+#if __AMX_TILE__
+// memory layout consumed by ldtilecfg
+struct amx_tilecfg
+{
+    unsigned char palette_id;
+    unsigned char start_row;
+    unsigned char reserved[14];
+    unsigned short colsb[16];
+    unsigned char rows[16];
+};
+
+static NCNN_FORCEINLINE void amx_tilecfg_init(amx_tilecfg& cfg)
+{
+    cfg.palette_id = 1;
+    cfg.start_row = 0;
+    for (int i = 0; i < 14; i++)
+        cfg.reserved[i] = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        cfg.colsb[i] = 0;
+        cfg.rows[i] = 0;
+    }
+}
+
+static NCNN_FORCEINLINE void amx_tilecfg_set(amx_tilecfg& cfg, int tile, int rows, int colsb)
+{
+    cfg.rows[tile] = (unsigned char)rows;
+    cfg.colsb[tile] = (unsigned short)colsb;
+}
+#endif // __AMX_TILE__
+
 #endif // __AVX512F__
 #endif // __AVX2__
 #endif // __AVX__
@@ -228,6 +228,10 @@ public:
         PIXEL_RGBA = 4,
         PIXEL_BGRA = 5,
 
+        // yuv420sp sources are only accepted by from_pixels_preprocess
+        PIXEL_YUV420SP = 6,      // nv21, full y plane followed by interleaved vu
+        PIXEL_YUV420SP_NV12 = 7, // nv12, full y plane followed by interleaved uv
+
         PIXEL_RGB2BGR = PIXEL_RGB | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
         PIXEL_RGB2GRAY = PIXEL_RGB | (PIXEL_GRAY << PIXEL_CONVERT_SHIFT),
         PIXEL_RGB2RGBA = PIXEL_RGB | (PIXEL_RGBA << PIXEL_CONVERT_SHIFT),
@@ -252,6 +256,11 @@ public:
         PIXEL_BGRA2BGR = PIXEL_BGRA | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
         PIXEL_BGRA2GRAY = PIXEL_BGRA | (PIXEL_GRAY << PIXEL_CONVERT_SHIFT),
         PIXEL_BGRA2RGBA = PIXEL_BGRA | (PIXEL_RGBA << PIXEL_CONVERT_SHIFT),
+
+        PIXEL_YUV420SP2RGB = PIXEL_YUV420SP | (PIXEL_RGB << PIXEL_CONVERT_SHIFT),
+        PIXEL_YUV420SP2BGR = PIXEL_YUV420SP | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
+        PIXEL_YUV420SP_NV12_2RGB = PIXEL_YUV420SP_NV12 | (PIXEL_RGB << PIXEL_CONVERT_SHIFT),
+        PIXEL_YUV420SP_NV12_2BGR = PIXEL_YUV420SP_NV12 | (PIXEL_BGR << PIXEL_CONVERT_SHIFT),
     };
     // convenient construct from pixel data
     static Mat from_pixels(const unsigned char* pixels, int type, int w, int h, Allocator* allocator = 0);
@@ -621,8 +630,55 @@ NCNN_EXPORT void resize_bilinear_c1(const unsigned char* src, int srcw, int srch
 NCNN_EXPORT void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride);
 NCNN_EXPORT void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride);
 NCNN_EXPORT void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride);
+// image pixel bilinear resize with stride(bytes-per-row) parameter, images of 256x256 and larger are split into bands of rows over num_threads threads
+NCNN_EXPORT void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads);
+NCNN_EXPORT void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads);
+NCNN_EXPORT void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads);
+NCNN_EXPORT void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads);
 // image pixel bilinear resize, convenient wrapper for yuv420sp(nv21/nv12)
 NCNN_EXPORT void resize_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h);
+
+// parameters of from_pixels_preprocess
+class NCNN_EXPORT PixelPreprocess
+{
+public:
+    PixelPreprocess();
+
+    // keep aspect ratio, center the image in the target size and fill the rest with border_vals
+    // target_width and target_height must be set before
+    void set_letterbox(int w, int h);
+
+public:
+    int target_width;
+    int target_height;
+
+    // 2x3 transform from target to source pixel coordinates, the same convention as warpaffine_bilinear
+    // all zero means stretching the whole source image to the target size
+    float tm[6];
+
+    // per output channel value in pixel units for target pixels outside the source image
+    float border_vals[4];
+
+    // optional, the same as substract_mean_normalize
+    const float* mean_vals;
+    const float* norm_vals;
+
+    // 1 or 4, 4 requires a four channel output
+    int elempack;
+
+    // output storage, 32 for fp32, 16 for fp16, 8 for int8
+    int elembits;
+
+    // int8 value = round(normalized value * int8_scale)
+    float int8_scale;
+
+    int num_threads;
+};
+
+// fused convert, bilinear resample, mean/norm, packing and storage cast in one pass over the target rows
+// type is one of the from_pixels types or PIXEL_YUV420SP2RGB and friends
+// for yuv420sp the uv plane starts right after h rows of stride bytes
+NCNN_EXPORT Mat from_pixels_preprocess(const unsigned char* pixels, int type, int w, int h, int stride, const PixelPreprocess& pp, Allocator* allocator = 0);
 #endif // NCNN_PIXEL
 #if NCNN_PIXEL_ROTATE
 // type is the from type, 6 means rotating from 6 to 1
@@ -666,6 +722,11 @@ NCNN_EXPORT void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int
 NCNN_EXPORT void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type = 0, unsigned int v = 0);
 NCNN_EXPORT void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type = 0, unsigned int v = 0);
 NCNN_EXPORT void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type = 0, unsigned int v = 0);
+// image pixel bilinear warpaffine with stride(bytes-per-row) parameter, images of 256x256 and larger are split into bands of rows over num_threads threads
+NCNN_EXPORT void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads);
+NCNN_EXPORT void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads);
+NCNN_EXPORT void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads);
+NCNN_EXPORT void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads);
 // image pixel bilinear warpaffine, convenient wrapper for yuv420sp(nv21/nv12), set -233 for transparent border color, the color YUV_ is little-endian encoded
 NCNN_EXPORT void warpaffine_bilinear_yuv420sp(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int type = 0, unsigned int v = 0);
 #endif // NCNN_PIXEL_AFFINE
@@ -8,11 +8,16 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#include "cpu.h"
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL
+#if __SSE2__
+#include "mat_pixel_x86.h"
+#endif // __SSE2__
+
 static int from_rgb(const unsigned char* rgb, int w, int h, int stride, Mat& m, Allocator* allocator)
 {
     m.create(w, h, 3, 4u, allocator);
@@ -108,6 +113,17 @@ static int from_rgb(const unsigned char* rgb, int w, int h, int stride, Mat& m,
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c3_sse(rgb, ptr0, ptr1, ptr2, remain);
+
+            rgb += nn * 3;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgb[0];
@@ -180,6 +196,17 @@ static void to_rgb(const Mat& m, unsigned char* rgb, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c3_sse(ptr0, ptr1, ptr2, rgb, remain);
+
+            rgb += nn * 3;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgb[0] = SATURATE_CAST_UCHAR(*ptr0);
@@ -273,6 +300,15 @@ static int from_gray(const unsigned char* gray, int w, int h, int stride, Mat& m
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c1_sse(gray, ptr, remain);
+
+            gray += nn;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = *gray;
@@ -328,6 +364,15 @@ static void to_gray(const Mat& m, unsigned char* gray, int stride)
             ptr += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c1_sse(ptr, gray, remain);
+
+            gray += nn;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *gray = SATURATE_CAST_UCHAR(*ptr);
@@ -451,6 +496,18 @@ static int from_rgba(const unsigned char* rgba, int w, int h, int stride, Mat& m
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c4_sse(rgba, ptr0, ptr1, ptr2, ptr3, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            ptr3 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[0];
@@ -531,6 +588,18 @@ static void to_rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr3 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c4_sse(ptr0, ptr1, ptr2, ptr3, rgba, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            ptr3 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgba[0] = SATURATE_CAST_UCHAR(*ptr0);
@@ -645,6 +714,17 @@ static int from_rgb2bgr(const unsigned char* rgb, int w, int h, int stride, Mat&
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c3_sse(rgb, ptr2, ptr1, ptr0, remain);
+
+            rgb += nn * 3;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgb[2];
@@ -717,6 +797,17 @@ static void to_bgr2rgb(const Mat& m, unsigned char* rgb, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c3_sse(ptr2, ptr1, ptr0, rgb, remain);
+
+            rgb += nn * 3;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgb[2] = SATURATE_CAST_UCHAR(*ptr0);
@@ -821,6 +912,15 @@ static int from_rgb2gray(const unsigned char* rgb, int w, int h, int stride, Mat
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c3_to_gray_sse(rgb, ptr, remain, R2Y, G2Y, B2Y);
+
+            rgb += nn * 3;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((rgb[0] * R2Y + rgb[1] * G2Y + rgb[2] * B2Y) >> Y_shift);
@@ -906,6 +1006,17 @@ static void to_rgb2rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c4_sse(ptr0, ptr1, ptr2, 0, rgba, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgba[0] = SATURATE_CAST_UCHAR(*ptr0);
@@ -1011,6 +1122,15 @@ static int from_bgr2gray(const unsigned char* bgr, int w, int h, int stride, Mat
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c3_to_gray_sse(bgr, ptr, remain, B2Y, G2Y, R2Y);
+
+            bgr += nn * 3;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((bgr[2] * R2Y + bgr[1] * G2Y + bgr[0] * B2Y) >> Y_shift);
@@ -1096,6 +1216,17 @@ static void to_bgr2rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c4_sse(ptr2, ptr1, ptr0, 0, rgba, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgba[0] = SATURATE_CAST_UCHAR(*ptr2);
@@ -1212,6 +1343,17 @@ static int from_gray2rgb(const unsigned char* gray, int w, int h, int stride, Ma
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c1_to_c3_sse(gray, ptr0, ptr1, ptr2, remain);
+
+            gray += nn;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = *gray;
@@ -1293,6 +1435,15 @@ static void to_gray2rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c1_to_c4_sse(ptr, rgba, remain);
+
+            rgba += nn * 4;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             unsigned char gray = SATURATE_CAST_UCHAR(*ptr);
@@ -1405,6 +1556,17 @@ static int from_rgba2rgb(const unsigned char* rgba, int w, int h, int stride, Ma
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c4_to_c3_sse(rgba, ptr0, ptr1, ptr2, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[0];
@@ -1518,6 +1680,17 @@ static int from_rgba2bgr(const unsigned char* rgba, int w, int h, int stride, Ma
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c4_to_c3_sse(rgba, ptr2, ptr1, ptr0, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[2];
@@ -1623,6 +1796,15 @@ static int from_rgba2gray(const unsigned char* rgba, int w, int h, int stride, M
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c4_to_gray_sse(rgba, ptr, remain, R2Y, G2Y, B2Y);
+
+            rgba += nn * 4;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((rgba[0] * R2Y + rgba[1] * G2Y + rgba[2] * B2Y) >> Y_shift);
@@ -1747,6 +1929,18 @@ static int from_rgba2bgra(const unsigned char* rgba, int w, int h, int stride, M
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c4_sse(rgba, ptr2, ptr1, ptr0, ptr3, remain);
+
+            rgba += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            ptr3 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[2];
@@ -1827,6 +2021,18 @@ static void to_rgba2bgra(const Mat& m, unsigned char* bgra, int stride)
             ptr3 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = to_c4_sse(ptr2, ptr1, ptr0, ptr3, bgra, remain);
+
+            bgra += nn * 4;
+            ptr0 += nn;
+            ptr1 += nn;
+            ptr2 += nn;
+            ptr3 += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             bgra[0] = SATURATE_CAST_UCHAR(*ptr2);
@@ -1933,6 +2139,15 @@ static int from_bgra2gray(const unsigned char* bgra, int w, int h, int stride, M
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        {
+            int nn = from_c4_to_gray_sse(bgra, ptr, remain, B2Y, G2Y, R2Y);
+
+            bgra += nn * 4;
+            ptr += nn;
+            remain -= nn;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((bgra[2] * R2Y + bgra[1] * G2Y + bgra[0] * B2Y) >> Y_shift);
@@ -7,11 +7,25 @@
 #endif // __ARM_NEON
 #include <limits.h>
 
+#include "cpu.h"
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL_AFFINE
+#if __SSE2__
+#include "mat_pixel_affine_x86.h"
+#endif // __SSE2__
+
+// split large images into bands of rows when the caller asks for more than one thread
+static int warpaffine_band_count(int w, int h, int num_threads)
+{
+    if (num_threads > 1 && w * h >= 256 * 256)
+        return std::max(std::min(num_threads, h / 16), 1);
+
+    return 1;
+}
+
 void get_rotation_matrix(float angle, float scale, float dx, float dy, float* tm)
 {
     angle *= (float)(3.14159265358979323846 / 180);
@@ -162,11 +176,28 @@ void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, unsign
 
 void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
 {
-    const unsigned char* border_color = (const unsigned char*)&v;
-    const int wgap = stride - w;
+    return warpaffine_bilinear_c1(src, srcw, srch, srcstride, dst, w, h, stride, tm, type, v, 1);
+}
+
+void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
+{
+    return warpaffine_bilinear_c2(src, srcw, srch, srcstride, dst, w, h, stride, tm, type, v, 1);
+}
+
+void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
+{
+    return warpaffine_bilinear_c3(src, srcw, srch, srcstride, dst, w, h, stride, tm, type, v, 1);
+}
+
+void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
+{
+    return warpaffine_bilinear_c4(src, srcw, srch, srcstride, dst, w, h, stride, tm, type, v, 1);
+}
 
+void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads)
+{
+    const unsigned char* border_color = (const unsigned char*)&v;
     const unsigned char* src0 = src;
-    unsigned char* dst0 = dst;
 
 #define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X), SHRT_MIN), SHRT_MAX)
 #define SATURATE_CAST_INT(X)   (int)::std::min(::std::max((int)((X) + ((X) >= 0.f ? 0.5f : -0.5f)), INT_MIN), INT_MAX)
@@ -179,9 +210,14 @@ void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int sr
         bdelta[x] = SATURATE_CAST_INT(tm[3] * x * (1 << 10));
     }
 
-    int y = 0;
-    for (; y < h; y++)
+    // warp large images with rows spread over threads
+    const int nT = warpaffine_band_count(w, h, num_threads);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int y = 0; y < h; y++)
     {
+        unsigned char* dst0 = dst + y * stride;
+
         int X0 = SATURATE_CAST_INT((tm[1] * y + tm[2]) * (1 << 10));
         int Y0 = SATURATE_CAST_INT((tm[4] * y + tm[5]) * (1 << 10));
 
@@ -287,6 +323,10 @@ void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int sr
 
                 vst1_u8(dst0, _dst);
 
+                dst0 += 8;
+#elif __SSE2__
+                warpaffine_bilinear_c1_inside_8_sse(src0, srcstride, X0, Y0, adelta.data() + x, bdelta.data() + x, dst0);
+
                 dst0 += 8;
 #else
                 for (int xi = 0; xi < 8; xi++)
@@ -457,21 +497,16 @@ void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int sr
 
             dst0 += 1;
         }
-
-        dst0 += wgap;
     }
 
 #undef SATURATE_CAST_SHORT
 #undef SATURATE_CAST_INT
 }
 
-void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
+void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads)
 {
     const unsigned char* border_color = (const unsigned char*)&v;
-    const int wgap = stride - w * 2;
-
     const unsigned char* src0 = src;
-    unsigned char* dst0 = dst;
 
 #define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X), SHRT_MIN), SHRT_MAX)
 #define SATURATE_CAST_INT(X)   (int)::std::min(::std::max((int)((X) + ((X) >= 0.f ? 0.5f : -0.5f)), INT_MIN), INT_MAX)
@@ -484,9 +519,14 @@ void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int sr
         bdelta[x] = SATURATE_CAST_INT(tm[3] * x * (1 << 10));
     }
 
-    int y = 0;
-    for (; y < h; y++)
+    // warp large images with rows spread over threads
+    const int nT = warpaffine_band_count(w, h, num_threads);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int y = 0; y < h; y++)
     {
+        unsigned char* dst0 = dst + y * stride;
+
         int X0 = SATURATE_CAST_INT((tm[1] * y + tm[2]) * (1 << 10));
         int Y0 = SATURATE_CAST_INT((tm[4] * y + tm[5]) * (1 << 10));
 
@@ -605,6 +645,10 @@ void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int sr
 
                 vst2_u8(dst0, _dst);
 
+                dst0 += 2 * 8;
+#elif __SSE2__
+                warpaffine_bilinear_c2_inside_8_sse(src0, srcstride, X0, Y0, adelta.data() + x, bdelta.data() + x, dst0);
+
                 dst0 += 2 * 8;
 #else
                 for (int xi = 0; xi < 8; xi++)
@@ -784,21 +828,16 @@ void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int sr
 
             dst0 += 2;
         }
-
-        dst0 += wgap;
     }
 
 #undef SATURATE_CAST_SHORT
 #undef SATURATE_CAST_INT
 }
 
-void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
+void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads)
 {
     const unsigned char* border_color = (const unsigned char*)&v;
-    const int wgap = stride - w * 3;
-
     const unsigned char* src0 = src;
-    unsigned char* dst0 = dst;
 
 #define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X), SHRT_MIN), SHRT_MAX)
 #define SATURATE_CAST_INT(X)   (int)::std::min(::std::max((int)((X) + ((X) >= 0.f ? 0.5f : -0.5f)), INT_MIN), INT_MAX)
@@ -811,9 +850,14 @@ void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int sr
         bdelta[x] = SATURATE_CAST_INT(tm[3] * x * (1 << 10));
     }
 
-    int y = 0;
-    for (; y < h; y++)
+    // warp large images with rows spread over threads
+    const int nT = warpaffine_band_count(w, h, num_threads);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int y = 0; y < h; y++)
     {
+        unsigned char* dst0 = dst + y * stride;
+
         int X0 = SATURATE_CAST_INT((tm[1] * y + tm[2]) * (1 << 10));
         int Y0 = SATURATE_CAST_INT((tm[4] * y + tm[5]) * (1 << 10));
 
@@ -965,6 +1009,10 @@ void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int sr
 
                 vst3_u8(dst0, _dst);
 
+                dst0 += 3 * 8;
+#elif __SSE2__
+                warpaffine_bilinear_c3_inside_8_sse(src0, srcstride, X0, Y0, adelta.data() + x, bdelta.data() + x, dst0);
+
                 dst0 += 3 * 8;
 #else
                 for (int xi = 0; xi < 8; xi++)
@@ -1151,21 +1199,16 @@ void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int sr
 
             dst0 += 3;
         }
-
-        dst0 += wgap;
     }
 
 #undef SATURATE_CAST_SHORT
 #undef SATURATE_CAST_INT
 }
 
-void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v)
+void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, const float* tm, int type, unsigned int v, int num_threads)
 {
     const unsigned char* border_color = (const unsigned char*)&v;
-    const int wgap = stride - w * 4;
-
     const unsigned char* src0 = src;
-    unsigned char* dst0 = dst;
 
 #define SATURATE_CAST_SHORT(X) (short)::std::min(::std::max((int)(X), SHRT_MIN), SHRT_MAX)
 #define SATURATE_CAST_INT(X)   (int)::std::min(::std::max((int)((X) + ((X) >= 0.f ? 0.5f : -0.5f)), INT_MIN), INT_MAX)
@@ -1178,9 +1221,14 @@ void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int sr
         bdelta[x] = SATURATE_CAST_INT(tm[3] * x * (1 << 10));
     }
 
-    int y = 0;
-    for (; y < h; y++)
+    // warp large images with rows spread over threads
+    const int nT = warpaffine_band_count(w, h, num_threads);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int y = 0; y < h; y++)
     {
+        unsigned char* dst0 = dst + y * stride;
+
         int X0 = SATURATE_CAST_INT((tm[1] * y + tm[2]) * (1 << 10));
         int Y0 = SATURATE_CAST_INT((tm[4] * y + tm[5]) * (1 << 10));
 
@@ -1367,6 +1415,10 @@ void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int sr
 
                 vst4_u8(dst0, _dst);
 
+                dst0 += 4 * 8;
+#elif __SSE2__
+                warpaffine_bilinear_c4_inside_8_sse(src0, srcstride, X0, Y0, adelta.data() + x, bdelta.data() + x, dst0);
+
                 dst0 += 4 * 8;
 #else
                 for (int xi = 0; xi < 8; xi++)
@@ -1560,8 +1612,6 @@ void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int sr
 
             dst0 += 4;
         }
-
-        dst0 += wgap;
     }
 
 #undef SATURATE_CAST_SHORT
@@ -0,0 +1,341 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// x86 kernels for the all inside blocks of the fixed point bilinear warpaffine in mat_pixel_affine.cpp
+// every kernel interpolates 8 destination pixels whose four source taps are inside the image
+// the arithmetic is the same as the scalar code, results are bit-exact
+//
+// the taps are fetched as 32bit words, row sy words are read forward and row sy + 1 words
+// are read backward where needed, so no load goes past the last source row
+
+#if __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+void warpaffine_bilinear_c1_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0);
+void warpaffine_bilinear_c2_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0);
+void warpaffine_bilinear_c3_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0);
+void warpaffine_bilinear_c4_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0);
+#endif
+
+#if __AVX2__
+// source offsets and the (alpha0, alpha1) (beta0, beta1) 16bit weight pairs of 8 pixels
+static inline void warpaffine_bilinear_coords_avx2(int X0, int Y0, const int* adelta, const int* bdelta, int srcstride, int cn, __m256i& _ofs, __m256i& _alpha, __m256i& _beta)
+{
+    __m256i _X = _mm256_add_epi32(_mm256_set1_epi32(X0), _mm256_loadu_si256((const __m256i*)adelta));
+    __m256i _Y = _mm256_add_epi32(_mm256_set1_epi32(Y0), _mm256_loadu_si256((const __m256i*)bdelta));
+
+    _ofs = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srai_epi32(_Y, 10), _mm256_set1_epi32(srcstride)), _mm256_mullo_epi32(_mm256_srai_epi32(_X, 10), _mm256_set1_epi32(cn)));
+
+    __m256i _fx = _mm256_and_si256(_X, _mm256_set1_epi32((1 << 10) - 1));
+    __m256i _fy = _mm256_and_si256(_Y, _mm256_set1_epi32((1 << 10) - 1));
+    _alpha = _mm256_or_si256(_mm256_sub_epi32(_mm256_set1_epi32(1 << 10), _fx), _mm256_slli_epi32(_fx, 16));
+    _beta = _mm256_or_si256(_mm256_sub_epi32(_mm256_set1_epi32(1 << 10), _fy), _mm256_slli_epi32(_fy, 16));
+}
+
+// ((a0 * alpha0 + a1 * alpha1) >> 5 * beta0 + (b0 * alpha0 + b1 * alpha1) >> 5 * beta1) >> 15
+static inline __m256i warpaffine_bilinear_interp_avx2(__m256i _a, __m256i _b, __m256i _alpha, __m256i _beta)
+{
+    __m256i _ta = _mm256_srai_epi32(_mm256_madd_epi16(_a, _alpha), 5);
+    __m256i _tb = _mm256_srai_epi32(_mm256_madd_epi16(_b, _alpha), 5);
+    return _mm256_srai_epi32(_mm256_madd_epi16(_mm256_or_si256(_ta, _mm256_slli_epi32(_tb, 16)), _beta), 15);
+}
+
+// four channel words of tap 0 and tap 1 to 16 bytes per 128bit lane, one pixel per channel quad
+static inline __m256i warpaffine_bilinear_interp_c4_avx2(__m256i _a0, __m256i _a1, __m256i _b0, __m256i _b1, __m256i _alpha, __m256i _beta)
+{
+    const __m256i _zero = _mm256_setzero_si256();
+
+    // pixel 0 1 and pixel 2 3 of each lane
+    __m256i _a01 = _mm256_unpacklo_epi8(_a0, _a1);
+    __m256i _a23 = _mm256_unpackhi_epi8(_a0, _a1);
+    __m256i _b01 = _mm256_unpacklo_epi8(_b0, _b1);
+    __m256i _b23 = _mm256_unpackhi_epi8(_b0, _b1);
+
+    __m256i _r0 = warpaffine_bilinear_interp_avx2(_mm256_unpacklo_epi8(_a01, _zero), _mm256_unpacklo_epi8(_b01, _zero), _mm256_shuffle_epi32(_alpha, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_shuffle_epi32(_beta, _MM_SHUFFLE(0, 0, 0, 0)));
+    __m256i _r1 = warpaffine_bilinear_interp_avx2(_mm256_unpackhi_epi8(_a01, _zero), _mm256_unpackhi_epi8(_b01, _zero), _mm256_shuffle_epi32(_alpha, _MM_SHUFFLE(1, 1, 1, 1)), _mm256_shuffle_epi32(_beta, _MM_SHUFFLE(1, 1, 1, 1)));
+    __m256i _r2 = warpaffine_bilinear_interp_avx2(_mm256_unpacklo_epi8(_a23, _zero), _mm256_unpacklo_epi8(_b23, _zero), _mm256_shuffle_epi32(_alpha, _MM_SHUFFLE(2, 2, 2, 2)), _mm256_shuffle_epi32(_beta, _MM_SHUFFLE(2, 2, 2, 2)));
+    __m256i _r3 = warpaffine_bilinear_interp_avx2(_mm256_unpackhi_epi8(_a23, _zero), _mm256_unpackhi_epi8(_b23, _zero), _mm256_shuffle_epi32(_alpha, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_shuffle_epi32(_beta, _MM_SHUFFLE(3, 3, 3, 3)));
+
+    return _mm256_packus_epi16(_mm256_packs_epi32(_r0, _r1), _mm256_packs_epi32(_r2, _r3));
+}
+#endif // __AVX2__
+
+// source offsets and the (alpha0, alpha1) (beta0, beta1) 16bit weight pairs of 4 pixels
+static inline void warpaffine_bilinear_coords_sse(int X0, int Y0, const int* adelta, const int* bdelta, int srcstride, int cn, int* ofs, __m128i& _alpha, __m128i& _beta)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        ofs[i] = ((Y0 + bdelta[i]) >> 10) * srcstride + ((X0 + adelta[i]) >> 10) * cn;
+    }
+
+    __m128i _X = _mm_add_epi32(_mm_set1_epi32(X0), _mm_loadu_si128((const __m128i*)adelta));
+    __m128i _Y = _mm_add_epi32(_mm_set1_epi32(Y0), _mm_loadu_si128((const __m128i*)bdelta));
+
+    __m128i _fx = _mm_and_si128(_X, _mm_set1_epi32((1 << 10) - 1));
+    __m128i _fy = _mm_and_si128(_Y, _mm_set1_epi32((1 << 10) - 1));
+    _alpha = _mm_or_si128(_mm_sub_epi32(_mm_set1_epi32(1 << 10), _fx), _mm_slli_epi32(_fx, 16));
+    _beta = _mm_or_si128(_mm_sub_epi32(_mm_set1_epi32(1 << 10), _fy), _mm_slli_epi32(_fy, 16));
+}
+
+static inline __m128i warpaffine_bilinear_load_sse(const unsigned char* p, const int* ofs)
+{
+    return _mm_setr_epi32(*(const int*)(p + ofs[0]), *(const int*)(p + ofs[1]), *(const int*)(p + ofs[2]), *(const int*)(p + ofs[3]));
+}
+
+// ((a0 * alpha0 + a1 * alpha1) >> 5 * beta0 + (b0 * alpha0 + b1 * alpha1) >> 5 * beta1) >> 15
+static inline __m128i warpaffine_bilinear_interp_sse(__m128i _a, __m128i _b, __m128i _alpha, __m128i _beta)
+{
+    __m128i _ta = _mm_srai_epi32(_mm_madd_epi16(_a, _alpha), 5);
+    __m128i _tb = _mm_srai_epi32(_mm_madd_epi16(_b, _alpha), 5);
+    return _mm_srai_epi32(_mm_madd_epi16(_mm_or_si128(_ta, _mm_slli_epi32(_tb, 16)), _beta), 15);
+}
+
+// four channel words of tap 0 and tap 1 to 16 bytes, one pixel per channel quad
+static inline __m128i warpaffine_bilinear_interp_c4_sse(__m128i _a0, __m128i _a1, __m128i _b0, __m128i _b1, __m128i _alpha, __m128i _beta)
+{
+    const __m128i _zero = _mm_setzero_si128();
+
+    // pixel 0 1 and pixel 2 3
+    __m128i _a01 = _mm_unpacklo_epi8(_a0, _a1);
+    __m128i _a23 = _mm_unpackhi_epi8(_a0, _a1);
+    __m128i _b01 = _mm_unpacklo_epi8(_b0, _b1);
+    __m128i _b23 = _mm_unpackhi_epi8(_b0, _b1);
+
+    __m128i _r0 = warpaffine_bilinear_interp_sse(_mm_unpacklo_epi8(_a01, _zero), _mm_unpacklo_epi8(_b01, _zero), _mm_shuffle_epi32(_alpha, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_epi32(_beta, _MM_SHUFFLE(0, 0, 0, 0)));
+    __m128i _r1 = warpaffine_bilinear_interp_sse(_mm_unpackhi_epi8(_a01, _zero), _mm_unpackhi_epi8(_b01, _zero), _mm_shuffle_epi32(_alpha, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_epi32(_beta, _MM_SHUFFLE(1, 1, 1, 1)));
+    __m128i _r2 = warpaffine_bilinear_interp_sse(_mm_unpacklo_epi8(_a23, _zero), _mm_unpacklo_epi8(_b23, _zero), _mm_shuffle_epi32(_alpha, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_epi32(_beta, _MM_SHUFFLE(2, 2, 2, 2)));
+    __m128i _r3 = warpaffine_bilinear_interp_sse(_mm_unpackhi_epi8(_a23, _zero), _mm_unpackhi_epi8(_b23, _zero), _mm_shuffle_epi32(_alpha, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_epi32(_beta, _MM_SHUFFLE(3, 3, 3, 3)));
+
+    return _mm_packus_epi16(_mm_packs_epi32(_r0, _r1), _mm_packs_epi32(_r2, _r3));
+}
+
+// a0 a1 x x words to (a0, a1) 16bit pairs
+static inline __m128i warpaffine_bilinear_pair_c1_sse(__m128i _p)
+{
+    return _mm_or_si128(_mm_and_si128(_p, _mm_set1_epi32(0xff)), _mm_slli_epi32(_mm_and_si128(_p, _mm_set1_epi32(0xff00)), 8));
+}
+
+// c0 c1 c0' c1' words to (c0, c0') (c1, c1') 16bit pairs, two pixels per register
+static inline __m128i warpaffine_bilinear_pair_c2_sse(__m128i _p)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(_p, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+static void warpaffine_bilinear_c1_inside_8_sse(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        warpaffine_bilinear_c1_inside_8_sse_avx2(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+        return;
+    }
+#endif
+
+#if __AVX2__
+    __m256i _ofs;
+    __m256i _alpha;
+    __m256i _beta;
+    warpaffine_bilinear_coords_avx2(X0, Y0, adelta, bdelta, srcstride, 1, _ofs, _alpha, _beta);
+
+    // a0 a1 x x and x x b0 b1
+    __m256i _a = _mm256_i32gather_epi32((const int*)src0, _ofs, 1);
+    __m256i _b = _mm256_srli_epi32(_mm256_i32gather_epi32((const int*)(src0 + srcstride - 2), _ofs, 1), 16);
+
+    _a = _mm256_or_si256(_mm256_and_si256(_a, _mm256_set1_epi32(0xff)), _mm256_slli_epi32(_mm256_and_si256(_a, _mm256_set1_epi32(0xff00)), 8));
+    _b = _mm256_or_si256(_mm256_and_si256(_b, _mm256_set1_epi32(0xff)), _mm256_slli_epi32(_mm256_and_si256(_b, _mm256_set1_epi32(0xff00)), 8));
+
+    __m256i _r = warpaffine_bilinear_interp_avx2(_a, _b, _alpha, _beta);
+    _r = _mm256_packs_epi32(_r, _r);
+    _r = _mm256_packus_epi16(_r, _r);
+    _r = _mm256_permutevar8x32_epi32(_r, _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4));
+    _mm_storel_epi64((__m128i*)dst0, _mm256_castsi256_si128(_r));
+#else
+    __m128i _r[2];
+    for (int i = 0; i < 2; i++)
+    {
+        int ofs[4];
+        __m128i _alpha;
+        __m128i _beta;
+        warpaffine_bilinear_coords_sse(X0, Y0, adelta + i * 4, bdelta + i * 4, srcstride, 1, ofs, _alpha, _beta);
+
+        // a0 a1 x x and x x b0 b1
+        __m128i _a = warpaffine_bilinear_load_sse(src0, ofs);
+        __m128i _b = _mm_srli_epi32(warpaffine_bilinear_load_sse(src0 + srcstride - 2, ofs), 16);
+
+        _r[i] = warpaffine_bilinear_interp_sse(warpaffine_bilinear_pair_c1_sse(_a), warpaffine_bilinear_pair_c1_sse(_b), _alpha, _beta);
+    }
+
+    __m128i _r16 = _mm_packs_epi32(_r[0], _r[1]);
+    _mm_storel_epi64((__m128i*)dst0, _mm_packus_epi16(_r16, _r16));
+#endif // __AVX2__
+}
+
+static void warpaffine_bilinear_c2_inside_8_sse(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        warpaffine_bilinear_c2_inside_8_sse_avx2(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+        return;
+    }
+#endif
+
+#if __AVX2__
+    __m256i _ofs;
+    __m256i _alpha;
+    __m256i _beta;
+    warpaffine_bilinear_coords_avx2(X0, Y0, adelta, bdelta, srcstride, 2, _ofs, _alpha, _beta);
+
+    // c0 c1 c0' c1' of both taps
+    __m256i _a = _mm256_i32gather_epi32((const int*)src0, _ofs, 1);
+    __m256i _b = _mm256_i32gather_epi32((const int*)(src0 + srcstride), _ofs, 1);
+
+    const __m256i _zero = _mm256_setzero_si256();
+    __m256i _al = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_mm256_unpacklo_epi8(_a, _zero), _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i _ah = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_mm256_unpackhi_epi8(_a, _zero), _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i _bl = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_mm256_unpacklo_epi8(_b, _zero), _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+    __m256i _bh = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_mm256_unpackhi_epi8(_b, _zero), _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+
+    __m256i _rl = warpaffine_bilinear_interp_avx2(_al, _bl, _mm256_unpacklo_epi32(_alpha, _alpha), _mm256_unpacklo_epi32(_beta, _beta));
+    __m256i _rh = warpaffine_bilinear_interp_avx2(_ah, _bh, _mm256_unpackhi_epi32(_alpha, _alpha), _mm256_unpackhi_epi32(_beta, _beta));
+
+    __m256i _r = _mm256_packus_epi16(_mm256_packs_epi32(_rl, _rh), _zero);
+    _r = _mm256_permute4x64_epi64(_r, _MM_SHUFFLE(3, 1, 2, 0));
+    _mm_storeu_si128((__m128i*)dst0, _mm256_castsi256_si128(_r));
+#else
+    const __m128i _zero = _mm_setzero_si128();
+
+    __m128i _r[2];
+    for (int i = 0; i < 2; i++)
+    {
+        int ofs[4];
+        __m128i _alpha;
+        __m128i _beta;
+        warpaffine_bilinear_coords_sse(X0, Y0, adelta + i * 4, bdelta + i * 4, srcstride, 2, ofs, _alpha, _beta);
+
+        // c0 c1 c0' c1' of both taps
+        __m128i _a = warpaffine_bilinear_load_sse(src0, ofs);
+        __m128i _b = warpaffine_bilinear_load_sse(src0 + srcstride, ofs);
+
+        __m128i _al = warpaffine_bilinear_pair_c2_sse(_mm_unpacklo_epi8(_a, _zero));
+        __m128i _ah = warpaffine_bilinear_pair_c2_sse(_mm_unpackhi_epi8(_a, _zero));
+        __m128i _bl = warpaffine_bilinear_pair_c2_sse(_mm_unpacklo_epi8(_b, _zero));
+        __m128i _bh = warpaffine_bilinear_pair_c2_sse(_mm_unpackhi_epi8(_b, _zero));
+
+        __m128i _rl = warpaffine_bilinear_interp_sse(_al, _bl, _mm_unpacklo_epi32(_alpha, _alpha), _mm_unpacklo_epi32(_beta, _beta));
+        __m128i _rh = warpaffine_bilinear_interp_sse(_ah, _bh, _mm_unpackhi_epi32(_alpha, _alpha), _mm_unpackhi_epi32(_beta, _beta));
+
+        _r[i] = _mm_packs_epi32(_rl, _rh);
+    }
+
+    _mm_storeu_si128((__m128i*)dst0, _mm_packus_epi16(_r[0], _r[1]));
+#endif // __AVX2__
+}
+
+static void warpaffine_bilinear_c3_inside_8_sse(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        warpaffine_bilinear_c3_inside_8_sse_avx2(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+        return;
+    }
+#endif
+
+    // interpolated as four channels, the fourth one is junk
+    // b1 is read one byte early and shifted down so the word ends at the last tap byte
+#if __AVX2__
+    __m256i _ofs;
+    __m256i _alpha;
+    __m256i _beta;
+    warpaffine_bilinear_coords_avx2(X0, Y0, adelta, bdelta, srcstride, 3, _ofs, _alpha, _beta);
+
+    __m256i _a0 = _mm256_i32gather_epi32((const int*)src0, _ofs, 1);
+    __m256i _a1 = _mm256_i32gather_epi32((const int*)(src0 + 3), _ofs, 1);
+    __m256i _b0 = _mm256_i32gather_epi32((const int*)(src0 + srcstride), _ofs, 1);
+    __m256i _b1 = _mm256_srli_epi32(_mm256_i32gather_epi32((const int*)(src0 + srcstride + 2), _ofs, 1), 8);
+
+    __m256i _r = warpaffine_bilinear_interp_c4_avx2(_a0, _a1, _b0, _b1, _alpha, _beta);
+
+    // drop the junk channel and join the two lanes
+    _r = _mm256_shuffle_epi8(_r, _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+    _r = _mm256_permutevar8x32_epi32(_r, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm_storeu_si128((__m128i*)dst0, _mm256_castsi256_si128(_r));
+    _mm_storel_epi64((__m128i*)(dst0 + 16), _mm256_extracti128_si256(_r, 1));
+#else
+    for (int i = 0; i < 2; i++)
+    {
+        int ofs[4];
+        __m128i _alpha;
+        __m128i _beta;
+        warpaffine_bilinear_coords_sse(X0, Y0, adelta + i * 4, bdelta + i * 4, srcstride, 3, ofs, _alpha, _beta);
+
+        __m128i _a0 = warpaffine_bilinear_load_sse(src0, ofs);
+        __m128i _a1 = warpaffine_bilinear_load_sse(src0 + 3, ofs);
+        __m128i _b0 = warpaffine_bilinear_load_sse(src0 + srcstride, ofs);
+        __m128i _b1 = _mm_srli_epi32(warpaffine_bilinear_load_sse(src0 + srcstride + 2, ofs), 8);
+
+        __m128i _r = warpaffine_bilinear_interp_c4_sse(_a0, _a1, _b0, _b1, _alpha, _beta);
+
+        // drop the junk channel
+#if __SSSE3__
+        _r = _mm_shuffle_epi8(_r, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+        _mm_storel_epi64((__m128i*)(dst0 + i * 12), _r);
+        *(int*)(dst0 + i * 12 + 8) = _mm_cvtsi128_si32(_mm_srli_si128(_r, 8));
+#else
+        unsigned char tmp[16];
+        _mm_storeu_si128((__m128i*)tmp, _r);
+        for (int j = 0; j < 4; j++)
+        {
+            dst0[i * 12 + j * 3] = tmp[j * 4];
+            dst0[i * 12 + j * 3 + 1] = tmp[j * 4 + 1];
+            dst0[i * 12 + j * 3 + 2] = tmp[j * 4 + 2];
+        }
+#endif // __SSSE3__
+    }
+#endif // __AVX2__
+}
+
+static void warpaffine_bilinear_c4_inside_8_sse(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        warpaffine_bilinear_c4_inside_8_sse_avx2(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+        return;
+    }
+#endif
+
+#if __AVX2__
+    __m256i _ofs;
+    __m256i _alpha;
+    __m256i _beta;
+    warpaffine_bilinear_coords_avx2(X0, Y0, adelta, bdelta, srcstride, 4, _ofs, _alpha, _beta);
+
+    __m256i _a0 = _mm256_i32gather_epi32((const int*)src0, _ofs, 1);
+    __m256i _a1 = _mm256_i32gather_epi32((const int*)(src0 + 4), _ofs, 1);
+    __m256i _b0 = _mm256_i32gather_epi32((const int*)(src0 + srcstride), _ofs, 1);
+    __m256i _b1 = _mm256_i32gather_epi32((const int*)(src0 + srcstride + 4), _ofs, 1);
+
+    __m256i _r = warpaffine_bilinear_interp_c4_avx2(_a0, _a1, _b0, _b1, _alpha, _beta);
+    _mm256_storeu_si256((__m256i*)dst0, _r);
+#else
+    for (int i = 0; i < 2; i++)
+    {
+        int ofs[4];
+        __m128i _alpha;
+        __m128i _beta;
+        warpaffine_bilinear_coords_sse(X0, Y0, adelta + i * 4, bdelta + i * 4, srcstride, 4, ofs, _alpha, _beta);
+
+        __m128i _a0 = warpaffine_bilinear_load_sse(src0, ofs);
+        __m128i _a1 = warpaffine_bilinear_load_sse(src0 + 4, ofs);
+        __m128i _b0 = warpaffine_bilinear_load_sse(src0 + srcstride, ofs);
+        __m128i _b1 = warpaffine_bilinear_load_sse(src0 + srcstride + 4, ofs);
+
+        __m128i _r = warpaffine_bilinear_interp_c4_sse(_a0, _a1, _b0, _b1, _alpha, _beta);
+        _mm_storeu_si128((__m128i*)(dst0 + i * 16), _r);
+    }
+#endif // __AVX2__
+}
@@ -0,0 +1,918 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "mat.h"
+
+#include <math.h>
+#include <vector>
+
+#if __ARM_NEON
+#include <arm_neon.h>
+#endif // __ARM_NEON
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif
+#endif // __SSE2__
+#include "platform.h"
+
+namespace ncnn {
+
+#if NCNN_PIXEL
+PixelPreprocess::PixelPreprocess()
+{
+    target_width = 0;
+    target_height = 0;
+
+    for (int i = 0; i < 6; i++)
+    {
+        tm[i] = 0.f;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        border_vals[i] = 0.f;
+    }
+
+    mean_vals = 0;
+    norm_vals = 0;
+
+    elempack = 1;
+    elembits = 32;
+    int8_scale = 1.f;
+
+    num_threads = 1;
+}
+
+void PixelPreprocess::set_letterbox(int w, int h)
+{
+    const float scale = std::min((float)target_width / w, (float)target_height / h);
+
+    const int pad_x = (target_width - (int)(w * scale + 0.5f)) / 2;
+    const int pad_y = (target_height - (int)(h * scale + 0.5f)) / 2;
+
+    // pixel centers map to pixel centers
+    tm[0] = 1.f / scale;
+    tm[1] = 0.f;
+    tm[2] = (0.5f - pad_x) / scale - 0.5f;
+    tm[3] = 0.f;
+    tm[4] = 1.f / scale;
+    tm[5] = (0.5f - pad_y) / scale - 0.5f;
+}
+
+// one output channel made from the bytes of a source pixel
+struct pixel_channel_t
+{
+    // 0 = byte i0, 1 = opaque alpha, 2 = gray of the r g b bytes i0 i1 i2
+    int type;
+    int i0;
+    int i1;
+    int i2;
+};
+
+struct pixel_source_t
+{
+    const unsigned char* data;
+    int w;
+    int h;
+    int stride;
+
+    // bytes per pixel, yuv420sp pixels are decoded to 3 bytes rgb
+    int channels;
+
+    int yuv420sp;
+
+    // offset of u in the interleaved chroma pair
+    int uoff;
+};
+
+// r g b a byte offsets of a pixel format, -1 if absent
+static int get_pixel_layout(int format, int* rgba)
+{
+    rgba[0] = rgba[1] = rgba[2] = rgba[3] = -1;
+
+    switch (format)
+    {
+    case Mat::PIXEL_RGB:
+    case Mat::PIXEL_YUV420SP:
+    case Mat::PIXEL_YUV420SP_NV12:
+        rgba[0] = 0;
+        rgba[1] = 1;
+        rgba[2] = 2;
+        return 3;
+    case Mat::PIXEL_BGR:
+        rgba[0] = 2;
+        rgba[1] = 1;
+        rgba[2] = 0;
+        return 3;
+    case Mat::PIXEL_GRAY:
+        rgba[0] = 0;
+        rgba[1] = 0;
+        rgba[2] = 0;
+        return 1;
+    case Mat::PIXEL_RGBA:
+        rgba[0] = 0;
+        rgba[1] = 1;
+        rgba[2] = 2;
+        rgba[3] = 3;
+        return 4;
+    case Mat::PIXEL_BGRA:
+        rgba[0] = 2;
+        rgba[1] = 1;
+        rgba[2] = 0;
+        rgba[3] = 3;
+        return 4;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+static int get_pixel_channels(int type, pixel_channel_t* chs)
+{
+    const int src_format = type & Mat::PIXEL_FORMAT_MASK;
+    const int dst_format = (type & Mat::PIXEL_CONVERT_MASK) ? (type >> Mat::PIXEL_CONVERT_SHIFT) : src_format;
+
+    int src_rgba[4];
+    const int src_channels = get_pixel_layout(src_format, src_rgba);
+    if (src_channels == 0)
+        return 0;
+
+    // dst is described by r g b a, 4 = gray
+    int dst_order[4];
+    int dst_channels = 0;
+    switch (dst_format)
+    {
+    case Mat::PIXEL_RGB:
+    case Mat::PIXEL_YUV420SP:
+    case Mat::PIXEL_YUV420SP_NV12:
+        dst_order[0] = 0;
+        dst_order[1] = 1;
+        dst_order[2] = 2;
+        dst_channels = 3;
+        break;
+    case Mat::PIXEL_BGR:
+        dst_order[0] = 2;
+        dst_order[1] = 1;
+        dst_order[2] = 0;
+        dst_channels = 3;
+        break;
+    case Mat::PIXEL_GRAY:
+        dst_order[0] = 4;
+        dst_channels = 1;
+        break;
+    case Mat::PIXEL_RGBA:
+        dst_order[0] = 0;
+        dst_order[1] = 1;
+        dst_order[2] = 2;
+        dst_order[3] = 3;
+        dst_channels = 4;
+        break;
+    case Mat::PIXEL_BGRA:
+        dst_order[0] = 2;
+        dst_order[1] = 1;
+        dst_order[2] = 0;
+        dst_order[3] = 3;
+        dst_channels = 4;
+        break;
+    default:
+        return 0;
+    }
+
+    for (int q = 0; q < dst_channels; q++)
+    {
+        const int c = dst_order[q];
+        if (c == 4)
+        {
+            if (src_channels == 1)
+            {
+                chs[q].type = 0;
+                chs[q].i0 = 0;
+            }
+            else
+            {
+                chs[q].type = 2;
+                chs[q].i0 = src_rgba[0];
+                chs[q].i1 = src_rgba[1];
+                chs[q].i2 = src_rgba[2];
+            }
+        }
+        else if (src_rgba[c] == -1)
+        {
+            chs[q].type = 1;
+        }
+        else
+        {
+            chs[q].type = 0;
+            chs[q].i0 = src_rgba[c];
+        }
+    }
+
+    return dst_channels;
+}
+
+static inline int pixel_channel_value(const unsigned char* p, const pixel_channel_t& ch)
+{
+    if (ch.type == 0)
+        return p[ch.i0];
+
+    if (ch.type == 1)
+        return 255;
+
+    // coeffs for r g b = 0.299f, 0.587f, 0.114f, the same as from_pixels
+    return (p[ch.i0] * 77 + p[ch.i1] * 150 + p[ch.i2] * 29) >> 8;
+}
+
+// the same approximation as yuv420sp2rgb
+static inline void yuv420sp_decode_pixel(const unsigned char* yrow, const unsigned char* uvrow, int x, int uoff, unsigned char* rgb)
+{
+#define SATURATE_CAST_UCHAR(X) (unsigned char)::std::min(::std::max((int)(X), 0), 255);
+    const unsigned char* uv = uvrow + (x / 2) * 2;
+    int u = uv[uoff] - 128;
+    int v = uv[1 - uoff] - 128;
+
+    int ruv = 90 * v;
+    int guv = -46 * v + -22 * u;
+    int buv = 113 * u;
+
+    int yy = yrow[x] << 6;
+    rgb[0] = SATURATE_CAST_UCHAR((yy + ruv) >> 6);
+    rgb[1] = SATURATE_CAST_UCHAR((yy + guv) >> 6);
+    rgb[2] = SATURATE_CAST_UCHAR((yy + buv) >> 6);
+#undef SATURATE_CAST_UCHAR
+}
+
+static inline const unsigned char* pixel_source_tap(const pixel_source_t& src, int x, int y, unsigned char* buf)
+{
+    if (!src.yuv420sp)
+        return src.data + y * src.stride + x * src.channels;
+
+    const unsigned char* yrow = src.data + y * src.stride;
+    const unsigned char* uvrow = src.data + src.h * src.stride + (y / 2) * src.stride;
+    yuv420sp_decode_pixel(yrow, uvrow, x, src.uoff, buf);
+    return buf;
+}
+
+// horizontal pass of source row sy into one float row per source channel, columns [xb, xe) only
+// xofs are byte offsets into the row, or pixel indexes for yuv420sp
+static void preprocess_hresize(const pixel_source_t& src, int sy, const int* xofs0, const int* xofs1, const float* alpha, int xb, int xe, float** srows)
+{
+    const unsigned char* row = src.data + sy * src.stride;
+
+    if (src.yuv420sp)
+    {
+        const unsigned char* uvrow = src.data + src.h * src.stride + (sy / 2) * src.stride;
+
+        float* r = srows[0];
+        float* g = srows[1];
+        float* b = srows[2];
+        for (int x = xb; x < xe; x++)
+        {
+            const int sx0 = xofs0[x];
+            const int sx1 = xofs1[x];
+
+            // both taps share the chroma of a 2x2 block most of the time
+            const unsigned char* uv0 = uvrow + (sx0 & ~1);
+            const unsigned char* uv1 = uvrow + (sx1 & ~1);
+
+            int u = uv0[src.uoff] - 128;
+            int v = uv0[1 - src.uoff] - 128;
+            int ruv0 = 90 * v;
+            int guv0 = -46 * v + -22 * u;
+            int buv0 = 113 * u;
+
+            int ruv1 = ruv0;
+            int guv1 = guv0;
+            int buv1 = buv0;
+            if (uv1 != uv0)
+            {
+                u = uv1[src.uoff] - 128;
+                v = uv1[1 - src.uoff] - 128;
+                ruv1 = 90 * v;
+                guv1 = -46 * v + -22 * u;
+                buv1 = 113 * u;
+            }
+
+            const int yy0 = row[sx0] << 6;
+            const int yy1 = row[sx1] << 6;
+
+            const int r0 = std::min(std::max((yy0 + ruv0) >> 6, 0), 255);
+            const int g0 = std::min(std::max((yy0 + guv0) >> 6, 0), 255);
+            const int b0 = std::min(std::max((yy0 + buv0) >> 6, 0), 255);
+            const int r1 = std::min(std::max((yy1 + ruv1) >> 6, 0), 255);
+            const int g1 = std::min(std::max((yy1 + guv1) >> 6, 0), 255);
+            const int b1 = std::min(std::max((yy1 + buv1) >> 6, 0), 255);
+
+            const float a1 = alpha[x];
+            r[x] = r0 + (r1 - r0) * a1;
+            g[x] = g0 + (g1 - g0) * a1;
+            b[x] = b0 + (b1 - b0) * a1;
+        }
+        return;
+    }
+
+    if (src.channels == 1)
+    {
+        float* r0 = srows[0];
+        for (int x = xb; x < xe; x++)
+        {
+            const int v0 = row[xofs0[x]];
+            const int v1 = row[xofs1[x]];
+            r0[x] = v0 + (v1 - v0) * alpha[x];
+        }
+    }
+    if (src.channels == 3)
+    {
+        float* r0 = srows[0];
+        float* r1 = srows[1];
+        float* r2 = srows[2];
+        for (int x = xb; x < xe; x++)
+        {
+            const unsigned char* p0 = row + xofs0[x];
+            const unsigned char* p1 = row + xofs1[x];
+            const float a1 = alpha[x];
+            r0[x] = p0[0] + (p1[0] - p0[0]) * a1;
+            r1[x] = p0[1] + (p1[1] - p0[1]) * a1;
+            r2[x] = p0[2] + (p1[2] - p0[2]) * a1;
+        }
+    }
+    if (src.channels == 4)
+    {
+        float* r0 = srows[0];
+        float* r1 = srows[1];
+        float* r2 = srows[2];
+        float* r3 = srows[3];
+        for (int x = xb; x < xe; x++)
+        {
+            const unsigned char* p0 = row + xofs0[x];
+            const unsigned char* p1 = row + xofs1[x];
+            const float a1 = alpha[x];
+            r0[x] = p0[0] + (p1[0] - p0[0]) * a1;
+            r1[x] = p0[1] + (p1[1] - p0[1]) * a1;
+            r2[x] = p0[2] + (p1[2] - p0[2]) * a1;
+            r3[x] = p0[3] + (p1[3] - p0[3]) * a1;
+        }
+    }
+}
+
+// map the interpolated source channel rows to output channel rows
+// direct channels alias the source rows, gray is blended into the spare row
+static void preprocess_derive_rows(float** srows, float* gray, const float* opaque, const pixel_channel_t* chs, int outc, int xb, int xe, const float** rows)
+{
+    for (int q = 0; q < outc; q++)
+    {
+        const pixel_channel_t& ch = chs[q];
+        if (ch.type == 0)
+        {
+            rows[q] = srows[ch.i0];
+        }
+        else if (ch.type == 1)
+        {
+            rows[q] = opaque;
+        }
+        else
+        {
+            const float* r = srows[ch.i0];
+            const float* g = srows[ch.i1];
+            const float* b = srows[ch.i2];
+            for (int x = xb; x < xe; x++)
+            {
+                gray[x] = (r[x] * 77 + g[x] * 150 + b[x] * 29) * (1.f / 256);
+            }
+            rows[q] = gray;
+        }
+    }
+}
+
+// per pixel bilinear sampling of target row y for a transform with rotation or shear
+static void preprocess_warp_row(const pixel_source_t& src, int y, const float* tm, const pixel_channel_t* chs, int outc, const float* border_vals, float** rows, int outw)
+{
+    unsigned char buf00[4];
+    unsigned char buf01[4];
+    unsigned char buf10[4];
+    unsigned char buf11[4];
+
+    for (int x = 0; x < outw; x++)
+    {
+        const float fx = tm[0] * x + tm[1] * y + tm[2];
+        const float fy = tm[3] * x + tm[4] * y + tm[5];
+
+        if (fx < -0.5f || fx >= src.w - 0.5f || fy < -0.5f || fy >= src.h - 0.5f)
+        {
+            for (int q = 0; q < outc; q++)
+            {
+                rows[q][x] = border_vals[q];
+            }
+            continue;
+        }
+
+        int sx = (int)floorf(fx);
+        int sy = (int)floorf(fy);
+        float a1 = fx - sx;
+        float b1 = fy - sy;
+        if (sx < 0)
+        {
+            sx = 0;
+            a1 = 0.f;
+        }
+        if (sx >= src.w - 1)
+        {
+            sx = src.w - 1;
+            a1 = 0.f;
+        }
+        if (sy < 0)
+        {
+            sy = 0;
+            b1 = 0.f;
+        }
+        if (sy >= src.h - 1)
+        {
+            sy = src.h - 1;
+            b1 = 0.f;
+        }
+
+        const int sx1 = std::min(sx + 1, src.w - 1);
+        const int sy1 = std::min(sy + 1, src.h - 1);
+
+        const unsigned char* p00 = pixel_source_tap(src, sx, sy, buf00);
+        const unsigned char* p01 = pixel_source_tap(src, sx1, sy, buf01);
+        const unsigned char* p10 = pixel_source_tap(src, sx, sy1, buf10);
+        const unsigned char* p11 = pixel_source_tap(src, sx1, sy1, buf11);
+
+        for (int q = 0; q < outc; q++)
+        {
+            const float v00 = (float)pixel_channel_value(p00, chs[q]);
+            const float v01 = (float)pixel_channel_value(p01, chs[q]);
+            const float v10 = (float)pixel_channel_value(p10, chs[q]);
+            const float v11 = (float)pixel_channel_value(p11, chs[q]);
+            const float v0 = v00 + (v01 - v00) * a1;
+            const float v1 = v10 + (v11 - v10) * a1;
+            rows[q][x] = v0 + (v1 - v0) * b1;
+        }
+    }
+}
+
+// outptr = rows0 * s0 + rows1 * s1 + bias, the vertical blend with mean and norm folded in
+static void preprocess_vresize_row(const float* rows0, const float* rows1, float s0, float s1, float bias, float* outptr, int outw)
+{
+    int x = 0;
+#if __SSE2__
+#if __AVX__
+    {
+        __m256 _s0 = _mm256_set1_ps(s0);
+        __m256 _s1 = _mm256_set1_ps(s1);
+        __m256 _bias = _mm256_set1_ps(bias);
+        for (; x + 7 < outw; x += 8)
+        {
+            __m256 _r0 = _mm256_loadu_ps(rows0 + x);
+            __m256 _r1 = _mm256_loadu_ps(rows1 + x);
+            __m256 _v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_r0, _s0), _mm256_mul_ps(_r1, _s1)), _bias);
+            _mm256_storeu_ps(outptr + x, _v);
+        }
+    }
+#endif // __AVX__
+    {
+        __m128 _s0 = _mm_set1_ps(s0);
+        __m128 _s1 = _mm_set1_ps(s1);
+        __m128 _bias = _mm_set1_ps(bias);
+        for (; x + 3 < outw; x += 4)
+        {
+            __m128 _r0 = _mm_loadu_ps(rows0 + x);
+            __m128 _r1 = _mm_loadu_ps(rows1 + x);
+            __m128 _v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_r0, _s0), _mm_mul_ps(_r1, _s1)), _bias);
+            _mm_storeu_ps(outptr + x, _v);
+        }
+    }
+#endif // __SSE2__
+#if __ARM_NEON
+    {
+        float32x4_t _s0 = vdupq_n_f32(s0);
+        float32x4_t _s1 = vdupq_n_f32(s1);
+        float32x4_t _bias = vdupq_n_f32(bias);
+        for (; x + 3 < outw; x += 4)
+        {
+            float32x4_t _r0 = vld1q_f32(rows0 + x);
+            float32x4_t _r1 = vld1q_f32(rows1 + x);
+            float32x4_t _v = vmlaq_f32(vmlaq_f32(_bias, _r0, _s0), _r1, _s1);
+            vst1q_f32(outptr + x, _v);
+        }
+    }
+#endif // __ARM_NEON
+    for (; x < outw; x++)
+    {
+        outptr[x] = rows0[x] * s0 + rows1[x] * s1 + bias;
+    }
+}
+
+// interleave elempack planar rows of outw into outw pixels of elempack
+static void preprocess_pack_row(const float* planar, int outw, int elempack, float* outptr)
+{
+    int x = 0;
+#if __SSE2__
+    if (elempack == 4)
+    {
+        for (; x + 3 < outw; x += 4)
+        {
+            for (int k = 0; k < elempack; k += 4)
+            {
+                __m128 _r0 = _mm_loadu_ps(planar + k * outw + x);
+                __m128 _r1 = _mm_loadu_ps(planar + (k + 1) * outw + x);
+                __m128 _r2 = _mm_loadu_ps(planar + (k + 2) * outw + x);
+                __m128 _r3 = _mm_loadu_ps(planar + (k + 3) * outw + x);
+                _MM_TRANSPOSE4_PS(_r0, _r1, _r2, _r3);
+                _mm_storeu_ps(outptr + x * elempack + k, _r0);
+                _mm_storeu_ps(outptr + (x + 1) * elempack + k, _r1);
+                _mm_storeu_ps(outptr + (x + 2) * elempack + k, _r2);
+                _mm_storeu_ps(outptr + (x + 3) * elempack + k, _r3);
+            }
+        }
+    }
+#endif // __SSE2__
+#if __ARM_NEON
+    if (elempack == 4)
+    {
+        for (; x + 3 < outw; x += 4)
+        {
+            for (int k = 0; k < elempack; k += 4)
+            {
+                float32x4_t _r0 = vld1q_f32(planar + k * outw + x);
+                float32x4_t _r1 = vld1q_f32(planar + (k + 1) * outw + x);
+                float32x4_t _r2 = vld1q_f32(planar + (k + 2) * outw + x);
+                float32x4_t _r3 = vld1q_f32(planar + (k + 3) * outw + x);
+                float32x4x2_t _r02 = vzipq_f32(_r0, _r2);
+                float32x4x2_t _r13 = vzipq_f32(_r1, _r3);
+                float32x4x2_t _t0 = vzipq_f32(_r02.val[0], _r13.val[0]);
+                float32x4x2_t _t1 = vzipq_f32(_r02.val[1], _r13.val[1]);
+                vst1q_f32(outptr + x * elempack + k, _t0.val[0]);
+                vst1q_f32(outptr + (x + 1) * elempack + k, _t0.val[1]);
+                vst1q_f32(outptr + (x + 2) * elempack + k, _t1.val[0]);
+                vst1q_f32(outptr + (x + 3) * elempack + k, _t1.val[1]);
+            }
+        }
+    }
+#endif // __ARM_NEON
+    for (; x < outw; x++)
+    {
+        for (int k = 0; k < elempack; k++)
+        {
+            outptr[x * elempack + k] = planar[k * outw + x];
+        }
+    }
+}
+
+static void preprocess_cast_fp16_row(const float* ptr, unsigned short* outptr, int size)
+{
+    int i = 0;
+#if __F16C__
+    for (; i + 7 < size; i += 8)
+    {
+        __m128i _v = _mm256_cvtps_ph(_mm256_loadu_ps(ptr + i), _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC);
+        _mm_storeu_si128((__m128i*)(outptr + i), _v);
+    }
+#endif // __F16C__
+#if __ARM_NEON && __aarch64__
+    for (; i + 3 < size; i += 4)
+    {
+        vst1_u16(outptr + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(ptr + i))));
+    }
+#endif // __ARM_NEON && __aarch64__
+    for (; i < size; i++)
+    {
+        outptr[i] = float32_to_float16(ptr[i]);
+    }
+}
+
+static void preprocess_cast_int8_row(const float* ptr, signed char* outptr, int size, float scale)
+{
+    int i = 0;
+#if __SSE2__
+    {
+        __m128 _scale = _mm_set1_ps(scale);
+        __m128 _p5 = _mm_set1_ps(0.5f);
+        __m128 _signmask = _mm_castsi128_ps(_mm_set1_epi32(1 << 31));
+        for (; i + 7 < size; i += 8)
+        {
+            __m128 _v0 = _mm_mul_ps(_mm_loadu_ps(ptr + i), _scale);
+            __m128 _v1 = _mm_mul_ps(_mm_loadu_ps(ptr + i + 4), _scale);
+            // round half away from zero like round()
+            _v0 = _mm_add_ps(_v0, _mm_or_ps(_p5, _mm_and_ps(_v0, _signmask)));
+            _v1 = _mm_add_ps(_v1, _mm_or_ps(_p5, _mm_and_ps(_v1, _signmask)));
+            __m128i _v = _mm_packs_epi32(_mm_cvttps_epi32(_v0), _mm_cvttps_epi32(_v1));
+            _v = _mm_max_epi16(_v, _mm_set1_epi16(-127));
+            _v = _mm_packs_epi16(_v, _v);
+            _mm_storel_epi64((__m128i*)(outptr + i), _v);
+        }
+    }
+#endif // __SSE2__
+#if __ARM_NEON && __aarch64__
+    {
+        float32x4_t _scale = vdupq_n_f32(scale);
+        for (; i + 7 < size; i += 8)
+        {
+            int32x4_t _v0 = vcvtaq_s32_f32(vmulq_f32(vld1q_f32(ptr + i), _scale));
+            int32x4_t _v1 = vcvtaq_s32_f32(vmulq_f32(vld1q_f32(ptr + i + 4), _scale));
+            int16x8_t _v = vcombine_s16(vqmovn_s32(_v0), vqmovn_s32(_v1));
+            _v = vmaxq_s16(_v, vdupq_n_s16(-127));
+            vst1_s8(outptr + i, vqmovn_s16(_v));
+        }
+    }
+#endif // __ARM_NEON && __aarch64__
+    for (; i < size; i++)
+    {
+        int v = (int)round(ptr[i] * scale);
+        outptr[i] = (signed char)std::min(std::max(v, -127), 127);
+    }
+}
+
+// blend, normalize, pack and cast one target row into every channel of out
+// columns outside [xb, xe) take border_vals, tmp holds 2 * elempack * outw floats
+static void preprocess_store_row(const float** rows0, const float** rows1, float b0, float b1, int xb, int xe, const PixelPreprocess& pp, Mat& out, int y, float* tmp)
+{
+    const int outw = out.w;
+    const int elempack = out.elempack;
+    const bool store_fp32_pack1 = elempack == 1 && pp.elembits == 32;
+
+    for (int p = 0; p < out.c; p++)
+    {
+        float* planar = store_fp32_pack1 ? (float*)out.channel(p).row(y) : tmp;
+
+        for (int k = 0; k < elempack; k++)
+        {
+            const int q = p * elempack + k;
+            const float norm = pp.norm_vals ? pp.norm_vals[q] : 1.f;
+            const float bias = pp.mean_vals ? -pp.mean_vals[q] * norm : 0.f;
+            float* ptr = planar + k * outw;
+
+            const float border = pp.border_vals[q] * norm + bias;
+            for (int x = 0; x < xb; x++)
+            {
+                ptr[x] = border;
+            }
+            if (xe > xb)
+            {
+                preprocess_vresize_row(rows0[q] + xb, rows1[q] + xb, b0 * norm, b1 * norm, bias, ptr + xb, xe - xb);
+            }
+            for (int x = std::max(xb, xe); x < outw; x++)
+            {
+                ptr[x] = border;
+            }
+        }
+
+        if (store_fp32_pack1)
+            continue;
+
+        float* packed = planar;
+        if (elempack > 1)
+        {
+            packed = pp.elembits == 32 ? (float*)out.channel(p).row(y) : tmp + elempack * outw;
+            preprocess_pack_row(planar, outw, elempack, packed);
+        }
+
+        if (pp.elembits == 16)
+            preprocess_cast_fp16_row(packed, out.channel(p).row<unsigned short>(y), outw * elempack);
+
+        if (pp.elembits == 8)
+            preprocess_cast_int8_row(packed, out.channel(p).row<signed char>(y), outw * elempack, pp.int8_scale);
+    }
+}
+
+Mat from_pixels_preprocess(const unsigned char* pixels, int type, int w, int h, int stride, const PixelPreprocess& pp, Allocator* allocator)
+{
+    pixel_channel_t chs[4];
+    const int outc = get_pixel_channels(type, chs);
+    if (outc == 0)
+    {
+        NCNN_LOGE("from_pixels_preprocess unsupported pixel type %d", type);
+        return Mat();
+    }
+
+    const int outw = pp.target_width;
+    const int outh = pp.target_height;
+    const int elempack = pp.elempack;
+
+    if (outw <= 0 || outh <= 0 || w <= 0 || h <= 0)
+    {
+        NCNN_LOGE("from_pixels_preprocess invalid size %d x %d -> %d x %d", w, h, outw, outh);
+        return Mat();
+    }
+
+    if ((elempack != 1 && elempack != 4) || outc % elempack != 0)
+    {
+        NCNN_LOGE("from_pixels_preprocess elempack %d does not fit %d channels", elempack, outc);
+        return Mat();
+    }
+
+    if (pp.elembits != 32 && pp.elembits != 16 && pp.elembits != 8)
+    {
+        NCNN_LOGE("from_pixels_preprocess unsupported elembits %d", pp.elembits);
+        return Mat();
+    }
+
+    pixel_source_t src;
+    src.data = pixels;
+    src.w = w;
+    src.h = h;
+    src.stride = stride;
+    src.yuv420sp = 0;
+    src.uoff = 0;
+    {
+        const int src_format = type & Mat::PIXEL_FORMAT_MASK;
+        int src_rgba[4];
+        src.channels = get_pixel_layout(src_format, src_rgba);
+        if (src_format == Mat::PIXEL_YUV420SP)
+        {
+            src.yuv420sp = 1;
+            src.uoff = 1;
+        }
+        if (src_format == Mat::PIXEL_YUV420SP_NV12)
+        {
+            src.yuv420sp = 1;
+            src.uoff = 0;
+        }
+    }
+
+    Mat out;
+    out.create(outw, outh, outc / elempack, (size_t)(pp.elembits / 8 * elempack), elempack, allocator);
+    if (out.empty())
+        return out;
+
+    // stretch when no transform is given
+    float tm[6];
+    bool has_tm = false;
+    for (int i = 0; i < 6; i++)
+    {
+        tm[i] = pp.tm[i];
+        has_tm = has_tm || tm[i] != 0.f;
+    }
+    if (!has_tm)
+    {
+        tm[0] = (float)w / outw;
+        tm[2] = 0.5f * tm[0] - 0.5f;
+        tm[4] = (float)h / outh;
+        tm[5] = 0.5f * tm[4] - 0.5f;
+    }
+
+    const bool separable = tm[1] == 0.f && tm[3] == 0.f;
+
+    // column and row taps of the separable path
+    // the columns inside the source image form the range [xb, xe), negative yofs marks a border row
+    std::vector<int> xofs0(outw);
+    std::vector<int> xofs1(outw);
+    std::vector<float> alpha(outw);
+    std::vector<int> yofs0(outh);
+    std::vector<int> yofs1(outh);
+    std::vector<float> beta(outh);
+    int xb = 0;
+    int xe = 0;
+    if (separable)
+    {
+        // byte offsets for interleaved pixels, pixel indexes for yuv420sp
+        const int xstep = src.yuv420sp ? 1 : src.channels;
+
+        xb = outw;
+        for (int x = 0; x < outw; x++)
+        {
+            const float fx = tm[0] * x + tm[2];
+            if (fx < -0.5f || fx >= w - 0.5f)
+                continue;
+
+            int sx = (int)floorf(fx);
+            float a1 = fx - sx;
+            if (sx < 0)
+            {
+                sx = 0;
+                a1 = 0.f;
+            }
+            if (sx >= w - 1)
+            {
+                sx = w - 1;
+                a1 = 0.f;
+            }
+
+            xofs0[x] = sx * xstep;
+            xofs1[x] = std::min(sx + 1, w - 1) * xstep;
+            alpha[x] = a1;
+
+            xb = std::min(xb, x);
+            xe = x + 1;
+        }
+        if (xe == 0)
+            xb = 0;
+
+        for (int y = 0; y < outh; y++)
+        {
+            const float fy = tm[4] * y + tm[5];
+            if (fy < -0.5f || fy >= h - 0.5f)
+            {
+                yofs0[y] = -1;
+                continue;
+            }
+
+            int sy = (int)floorf(fy);
+            float b1 = fy - sy;
+            if (sy < 0)
+            {
+                sy = 0;
+                b1 = 0.f;
+            }
+            if (sy >= h - 1)
+            {
+                sy = h - 1;
+                b1 = 0.f;
+            }
+
+            yofs0[y] = sy;
+            yofs1[y] = std::min(sy + 1, h - 1);
+            beta[y] = b1;
+        }
+    }
+
+    // split the target rows into one band per thread, each band keeps its own two cached source rows
+    const int nT = std::max(1, std::min(pp.num_threads, outh));
+    const int band = (outh + nT - 1) / nT;
+
+    // per band workspace = 2 cached slots of 4 source channels and gray + opaque row + 2 scratch rows of elempack
+    const int rows_size = (2 * 5 + 1 + 2 * elempack) * outw;
+    Mat workspace(rows_size, nT, (size_t)4u, allocator);
+    if (workspace.empty())
+        return Mat();
+
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
+    {
+        float* ws = workspace.row(t);
+
+        float* slots[2][5];
+        for (int i = 0; i < 5; i++)
+        {
+            slots[0][i] = ws + i * outw;
+            slots[1][i] = ws + (5 + i) * outw;
+        }
+        int slot_y[2] = {-1, -1};
+        const float* rows[2][4] = {{0}};
+
+        float* opaque = ws + 10 * outw;
+        for (int x = 0; x < outw; x++)
+        {
+            opaque[x] = 255.f;
+        }
+
+        float* tmp = ws + 11 * outw;
+
+        const int y_start = t * band;
+        const int y_end = std::min(y_start + band, outh);
+
+        for (int y = y_start; y < y_end; y++)
+        {
+            if (!separable)
+            {
+                preprocess_warp_row(src, y, tm, chs, outc, pp.border_vals, slots[0], outw);
+                for (int q = 0; q < outc; q++)
+                {
+                    rows[0][q] = slots[0][q];
+                }
+                preprocess_store_row(rows[0], rows[0], 1.f, 0.f, 0, outw, pp, out, y, tmp);
+                continue;
+            }
+
+            if (yofs0[y] < 0)
+            {
+                preprocess_store_row(rows[0], rows[0], 1.f, 0.f, 0, 0, pp, out, y, tmp);
+                continue;
+            }
+
+            const int sy0 = yofs0[y];
+            const int sy1 = yofs1[y];
+
+            // reuse the cached horizontal rows, only compute the missing ones
+            int s0 = slot_y[0] == sy0 ? 0 : slot_y[1] == sy0 ? 1 : -1;
+            int s1 = slot_y[0] == sy1 ? 0 : slot_y[1] == sy1 ? 1 : -1;
+            if (s0 == -1)
+            {
+                s0 = s1 == 0 ? 1 : 0;
+                preprocess_hresize(src, sy0, xofs0.data(), xofs1.data(), alpha.data(), xb, xe, slots[s0]);
+                preprocess_derive_rows(slots[s0], slots[s0][4], opaque, chs, outc, xb, xe, rows[s0]);
+                slot_y[s0] = sy0;
+            }
+            if (s1 == -1)
+            {
+                s1 = sy1 == sy0 ? s0 : s0 == 0 ? 1 : 0;
+                if (s1 != s0)
+                {
+                    preprocess_hresize(src, sy1, xofs0.data(), xofs1.data(), alpha.data(), xb, xe, slots[s1]);
+                    preprocess_derive_rows(slots[s1], slots[s1][4], opaque, chs, outc, xb, xe, rows[s1]);
+                    slot_y[s1] = sy1;
+                }
+            }
+
+            preprocess_store_row(rows[s0], rows[s1], 1.f - beta[y], beta[y], xb, xe, pp, out, y, tmp);
+        }
+    }
+
+    return out;
+}
+#endif // NCNN_PIXEL
+
+} // namespace ncnn
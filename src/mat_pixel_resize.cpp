@@ -8,14 +8,35 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#include "cpu.h"
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL
+#if __SSE2__
+#include "mat_pixel_resize_x86.h"
+#endif // __SSE2__
+
+// split large images into bands of rows when the caller asks for more than one thread
+static int resize_band_count(int w, int h, int num_threads)
+{
+    if (num_threads > 1 && w * h >= 256 * 256)
+        return std::max(std::min(num_threads, h / 16), 1);
+
+    return 1;
+}
+
 static void vresize_two(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp0, unsigned char* Dp1, short b0, short b1, short b2, short b3)
 {
     int dx = 0;
+#if __SSE2__
+    dx = resize_bilinear_vresize_two_sse(rows0p, rows1p, wsize, Dp0, Dp1, b0, b1, b2, b3);
+    rows0p += dx;
+    rows1p += dx;
+    Dp0 += dx;
+    Dp1 += dx;
+#endif // __SSE2__
 #if __ARM_NEON
     int16x8_t _b0 = vdupq_n_s16(b0);
     int16x8_t _b1 = vdupq_n_s16(b1);
@@ -116,6 +137,12 @@ static void vresize_two(const short* rows0p, const short* rows1p, int wsize, uns
 static void vresize_one(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp, short b0, short b1)
 {
     int dx = 0;
+#if __SSE2__
+    dx = resize_bilinear_vresize_one_sse(rows0p, rows1p, wsize, Dp, b0, b1);
+    rows0p += dx;
+    rows1p += dx;
+    Dp += dx;
+#endif // __SSE2__
 #if __ARM_NEON
     int16x8_t _b0 = vdupq_n_s16(b0);
     int16x8_t _b1 = vdupq_n_s16(b1);
@@ -208,6 +235,26 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, unsigned c
 }
 
 void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+{
+    return resize_bilinear_c1(src, srcw, srch, srcstride, dst, w, h, stride, 1);
+}
+
+void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+{
+    return resize_bilinear_c2(src, srcw, srch, srcstride, dst, w, h, stride, 1);
+}
+
+void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+{
+    return resize_bilinear_c3(src, srcw, srch, srcstride, dst, w, h, stride, 1);
+}
+
+void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+{
+    return resize_bilinear_c4(src, srcw, srch, srcstride, dst, w, h, stride, 1);
+}
+
+void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads)
 {
     const int INTER_RESIZE_COEF_BITS = 11;
     const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
@@ -284,96 +331,120 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstr
 
 #undef SATURATE_CAST_SHORT
 
-    // loop body
-    Mat rowsbuf0(w, (size_t)2u);
-    Mat rowsbuf1(w, (size_t)2u);
-    short* rows0 = (short*)rowsbuf0.data;
-    short* rows1 = (short*)rowsbuf1.data;
+    // resize large images in bands of rows, each band keeps its own pair of horizontal rows
+    const int nT = resize_band_count(w, h, num_threads);
+    const int band = (h + nT - 1) / nT;
 
-    int prev_sy1 = -2;
-
-    for (int dy = 0; dy < h; dy++)
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
     {
-        sy = yofs[dy];
+        const int dy_begin = std::min(t * band, h);
+        const int dy_end = std::min(dy_begin + band, h);
 
-        if (sy == prev_sy1)
-        {
-            // reuse all rows
-        }
-        else if (sy == prev_sy1 + 1)
+        // loop body
+        Mat rowsbuf0(w, (size_t)2u);
+        Mat rowsbuf1(w, (size_t)2u);
+        short* rows0 = (short*)rowsbuf0.data;
+        short* rows1 = (short*)rowsbuf1.data;
+
+        const short* ibetap = ibeta + dy_begin * 2;
+
+        int prev_sy1 = -2;
+
+        for (int dy = dy_begin; dy < dy_end; dy++)
         {
-            // hresize one row
-            short* rows0_old = rows0;
-            rows0 = rows1;
-            rows1 = rows0_old;
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            const int sy = yofs[dy];
+
+            if (sy == prev_sy1)
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // reuse all rows
+            }
+            else if (sy == prev_sy1 + 1)
+            {
+                // hresize one row
+                short* rows0_old = rows0;
+                rows0 = rows1;
+                rows1 = rows0_old;
+                const unsigned char* S1 = src + srcstride * (sy + 1);
+
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c1_sse(S1, srcw, xofs, ialpha, rows1, w);
+#endif // __SSE2__
 
-                const unsigned char* S1p = S1 + sx;
-                rows1p[dx] = (S1p[0] * a0 + S1p[1] * a1) >> 4;
+                const short* ialphap = ialpha + dx * 2;
+                short* rows1p = rows1;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
 
-                ialphap += 2;
+                    const unsigned char* S1p = S1 + sx;
+                    rows1p[dx] = (S1p[0] * a0 + S1p[1] * a1) >> 4;
+
+                    ialphap += 2;
+                }
             }
-        }
-        else
-        {
-            // hresize two rows
-            const unsigned char* S0 = src + srcstride * (sy);
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            else
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // hresize two rows
+                const unsigned char* S0 = src + srcstride * (sy);
+                const unsigned char* S1 = src + srcstride * (sy + 1);
 
-                const unsigned char* S0p = S0 + sx;
-                const unsigned char* S1p = S1 + sx;
-                rows0p[dx] = (S0p[0] * a0 + S0p[1] * a1) >> 4;
-                rows1p[dx] = (S1p[0] * a0 + S1p[1] * a1) >> 4;
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c1_sse(S0, srcw, xofs, ialpha, rows0, w);
+                resize_bilinear_hresize_c1_sse(S1, srcw, xofs, ialpha, rows1, w);
+#endif // __SSE2__
 
-                ialphap += 2;
+                const short* ialphap = ialpha + dx * 2;
+                short* rows0p = rows0;
+                short* rows1p = rows1;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
+
+                    const unsigned char* S0p = S0 + sx;
+                    const unsigned char* S1p = S1 + sx;
+                    rows0p[dx] = (S0p[0] * a0 + S0p[1] * a1) >> 4;
+                    rows1p[dx] = (S1p[0] * a0 + S1p[1] * a1) >> 4;
+
+                    ialphap += 2;
+                }
             }
-        }
 
-        prev_sy1 = sy;
+            prev_sy1 = sy;
 
-        if (dy + 1 < h && yofs[dy + 1] == sy)
-        {
-            // vresize for two rows
-            unsigned char* Dp0 = dst + stride * dy;
-            unsigned char* Dp1 = dst + stride * (dy + 1);
+            if (dy + 1 < dy_end && yofs[dy + 1] == sy)
+            {
+                // vresize for two rows
+                unsigned char* Dp0 = dst + stride * dy;
+                unsigned char* Dp1 = dst + stride * (dy + 1);
 
-            vresize_two(rows0, rows1, w, Dp0, Dp1, ibeta[0], ibeta[1], ibeta[2], ibeta[3]);
+                vresize_two(rows0, rows1, w, Dp0, Dp1, ibetap[0], ibetap[1], ibetap[2], ibetap[3]);
 
-            ibeta += 4;
-            dy += 1;
-        }
-        else
-        {
-            // vresize
-            unsigned char* Dp = dst + stride * dy;
+                ibetap += 4;
+                dy += 1;
+            }
+            else
+            {
+                // vresize
+                unsigned char* Dp = dst + stride * dy;
 
-            vresize_one(rows0, rows1, w, Dp, ibeta[0], ibeta[1]);
+                vresize_one(rows0, rows1, w, Dp, ibetap[0], ibetap[1]);
 
-            ibeta += 2;
+                ibetap += 2;
+            }
         }
     }
 
     delete[] buf;
 }
 
-void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads)
 {
     const int INTER_RESIZE_COEF_BITS = 11;
     const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
@@ -450,151 +521,175 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstr
 
 #undef SATURATE_CAST_SHORT
 
-    // loop body
-    Mat rowsbuf0(w * 2 + 2, (size_t)2u);
-    Mat rowsbuf1(w * 2 + 2, (size_t)2u);
-    short* rows0 = (short*)rowsbuf0.data;
-    short* rows1 = (short*)rowsbuf1.data;
-
-    int prev_sy1 = -2;
+    // resize large images in bands of rows, each band keeps its own pair of horizontal rows
+    const int nT = resize_band_count(w, h, num_threads);
+    const int band = (h + nT - 1) / nT;
 
-    for (int dy = 0; dy < h; dy++)
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
     {
-        sy = yofs[dy];
+        const int dy_begin = std::min(t * band, h);
+        const int dy_end = std::min(dy_begin + band, h);
 
-        if (sy == prev_sy1)
-        {
-            // reuse all rows
-        }
-        else if (sy == prev_sy1 + 1)
+        // loop body
+        Mat rowsbuf0(w * 2 + 2, (size_t)2u);
+        Mat rowsbuf1(w * 2 + 2, (size_t)2u);
+        short* rows0 = (short*)rowsbuf0.data;
+        short* rows1 = (short*)rowsbuf1.data;
+
+        const short* ibetap = ibeta + dy_begin * 2;
+
+        int prev_sy1 = -2;
+
+        for (int dy = dy_begin; dy < dy_end; dy++)
         {
-            // hresize one row
-            short* rows0_old = rows0;
-            rows0 = rows1;
-            rows1 = rows0_old;
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            const int sy = yofs[dy];
+
+            if (sy == prev_sy1)
+            {
+                // reuse all rows
+            }
+            else if (sy == prev_sy1 + 1)
             {
-                sx = xofs[dx];
+                // hresize one row
+                short* rows0_old = rows0;
+                rows0 = rows1;
+                rows1 = rows0_old;
+                const unsigned char* S1 = src + srcstride * (sy + 1);
+
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c2_sse(S1, srcw * 2, xofs, ialpha, rows1, w);
+#endif // __SSE2__
 
-                const unsigned char* S1p = S1 + sx;
+                const short* ialphap = ialpha + dx * 2;
+                short* rows1p = rows1 + dx * 2;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+
+                    const unsigned char* S1p = S1 + sx;
 #if __ARM_NEON
-                int16x4_t _a0a1XX = vld1_s16(ialphap);
-                int16x4_t _a0a0a1a1 = vzip_s16(_a0a1XX, _a0a1XX).val[0];
-                uint8x8_t _S1 = uint8x8_t();
-
-                _S1 = vld1_lane_u8(S1p, _S1, 0);
-                _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
-                _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
-                _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
-
-                int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
-                int16x4_t _S1lowhigh = vget_low_s16(_S116);
-                int32x4_t _S1ma0a1 = vmull_s16(_S1lowhigh, _a0a0a1a1);
-                int32x2_t _rows1low = vadd_s32(vget_low_s32(_S1ma0a1), vget_high_s32(_S1ma0a1));
-                int32x4_t _rows1 = vcombine_s32(_rows1low, vget_high_s32(_S1ma0a1));
-                int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
-                vst1_s16(rows1p, _rows1_sr4);
+                    int16x4_t _a0a1XX = vld1_s16(ialphap);
+                    int16x4_t _a0a0a1a1 = vzip_s16(_a0a1XX, _a0a1XX).val[0];
+                    uint8x8_t _S1 = uint8x8_t();
+
+                    _S1 = vld1_lane_u8(S1p, _S1, 0);
+                    _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
+                    _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
+                    _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
+
+                    int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
+                    int16x4_t _S1lowhigh = vget_low_s16(_S116);
+                    int32x4_t _S1ma0a1 = vmull_s16(_S1lowhigh, _a0a0a1a1);
+                    int32x2_t _rows1low = vadd_s32(vget_low_s32(_S1ma0a1), vget_high_s32(_S1ma0a1));
+                    int32x4_t _rows1 = vcombine_s32(_rows1low, vget_high_s32(_S1ma0a1));
+                    int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
+                    vst1_s16(rows1p, _rows1_sr4);
 #else
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
 
-                rows1p[0] = (S1p[0] * a0 + S1p[2] * a1) >> 4;
-                rows1p[1] = (S1p[1] * a0 + S1p[3] * a1) >> 4;
+                    rows1p[0] = (S1p[0] * a0 + S1p[2] * a1) >> 4;
+                    rows1p[1] = (S1p[1] * a0 + S1p[3] * a1) >> 4;
 #endif // __ARM_NEON
 
-                ialphap += 2;
-                rows1p += 2;
+                    ialphap += 2;
+                    rows1p += 2;
+                }
             }
-        }
-        else
-        {
-            // hresize two rows
-            const unsigned char* S0 = src + srcstride * (sy);
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            else
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // hresize two rows
+                const unsigned char* S0 = src + srcstride * (sy);
+                const unsigned char* S1 = src + srcstride * (sy + 1);
 
-                const unsigned char* S0p = S0 + sx;
-                const unsigned char* S1p = S1 + sx;
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c2_sse(S0, srcw * 2, xofs, ialpha, rows0, w);
+                resize_bilinear_hresize_c2_sse(S1, srcw * 2, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+                const short* ialphap = ialpha + dx * 2;
+                short* rows0p = rows0 + dx * 2;
+                short* rows1p = rows1 + dx * 2;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
+
+                    const unsigned char* S0p = S0 + sx;
+                    const unsigned char* S1p = S1 + sx;
 #if __ARM_NEON
-                int16x4_t _a0 = vdup_n_s16(a0);
-                int16x4_t _a1 = vdup_n_s16(a1);
-                uint8x8_t _S0 = uint8x8_t();
-                uint8x8_t _S1 = uint8x8_t();
-
-                _S0 = vld1_lane_u8(S0p, _S0, 0);
-                _S0 = vld1_lane_u8(S0p + 1, _S0, 1);
-                _S0 = vld1_lane_u8(S0p + 2, _S0, 2);
-                _S0 = vld1_lane_u8(S0p + 3, _S0, 3);
-
-                _S1 = vld1_lane_u8(S1p, _S1, 0);
-                _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
-                _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
-                _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
-
-                int16x8_t _S016 = vreinterpretq_s16_u16(vmovl_u8(_S0));
-                int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
-                int16x4_t _S0lowhigh = vget_low_s16(_S016);
-                int16x4_t _S1lowhigh = vget_low_s16(_S116);
-                int32x2x2_t _S0S1low_S0S1high = vtrn_s32(vreinterpret_s32_s16(_S0lowhigh), vreinterpret_s32_s16(_S1lowhigh));
-                int32x4_t _rows01 = vmull_s16(vreinterpret_s16_s32(_S0S1low_S0S1high.val[0]), _a0);
-                _rows01 = vmlal_s16(_rows01, vreinterpret_s16_s32(_S0S1low_S0S1high.val[1]), _a1);
-                int16x4_t _rows01_sr4 = vshrn_n_s32(_rows01, 4);
-                int16x4_t _rows1_sr4 = vext_s16(_rows01_sr4, _rows01_sr4, 2);
-                vst1_s16(rows0p, _rows01_sr4);
-                vst1_s16(rows1p, _rows1_sr4);
+                    int16x4_t _a0 = vdup_n_s16(a0);
+                    int16x4_t _a1 = vdup_n_s16(a1);
+                    uint8x8_t _S0 = uint8x8_t();
+                    uint8x8_t _S1 = uint8x8_t();
+
+                    _S0 = vld1_lane_u8(S0p, _S0, 0);
+                    _S0 = vld1_lane_u8(S0p + 1, _S0, 1);
+                    _S0 = vld1_lane_u8(S0p + 2, _S0, 2);
+                    _S0 = vld1_lane_u8(S0p + 3, _S0, 3);
+
+                    _S1 = vld1_lane_u8(S1p, _S1, 0);
+                    _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
+                    _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
+                    _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
+
+                    int16x8_t _S016 = vreinterpretq_s16_u16(vmovl_u8(_S0));
+                    int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
+                    int16x4_t _S0lowhigh = vget_low_s16(_S016);
+                    int16x4_t _S1lowhigh = vget_low_s16(_S116);
+                    int32x2x2_t _S0S1low_S0S1high = vtrn_s32(vreinterpret_s32_s16(_S0lowhigh), vreinterpret_s32_s16(_S1lowhigh));
+                    int32x4_t _rows01 = vmull_s16(vreinterpret_s16_s32(_S0S1low_S0S1high.val[0]), _a0);
+                    _rows01 = vmlal_s16(_rows01, vreinterpret_s16_s32(_S0S1low_S0S1high.val[1]), _a1);
+                    int16x4_t _rows01_sr4 = vshrn_n_s32(_rows01, 4);
+                    int16x4_t _rows1_sr4 = vext_s16(_rows01_sr4, _rows01_sr4, 2);
+                    vst1_s16(rows0p, _rows01_sr4);
+                    vst1_s16(rows1p, _rows1_sr4);
 #else
-                rows0p[0] = (S0p[0] * a0 + S0p[2] * a1) >> 4;
-                rows0p[1] = (S0p[1] * a0 + S0p[3] * a1) >> 4;
-                rows1p[0] = (S1p[0] * a0 + S1p[2] * a1) >> 4;
-                rows1p[1] = (S1p[1] * a0 + S1p[3] * a1) >> 4;
+                    rows0p[0] = (S0p[0] * a0 + S0p[2] * a1) >> 4;
+                    rows0p[1] = (S0p[1] * a0 + S0p[3] * a1) >> 4;
+                    rows1p[0] = (S1p[0] * a0 + S1p[2] * a1) >> 4;
+                    rows1p[1] = (S1p[1] * a0 + S1p[3] * a1) >> 4;
 #endif // __ARM_NEON
 
-                ialphap += 2;
-                rows0p += 2;
-                rows1p += 2;
+                    ialphap += 2;
+                    rows0p += 2;
+                    rows1p += 2;
+                }
             }
-        }
 
-        prev_sy1 = sy;
+            prev_sy1 = sy;
 
-        if (dy + 1 < h && yofs[dy + 1] == sy)
-        {
-            // vresize for two rows
-            unsigned char* Dp0 = dst + stride * dy;
-            unsigned char* Dp1 = dst + stride * (dy + 1);
+            if (dy + 1 < dy_end && yofs[dy + 1] == sy)
+            {
+                // vresize for two rows
+                unsigned char* Dp0 = dst + stride * dy;
+                unsigned char* Dp1 = dst + stride * (dy + 1);
 
-            vresize_two(rows0, rows1, w * 2, Dp0, Dp1, ibeta[0], ibeta[1], ibeta[2], ibeta[3]);
+                vresize_two(rows0, rows1, w * 2, Dp0, Dp1, ibetap[0], ibetap[1], ibetap[2], ibetap[3]);
 
-            ibeta += 4;
-            dy += 1;
-        }
-        else
-        {
-            // vresize
-            unsigned char* Dp = dst + stride * dy;
+                ibetap += 4;
+                dy += 1;
+            }
+            else
+            {
+                // vresize
+                unsigned char* Dp = dst + stride * dy;
 
-            vresize_one(rows0, rows1, w * 2, Dp, ibeta[0], ibeta[1]);
+                vresize_one(rows0, rows1, w * 2, Dp, ibetap[0], ibetap[1]);
 
-            ibeta += 2;
+                ibetap += 2;
+            }
         }
     }
 
     delete[] buf;
 }
 
-void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads)
 {
     const int INTER_RESIZE_COEF_BITS = 11;
     const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
@@ -671,162 +766,186 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstr
 
 #undef SATURATE_CAST_SHORT
 
-    // loop body
-    Mat rowsbuf0(w * 3 + 1, (size_t)2u);
-    Mat rowsbuf1(w * 3 + 1, (size_t)2u);
-    short* rows0 = (short*)rowsbuf0.data;
-    short* rows1 = (short*)rowsbuf1.data;
+    // resize large images in bands of rows, each band keeps its own pair of horizontal rows
+    const int nT = resize_band_count(w, h, num_threads);
+    const int band = (h + nT - 1) / nT;
 
-    int prev_sy1 = -2;
-
-    for (int dy = 0; dy < h; dy++)
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
     {
-        sy = yofs[dy];
+        const int dy_begin = std::min(t * band, h);
+        const int dy_end = std::min(dy_begin + band, h);
 
-        if (sy == prev_sy1)
-        {
-            // reuse all rows
-        }
-        else if (sy == prev_sy1 + 1)
+        // loop body
+        Mat rowsbuf0(w * 3 + 1, (size_t)2u);
+        Mat rowsbuf1(w * 3 + 1, (size_t)2u);
+        short* rows0 = (short*)rowsbuf0.data;
+        short* rows1 = (short*)rowsbuf1.data;
+
+        const short* ibetap = ibeta + dy_begin * 2;
+
+        int prev_sy1 = -2;
+
+        for (int dy = dy_begin; dy < dy_end; dy++)
         {
-            // hresize one row
-            short* rows0_old = rows0;
-            rows0 = rows1;
-            rows1 = rows0_old;
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            const int sy = yofs[dy];
+
+            if (sy == prev_sy1)
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // reuse all rows
+            }
+            else if (sy == prev_sy1 + 1)
+            {
+                // hresize one row
+                short* rows0_old = rows0;
+                rows0 = rows1;
+                rows1 = rows0_old;
+                const unsigned char* S1 = src + srcstride * (sy + 1);
+
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c3_sse(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
 
-                const unsigned char* S1p = S1 + sx;
+                const short* ialphap = ialpha + dx * 2;
+                short* rows1p = rows1 + dx * 3;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
+
+                    const unsigned char* S1p = S1 + sx;
 #if __ARM_NEON
-                int16x4_t _a0 = vdup_n_s16(a0);
-                int16x4_t _a1 = vdup_n_s16(a1);
-                uint8x8_t _S1 = uint8x8_t();
-
-                _S1 = vld1_lane_u8(S1p, _S1, 0);
-                _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
-                _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
-                _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
-                _S1 = vld1_lane_u8(S1p + 4, _S1, 4);
-                _S1 = vld1_lane_u8(S1p + 5, _S1, 5);
-
-                int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
-                int16x4_t _S1low = vget_low_s16(_S116);
-                int16x4_t _S1high = vext_s16(_S1low, vget_high_s16(_S116), 3);
-                int32x4_t _rows1 = vmull_s16(_S1low, _a0);
-                _rows1 = vmlal_s16(_rows1, _S1high, _a1);
-                int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
-                vst1_s16(rows1p, _rows1_sr4);
+                    int16x4_t _a0 = vdup_n_s16(a0);
+                    int16x4_t _a1 = vdup_n_s16(a1);
+                    uint8x8_t _S1 = uint8x8_t();
+
+                    _S1 = vld1_lane_u8(S1p, _S1, 0);
+                    _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
+                    _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
+                    _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
+                    _S1 = vld1_lane_u8(S1p + 4, _S1, 4);
+                    _S1 = vld1_lane_u8(S1p + 5, _S1, 5);
+
+                    int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
+                    int16x4_t _S1low = vget_low_s16(_S116);
+                    int16x4_t _S1high = vext_s16(_S1low, vget_high_s16(_S116), 3);
+                    int32x4_t _rows1 = vmull_s16(_S1low, _a0);
+                    _rows1 = vmlal_s16(_rows1, _S1high, _a1);
+                    int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
+                    vst1_s16(rows1p, _rows1_sr4);
 #else
-                rows1p[0] = (S1p[0] * a0 + S1p[3] * a1) >> 4;
-                rows1p[1] = (S1p[1] * a0 + S1p[4] * a1) >> 4;
-                rows1p[2] = (S1p[2] * a0 + S1p[5] * a1) >> 4;
+                    rows1p[0] = (S1p[0] * a0 + S1p[3] * a1) >> 4;
+                    rows1p[1] = (S1p[1] * a0 + S1p[4] * a1) >> 4;
+                    rows1p[2] = (S1p[2] * a0 + S1p[5] * a1) >> 4;
 #endif // __ARM_NEON
 
-                ialphap += 2;
-                rows1p += 3;
+                    ialphap += 2;
+                    rows1p += 3;
+                }
             }
-        }
-        else
-        {
-            // hresize two rows
-            const unsigned char* S0 = src + srcstride * (sy);
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            else
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // hresize two rows
+                const unsigned char* S0 = src + srcstride * (sy);
+                const unsigned char* S1 = src + srcstride * (sy + 1);
+
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c3_sse(S0, xofs, ialpha, rows0, w);
+                resize_bilinear_hresize_c3_sse(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
 
-                const unsigned char* S0p = S0 + sx;
-                const unsigned char* S1p = S1 + sx;
+                const short* ialphap = ialpha + dx * 2;
+                short* rows0p = rows0 + dx * 3;
+                short* rows1p = rows1 + dx * 3;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
+
+                    const unsigned char* S0p = S0 + sx;
+                    const unsigned char* S1p = S1 + sx;
 #if __ARM_NEON
-                int16x4_t _a0 = vdup_n_s16(a0);
-                int16x4_t _a1 = vdup_n_s16(a1);
-                uint8x8_t _S0 = uint8x8_t();
-                uint8x8_t _S1 = uint8x8_t();
-
-                _S0 = vld1_lane_u8(S0p, _S0, 0);
-                _S0 = vld1_lane_u8(S0p + 1, _S0, 1);
-                _S0 = vld1_lane_u8(S0p + 2, _S0, 2);
-                _S0 = vld1_lane_u8(S0p + 3, _S0, 3);
-                _S0 = vld1_lane_u8(S0p + 4, _S0, 4);
-                _S0 = vld1_lane_u8(S0p + 5, _S0, 5);
-
-                _S1 = vld1_lane_u8(S1p, _S1, 0);
-                _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
-                _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
-                _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
-                _S1 = vld1_lane_u8(S1p + 4, _S1, 4);
-                _S1 = vld1_lane_u8(S1p + 5, _S1, 5);
-
-                int16x8_t _S016 = vreinterpretq_s16_u16(vmovl_u8(_S0));
-                int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
-                int16x4_t _S0low = vget_low_s16(_S016);
-                int16x4_t _S1low = vget_low_s16(_S116);
-                int16x4_t _S0high = vext_s16(_S0low, vget_high_s16(_S016), 3);
-                int16x4_t _S1high = vext_s16(_S1low, vget_high_s16(_S116), 3);
-                int32x4_t _rows0 = vmull_s16(_S0low, _a0);
-                int32x4_t _rows1 = vmull_s16(_S1low, _a0);
-                _rows0 = vmlal_s16(_rows0, _S0high, _a1);
-                _rows1 = vmlal_s16(_rows1, _S1high, _a1);
-                int16x4_t _rows0_sr4 = vshrn_n_s32(_rows0, 4);
-                int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
-                vst1_s16(rows0p, _rows0_sr4);
-                vst1_s16(rows1p, _rows1_sr4);
+                    int16x4_t _a0 = vdup_n_s16(a0);
+                    int16x4_t _a1 = vdup_n_s16(a1);
+                    uint8x8_t _S0 = uint8x8_t();
+                    uint8x8_t _S1 = uint8x8_t();
+
+                    _S0 = vld1_lane_u8(S0p, _S0, 0);
+                    _S0 = vld1_lane_u8(S0p + 1, _S0, 1);
+                    _S0 = vld1_lane_u8(S0p + 2, _S0, 2);
+                    _S0 = vld1_lane_u8(S0p + 3, _S0, 3);
+                    _S0 = vld1_lane_u8(S0p + 4, _S0, 4);
+                    _S0 = vld1_lane_u8(S0p + 5, _S0, 5);
+
+                    _S1 = vld1_lane_u8(S1p, _S1, 0);
+                    _S1 = vld1_lane_u8(S1p + 1, _S1, 1);
+                    _S1 = vld1_lane_u8(S1p + 2, _S1, 2);
+                    _S1 = vld1_lane_u8(S1p + 3, _S1, 3);
+                    _S1 = vld1_lane_u8(S1p + 4, _S1, 4);
+                    _S1 = vld1_lane_u8(S1p + 5, _S1, 5);
+
+                    int16x8_t _S016 = vreinterpretq_s16_u16(vmovl_u8(_S0));
+                    int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
+                    int16x4_t _S0low = vget_low_s16(_S016);
+                    int16x4_t _S1low = vget_low_s16(_S116);
+                    int16x4_t _S0high = vext_s16(_S0low, vget_high_s16(_S016), 3);
+                    int16x4_t _S1high = vext_s16(_S1low, vget_high_s16(_S116), 3);
+                    int32x4_t _rows0 = vmull_s16(_S0low, _a0);
+                    int32x4_t _rows1 = vmull_s16(_S1low, _a0);
+                    _rows0 = vmlal_s16(_rows0, _S0high, _a1);
+                    _rows1 = vmlal_s16(_rows1, _S1high, _a1);
+                    int16x4_t _rows0_sr4 = vshrn_n_s32(_rows0, 4);
+                    int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
+                    vst1_s16(rows0p, _rows0_sr4);
+                    vst1_s16(rows1p, _rows1_sr4);
 #else
-                rows0p[0] = (S0p[0] * a0 + S0p[3] * a1) >> 4;
-                rows0p[1] = (S0p[1] * a0 + S0p[4] * a1) >> 4;
-                rows0p[2] = (S0p[2] * a0 + S0p[5] * a1) >> 4;
-                rows1p[0] = (S1p[0] * a0 + S1p[3] * a1) >> 4;
-                rows1p[1] = (S1p[1] * a0 + S1p[4] * a1) >> 4;
-                rows1p[2] = (S1p[2] * a0 + S1p[5] * a1) >> 4;
+                    rows0p[0] = (S0p[0] * a0 + S0p[3] * a1) >> 4;
+                    rows0p[1] = (S0p[1] * a0 + S0p[4] * a1) >> 4;
+                    rows0p[2] = (S0p[2] * a0 + S0p[5] * a1) >> 4;
+                    rows1p[0] = (S1p[0] * a0 + S1p[3] * a1) >> 4;
+                    rows1p[1] = (S1p[1] * a0 + S1p[4] * a1) >> 4;
+                    rows1p[2] = (S1p[2] * a0 + S1p[5] * a1) >> 4;
 #endif // __ARM_NEON
 
-                ialphap += 2;
-                rows0p += 3;
-                rows1p += 3;
+                    ialphap += 2;
+                    rows0p += 3;
+                    rows1p += 3;
+                }
             }
-        }
 
-        prev_sy1 = sy;
+            prev_sy1 = sy;
 
-        if (dy + 1 < h && yofs[dy + 1] == sy)
-        {
-            // vresize for two rows
-            unsigned char* Dp0 = dst + stride * dy;
-            unsigned char* Dp1 = dst + stride * (dy + 1);
+            if (dy + 1 < dy_end && yofs[dy + 1] == sy)
+            {
+                // vresize for two rows
+                unsigned char* Dp0 = dst + stride * dy;
+                unsigned char* Dp1 = dst + stride * (dy + 1);
 
-            vresize_two(rows0, rows1, w * 3, Dp0, Dp1, ibeta[0], ibeta[1], ibeta[2], ibeta[3]);
+                vresize_two(rows0, rows1, w * 3, Dp0, Dp1, ibetap[0], ibetap[1], ibetap[2], ibetap[3]);
 
-            ibeta += 4;
-            dy += 1;
-        }
-        else
-        {
-            // vresize
-            unsigned char* Dp = dst + stride * dy;
+                ibetap += 4;
+                dy += 1;
+            }
+            else
+            {
+                // vresize
+                unsigned char* Dp = dst + stride * dy;
 
-            vresize_one(rows0, rows1, w * 3, Dp, ibeta[0], ibeta[1]);
+                vresize_one(rows0, rows1, w * 3, Dp, ibetap[0], ibetap[1]);
 
-            ibeta += 2;
+                ibetap += 2;
+            }
         }
     }
 
     delete[] buf;
 }
 
-void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride)
+void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int num_threads)
 {
     const int INTER_RESIZE_COEF_BITS = 11;
     const int INTER_RESIZE_COEF_SCALE = 1 << INTER_RESIZE_COEF_BITS;
@@ -903,135 +1022,159 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstr
 
 #undef SATURATE_CAST_SHORT
 
-    // loop body
-    Mat rowsbuf0(w * 4, (size_t)2u);
-    Mat rowsbuf1(w * 4, (size_t)2u);
-    short* rows0 = (short*)rowsbuf0.data;
-    short* rows1 = (short*)rowsbuf1.data;
+    // resize large images in bands of rows, each band keeps its own pair of horizontal rows
+    const int nT = resize_band_count(w, h, num_threads);
+    const int band = (h + nT - 1) / nT;
 
-    int prev_sy1 = -2;
-
-    for (int dy = 0; dy < h; dy++)
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
     {
-        sy = yofs[dy];
+        const int dy_begin = std::min(t * band, h);
+        const int dy_end = std::min(dy_begin + band, h);
 
-        if (sy == prev_sy1)
-        {
-            // reuse all rows
-        }
-        else if (sy == prev_sy1 + 1)
+        // loop body
+        Mat rowsbuf0(w * 4, (size_t)2u);
+        Mat rowsbuf1(w * 4, (size_t)2u);
+        short* rows0 = (short*)rowsbuf0.data;
+        short* rows1 = (short*)rowsbuf1.data;
+
+        const short* ibetap = ibeta + dy_begin * 2;
+
+        int prev_sy1 = -2;
+
+        for (int dy = dy_begin; dy < dy_end; dy++)
         {
-            // hresize one row
-            short* rows0_old = rows0;
-            rows0 = rows1;
-            rows1 = rows0_old;
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            const int sy = yofs[dy];
+
+            if (sy == prev_sy1)
+            {
+                // reuse all rows
+            }
+            else if (sy == prev_sy1 + 1)
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // hresize one row
+                short* rows0_old = rows0;
+                rows0 = rows1;
+                rows1 = rows0_old;
+                const unsigned char* S1 = src + srcstride * (sy + 1);
 
-                const unsigned char* S1p = S1 + sx;
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c4_sse(S1, srcw * 4, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+                const short* ialphap = ialpha + dx * 2;
+                short* rows1p = rows1 + dx * 4;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
+
+                    const unsigned char* S1p = S1 + sx;
 #if __ARM_NEON
-                int16x4_t _a0 = vdup_n_s16(a0);
-                int16x4_t _a1 = vdup_n_s16(a1);
-                uint8x8_t _S1 = vld1_u8(S1p);
-                int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
-                int16x4_t _S1low = vget_low_s16(_S116);
-                int16x4_t _S1high = vget_high_s16(_S116);
-                int32x4_t _rows1 = vmull_s16(_S1low, _a0);
-                _rows1 = vmlal_s16(_rows1, _S1high, _a1);
-                int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
-                vst1_s16(rows1p, _rows1_sr4);
+                    int16x4_t _a0 = vdup_n_s16(a0);
+                    int16x4_t _a1 = vdup_n_s16(a1);
+                    uint8x8_t _S1 = vld1_u8(S1p);
+                    int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
+                    int16x4_t _S1low = vget_low_s16(_S116);
+                    int16x4_t _S1high = vget_high_s16(_S116);
+                    int32x4_t _rows1 = vmull_s16(_S1low, _a0);
+                    _rows1 = vmlal_s16(_rows1, _S1high, _a1);
+                    int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
+                    vst1_s16(rows1p, _rows1_sr4);
 #else
-                rows1p[0] = (S1p[0] * a0 + S1p[4] * a1) >> 4;
-                rows1p[1] = (S1p[1] * a0 + S1p[5] * a1) >> 4;
-                rows1p[2] = (S1p[2] * a0 + S1p[6] * a1) >> 4;
-                rows1p[3] = (S1p[3] * a0 + S1p[7] * a1) >> 4;
+                    rows1p[0] = (S1p[0] * a0 + S1p[4] * a1) >> 4;
+                    rows1p[1] = (S1p[1] * a0 + S1p[5] * a1) >> 4;
+                    rows1p[2] = (S1p[2] * a0 + S1p[6] * a1) >> 4;
+                    rows1p[3] = (S1p[3] * a0 + S1p[7] * a1) >> 4;
 #endif // __ARM_NEON
 
-                ialphap += 2;
-                rows1p += 4;
+                    ialphap += 2;
+                    rows1p += 4;
+                }
             }
-        }
-        else
-        {
-            // hresize two rows
-            const unsigned char* S0 = src + srcstride * (sy);
-            const unsigned char* S1 = src + srcstride * (sy + 1);
-
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            else
             {
-                sx = xofs[dx];
-                short a0 = ialphap[0];
-                short a1 = ialphap[1];
+                // hresize two rows
+                const unsigned char* S0 = src + srcstride * (sy);
+                const unsigned char* S1 = src + srcstride * (sy + 1);
+
+                int dx = 0;
+#if __SSE2__
+                dx = resize_bilinear_hresize_c4_sse(S0, srcw * 4, xofs, ialpha, rows0, w);
+                resize_bilinear_hresize_c4_sse(S1, srcw * 4, xofs, ialpha, rows1, w);
+#endif // __SSE2__
 
-                const unsigned char* S0p = S0 + sx;
-                const unsigned char* S1p = S1 + sx;
+                const short* ialphap = ialpha + dx * 2;
+                short* rows0p = rows0 + dx * 4;
+                short* rows1p = rows1 + dx * 4;
+                for (; dx < w; dx++)
+                {
+                    const int sx = xofs[dx];
+                    short a0 = ialphap[0];
+                    short a1 = ialphap[1];
+
+                    const unsigned char* S0p = S0 + sx;
+                    const unsigned char* S1p = S1 + sx;
 #if __ARM_NEON
-                int16x4_t _a0 = vdup_n_s16(a0);
-                int16x4_t _a1 = vdup_n_s16(a1);
-                uint8x8_t _S0 = vld1_u8(S0p);
-                uint8x8_t _S1 = vld1_u8(S1p);
-                int16x8_t _S016 = vreinterpretq_s16_u16(vmovl_u8(_S0));
-                int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
-                int16x4_t _S0low = vget_low_s16(_S016);
-                int16x4_t _S1low = vget_low_s16(_S116);
-                int16x4_t _S0high = vget_high_s16(_S016);
-                int16x4_t _S1high = vget_high_s16(_S116);
-                int32x4_t _rows0 = vmull_s16(_S0low, _a0);
-                int32x4_t _rows1 = vmull_s16(_S1low, _a0);
-                _rows0 = vmlal_s16(_rows0, _S0high, _a1);
-                _rows1 = vmlal_s16(_rows1, _S1high, _a1);
-                int16x4_t _rows0_sr4 = vshrn_n_s32(_rows0, 4);
-                int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
-                vst1_s16(rows0p, _rows0_sr4);
-                vst1_s16(rows1p, _rows1_sr4);
+                    int16x4_t _a0 = vdup_n_s16(a0);
+                    int16x4_t _a1 = vdup_n_s16(a1);
+                    uint8x8_t _S0 = vld1_u8(S0p);
+                    uint8x8_t _S1 = vld1_u8(S1p);
+                    int16x8_t _S016 = vreinterpretq_s16_u16(vmovl_u8(_S0));
+                    int16x8_t _S116 = vreinterpretq_s16_u16(vmovl_u8(_S1));
+                    int16x4_t _S0low = vget_low_s16(_S016);
+                    int16x4_t _S1low = vget_low_s16(_S116);
+                    int16x4_t _S0high = vget_high_s16(_S016);
+                    int16x4_t _S1high = vget_high_s16(_S116);
+                    int32x4_t _rows0 = vmull_s16(_S0low, _a0);
+                    int32x4_t _rows1 = vmull_s16(_S1low, _a0);
+                    _rows0 = vmlal_s16(_rows0, _S0high, _a1);
+                    _rows1 = vmlal_s16(_rows1, _S1high, _a1);
+                    int16x4_t _rows0_sr4 = vshrn_n_s32(_rows0, 4);
+                    int16x4_t _rows1_sr4 = vshrn_n_s32(_rows1, 4);
+                    vst1_s16(rows0p, _rows0_sr4);
+                    vst1_s16(rows1p, _rows1_sr4);
 #else
-                rows0p[0] = (S0p[0] * a0 + S0p[4] * a1) >> 4;
-                rows0p[1] = (S0p[1] * a0 + S0p[5] * a1) >> 4;
-                rows0p[2] = (S0p[2] * a0 + S0p[6] * a1) >> 4;
-                rows0p[3] = (S0p[3] * a0 + S0p[7] * a1) >> 4;
-                rows1p[0] = (S1p[0] * a0 + S1p[4] * a1) >> 4;
-                rows1p[1] = (S1p[1] * a0 + S1p[5] * a1) >> 4;
-                rows1p[2] = (S1p[2] * a0 + S1p[6] * a1) >> 4;
-                rows1p[3] = (S1p[3] * a0 + S1p[7] * a1) >> 4;
+                    rows0p[0] = (S0p[0] * a0 + S0p[4] * a1) >> 4;
+                    rows0p[1] = (S0p[1] * a0 + S0p[5] * a1) >> 4;
+                    rows0p[2] = (S0p[2] * a0 + S0p[6] * a1) >> 4;
+                    rows0p[3] = (S0p[3] * a0 + S0p[7] * a1) >> 4;
+                    rows1p[0] = (S1p[0] * a0 + S1p[4] * a1) >> 4;
+                    rows1p[1] = (S1p[1] * a0 + S1p[5] * a1) >> 4;
+                    rows1p[2] = (S1p[2] * a0 + S1p[6] * a1) >> 4;
+                    rows1p[3] = (S1p[3] * a0 + S1p[7] * a1) >> 4;
 #endif // __ARM_NEON
 
-                ialphap += 2;
-                rows0p += 4;
-                rows1p += 4;
+                    ialphap += 2;
+                    rows0p += 4;
+                    rows1p += 4;
+                }
             }
-        }
 
-        prev_sy1 = sy;
+            prev_sy1 = sy;
 
-        if (dy + 1 < h && yofs[dy + 1] == sy)
-        {
-            // vresize for two rows
-            unsigned char* Dp0 = dst + stride * dy;
-            unsigned char* Dp1 = dst + stride * (dy + 1);
+            if (dy + 1 < dy_end && yofs[dy + 1] == sy)
+            {
+                // vresize for two rows
+                unsigned char* Dp0 = dst + stride * dy;
+                unsigned char* Dp1 = dst + stride * (dy + 1);
 
-            vresize_two(rows0, rows1, w * 4, Dp0, Dp1, ibeta[0], ibeta[1], ibeta[2], ibeta[3]);
+                vresize_two(rows0, rows1, w * 4, Dp0, Dp1, ibetap[0], ibetap[1], ibetap[2], ibetap[3]);
 
-            ibeta += 4;
-            dy += 1;
-        }
-        else
-        {
-            // vresize
-            unsigned char* Dp = dst + stride * dy;
+                ibetap += 4;
+                dy += 1;
+            }
+            else
+            {
+                // vresize
+                unsigned char* Dp = dst + stride * dy;
 
-            vresize_one(rows0, rows1, w * 4, Dp, ibeta[0], ibeta[1]);
+                vresize_one(rows0, rows1, w * 4, Dp, ibetap[0], ibetap[1]);
 
-            ibeta += 2;
+                ibetap += 2;
+            }
         }
     }
 
@@ -0,0 +1,309 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// x86 row kernels for the fixed point bilinear resize in mat_pixel_resize.cpp
+// every kernel handles the leading pixels of a row and returns how many it has done,
+// the caller finishes the remaining pixels with the scalar loop
+// the arithmetic is the same as the scalar code, results are bit-exact
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+int resize_bilinear_hresize_c1_sse_avx2(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w);
+int resize_bilinear_hresize_c2_sse_avx2(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w);
+int resize_bilinear_hresize_c3_sse_avx2(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w);
+int resize_bilinear_hresize_c4_sse_avx2(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w);
+int resize_bilinear_vresize_two_sse_avx2(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp0, unsigned char* Dp1, short b0, short b1, short b2, short b3);
+int resize_bilinear_vresize_one_sse_avx2(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp, short b0, short b1);
+#endif
+
+// rows[dx] = (S[sx] * a0 + S[sx + 1] * a1) >> 4
+// rowsize is the number of readable bytes from S
+static int resize_bilinear_hresize_c1_sse(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return resize_bilinear_hresize_c1_sse_avx2(S, rowsize, xofs, ialpha, rows, w);
+    }
+#endif
+
+    int dx = 0;
+#if __AVX2__
+    for (; dx + 15 < w; dx += 16)
+    {
+        // the gather reads 4 bytes from every tap
+        if (xofs[dx + 15] + 4 > rowsize)
+            break;
+
+        __m256i _p0 = _mm256_i32gather_epi32((const int*)S, _mm256_loadu_si256((const __m256i*)(xofs + dx)), 1);
+        __m256i _p1 = _mm256_i32gather_epi32((const int*)S, _mm256_loadu_si256((const __m256i*)(xofs + dx + 8)), 1);
+
+        // byte 0 and 1 of each lane as a 16bit pair
+        _p0 = _mm256_or_si256(_mm256_and_si256(_p0, _mm256_set1_epi32(0xff)), _mm256_slli_epi32(_mm256_and_si256(_p0, _mm256_set1_epi32(0xff00)), 8));
+        _p1 = _mm256_or_si256(_mm256_and_si256(_p1, _mm256_set1_epi32(0xff)), _mm256_slli_epi32(_mm256_and_si256(_p1, _mm256_set1_epi32(0xff00)), 8));
+
+        __m256i _r0 = _mm256_srai_epi32(_mm256_madd_epi16(_p0, _mm256_loadu_si256((const __m256i*)(ialpha + dx * 2))), 4);
+        __m256i _r1 = _mm256_srai_epi32(_mm256_madd_epi16(_p1, _mm256_loadu_si256((const __m256i*)(ialpha + dx * 2 + 16))), 4);
+
+        __m256i _r = _mm256_permute4x64_epi64(_mm256_packs_epi32(_r0, _r1), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)(rows + dx), _r);
+    }
+#else
+    (void)rowsize;
+#endif // __AVX2__
+    for (; dx + 7 < w; dx += 8)
+    {
+        __m128i _p = _mm_setzero_si128();
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx]), 0);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 1]), 1);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 2]), 2);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 3]), 3);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 4]), 4);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 5]), 5);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 6]), 6);
+        _p = _mm_insert_epi16(_p, *(const unsigned short*)(S + xofs[dx + 7]), 7);
+
+        __m128i _p0 = _mm_unpacklo_epi8(_p, _mm_setzero_si128());
+        __m128i _p1 = _mm_unpackhi_epi8(_p, _mm_setzero_si128());
+
+        __m128i _r0 = _mm_srai_epi32(_mm_madd_epi16(_p0, _mm_loadu_si128((const __m128i*)(ialpha + dx * 2))), 4);
+        __m128i _r1 = _mm_srai_epi32(_mm_madd_epi16(_p1, _mm_loadu_si128((const __m128i*)(ialpha + dx * 2 + 8))), 4);
+
+        _mm_storeu_si128((__m128i*)(rows + dx), _mm_packs_epi32(_r0, _r1));
+    }
+
+    return dx;
+}
+
+// rows[dx * 2 + c] = (S[sx + c] * a0 + S[sx + 2 + c] * a1) >> 4
+static int resize_bilinear_hresize_c2_sse(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return resize_bilinear_hresize_c2_sse_avx2(S, rowsize, xofs, ialpha, rows, w);
+    }
+#endif
+
+    // the two taps of a c2 pixel are exactly 4 bytes
+    (void)rowsize;
+
+    int dx = 0;
+#if __AVX2__
+    for (; dx + 7 < w; dx += 8)
+    {
+        __m256i _p = _mm256_i32gather_epi32((const int*)S, _mm256_loadu_si256((const __m256i*)(xofs + dx)), 1);
+
+        __m256i _p0 = _mm256_unpacklo_epi8(_p, _mm256_setzero_si256());
+        __m256i _p1 = _mm256_unpackhi_epi8(_p, _mm256_setzero_si256());
+        _p0 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_p0, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+        _p1 = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(_p1, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+
+        __m256i _a = _mm256_loadu_si256((const __m256i*)(ialpha + dx * 2));
+        __m256i _r0 = _mm256_srai_epi32(_mm256_madd_epi16(_p0, _mm256_unpacklo_epi32(_a, _a)), 4);
+        __m256i _r1 = _mm256_srai_epi32(_mm256_madd_epi16(_p1, _mm256_unpackhi_epi32(_a, _a)), 4);
+
+        _mm256_storeu_si256((__m256i*)(rows + dx * 2), _mm256_packs_epi32(_r0, _r1));
+    }
+#endif // __AVX2__
+    for (; dx + 3 < w; dx += 4)
+    {
+        __m128i _p = _mm_setr_epi32(*(const int*)(S + xofs[dx]), *(const int*)(S + xofs[dx + 1]), *(const int*)(S + xofs[dx + 2]), *(const int*)(S + xofs[dx + 3]));
+
+        // c0 c1 c0' c1' to c0 c0' c1 c1'
+        __m128i _p0 = _mm_unpacklo_epi8(_p, _mm_setzero_si128());
+        __m128i _p1 = _mm_unpackhi_epi8(_p, _mm_setzero_si128());
+        _p0 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_p0, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+        _p1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_p1, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+
+        __m128i _a = _mm_loadu_si128((const __m128i*)(ialpha + dx * 2));
+        __m128i _r0 = _mm_srai_epi32(_mm_madd_epi16(_p0, _mm_unpacklo_epi32(_a, _a)), 4);
+        __m128i _r1 = _mm_srai_epi32(_mm_madd_epi16(_p1, _mm_unpackhi_epi32(_a, _a)), 4);
+
+        _mm_storeu_si128((__m128i*)(rows + dx * 2), _mm_packs_epi32(_r0, _r1));
+    }
+
+    return dx;
+}
+
+// rows[dx * 3 + c] = (S[sx + c] * a0 + S[sx + 3 + c] * a1) >> 4
+// writes one short past the last pixel, rows must have w * 3 + 1 elements
+static int resize_bilinear_hresize_c3_sse(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return resize_bilinear_hresize_c3_sse_avx2(S, xofs, ialpha, rows, w);
+    }
+#endif
+
+    int dx = 0;
+    for (; dx + 1 < w; dx += 2)
+    {
+        const unsigned char* S0p = S + xofs[dx];
+        const unsigned char* S1p = S + xofs[dx + 1];
+
+        __m128i _p0 = _mm_insert_epi16(_mm_cvtsi32_si128(*(const int*)S0p), *(const unsigned short*)(S0p + 4), 2);
+        __m128i _p1 = _mm_insert_epi16(_mm_cvtsi32_si128(*(const int*)S1p), *(const unsigned short*)(S1p + 4), 2);
+
+        // c0 c1 c2 c0' c1' c2' to c0 c0' c1 c1' c2 c2'
+        _p0 = _mm_unpacklo_epi8(_p0, _mm_setzero_si128());
+        _p1 = _mm_unpacklo_epi8(_p1, _mm_setzero_si128());
+        _p0 = _mm_unpacklo_epi16(_p0, _mm_srli_si128(_p0, 6));
+        _p1 = _mm_unpacklo_epi16(_p1, _mm_srli_si128(_p1, 6));
+
+        __m128i _r0 = _mm_srai_epi32(_mm_madd_epi16(_p0, _mm_set1_epi32(*(const int*)(ialpha + dx * 2))), 4);
+        __m128i _r1 = _mm_srai_epi32(_mm_madd_epi16(_p1, _mm_set1_epi32(*(const int*)(ialpha + dx * 2 + 2))), 4);
+
+        __m128i _r = _mm_packs_epi32(_r0, _r1);
+        _mm_storel_epi64((__m128i*)(rows + dx * 3), _r);
+        _mm_storel_epi64((__m128i*)(rows + dx * 3 + 3), _mm_unpackhi_epi64(_r, _r));
+    }
+
+    return dx;
+}
+
+// rows[dx * 4 + c] = (S[sx + c] * a0 + S[sx + 4 + c] * a1) >> 4
+static int resize_bilinear_hresize_c4_sse(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return resize_bilinear_hresize_c4_sse_avx2(S, rowsize, xofs, ialpha, rows, w);
+    }
+#endif
+
+    // the two taps of a c4 pixel are exactly 8 bytes
+    (void)rowsize;
+
+    int dx = 0;
+#if __AVX2__
+    for (; dx + 3 < w; dx += 4)
+    {
+        __m256i _p = _mm256_i32gather_epi64((const long long*)S, _mm_loadu_si128((const __m128i*)(xofs + dx)), 1);
+
+        // pixel 0 2 and pixel 1 3
+        __m256i _p02 = _mm256_unpacklo_epi8(_p, _mm256_setzero_si256());
+        __m256i _p13 = _mm256_unpackhi_epi8(_p, _mm256_setzero_si256());
+        _p02 = _mm256_unpacklo_epi16(_p02, _mm256_srli_si256(_p02, 8));
+        _p13 = _mm256_unpacklo_epi16(_p13, _mm256_srli_si256(_p13, 8));
+
+        __m256i _a = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(ialpha + dx * 2)));
+        __m256i _a02 = _mm256_permutevar8x32_epi32(_a, _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2));
+        __m256i _a13 = _mm256_permutevar8x32_epi32(_a, _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3));
+
+        __m256i _r02 = _mm256_srai_epi32(_mm256_madd_epi16(_p02, _a02), 4);
+        __m256i _r13 = _mm256_srai_epi32(_mm256_madd_epi16(_p13, _a13), 4);
+
+        _mm256_storeu_si256((__m256i*)(rows + dx * 4), _mm256_packs_epi32(_r02, _r13));
+    }
+#endif // __AVX2__
+    for (; dx + 1 < w; dx += 2)
+    {
+        __m128i _p0 = _mm_loadl_epi64((const __m128i*)(S + xofs[dx]));
+        __m128i _p1 = _mm_loadl_epi64((const __m128i*)(S + xofs[dx + 1]));
+
+        // c0 c1 c2 c3 c0' c1' c2' c3' to c0 c0' c1 c1' c2 c2' c3 c3'
+        _p0 = _mm_unpacklo_epi8(_p0, _mm_setzero_si128());
+        _p1 = _mm_unpacklo_epi8(_p1, _mm_setzero_si128());
+        _p0 = _mm_unpacklo_epi16(_p0, _mm_srli_si128(_p0, 8));
+        _p1 = _mm_unpacklo_epi16(_p1, _mm_srli_si128(_p1, 8));
+
+        __m128i _r0 = _mm_srai_epi32(_mm_madd_epi16(_p0, _mm_set1_epi32(*(const int*)(ialpha + dx * 2))), 4);
+        __m128i _r1 = _mm_srai_epi32(_mm_madd_epi16(_p1, _mm_set1_epi32(*(const int*)(ialpha + dx * 2 + 2))), 4);
+
+        _mm_storeu_si128((__m128i*)(rows + dx * 4), _mm_packs_epi32(_r0, _r1));
+    }
+
+    return dx;
+}
+
+// the wide part of vresize_two, the sse2 and scalar loops in vresize_two take the rest
+static int resize_bilinear_vresize_two_sse(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp0, unsigned char* Dp1, short b0, short b1, short b2, short b3)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return resize_bilinear_vresize_two_sse_avx2(rows0p, rows1p, wsize, Dp0, Dp1, b0, b1, b2, b3);
+    }
+#endif
+
+    int dx = 0;
+#if __AVX2__
+    __m256i _b0 = _mm256_set1_epi16(b0);
+    __m256i _b1 = _mm256_set1_epi16(b1);
+    __m256i _b2 = _mm256_set1_epi16(b2);
+    __m256i _b3 = _mm256_set1_epi16(b3);
+    __m256i _v2 = _mm256_set1_epi16(2);
+    for (; dx + 31 < wsize; dx += 32)
+    {
+        __m256i _r00 = _mm256_loadu_si256((const __m256i*)(rows0p + dx));
+        __m256i _r01 = _mm256_loadu_si256((const __m256i*)(rows0p + dx + 16));
+        __m256i _r10 = _mm256_loadu_si256((const __m256i*)(rows1p + dx));
+        __m256i _r11 = _mm256_loadu_si256((const __m256i*)(rows1p + dx + 16));
+        __m256i _acc00 = _mm256_add_epi16(_mm256_mulhi_epi16(_r00, _b0), _mm256_mulhi_epi16(_r10, _b1));
+        __m256i _acc01 = _mm256_add_epi16(_mm256_mulhi_epi16(_r01, _b0), _mm256_mulhi_epi16(_r11, _b1));
+        __m256i _acc10 = _mm256_add_epi16(_mm256_mulhi_epi16(_r00, _b2), _mm256_mulhi_epi16(_r10, _b3));
+        __m256i _acc11 = _mm256_add_epi16(_mm256_mulhi_epi16(_r01, _b2), _mm256_mulhi_epi16(_r11, _b3));
+        _acc00 = _mm256_srai_epi16(_mm256_add_epi16(_acc00, _v2), 2);
+        _acc01 = _mm256_srai_epi16(_mm256_add_epi16(_acc01, _v2), 2);
+        _acc10 = _mm256_srai_epi16(_mm256_add_epi16(_acc10, _v2), 2);
+        _acc11 = _mm256_srai_epi16(_mm256_add_epi16(_acc11, _v2), 2);
+        __m256i _Dp0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_acc00, _acc01), _MM_SHUFFLE(3, 1, 2, 0));
+        __m256i _Dp1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_acc10, _acc11), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)(Dp0 + dx), _Dp0);
+        _mm256_storeu_si256((__m256i*)(Dp1 + dx), _Dp1);
+    }
+#else
+    (void)rows0p;
+    (void)rows1p;
+    (void)wsize;
+    (void)Dp0;
+    (void)Dp1;
+    (void)b0;
+    (void)b1;
+    (void)b2;
+    (void)b3;
+#endif // __AVX2__
+
+    return dx;
+}
+
+// the wide part of vresize_one, the sse2 and scalar loops in vresize_one take the rest
+static int resize_bilinear_vresize_one_sse(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp, short b0, short b1)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return resize_bilinear_vresize_one_sse_avx2(rows0p, rows1p, wsize, Dp, b0, b1);
+    }
+#endif
+
+    int dx = 0;
+#if __AVX2__
+    __m256i _b0 = _mm256_set1_epi16(b0);
+    __m256i _b1 = _mm256_set1_epi16(b1);
+    __m256i _v2 = _mm256_set1_epi16(2);
+    for (; dx + 31 < wsize; dx += 32)
+    {
+        __m256i _r00 = _mm256_loadu_si256((const __m256i*)(rows0p + dx));
+        __m256i _r01 = _mm256_loadu_si256((const __m256i*)(rows0p + dx + 16));
+        __m256i _r10 = _mm256_loadu_si256((const __m256i*)(rows1p + dx));
+        __m256i _r11 = _mm256_loadu_si256((const __m256i*)(rows1p + dx + 16));
+        __m256i _acc0 = _mm256_add_epi16(_mm256_mulhi_epi16(_r00, _b0), _mm256_mulhi_epi16(_r10, _b1));
+        __m256i _acc1 = _mm256_add_epi16(_mm256_mulhi_epi16(_r01, _b0), _mm256_mulhi_epi16(_r11, _b1));
+        _acc0 = _mm256_srai_epi16(_mm256_add_epi16(_acc0, _v2), 2);
+        _acc1 = _mm256_srai_epi16(_mm256_add_epi16(_acc1, _v2), 2);
+        __m256i _Dp = _mm256_permute4x64_epi64(_mm256_packus_epi16(_acc0, _acc1), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i*)(Dp + dx), _Dp);
+    }
+#else
+    (void)rows0p;
+    (void)rows1p;
+    (void)wsize;
+    (void)Dp;
+    (void)b0;
+    (void)b1;
+#endif // __AVX2__
+
+    return dx;
+}
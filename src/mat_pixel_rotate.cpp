@@ -5,11 +5,16 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#include "cpu.h"
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL_ROTATE
+#if __SSE2__
+#include "mat_pixel_rotate_x86.h"
+#endif // __SSE2__
+
 // should be a kanna ascii art here in my local branch
 // but we shall ask the original art author for permission first ...
 // https://www.reddit.com/r/anime/comments/5uxjn4/i_recreated_the_kanna_ascii_art_from_kobayashisan/
@@ -5943,6 +5948,11 @@ void kanna_rotate_c1(const unsigned char* src, int srcw, int srch, int srcstride
     // assert srcw == w && srch == h for type 1234
     // assert srcw == h && srch == w for type 5678
 
+#if __SSE2__
+    if (kanna_rotate_sse(src, srcw, srch, srcstride, dst, w, h, stride, 1, type) == 0)
+        return;
+#endif // __SSE2__
+
     switch (type)
     {
     case 1:
@@ -5980,6 +5990,11 @@ void kanna_rotate_c2(const unsigned char* src, int srcw, int srch, int srcstride
     // assert srcw == w && srch == h for type 1234
     // assert srcw == h && srch == w for type 5678
 
+#if __SSE2__
+    if (kanna_rotate_sse(src, srcw, srch, srcstride, dst, w, h, stride, 2, type) == 0)
+        return;
+#endif // __SSE2__
+
     switch (type)
     {
     case 1:
@@ -6017,6 +6032,11 @@ void kanna_rotate_c3(const unsigned char* src, int srcw, int srch, int srcstride
     // assert srcw == w && srch == h for type 1234
     // assert srcw == h && srch == w for type 5678
 
+#if __SSE2__
+    if (kanna_rotate_sse(src, srcw, srch, srcstride, dst, w, h, stride, 3, type) == 0)
+        return;
+#endif // __SSE2__
+
     switch (type)
     {
     case 1:
@@ -6054,6 +6074,11 @@ void kanna_rotate_c4(const unsigned char* src, int srcw, int srch, int srcstride
     // assert srcw == w && srch == h for type 1234
     // assert srcw == h && srch == w for type 5678
 
+#if __SSE2__
+    if (kanna_rotate_sse(src, srcw, srch, srcstride, dst, w, h, stride, 4, type) == 0)
+        return;
+#endif // __SSE2__
+
     switch (type)
     {
     case 1:
@@ -0,0 +1,349 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// x86 kernels for kanna_rotate in mat_pixel_rotate.cpp
+// the flips move 16 bytes at a time and reverse the pixel order in register,
+// the transposes work on 8x8 tiles of 1, 2 and 3 byte pixels and 4x4 tiles of 4 byte pixels,
+// 3 byte pixels need ssse3 shuffles, without them and on the tile edges pixels are moved one at a time
+// large images are split into bands of source rows over threads
+
+#if __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+// reverse the order of the 1, 2 or 4 byte pixels in a register
+static inline __m128i kanna_rotate_reverse_sse(__m128i _p, int elemsize)
+{
+#if __SSSE3__
+    if (elemsize == 1)
+        return _mm_shuffle_epi8(_p, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+#endif
+
+    _p = _mm_shuffle_epi32(_p, _MM_SHUFFLE(0, 1, 2, 3));
+    if (elemsize == 4)
+        return _p;
+
+    _p = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_p, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    if (elemsize == 2)
+        return _p;
+
+    return _mm_or_si128(_mm_srli_epi16(_p, 8), _mm_slli_epi16(_p, 8));
+}
+
+// dp[w - 1 - x] = sp[x]
+static void kanna_rotate_flip_row_sse(const unsigned char* sp, unsigned char* dp, int w, int elemsize)
+{
+#if __SSSE3__
+    if (elemsize == 3)
+    {
+        // 5 pixels per register, src is walked backward so the junk 16th byte of every store
+        // lands on a dst pixel that is written afterwards
+        const __m128i _mask = _mm_setr_epi8(12, 13, 14, 9, 10, 11, 6, 7, 8, 3, 4, 5, 0, 1, 2, 15);
+
+        int x = w - 6;
+        for (; x >= 1; x -= 5)
+        {
+            __m128i _p = _mm_loadu_si128((const __m128i*)(sp + x * 3));
+            _mm_storeu_si128((__m128i*)(dp + (w - x - 5) * 3), _mm_shuffle_epi8(_p, _mask));
+        }
+
+        // the head pixels and the last pixel
+        for (int i = 0; i < x + 5; i++)
+        {
+            dp[(w - 1 - i) * 3] = sp[i * 3];
+            dp[(w - 1 - i) * 3 + 1] = sp[i * 3 + 1];
+            dp[(w - 1 - i) * 3 + 2] = sp[i * 3 + 2];
+        }
+        dp[0] = sp[(w - 1) * 3];
+        dp[1] = sp[(w - 1) * 3 + 1];
+        dp[2] = sp[(w - 1) * 3 + 2];
+        return;
+    }
+#endif // __SSSE3__
+
+    int x = 0;
+    if (elemsize != 3)
+    {
+        const int n = 16 / elemsize;
+        for (; x + n - 1 < w; x += n)
+        {
+            __m128i _p = _mm_loadu_si128((const __m128i*)(sp + x * elemsize));
+            _mm_storeu_si128((__m128i*)(dp + (w - x - n) * elemsize), kanna_rotate_reverse_sse(_p, elemsize));
+        }
+    }
+    for (; x < w; x++)
+    {
+        const unsigned char* s = sp + x * elemsize;
+        unsigned char* d = dp + (w - 1 - x) * elemsize;
+        for (int k = 0; k < elemsize; k++)
+        {
+            d[k] = s[k];
+        }
+    }
+}
+
+// 8x8 tile of 1 byte pixels, row i of the tile at s + i * sstep goes to column i of the dst rows d + k * dstep
+static void kanna_rotate_transpose_tile_c1_sse(const unsigned char* s, int sstep, unsigned char* d, int dstep)
+{
+    __m128i _r0 = _mm_loadl_epi64((const __m128i*)s);
+    __m128i _r1 = _mm_loadl_epi64((const __m128i*)(s + sstep));
+    __m128i _r2 = _mm_loadl_epi64((const __m128i*)(s + sstep * 2));
+    __m128i _r3 = _mm_loadl_epi64((const __m128i*)(s + sstep * 3));
+    __m128i _r4 = _mm_loadl_epi64((const __m128i*)(s + sstep * 4));
+    __m128i _r5 = _mm_loadl_epi64((const __m128i*)(s + sstep * 5));
+    __m128i _r6 = _mm_loadl_epi64((const __m128i*)(s + sstep * 6));
+    __m128i _r7 = _mm_loadl_epi64((const __m128i*)(s + sstep * 7));
+
+    __m128i _r01 = _mm_unpacklo_epi8(_r0, _r1);
+    __m128i _r23 = _mm_unpacklo_epi8(_r2, _r3);
+    __m128i _r45 = _mm_unpacklo_epi8(_r4, _r5);
+    __m128i _r67 = _mm_unpacklo_epi8(_r6, _r7);
+
+    __m128i _r0123l = _mm_unpacklo_epi16(_r01, _r23);
+    __m128i _r0123h = _mm_unpackhi_epi16(_r01, _r23);
+    __m128i _r4567l = _mm_unpacklo_epi16(_r45, _r67);
+    __m128i _r4567h = _mm_unpackhi_epi16(_r45, _r67);
+
+    __m128i _c01 = _mm_unpacklo_epi32(_r0123l, _r4567l);
+    __m128i _c23 = _mm_unpackhi_epi32(_r0123l, _r4567l);
+    __m128i _c45 = _mm_unpacklo_epi32(_r0123h, _r4567h);
+    __m128i _c67 = _mm_unpackhi_epi32(_r0123h, _r4567h);
+
+    _mm_storel_epi64((__m128i*)d, _c01);
+    _mm_storel_epi64((__m128i*)(d + dstep), _mm_srli_si128(_c01, 8));
+    _mm_storel_epi64((__m128i*)(d + dstep * 2), _c23);
+    _mm_storel_epi64((__m128i*)(d + dstep * 3), _mm_srli_si128(_c23, 8));
+    _mm_storel_epi64((__m128i*)(d + dstep * 4), _c45);
+    _mm_storel_epi64((__m128i*)(d + dstep * 5), _mm_srli_si128(_c45, 8));
+    _mm_storel_epi64((__m128i*)(d + dstep * 6), _c67);
+    _mm_storel_epi64((__m128i*)(d + dstep * 7), _mm_srli_si128(_c67, 8));
+}
+
+// 8x8 tile of 2 byte pixels
+static void kanna_rotate_transpose_tile_c2_sse(const unsigned char* s, int sstep, unsigned char* d, int dstep)
+{
+    __m128i _r0 = _mm_loadu_si128((const __m128i*)s);
+    __m128i _r1 = _mm_loadu_si128((const __m128i*)(s + sstep));
+    __m128i _r2 = _mm_loadu_si128((const __m128i*)(s + sstep * 2));
+    __m128i _r3 = _mm_loadu_si128((const __m128i*)(s + sstep * 3));
+    __m128i _r4 = _mm_loadu_si128((const __m128i*)(s + sstep * 4));
+    __m128i _r5 = _mm_loadu_si128((const __m128i*)(s + sstep * 5));
+    __m128i _r6 = _mm_loadu_si128((const __m128i*)(s + sstep * 6));
+    __m128i _r7 = _mm_loadu_si128((const __m128i*)(s + sstep * 7));
+
+    __m128i _r01l = _mm_unpacklo_epi16(_r0, _r1);
+    __m128i _r01h = _mm_unpackhi_epi16(_r0, _r1);
+    __m128i _r23l = _mm_unpacklo_epi16(_r2, _r3);
+    __m128i _r23h = _mm_unpackhi_epi16(_r2, _r3);
+    __m128i _r45l = _mm_unpacklo_epi16(_r4, _r5);
+    __m128i _r45h = _mm_unpackhi_epi16(_r4, _r5);
+    __m128i _r67l = _mm_unpacklo_epi16(_r6, _r7);
+    __m128i _r67h = _mm_unpackhi_epi16(_r6, _r7);
+
+    __m128i _r0123_01 = _mm_unpacklo_epi32(_r01l, _r23l);
+    __m128i _r0123_23 = _mm_unpackhi_epi32(_r01l, _r23l);
+    __m128i _r0123_45 = _mm_unpacklo_epi32(_r01h, _r23h);
+    __m128i _r0123_67 = _mm_unpackhi_epi32(_r01h, _r23h);
+    __m128i _r4567_01 = _mm_unpacklo_epi32(_r45l, _r67l);
+    __m128i _r4567_23 = _mm_unpackhi_epi32(_r45l, _r67l);
+    __m128i _r4567_45 = _mm_unpacklo_epi32(_r45h, _r67h);
+    __m128i _r4567_67 = _mm_unpackhi_epi32(_r45h, _r67h);
+
+    _mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi64(_r0123_01, _r4567_01));
+    _mm_storeu_si128((__m128i*)(d + dstep), _mm_unpackhi_epi64(_r0123_01, _r4567_01));
+    _mm_storeu_si128((__m128i*)(d + dstep * 2), _mm_unpacklo_epi64(_r0123_23, _r4567_23));
+    _mm_storeu_si128((__m128i*)(d + dstep * 3), _mm_unpackhi_epi64(_r0123_23, _r4567_23));
+    _mm_storeu_si128((__m128i*)(d + dstep * 4), _mm_unpacklo_epi64(_r0123_45, _r4567_45));
+    _mm_storeu_si128((__m128i*)(d + dstep * 5), _mm_unpackhi_epi64(_r0123_45, _r4567_45));
+    _mm_storeu_si128((__m128i*)(d + dstep * 6), _mm_unpacklo_epi64(_r0123_67, _r4567_67));
+    _mm_storeu_si128((__m128i*)(d + dstep * 7), _mm_unpackhi_epi64(_r0123_67, _r4567_67));
+}
+
+// 8x8 tile of 3 byte pixels
+static void kanna_rotate_transpose_tile_c3_sse(const unsigned char* s, int sstep, unsigned char* d, int dstep)
+{
+#if __SSSE3__
+    // widen every pixel to 4 bytes, transpose as four 4x4 tiles and narrow back
+    const __m128i _widen = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i _narrow = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    __m128i _l[8];
+    __m128i _h[8];
+    for (int i = 0; i < 8; i++)
+    {
+        __m128i _p0 = _mm_loadu_si128((const __m128i*)(s + sstep * i));
+        __m128i _p1 = _mm_loadl_epi64((const __m128i*)(s + sstep * i + 16));
+        _l[i] = _mm_shuffle_epi8(_p0, _widen);
+        _h[i] = _mm_shuffle_epi8(_mm_alignr_epi8(_p1, _p0, 12), _widen);
+    }
+
+    // column k of the rows 0-3 and 4-7
+    __m128i _c0123[8];
+    __m128i _c4567[8];
+    for (int i = 0; i < 8; i += 4)
+    {
+        __m128i* _c = i == 0 ? _c0123 : _c4567;
+
+        __m128i _r01l = _mm_unpacklo_epi32(_l[i], _l[i + 1]);
+        __m128i _r01h = _mm_unpackhi_epi32(_l[i], _l[i + 1]);
+        __m128i _r23l = _mm_unpacklo_epi32(_l[i + 2], _l[i + 3]);
+        __m128i _r23h = _mm_unpackhi_epi32(_l[i + 2], _l[i + 3]);
+        _c[0] = _mm_unpacklo_epi64(_r01l, _r23l);
+        _c[1] = _mm_unpackhi_epi64(_r01l, _r23l);
+        _c[2] = _mm_unpacklo_epi64(_r01h, _r23h);
+        _c[3] = _mm_unpackhi_epi64(_r01h, _r23h);
+
+        _r01l = _mm_unpacklo_epi32(_h[i], _h[i + 1]);
+        _r01h = _mm_unpackhi_epi32(_h[i], _h[i + 1]);
+        _r23l = _mm_unpacklo_epi32(_h[i + 2], _h[i + 3]);
+        _r23h = _mm_unpackhi_epi32(_h[i + 2], _h[i + 3]);
+        _c[4] = _mm_unpacklo_epi64(_r01l, _r23l);
+        _c[5] = _mm_unpackhi_epi64(_r01l, _r23l);
+        _c[6] = _mm_unpacklo_epi64(_r01h, _r23h);
+        _c[7] = _mm_unpackhi_epi64(_r01h, _r23h);
+    }
+
+    for (int k = 0; k < 8; k++)
+    {
+        __m128i _a = _mm_shuffle_epi8(_c0123[k], _narrow);
+        __m128i _b = _mm_shuffle_epi8(_c4567[k], _narrow);
+        _mm_storeu_si128((__m128i*)(d + dstep * k), _mm_or_si128(_a, _mm_slli_si128(_b, 12)));
+        _mm_storel_epi64((__m128i*)(d + dstep * k + 16), _mm_srli_si128(_b, 4));
+    }
+#else
+    for (int k = 0; k < 8; k++)
+    {
+        unsigned char* dp = d + dstep * k;
+        for (int i = 0; i < 8; i++)
+        {
+            const unsigned char* sp = s + sstep * i + k * 3;
+            dp[i * 3] = sp[0];
+            dp[i * 3 + 1] = sp[1];
+            dp[i * 3 + 2] = sp[2];
+        }
+    }
+#endif // __SSSE3__
+}
+
+// 4x4 tile of 4 byte pixels
+static void kanna_rotate_transpose_tile_c4_sse(const unsigned char* s, int sstep, unsigned char* d, int dstep)
+{
+    __m128i _r0 = _mm_loadu_si128((const __m128i*)s);
+    __m128i _r1 = _mm_loadu_si128((const __m128i*)(s + sstep));
+    __m128i _r2 = _mm_loadu_si128((const __m128i*)(s + sstep * 2));
+    __m128i _r3 = _mm_loadu_si128((const __m128i*)(s + sstep * 3));
+
+    __m128i _r01l = _mm_unpacklo_epi32(_r0, _r1);
+    __m128i _r01h = _mm_unpackhi_epi32(_r0, _r1);
+    __m128i _r23l = _mm_unpacklo_epi32(_r2, _r3);
+    __m128i _r23h = _mm_unpackhi_epi32(_r2, _r3);
+
+    _mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi64(_r01l, _r23l));
+    _mm_storeu_si128((__m128i*)(d + dstep), _mm_unpackhi_epi64(_r01l, _r23l));
+    _mm_storeu_si128((__m128i*)(d + dstep * 2), _mm_unpacklo_epi64(_r01h, _r23h));
+    _mm_storeu_si128((__m128i*)(d + dstep * 3), _mm_unpackhi_epi64(_r01h, _r23h));
+}
+
+// the dst pixel of src pixel (x, y) is at row (revrow ? srcw - 1 - x : x) and column (revcol ? srch - 1 - y : y)
+// handles the src rows [y_begin, y_end)
+static void kanna_rotate_transpose_sse(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int stride, int elemsize, int revrow, int revcol, int y_begin, int y_end)
+{
+    const int tile = elemsize == 4 ? 4 : 8;
+
+    int y = y_begin;
+    for (; y + tile - 1 < y_end; y += tile)
+    {
+        // the tile rows are read bottom up when columns are reversed, so the dst bytes stay in order
+        const unsigned char* s0 = revcol ? src + (y + tile - 1) * srcstride : src + y * srcstride;
+        const int sstep = revcol ? -srcstride : srcstride;
+        const int dcol = revcol ? srch - tile - y : y;
+        const int dstep = revrow ? -stride : stride;
+
+        int x = 0;
+        for (; x + tile - 1 < srcw; x += tile)
+        {
+            const unsigned char* s = s0 + x * elemsize;
+            unsigned char* d = dst + (revrow ? srcw - 1 - x : x) * stride + dcol * elemsize;
+
+            if (elemsize == 1)
+                kanna_rotate_transpose_tile_c1_sse(s, sstep, d, dstep);
+            if (elemsize == 2)
+                kanna_rotate_transpose_tile_c2_sse(s, sstep, d, dstep);
+            if (elemsize == 3)
+                kanna_rotate_transpose_tile_c3_sse(s, sstep, d, dstep);
+            if (elemsize == 4)
+                kanna_rotate_transpose_tile_c4_sse(s, sstep, d, dstep);
+        }
+        for (; x < srcw; x++)
+        {
+            unsigned char* dp = dst + (revrow ? srcw - 1 - x : x) * stride + dcol * elemsize;
+            for (int i = 0; i < tile; i++)
+            {
+                const unsigned char* sp = s0 + sstep * i + x * elemsize;
+                for (int k = 0; k < elemsize; k++)
+                {
+                    dp[i * elemsize + k] = sp[k];
+                }
+            }
+        }
+    }
+    for (; y < y_end; y++)
+    {
+        const unsigned char* sp = src + y * srcstride;
+        unsigned char* dp = dst + (revcol ? srch - 1 - y : y) * elemsize;
+        for (int x = 0; x < srcw; x++)
+        {
+            unsigned char* d = dp + (revrow ? srcw - 1 - x : x) * stride;
+            for (int k = 0; k < elemsize; k++)
+            {
+                d[k] = sp[x * elemsize + k];
+            }
+        }
+    }
+}
+
+// returns 0 when the rotate type is handled
+static int kanna_rotate_sse(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int w, int h, int stride, int elemsize, int type)
+{
+    if (type < 1 || type > 8)
+        return -1;
+
+    // bands of 8 src rows keep the transpose tiles whole
+    const int nT = srcw * srch >= 256 * 256 ? std::max(std::min(ncnn::get_physical_big_cpu_count(), srch / 16), 1) : 1;
+    const int band = ((srch + nT - 1) / nT + 7) / 8 * 8;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
+    {
+        const int y_begin = std::min(t * band, srch);
+        const int y_end = std::min(y_begin + band, srch);
+
+        if (type == 1 || type == 4)
+        {
+            // copy or vertical flip
+            for (int y = y_begin; y < y_end; y++)
+            {
+                unsigned char* dp = dst + (type == 1 ? y : h - 1 - y) * stride;
+                memcpy(dp, src + y * srcstride, w * elemsize);
+            }
+        }
+        else if (type == 2 || type == 3)
+        {
+            // horizontal flip or rotate 180
+            for (int y = y_begin; y < y_end; y++)
+            {
+                unsigned char* dp = dst + (type == 2 ? y : h - 1 - y) * stride;
+                kanna_rotate_flip_row_sse(src + y * srcstride, dp, w, elemsize);
+            }
+        }
+        else
+        {
+            // transpose, rotate 90 cw, transverse or rotate 90 ccw
+            const int revrow = type == 7 || type == 8;
+            const int revcol = type == 6 || type == 7;
+            kanna_rotate_transpose_sse(src, srcw, srch, srcstride, dst, stride, elemsize, revrow, revcol, y_begin, y_end);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,688 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// x86 row kernels for the u8 pixel <-> fp32 planar conversions in mat_pixel.cpp
+// every kernel converts the leading pixels of a row and returns how many it has done,
+// the caller finishes the remaining pixels with the scalar loop
+// the rounding matches the scalar code bit-exact, u8 to float is exact
+// and float to u8 truncates toward zero then saturates like SATURATE_CAST_UCHAR
+
+#if __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+int from_c1_sse_avx512(const unsigned char* src, float* ptr, int size);
+int from_c1_to_c3_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size);
+int from_c3_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size);
+int from_c3_to_gray_sse_avx512(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2);
+int from_c4_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, float* ptr3, int size);
+int from_c4_to_c3_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size);
+int from_c4_to_gray_sse_avx512(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2);
+int to_c1_sse_avx512(const float* ptr, unsigned char* dst, int size);
+int to_c1_to_c4_sse_avx512(const float* ptr, unsigned char* dst, int size);
+int to_c3_sse_avx512(const float* ptr0, const float* ptr1, const float* ptr2, unsigned char* dst, int size);
+int to_c4_sse_avx512(const float* ptr0, const float* ptr1, const float* ptr2, const float* ptr3, unsigned char* dst, int size);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+int from_c1_sse_avx2(const unsigned char* src, float* ptr, int size);
+int from_c1_to_c3_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size);
+int from_c3_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size);
+int from_c3_to_gray_sse_avx2(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2);
+int from_c4_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, float* ptr3, int size);
+int from_c4_to_c3_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size);
+int from_c4_to_gray_sse_avx2(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2);
+int to_c1_sse_avx2(const float* ptr, unsigned char* dst, int size);
+int to_c1_to_c4_sse_avx2(const float* ptr, unsigned char* dst, int size);
+int to_c3_sse_avx2(const float* ptr0, const float* ptr1, const float* ptr2, unsigned char* dst, int size);
+int to_c4_sse_avx2(const float* ptr0, const float* ptr1, const float* ptr2, const float* ptr3, unsigned char* dst, int size);
+#endif
+
+// 4 rgb pixels to one pixel per 32bit lane, the highest byte of each lane is zero
+static inline __m128i load_c3_epi32_sse2(const unsigned char* p)
+{
+    __m128i _p = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)p), _mm_cvtsi32_si128(*(const int*)(p + 8)));
+#if __SSSE3__
+    return _mm_shuffle_epi8(_p, _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+#else
+    __m128i _t0 = _mm_unpacklo_epi32(_p, _mm_srli_si128(_p, 3));
+    __m128i _t1 = _mm_unpacklo_epi32(_mm_srli_si128(_p, 6), _mm_srli_si128(_p, 9));
+    return _mm_and_si128(_mm_unpacklo_epi64(_t0, _t1), _mm_set1_epi32(0x00ffffff));
+#endif
+}
+
+// 4 pixels with zero highest byte to 12 bytes rgb
+static inline void store_c3_epi32_sse2(unsigned char* p, __m128i _px)
+{
+#if __SSSE3__
+    __m128i _p = _mm_shuffle_epi8(_px, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+#else
+    __m128i _q = _mm_or_si128(_mm_and_si128(_px, _mm_setr_epi32(-1, 0, -1, 0)), _mm_srli_epi64(_mm_and_si128(_px, _mm_setr_epi32(0, -1, 0, -1)), 8));
+    __m128i _p = _mm_or_si128(_mm_move_epi64(_q), _mm_slli_si128(_mm_unpackhi_epi64(_q, _q), 6));
+#endif
+    _mm_storel_epi64((__m128i*)p, _p);
+    *(int*)(p + 8) = _mm_cvtsi128_si32(_mm_unpackhi_epi64(_p, _p));
+}
+
+static inline __m128 channel_ps_sse2(__m128i _px, int shift)
+{
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(_px, shift), _mm_set1_epi32(255)));
+}
+
+// (c0 * w0 + c1 * w1 + c2 * w2) >> 8 with _w02 = w0 | w2 << 16
+static inline __m128 gray_ps_sse2(__m128i _px, __m128i _w02, __m128i _w1)
+{
+    __m128i _c02 = _mm_and_si128(_px, _mm_set1_epi32(0x00ff00ff));
+    __m128i _c1 = _mm_and_si128(_mm_srli_epi32(_px, 8), _mm_set1_epi32(255));
+    __m128i _y = _mm_add_epi32(_mm_madd_epi16(_c02, _w02), _mm_madd_epi16(_c1, _w1));
+    return _mm_cvtepi32_ps(_mm_srli_epi32(_y, 8));
+}
+
+// saturate 4 pixels of c0 c1 c2 c3 and interleave them into one pixel per 32bit lane
+static inline __m128i pack_c4_epi32_sse2(__m128i _c0, __m128i _c1, __m128i _c2, __m128i _c3)
+{
+    __m128i _p = _mm_packus_epi16(_mm_packs_epi32(_c0, _c1), _mm_packs_epi32(_c2, _c3));
+    _p = _mm_unpacklo_epi8(_p, _mm_srli_si128(_p, 8));
+    return _mm_unpacklo_epi8(_p, _mm_srli_si128(_p, 8));
+}
+
+#if __AVX2__
+static inline __m256i load_c3_epi32_avx2(const unsigned char* p)
+{
+    __m256i _p = _mm256_maskload_epi32((const int*)p, _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0));
+    _p = _mm256_permutevar8x32_epi32(_p, _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0));
+    return _mm256_shuffle_epi8(_p, _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+}
+
+static inline void store_c3_epi32_avx2(unsigned char* p, __m256i _px)
+{
+    __m256i _p = _mm256_shuffle_epi8(_px, _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+    _p = _mm256_permutevar8x32_epi32(_p, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_maskstore_epi32((int*)p, _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0), _p);
+}
+
+static inline __m256 channel_ps_avx2(__m256i _px, int shift)
+{
+    return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(_px, shift), _mm256_set1_epi32(255)));
+}
+
+static inline __m256 gray_ps_avx2(__m256i _px, __m256i _w02, __m256i _w1)
+{
+    __m256i _c02 = _mm256_and_si256(_px, _mm256_set1_epi32(0x00ff00ff));
+    __m256i _c1 = _mm256_and_si256(_mm256_srli_epi32(_px, 8), _mm256_set1_epi32(255));
+    __m256i _y = _mm256_add_epi32(_mm256_madd_epi16(_c02, _w02), _mm256_madd_epi16(_c1, _w1));
+    return _mm256_cvtepi32_ps(_mm256_srli_epi32(_y, 8));
+}
+
+static inline __m256i saturate_epu8_epi32_avx2(__m256 _v)
+{
+    return _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(_v), _mm256_setzero_si256()), _mm256_set1_epi32(255));
+}
+
+static inline __m256i pack_c4_epi32_avx2(__m256i _c0, __m256i _c1, __m256i _c2, __m256i _c3)
+{
+    __m256i _c01 = _mm256_or_si256(_c0, _mm256_slli_epi32(_c1, 8));
+    __m256i _c23 = _mm256_or_si256(_mm256_slli_epi32(_c2, 16), _mm256_slli_epi32(_c3, 24));
+    return _mm256_or_si256(_c01, _c23);
+}
+#endif // __AVX2__
+
+#if __AVX512F__
+static inline __m512i load_c3_epi32_avx512(const unsigned char* p)
+{
+    __m512i _p = _mm512_maskz_loadu_epi32(0x0fff, p);
+    _p = _mm512_permutexvar_epi32(_mm512_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0, 6, 7, 8, 0, 9, 10, 11, 0), _p);
+    return _mm512_shuffle_epi8(_p, _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1)));
+}
+
+static inline void store_c3_epi32_avx512(unsigned char* p, __m512i _px)
+{
+    __m512i _p = _mm512_shuffle_epi8(_px, _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1)));
+    _p = _mm512_permutexvar_epi32(_mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15), _p);
+    _mm512_mask_storeu_epi32(p, 0x0fff, _p);
+}
+
+static inline __m512 channel_ps_avx512(__m512i _px, int shift)
+{
+    return _mm512_cvtepi32_ps(_mm512_and_si512(_mm512_srli_epi32(_px, shift), _mm512_set1_epi32(255)));
+}
+
+static inline __m512 gray_ps_avx512(__m512i _px, __m512i _w02, __m512i _w1)
+{
+    __m512i _c02 = _mm512_and_si512(_px, _mm512_set1_epi32(0x00ff00ff));
+    __m512i _c1 = _mm512_and_si512(_mm512_srli_epi32(_px, 8), _mm512_set1_epi32(255));
+    __m512i _y = _mm512_add_epi32(_mm512_madd_epi16(_c02, _w02), _mm512_madd_epi16(_c1, _w1));
+    return _mm512_cvtepi32_ps(_mm512_srli_epi32(_y, 8));
+}
+
+static inline __m512i saturate_epu8_epi32_avx512(__m512 _v)
+{
+    return _mm512_min_epi32(_mm512_max_epi32(_mm512_cvttps_epi32(_v), _mm512_setzero_si512()), _mm512_set1_epi32(255));
+}
+
+static inline __m512i pack_c4_epi32_avx512(__m512i _c0, __m512i _c1, __m512i _c2, __m512i _c3)
+{
+    __m512i _c01 = _mm512_or_si512(_c0, _mm512_slli_epi32(_c1, 8));
+    __m512i _c23 = _mm512_or_si512(_mm512_slli_epi32(_c2, 16), _mm512_slli_epi32(_c3, 24));
+    return _mm512_or_si512(_c01, _c23);
+}
+#endif // __AVX512F__
+
+static int from_c1_sse(const unsigned char* src, float* ptr, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c1_sse_avx512(src, ptr, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c1_sse_avx2(src, ptr, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _p = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        _mm512_storeu_ps(ptr + i, _mm512_cvtepi32_ps(_p));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _p = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+        _mm256_storeu_ps(ptr + i, _mm256_cvtepi32_ps(_p));
+    }
+#endif // __AVX2__
+    for (; i + 15 < size; i += 16)
+    {
+        __m128i _p = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i _p01 = _mm_unpacklo_epi8(_p, _mm_setzero_si128());
+        __m128i _p23 = _mm_unpackhi_epi8(_p, _mm_setzero_si128());
+        _mm_storeu_ps(ptr + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(_p01, _mm_setzero_si128())));
+        _mm_storeu_ps(ptr + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(_p01, _mm_setzero_si128())));
+        _mm_storeu_ps(ptr + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(_p23, _mm_setzero_si128())));
+        _mm_storeu_ps(ptr + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(_p23, _mm_setzero_si128())));
+    }
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _p = _mm_cvtsi32_si128(*(const int*)(src + i));
+        _p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_p, _mm_setzero_si128()), _mm_setzero_si128());
+        _mm_storeu_ps(ptr + i, _mm_cvtepi32_ps(_p));
+    }
+
+    return i;
+}
+
+static int from_c1_to_c3_sse(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c1_to_c3_sse_avx512(src, ptr0, ptr1, ptr2, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c1_to_c3_sse_avx2(src, ptr0, ptr1, ptr2, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(src + i))));
+        _mm512_storeu_ps(ptr0 + i, _p);
+        _mm512_storeu_ps(ptr1 + i, _p);
+        _mm512_storeu_ps(ptr2 + i, _p);
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i))));
+        _mm256_storeu_ps(ptr0 + i, _p);
+        _mm256_storeu_ps(ptr1 + i, _p);
+        _mm256_storeu_ps(ptr2 + i, _p);
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _p = _mm_cvtsi32_si128(*(const int*)(src + i));
+        __m128 _v = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_p, _mm_setzero_si128()), _mm_setzero_si128()));
+        _mm_storeu_ps(ptr0 + i, _v);
+        _mm_storeu_ps(ptr1 + i, _v);
+        _mm_storeu_ps(ptr2 + i, _v);
+    }
+
+    return i;
+}
+
+static int from_c3_sse(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c3_sse_avx512(src, ptr0, ptr1, ptr2, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c3_sse_avx2(src, ptr0, ptr1, ptr2, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _px = load_c3_epi32_avx512(src + i * 3);
+        _mm512_storeu_ps(ptr0 + i, channel_ps_avx512(_px, 0));
+        _mm512_storeu_ps(ptr1 + i, channel_ps_avx512(_px, 8));
+        _mm512_storeu_ps(ptr2 + i, channel_ps_avx512(_px, 16));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _px = load_c3_epi32_avx2(src + i * 3);
+        _mm256_storeu_ps(ptr0 + i, channel_ps_avx2(_px, 0));
+        _mm256_storeu_ps(ptr1 + i, channel_ps_avx2(_px, 8));
+        _mm256_storeu_ps(ptr2 + i, channel_ps_avx2(_px, 16));
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _px = load_c3_epi32_sse2(src + i * 3);
+        _mm_storeu_ps(ptr0 + i, channel_ps_sse2(_px, 0));
+        _mm_storeu_ps(ptr1 + i, channel_ps_sse2(_px, 8));
+        _mm_storeu_ps(ptr2 + i, channel_ps_sse2(_px, 16));
+    }
+
+    return i;
+}
+
+static int from_c3_to_gray_sse(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c3_to_gray_sse_avx512(src, ptr, size, w0, w1, w2);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c3_to_gray_sse_avx2(src, ptr, size, w0, w1, w2);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    {
+        __m512i _w02 = _mm512_set1_epi32(w0 | (w2 << 16));
+        __m512i _w1 = _mm512_set1_epi32(w1);
+        for (; i + 15 < size; i += 16)
+        {
+            __m512i _px = load_c3_epi32_avx512(src + i * 3);
+            _mm512_storeu_ps(ptr + i, gray_ps_avx512(_px, _w02, _w1));
+        }
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    {
+        __m256i _w02 = _mm256_set1_epi32(w0 | (w2 << 16));
+        __m256i _w1 = _mm256_set1_epi32(w1);
+        for (; i + 7 < size; i += 8)
+        {
+            __m256i _px = load_c3_epi32_avx2(src + i * 3);
+            _mm256_storeu_ps(ptr + i, gray_ps_avx2(_px, _w02, _w1));
+        }
+    }
+#endif // __AVX2__
+    __m128i _w02 = _mm_set1_epi32(w0 | (w2 << 16));
+    __m128i _w1 = _mm_set1_epi32(w1);
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _px = load_c3_epi32_sse2(src + i * 3);
+        _mm_storeu_ps(ptr + i, gray_ps_sse2(_px, _w02, _w1));
+    }
+
+    return i;
+}
+
+static int from_c4_sse(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, float* ptr3, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c4_sse_avx512(src, ptr0, ptr1, ptr2, ptr3, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c4_sse_avx2(src, ptr0, ptr1, ptr2, ptr3, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _px = _mm512_loadu_si512((const __m512i*)(src + i * 4));
+        _mm512_storeu_ps(ptr0 + i, channel_ps_avx512(_px, 0));
+        _mm512_storeu_ps(ptr1 + i, channel_ps_avx512(_px, 8));
+        _mm512_storeu_ps(ptr2 + i, channel_ps_avx512(_px, 16));
+        _mm512_storeu_ps(ptr3 + i, _mm512_cvtepi32_ps(_mm512_srli_epi32(_px, 24)));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _px = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+        _mm256_storeu_ps(ptr0 + i, channel_ps_avx2(_px, 0));
+        _mm256_storeu_ps(ptr1 + i, channel_ps_avx2(_px, 8));
+        _mm256_storeu_ps(ptr2 + i, channel_ps_avx2(_px, 16));
+        _mm256_storeu_ps(ptr3 + i, _mm256_cvtepi32_ps(_mm256_srli_epi32(_px, 24)));
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _px = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        _mm_storeu_ps(ptr0 + i, channel_ps_sse2(_px, 0));
+        _mm_storeu_ps(ptr1 + i, channel_ps_sse2(_px, 8));
+        _mm_storeu_ps(ptr2 + i, channel_ps_sse2(_px, 16));
+        _mm_storeu_ps(ptr3 + i, _mm_cvtepi32_ps(_mm_srli_epi32(_px, 24)));
+    }
+
+    return i;
+}
+
+static int from_c4_to_c3_sse(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c4_to_c3_sse_avx512(src, ptr0, ptr1, ptr2, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c4_to_c3_sse_avx2(src, ptr0, ptr1, ptr2, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _px = _mm512_loadu_si512((const __m512i*)(src + i * 4));
+        _mm512_storeu_ps(ptr0 + i, channel_ps_avx512(_px, 0));
+        _mm512_storeu_ps(ptr1 + i, channel_ps_avx512(_px, 8));
+        _mm512_storeu_ps(ptr2 + i, channel_ps_avx512(_px, 16));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _px = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+        _mm256_storeu_ps(ptr0 + i, channel_ps_avx2(_px, 0));
+        _mm256_storeu_ps(ptr1 + i, channel_ps_avx2(_px, 8));
+        _mm256_storeu_ps(ptr2 + i, channel_ps_avx2(_px, 16));
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _px = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        _mm_storeu_ps(ptr0 + i, channel_ps_sse2(_px, 0));
+        _mm_storeu_ps(ptr1 + i, channel_ps_sse2(_px, 8));
+        _mm_storeu_ps(ptr2 + i, channel_ps_sse2(_px, 16));
+    }
+
+    return i;
+}
+
+static int from_c4_to_gray_sse(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return from_c4_to_gray_sse_avx512(src, ptr, size, w0, w1, w2);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return from_c4_to_gray_sse_avx2(src, ptr, size, w0, w1, w2);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    {
+        __m512i _w02 = _mm512_set1_epi32(w0 | (w2 << 16));
+        __m512i _w1 = _mm512_set1_epi32(w1);
+        for (; i + 15 < size; i += 16)
+        {
+            __m512i _px = _mm512_loadu_si512((const __m512i*)(src + i * 4));
+            _mm512_storeu_ps(ptr + i, gray_ps_avx512(_px, _w02, _w1));
+        }
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    {
+        __m256i _w02 = _mm256_set1_epi32(w0 | (w2 << 16));
+        __m256i _w1 = _mm256_set1_epi32(w1);
+        for (; i + 7 < size; i += 8)
+        {
+            __m256i _px = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            _mm256_storeu_ps(ptr + i, gray_ps_avx2(_px, _w02, _w1));
+        }
+    }
+#endif // __AVX2__
+    __m128i _w02 = _mm_set1_epi32(w0 | (w2 << 16));
+    __m128i _w1 = _mm_set1_epi32(w1);
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _px = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        _mm_storeu_ps(ptr + i, gray_ps_sse2(_px, _w02, _w1));
+    }
+
+    return i;
+}
+
+static int to_c1_sse(const float* ptr, unsigned char* dst, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return to_c1_sse_avx512(ptr, dst, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return to_c1_sse_avx2(ptr, dst, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _p = _mm512_max_epi32(_mm512_cvttps_epi32(_mm512_loadu_ps(ptr + i)), _mm512_setzero_si512());
+        _mm_storeu_si128((__m128i*)(dst + i), _mm512_cvtusepi32_epi8(_p));
+    }
+#endif // __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m128i _p0 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + i));
+        __m128i _p1 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + i + 4));
+        __m128i _p2 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + i + 8));
+        __m128i _p3 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + i + 12));
+        __m128i _p = _mm_packus_epi16(_mm_packs_epi32(_p0, _p1), _mm_packs_epi32(_p2, _p3));
+        _mm_storeu_si128((__m128i*)(dst + i), _p);
+    }
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _p = _mm_cvttps_epi32(_mm_loadu_ps(ptr + i));
+        _p = _mm_packus_epi16(_mm_packs_epi32(_p, _p), _mm_setzero_si128());
+        *(int*)(dst + i) = _mm_cvtsi128_si32(_p);
+    }
+
+    return i;
+}
+
+static int to_c1_to_c4_sse(const float* ptr, unsigned char* dst, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return to_c1_to_c4_sse_avx512(ptr, dst, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return to_c1_to_c4_sse_avx2(ptr, dst, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _g = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr + i));
+        _mm512_storeu_si512((__m512i*)(dst + i * 4), pack_c4_epi32_avx512(_g, _g, _g, _mm512_set1_epi32(255)));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _g = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr + i));
+        _mm256_storeu_si256((__m256i*)(dst + i * 4), pack_c4_epi32_avx2(_g, _g, _g, _mm256_set1_epi32(255)));
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _g = _mm_cvttps_epi32(_mm_loadu_ps(ptr + i));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), pack_c4_epi32_sse2(_g, _g, _g, _mm_set1_epi32(255)));
+    }
+
+    return i;
+}
+
+static int to_c3_sse(const float* ptr0, const float* ptr1, const float* ptr2, unsigned char* dst, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return to_c3_sse_avx512(ptr0, ptr1, ptr2, dst, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return to_c3_sse_avx2(ptr0, ptr1, ptr2, dst, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _c0 = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr0 + i));
+        __m512i _c1 = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr1 + i));
+        __m512i _c2 = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr2 + i));
+        store_c3_epi32_avx512(dst + i * 3, pack_c4_epi32_avx512(_c0, _c1, _c2, _mm512_setzero_si512()));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _c0 = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr0 + i));
+        __m256i _c1 = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr1 + i));
+        __m256i _c2 = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr2 + i));
+        store_c3_epi32_avx2(dst + i * 3, pack_c4_epi32_avx2(_c0, _c1, _c2, _mm256_setzero_si256()));
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _c0 = _mm_cvttps_epi32(_mm_loadu_ps(ptr0 + i));
+        __m128i _c1 = _mm_cvttps_epi32(_mm_loadu_ps(ptr1 + i));
+        __m128i _c2 = _mm_cvttps_epi32(_mm_loadu_ps(ptr2 + i));
+        store_c3_epi32_sse2(dst + i * 3, pack_c4_epi32_sse2(_c0, _c1, _c2, _mm_setzero_si128()));
+    }
+
+    return i;
+}
+
+// ptr3 may be null for opaque alpha
+static int to_c4_sse(const float* ptr0, const float* ptr1, const float* ptr2, const float* ptr3, unsigned char* dst, int size)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx512())
+    {
+        return to_c4_sse_avx512(ptr0, ptr1, ptr2, ptr3, dst, size);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __SSE2__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return to_c4_sse_avx2(ptr0, ptr1, ptr2, ptr3, dst, size);
+    }
+#endif
+
+    int i = 0;
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        __m512i _c0 = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr0 + i));
+        __m512i _c1 = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr1 + i));
+        __m512i _c2 = saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr2 + i));
+        __m512i _c3 = ptr3 ? saturate_epu8_epi32_avx512(_mm512_loadu_ps(ptr3 + i)) : _mm512_set1_epi32(255);
+        _mm512_storeu_si512((__m512i*)(dst + i * 4), pack_c4_epi32_avx512(_c0, _c1, _c2, _c3));
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    for (; i + 7 < size; i += 8)
+    {
+        __m256i _c0 = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr0 + i));
+        __m256i _c1 = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr1 + i));
+        __m256i _c2 = saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr2 + i));
+        __m256i _c3 = ptr3 ? saturate_epu8_epi32_avx2(_mm256_loadu_ps(ptr3 + i)) : _mm256_set1_epi32(255);
+        _mm256_storeu_si256((__m256i*)(dst + i * 4), pack_c4_epi32_avx2(_c0, _c1, _c2, _c3));
+    }
+#endif // __AVX2__
+    for (; i + 3 < size; i += 4)
+    {
+        __m128i _c0 = _mm_cvttps_epi32(_mm_loadu_ps(ptr0 + i));
+        __m128i _c1 = _mm_cvttps_epi32(_mm_loadu_ps(ptr1 + i));
+        __m128i _c2 = _mm_cvttps_epi32(_mm_loadu_ps(ptr2 + i));
+        __m128i _c3 = ptr3 ? _mm_cvttps_epi32(_mm_loadu_ps(ptr3 + i)) : _mm_set1_epi32(255);
+        _mm_storeu_si128((__m128i*)(dst + i * 4), pack_c4_epi32_sse2(_c0, _c1, _c2, _c3));
+    }
+
+    return i;
+}
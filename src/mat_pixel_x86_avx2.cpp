@@ -0,0 +1,124 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "mat.h"
+
+namespace ncnn {
+
+#if NCNN_PIXEL
+#include "mat_pixel_x86.h"
+
+int from_c1_sse_avx2(const unsigned char* src, float* ptr, int size)
+{
+    return from_c1_sse(src, ptr, size);
+}
+
+int from_c1_to_c3_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    return from_c1_to_c3_sse(src, ptr0, ptr1, ptr2, size);
+}
+
+int from_c3_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    return from_c3_sse(src, ptr0, ptr1, ptr2, size);
+}
+
+int from_c3_to_gray_sse_avx2(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2)
+{
+    return from_c3_to_gray_sse(src, ptr, size, w0, w1, w2);
+}
+
+int from_c4_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, float* ptr3, int size)
+{
+    return from_c4_sse(src, ptr0, ptr1, ptr2, ptr3, size);
+}
+
+int from_c4_to_c3_sse_avx2(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    return from_c4_to_c3_sse(src, ptr0, ptr1, ptr2, size);
+}
+
+int from_c4_to_gray_sse_avx2(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2)
+{
+    return from_c4_to_gray_sse(src, ptr, size, w0, w1, w2);
+}
+
+int to_c1_sse_avx2(const float* ptr, unsigned char* dst, int size)
+{
+    return to_c1_sse(ptr, dst, size);
+}
+
+int to_c1_to_c4_sse_avx2(const float* ptr, unsigned char* dst, int size)
+{
+    return to_c1_to_c4_sse(ptr, dst, size);
+}
+
+int to_c3_sse_avx2(const float* ptr0, const float* ptr1, const float* ptr2, unsigned char* dst, int size)
+{
+    return to_c3_sse(ptr0, ptr1, ptr2, dst, size);
+}
+
+int to_c4_sse_avx2(const float* ptr0, const float* ptr1, const float* ptr2, const float* ptr3, unsigned char* dst, int size)
+{
+    return to_c4_sse(ptr0, ptr1, ptr2, ptr3, dst, size);
+}
+
+#include "mat_pixel_resize_x86.h"
+
+int resize_bilinear_hresize_c1_sse_avx2(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    return resize_bilinear_hresize_c1_sse(S, rowsize, xofs, ialpha, rows, w);
+}
+
+int resize_bilinear_hresize_c2_sse_avx2(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    return resize_bilinear_hresize_c2_sse(S, rowsize, xofs, ialpha, rows, w);
+}
+
+int resize_bilinear_hresize_c3_sse_avx2(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    return resize_bilinear_hresize_c3_sse(S, xofs, ialpha, rows, w);
+}
+
+int resize_bilinear_hresize_c4_sse_avx2(const unsigned char* S, int rowsize, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    return resize_bilinear_hresize_c4_sse(S, rowsize, xofs, ialpha, rows, w);
+}
+
+int resize_bilinear_vresize_two_sse_avx2(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp0, unsigned char* Dp1, short b0, short b1, short b2, short b3)
+{
+    return resize_bilinear_vresize_two_sse(rows0p, rows1p, wsize, Dp0, Dp1, b0, b1, b2, b3);
+}
+
+int resize_bilinear_vresize_one_sse_avx2(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp, short b0, short b1)
+{
+    return resize_bilinear_vresize_one_sse(rows0p, rows1p, wsize, Dp, b0, b1);
+}
+#endif // NCNN_PIXEL
+
+#if NCNN_PIXEL_AFFINE
+#include "mat_pixel_affine_x86.h"
+
+void warpaffine_bilinear_c1_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+    warpaffine_bilinear_c1_inside_8_sse(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+}
+
+void warpaffine_bilinear_c2_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+    warpaffine_bilinear_c2_inside_8_sse(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+}
+
+void warpaffine_bilinear_c3_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+    warpaffine_bilinear_c3_inside_8_sse(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+}
+
+void warpaffine_bilinear_c4_inside_8_sse_avx2(const unsigned char* src0, int srcstride, int X0, int Y0, const int* adelta, const int* bdelta, unsigned char* dst0)
+{
+    warpaffine_bilinear_c4_inside_8_sse(src0, srcstride, X0, Y0, adelta, bdelta, dst0);
+}
+#endif // NCNN_PIXEL_AFFINE
+
+} // namespace ncnn
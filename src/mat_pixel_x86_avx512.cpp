@@ -0,0 +1,68 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "mat.h"
+
+namespace ncnn {
+
+#if NCNN_PIXEL
+#include "mat_pixel_x86.h"
+
+int from_c1_sse_avx512(const unsigned char* src, float* ptr, int size)
+{
+    return from_c1_sse(src, ptr, size);
+}
+
+int from_c1_to_c3_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    return from_c1_to_c3_sse(src, ptr0, ptr1, ptr2, size);
+}
+
+int from_c3_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    return from_c3_sse(src, ptr0, ptr1, ptr2, size);
+}
+
+int from_c3_to_gray_sse_avx512(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2)
+{
+    return from_c3_to_gray_sse(src, ptr, size, w0, w1, w2);
+}
+
+int from_c4_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, float* ptr3, int size)
+{
+    return from_c4_sse(src, ptr0, ptr1, ptr2, ptr3, size);
+}
+
+int from_c4_to_c3_sse_avx512(const unsigned char* src, float* ptr0, float* ptr1, float* ptr2, int size)
+{
+    return from_c4_to_c3_sse(src, ptr0, ptr1, ptr2, size);
+}
+
+int from_c4_to_gray_sse_avx512(const unsigned char* src, float* ptr, int size, int w0, int w1, int w2)
+{
+    return from_c4_to_gray_sse(src, ptr, size, w0, w1, w2);
+}
+
+int to_c1_sse_avx512(const float* ptr, unsigned char* dst, int size)
+{
+    return to_c1_sse(ptr, dst, size);
+}
+
+int to_c1_to_c4_sse_avx512(const float* ptr, unsigned char* dst, int size)
+{
+    return to_c1_to_c4_sse(ptr, dst, size);
+}
+
+int to_c3_sse_avx512(const float* ptr0, const float* ptr1, const float* ptr2, unsigned char* dst, int size)
+{
+    return to_c3_sse(ptr0, ptr1, ptr2, dst, size);
+}
+
+int to_c4_sse_avx512(const float* ptr0, const float* ptr1, const float* ptr2, const float* ptr3, unsigned char* dst, int size)
+{
+    return to_c4_sse(ptr0, ptr1, ptr2, ptr3, dst, size);
+}
+#endif // NCNN_PIXEL
+
+} // namespace ncnn
@@ -5,6 +5,7 @@
 
 #include "datareader.h"
 
+#include <algorithm>
 #include <string.h>
 
 namespace ncnn {
@@ -110,6 +111,46 @@ Mat ModelBinFromDataReader::load(int w, int type) const
         swap_endianness_32(&flag_struct.tag);
 #endif
 
+        while (flag_struct.tag == 0x00444150)
+        {
+            // alignment padding in front of the weight data
+            unsigned int padding_size = 0;
+            nread = d->dr.read(&padding_size, sizeof(padding_size));
+            if (nread != sizeof(padding_size))
+            {
+                NCNN_LOGE("ModelBin read padding_size failed %zd", nread);
+                return Mat();
+            }
+
+#if __BIG_ENDIAN__
+            swap_endianness_32(&padding_size);
+#endif
+
+            const void* refbuf = 0;
+            nread = d->dr.reference(padding_size, &refbuf);
+            if (nread != padding_size)
+            {
+                std::vector<unsigned char> padding(padding_size);
+                nread = padding_size == 0 ? 0 : d->dr.read(&padding[0], padding_size);
+                if (nread != padding_size)
+                {
+                    NCNN_LOGE("ModelBin read padding failed %zd", nread);
+                    return Mat();
+                }
+            }
+
+            nread = d->dr.read(&flag_struct, sizeof(flag_struct));
+            if (nread != sizeof(flag_struct))
+            {
+                NCNN_LOGE("ModelBin read flag_struct failed %zd", nread);
+                return Mat();
+            }
+
+#if __BIG_ENDIAN__
+            swap_endianness_32(&flag_struct.tag);
+#endif
+        }
+
         unsigned int flag = (int)flag_struct.f0 + flag_struct.f1 + flag_struct.f2 + flag_struct.f3;
 
         if (flag_struct.tag == 0x01306B47)
@@ -218,6 +259,84 @@ Mat ModelBinFromDataReader::load(int w, int type) const
 
             return m;
         }
+        else if (flag_struct.tag == 0x00535042)
+        {
+            // block sparse data
+            // block size, nonzero block count, bitmask of nonzero blocks, then the values of nonzero blocks
+            unsigned int header[2];
+            nread = d->dr.read(header, sizeof(header));
+            if (nread != sizeof(header))
+            {
+                NCNN_LOGE("ModelBin read sparse header failed %zd", nread);
+                return Mat();
+            }
+
+#if __BIG_ENDIAN__
+            swap_endianness_32(&header[0]);
+            swap_endianness_32(&header[1]);
+#endif
+
+            const int block_size = header[0];
+            const int block_count = block_size > 0 ? (w + block_size - 1) / block_size : 0;
+            const int nonzero_block_count = header[1];
+            if (block_size <= 0 || nonzero_block_count > block_count)
+            {
+                NCNN_LOGE("ModelBin invalid sparse header %d %d", block_size, nonzero_block_count);
+                return Mat();
+            }
+
+            size_t align_mask_size = alignSize((block_count + 7) / 8, 4);
+            std::vector<unsigned char> mask(align_mask_size);
+            nread = d->dr.read(&mask[0], align_mask_size);
+            if (nread != align_mask_size)
+            {
+                NCNN_LOGE("ModelBin read sparse mask failed %zd", nread);
+                return Mat();
+            }
+
+            const size_t values_size = (size_t)nonzero_block_count * block_size;
+            std::vector<float> values(values_size + 1);
+            nread = values_size == 0 ? 0 : d->dr.read(&values[0], values_size * sizeof(float));
+            if (nread != values_size * sizeof(float))
+            {
+                NCNN_LOGE("ModelBin read sparse values failed %zd", nread);
+                return Mat();
+            }
+
+#if __BIG_ENDIAN__
+            for (size_t i = 0; i < values_size; i++)
+            {
+                swap_endianness_32(&values[i]);
+            }
+#endif
+
+            m.create(w);
+            if (m.empty())
+                return m;
+
+            m.fill(0.f);
+
+            float* ptr = m;
+            const float* vptr = &values[0];
+            int n = 0;
+            for (int i = 0; i < block_count; i++)
+            {
+                if (!(mask[i / 8] & (1 << (i % 8))))
+                    continue;
+
+                if (n == nonzero_block_count)
+                {
+                    NCNN_LOGE("ModelBin sparse mask and block count mismatch");
+                    return Mat();
+                }
+
+                const int size = std::min(block_size, w - i * block_size);
+                memcpy(ptr + i * block_size, vptr + (size_t)n * block_size, size * sizeof(float));
+                n++;
+            }
+
+            return m;
+        }
 
         if (flag != 0)
         {
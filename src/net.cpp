@@ -3,20 +3,20 @@
 
 #include "net.h"
 
+#include "benchmark.h"
 #include "cpu.h"
 #include "datareader.h"
 #include "layer_type.h"
 #include "modelbin.h"
 #include "paramdict.h"
+#include "profiler.h"
+#include "threadpool.h"
 
+#include <algorithm>
 #include <stdarg.h>
 #include <stdint.h>
 #include <string.h>
 
-#if NCNN_BENCHMARK
-#include "benchmark.h"
-#endif // NCNN_BENCHMARK
-
 #if NCNN_VULKAN
 #include "command.h"
 #include "pipelinecache.h"
@@ -24,6 +24,136 @@
 
 namespace ncnn {
 
+#if NCNN_THREADS
+class BranchWorkerPool;
+#endif // NCNN_THREADS
+class BlobArenaPlan;
+class BlobArenaAllocator;
+
+// the profiler of the extractor running layers on the current thread
+static ThreadLocalStorage tls_profiler;
+
+static Profiler* get_current_profiler()
+{
+    return (Profiler*)tls_profiler.get();
+}
+
+static void set_current_profiler(Profiler* profiler)
+{
+    tls_profiler.set((void*)profiler);
+}
+
+// the layer replicas of the numa node the extractor on the current thread is bound to
+// null for the layers of the net itself
+static ThreadLocalStorage tls_numa_layers;
+
+static const std::vector<Layer*>* get_current_numa_layers()
+{
+    return (const std::vector<Layer*>*)tls_numa_layers.get();
+}
+
+static void set_current_numa_layers(const std::vector<Layer*>* numa_layers)
+{
+    tls_numa_layers.set((void*)numa_layers);
+}
+
+// the per-layer streaming states of the extractor on the current thread
+// null when the extractor is not in streaming mode
+static ThreadLocalStorage tls_streaming_states;
+
+static std::vector<std::vector<Mat> >* get_current_streaming_states()
+{
+    return (std::vector<std::vector<Mat> >*)tls_streaming_states.get();
+}
+
+static void set_current_streaming_states(std::vector<std::vector<Mat> >* streaming_states)
+{
+    tls_streaming_states.set((void*)streaming_states);
+}
+
+// layers combining frames along the time axis, chunk by chunk they are only right with support_streaming
+static bool is_temporal_layer(int typeindex)
+{
+    switch (typeindex)
+    {
+    case LayerType::Convolution:
+    case LayerType::ConvolutionDepthWise:
+    case LayerType::Convolution1D:
+    case LayerType::ConvolutionDepthWise1D:
+    case LayerType::Convolution3D:
+    case LayerType::ConvolutionDepthWise3D:
+    case LayerType::Deconvolution:
+    case LayerType::DeconvolutionDepthWise:
+    case LayerType::Deconvolution1D:
+    case LayerType::DeconvolutionDepthWise1D:
+    case LayerType::Deconvolution3D:
+    case LayerType::DeconvolutionDepthWise3D:
+    case LayerType::DeformableConv2D:
+    case LayerType::Pooling:
+    case LayerType::Pooling1D:
+    case LayerType::Pooling3D:
+    case LayerType::StatisticsPooling:
+    case LayerType::RNN:
+    case LayerType::LSTM:
+    case LayerType::GRU:
+    case LayerType::MultiHeadAttention:
+    case LayerType::Spectrogram:
+    case LayerType::InverseSpectrogram:
+    case LayerType::CumulativeSum:
+    case LayerType::Fold:
+    case LayerType::Unfold:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// the first temporal layer without streaming support that the blob depends on, -1 for none
+static int find_non_streaming_layer(const Net* net, int blob_index)
+{
+    const std::vector<Blob>& blobs = net->blobs();
+    const std::vector<Layer*>& layers = net->layers();
+
+    std::vector<char> visited(layers.size(), 0);
+    std::vector<int> blob_stack(1, blob_index);
+    while (!blob_stack.empty())
+    {
+        int layer_index = blobs[blob_stack.back()].producer;
+        blob_stack.pop_back();
+
+        if (layer_index < 0 || visited[layer_index])
+            continue;
+
+        visited[layer_index] = 1;
+
+        const Layer* layer = layers[layer_index];
+        if (is_temporal_layer(layer->typeindex) && !layer->support_streaming)
+            return layer_index;
+
+        blob_stack.insert(blob_stack.end(), layer->bottoms.begin(), layer->bottoms.end());
+    }
+
+    return -1;
+}
+
+static void get_blob_shapes(const std::vector<Mat>& blob_mats, const std::vector<int>& blob_indexes, std::vector<Mat>& shapes)
+{
+    shapes.resize(blob_indexes.size());
+    for (size_t i = 0; i < blob_indexes.size(); i++)
+    {
+        const Mat& m = blob_mats[blob_indexes[i]];
+        Mat& shape = shapes[i];
+        shape.dims = m.dims;
+        shape.w = m.w;
+        shape.h = m.h;
+        shape.d = m.d;
+        shape.c = m.c;
+        shape.cstep = m.cstep;
+        shape.elemsize = m.elemsize;
+        shape.elempack = m.elempack;
+    }
+}
+
 class NetPrivate
 {
 public:
@@ -40,6 +170,12 @@ public:
     friend class Extractor;
     int forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
 
+    // run independent branches on partitioned thread groups
+    int forward_layer_branch_parallel(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
+
+    // forward one layer whose bottom blobs are all ready
+    int run_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
+
 #if NCNN_VULKAN
     int forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
 #endif // NCNN_VULKAN
@@ -47,6 +183,7 @@ public:
     int convert_layout(Mat& bottom_blob, const Layer* layer, const Option& opt) const;
 
     int do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, const Option& opt) const;
+    int do_forward_layer_streaming(const Layer* layer, std::vector<Mat>& blob_mats, std::vector<Mat>& states, const Option& opt) const;
 #if NCNN_VULKAN
     int do_forward_layer(const Layer* layer, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
 #endif // NCNN_VULKAN
@@ -55,6 +192,27 @@ public:
 #if NCNN_STRING
     void update_input_output_names();
 #endif // NCNN_STRING
+    void update_branch_width();
+
+    // the thread budget of one layer when branches run concurrently
+    int get_branch_num_threads(int layer_index, int num_threads) const;
+
+    // the option passed to create_pipeline of one layer
+    Option get_layer_option(int layer_index) const;
+
+    // import the cached pipeline of one layer or create it
+    int create_layer_pipeline(int layer_index);
+
+    // destroy the pipeline and delete the layer with its registered destroyer
+    void destroy_layer(Layer* layer);
+
+    // arena allocator for one forward pass, replaying the plan of the same shape signature if any
+    BlobArenaAllocator* create_blob_arena(const std::vector<Mat>& blob_mats, int blob_index, const Option& opt) const;
+    void update_blob_arena_plan(BlobArenaAllocator* blob_arena) const;
+
+    // run the layer for every sample of a batch, the layers supporting batch stacking run once
+    // blob_mats is the scratch space of single forward
+    int forward_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, std::vector<Mat>& batch_stacked_mats, std::vector<Mat>& blob_mats, const Option& opt) const;
 
     std::vector<Blob> blobs;
     std::vector<Layer*> layers;
@@ -72,6 +230,47 @@ public:
     PoolAllocator* local_blob_allocator;
     PoolAllocator* local_workspace_allocator;
 
+    // the max number of layers that may run concurrently
+    int branch_width;
+    // the number of layers sharing the same graph level with each layer
+    std::vector<int> branch_level_widths;
+#if NCNN_THREADS
+    BranchWorkerPool* branch_worker_pool;
+#endif // NCNN_THREADS
+
+    mutable std::vector<BlobArenaPlan*> blob_arena_plans;
+    mutable Mutex blob_arena_plans_lock;
+
+#if NCNN_STDIO
+    // the mapped model file referenced by layer weights
+    DataReaderFromMmap* model_mmap;
+
+    // the mapped pipeline cache file referenced by layer pipelines
+    DataReaderFromMmap* pipeline_cache_mmap;
+    // the cached pipeline data per layer, consumed by load_model
+    std::vector<std::vector<Mat> > pipeline_cache_data;
+    // the layer hash each cached record was created for
+    std::vector<unsigned int> pipeline_cache_hashes;
+
+    // the hash of the params of every layer, set in load_param
+    std::vector<unsigned int> layer_param_hashes;
+    // the hash of the params and weights of every layer, set in load_model
+    // pipeline cache records are reused for the same hash only
+    std::vector<unsigned int> layer_hashes;
+#endif // NCNN_STDIO
+
+    // the layer params kept by load_param for building the numa replicas, consumed by load_model
+    std::vector<ParamDict> numa_layer_params;
+
+    // the layer replicas per numa node, node 0 runs the layers of the net itself
+    // replicas are null for the layers loading no weight
+    std::vector<std::vector<Layer*> > numa_layers;
+    std::vector<ThreadPool*> numa_thread_pools;
+    std::vector<PoolAllocator*> numa_blob_allocators;
+    std::vector<PoolAllocator*> numa_workspace_allocators;
+    size_t numa_replica_size;
+    mutable int numa_next_node;
+
 #if NCNN_VULKAN
     const VulkanDevice* vkdev;
 
@@ -88,6 +287,19 @@ NetPrivate::NetPrivate(Option& _opt)
     local_blob_allocator = 0;
     local_workspace_allocator = 0;
 
+    branch_width = 1;
+#if NCNN_THREADS
+    branch_worker_pool = 0;
+#endif // NCNN_THREADS
+
+    numa_replica_size = 0;
+    numa_next_node = 0;
+
+#if NCNN_STDIO
+    model_mmap = 0;
+    pipeline_cache_mmap = 0;
+#endif // NCNN_STDIO
+
 #if NCNN_VULKAN
     vkdev = 0;
     weight_vkallocator = 0;
@@ -115,6 +327,10 @@ static Option get_masked_option(const Option& opt, int featmask)
     if (featmask & (1 << 7))
         opt1.num_threads = 1;
 
+    opt1.use_winograd23_convolution = opt1.use_winograd23_convolution && !(featmask & (1 << 8));
+    opt1.use_winograd43_convolution = opt1.use_winograd43_convolution && !(featmask & (1 << 9));
+    opt1.use_winograd63_convolution = opt1.use_winograd63_convolution && !(featmask & (1 << 10));
+
     return opt1;
 }
 
@@ -176,6 +392,37 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
         }
     }
 
+    return run_layer(layer_index, blob_mats, opt);
+}
+
+int NetPrivate::run_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const
+{
+    const std::vector<Layer*>* numa_layers = get_current_numa_layers();
+    const Layer* layer = numa_layers && (*numa_layers)[layer_index] ? (*numa_layers)[layer_index] : layers[layer_index];
+
+    std::vector<std::vector<Mat> >* streaming_states = get_current_streaming_states();
+    if (streaming_states && !layer->bottoms.empty() && blob_mats[layer->bottoms[0]].empty())
+    {
+        // no new frame reaches this layer in the current chunk
+        // mark the top blobs computed and empty
+        for (size_t i = 0; i < layer->tops.size(); i++)
+        {
+            Mat& top_blob = blob_mats[layer->tops[i]];
+            top_blob.release();
+            top_blob.dims = 1;
+        }
+
+        if (opt.lightmode)
+        {
+            for (size_t i = 0; i < layer->bottoms.size(); i++)
+            {
+                blob_mats[layer->bottoms[i]].release();
+            }
+        }
+
+        return 0;
+    }
+
 #if NCNN_BENCHMARK
     double start = get_current_time();
     Mat bottom_blob;
@@ -191,8 +438,22 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
         bottom_blob.elemsize = blob_mats[bottom_blob_index].elemsize;
     }
 #endif
+    Profiler* profiler = get_current_profiler();
+    LayerProfile profile;
+    if (profiler)
+    {
+        get_blob_shapes(blob_mats, layer->bottoms, profile.bottom_shapes);
+        profiler_take_kernel();
+        profile.start = get_current_time();
+    }
+
     int ret = 0;
-    if (layer->featmask)
+    if (streaming_states && layer->support_streaming)
+    {
+        std::vector<Mat>& states = (*streaming_states)[layer_index];
+        ret = do_forward_layer_streaming(layer, blob_mats, states, layer->featmask ? get_masked_option(opt, layer->featmask) : opt);
+    }
+    else if (layer->featmask)
     {
         ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
     }
@@ -200,6 +461,28 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
     {
         ret = do_forward_layer(layer, blob_mats, opt);
     }
+
+    if (profiler && ret == 0)
+    {
+        profile.end = get_current_time();
+        profile.layer_index = layer_index;
+#if NCNN_STRING
+        profile.type = layer->type;
+        profile.name = layer->name;
+#endif // NCNN_STRING
+        profile.thread_id = profiler_thread_id();
+        profile.num_threads = layer->featmask & (1 << 7) ? 1 : opt.num_threads;
+        profile.kernel = profiler_take_kernel();
+
+        get_blob_shapes(blob_mats, layer->tops, profile.top_shapes);
+        for (size_t i = 0; i < layer->tops.size(); i++)
+        {
+            const Mat& top_blob = blob_mats[layer->tops[i]];
+            profile.top_bytes += top_blob.total() * top_blob.elemsize;
+        }
+
+        profiler->record(profile);
+    }
 #if NCNN_BENCHMARK
     double end = get_current_time();
     if (layer->one_blob_only)
@@ -222,132 +505,1095 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
     return 0;
 }
 
-#if NCNN_VULKAN
-int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const
+#if NCNN_THREADS
+// shared state of one branch parallel forward
+class BranchScheduler
 {
-    const Layer* layer = layers[layer_index];
+public:
+    BranchScheduler(const NetPrivate* _net, std::vector<Mat>& _blob_mats, const Option& _opt);
 
-    //     NCNN_LOGE("forward_layer %d %d %s", layer->support_vulkan, layer_index, layer->name.c_str());
+    // pull ready layers and run them until the whole graph is done
+    void run();
 
-    bool cmd_submit_and_wait = false;
+public:
+    const NetPrivate* net;
+    std::vector<Mat>& blob_mats;
+    const Option& opt;
+
+    // profiler, thread pool, numa layers and streaming states of the calling thread, attached to the helper threads as well
+    Profiler* profiler;
+    ThreadPool* thread_pool;
+    const std::vector<Layer*>* numa_layers;
+    std::vector<std::vector<Mat> >* streaming_states;
+
+    // count of unresolved bottom blobs per layer, -1 for layers not involved
+    std::vector<int> pending;
+    std::vector<int> ready;
+    int running;
+    int remaining;
+    int ret;
 
-    // load bottom blobs
-    for (size_t i = 0; i < layer->bottoms.size(); i++)
-    {
-        int bottom_blob_index = layer->bottoms[i];
+    // helper threads that finished run()
+    int helper_done;
 
-        if (blob_mats_gpu[bottom_blob_index].dims == 0 && blob_mats[bottom_blob_index].dims == 0)
+    Mutex lock;
+    ConditionVariable cond;
+};
+
+BranchScheduler::BranchScheduler(const NetPrivate* _net, std::vector<Mat>& _blob_mats, const Option& _opt)
+    : net(_net), blob_mats(_blob_mats), opt(_opt)
+{
+    profiler = get_current_profiler();
+    thread_pool = get_current_thread_pool();
+    numa_layers = get_current_numa_layers();
+    streaming_states = get_current_streaming_states();
+    running = 0;
+    remaining = 0;
+    ret = 0;
+    helper_done = 0;
+}
+
+void BranchScheduler::run()
+{
+    Profiler* old_profiler = get_current_profiler();
+    set_current_profiler(profiler);
+
+    ThreadPool* old_thread_pool = get_current_thread_pool();
+    set_current_thread_pool(thread_pool);
+
+    const std::vector<Layer*>* old_numa_layers = get_current_numa_layers();
+    set_current_numa_layers(numa_layers);
+
+    std::vector<std::vector<Mat> >* old_streaming_states = get_current_streaming_states();
+    set_current_streaming_states(streaming_states);
+
+    lock.lock();
+    for (;;)
+    {
+        while (ready.empty() && remaining > 0 && ret == 0)
         {
-            int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, blob_mats_gpu, cmd, opt);
-            if (ret != 0)
-                return ret;
+            cond.wait(lock);
         }
 
-        if (layer->support_vulkan)
-        {
-            if (blob_mats_gpu[bottom_blob_index].dims == 0)
-            {
-                // host to buffer
-                cmd.record_upload(blob_mats[bottom_blob_index], blob_mats_gpu[bottom_blob_index], opt);
+        if (remaining == 0 || ret != 0)
+            break;
 
-                if (opt.lightmode)
-                {
-                    // delete after taken in light mode
-                    blob_mats[bottom_blob_index].release();
-                }
-            }
+        int layer_index = ready.back();
+        ready.pop_back();
+        running++;
+
+        Option opt1 = opt;
+        opt1.num_threads = net->get_branch_num_threads(layer_index, opt.num_threads);
+
+        lock.unlock();
+
+        int lret = net->run_layer(layer_index, blob_mats, opt1);
+
+        lock.lock();
+
+        running--;
+        remaining--;
+
+        if (lret != 0)
+        {
+            ret = lret;
         }
         else
         {
-            if (blob_mats[bottom_blob_index].dims == 0)
+            const Layer* layer = net->layers[layer_index];
+            for (size_t i = 0; i < layer->tops.size(); i++)
             {
-                Option opt_download = opt;
-                opt_download.use_packing_layout = layer->support_packing;
-
-                // buffer to host
-                cmd.record_download(blob_mats_gpu[bottom_blob_index], blob_mats[bottom_blob_index], opt_download);
-
-                if (opt.lightmode)
-                {
-                    // delete after taken in light mode
-                    blob_mats_gpu[bottom_blob_index].release();
-                }
+                int consumer = net->blobs[layer->tops[i]].consumer;
+                if (consumer == -1 || pending[consumer] <= 0)
+                    continue;
 
-                cmd_submit_and_wait = true;
+                pending[consumer]--;
+                if (pending[consumer] == 0)
+                    ready.push_back(consumer);
             }
         }
+
+        cond.broadcast();
     }
 
-    int ret;
-    if (cmd_submit_and_wait)
+    // wait for the layers still running on other groups
+    while (running > 0)
     {
-        ret = cmd.submit_and_wait();
+        cond.wait(lock);
+    }
+    lock.unlock();
 
-#if NCNN_BENCHMARK
-        std::vector<uint64_t> results(layer_index * 2);
-        cmd.get_query_pool_results(0, layer_index * 2, results);
-        for (int i = 0; i < layer_index; i++)
-        {
-            uint64_t start = results[i * 2];
-            uint64_t end = results[i * 2 + 1];
-            if (start == 0 || end == 0)
-                continue;
+    set_current_profiler(old_profiler);
+    set_current_thread_pool(old_thread_pool);
+    set_current_numa_layers(old_numa_layers);
+    set_current_streaming_states(old_streaming_states);
+}
 
-            double duration_us = (end - start) * vkdev->info.timestamp_period() / 1000;
-            NCNN_LOGE("%-24s %-30s %8.2lfus    |", layers[i]->type.c_str(), layers[i]->name.c_str(), duration_us);
-        }
-#endif // NCNN_BENCHMARK
+// persistent helper threads shared by all extractors of one net
+class BranchWorkerPool
+{
+public:
+    BranchWorkerPool(int thread_count);
+    ~BranchWorkerPool();
 
-        cmd.reset();
-        if (ret != 0)
-            return ret;
+    // ask count idle helpers to join the scheduler
+    void submit(BranchScheduler* s, int count);
+
+    // withdraw requests not yet picked up, return how many were withdrawn
+    int cancel(BranchScheduler* s);
+
+    int size() const;
+
+private:
+    static void* worker_main(void* args);
+
+    std::vector<Thread*> threads;
+    std::vector<BranchScheduler*> tasks;
+    bool quit;
+
+    Mutex lock;
+    ConditionVariable cond;
+};
+
+BranchWorkerPool::BranchWorkerPool(int thread_count)
+{
+    quit = false;
+
+    threads.resize(thread_count);
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i] = new Thread(worker_main, (void*)this);
     }
+}
 
-    if (layer->support_vulkan)
+BranchWorkerPool::~BranchWorkerPool()
+{
+    lock.lock();
+    quit = true;
+    cond.broadcast();
+    lock.unlock();
+
+    for (size_t i = 0; i < threads.size(); i++)
     {
-#if NCNN_BENCHMARK
-        cmd.record_write_timestamp(layer_index * 2);
-#endif
-        if (layer->featmask)
+        threads[i]->join();
+        delete threads[i];
+    }
+}
+
+void BranchWorkerPool::submit(BranchScheduler* s, int count)
+{
+    lock.lock();
+    for (int i = 0; i < count; i++)
+    {
+        tasks.push_back(s);
+    }
+    cond.broadcast();
+    lock.unlock();
+}
+
+int BranchWorkerPool::cancel(BranchScheduler* s)
+{
+    int count = 0;
+
+    lock.lock();
+    for (size_t i = 0; i < tasks.size();)
+    {
+        if (tasks[i] == s)
         {
-            ret = do_forward_layer(layer, blob_mats_gpu, cmd, get_masked_option(opt, layer->featmask));
+            tasks.erase(tasks.begin() + i);
+            count++;
         }
         else
         {
-            ret = do_forward_layer(layer, blob_mats_gpu, cmd, opt);
+            i++;
         }
-#if NCNN_BENCHMARK
-        cmd.record_write_timestamp(layer_index * 2 + 1);
-#endif
     }
-    else
+    lock.unlock();
+
+    return count;
+}
+
+int BranchWorkerPool::size() const
+{
+    return (int)threads.size();
+}
+
+void* BranchWorkerPool::worker_main(void* args)
+{
+    BranchWorkerPool* pool = (BranchWorkerPool*)args;
+
+    for (;;)
     {
-#if NCNN_BENCHMARK
-        double start = get_current_time();
-        Mat bottom_blob;
-        if (layer->one_blob_only)
-        {
-            int bottom_blob_index = layer->bottoms[0];
-            bottom_blob = blob_mats[bottom_blob_index].shape();
-        }
-#endif
-        if (layer->featmask)
-        {
-            ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
-        }
-        else
+        pool->lock.lock();
+        while (pool->tasks.empty() && !pool->quit)
         {
-            ret = do_forward_layer(layer, blob_mats, opt);
+            pool->cond.wait(pool->lock);
         }
-#if NCNN_BENCHMARK
-        double end = get_current_time();
-        if (layer->one_blob_only)
+
+        if (pool->quit)
         {
-            int top_blob_index = layer->tops[0];
-            benchmark(layer, bottom_blob, blob_mats[top_blob_index], start, end);
+            pool->lock.unlock();
+            break;
         }
-        else
-        {
+
+        BranchScheduler* s = pool->tasks.front();
+        pool->tasks.erase(pool->tasks.begin());
+        pool->lock.unlock();
+
+        set_flush_denormals(s->opt.flush_denormals);
+        set_kmp_work_stealing(s->opt.use_work_stealing);
+
+        s->run();
+
+        s->lock.lock();
+        s->helper_done++;
+        s->cond.broadcast();
+        s->lock.unlock();
+    }
+
+    return 0;
+}
+#endif // NCNN_THREADS
+
+int NetPrivate::forward_layer_branch_parallel(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const
+{
+#if NCNN_THREADS
+    const int group_count = std::min(opt.num_threads, branch_width);
+    if (group_count <= 1 || !branch_worker_pool)
+        return forward_layer(layer_index, blob_mats, opt);
+
+    BranchScheduler s(this, blob_mats, opt);
+
+    // collect the layers the requested blob depends on
+    s.pending.resize(layers.size(), -1);
+    std::vector<int> stack;
+    stack.push_back(layer_index);
+    s.pending[layer_index] = 0;
+    while (!stack.empty())
+    {
+        const Layer* layer = layers[stack.back()];
+        stack.pop_back();
+
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            int bottom_blob_index = layer->bottoms[i];
+            if (blob_mats[bottom_blob_index].dims != 0)
+                continue;
+
+            int producer = blobs[bottom_blob_index].producer;
+            if (s.pending[producer] == -1)
+            {
+                s.pending[producer] = 0;
+                stack.push_back(producer);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (s.pending[i] == -1)
+            continue;
+
+        const Layer* layer = layers[i];
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            if (blob_mats[layer->bottoms[j]].dims == 0)
+                s.pending[i]++;
+        }
+
+        s.remaining++;
+    }
+
+    // layers are stored in topological order, seed the ready queue in reverse
+    // so that the stack pops the earliest layer first
+    for (int i = (int)layers.size() - 1; i >= 0; i--)
+    {
+        if (s.pending[i] == 0)
+            s.ready.push_back(i);
+    }
+
+    const int helper_count = std::min(group_count - 1, branch_worker_pool->size());
+    branch_worker_pool->submit(&s, helper_count);
+
+    s.run();
+
+    // helpers that never showed up must not touch the scheduler any more
+    const int helper_claimed = helper_count - branch_worker_pool->cancel(&s);
+
+    s.lock.lock();
+    while (s.helper_done < helper_claimed)
+    {
+        s.cond.wait(s.lock);
+    }
+    s.lock.unlock();
+
+    return s.ret;
+#else
+    return forward_layer(layer_index, blob_mats, opt);
+#endif // NCNN_THREADS
+}
+
+// blob memory offsets planned for one forward pass of a fixed shape signature
+class BlobArenaPlan
+{
+public:
+    // input blob shapes, requested blob and light mode
+    std::vector<int> signature;
+
+    // the size of every blob allocation in request order
+    std::vector<size_t> sizes;
+
+    // the arena offset of every blob allocation
+    // blob outliving the forward pass has offset -1 and goes to the fallback allocator
+    std::vector<size_t> offsets;
+
+    size_t arena_size;
+};
+
+// serve blob allocations of one forward pass from a single contiguous arena
+// the first pass of a shape signature records allocation sizes and lifetimes
+// so that the following passes could replay them at precomputed offsets
+class BlobArenaAllocator : public Allocator
+{
+public:
+    BlobArenaAllocator(Allocator* _fallback, const BlobArenaPlan* _plan);
+    virtual ~BlobArenaAllocator();
+
+    virtual void* fastMalloc(size_t size);
+    virtual void fastFree(void* ptr);
+
+    // greedy-by-size offset assignment over the recorded blob lifetimes
+    BlobArenaPlan* create_plan();
+
+    bool recording() const;
+
+    // drop the extractor reference, destroy when all blobs are returned
+    void release();
+
+    size_t arena_size() const;
+
+public:
+    std::vector<int> signature;
+
+private:
+    void* fallback_malloc(size_t size);
+    void fallback_free(void* ptr);
+
+    Allocator* fallback;
+    const BlobArenaPlan* plan;
+    unsigned char* arena;
+
+    // the index of the next allocation
+    int alloc_index;
+    bool plan_mismatch;
+
+    // blobs not yet returned
+    int live_count;
+    bool released;
+
+    // recording state
+    int clock;
+    std::vector<size_t> record_sizes;
+    std::vector<int> record_alloc_times;
+    std::vector<int> record_free_times;
+    std::vector<std::pair<void*, int> > record_live_ptrs;
+
+    Mutex lock;
+};
+
+BlobArenaAllocator::BlobArenaAllocator(Allocator* _fallback, const BlobArenaPlan* _plan)
+    : Allocator(), fallback(_fallback), plan(_plan)
+{
+    arena = 0;
+    alloc_index = 0;
+    plan_mismatch = false;
+    live_count = 0;
+    released = false;
+    clock = 0;
+
+    if (plan && plan->arena_size > 0)
+    {
+        arena = (unsigned char*)fallback_malloc(plan->arena_size);
+        if (!arena)
+            plan_mismatch = true;
+    }
+}
+
+BlobArenaAllocator::~BlobArenaAllocator()
+{
+    if (arena)
+    {
+        fallback_free(arena);
+    }
+}
+
+void* BlobArenaAllocator::fallback_malloc(size_t size)
+{
+    return fallback ? fallback->fastMalloc(size) : ncnn::fastMalloc(size);
+}
+
+void BlobArenaAllocator::fallback_free(void* ptr)
+{
+    if (fallback)
+        fallback->fastFree(ptr);
+    else
+        ncnn::fastFree(ptr);
+}
+
+void* BlobArenaAllocator::fastMalloc(size_t size)
+{
+    MutexLockGuard guard(lock);
+
+    const int i = alloc_index++;
+
+    live_count++;
+
+    if (!plan)
+    {
+        void* ptr = fallback_malloc(size);
+
+        record_sizes.push_back(size);
+        record_alloc_times.push_back(clock++);
+        record_free_times.push_back(-1);
+        record_live_ptrs.push_back(std::make_pair(ptr, i));
+
+        return ptr;
+    }
+
+    if (!plan_mismatch && (i >= (int)plan->sizes.size() || plan->sizes[i] != size))
+    {
+        // the forward pass diverged from the recorded one
+        // keep the remaining blobs away from the arena
+        plan_mismatch = true;
+    }
+
+    if (plan_mismatch || plan->offsets[i] == (size_t)-1)
+        return fallback_malloc(size);
+
+    return arena + plan->offsets[i];
+}
+
+void BlobArenaAllocator::fastFree(void* ptr)
+{
+    lock.lock();
+
+    if (!plan)
+    {
+        for (size_t i = 0; i < record_live_ptrs.size(); i++)
+        {
+            if (record_live_ptrs[i].first == ptr)
+            {
+                record_free_times[record_live_ptrs[i].second] = clock++;
+                record_live_ptrs.erase(record_live_ptrs.begin() + i);
+                break;
+            }
+        }
+
+        fallback_free(ptr);
+    }
+    else if (!arena || (unsigned char*)ptr < arena || (unsigned char*)ptr >= arena + plan->arena_size)
+    {
+        fallback_free(ptr);
+    }
+
+    live_count--;
+
+    const bool destroy = released && live_count == 0;
+
+    lock.unlock();
+
+    if (destroy)
+        delete this;
+}
+
+BlobArenaPlan* BlobArenaAllocator::create_plan()
+{
+    MutexLockGuard guard(lock);
+
+    BlobArenaPlan* p = new BlobArenaPlan;
+    p->signature = signature;
+    p->sizes = record_sizes;
+    p->offsets.resize(record_sizes.size(), (size_t)-1);
+    p->arena_size = 0;
+
+    // place the largest blob first
+    std::vector<std::pair<size_t, int> > order;
+    for (size_t i = 0; i < record_sizes.size(); i++)
+    {
+        if (record_free_times[i] != -1)
+            order.push_back(std::make_pair(alignSize(record_sizes[i], NCNN_MALLOC_ALIGN), (int)i));
+    }
+    std::sort(order.begin(), order.end(), std::greater<std::pair<size_t, int> >());
+
+    // placed blobs sorted by offset
+    std::vector<int> placed;
+
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const size_t size = order[i].first;
+        const int x = order[i].second;
+
+        // pick the tightest gap among the blobs alive at the same time
+        size_t best_offset = (size_t)-1;
+        size_t best_gap = (size_t)-1;
+        size_t prev_end = 0;
+        for (size_t j = 0; j < placed.size(); j++)
+        {
+            const int y = placed[j];
+            if (record_alloc_times[x] > record_free_times[y] || record_alloc_times[y] > record_free_times[x])
+                continue;
+
+            const size_t y_offset = p->offsets[y];
+            if (y_offset > prev_end)
+            {
+                const size_t gap = y_offset - prev_end;
+                if (gap >= size && gap < best_gap)
+                {
+                    best_offset = prev_end;
+                    best_gap = gap;
+                }
+            }
+
+            prev_end = std::max(prev_end, y_offset + alignSize(record_sizes[y], NCNN_MALLOC_ALIGN));
+        }
+
+        if (best_offset == (size_t)-1)
+            best_offset = prev_end;
+
+        p->offsets[x] = best_offset;
+        p->arena_size = std::max(p->arena_size, best_offset + size);
+
+        size_t k = 0;
+        while (k < placed.size() && p->offsets[placed[k]] <= best_offset)
+            k++;
+        placed.insert(placed.begin() + k, x);
+    }
+
+    return p;
+}
+
+void BlobArenaAllocator::release()
+{
+    lock.lock();
+
+    released = true;
+
+    const bool destroy = live_count == 0;
+
+    lock.unlock();
+
+    if (destroy)
+        delete this;
+}
+
+bool BlobArenaAllocator::recording() const
+{
+    return !plan;
+}
+
+size_t BlobArenaAllocator::arena_size() const
+{
+    return arena ? plan->arena_size : 0;
+}
+
+BlobArenaAllocator* NetPrivate::create_blob_arena(const std::vector<Mat>& blob_mats, int blob_index, const Option& opt) const
+{
+    std::vector<int> signature;
+    signature.push_back(blob_index);
+    signature.push_back(opt.lightmode ? 1 : 0);
+    for (size_t i = 0; i < blob_mats.size(); i++)
+    {
+        const Mat& m = blob_mats[i];
+        if (m.dims == 0)
+            continue;
+
+        signature.push_back((int)i);
+        signature.push_back(m.dims);
+        signature.push_back(m.w);
+        signature.push_back(m.h);
+        signature.push_back(m.d);
+        signature.push_back(m.c);
+        signature.push_back(m.elempack);
+        signature.push_back((int)m.elemsize);
+    }
+
+    const BlobArenaPlan* plan = 0;
+    {
+        MutexLockGuard guard(blob_arena_plans_lock);
+
+        for (size_t i = 0; i < blob_arena_plans.size(); i++)
+        {
+            const std::vector<int>& s = blob_arena_plans[i]->signature;
+            if (s.size() == signature.size() && memcmp(&s[0], &signature[0], s.size() * sizeof(int)) == 0)
+            {
+                plan = blob_arena_plans[i];
+                break;
+            }
+        }
+    }
+
+    BlobArenaAllocator* blob_arena = new BlobArenaAllocator(opt.blob_allocator, plan);
+    if (!plan)
+    {
+        blob_arena->signature = signature;
+    }
+
+    return blob_arena;
+}
+
+void NetPrivate::update_blob_arena_plan(BlobArenaAllocator* blob_arena) const
+{
+    if (!blob_arena->recording())
+        return;
+
+    BlobArenaPlan* plan = blob_arena->create_plan();
+
+    MutexLockGuard guard(blob_arena_plans_lock);
+
+    // keep a bounded number of plans for models with dynamic input shape
+    bool drop = blob_arena_plans.size() >= 16;
+    for (size_t i = 0; i < blob_arena_plans.size() && !drop; i++)
+    {
+        const std::vector<int>& s = blob_arena_plans[i]->signature;
+        if (s.size() == plan->signature.size() && memcmp(&s[0], &plan->signature[0], s.size() * sizeof(int)) == 0)
+            drop = true;
+    }
+
+    if (drop)
+    {
+        delete plan;
+        return;
+    }
+
+    blob_arena_plans.push_back(plan);
+}
+
+static bool batch_sample_shape_equal(const Mat& a, const Mat& b)
+{
+    return a.dims == b.dims && a.w == b.w && a.h == b.h && a.d == b.d && a.c == b.c && a.elemsize == b.elemsize && a.elempack == b.elempack;
+}
+
+// stack the same-shaped samples of a batch
+// 1d samples become the rows of one 2d mat, 3d samples are stacked along height
+static int stack_batch_blob(const std::vector<Mat>& samples, Mat& stacked, const Option& opt)
+{
+    const int batch = (int)samples.size();
+    const Mat& m0 = samples[0];
+
+    if (m0.dims == 1)
+    {
+        const int w = m0.w * m0.elempack;
+        const size_t elemsize = m0.elemsize / m0.elempack;
+
+        stacked.create(w, batch, elemsize, opt.blob_allocator);
+        if (stacked.empty())
+            return -100;
+
+        for (int i = 0; i < batch; i++)
+        {
+            Mat m = samples[i];
+            if (m.elempack != 1)
+            {
+                Mat m_unpacked;
+                convert_packing(m, m_unpacked, 1, opt);
+                if (m_unpacked.empty())
+                    return -100;
+
+                m = m_unpacked;
+            }
+
+            memcpy(stacked.row<unsigned char>(i), m.data, w * elemsize);
+        }
+
+        return 0;
+    }
+
+    // dims == 3
+    const int w = m0.w;
+    const int h = m0.h;
+    const int channels = m0.c;
+    const size_t elemsize = m0.elemsize;
+    const int elempack = m0.elempack;
+
+    stacked.create(w, h * batch, channels, elemsize, elempack, opt.blob_allocator);
+    if (stacked.empty())
+        return -100;
+
+    for (int q = 0; q < channels; q++)
+    {
+        unsigned char* outptr = stacked.channel(q);
+
+        for (int i = 0; i < batch; i++)
+        {
+            memcpy(outptr + i * w * h * elemsize, samples[i].channel(q), w * h * elemsize);
+        }
+    }
+
+    return 0;
+}
+
+static int unstack_batch_blob(const Mat& stacked, std::vector<Mat>& samples, const Option& opt)
+{
+    const int batch = (int)samples.size();
+
+    if (stacked.dims == 2 && stacked.h * stacked.elempack == batch)
+    {
+        Mat m = stacked;
+        if (m.elempack != 1)
+        {
+            Mat m_unpacked;
+            convert_packing(m, m_unpacked, 1, opt);
+            if (m_unpacked.empty())
+                return -100;
+
+            m = m_unpacked;
+        }
+
+        for (int i = 0; i < batch; i++)
+        {
+            samples[i].create(m.w, m.elemsize, opt.blob_allocator);
+            if (samples[i].empty())
+                return -100;
+
+            memcpy(samples[i].data, m.row<const unsigned char>(i), m.w * m.elemsize);
+        }
+
+        return 0;
+    }
+
+    if (stacked.dims == 3 && stacked.h % batch == 0)
+    {
+        const int w = stacked.w;
+        const int h = stacked.h / batch;
+        const int channels = stacked.c;
+        const size_t elemsize = stacked.elemsize;
+        const int elempack = stacked.elempack;
+
+        for (int i = 0; i < batch; i++)
+        {
+            samples[i].create(w, h, channels, elemsize, elempack, opt.blob_allocator);
+            if (samples[i].empty())
+                return -100;
+
+            for (int q = 0; q < channels; q++)
+            {
+                const unsigned char* ptr = stacked.channel(q);
+
+                memcpy(samples[i].channel(q), ptr + i * w * h * elemsize, w * h * elemsize);
+            }
+        }
+
+        return 0;
+    }
+
+    NCNN_LOGE("unexpected stacked batch blob shape %d %d %d %d for batch %d", stacked.dims, stacked.w, stacked.h, stacked.c, batch);
+    return -1;
+}
+
+int NetPrivate::forward_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, std::vector<Mat>& batch_stacked_mats, std::vector<Mat>& blob_mats, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+
+    // load bottom blobs
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        int bottom_blob_index = layer->bottoms[i];
+
+        if (batch_blob_mats[bottom_blob_index][0].dims == 0 && batch_stacked_mats[bottom_blob_index].dims == 0)
+        {
+            int ret = forward_layer_batch(blobs[bottom_blob_index].producer, batch_blob_mats, batch_stacked_mats, blob_mats, opt);
+            if (ret != 0)
+                return ret;
+        }
+    }
+
+    const int batch = (int)batch_blob_mats[0].size();
+
+    // stack when all bottom samples share the same spatial shape
+    bool stack = batch > 1 && !layer->bottoms.empty();
+    int stack_dims = 0;
+    int stack_w = 0;
+    int stack_h = 0;
+    for (size_t i = 0; stack && i < layer->bottoms.size(); i++)
+    {
+        int bottom_blob_index = layer->bottoms[i];
+
+        const Mat& stacked = batch_stacked_mats[bottom_blob_index];
+        const std::vector<Mat>& samples = batch_blob_mats[bottom_blob_index];
+
+        int dims;
+        int w;
+        int h;
+        if (stacked.dims == 2)
+        {
+            dims = 1;
+            w = stacked.w;
+            h = 1;
+        }
+        else if (stacked.dims == 3)
+        {
+            dims = 3;
+            w = stacked.w;
+            h = stacked.h / batch;
+        }
+        else
+        {
+            dims = samples[0].dims;
+            w = samples[0].w * (dims == 1 ? samples[0].elempack : 1);
+            h = samples[0].h;
+
+            for (int j = 1; j < batch; j++)
+            {
+                if (!batch_sample_shape_equal(samples[j], samples[0]))
+                    stack = false;
+            }
+        }
+
+        if (i == 0)
+        {
+            stack_dims = dims;
+            stack_w = w;
+            stack_h = h;
+        }
+
+        if (dims != stack_dims || w != stack_w || h != stack_h)
+            stack = false;
+    }
+
+    if (stack)
+    {
+        // stacked pixels give more gemm columns to share among threads
+        // limit the stacked feature map size so that the packed input panel stays in cache
+        const bool stack_pixels = opt.num_threads > 1 && stack_w * stack_h * batch <= 4096;
+
+        stack = (stack_dims == 1 && layer->support_batch_rows) || (stack_dims == 3 && layer->support_batch_pixels && stack_pixels);
+    }
+
+    if (stack)
+    {
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            int bottom_blob_index = layer->bottoms[i];
+
+            Mat& stacked = batch_stacked_mats[bottom_blob_index];
+            if (stacked.dims == 0)
+            {
+                int ret = stack_batch_blob(batch_blob_mats[bottom_blob_index], stacked, opt);
+                if (ret != 0)
+                    return ret;
+            }
+
+            blob_mats[bottom_blob_index] = stacked;
+
+            if (opt.lightmode)
+            {
+                // hand over the only reference for inplace forward
+                stacked.release();
+                for (int j = 0; j < batch; j++)
+                {
+                    batch_blob_mats[bottom_blob_index][j].release();
+                }
+            }
+        }
+
+        int ret = run_layer(layer_index, blob_mats, opt);
+
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            blob_mats[layer->bottoms[i]].release();
+        }
+
+        for (size_t i = 0; i < layer->tops.size(); i++)
+        {
+            int top_blob_index = layer->tops[i];
+
+            batch_stacked_mats[top_blob_index] = blob_mats[top_blob_index];
+            blob_mats[top_blob_index].release();
+        }
+
+        return ret;
+    }
+
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        int bottom_blob_index = layer->bottoms[i];
+
+        if (batch_blob_mats[bottom_blob_index][0].dims == 0)
+        {
+            int ret = unstack_batch_blob(batch_stacked_mats[bottom_blob_index], batch_blob_mats[bottom_blob_index], opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        if (opt.lightmode)
+        {
+            batch_stacked_mats[bottom_blob_index].release();
+        }
+    }
+
+    for (int j = 0; j < batch; j++)
+    {
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            int bottom_blob_index = layer->bottoms[i];
+
+            blob_mats[bottom_blob_index] = batch_blob_mats[bottom_blob_index][j];
+
+            if (opt.lightmode)
+            {
+                // hand over the only reference for inplace forward
+                batch_blob_mats[bottom_blob_index][j].release();
+            }
+        }
+
+        int ret = run_layer(layer_index, blob_mats, opt);
+
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            blob_mats[layer->bottoms[i]].release();
+        }
+
+        for (size_t i = 0; i < layer->tops.size(); i++)
+        {
+            int top_blob_index = layer->tops[i];
+
+            batch_blob_mats[top_blob_index][j] = blob_mats[top_blob_index];
+            blob_mats[top_blob_index].release();
+        }
+
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+#if NCNN_VULKAN
+int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+
+    //     NCNN_LOGE("forward_layer %d %d %s", layer->support_vulkan, layer_index, layer->name.c_str());
+
+    bool cmd_submit_and_wait = false;
+
+    // load bottom blobs
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        int bottom_blob_index = layer->bottoms[i];
+
+        if (blob_mats_gpu[bottom_blob_index].dims == 0 && blob_mats[bottom_blob_index].dims == 0)
+        {
+            int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, blob_mats_gpu, cmd, opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        if (layer->support_vulkan)
+        {
+            if (blob_mats_gpu[bottom_blob_index].dims == 0)
+            {
+                // host to buffer
+                cmd.record_upload(blob_mats[bottom_blob_index], blob_mats_gpu[bottom_blob_index], opt);
+
+                if (opt.lightmode)
+                {
+                    // delete after taken in light mode
+                    blob_mats[bottom_blob_index].release();
+                }
+            }
+        }
+        else
+        {
+            if (blob_mats[bottom_blob_index].dims == 0)
+            {
+                Option opt_download = opt;
+                opt_download.use_packing_layout = layer->support_packing;
+
+                // buffer to host
+                cmd.record_download(blob_mats_gpu[bottom_blob_index], blob_mats[bottom_blob_index], opt_download);
+
+                if (opt.lightmode)
+                {
+                    // delete after taken in light mode
+                    blob_mats_gpu[bottom_blob_index].release();
+                }
+
+                cmd_submit_and_wait = true;
+            }
+        }
+    }
+
+    int ret;
+    if (cmd_submit_and_wait)
+    {
+        ret = cmd.submit_and_wait();
+
+#if NCNN_BENCHMARK
+        std::vector<uint64_t> results(layer_index * 2);
+        cmd.get_query_pool_results(0, layer_index * 2, results);
+        for (int i = 0; i < layer_index; i++)
+        {
+            uint64_t start = results[i * 2];
+            uint64_t end = results[i * 2 + 1];
+            if (start == 0 || end == 0)
+                continue;
+
+            double duration_us = (end - start) * vkdev->info.timestamp_period() / 1000;
+            NCNN_LOGE("%-24s %-30s %8.2lfus    |", layers[i]->type.c_str(), layers[i]->name.c_str(), duration_us);
+        }
+#endif // NCNN_BENCHMARK
+
+        cmd.reset();
+        if (ret != 0)
+            return ret;
+    }
+
+    if (layer->support_vulkan)
+    {
+#if NCNN_BENCHMARK
+        cmd.record_write_timestamp(layer_index * 2);
+#endif
+        if (layer->featmask)
+        {
+            ret = do_forward_layer(layer, blob_mats_gpu, cmd, get_masked_option(opt, layer->featmask));
+        }
+        else
+        {
+            ret = do_forward_layer(layer, blob_mats_gpu, cmd, opt);
+        }
+#if NCNN_BENCHMARK
+        cmd.record_write_timestamp(layer_index * 2 + 1);
+#endif
+    }
+    else
+    {
+#if NCNN_BENCHMARK
+        double start = get_current_time();
+        Mat bottom_blob;
+        if (layer->one_blob_only)
+        {
+            int bottom_blob_index = layer->bottoms[0];
+            bottom_blob = blob_mats[bottom_blob_index].shape();
+        }
+#endif
+        if (layer->featmask)
+        {
+            ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
+        }
+        else
+        {
+            ret = do_forward_layer(layer, blob_mats, opt);
+        }
+#if NCNN_BENCHMARK
+        double end = get_current_time();
+        if (layer->one_blob_only)
+        {
+            int top_blob_index = layer->tops[0];
+            benchmark(layer, bottom_blob, blob_mats[top_blob_index], start, end);
+        }
+        else
+        {
             benchmark(layer, start, end);
         }
 #endif
@@ -426,6 +1672,13 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
 
         int elembits = bottom_blob.elembits();
 
+#if NCNN_BF16 && !NCNN_ARM82 && !NCNN_VFPV4 && !NCNN_ZFH
+        // bf16 blob will be cast to fp32 below, resolve elempack as fp32
+        // x86 fp32 layers expect pack8 / pack16 where bf16 is packed by 4
+        if (elembits == 16 && opt.use_bf16_storage && !layer->support_bf16_storage)
+            elembits = 32;
+#endif // NCNN_BF16 && !NCNN_ARM82 && !NCNN_VFPV4 && !NCNN_ZFH
+
         if (layer->support_packing)
         {
             if (elembits == 32)
@@ -679,6 +1932,58 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats
     return 0;
 }
 
+int NetPrivate::do_forward_layer_streaming(const Layer* layer, std::vector<Mat>& blob_mats, std::vector<Mat>& states, const Option& opt) const
+{
+    std::vector<Mat> bottom_blobs(layer->bottoms.size());
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        bottom_blobs[i] = blob_mats[layer->bottoms[i]];
+
+        int ret = convert_layout(bottom_blobs[i], layer, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    // forward
+    std::vector<Mat> top_blobs(layer->tops.size());
+    int ret = layer->one_blob_only ? layer->forward_streaming(bottom_blobs[0], top_blobs[0], states, opt) : layer->forward_streaming(bottom_blobs, top_blobs, states, opt);
+    if (ret != 0)
+        return ret;
+
+    // states outlive the blob arena and the pool allocators of this pass
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        if (states[i].allocator)
+        {
+            states[i] = states[i].clone();
+            if (states[i].empty())
+                return -100;
+        }
+    }
+
+    // store top blobs
+    for (size_t i = 0; i < layer->tops.size(); i++)
+    {
+        Mat& top_blob = blob_mats[layer->tops[i]];
+        top_blob = top_blobs[i];
+
+        // empty when no window completes in the chunk, still marked computed
+        if (top_blob.dims == 0)
+            top_blob.dims = 1;
+    }
+
+    if (opt.lightmode)
+    {
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            // delete after taken in light mode
+            blob_mats[layer->bottoms[i]].release();
+        }
+    }
+
+    return 0;
+}
+
 #if NCNN_VULKAN
 int NetPrivate::do_forward_layer(const Layer* layer, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const
 {
@@ -705,150 +2010,467 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<VkMat>& blob_ma
             bottom_blob = bottom_blob_ref;
         }
 
-        // forward
-        if (opt.lightmode && layer->support_inplace)
+        // forward
+        if (opt.lightmode && layer->support_inplace)
+        {
+            VkMat& bottom_top_blob = bottom_blob;
+            int ret = layer->forward_inplace(bottom_top_blob, cmd, opt);
+            if (ret != 0)
+                return ret;
+
+            // store top blob
+            blob_mats_gpu[top_blob_index] = bottom_top_blob;
+        }
+        else
+        {
+            VkMat top_blob;
+            int ret = layer->forward(bottom_blob, top_blob, cmd, opt);
+            if (ret != 0)
+                return ret;
+
+            // store top blob
+            blob_mats_gpu[top_blob_index] = top_blob;
+        }
+
+        if (opt.lightmode)
+        {
+            // delete after taken in light mode
+            blob_mats_gpu[bottom_blob_index].release();
+        }
+    }
+    else
+    {
+        // load bottom blobs
+        std::vector<VkMat> bottom_blobs(layer->bottoms.size());
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            int bottom_blob_index = layer->bottoms[i];
+
+            VkMat& bottom_blob_ref = blob_mats_gpu[bottom_blob_index];
+            bottom_blobs[i].release();
+
+            if (opt.lightmode)
+            {
+                // deep copy for inplace forward if data is shared
+                if (layer->support_inplace && *bottom_blob_ref.refcount != 1)
+                {
+                    cmd.record_clone(bottom_blob_ref, bottom_blobs[i], opt);
+                    //                         NCNN_LOGE("clone %p[+%lu] %p[+%lu]", bottom_blob_ref.buffer(), bottom_blob_ref.buffer_offset(), bottom_blobs[i].buffer(), bottom_blobs[i].buffer_offset());
+                }
+            }
+            if (bottom_blobs[i].dims == 0)
+            {
+                bottom_blobs[i] = bottom_blob_ref;
+            }
+        }
+
+        // forward
+        if (opt.lightmode && layer->support_inplace)
+        {
+            std::vector<VkMat>& bottom_top_blobs = bottom_blobs;
+            int ret = layer->forward_inplace(bottom_top_blobs, cmd, opt);
+            if (ret != 0)
+                return ret;
+
+            // store top blobs
+            for (size_t i = 0; i < layer->tops.size(); i++)
+            {
+                int top_blob_index = layer->tops[i];
+
+                blob_mats_gpu[top_blob_index] = bottom_top_blobs[i];
+            }
+        }
+        else
+        {
+            std::vector<VkMat> top_blobs(layer->tops.size());
+            int ret = layer->forward(bottom_blobs, top_blobs, cmd, opt);
+            if (ret != 0)
+                return ret;
+
+            // store top blobs
+            for (size_t i = 0; i < layer->tops.size(); i++)
+            {
+                int top_blob_index = layer->tops[i];
+
+                blob_mats_gpu[top_blob_index] = top_blobs[i];
+            }
+        }
+
+        if (opt.lightmode)
+        {
+            for (size_t i = 0; i < layer->bottoms.size(); i++)
+            {
+                int bottom_blob_index = layer->bottoms[i];
+
+                // delete after taken in light mode
+                blob_mats_gpu[bottom_blob_index].release();
+            }
+        }
+    }
+
+    return 0;
+}
+#endif // NCNN_VULKAN
+
+void NetPrivate::update_input_output_indexes()
+{
+    input_blob_indexes.clear();
+    output_blob_indexes.clear();
+
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (layers[i]->typeindex == LayerType::Input)
+        {
+            int blob_index = layers[i]->tops[0];
+            input_blob_indexes.push_back(blob_index);
+        }
+    }
+
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        if (blobs[i].producer != -1 && blobs[i].consumer == -1)
+        {
+            output_blob_indexes.push_back(i);
+        }
+    }
+}
+
+#if NCNN_STRING
+void NetPrivate::update_input_output_names()
+{
+    input_blob_names.clear();
+    output_blob_names.clear();
+
+    for (size_t i = 0; i < input_blob_indexes.size(); i++)
+    {
+        int blob_index = input_blob_indexes[i];
+        input_blob_names.push_back(blobs[blob_index].name.c_str());
+    }
+
+    for (size_t i = 0; i < output_blob_indexes.size(); i++)
+    {
+        int blob_index = output_blob_indexes[i];
+        output_blob_names.push_back(blobs[blob_index].name.c_str());
+    }
+}
+#endif // NCNN_STRING
+
+void NetPrivate::update_branch_width()
+{
+    // group layers by their as-soon-as-possible level in the graph
+    // the widest level tells how many layers could run concurrently
+    std::vector<int> levels(layers.size(), -1);
+    std::vector<int> level_layer_counts(layers.size() + 1, 0);
+
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const Layer* layer = layers[i];
+        if (!layer || layer->bottoms.empty())
+            continue;
+
+        int level = 0;
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            int producer = blobs[layer->bottoms[j]].producer;
+            if (producer != -1)
+                level = std::max(level, levels[producer] + 1);
+        }
+
+        levels[i] = level;
+        level_layer_counts[level]++;
+    }
+
+    branch_width = 1;
+    branch_level_widths.resize(layers.size());
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        branch_level_widths[i] = levels[i] == -1 ? 1 : level_layer_counts[levels[i]];
+        branch_width = std::max(branch_width, branch_level_widths[i]);
+    }
+}
+
+int NetPrivate::get_branch_num_threads(int layer_index, int num_threads) const
+{
+    // layers on the same level run side by side, split the threads evenly
+    // the value must stay the same in create_pipeline and forward
+    // as kernels pre-pack weights for the thread count
+    const int groups = std::max(std::min(branch_level_widths[layer_index], num_threads), 1);
+    return std::max(num_threads / groups, 1);
+}
+
+Option NetPrivate::get_layer_option(int layer_index) const
+{
+    Option opt1 = opt;
+    if (opt.use_branch_parallel)
+    {
+        opt1.num_threads = get_branch_num_threads(layer_index, opt.num_threads);
+    }
+
+    return get_masked_option(opt1, layers[layer_index]->featmask);
+}
+
+int NetPrivate::create_layer_pipeline(int layer_index)
+{
+    Layer* layer = layers[layer_index];
+
+    Option opt1 = get_layer_option(layer_index);
+
+    int cret = -1;
+#if NCNN_STDIO
+    if (layer_index < (int)pipeline_cache_data.size() && !pipeline_cache_data[layer_index].empty())
+    {
+        if (pipeline_cache_hashes[layer_index] == layer_hashes[layer_index])
+        {
+            // reuse the transformed weight data
+            cret = layer->import_pipeline(pipeline_cache_data[layer_index], opt1);
+        }
+        else
+        {
+#if NCNN_STRING
+            NCNN_LOGE("pipeline cache record %d %s is created for other params or weights", layer_index, layer->name.c_str());
+#else
+            NCNN_LOGE("pipeline cache record %d is created for other params or weights", layer_index);
+#endif
+        }
+    }
+#endif // NCNN_STDIO
+    if (cret != 0)
+    {
+        cret = layer->create_pipeline(opt1);
+    }
+    if (cret != 0)
+    {
+#if NCNN_STRING
+        NCNN_LOGE("layer create_pipeline %d %s failed", layer_index, layer->name.c_str());
+#else
+        NCNN_LOGE("layer create_pipeline %d failed", layer_index);
+#endif
+        return -1;
+    }
+
+    return 0;
+}
+
+void NetPrivate::destroy_layer(Layer* layer)
+{
+    Option opt1 = get_masked_option(opt, layer->featmask);
+
+    int dret = layer->destroy_pipeline(opt1);
+    if (dret != 0)
+    {
+        NCNN_LOGE("layer destroy_pipeline failed");
+        // ignore anyway
+    }
+
+    if (layer->typeindex & ncnn::LayerType::CustomBit)
+    {
+        int custom_index = layer->typeindex & ~ncnn::LayerType::CustomBit;
+        if (custom_layer_registry[custom_index].destroyer)
         {
-            VkMat& bottom_top_blob = bottom_blob;
-            int ret = layer->forward_inplace(bottom_top_blob, cmd, opt);
-            if (ret != 0)
-                return ret;
-
-            // store top blob
-            blob_mats_gpu[top_blob_index] = bottom_top_blob;
+            custom_layer_registry[custom_index].destroyer(layer, custom_layer_registry[custom_index].userdata);
         }
         else
         {
-            VkMat top_blob;
-            int ret = layer->forward(bottom_blob, top_blob, cmd, opt);
-            if (ret != 0)
-                return ret;
-
-            // store top blob
-            blob_mats_gpu[top_blob_index] = top_blob;
-        }
-
-        if (opt.lightmode)
-        {
-            // delete after taken in light mode
-            blob_mats_gpu[bottom_blob_index].release();
+            delete layer;
         }
     }
     else
     {
-        // load bottom blobs
-        std::vector<VkMat> bottom_blobs(layer->bottoms.size());
-        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        // check overwrite builtin layer destroyer
+        int index = -1;
+        const size_t overwrite_builtin_layer_registry_entry_count = overwrite_builtin_layer_registry.size();
+        for (size_t i = 0; i < overwrite_builtin_layer_registry_entry_count; i++)
         {
-            int bottom_blob_index = layer->bottoms[i];
-
-            VkMat& bottom_blob_ref = blob_mats_gpu[bottom_blob_index];
-            bottom_blobs[i].release();
-
-            if (opt.lightmode)
-            {
-                // deep copy for inplace forward if data is shared
-                if (layer->support_inplace && *bottom_blob_ref.refcount != 1)
-                {
-                    cmd.record_clone(bottom_blob_ref, bottom_blobs[i], opt);
-                    //                         NCNN_LOGE("clone %p[+%lu] %p[+%lu]", bottom_blob_ref.buffer(), bottom_blob_ref.buffer_offset(), bottom_blobs[i].buffer(), bottom_blobs[i].buffer_offset());
-                }
-            }
-            if (bottom_blobs[i].dims == 0)
+            if (overwrite_builtin_layer_registry[i].typeindex == layer->typeindex)
             {
-                bottom_blobs[i] = bottom_blob_ref;
+                index = i;
+                break;
             }
         }
 
-        // forward
-        if (opt.lightmode && layer->support_inplace)
+        if (index != -1 && overwrite_builtin_layer_registry[index].destroyer)
         {
-            std::vector<VkMat>& bottom_top_blobs = bottom_blobs;
-            int ret = layer->forward_inplace(bottom_top_blobs, cmd, opt);
-            if (ret != 0)
-                return ret;
-
-            // store top blobs
-            for (size_t i = 0; i < layer->tops.size(); i++)
-            {
-                int top_blob_index = layer->tops[i];
-
-                blob_mats_gpu[top_blob_index] = bottom_top_blobs[i];
-            }
+            overwrite_builtin_layer_registry[index].destroyer(layer, overwrite_builtin_layer_registry[index].userdata);
         }
         else
         {
-            std::vector<VkMat> top_blobs(layer->tops.size());
-            int ret = layer->forward(bottom_blobs, top_blobs, cmd, opt);
-            if (ret != 0)
-                return ret;
-
-            // store top blobs
-            for (size_t i = 0; i < layer->tops.size(); i++)
-            {
-                int top_blob_index = layer->tops[i];
-
-                blob_mats_gpu[top_blob_index] = top_blobs[i];
-            }
+            delete layer;
         }
+    }
+}
 
-        if (opt.lightmode)
-        {
-            for (size_t i = 0; i < layer->bottoms.size(); i++)
-            {
-                int bottom_blob_index = layer->bottoms[i];
+// keeps the weights a layer loads, so that the numa replicas can load them again
+class ModelBinRecorder : public ModelBin
+{
+public:
+    ModelBinRecorder(const ModelBin& _mb, std::vector<Mat>& _weights)
+        : mb(_mb), weights(_weights)
+    {
+    }
 
-                // delete after taken in light mode
-                blob_mats_gpu[bottom_blob_index].release();
-            }
-        }
+    virtual Mat load(int w, int type) const
+    {
+        Mat m = mb.load(w, type);
+        weights.push_back(m);
+        return m;
     }
 
-    return 0;
+public:
+    const ModelBin& mb;
+    std::vector<Mat>& weights;
+};
+
+#if NCNN_STDIO
+static inline uint64_t hash_mix(uint64_t h, uint64_t k)
+{
+    h = (h ^ k) * 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 29);
 }
-#endif // NCNN_VULKAN
 
-void NetPrivate::update_input_output_indexes()
+// multiply-xorshift in four interleaved lanes to keep up with memory bandwidth
+static unsigned int hash_bytes(unsigned int seed, const void* data, size_t size)
 {
-    input_blob_indexes.clear();
-    output_blob_indexes.clear();
+    const unsigned char* p = (const unsigned char*)data;
+
+    uint64_t h0 = seed;
+    uint64_t h1 = seed + 1;
+    uint64_t h2 = seed + 2;
+    uint64_t h3 = seed + 3;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        uint64_t k[4];
+        memcpy(k, p + i, 32);
+        h0 = hash_mix(h0, k[0]);
+        h1 = hash_mix(h1, k[1]);
+        h2 = hash_mix(h2, k[2]);
+        h3 = hash_mix(h3, k[3]);
+    }
 
-    for (size_t i = 0; i < layers.size(); i++)
+    uint64_t h = hash_mix(hash_mix(hash_mix(h0, h1), h2), h3);
+    for (; i < size; i++)
     {
-        if (layers[i]->typeindex == LayerType::Input)
-        {
-            int blob_index = layers[i]->tops[0];
-            input_blob_indexes.push_back(blob_index);
-        }
+        h = hash_mix(h, p[i]);
     }
 
-    for (size_t i = 0; i < blobs.size(); i++)
+    h = hash_mix(h, size);
+    return (unsigned int)(h ^ (h >> 32));
+}
+
+static unsigned int hash_param(const ParamDict& pd)
+{
+    unsigned int h = 0;
+    for (int id = 0; id < NCNN_MAX_PARAM_COUNT; id++)
     {
-        if (blobs[i].producer != -1 && blobs[i].consumer == -1)
+        const int type = pd.type(id);
+        if (type == 0)
+            continue;
+
+        if (type == 1 || type == 2 || type == 3)
         {
-            output_blob_indexes.push_back(i);
+            // the raw bits of int or float
+            const int v[2] = {id, pd.get(id, 0)};
+            h = hash_bytes(h, v, sizeof(v));
+        }
+        if (type == 4 || type == 5 || type == 6)
+        {
+            const Mat v = pd.get(id, Mat());
+            h = hash_bytes(h + id, v.data, v.total() * v.elemsize);
+        }
+        if (type == 7)
+        {
+            const std::string str = pd.get(id, std::string());
+            h = hash_bytes(h + id, str.data(), str.size());
         }
     }
+
+    return h;
 }
 
-#if NCNN_STRING
-void NetPrivate::update_input_output_names()
+// hashes the weights a layer loads, so that the pipeline cache of another model is rejected
+class ModelBinHasher : public ModelBin
 {
-    input_blob_names.clear();
-    output_blob_names.clear();
+public:
+    ModelBinHasher(const ModelBin& _mb, unsigned int& _hash)
+        : mb(_mb), hash(_hash)
+    {
+    }
 
-    for (size_t i = 0; i < input_blob_indexes.size(); i++)
+    virtual Mat load(int w, int type) const
     {
-        int blob_index = input_blob_indexes[i];
-        input_blob_names.push_back(blobs[blob_index].name.c_str());
+        Mat m = mb.load(w, type);
+        hash = hash_bytes(hash, m.data, m.total() * m.elemsize);
+        return m;
     }
 
-    for (size_t i = 0; i < output_blob_indexes.size(); i++)
+public:
+    const ModelBin& mb;
+    unsigned int& hash;
+};
+#endif // NCNN_STDIO
+
+#if NCNN_THREADS
+// builds the layer replicas of one numa node on a thread bound to the node
+// the weights copied and transformed there are first touched by the node cpus and stay in its memory
+class NumaReplicaBuilder
+{
+public:
+    static void* run(void* args);
+
+public:
+    CpuSet thread_affinity_mask;
+    ThreadPool* thread_pool;
+    const std::vector<Layer*>* layers;
+    const std::vector<std::vector<Mat> >* weights;
+    const std::vector<Option>* layer_options;
+    int ret;
+};
+
+void* NumaReplicaBuilder::run(void* args)
+{
+    NumaReplicaBuilder* b = (NumaReplicaBuilder*)args;
+
+    set_current_thread_affinity(b->thread_affinity_mask);
+    set_current_thread_pool(b->thread_pool);
+
+    b->ret = 0;
+    for (size_t i = 0; i < b->layers->size(); i++)
     {
-        int blob_index = output_blob_indexes[i];
-        output_blob_names.push_back(blobs[blob_index].name.c_str());
+        Layer* layer = (*b->layers)[i];
+        if (!layer)
+            continue;
+
+        const std::vector<Mat>& weights = (*b->weights)[i];
+
+        std::vector<Mat> weights_local(weights.size());
+        for (size_t j = 0; j < weights.size(); j++)
+        {
+            weights_local[j] = weights[j].clone();
+        }
+
+        ModelBinFromMatArray mb(&weights_local[0]);
+        int lret = layer->load_model(mb);
+        if (lret == 0)
+        {
+            lret = layer->create_pipeline((*b->layer_options)[i]);
+        }
+        if (lret != 0)
+        {
+#if NCNN_STRING
+            NCNN_LOGE("numa replica %d %s failed", (int)i, layer->name.c_str());
+#else
+            NCNN_LOGE("numa replica %d failed", (int)i);
+#endif
+            b->ret = -1;
+            break;
+        }
     }
+
+    set_current_thread_pool(0);
+
+    return 0;
 }
-#endif // NCNN_STRING
+#endif // NCNN_THREADS
 
 Net::Net()
     : d(new NetPrivate(opt))
@@ -993,6 +2615,13 @@ int Net::load_param(const DataReader& dr)
     }
 
     d->layers.resize((size_t)layer_count);
+    d->numa_layer_params.clear();
+    if (opt.use_numa_replica)
+        d->numa_layer_params.resize(layer_count);
+#if NCNN_STDIO
+    d->layer_param_hashes.clear();
+    d->layer_param_hashes.resize(layer_count, 0);
+#endif // NCNN_STDIO
     d->blobs.resize((size_t)blob_count);
 
 #if NCNN_VULKAN
@@ -1240,11 +2869,22 @@ int Net::load_param(const DataReader& dr)
             layer = layer_cpu;
         }
 
+        if (opt.use_numa_replica)
+        {
+            // load the same params into the replicas later
+            d->numa_layer_params[i] = pd;
+        }
+
+#if NCNN_STDIO
+        d->layer_param_hashes[i] = hash_param(pd);
+#endif // NCNN_STDIO
+
         d->layers[i] = layer;
     }
 
     d->update_input_output_indexes();
     d->update_input_output_names();
+    d->update_branch_width();
 
 #undef SCAN_VALUE
     return 0;
@@ -1292,6 +2932,13 @@ int Net::load_param_bin(const DataReader& dr)
     }
 
     d->layers.resize(layer_count);
+    d->numa_layer_params.clear();
+    if (opt.use_numa_replica)
+        d->numa_layer_params.resize(layer_count);
+#if NCNN_STDIO
+    d->layer_param_hashes.clear();
+    d->layer_param_hashes.resize(layer_count, 0);
+#endif // NCNN_STDIO
     d->blobs.resize(blob_count);
 
 #if NCNN_VULKAN
@@ -1521,10 +3168,21 @@ int Net::load_param_bin(const DataReader& dr)
             layer = layer_cpu;
         }
 
+        if (opt.use_numa_replica)
+        {
+            // load the same params into the replicas later
+            d->numa_layer_params[i] = pd;
+        }
+
+#if NCNN_STDIO
+        d->layer_param_hashes[i] = hash_param(pd);
+#endif // NCNN_STDIO
+
         d->layers[i] = layer;
     }
 
     d->update_input_output_indexes();
+    d->update_branch_width();
 
 #undef READ_VALUE
     return 0;
@@ -1555,6 +3213,19 @@ int Net::load_model(const DataReader& dr)
     }
 #endif // NCNN_VULKAN
 
+#if NCNN_THREADS
+    const bool numa_replica = opt.use_numa_replica && !opt.use_vulkan_compute && get_numa_node_count() > 1 && (int)d->numa_layer_params.size() == layer_count;
+#else
+    const bool numa_replica = false;
+#endif // NCNN_THREADS
+
+    // the weights loaded by every layer, copied into the replicas before the layers transform them
+    std::vector<std::vector<Mat> > numa_weights(numa_replica ? layer_count : 0);
+
+#if NCNN_STDIO
+    d->layer_hashes.resize(layer_count, 0);
+#endif // NCNN_STDIO
+
     ModelBinFromDataReader mb(dr);
     for (int i = 0; i < layer_count; i++)
     {
@@ -1568,32 +3239,184 @@ int Net::load_model(const DataReader& dr)
             break;
         }
 
-        int lret = layer->load_model(mb);
-        if (lret != 0)
+#if NCNN_STDIO
+        d->layer_hashes[i] = i < (int)d->layer_param_hashes.size() ? d->layer_param_hashes[i] : 0;
+
+        ModelBinHasher mbh(mb, d->layer_hashes[i]);
+        const ModelBin& mb1 = mbh;
+#else
+        const ModelBin& mb1 = mb;
+#endif // NCNN_STDIO
+
+        int lret = 0;
+        if (numa_replica)
+        {
+            ModelBinRecorder mbr(mb1, numa_weights[i]);
+            lret = layer->load_model(mbr);
+        }
+        else
+        {
+            lret = layer->load_model(mb1);
+        }
+        if (lret != 0)
+        {
+#if NCNN_STRING
+            NCNN_LOGE("layer load_model %d %s failed", i, layer->name.c_str());
+#else
+            NCNN_LOGE("layer load_model %d failed", i);
+#endif
+            ret = -1;
+            break;
+        }
+
+        if (numa_replica)
+            continue;
+
+        if (d->create_layer_pipeline(i) != 0)
+        {
+            ret = -1;
+            break;
+        }
+    }
+
+#if NCNN_THREADS
+    if (ret == 0 && numa_replica)
+    {
+        const int node_count = get_numa_node_count();
+
+        std::vector<Option> layer_options(layer_count);
+        for (int i = 0; i < layer_count; i++)
+        {
+            layer_options[i] = d->get_layer_option(i);
+        }
+
+        d->numa_layers.resize(node_count);
+        d->numa_thread_pools.resize(node_count);
+        for (int j = 0; j < node_count; j++)
+        {
+            d->numa_thread_pools[j] = new ThreadPool(opt.num_threads, get_numa_node_cpu_mask(j));
+        }
+
+        // node 0 runs the layers themselves
+        d->numa_replica_size = 0;
+        for (int j = 1; j < node_count && ret == 0; j++)
+        {
+            d->numa_layers[j].resize(layer_count, 0);
+            for (int i = 0; i < layer_count; i++)
+            {
+                if (numa_weights[i].empty())
+                    continue;
+
+                const Layer* layer = d->layers[i];
+
+                Layer* replica = create_overwrite_builtin_layer(layer->typeindex);
+                if (!replica)
+                {
+                    replica = create_layer_cpu(layer->typeindex);
+                }
+                if (!replica)
+                {
+                    int custom_index = layer->typeindex & ~LayerType::CustomBit;
+                    replica = create_custom_layer(custom_index);
+                }
+                if (!replica)
+                {
+                    NCNN_LOGE("numa replica %d create failed", i);
+                    ret = -1;
+                    break;
+                }
+
+#if NCNN_STRING
+                replica->type = layer->type;
+                replica->name = layer->name;
+#endif // NCNN_STRING
+                replica->bottoms = layer->bottoms;
+                replica->tops = layer->tops;
+                replica->bottom_shapes = layer->bottom_shapes;
+                replica->top_shapes = layer->top_shapes;
+                replica->featmask = layer->featmask;
+
+                d->numa_layers[j][i] = replica;
+
+                if (replica->load_param(d->numa_layer_params[i]) != 0)
+                {
+                    NCNN_LOGE("numa replica %d load_param failed", i);
+                    ret = -1;
+                    break;
+                }
+
+                if (j == 1)
+                {
+                    for (size_t k = 0; k < numa_weights[i].size(); k++)
+                    {
+                        d->numa_replica_size += numa_weights[i][k].total() * numa_weights[i][k].elemsize;
+                    }
+                }
+            }
+        }
+
+        if (ret == 0)
+        {
+            std::vector<NumaReplicaBuilder> builders(node_count);
+            std::vector<Thread*> threads(node_count, 0);
+            for (int j = 1; j < node_count; j++)
+            {
+                builders[j].thread_affinity_mask = get_numa_node_cpu_mask(j);
+                builders[j].thread_pool = d->numa_thread_pools[j];
+                builders[j].layers = &d->numa_layers[j];
+                builders[j].weights = &numa_weights;
+                builders[j].layer_options = &layer_options;
+                builders[j].ret = 0;
+
+                threads[j] = new Thread(NumaReplicaBuilder::run, &builders[j]);
+            }
+            for (int j = 1; j < node_count; j++)
+            {
+                threads[j]->join();
+                delete threads[j];
+
+                if (builders[j].ret != 0)
+                    ret = -1;
+            }
+        }
+
+        // the replicas hold their own copies, the layers may transform the weights now
+        numa_weights.clear();
+
+        for (int i = 0; i < layer_count && ret == 0; i++)
         {
-#if NCNN_STRING
-            NCNN_LOGE("layer load_model %d %s failed", i, layer->name.c_str());
-#else
-            NCNN_LOGE("layer load_model %d failed", i);
-#endif
-            ret = -1;
-            break;
+            if (d->create_layer_pipeline(i) != 0)
+                ret = -1;
         }
 
-        Option opt1 = get_masked_option(opt, layer->featmask);
-
-        int cret = layer->create_pipeline(opt1);
-        if (cret != 0)
+        if (opt.use_local_pool_allocator)
         {
-#if NCNN_STRING
-            NCNN_LOGE("layer create_pipeline %d %s failed", i, layer->name.c_str());
-#else
-            NCNN_LOGE("layer create_pipeline %d failed", i);
-#endif
-            ret = -1;
-            break;
+            d->numa_blob_allocators.resize(node_count, 0);
+            d->numa_workspace_allocators.resize(node_count, 0);
+            for (int j = 0; j < node_count; j++)
+            {
+                if (opt.blob_allocator == 0)
+                {
+                    d->numa_blob_allocators[j] = new PoolAllocator;
+                    d->numa_blob_allocators[j]->set_size_compare_ratio(0.f);
+                }
+                if (opt.workspace_allocator == 0)
+                {
+                    d->numa_workspace_allocators[j] = new PoolAllocator;
+                    d->numa_workspace_allocators[j]->set_size_compare_ratio(0.f);
+                }
+            }
         }
     }
+#endif // NCNN_THREADS
+
+    d->numa_layer_params.clear();
+
+#if NCNN_STDIO
+    // the layers hold the references now
+    d->pipeline_cache_data.clear();
+    d->pipeline_cache_hashes.clear();
+#endif // NCNN_STDIO
 
     if (opt.use_local_pool_allocator)
     {
@@ -1615,6 +3438,17 @@ int Net::load_model(const DataReader& dr)
         }
     }
 
+#if NCNN_THREADS
+    if (opt.use_branch_parallel)
+    {
+        const int helper_count = std::min(opt.num_threads, d->branch_width) - 1;
+        if (helper_count > 0 && !d->branch_worker_pool)
+        {
+            d->branch_worker_pool = new BranchWorkerPool(helper_count);
+        }
+    }
+#endif // NCNN_THREADS
+
 #if NCNN_VULKAN
     if (ret == 0 && opt.use_vulkan_compute)
     {
@@ -1694,6 +3528,427 @@ int Net::load_model(const char* modelpath)
     fclose(fp);
     return ret;
 }
+
+int Net::load_model_mmap(const char* modelpath)
+{
+    if (d->model_mmap)
+    {
+        NCNN_LOGE("model already mapped, clear the net before loading again");
+        return -1;
+    }
+
+    DataReaderFromMmap* dr = new DataReaderFromMmap(modelpath);
+    if (dr->empty())
+    {
+        delete dr;
+        return -1;
+    }
+
+    int ret = load_model(*dr);
+
+    // keep the mapping even on failure, loaded layers may reference it already
+    d->model_mmap = dr;
+
+    return ret;
+}
+
+// pipeline cache file layout
+//   header   [magic] [cpu isa bits] [l2 cache size] [l3 cache size] [layer count]
+//   record   [layer index] [layer typeindex] [option bits] [num_threads] [layer hash] [mat count]
+//   mat      [dims] [w] [h] [d] [c] [elemsize] [elempack] [cstep] [padding size] [padding] [data]
+//   the record list ends with layer index -1, mat data is 64-byte aligned
+static const int PIPELINE_CACHE_MAGIC = 0x0050434e; // NCP
+
+static int get_pipeline_cache_cpu_bits()
+{
+    // the isa levels that may change the weight data layout
+    int bits = 0;
+    bits |= cpu_support_x86_avx() << 0;
+    bits |= cpu_support_x86_fma() << 1;
+    bits |= cpu_support_x86_xop() << 2;
+    bits |= cpu_support_x86_f16c() << 3;
+    bits |= cpu_support_x86_avx2() << 4;
+    bits |= cpu_support_x86_avx_vnni() << 5;
+    bits |= cpu_support_x86_avx_vnni_int8() << 6;
+    bits |= cpu_support_x86_avx_vnni_int16() << 7;
+    bits |= cpu_support_x86_avx_ne_convert() << 8;
+    bits |= cpu_support_x86_avx512() << 9;
+    bits |= cpu_support_x86_avx512_vnni() << 10;
+    bits |= cpu_support_x86_avx512_bf16() << 11;
+    bits |= cpu_support_x86_avx512_fp16() << 12;
+    bits |= cpu_support_arm_neon() << 13;
+    bits |= cpu_support_arm_vfpv4() << 14;
+    bits |= cpu_support_arm_asimdhp() << 15;
+    bits |= cpu_support_arm_asimddp() << 16;
+    bits |= cpu_support_arm_asimdfhm() << 17;
+    bits |= cpu_support_arm_bf16() << 18;
+    bits |= cpu_support_arm_i8mm() << 19;
+    bits |= cpu_support_arm_sve() << 20;
+    bits |= cpu_support_arm_sve2() << 21;
+    bits |= cpu_support_loongarch_lsx() << 22;
+    bits |= cpu_support_loongarch_lasx() << 23;
+    bits |= cpu_support_mips_msa() << 24;
+    bits |= cpu_support_loongson_mmi() << 25;
+    bits |= cpu_support_riscv_v() << 26;
+    bits |= cpu_support_riscv_zfh() << 27;
+    bits |= cpu_support_riscv_zvfh() << 28;
+    bits |= cpu_support_riscv_xtheadvector() << 29;
+    return bits;
+}
+
+static int get_pipeline_cache_option_bits(const Option& opt)
+{
+    // the options that may change the weight data transform
+    int bits = 0;
+    bits |= opt.use_winograd_convolution << 0;
+    bits |= opt.use_sgemm_convolution << 1;
+    bits |= opt.use_int8_inference << 2;
+    bits |= opt.use_vulkan_compute << 3;
+    bits |= opt.use_bf16_storage << 4;
+    bits |= opt.use_fp16_packed << 5;
+    bits |= opt.use_fp16_storage << 6;
+    bits |= opt.use_fp16_arithmetic << 7;
+    bits |= opt.use_int8_packed << 8;
+    bits |= opt.use_int8_storage << 9;
+    bits |= opt.use_int8_arithmetic << 10;
+    bits |= opt.use_packing_layout << 11;
+    bits |= opt.use_winograd23_convolution << 12;
+    bits |= opt.use_winograd43_convolution << 13;
+    bits |= opt.use_winograd63_convolution << 14;
+    bits |= opt.use_a53_a55_optimized_kernel << 15;
+    bits |= opt.use_sparse_weight << 16;
+    return bits;
+}
+
+int Net::load_pipeline_cache(const char* cachepath)
+{
+    if (d->layers.empty())
+    {
+        NCNN_LOGE("network graph not ready");
+        return -1;
+    }
+
+    if (d->pipeline_cache_mmap)
+    {
+        NCNN_LOGE("pipeline cache already mapped, clear the net before loading again");
+        return -1;
+    }
+
+    DataReaderFromMmap* dr = new DataReaderFromMmap(cachepath);
+    if (dr->empty())
+    {
+        delete dr;
+        return -1;
+    }
+
+    const int layer_count = (int)d->layers.size();
+
+    int header[5];
+    if (dr->read(header, sizeof(header)) != sizeof(header) || header[0] != PIPELINE_CACHE_MAGIC)
+    {
+        NCNN_LOGE("invalid pipeline cache %s", cachepath);
+        delete dr;
+        return -1;
+    }
+
+    if (header[1] != get_pipeline_cache_cpu_bits() || header[2] != get_cpu_level2_cache_size() || header[3] != get_cpu_level3_cache_size() || header[4] != layer_count)
+    {
+        NCNN_LOGE("pipeline cache %s is created for another cpu or network", cachepath);
+        delete dr;
+        return -1;
+    }
+
+    std::vector<std::vector<Mat> > pipeline_cache_data(layer_count);
+    std::vector<unsigned int> pipeline_cache_hashes(layer_count, 0);
+
+    for (;;)
+    {
+        int record[6];
+        if (dr->read(record, sizeof(record)) != sizeof(record))
+        {
+            NCNN_LOGE("read pipeline cache record failed");
+            delete dr;
+            return -1;
+        }
+
+        const int layer_index = record[0];
+        if (layer_index == -1)
+            break;
+
+        if (layer_index < 0 || layer_index >= layer_count || record[5] < 0)
+        {
+            NCNN_LOGE("invalid pipeline cache record %d", layer_index);
+            delete dr;
+            return -1;
+        }
+
+        std::vector<Mat> pipeline_data(record[5]);
+        for (int j = 0; j < record[5]; j++)
+        {
+            int mat_header[9];
+            if (dr->read(mat_header, sizeof(mat_header)) != sizeof(mat_header))
+            {
+                NCNN_LOGE("read pipeline cache mat failed");
+                delete dr;
+                return -1;
+            }
+
+            const int dims = mat_header[0];
+            const int w = mat_header[1];
+            const int h = mat_header[2];
+            const int _d = mat_header[3];
+            const int c = mat_header[4];
+            const size_t elemsize = mat_header[5];
+            const int elempack = mat_header[6];
+            const size_t cstep = mat_header[7];
+            const size_t padding = mat_header[8];
+
+            const void* padding_data = 0;
+            if (padding > 0 && dr->reference(padding, &padding_data) != padding)
+            {
+                NCNN_LOGE("read pipeline cache mat failed");
+                delete dr;
+                return -1;
+            }
+
+            if (dims == 0)
+                continue;
+
+            const size_t size = cstep * c * elemsize;
+
+            const void* data = 0;
+            if (dr->reference(size, &data) != size)
+            {
+                NCNN_LOGE("read pipeline cache mat failed");
+                delete dr;
+                return -1;
+            }
+
+            Mat m;
+            if (dims == 1)
+                m = Mat(w, (void*)data, elemsize, elempack);
+            if (dims == 2)
+                m = Mat(w, h, (void*)data, elemsize, elempack);
+            if (dims == 3)
+                m = Mat(w, h, c, (void*)data, elemsize, elempack);
+            if (dims == 4)
+                m = Mat(w, h, _d, c, (void*)data, elemsize, elempack);
+            m.cstep = cstep;
+
+            pipeline_data[j] = m;
+        }
+
+        // skip the stale record whose layer type or option changed
+        const Layer* layer = d->layers[layer_index];
+        if (!layer || layer->typeindex != record[1])
+            continue;
+
+        const Option opt1 = d->get_layer_option(layer_index);
+        if (get_pipeline_cache_option_bits(opt1) != record[2] || opt1.num_threads != record[3])
+            continue;
+
+        // the layer hash is known after load_model, compared in create_pipeline
+        pipeline_cache_data[layer_index] = pipeline_data;
+        pipeline_cache_hashes[layer_index] = (unsigned int)record[4];
+    }
+
+    d->pipeline_cache_mmap = dr;
+    d->pipeline_cache_data = pipeline_cache_data;
+    d->pipeline_cache_hashes = pipeline_cache_hashes;
+
+    return 0;
+}
+
+int Net::save_pipeline_cache(const char* cachepath) const
+{
+    if (d->layers.empty())
+    {
+        NCNN_LOGE("network graph not ready");
+        return -1;
+    }
+
+    FILE* fp = fopen(cachepath, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", cachepath);
+        return -1;
+    }
+
+    const int layer_count = (int)d->layers.size();
+
+    int header[5];
+    header[0] = PIPELINE_CACHE_MAGIC;
+    header[1] = get_pipeline_cache_cpu_bits();
+    header[2] = get_cpu_level2_cache_size();
+    header[3] = get_cpu_level3_cache_size();
+    header[4] = layer_count;
+
+    size_t offset = fwrite(header, 1, sizeof(header), fp);
+
+    const unsigned char zeros[64] = {0};
+
+    for (int i = 0; i < layer_count; i++)
+    {
+        const Layer* layer = d->layers[i];
+        if (!layer)
+            continue;
+
+        std::vector<Mat> pipeline_data;
+        if (layer->export_pipeline(pipeline_data) != 0)
+            continue;
+
+        const Option opt1 = d->get_layer_option(i);
+
+        int record[6];
+        record[0] = i;
+        record[1] = layer->typeindex;
+        record[2] = get_pipeline_cache_option_bits(opt1);
+        record[3] = opt1.num_threads;
+        record[4] = i < (int)d->layer_hashes.size() ? (int)d->layer_hashes[i] : 0;
+        record[5] = (int)pipeline_data.size();
+
+        offset += fwrite(record, 1, sizeof(record), fp);
+
+        for (size_t j = 0; j < pipeline_data.size(); j++)
+        {
+            const Mat& m = pipeline_data[j];
+
+            const size_t padding = alignSize(offset + sizeof(int) * 9, 64) - (offset + sizeof(int) * 9);
+
+            int mat_header[9];
+            mat_header[0] = m.dims;
+            mat_header[1] = m.w;
+            mat_header[2] = m.h;
+            mat_header[3] = m.d;
+            mat_header[4] = m.c;
+            mat_header[5] = (int)m.elemsize;
+            mat_header[6] = m.elempack;
+            mat_header[7] = (int)m.cstep;
+            mat_header[8] = (int)padding;
+
+            offset += fwrite(mat_header, 1, sizeof(mat_header), fp);
+            offset += fwrite(zeros, 1, padding, fp);
+
+            if (m.dims == 0)
+                continue;
+
+            offset += fwrite(m.data, 1, m.cstep * m.c * m.elemsize, fp);
+        }
+    }
+
+    int end_record[6] = {-1, 0, 0, 0, 0, 0};
+    fwrite(end_record, 1, sizeof(end_record), fp);
+
+    int ret = ferror(fp) ? -1 : 0;
+    if (ret != 0)
+    {
+        NCNN_LOGE("fwrite %s failed", cachepath);
+    }
+
+    fclose(fp);
+
+    return ret;
+}
+
+// tuning file layout
+//   header   ncnn_tuning [layer count]
+//   record   [layer index] [layer typeindex] [featmask] [layer name]
+//   featmask bits outside of the algorithm selection are ignored
+static const int TUNING_FEATMASK = (1 << 5) | (1 << 6) | (1 << 8) | (1 << 9) | (1 << 10);
+
+int Net::load_tuning(const char* tunepath)
+{
+    if (d->layers.empty())
+    {
+        NCNN_LOGE("load_tuning must be called after load_param");
+        return -1;
+    }
+
+    FILE* fp = fopen(tunepath, "rb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", tunepath);
+        return -1;
+    }
+
+    int layer_count = 0;
+    int nscan = fscanf(fp, "ncnn_tuning %d", &layer_count);
+    if (nscan != 1 || layer_count != (int)d->layers.size())
+    {
+        NCNN_LOGE("tuning file %s does not match the network", tunepath);
+        fclose(fp);
+        return -1;
+    }
+
+    for (;;)
+    {
+        int layer_index = 0;
+        int typeindex = 0;
+        int featmask = 0;
+        nscan = fscanf(fp, "%d %d %d%*[^\n]", &layer_index, &typeindex, &featmask);
+        if (nscan != 3)
+            break;
+
+        if (layer_index < 0 || layer_index >= (int)d->layers.size())
+            continue;
+
+        Layer* layer = d->layers[layer_index];
+        if (layer->typeindex != typeindex)
+        {
+            NCNN_LOGE("tuning record for layer %d has mismatched type, skipped", layer_index);
+            continue;
+        }
+
+        layer->featmask |= featmask & TUNING_FEATMASK;
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+
+int Net::save_tuning(const char* tunepath) const
+{
+    if (d->layers.empty())
+    {
+        NCNN_LOGE("network graph not ready");
+        return -1;
+    }
+
+    FILE* fp = fopen(tunepath, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", tunepath);
+        return -1;
+    }
+
+    fprintf(fp, "ncnn_tuning %d\n", (int)d->layers.size());
+
+    for (size_t i = 0; i < d->layers.size(); i++)
+    {
+        const Layer* layer = d->layers[i];
+
+        const int featmask = layer->featmask & TUNING_FEATMASK;
+        if (featmask == 0)
+            continue;
+
+#if NCNN_STRING
+        fprintf(fp, "%d %d %d %s\n", (int)i, layer->typeindex, featmask, layer->name.c_str());
+#else
+        fprintf(fp, "%d %d %d\n", (int)i, layer->typeindex, featmask);
+#endif
+    }
+
+    int ret = ferror(fp) ? -1 : 0;
+    if (ret != 0)
+    {
+        NCNN_LOGE("fprintf %s failed", tunepath);
+    }
+
+    fclose(fp);
+
+    return ret;
+}
 #endif // NCNN_STDIO
 
 int Net::load_param(const unsigned char* _mem)
@@ -1778,59 +4033,41 @@ int Net::load_model(AAssetManager* mgr, const char* assetpath)
 #endif // __ANDROID_API__ >= 9
 #endif // NCNN_PLATFORM_API
 
-void Net::clear()
-{
-    d->blobs.clear();
-    for (size_t i = 0; i < d->layers.size(); i++)
-    {
-        Layer* layer = d->layers[i];
-
-        Option opt1 = get_masked_option(opt, layer->featmask);
-
-        int dret = layer->destroy_pipeline(opt1);
-        if (dret != 0)
-        {
-            NCNN_LOGE("layer destroy_pipeline failed");
-            // ignore anyway
-        }
-
-        if (layer->typeindex & ncnn::LayerType::CustomBit)
-        {
-            int custom_index = layer->typeindex & ~ncnn::LayerType::CustomBit;
-            if (d->custom_layer_registry[custom_index].destroyer)
-            {
-                d->custom_layer_registry[custom_index].destroyer(layer, d->custom_layer_registry[custom_index].userdata);
-            }
-            else
-            {
-                delete layer;
-            }
-        }
-        else
-        {
-            // check overwrite builtin layer destroyer
-            int index = -1;
-            const size_t overwrite_builtin_layer_registry_entry_count = d->overwrite_builtin_layer_registry.size();
-            for (size_t i = 0; i < overwrite_builtin_layer_registry_entry_count; i++)
-            {
-                if (d->overwrite_builtin_layer_registry[i].typeindex == layer->typeindex)
-                {
-                    index = i;
-                    break;
-                }
-            }
+void Net::clear()
+{
+    d->blobs.clear();
+    for (size_t i = 0; i < d->layers.size(); i++)
+    {
+        d->destroy_layer(d->layers[i]);
+    }
+    d->layers.clear();
 
-            if (index != -1 && d->overwrite_builtin_layer_registry[index].destroyer)
-            {
-                d->overwrite_builtin_layer_registry[index].destroyer(layer, d->overwrite_builtin_layer_registry[index].userdata);
-            }
-            else
-            {
-                delete layer;
-            }
+    for (size_t i = 0; i < d->numa_layers.size(); i++)
+    {
+        for (size_t j = 0; j < d->numa_layers[i].size(); j++)
+        {
+            if (d->numa_layers[i][j])
+                d->destroy_layer(d->numa_layers[i][j]);
         }
     }
-    d->layers.clear();
+    d->numa_layers.clear();
+    d->numa_layer_params.clear();
+    d->numa_replica_size = 0;
+    d->numa_next_node = 0;
+
+    for (size_t i = 0; i < d->numa_thread_pools.size(); i++)
+    {
+        delete d->numa_thread_pools[i];
+    }
+    d->numa_thread_pools.clear();
+
+    for (size_t i = 0; i < d->numa_blob_allocators.size(); i++)
+    {
+        delete d->numa_blob_allocators[i];
+        delete d->numa_workspace_allocators[i];
+    }
+    d->numa_blob_allocators.clear();
+    d->numa_workspace_allocators.clear();
 
     if (d->local_blob_allocator)
     {
@@ -1843,6 +4080,39 @@ void Net::clear()
         d->local_workspace_allocator = 0;
     }
 
+#if NCNN_THREADS
+    if (d->branch_worker_pool)
+    {
+        delete d->branch_worker_pool;
+        d->branch_worker_pool = 0;
+    }
+#endif // NCNN_THREADS
+
+    for (size_t i = 0; i < d->blob_arena_plans.size(); i++)
+    {
+        delete d->blob_arena_plans[i];
+    }
+    d->blob_arena_plans.clear();
+
+#if NCNN_STDIO
+    // unmap after all the layers referencing weights are gone
+    if (d->model_mmap)
+    {
+        delete d->model_mmap;
+        d->model_mmap = 0;
+    }
+
+    d->pipeline_cache_data.clear();
+    d->pipeline_cache_hashes.clear();
+    d->layer_param_hashes.clear();
+    d->layer_hashes.clear();
+    if (d->pipeline_cache_mmap)
+    {
+        delete d->pipeline_cache_mmap;
+        d->pipeline_cache_mmap = 0;
+    }
+#endif // NCNN_STDIO
+
 #if NCNN_VULKAN
     if (d->weight_vkallocator)
     {
@@ -1865,7 +4135,21 @@ void Net::clear()
 
 Extractor Net::create_extractor() const
 {
-    return Extractor(this, d->blobs.size());
+    Extractor ex(this, d->blobs.size());
+
+    if (!d->numa_thread_pools.empty())
+    {
+        // spread extractors over the numa nodes
+        unsigned int node = (unsigned int)NCNN_XADD(&d->numa_next_node, 1);
+        ex.set_numa_node((int)(node % d->numa_thread_pools.size()));
+    }
+
+    return ex;
+}
+
+size_t Net::numa_replica_size() const
+{
+    return d->numa_replica_size;
 }
 
 const std::vector<int>& Net::input_indexes() const
@@ -2042,6 +4326,27 @@ public:
     std::vector<Mat> blob_mats;
     Option opt;
 
+    // arenas of the forward passes, alive until the blobs inside are released
+    std::vector<BlobArenaAllocator*> blob_arenas;
+
+    // per-sample and stacked blobs of batch inference
+    int batch_size;
+    std::vector<std::vector<Mat> > batch_blob_mats;
+    std::vector<Mat> batch_stacked_mats;
+
+    Profiler* profiler;
+
+    // the numa node bound by set_numa_node, -1 for none
+    int numa_node;
+
+    // the private pool of set_thread_pool or the numa node, null for the shared openmp team
+    ThreadPool* thread_pool;
+
+    // per-layer context kept between the chunks of a stream
+    bool streaming;
+    bool streaming_chunk_done;
+    std::vector<std::vector<Mat> > streaming_states;
+
 #if NCNN_VULKAN
     VkAllocator* local_blob_vkallocator;
     VkAllocator* local_staging_vkallocator;
@@ -2055,6 +4360,12 @@ Extractor::Extractor(const Net* _net, size_t blob_count)
 {
     d->blob_mats.resize(blob_count);
     d->opt = d->net->opt;
+    d->batch_size = 0;
+    d->profiler = 0;
+    d->numa_node = -1;
+    d->thread_pool = 0;
+    d->streaming = false;
+    d->streaming_chunk_done = false;
 
 #if NCNN_VULKAN
     if (d->net->opt.use_vulkan_compute)
@@ -2080,6 +4391,15 @@ Extractor::Extractor(const Extractor& rhs)
     d->net = rhs.d->net;
     d->blob_mats = rhs.d->blob_mats;
     d->opt = rhs.d->opt;
+    d->batch_size = rhs.d->batch_size;
+    d->batch_blob_mats = rhs.d->batch_blob_mats;
+    d->batch_stacked_mats = rhs.d->batch_stacked_mats;
+    d->profiler = rhs.d->profiler;
+    d->numa_node = rhs.d->numa_node;
+    d->thread_pool = rhs.d->thread_pool;
+    d->streaming = rhs.d->streaming;
+    d->streaming_chunk_done = rhs.d->streaming_chunk_done;
+    d->streaming_states = rhs.d->streaming_states;
 
 #if NCNN_VULKAN
     d->local_blob_vkallocator = 0;
@@ -2097,6 +4417,21 @@ Extractor& Extractor::operator=(const Extractor& rhs)
     d->net = rhs.d->net;
     d->blob_mats = rhs.d->blob_mats;
     d->opt = rhs.d->opt;
+    d->batch_size = rhs.d->batch_size;
+    d->batch_blob_mats = rhs.d->batch_blob_mats;
+    d->batch_stacked_mats = rhs.d->batch_stacked_mats;
+    d->profiler = rhs.d->profiler;
+    d->numa_node = rhs.d->numa_node;
+    d->thread_pool = rhs.d->thread_pool;
+    d->streaming = rhs.d->streaming;
+    d->streaming_chunk_done = rhs.d->streaming_chunk_done;
+    d->streaming_states = rhs.d->streaming_states;
+
+    for (size_t i = 0; i < d->blob_arenas.size(); i++)
+    {
+        d->blob_arenas[i]->release();
+    }
+    d->blob_arenas.clear();
 
 #if NCNN_VULKAN
     d->local_blob_vkallocator = 0;
@@ -2112,6 +4447,19 @@ void Extractor::clear()
 {
     d->blob_mats.clear();
 
+    d->streaming_chunk_done = false;
+    d->streaming_states.clear();
+
+    d->batch_size = 0;
+    d->batch_blob_mats.clear();
+    d->batch_stacked_mats.clear();
+
+    for (size_t i = 0; i < d->blob_arenas.size(); i++)
+    {
+        d->blob_arenas[i]->release();
+    }
+    d->blob_arenas.clear();
+
 #if NCNN_VULKAN
     if (d->opt.use_vulkan_compute)
     {
@@ -2152,6 +4500,58 @@ void Extractor::set_workspace_allocator(Allocator* allocator)
     d->opt.workspace_allocator = allocator;
 }
 
+void Extractor::set_thread_pool(ThreadPool* thread_pool)
+{
+    d->thread_pool = thread_pool;
+}
+
+void Extractor::set_profiler(Profiler* profiler)
+{
+    d->profiler = profiler;
+}
+
+void Extractor::set_numa_node(int node)
+{
+    const NetPrivate* net = d->net->d;
+    if (node < 0 || node >= (int)net->numa_thread_pools.size())
+    {
+        NCNN_LOGE("numa node %d has no replica", node);
+        return;
+    }
+
+    d->numa_node = node;
+    d->thread_pool = net->numa_thread_pools[node];
+    if (!net->numa_blob_allocators.empty() && net->numa_blob_allocators[node])
+    {
+        d->opt.blob_allocator = net->numa_blob_allocators[node];
+    }
+    if (!net->numa_workspace_allocators.empty() && net->numa_workspace_allocators[node])
+    {
+        d->opt.workspace_allocator = net->numa_workspace_allocators[node];
+    }
+}
+
+size_t Extractor::blob_arena_size() const
+{
+    size_t size = 0;
+    for (size_t i = 0; i < d->blob_arenas.size(); i++)
+    {
+        size += d->blob_arenas[i]->arena_size();
+    }
+
+    return size;
+}
+
+void Extractor::set_streaming(bool enable)
+{
+    d->streaming = enable;
+}
+
+void Extractor::reset_streaming()
+{
+    d->streaming_states.clear();
+}
+
 #if NCNN_VULKAN
 void Extractor::set_vulkan_compute(bool enable)
 {
@@ -2218,6 +4618,17 @@ int Extractor::input(int blob_index, const Mat& in)
     if (blob_index < 0 || blob_index >= (int)d->blob_mats.size())
         return -1;
 
+    if (d->streaming && d->streaming_chunk_done)
+    {
+        // start the next chunk
+        for (size_t i = 0; i < d->blob_mats.size(); i++)
+        {
+            d->blob_mats[i].release();
+        }
+
+        d->streaming_chunk_done = false;
+    }
+
     d->blob_mats[blob_index] = in;
 
     return 0;
@@ -2228,12 +4639,49 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
     if (blob_index < 0 || blob_index >= (int)d->blob_mats.size())
         return -1;
 
+    if (d->streaming && d->streaming_states.empty())
+    {
+        // checked at the start of each stream
+        int layer_index = find_non_streaming_layer(d->net, blob_index);
+        if (layer_index != -1)
+        {
+#if NCNN_STRING
+            const Layer* layer = d->net->layers()[layer_index];
+            NCNN_LOGE("layer %d %s %s does not support streaming", layer_index, layer->type.c_str(), layer->name.c_str());
+#else
+            NCNN_LOGE("layer %d does not support streaming", layer_index);
+#endif
+            return -1;
+        }
+    }
+
     int old_blocktime = get_kmp_blocktime();
     set_kmp_blocktime(d->opt.openmp_blocktime);
 
     int old_flush_denormals = get_flush_denormals();
     set_flush_denormals(d->opt.flush_denormals);
 
+    int old_work_stealing = get_kmp_work_stealing();
+    set_kmp_work_stealing(d->opt.use_work_stealing);
+
+    Profiler* old_profiler = get_current_profiler();
+    set_current_profiler(d->profiler);
+
+    ThreadPool* old_thread_pool = get_current_thread_pool();
+    if (d->thread_pool)
+        set_current_thread_pool(d->thread_pool);
+
+    const std::vector<Layer*>* old_numa_layers = get_current_numa_layers();
+    set_current_numa_layers(d->numa_node > 0 ? &d->net->d->numa_layers[d->numa_node] : 0);
+
+    std::vector<std::vector<Mat> >* old_streaming_states = get_current_streaming_states();
+    if (d->streaming)
+    {
+        d->streaming_states.resize(d->net->layers().size());
+        d->streaming_chunk_done = true;
+    }
+    set_current_streaming_states(d->streaming ? &d->streaming_states : 0);
+
     int ret = 0;
 
     if (d->blob_mats[blob_index].dims == 0)
@@ -2302,15 +4750,53 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
 #endif // NCNN_BENCHMARK
             }
         }
+        else if (d->opt.use_branch_parallel)
+        {
+            ret = d->net->d->forward_layer_branch_parallel(layer_index, d->blob_mats, d->opt);
+        }
+        else if (d->opt.use_blob_arena)
+        {
+            BlobArenaAllocator* blob_arena = d->net->d->create_blob_arena(d->blob_mats, blob_index, d->opt);
+
+            Option opt = d->opt;
+            opt.blob_allocator = blob_arena;
+            ret = d->net->d->forward_layer(layer_index, d->blob_mats, opt);
+
+            d->net->d->update_blob_arena_plan(blob_arena);
+            d->blob_arenas.push_back(blob_arena);
+        }
         else
         {
             ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
         }
 #else
-        ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
+        if (d->opt.use_branch_parallel)
+        {
+            ret = d->net->d->forward_layer_branch_parallel(layer_index, d->blob_mats, d->opt);
+        }
+        else if (d->opt.use_blob_arena)
+        {
+            BlobArenaAllocator* blob_arena = d->net->d->create_blob_arena(d->blob_mats, blob_index, d->opt);
+
+            Option opt = d->opt;
+            opt.blob_allocator = blob_arena;
+            ret = d->net->d->forward_layer(layer_index, d->blob_mats, opt);
+
+            d->net->d->update_blob_arena_plan(blob_arena);
+            d->blob_arenas.push_back(blob_arena);
+        }
+        else
+        {
+            ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
+        }
 #endif // NCNN_VULKAN
     }
 
+    set_current_profiler(old_profiler);
+    set_current_thread_pool(old_thread_pool);
+    set_current_numa_layers(old_numa_layers);
+    set_current_streaming_states(old_streaming_states);
+
     feat = d->blob_mats[blob_index];
 
     // empty is valid for outputs
@@ -2386,7 +4872,8 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
         if (feat.empty())
             return -100;
 
-        if (d->opt.use_local_pool_allocator && feat.allocator == d->net->d->local_blob_allocator)
+        const bool numa_local = d->numa_node >= 0 && !d->net->d->numa_blob_allocators.empty() && feat.allocator == d->net->d->numa_blob_allocators[d->numa_node];
+        if (d->opt.use_local_pool_allocator && (feat.allocator == d->net->d->local_blob_allocator || numa_local))
         {
             // detach the returned mat from local pool allocator
             // so we could destroy net instance much earlier
@@ -2394,14 +4881,216 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
             if (feat.empty())
                 return -100;
         }
+
+        for (size_t i = 0; i < d->blob_arenas.size(); i++)
+        {
+            if (feat.allocator == d->blob_arenas[i])
+            {
+                // arena memory is reused by the next forward pass
+                feat = feat.clone();
+                if (feat.empty())
+                    return -100;
+                break;
+            }
+        }
     }
 
     set_kmp_blocktime(old_blocktime);
     set_flush_denormals(old_flush_denormals);
+    set_kmp_work_stealing(old_work_stealing);
 
     return ret;
 }
 
+#if NCNN_STRING
+int Extractor::input_batch(const char* blob_name, const std::vector<Mat>& ins)
+{
+    int blob_index = d->net->find_blob_index_by_name(blob_name);
+    if (blob_index == -1)
+    {
+        NCNN_LOGE("Try");
+        const std::vector<const char*>& input_names = d->net->input_names();
+        for (size_t i = 0; i < input_names.size(); i++)
+        {
+            NCNN_LOGE("    ex.input_batch(\"%s\", ins%d);", input_names[i], (int)i);
+        }
+
+        return -1;
+    }
+
+    return input_batch(blob_index, ins);
+}
+
+int Extractor::extract_batch(const char* blob_name, std::vector<Mat>& feats, int type)
+{
+    int blob_index = d->net->find_blob_index_by_name(blob_name);
+    if (blob_index == -1)
+    {
+        NCNN_LOGE("Try");
+        const std::vector<const char*>& output_names = d->net->output_names();
+        for (size_t i = 0; i < output_names.size(); i++)
+        {
+            NCNN_LOGE("    ex.extract_batch(\"%s\", outs%d);", output_names[i], (int)i);
+        }
+
+        return -1;
+    }
+
+    return extract_batch(blob_index, feats, type);
+}
+#endif // NCNN_STRING
+
+int Extractor::input_batch(int blob_index, const std::vector<Mat>& ins)
+{
+    if (blob_index < 0 || blob_index >= (int)d->blob_mats.size())
+        return -1;
+
+    if (ins.empty())
+        return -1;
+
+    const int batch = (int)ins.size();
+
+    if (d->batch_size != 0 && d->batch_size != batch)
+    {
+        NCNN_LOGE("input_batch batch size %d mismatch with %d", batch, d->batch_size);
+        return -1;
+    }
+
+    for (int i = 1; i < batch; i++)
+    {
+        if (!batch_sample_shape_equal(ins[i], ins[0]))
+        {
+            NCNN_LOGE("input_batch sample %d shape mismatch", i);
+            return -1;
+        }
+    }
+
+    if (d->batch_size == 0)
+    {
+        d->batch_size = batch;
+        d->batch_blob_mats.resize(d->blob_mats.size(), std::vector<Mat>(batch));
+        d->batch_stacked_mats.resize(d->blob_mats.size());
+    }
+
+    d->batch_blob_mats[blob_index] = ins;
+    d->batch_stacked_mats[blob_index].release();
+
+    return 0;
+}
+
+int Extractor::extract_batch(int blob_index, std::vector<Mat>& feats, int type)
+{
+    if (blob_index < 0 || blob_index >= (int)d->blob_mats.size())
+        return -1;
+
+    if (d->batch_size == 0)
+    {
+        NCNN_LOGE("set batch inputs with input_batch before extract_batch");
+        return -1;
+    }
+
+    const int batch = d->batch_size;
+
+    feats.resize(batch);
+
+#if NCNN_VULKAN
+    if (d->opt.use_vulkan_compute)
+    {
+        // gpu inference runs the samples one by one
+        for (int i = 0; i < batch; i++)
+        {
+            Extractor ex = d->net->create_extractor();
+            ex.d->opt = d->opt;
+
+            for (size_t j = 0; j < d->batch_blob_mats.size(); j++)
+            {
+                if (d->batch_blob_mats[j][i].dims != 0)
+                    ex.input((int)j, d->batch_blob_mats[j][i]);
+            }
+
+            int ret = ex.extract(blob_index, feats[i], type);
+            if (ret != 0)
+                return ret;
+        }
+
+        return 0;
+    }
+#endif // NCNN_VULKAN
+
+    int ret = 0;
+
+    if (d->batch_blob_mats[blob_index][0].dims == 0 && d->batch_stacked_mats[blob_index].dims == 0)
+    {
+        int layer_index = d->net->blobs()[blob_index].producer;
+
+        // use local allocator
+        if (d->opt.use_local_pool_allocator)
+        {
+            if (!d->opt.blob_allocator)
+            {
+                d->opt.blob_allocator = d->net->d->local_blob_allocator;
+            }
+            if (!d->opt.workspace_allocator)
+            {
+                d->opt.workspace_allocator = d->net->d->local_workspace_allocator;
+            }
+        }
+
+        int old_blocktime = get_kmp_blocktime();
+        set_kmp_blocktime(d->opt.openmp_blocktime);
+
+        int old_flush_denormals = get_flush_denormals();
+        set_flush_denormals(d->opt.flush_denormals);
+
+        int old_work_stealing = get_kmp_work_stealing();
+        set_kmp_work_stealing(d->opt.use_work_stealing);
+
+        Profiler* old_profiler = get_current_profiler();
+        set_current_profiler(d->profiler);
+
+        ThreadPool* old_thread_pool = get_current_thread_pool();
+        if (d->thread_pool)
+            set_current_thread_pool(d->thread_pool);
+
+        const std::vector<Layer*>* old_numa_layers = get_current_numa_layers();
+        set_current_numa_layers(d->numa_node > 0 ? &d->net->d->numa_layers[d->numa_node] : 0);
+
+        ret = d->net->d->forward_layer_batch(layer_index, d->batch_blob_mats, d->batch_stacked_mats, d->blob_mats, d->opt);
+
+        set_kmp_blocktime(old_blocktime);
+        set_flush_denormals(old_flush_denormals);
+        set_kmp_work_stealing(old_work_stealing);
+        set_current_profiler(old_profiler);
+        set_current_thread_pool(old_thread_pool);
+        set_current_numa_layers(old_numa_layers);
+
+        if (ret != 0)
+            return ret;
+    }
+
+    if (d->batch_blob_mats[blob_index][0].dims == 0)
+    {
+        ret = unstack_batch_blob(d->batch_stacked_mats[blob_index], d->batch_blob_mats[blob_index], d->opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    // unpack and cast each sample the same way as single extract
+    for (int i = 0; i < batch; i++)
+    {
+        d->blob_mats[blob_index] = d->batch_blob_mats[blob_index][i];
+
+        ret = extract(blob_index, feats[i], type);
+
+        d->blob_mats[blob_index].release();
+
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 #if NCNN_VULKAN
 #if NCNN_STRING
 int Extractor::input(const char* blob_name, const VkMat& in)
@@ -2462,6 +5151,9 @@ int Extractor::extract(int blob_index, VkMat& feat, VkCompute& cmd)
     int old_flush_denormals = get_flush_denormals();
     set_flush_denormals(d->opt.flush_denormals);
 
+    int old_work_stealing = get_kmp_work_stealing();
+    set_kmp_work_stealing(d->opt.use_work_stealing);
+
     int ret = 0;
 
     if (d->blob_mats_gpu[blob_index].dims == 0)
@@ -2482,6 +5174,7 @@ int Extractor::extract(int blob_index, VkMat& feat, VkCompute& cmd)
 
     set_kmp_blocktime(old_blocktime);
     set_flush_denormals(old_flush_denormals);
+    set_kmp_work_stealing(old_work_stealing);
 
     return ret;
 }
@@ -81,6 +81,39 @@ public:
     // return 0 if success
     int load_model(FILE* fp);
     int load_model(const char* modelpath);
+
+    // map network weight data from model file
+    // weight data is referenced from the mapping instead of copied
+    // so that processes loading the same model share the page cache
+    // the mapping is released on clear
+    // return 0 if success
+    int load_model_mmap(const char* modelpath);
+
+    // map the weight data transformed by layer create_pipeline from cache file
+    // the cached layers skip the transform in the following load_model
+    // the cache is keyed by layer index, cpu isa level, options and the hash of layer params and weights
+    // stale records are ignored and these layers run create_pipeline as usual
+    // call it after load_param and before load_model
+    // return 0 if success
+    int load_pipeline_cache(const char* cachepath);
+
+    // save the weight data transformed by layer create_pipeline to cache file
+    // call it after load_model, regenerate the cache when the model changes
+    // return 0 if success
+    int save_pipeline_cache(const char* cachepath) const;
+
+    // apply the per-layer convolution algorithm choices from tuning file
+    // the choices are featmask bits that disable sgemm and winograd variants
+    // and are OR-ed into the featmask of the matching layers
+    // records for another model or with mismatched layer type are ignored
+    // call it after load_param and before load_model
+    // return 0 if success
+    int load_tuning(const char* tunepath);
+
+    // save the algorithm selection featmask bits of all layers to tuning file
+    // the ncnntune tool measures the candidates and writes the file with it
+    // return 0 if success
+    int save_tuning(const char* tunepath) const;
 #endif // NCNN_STDIO
 
     // load network structure from external memory
@@ -126,6 +159,10 @@ public:
     const std::vector<const char*>& output_names() const;
 #endif
 
+    // get the bytes of layer weights replicated on every numa node besides node 0
+    // zero if opt.use_numa_replica is disabled or there is only one numa node
+    size_t numa_replica_size() const;
+
     const std::vector<Blob>& blobs() const;
     const std::vector<Layer*>& layers() const;
 
@@ -151,6 +188,8 @@ private:
     NetPrivate* const d;
 };
 
+class Profiler;
+class ThreadPool;
 class ExtractorPrivate;
 class NCNN_EXPORT Extractor
 {
@@ -181,6 +220,40 @@ public:
     // set workspace memory allocator
     void set_workspace_allocator(Allocator* allocator);
 
+    // run the parallel regions inside layers on a private thread pool
+    // the pool size should match net.opt.num_threads
+    // extractors running at the same time on one pool share its threads
+    void set_thread_pool(ThreadPool* thread_pool);
+
+    // record every layer forward on the cpu into profiler, null to stop profiling
+    // the profiler must outlive the extract calls
+    void set_profiler(Profiler* profiler);
+
+    // run on the layer replicas, thread pool and local allocators of one numa node
+    // only valid when the net is loaded with opt.use_numa_replica
+    // create_extractor() binds extractors to the nodes in turn already
+    void set_numa_node(int node);
+
+    // get the total bytes of blob arenas used by forward passes so far
+    // it is the planned peak blob memory, zero if opt.use_blob_arena is disabled
+    // or no plan has been recorded for the input shapes yet
+    size_t blob_arena_size() const;
+
+    // feed the input as consecutive chunks of one stream
+    // layers supporting streaming keep their context between chunks in this extractor,
+    // the cached past frames of Convolution1D, ConvolutionDepthWise1D, Pooling1D and Spectrogram
+    // and the last hidden and cell states of forward LSTM, GRU and RNN
+    // the first input() after an extract() starts the next chunk and drops the blobs of the previous one
+    // chunk lengths should be multiples of the accumulated stride, cpu layers only
+    // the output is empty until the chunks fill the receptive field
+    // extract() fails if the blob depends on a layer combining frames over time without streaming support,
+    // such as Convolution, MultiHeadAttention, Deconvolution1D or bidirectional LSTM
+    // disabled by default
+    void set_streaming(bool enable);
+
+    // drop the streaming context, the next chunk starts a new stream
+    void reset_streaming();
+
 #if NCNN_VULKAN
     // deprecated, no-op
     // instead, set net.opt.use_vulkan_compute before net.load_param()
@@ -215,6 +288,28 @@ public:
     // type = 1, do not convert fp16/bf16 or / and packing
     int extract(int blob_index, Mat& feat, int type = 0);
 
+#if NCNN_STRING
+    // set batch inputs by blob name
+    // all mats should have the same shape
+    // return 0 if success
+    int input_batch(const char* blob_name, const std::vector<Mat>& ins);
+
+    // get batch results by blob name
+    // layers supporting batch stacking run once on the stacked samples
+    // the others run sample by sample
+    // return 0 if success
+    int extract_batch(const char* blob_name, std::vector<Mat>& feats, int type = 0);
+#endif // NCNN_STRING
+
+    // set batch inputs by blob index
+    // all mats should have the same shape
+    // return 0 if success
+    int input_batch(int blob_index, const std::vector<Mat>& ins);
+
+    // get batch results by blob index
+    // return 0 if success
+    int extract_batch(int blob_index, std::vector<Mat>& feats, int type = 0);
+
 #if NCNN_VULKAN
 #if NCNN_STRING
     // set input by blob name
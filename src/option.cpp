@@ -47,9 +47,9 @@ Option::Option()
     use_reserved_1 = false;
 
     use_tensor_storage = false;
-    use_reserved_1p = false;
+    use_numa_replica = false;
 
-    use_reserved_2 = false;
+    use_sparse_weight = false;
 
     flush_denormals = 3;
 
@@ -67,9 +67,9 @@ Option::Option()
     use_fp16_uniform = true;
     use_int8_uniform = true;
 
-    use_reserved_9 = false;
-    use_reserved_10 = false;
-    use_reserved_11 = false;
+    use_branch_parallel = false;
+    use_blob_arena = false;
+    use_work_stealing = false;
 }
 
 } // namespace ncnn
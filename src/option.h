@@ -108,8 +108,18 @@ public:
 
     bool use_tensor_storage;
 
-    bool use_reserved_1p;
-    bool use_reserved_2;
+    // replicate the layer weights on every numa node in load_model
+    // extractors are spread over the nodes, each runs on the replica, threads and allocators of its node
+    // see get_numa_node_count() and Extractor::set_numa_node()
+    // disabled by default
+    bool use_numa_replica;
+
+    // run innerproduct, convolution 1x1 and gemm with constant B on the nonzero weight blocks only
+    // when most of the pruned fp32 weights are zero, dense weights keep the dense kernels
+    // x86 only, other architectures keep the dense kernels
+    // changes should be applied before loading network structure and weight
+    // disabled by default
+    bool use_sparse_weight;
 
     // enable DAZ(Denormals-Are-Zero) and FTZ(Flush-To-Zero)
     // default value is 3
@@ -140,9 +150,25 @@ public:
     bool use_fp16_uniform;
     bool use_int8_uniform;
 
-    bool use_reserved_9;
-    bool use_reserved_10;
-    bool use_reserved_11;
+    // run independent graph branches concurrently
+    // num_threads is partitioned among the layers running at the same time
+    // blob and workspace allocator must be thread-safe when enabled
+    // changes should be applied before loading network structure and weight
+    // disabled by default
+    bool use_branch_parallel;
+
+    // serve intermediate blobs from one preplanned arena per extractor
+    // blob offsets are planned from the lifetimes recorded in the first forward pass
+    // of each input shape signature, then replayed in the following passes
+    // ignored when use_branch_parallel is enabled
+    // disabled by default
+    bool use_blob_arena;
+
+    // let idle openmp threads take over the loop share of a stalled one
+    // keeps a layer from waiting on one slow thread on hybrid cores or busy hosts
+    // only implemented in simpleomp
+    // disabled by default
+    bool use_work_stealing;
 };
 
 } // namespace ncnn
@@ -0,0 +1,243 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "profiler.h"
+
+#if NCNN_STDIO
+#include <stdio.h>
+#endif
+
+namespace ncnn {
+
+LayerProfile::LayerProfile()
+{
+    layer_index = -1;
+    start = 0.0;
+    end = 0.0;
+    thread_id = 0;
+    num_threads = 1;
+    top_bytes = 0;
+    kernel = "";
+}
+
+class ProfilerPrivate
+{
+public:
+    mutable Mutex lock;
+    std::vector<LayerProfile> records;
+};
+
+Profiler::Profiler()
+    : d(new ProfilerPrivate)
+{
+}
+
+Profiler::~Profiler()
+{
+    delete d;
+}
+
+Profiler::Profiler(const Profiler&)
+    : d(0)
+{
+}
+
+Profiler& Profiler::operator=(const Profiler&)
+{
+    return *this;
+}
+
+void Profiler::record(const LayerProfile& profile)
+{
+    MutexLockGuard g(d->lock);
+    d->records.push_back(profile);
+}
+
+void Profiler::clear()
+{
+    MutexLockGuard g(d->lock);
+    d->records.clear();
+}
+
+std::vector<LayerProfile> Profiler::records() const
+{
+    MutexLockGuard g(d->lock);
+    return d->records;
+}
+
+#if NCNN_STDIO
+static void print_shapes(FILE* fp, const std::vector<Mat>& shapes)
+{
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        const Mat& m = shapes[i];
+
+        if (i != 0)
+            fprintf(fp, " ");
+
+        if (m.dims == 1) fprintf(fp, "%d", m.w);
+        if (m.dims == 2) fprintf(fp, "%dx%d", m.w, m.h);
+        if (m.dims == 3) fprintf(fp, "%dx%dx%d", m.w, m.h, m.c);
+        if (m.dims == 4) fprintf(fp, "%dx%dx%dx%d", m.w, m.h, m.d, m.c);
+    }
+}
+
+static void print_elempacks(FILE* fp, const std::vector<Mat>& shapes)
+{
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        if (i != 0)
+            fprintf(fp, " ");
+
+        fprintf(fp, "%d", shapes[i].elempack);
+    }
+}
+
+static void print_json_string(FILE* fp, const char* s)
+{
+    fprintf(fp, "\"");
+    for (; *s; s++)
+    {
+        const unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\')
+            fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(fp, "\\u%04x", c);
+        else
+            fprintf(fp, "%c", c);
+    }
+    fprintf(fp, "\"");
+}
+
+int Profiler::save_chrome_trace(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    const std::vector<LayerProfile> rs = records();
+
+    // timestamps relative to the earliest layer start
+    double t0 = 0.0;
+    for (size_t i = 0; i < rs.size(); i++)
+    {
+        if (i == 0 || rs[i].start < t0)
+            t0 = rs[i].start;
+    }
+
+    fprintf(fp, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < rs.size(); i++)
+    {
+        const LayerProfile& r = rs[i];
+
+        fprintf(fp, "{\"name\":");
+#if NCNN_STRING
+        print_json_string(fp, r.name.empty() ? r.type.c_str() : r.name.c_str());
+        fprintf(fp, ",\"cat\":");
+        print_json_string(fp, r.type.c_str());
+#else
+        fprintf(fp, "\"%d\",\"cat\":\"layer\"", r.layer_index);
+#endif
+        fprintf(fp, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%d", (r.start - t0) * 1000.0, (r.end - r.start) * 1000.0, r.thread_id);
+
+        fprintf(fp, ",\"args\":{\"index\":%d,\"num_threads\":%d,\"bottom_shapes\":\"", r.layer_index, r.num_threads);
+        print_shapes(fp, r.bottom_shapes);
+        fprintf(fp, "\",\"bottom_elempacks\":\"");
+        print_elempacks(fp, r.bottom_shapes);
+        fprintf(fp, "\",\"top_shapes\":\"");
+        print_shapes(fp, r.top_shapes);
+        fprintf(fp, "\",\"top_elempacks\":\"");
+        print_elempacks(fp, r.top_shapes);
+        fprintf(fp, "\",\"top_bytes\":%lu,\"kernel\":", (unsigned long)r.top_bytes);
+        print_json_string(fp, r.kernel);
+        fprintf(fp, "}}%s\n", i + 1 == rs.size() ? "" : ",");
+    }
+    fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    fclose(fp);
+
+    return 0;
+}
+
+int Profiler::save_csv(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    const std::vector<LayerProfile> rs = records();
+
+    double t0 = 0.0;
+    for (size_t i = 0; i < rs.size(); i++)
+    {
+        if (i == 0 || rs[i].start < t0)
+            t0 = rs[i].start;
+    }
+
+    fprintf(fp, "index,type,name,start_ms,time_ms,thread,num_threads,bottom_shapes,bottom_elempacks,top_shapes,top_elempacks,top_bytes,kernel\n");
+    for (size_t i = 0; i < rs.size(); i++)
+    {
+        const LayerProfile& r = rs[i];
+
+#if NCNN_STRING
+        fprintf(fp, "%d,%s,%s,", r.layer_index, r.type.c_str(), r.name.c_str());
+#else
+        fprintf(fp, "%d,,,", r.layer_index);
+#endif
+        fprintf(fp, "%.3f,%.3f,%d,%d,", r.start - t0, r.end - r.start, r.thread_id, r.num_threads);
+        print_shapes(fp, r.bottom_shapes);
+        fprintf(fp, ",");
+        print_elempacks(fp, r.bottom_shapes);
+        fprintf(fp, ",");
+        print_shapes(fp, r.top_shapes);
+        fprintf(fp, ",");
+        print_elempacks(fp, r.top_shapes);
+        fprintf(fp, ",%lu,%s\n", (unsigned long)r.top_bytes, r.kernel);
+    }
+
+    fclose(fp);
+
+    return 0;
+}
+#endif // NCNN_STDIO
+
+static ThreadLocalStorage tls_profiler_kernel;
+static ThreadLocalStorage tls_profiler_thread_id;
+static Mutex g_profiler_thread_lock;
+static int g_profiler_thread_count = 0;
+
+void profiler_set_kernel(const char* kernel)
+{
+    tls_profiler_kernel.set((void*)kernel);
+}
+
+const char* profiler_take_kernel()
+{
+    const char* kernel = (const char*)tls_profiler_kernel.get();
+    tls_profiler_kernel.set(0);
+    return kernel ? kernel : "";
+}
+
+int profiler_thread_id()
+{
+    // stored as id + 1, zero means unassigned
+    size_t id = (size_t)tls_profiler_thread_id.get();
+    if (id == 0)
+    {
+        g_profiler_thread_lock.lock();
+        id = ++g_profiler_thread_count;
+        g_profiler_thread_lock.unlock();
+
+        tls_profiler_thread_id.set((void*)id);
+    }
+
+    return (int)id - 1;
+}
+
+} // namespace ncnn
@@ -0,0 +1,92 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_PROFILER_H
+#define NCNN_PROFILER_H
+
+#include "platform.h"
+#include "mat.h"
+
+namespace ncnn {
+
+// timing and blob shapes of one layer forward
+class NCNN_EXPORT LayerProfile
+{
+public:
+    LayerProfile();
+
+    int layer_index;
+#if NCNN_STRING
+    std::string type;
+    std::string name;
+#endif // NCNN_STRING
+
+    // get_current_time() in ms
+    double start;
+    double end;
+
+    // the profiler assigns every thread running layers a small id
+    int thread_id;
+    int num_threads;
+
+    // shape only, dims w h d c elemsize elempack are set as stored and data is null
+    std::vector<Mat> bottom_shapes;
+    std::vector<Mat> top_shapes;
+
+    // bytes of the top blobs produced, the allocation made by the layer for its outputs
+    size_t top_bytes;
+
+    // the kernel chosen by the layer forward, empty if the layer did not tell
+    const char* kernel;
+};
+
+class ProfilerPrivate;
+class NCNN_EXPORT Profiler
+{
+public:
+    Profiler();
+    virtual ~Profiler();
+
+    // called after every layer forward on the cpu
+    // layers of branch parallel extractors call it concurrently
+    // the default implementation appends the profile to records
+    virtual void record(const LayerProfile& profile);
+
+    // drop all records
+    void clear();
+
+    // records in completion order
+    std::vector<LayerProfile> records() const;
+
+#if NCNN_STDIO
+    // write chrome trace event format json, open it in chrome://tracing or ui.perfetto.dev
+    // return 0 if success
+    int save_chrome_trace(const char* path) const;
+
+    // write one line per record with header
+    // index,type,name,start_ms,time_ms,thread,num_threads,bottom_shapes,bottom_elempacks,top_shapes,top_elempacks,top_bytes,kernel
+    // return 0 if success
+    int save_csv(const char* path) const;
+#endif // NCNN_STDIO
+
+private:
+    Profiler(const Profiler&);
+    Profiler& operator=(const Profiler&);
+
+private:
+    ProfilerPrivate* const d;
+};
+
+// tell the attached profiler which kernel the running layer forward has chosen
+// kernel must be a string literal, cheap and safe to call when no profiler is attached
+NCNN_EXPORT void profiler_set_kernel(const char* kernel);
+
+// get and reset the kernel told on the current thread
+NCNN_EXPORT const char* profiler_take_kernel();
+
+// the small id of the current thread in profiles
+NCNN_EXPORT int profiler_thread_id();
+
+} // namespace ncnn
+
+#endif // NCNN_PROFILER_H
@@ -82,6 +82,10 @@ public:
     // per-task
     int thread_num;
 
+    // work stealing mode, the next thread_num to be claimed by the team
+    // null for the static mode
+    int* next_thread_num;
+
     // finish status
     int* num_threads_to_wait;
     Mutex* finish_lock;
@@ -152,6 +156,39 @@ public:
         condition.signal();
     }
 
+    // withdraw the tasks in v[0, n) not yet picked up, return how many were withdrawn
+    int cancel(const KMPTask* v, int n)
+    {
+        lock.lock();
+
+        int withdrawn = 0;
+        int j = front;
+        for (int i = 0; i < size; i++)
+        {
+            KMPTask* t = tasks[(front + i) % max_size];
+            if (t >= v && t < v + n)
+            {
+                withdrawn++;
+                continue;
+            }
+
+            tasks[j] = t;
+            j++;
+            if (j == max_size)
+                j = 0;
+        }
+
+        size -= withdrawn;
+        back = j;
+
+        lock.unlock();
+
+        if (withdrawn)
+            condition.signal();
+
+        return withdrawn;
+    }
+
     void get(KMPTask*& v)
     {
         lock.lock();
@@ -181,6 +218,14 @@ private:
     int back;
 };
 
+class KMPGlobal;
+
+struct KMPThreadArgs
+{
+    KMPGlobal* team;
+    int tid;
+};
+
 class KMPGlobal
 {
 public:
@@ -188,8 +233,9 @@ public:
     {
         kmp_max_threads = 0;
         kmp_threads = 0;
-        kmp_threads_tid = 0;
+        kmp_threads_args = 0;
         kmp_task_queue = 0;
+        kmp_pin_threads = false;
     }
 
     ~KMPGlobal()
@@ -206,20 +252,32 @@ public:
     static pthread_once_t is_initialized;
 
     void init()
+    {
+        init(ncnn::get_cpu_count(), 0);
+    }
+
+    void init(int max_threads, const ncnn::CpuSet* thread_affinity_mask)
     {
         // NCNN_LOGE("KMPGlobal init");
-        kmp_max_threads = ncnn::get_cpu_count();
+        kmp_max_threads = max_threads;
+
+        if (thread_affinity_mask)
+        {
+            kmp_thread_affinity_mask = *thread_affinity_mask;
+            kmp_pin_threads = true;
+        }
 
         kmp_task_queue = new ncnn::KMPTaskQueue(std::max(kmp_max_threads * 4, 16));
 
         if (kmp_max_threads > 1)
         {
             kmp_threads = new ncnn::Thread*[kmp_max_threads - 1];
-            kmp_threads_tid = new int[kmp_max_threads - 1];
+            kmp_threads_args = new KMPThreadArgs[kmp_max_threads - 1];
             for (int i = 0; i < kmp_max_threads - 1; i++)
             {
-                kmp_threads_tid[i] = i + 1;
-                kmp_threads[i] = new ncnn::Thread(kmp_threadfunc, (void*)&kmp_threads_tid[i]);
+                kmp_threads_args[i].team = this;
+                kmp_threads_args[i].tid = i + 1;
+                kmp_threads[i] = new ncnn::Thread(kmp_threadfunc, (void*)&kmp_threads_args[i]);
             }
         }
     }
@@ -243,6 +301,7 @@ public:
 #endif
                 tasks[i].num_threads = kmp_max_threads;
                 tasks[i].thread_num = i + 1;
+                tasks[i].next_thread_num = 0;
                 tasks[i].num_threads_to_wait = 0;
                 tasks[i].finish_lock = 0;
                 tasks[i].finish_condition = 0;
@@ -262,7 +321,7 @@ public:
                 delete kmp_threads[i];
             }
             delete[] kmp_threads;
-            delete[] kmp_threads_tid;
+            delete[] kmp_threads_args;
         }
 
         delete kmp_task_queue;
@@ -271,8 +330,12 @@ public:
 public:
     int kmp_max_threads;
     ncnn::Thread** kmp_threads;
-    int* kmp_threads_tid;
+    KMPThreadArgs* kmp_threads_args;
     ncnn::KMPTaskQueue* kmp_task_queue;
+
+    // pin worker threads to the mask when they start
+    ncnn::CpuSet kmp_thread_affinity_mask;
+    bool kmp_pin_threads;
 };
 
 } // namespace ncnn
@@ -284,11 +347,55 @@ static ncnn::KMPGlobal g_kmp_global;
 static ncnn::ThreadLocalStorage tls_num_threads;
 static ncnn::ThreadLocalStorage tls_thread_num;
 
+// private team of the calling thread, null for the global one
+static ncnn::ThreadLocalStorage tls_kmp_team;
+
+static ncnn::ThreadLocalStorage tls_work_stealing;
+
 static void init_g_kmp_global()
 {
     g_kmp_global.init();
 }
 
+static ncnn::KMPGlobal* get_kmp_team()
+{
+    ncnn::KMPGlobal* team = (ncnn::KMPGlobal*)tls_kmp_team.get();
+    if (team)
+        return team;
+
+    g_kmp_global.try_init();
+    return &g_kmp_global;
+}
+
+namespace ncnn {
+
+KMPGlobal* kmp_create_team(int num_threads, const CpuSet* thread_affinity_mask)
+{
+    KMPGlobal* team = new KMPGlobal;
+    team->init(std::max(num_threads, 1), thread_affinity_mask);
+    return team;
+}
+
+void kmp_destroy_team(KMPGlobal* team)
+{
+    if (tls_kmp_team.get() == team)
+        tls_kmp_team.set(0);
+
+    delete team;
+}
+
+KMPGlobal* kmp_get_team()
+{
+    return (KMPGlobal*)tls_kmp_team.get();
+}
+
+void kmp_set_team(KMPGlobal* team)
+{
+    tls_kmp_team.set(team);
+}
+
+} // namespace ncnn
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -323,6 +430,16 @@ int omp_get_thread_num()
     return (int)reinterpret_cast<size_t>(tls_thread_num.get());
 }
 
+int kmp_get_work_stealing()
+{
+    return (int)reinterpret_cast<size_t>(tls_work_stealing.get());
+}
+
+void kmp_set_work_stealing(int work_stealing)
+{
+    tls_work_stealing.set(reinterpret_cast<void*>((size_t)(work_stealing ? 1 : 0)));
+}
+
 #if __clang__
 int kmp_get_blocktime()
 {
@@ -445,32 +562,91 @@ static int kmp_invoke_microtask(kmpc_micro fn, int gtid, int tid, int argc, void
 }
 #endif // __clang__
 
-static void* kmp_threadfunc(void* args)
+static void kmp_invoke_task(const ncnn::KMPTask* task, int thread_num, int tid)
 {
+    tls_num_threads.set(reinterpret_cast<void*>((size_t)task->num_threads));
+    tls_thread_num.set(reinterpret_cast<void*>((size_t)thread_num));
+
 #if __clang__
-    int tid = *(int*)args;
+    kmp_invoke_microtask(task->fn, thread_num, tid, task->argc, task->argv);
 #else
-    (void)args;
+    (void)tid;
+    task->fn(task->data);
 #endif
+}
+
+static void kmp_claim_and_invoke_task(const ncnn::KMPTask* task, int tid)
+{
+    // the thread_num set before claiming, the claimed ones must not outlive the loop
+    void* old_thread_num = tls_thread_num.get();
+
+    // every thread_num runs exactly once, on whichever thread claims it first
+    for (;;)
+    {
+        int thread_num = __sync_fetch_and_add(task->next_thread_num, 1);
+        if (thread_num >= task->num_threads)
+            break;
+
+        kmp_invoke_task(task, thread_num, tid);
+    }
+
+    tls_thread_num.set(old_thread_num);
+}
+
+// tasks[0] runs on the calling thread, tasks[1 ~ num_helpers] are dispatched to the team
+// the calling thread runs thread_num 0 and then claims the rest along with the helpers,
+// helper tasks not yet picked up when all thread_num are claimed are withdrawn instead of waited for
+static void kmp_fork_work_stealing(ncnn::KMPGlobal* team, ncnn::KMPTask* tasks, int num_helpers)
+{
+    team->kmp_task_queue->dispatch(tasks + 1, num_helpers);
+
+    kmp_invoke_task(&tasks[0], 0, 0);
+
+    kmp_claim_and_invoke_task(&tasks[0], 0);
+
+    int withdrawn = team->kmp_task_queue->cancel(tasks + 1, num_helpers);
+
+    // wait for finished
+    {
+        tasks[0].finish_lock->lock();
+        *tasks[0].num_threads_to_wait -= withdrawn;
+        while (*tasks[0].num_threads_to_wait != 0)
+        {
+            tasks[0].finish_condition->wait(*tasks[0].finish_lock);
+        }
+        tasks[0].finish_lock->unlock();
+    }
+}
+
+static void* kmp_threadfunc(void* args)
+{
+    const ncnn::KMPThreadArgs* thread_args = (const ncnn::KMPThreadArgs*)args;
+    ncnn::KMPGlobal* team = thread_args->team;
+    int tid = thread_args->tid;
+
+    if (team->kmp_pin_threads)
+    {
+        ncnn::set_current_thread_affinity(team->kmp_thread_affinity_mask);
+    }
 
     for (;;)
     {
         ncnn::KMPTask* task;
-        g_kmp_global.kmp_task_queue->get(task);
+        team->kmp_task_queue->get(task);
 
         // fprintf(stderr, "get %d\n", tid);
 
         if (!task->fn)
             break;
 
-        tls_num_threads.set(reinterpret_cast<void*>((size_t)task->num_threads));
-        tls_thread_num.set(reinterpret_cast<void*>((size_t)task->thread_num));
-
-#if __clang__
-        kmp_invoke_microtask(task->fn, task->thread_num, tid, task->argc, task->argv);
-#else
-        task->fn(task->data);
-#endif
+        if (task->next_thread_num)
+        {
+            kmp_claim_and_invoke_task(task, tid);
+        }
+        else
+        {
+            kmp_invoke_task(task, task->thread_num, tid);
+        }
 
         // update finished
         {
@@ -503,10 +679,14 @@ void __kmpc_push_num_threads(void* /*loc*/, int32_t /*gtid*/, int32_t num_thread
 
 void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
 {
-    g_kmp_global.try_init();
+    ncnn::KMPGlobal* team = get_kmp_team();
 
     // NCNN_LOGE("__kmpc_fork_call %d", argc);
     int num_threads = omp_get_num_threads();
+    if (team != &g_kmp_global)
+    {
+        num_threads = std::min(num_threads, team->kmp_max_threads);
+    }
 
     // build argv
     void* argv[32];
@@ -518,7 +698,7 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
         va_end(ap);
     }
 
-    if (g_kmp_global.kmp_max_threads == 1 || num_threads == 1)
+    if (team->kmp_max_threads == 1 || num_threads == 1)
     {
         for (int i = 0; i < num_threads; i++)
         {
@@ -530,6 +710,34 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
         return;
     }
 
+    if (kmp_get_work_stealing())
+    {
+        const int num_helpers = std::min(num_threads, team->kmp_max_threads) - 1;
+
+        int num_threads_to_wait = num_helpers;
+        int next_thread_num = 1;
+        ncnn::Mutex finish_lock;
+        ncnn::ConditionVariable finish_condition;
+
+        // TODO portable stack allocation
+        ncnn::KMPTask* tasks = (ncnn::KMPTask*)alloca((num_helpers + 1) * sizeof(ncnn::KMPTask));
+        for (int i = 0; i < num_helpers + 1; i++)
+        {
+            tasks[i].fn = fn;
+            tasks[i].argc = argc;
+            tasks[i].argv = (void**)argv;
+            tasks[i].num_threads = num_threads;
+            tasks[i].thread_num = -1;
+            tasks[i].next_thread_num = &next_thread_num;
+            tasks[i].num_threads_to_wait = &num_threads_to_wait;
+            tasks[i].finish_lock = &finish_lock;
+            tasks[i].finish_condition = &finish_condition;
+        }
+
+        kmp_fork_work_stealing(team, tasks, num_helpers);
+        return;
+    }
+
     int num_threads_to_wait = num_threads - 1;
     ncnn::Mutex finish_lock;
     ncnn::ConditionVariable finish_condition;
@@ -543,13 +751,14 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
         tasks[i].argv = (void**)argv;
         tasks[i].num_threads = num_threads;
         tasks[i].thread_num = i + 1;
+        tasks[i].next_thread_num = 0;
         tasks[i].num_threads_to_wait = &num_threads_to_wait;
         tasks[i].finish_lock = &finish_lock;
         tasks[i].finish_condition = &finish_condition;
     }
 
     // dispatch 1 ~ num_threads
-    g_kmp_global.kmp_task_queue->dispatch(tasks, num_threads - 1);
+    team->kmp_task_queue->dispatch(tasks, num_threads - 1);
 
     // dispatch 0
     {
@@ -653,15 +862,19 @@ struct parallel_context
 
 void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
 {
-    g_kmp_global.try_init();
+    ncnn::KMPGlobal* team = get_kmp_team();
 
     // NCNN_LOGE("GOMP_parallel_start %p %p %u", fn, data, num_threads);
     if (num_threads == 0)
     {
         num_threads = omp_get_max_threads();
     }
+    if (team != &g_kmp_global)
+    {
+        num_threads = std::min(num_threads, (unsigned)team->kmp_max_threads);
+    }
 
-    if (g_kmp_global.kmp_max_threads == 1 || num_threads == 1)
+    if (team->kmp_max_threads == 1 || num_threads == 1)
     {
         for (unsigned i = 0; i < num_threads; i++)
         {
@@ -687,13 +900,14 @@ void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
         pc->tasks[i].data = data;
         pc->tasks[i].num_threads = num_threads;
         pc->tasks[i].thread_num = i + 1;
+        pc->tasks[i].next_thread_num = 0;
         pc->tasks[i].num_threads_to_wait = &pc->num_threads_to_wait;
         pc->tasks[i].finish_lock = &pc->finish_lock;
         pc->tasks[i].finish_condition = &pc->finish_condition;
     }
 
     // dispatch 1 ~ num_threads
-    g_kmp_global.kmp_task_queue->dispatch(pc->tasks, num_threads - 1);
+    team->kmp_task_queue->dispatch(pc->tasks, num_threads - 1);
 
     // dispatch 0
     {
@@ -724,15 +938,19 @@ void GOMP_parallel_end()
 
 void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned int /*flags*/)
 {
-    g_kmp_global.try_init();
+    ncnn::KMPGlobal* team = get_kmp_team();
 
     // NCNN_LOGE("GOMP_parallel %p %p %u", fn, data, num_threads);
     if (num_threads == 0)
     {
         num_threads = omp_get_max_threads();
     }
+    if (team != &g_kmp_global)
+    {
+        num_threads = std::min(num_threads, (unsigned)team->kmp_max_threads);
+    }
 
-    if (g_kmp_global.kmp_max_threads == 1 || num_threads == 1)
+    if (team->kmp_max_threads == 1 || num_threads == 1)
     {
         for (unsigned i = 0; i < num_threads; i++)
         {
@@ -745,6 +963,33 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
         return;
     }
 
+    if (kmp_get_work_stealing())
+    {
+        const int num_helpers = std::min((int)num_threads, team->kmp_max_threads) - 1;
+
+        int num_threads_to_wait = num_helpers;
+        int next_thread_num = 1;
+        ncnn::Mutex finish_lock;
+        ncnn::ConditionVariable finish_condition;
+
+        // TODO portable stack allocation
+        ncnn::KMPTask* tasks = (ncnn::KMPTask*)alloca((num_helpers + 1) * sizeof(ncnn::KMPTask));
+        for (int i = 0; i < num_helpers + 1; i++)
+        {
+            tasks[i].fn = fn;
+            tasks[i].data = data;
+            tasks[i].num_threads = num_threads;
+            tasks[i].thread_num = -1;
+            tasks[i].next_thread_num = &next_thread_num;
+            tasks[i].num_threads_to_wait = &num_threads_to_wait;
+            tasks[i].finish_lock = &finish_lock;
+            tasks[i].finish_condition = &finish_condition;
+        }
+
+        kmp_fork_work_stealing(team, tasks, num_helpers);
+        return;
+    }
+
     int num_threads_to_wait = num_threads - 1;
     ncnn::Mutex finish_lock;
     ncnn::ConditionVariable finish_condition;
@@ -757,13 +1002,14 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
         tasks[i].data = data;
         tasks[i].num_threads = num_threads;
         tasks[i].thread_num = i + 1;
+        tasks[i].next_thread_num = 0;
         tasks[i].num_threads_to_wait = &num_threads_to_wait;
         tasks[i].finish_lock = &finish_lock;
         tasks[i].finish_condition = &finish_condition;
     }
 
     // dispatch 1 ~ num_threads
-    g_kmp_global.kmp_task_queue->dispatch(tasks, num_threads - 1);
+    team->kmp_task_queue->dispatch(tasks, num_threads - 1);
 
     // dispatch 0
     {
@@ -33,10 +33,34 @@ NCNN_EXPORT int kmp_get_blocktime();
 
 NCNN_EXPORT void kmp_set_blocktime(int blocktime);
 
+// claim thread_num dynamically so idle threads take over the share of a stalled one
+// thread_num 0 always runs on the calling thread, per calling thread setting
+NCNN_EXPORT int kmp_get_work_stealing();
+
+NCNN_EXPORT void kmp_set_work_stealing(int work_stealing);
+
 #ifdef __cplusplus
 }
 #endif
 
+#ifdef __cplusplus
+namespace ncnn {
+
+class CpuSet;
+class KMPGlobal;
+
+// private worker team, the parallel regions started on a thread run on the team set on it
+// worker threads are pinned to thread_affinity_mask if it is not null
+KMPGlobal* kmp_create_team(int num_threads, const CpuSet* thread_affinity_mask);
+void kmp_destroy_team(KMPGlobal* team);
+
+// null for the global team
+KMPGlobal* kmp_get_team();
+void kmp_set_team(KMPGlobal* team);
+
+} // namespace ncnn
+#endif // __cplusplus
+
 #endif // NCNN_SIMPLEOMP
 
 #endif // NCNN_SIMPLEOMP_H
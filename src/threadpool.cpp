@@ -0,0 +1,129 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "threadpool.h"
+
+#ifdef _OPENMP
+#if NCNN_SIMPLEOMP
+#include "simpleomp.h"
+#else
+#include <omp.h>
+#endif
+#endif
+
+#include <vector>
+
+namespace ncnn {
+
+class ThreadPoolPrivate
+{
+public:
+    int num_threads;
+    CpuSet thread_affinity_mask;
+    bool pin_threads;
+
+    // identifies the pool a thread was pinned for, pointers may be reused
+    int serial;
+
+#if NCNN_SIMPLEOMP
+    KMPGlobal* team;
+#endif
+};
+
+static Mutex g_thread_pool_lock;
+static int g_thread_pool_serial = 0;
+
+static ThreadLocalStorage tls_thread_pool;
+static ThreadLocalStorage tls_thread_pool_pinned;
+
+ThreadPool::ThreadPool(int num_threads, const CpuSet& thread_affinity_mask)
+    : d(new ThreadPoolPrivate)
+{
+    const int num_enabled = thread_affinity_mask.num_enabled();
+
+    if (num_threads <= 0)
+        num_threads = num_enabled > 0 ? num_enabled : get_cpu_count();
+
+    d->num_threads = num_threads;
+    d->thread_affinity_mask = thread_affinity_mask;
+    d->pin_threads = num_enabled > 0;
+
+    g_thread_pool_lock.lock();
+    d->serial = ++g_thread_pool_serial;
+    g_thread_pool_lock.unlock();
+
+#if NCNN_SIMPLEOMP
+    d->team = kmp_create_team(num_threads, d->pin_threads ? &d->thread_affinity_mask : 0);
+#endif
+}
+
+ThreadPool::~ThreadPool()
+{
+    if (get_current_thread_pool() == this)
+        set_current_thread_pool(0);
+
+#if NCNN_SIMPLEOMP
+    kmp_destroy_team(d->team);
+#endif
+
+    delete d;
+}
+
+ThreadPool::ThreadPool(const ThreadPool&)
+    : d(0)
+{
+}
+
+ThreadPool& ThreadPool::operator=(const ThreadPool&)
+{
+    return *this;
+}
+
+int ThreadPool::num_threads() const
+{
+    return d->num_threads;
+}
+
+const CpuSet& ThreadPool::thread_affinity_mask() const
+{
+    return d->thread_affinity_mask;
+}
+
+void set_current_thread_pool(ThreadPool* thread_pool)
+{
+    tls_thread_pool.set(thread_pool);
+
+#if NCNN_SIMPLEOMP
+    kmp_set_team(thread_pool ? thread_pool->d->team : 0);
+#endif
+
+    if (!thread_pool || !thread_pool->d->pin_threads)
+        return;
+
+    // pin once per thread and pool
+    const size_t serial = (size_t)thread_pool->d->serial;
+    if ((size_t)tls_thread_pool_pinned.get() == serial)
+        return;
+
+    tls_thread_pool_pinned.set((void*)serial);
+
+#if defined(_OPENMP) && !NCNN_SIMPLEOMP
+    // openmp runtimes keep a team per master thread, pin all of it
+    const int num_threads = thread_pool->d->num_threads;
+    const CpuSet& thread_affinity_mask = thread_pool->d->thread_affinity_mask;
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < num_threads; i++)
+    {
+        set_current_thread_affinity(thread_affinity_mask);
+    }
+#else
+    set_current_thread_affinity(thread_pool->d->thread_affinity_mask);
+#endif
+}
+
+ThreadPool* get_current_thread_pool()
+{
+    return (ThreadPool*)tls_thread_pool.get();
+}
+
+} // namespace ncnn
@@ -0,0 +1,48 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_THREADPOOL_H
+#define NCNN_THREADPOOL_H
+
+#include "platform.h"
+#include "cpu.h"
+
+namespace ncnn {
+
+class ThreadPool;
+
+// route the parallel regions started on the calling thread to thread_pool, null for the shared team
+// the calling thread is pinned to the pool cpus and stays pinned after switching away
+// with the built-in simpleomp runtime the work runs on the pool threads,
+// with other openmp runtimes the team of the calling thread is pinned to the pool cpus instead
+NCNN_EXPORT void set_current_thread_pool(ThreadPool* thread_pool);
+NCNN_EXPORT ThreadPool* get_current_thread_pool();
+
+// worker threads private to the extractors it is attached to
+// the parallel regions inside layers run on these threads instead of the shared openmp team,
+// so extractors with their own pools on disjoint cpus do not compete with each other
+class ThreadPoolPrivate;
+class NCNN_EXPORT ThreadPool
+{
+public:
+    // num_threads includes the thread calling extract, which runs the first share of the work
+    // threads are pinned to thread_affinity_mask unless it is empty
+    // num_threads 0 means the number of cpus in thread_affinity_mask
+    ThreadPool(int num_threads, const CpuSet& thread_affinity_mask = CpuSet());
+    ~ThreadPool();
+
+    int num_threads() const;
+    const CpuSet& thread_affinity_mask() const;
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+private:
+    friend void set_current_thread_pool(ThreadPool* thread_pool);
+    ThreadPoolPrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_THREADPOOL_H
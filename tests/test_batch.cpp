@@ -0,0 +1,95 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "testutil.h"
+
+static int test_batch(const ncnn::Option& _opt, int batch)
+{
+    std::vector<unsigned char> model = FireModel(2);
+
+    ncnn::Option opt = _opt;
+    opt.use_vulkan_compute = false;
+
+    ncnn::Net net;
+    net.opt = opt;
+    if (LoadNet(net, FireParam(2).c_str(), model) != 0)
+    {
+        fprintf(stderr, "LoadNet failed\n");
+        return -1;
+    }
+
+    std::vector<ncnn::Mat> ins(batch);
+    std::vector<ncnn::Mat> refs(batch);
+    for (int i = 0; i < batch; i++)
+    {
+        ins[i] = RandomMat(24, 24, 3);
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", ins[i]);
+        ex.extract("prob", refs[i]);
+    }
+
+    std::vector<ncnn::Mat> outs;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input_batch("data", ins);
+        int ret = ex.extract_batch("prob", outs);
+        if (ret != 0 || (int)outs.size() != batch)
+        {
+            fprintf(stderr, "extract_batch failed %d\n", ret);
+            return -1;
+        }
+    }
+
+    if (CompareMat(refs, outs, 0.001) != 0)
+    {
+        fprintf(stderr, "test_batch failed batch=%d use_packing_layout=%d use_fp16_storage=%d\n", batch, opt.use_packing_layout, opt.use_fp16_storage);
+        return -1;
+    }
+
+    // mixed shapes are rejected
+    {
+        std::vector<ncnn::Mat> ins2 = ins;
+        ins2.push_back(RandomMat(20, 24, 3));
+
+        ncnn::Extractor ex = net.create_extractor();
+        if (ex.input_batch("data", ins2) == 0)
+        {
+            fprintf(stderr, "test_batch accepted mixed shapes\n");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[2];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_packed = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_packed = true;
+    opts[1].use_fp16_storage = true;
+    opts[1].use_bf16_storage = true;
+
+    for (int i = 0; i < 2; i++)
+    {
+        int ret = 0
+                  || test_batch(opts[i], 1)
+                  || test_batch(opts[i], 3)
+                  || test_batch(opts[i], 8);
+
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
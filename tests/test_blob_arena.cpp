@@ -0,0 +1,108 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "testutil.h"
+
+static int test_blob_arena(const ncnn::Option& _opt)
+{
+    std::vector<unsigned char> model = FireModel(2);
+
+    ncnn::Option opt = _opt;
+    opt.use_vulkan_compute = false;
+    opt.use_blob_arena = false;
+
+    ncnn::Net net0;
+    net0.opt = opt;
+    if (LoadNet(net0, FireParam(2).c_str(), model) != 0)
+    {
+        fprintf(stderr, "LoadNet failed\n");
+        return -1;
+    }
+
+    opt.use_blob_arena = true;
+
+    ncnn::Net net;
+    net.opt = opt;
+    if (LoadNet(net, FireParam(2).c_str(), model) != 0)
+    {
+        fprintf(stderr, "LoadNet failed\n");
+        return -1;
+    }
+
+    // each input shape gets its own plan
+    ncnn::Mat ins[2] = {RandomMat(24, 24, 3), RandomMat(31, 17, 3)};
+
+    ncnn::Mat refs[2];
+    for (int i = 0; i < 2; i++)
+    {
+        ncnn::Extractor ex = net0.create_extractor();
+        ex.input("data", ins[i]);
+        ex.extract("fire3/concat", refs[i]);
+    }
+
+    // the plan is recorded in the first pass of each shape and replayed in the following ones
+    for (int k = 0; k < 6; k++)
+    {
+        const int i = k % 2;
+
+        ncnn::Mat out;
+        size_t arena_size = 0;
+        {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.input("data", ins[i]);
+            int ret = ex.extract("fire3/concat", out);
+            if (ret != 0)
+            {
+                fprintf(stderr, "extract failed\n");
+                return -1;
+            }
+
+            arena_size = ex.blob_arena_size();
+        }
+
+        if (CompareMat(refs[i], out, 0.001) != 0)
+        {
+            fprintf(stderr, "test_blob_arena failed pass=%d lightmode=%d use_packing_layout=%d use_fp16_storage=%d\n", k, opt.lightmode, opt.use_packing_layout, opt.use_fp16_storage);
+            return -1;
+        }
+
+        // without lightmode every blob outlives the forward pass and stays out of the arena
+        if (k >= 2 && opt.lightmode && arena_size == 0)
+        {
+            fprintf(stderr, "test_blob_arena plan not replayed pass=%d\n", k);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_packed = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_packed = true;
+    opts[1].use_fp16_storage = true;
+    opts[1].use_bf16_storage = true;
+
+    opts[2].lightmode = false;
+    opts[2].use_packing_layout = true;
+
+    for (int i = 0; i < 3; i++)
+    {
+        int ret = test_blob_arena(opts[i]);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
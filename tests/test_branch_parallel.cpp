@@ -0,0 +1,83 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "testutil.h"
+
+static int run_net(const ncnn::Option& opt, const std::vector<unsigned char>& model, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Net net;
+    net.opt = opt;
+
+    // two fire modules, the expand branches of each are independent
+    if (LoadNet(net, FireParam(2).c_str(), model) != 0)
+        return -1;
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("prob", out);
+}
+
+static int test_branch_parallel(const ncnn::Option& _opt, int num_threads)
+{
+    std::vector<unsigned char> model = FireModel(2);
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    ncnn::Option opt = _opt;
+    opt.num_threads = 1;
+    opt.use_branch_parallel = false;
+    opt.use_vulkan_compute = false;
+
+    ncnn::Mat ref;
+    if (run_net(opt, model, in, ref) != 0)
+    {
+        fprintf(stderr, "run_net failed\n");
+        return -1;
+    }
+
+    opt.num_threads = num_threads;
+    opt.use_branch_parallel = true;
+
+    // run a few times so that the helper threads pick the layers in different orders
+    for (int i = 0; i < 3; i++)
+    {
+        ncnn::Mat out;
+        if (run_net(opt, model, in, out) != 0 || CompareMat(ref, out, 0.001) != 0)
+        {
+            fprintf(stderr, "test_branch_parallel failed num_threads=%d use_packing_layout=%d use_fp16_storage=%d\n", num_threads, opt.use_packing_layout, opt.use_fp16_storage);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[2];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_packed = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_packed = true;
+    opts[1].use_fp16_storage = true;
+    opts[1].use_bf16_storage = true;
+
+    for (int i = 0; i < 2; i++)
+    {
+        int ret = 0
+                  || test_branch_parallel(opts[i], 2)
+                  || test_branch_parallel(opts[i], 3)
+                  || test_branch_parallel(opts[i], 4);
+
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
@@ -56,6 +56,26 @@ static int test_convolution(int w, int h, int c, int outch, int kernel, int dila
         }
     }
 
+    {
+        // fp16 weights on the im2col gemm path
+        ncnn::Option opt;
+        opt.num_threads = 1;
+        opt.use_packing_layout = true;
+        opt.use_fp16_packed = true;
+        opt.use_fp16_storage = true;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_storage = false;
+        opt.use_sgemm_convolution = true;
+        opt.use_winograd_convolution = false;
+
+        ret = test_layer_opt("Convolution", pd, weights, opt, a, epsilon);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_convolution failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d act=%d actparams=[%f,%f]\n", w, h, c, outch, kernel, dilation, stride, pad, bias, activation_type, activation_params[0], activation_params[1]);
+            return ret;
+        }
+    }
+
     {
         ncnn::Option opt;
         opt.num_threads = 1;
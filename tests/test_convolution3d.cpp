@@ -75,9 +75,43 @@ static int test_convolution3d_0()
     return 0;
 }
 
+static int test_convolution3d_1()
+{
+    static const int kdsp[6][4] = {
+        {1, 1, 1, 0},
+        {1, 1, 2, 0},
+        {2, 1, 1, 1},
+        {3, 1, 1, 1},
+        {3, 1, 2, -233},
+        {3, 2, 1, 2},
+    };
+
+    for (int i = 0; i < 6; i++)
+    {
+        const int k = kdsp[i][0];
+        const int d = kdsp[i][1];
+        const int s = kdsp[i][2];
+        const int p = kdsp[i][3];
+
+        int ret = 0
+                  || test_convolution3d(9, 8, 7, 3, 24, k, d, s, p, 1)
+                  || test_convolution3d(9, 8, 7, 17, 20, k, d, s, p, 0)
+                  || test_convolution3d(9, 8, 7, 24, 17, k, d, s, p, 1)
+                  || test_convolution3d(9, 8, 7, 32, 32, k, d, s, p, 1)
+                  || test_convolution3d(13, 5, 6, 48, 64, k, d, s, p, 0);
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_convolution3d_0();
+    return 0
+           || test_convolution3d_0()
+           || test_convolution3d_1();
 }
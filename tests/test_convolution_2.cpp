@@ -161,9 +161,56 @@ static int test_convolution_1()
            || test_convolution(9, 10, 6, 160, 3, 1, 1, 0, 0);
 }
 
+static int test_convolution_sparse(int w, int h, int c, int outch, int pad, int bias, int block_h, float density)
+{
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, 1);
+    pd.set(2, 1);
+    pd.set(3, 1);
+    pd.set(4, pad);
+    pd.set(5, bias);
+    pd.set(6, outch * c);
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 2 : 1);
+    weights[0] = RandomMat(outch * c);
+    Sparsify(weights[0], c, outch, block_h, density);
+    if (bias)
+        weights[1] = RandomMat(outch);
+
+    int ret = test_layer("Convolution", pd, weights, a, 0.001, 0, TEST_LAYER_ENABLE_SPARSE_WEIGHT);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_convolution_sparse failed w=%d h=%d c=%d outch=%d pad=%d bias=%d block_h=%d density=%f act=%d actparams=[%f,%f]\n", w, h, c, outch, pad, bias, block_h, density, activation_type, activation_params[0], activation_params[1]);
+        return ret;
+    }
+
+    return ret;
+}
+
+static int test_convolution_2()
+{
+    return 0
+           || test_convolution_sparse(7, 6, 64, 32, 0, 1, 4, 0.25f)
+           || test_convolution_sparse(9, 5, 48, 17, 1, 0, 4, 0.15f)
+           || test_convolution_sparse(13, 11, 24, 64, 0, 1, 4, 0.2f)
+           || test_convolution_sparse(8, 7, 96, 12, 0, 1, 1, 0.1f)
+           || test_convolution_sparse(5, 9, 40, 9, 1, 1, 1, 0.15f)
+           || test_convolution_sparse(32, 17, 16, 24, 0, 0, 4, 0.25f);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_convolution_0() || test_convolution_1();
+    return test_convolution_0() || test_convolution_1() || test_convolution_2();
 }
@@ -1,6 +1,7 @@
 // Copyright 2020 Tencent
 // SPDX-License-Identifier: BSD-3-Clause
 
+#include "modelbin.h"
 #include "testutil.h"
 
 static int test_gemm(int M, int N, int K, float alpha, int transA, int transB, int output_transpose, int constantA, int constantB, int output_N1M = 0)
@@ -234,6 +235,217 @@ static int test_gemm_1(int M, int N, int K)
            || test_gemm_bias(M, N, K, RandomMat(N), 3.1f, 0.6f, 0, 1, 0, 1, 1, 1);
 }
 
+static int test_gemm_sparse(int M, int N, int K, const ncnn::Mat& C, float alpha, float beta, int transA, int transB, int output_transpose, int block_h, float density)
+{
+    int broadcast_type_C = 0;
+    if (C.dims == 1 && C.w == M)
+        broadcast_type_C = 1;
+    if (C.dims == 1 && C.w == N)
+        broadcast_type_C = 4;
+    if (C.dims == 2 && C.w == N && C.h == M)
+        broadcast_type_C = 3;
+
+    ncnn::ParamDict pd;
+    pd.set(0, alpha);
+    pd.set(1, beta);
+    pd.set(2, transA);
+    pd.set(3, transB);
+    pd.set(4, 0);
+    pd.set(5, 1);
+    pd.set(6, 1);
+    pd.set(7, M);
+    pd.set(8, N);
+    pd.set(9, K);
+    pd.set(10, broadcast_type_C);
+    pd.set(14, output_transpose);
+
+    // zero blocks of block_h outputs along one k of the constant B
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = transB ? RandomMat(K, N) : RandomMat(N, K);
+    if (transB)
+    {
+        Sparsify(weights[0], K, N, block_h, density);
+    }
+    else
+    {
+        ncnn::Mat BT = RandomMat(K, N);
+        Sparsify(BT, K, N, block_h, density);
+        for (int i = 0; i < N; i++)
+        {
+            for (int k = 0; k < K; k++)
+            {
+                weights[0].row(k)[i] = BT.row(i)[k];
+            }
+        }
+    }
+    weights[1] = C;
+
+    std::vector<ncnn::Mat> a(1);
+    a[0] = transA ? RandomMat(M, K) : RandomMat(K, M);
+
+    int ret = test_layer("Gemm", pd, weights, a, 1, 0.001, 0, TEST_LAYER_ENABLE_SPARSE_WEIGHT);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_gemm_sparse failed M=%d N=%d K=%d C.dims=%d C=(%d %d %d) alpha=%f beta=%f transA=%d transB=%d output_transpose=%d block_h=%d density=%f\n", M, N, K, C.dims, C.w, C.h, C.c, alpha, beta, transA, transB, output_transpose, block_h, density);
+        return ret;
+    }
+
+    return ret;
+}
+
+static int test_gemm_2(int M, int N, int K)
+{
+    return 0
+           || test_gemm_sparse(M, N, K, RandomMat(1), 2.1f, 0.5f, 0, 1, 0, 4, 0.25f)
+           || test_gemm_sparse(M, N, K, RandomMat(M), 3.1f, 0.6f, 1, 1, 1, 4, 0.15f)
+           || test_gemm_sparse(M, N, K, RandomMat(N, M), 4.1f, 0.7f, 0, 0, 0, 4, 0.2f)
+           || test_gemm_sparse(M, N, K, RandomMat(N), 5.1f, 0.8f, 1, 0, 1, 1, 0.1f)
+           || test_gemm_sparse(M, N, K, RandomMat(N, M), 2.1f, 0.5f, 1, 1, 0, 1, 0.15f);
+}
+
+static int test_gemm_output_elemtype(int M, int N, int K, int transA, int transB, int output_transpose, int constantA, int constantB, int output_elemtype)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, 2.1f); // alpha
+    pd.set(1, 1.f);  // beta
+    pd.set(2, transA);
+    pd.set(3, transB);
+    pd.set(4, constantA);
+    pd.set(5, constantB);
+    pd.set(6, 1);
+    pd.set(7, M);
+    pd.set(8, N);
+    pd.set(9, K);
+    pd.set(10, -1);
+    pd.set(13, output_elemtype);
+    pd.set(14, output_transpose);
+
+    std::vector<ncnn::Mat> weights;
+    if (constantA) weights.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (constantB) weights.push_back(transB ? RandomMat(K, N) : RandomMat(N, K));
+
+    std::vector<ncnn::Mat> a;
+    if (!constantA) a.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (!constantB) a.push_back(transB ? RandomMat(K, N) : RandomMat(N, K));
+
+    std::vector<ncnn::Mat> b;
+    int ret = test_layer_naive(ncnn::layer_to_index("Gemm"), pd, weights, a, 1, b, 0, 0);
+    if (ret != 0)
+        return ret;
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_packing_layout = false;
+    opt.use_fp16_storage = false;
+    opt.use_bf16_storage = true;
+
+    ncnn::Layer* op = ncnn::create_layer_cpu("Gemm");
+    op->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+    op->load_model(mb);
+    op->create_pipeline(opt);
+
+    if (!op->support_bf16_storage)
+    {
+        op->destroy_pipeline(opt);
+        delete op;
+        return 0;
+    }
+
+    std::vector<ncnn::Mat> a_bf16(a.size());
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        ncnn::cast_float32_to_bfloat16(a[i], a_bf16[i], opt);
+    }
+
+    std::vector<ncnn::Mat> c(1);
+    op->forward(a_bf16, c, opt);
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    // fp32 output when asked for, bf16 following the input otherwise
+    const int expect_elembits = output_elemtype == 1 ? 32 : 16;
+    if (c[0].elembits() != expect_elembits)
+    {
+        fprintf(stderr, "test_gemm_output_elemtype failed elembits=%d expect=%d output_elemtype=%d\n", c[0].elembits(), expect_elembits, output_elemtype);
+        return -1;
+    }
+
+    ncnn::Mat c_fp32 = c[0];
+    if (c[0].elembits() == 16)
+        ncnn::cast_bfloat16_to_float32(c[0], c_fp32, opt);
+
+    if (CompareMat(b[0], c_fp32, 0.1) != 0)
+    {
+        fprintf(stderr, "test_gemm_output_elemtype failed M=%d N=%d K=%d transA=%d transB=%d output_transpose=%d constantA=%d constantB=%d output_elemtype=%d\n", M, N, K, transA, transB, output_transpose, constantA, constantB, output_elemtype);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_gemm_3(int M, int N, int K)
+{
+    return 0
+           || test_gemm_output_elemtype(M, N, K, 0, 0, 0, 0, 0, 0)
+           || test_gemm_output_elemtype(M, N, K, 0, 1, 0, 0, 1, 1)
+           || test_gemm_output_elemtype(M, N, K, 1, 0, 1, 1, 0, 1)
+           || test_gemm_output_elemtype(M, N, K, 1, 1, 0, 0, 0, 1);
+}
+
+static int test_gemm_fp16s(int M, int N, int K, float alpha, int transA, int transB, int output_transpose, int constantA, int constantB)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, alpha);
+    pd.set(1, 1.f); // beta
+    pd.set(2, transA);
+    pd.set(3, transB);
+    pd.set(4, constantA);
+    pd.set(5, constantB);
+    pd.set(6, 1);
+    pd.set(7, M);
+    pd.set(8, N);
+    pd.set(9, K);
+    pd.set(10, -1);
+    pd.set(14, output_transpose);
+
+    std::vector<ncnn::Mat> weights;
+    if (constantA) weights.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (constantB) weights.push_back(transB ? RandomMat(K, N) : RandomMat(N, K));
+
+    std::vector<ncnn::Mat> a;
+    if (!constantA) a.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (!constantB) a.push_back(transB ? RandomMat(K, N) : RandomMat(N, K));
+
+    // fp16 storage with fp32 arithmetic
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_packing_layout = true;
+    opt.use_fp16_packed = true;
+    opt.use_fp16_storage = true;
+    opt.use_fp16_arithmetic = false;
+    opt.use_bf16_storage = false;
+
+    int ret = test_layer_opt("Gemm", pd, weights, opt, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_gemm_fp16s failed M=%d N=%d K=%d alpha=%f transA=%d transB=%d output_transpose=%d constantA=%d constantB=%d\n", M, N, K, alpha, transA, transB, output_transpose, constantA, constantB);
+    }
+
+    return ret;
+}
+
+static int test_gemm_4(int M, int N, int K)
+{
+    return 0
+           || test_gemm_fp16s(M, N, K, 2.1f, 0, 0, 0, 0, 0)
+           || test_gemm_fp16s(M, N, K, 3.1f, 0, 1, 0, 0, 1)
+           || test_gemm_fp16s(M, N, K, 4.1f, 1, 0, 1, 1, 0)
+           || test_gemm_fp16s(M, N, K, 5.1f, 1, 1, 0, 1, 1);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -286,7 +498,10 @@ int main()
 
         int ret = 0
                   || test_gemm_0(M, N, K)
-                  || test_gemm_1(M, N, K);
+                  || test_gemm_1(M, N, K)
+                  || test_gemm_2(M, N, K)
+                  || test_gemm_3(M, N, K)
+                  || test_gemm_4(M, N, K);
 
         if (ret != 0)
             return ret;
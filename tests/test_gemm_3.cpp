@@ -481,7 +481,9 @@ int main()
         {35, 47, 48},
         {35, 48, 47},
         {40, 40, 40},
-        {47, 48, 47}
+        {47, 48, 47},
+        {48, 33, 132},
+        {64, 52, 260}
     };
 
     int mnk_count = sizeof(mnk) / sizeof(int) / 3;
@@ -246,6 +246,52 @@ static int test_innerproduct_5()
 }
 #endif // NCNN_INT8
 
+static int test_innerproduct_sparse(const ncnn::Mat& a, int outch, int bias, int block_h, float density)
+{
+    const int num_input = a.w * a.h * a.c;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, bias);
+    pd.set(2, outch * num_input);
+
+    int activation_type = RAND() % 7;
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 2 : 1);
+    weights[0] = RandomMat(outch * num_input);
+    Sparsify(weights[0], a.dims == 2 ? a.w : num_input, outch, block_h, density);
+    if (bias)
+        weights[1] = RandomMat(outch);
+
+    int ret = test_layer("InnerProduct", pd, weights, a, 0.001, 0, TEST_LAYER_ENABLE_SPARSE_WEIGHT);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_innerproduct_sparse failed a.dims=%d a=(%d %d %d) outch=%d bias=%d block_h=%d density=%f act=%d actparams=[%f,%f]\n", a.dims, a.w, a.h, a.c, outch, bias, block_h, density, activation_type, activation_params[0], activation_params[1]);
+        return ret;
+    }
+
+    return ret;
+}
+
+static int test_innerproduct_6()
+{
+    return 0
+           || test_innerproduct_sparse(RandomMat(64), 16, 1, 4, 0.25f)
+           || test_innerproduct_sparse(RandomMat(67), 13, 0, 4, 0.15f)
+           || test_innerproduct_sparse(RandomMat(5, 4, 16), 24, 1, 4, 0.2f)
+           || test_innerproduct_sparse(RandomMat(80), 7, 1, 1, 0.1f)
+           || test_innerproduct_sparse(RandomMat(3, 3, 12), 9, 0, 1, 0.15f)
+           || test_innerproduct_sparse(RandomMat(48, 1), 16, 1, 4, 0.25f)
+           || test_innerproduct_sparse(RandomMat(64, 19), 32, 1, 4, 0.25f)
+           || test_innerproduct_sparse(RandomMat(37, 300), 10, 0, 4, 0.15f)
+           || test_innerproduct_sparse(RandomMat(53, 21), 11, 1, 1, 0.1f);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -257,12 +303,14 @@ int main()
            || test_innerproduct_2()
            || test_innerproduct_3()
            || test_innerproduct_4()
-           || test_innerproduct_5();
+           || test_innerproduct_5()
+           || test_innerproduct_6();
 #else
     return 0
            || test_innerproduct_0()
            || test_innerproduct_1()
            || test_innerproduct_2()
-           || test_innerproduct_4();
+           || test_innerproduct_4()
+           || test_innerproduct_6();
 #endif
 }
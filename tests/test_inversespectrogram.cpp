@@ -3,6 +3,8 @@
 
 #include "testutil.h"
 
+#include <math.h>
+
 static int test_inversespectrogram(int frames, int freqs, int n_fft, int returns, int hoplen, int winlen, int window_type, int center, int normalized)
 {
     ncnn::Mat a = RandomMat(2, frames, freqs);
@@ -37,9 +39,78 @@ static int test_inversespectrogram_0()
            || test_inversespectrogram(124, 28, 55, 2, 12, 55, 1, 1, 2);
 }
 
+// compare the complex output of full spectrums against a direct inverse dft in double precision
+static int test_inversespectrogram_dft(int frames, int n_fft)
+{
+    ncnn::Mat a = RandomMat(2, frames, n_fft);
+
+    // non overlapping frames without window, the output is the concatenated inverse dft
+    ncnn::ParamDict pd;
+    pd.set(0, n_fft);
+    pd.set(1, 0);
+    pd.set(2, n_fft);
+    pd.set(5, 0);
+
+    ncnn::Layer* op = ncnn::create_layer("InverseSpectrogram");
+    op->load_param(pd);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    ncnn::Mat b;
+    op->forward(a, b, opt);
+
+    delete op;
+
+    ncnn::Mat ref(2, frames * n_fft);
+    for (int j = 0; j < frames; j++)
+    {
+        for (int i = 0; i < n_fft; i++)
+        {
+            double re = 0.0;
+            double im = 0.0;
+            for (int k = 0; k < n_fft; k++)
+            {
+                const float* ptr = a.channel(k).row(j);
+                double angle = 2 * 3.14159265358979323846 * ((long)i * k % n_fft) / n_fft;
+                re += ptr[0] * cos(angle) - ptr[1] * sin(angle);
+                im += ptr[0] * sin(angle) + ptr[1] * cos(angle);
+            }
+
+            ref.row(j * n_fft + i)[0] = (float)(re / n_fft);
+            ref.row(j * n_fft + i)[1] = (float)(im / n_fft);
+        }
+    }
+
+    int ret = CompareMat(b, ref, 0.001);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_inversespectrogram_dft failed frames=%d n_fft=%d\n", frames, n_fft);
+    }
+
+    return ret;
+}
+
+static int test_inversespectrogram_1()
+{
+    return 0
+           || test_inversespectrogram_dft(5, 1)
+           || test_inversespectrogram_dft(5, 2)
+           || test_inversespectrogram_dft(9, 10)
+           || test_inversespectrogram_dft(9, 17)
+           || test_inversespectrogram_dft(11, 22)
+           || test_inversespectrogram_dft(11, 49)
+           || test_inversespectrogram_dft(13, 55)
+           || test_inversespectrogram_dft(3, 384)
+           || test_inversespectrogram_dft(3, 400)
+           || test_inversespectrogram_dft(3, 512);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_inversespectrogram_0();
+    return 0
+           || test_inversespectrogram_0()
+           || test_inversespectrogram_1();
 }
@@ -359,6 +359,141 @@ static int test_mat_pixel_yuv420sp2rgb(int w, int h)
     return 0;
 }
 
+// scalar reference of every from_pixels convert type
+// channel map entries are source byte indexes, -1 means 255, -2 means gray from the r g b byte indexes
+struct pixel_convert_t
+{
+    int type;
+    int src_c;
+    int dst_c;
+    int map[4];
+};
+
+static int test_mat_pixel_from_convert(int w, int h, int stride_pad)
+{
+    const pixel_convert_t types[] = {
+        {ncnn::Mat::PIXEL_RGB, 3, 3, {0, 1, 2, 0}},
+        {ncnn::Mat::PIXEL_GRAY, 1, 1, {0, 0, 0, 0}},
+        {ncnn::Mat::PIXEL_RGBA, 4, 4, {0, 1, 2, 3}},
+        {ncnn::Mat::PIXEL_RGB2BGR, 3, 3, {2, 1, 0, 0}},
+        {ncnn::Mat::PIXEL_RGB2GRAY, 3, 1, {-2, 0, 1, 2}},
+        {ncnn::Mat::PIXEL_RGB2RGBA, 3, 4, {0, 1, 2, -1}},
+        {ncnn::Mat::PIXEL_BGR2GRAY, 3, 1, {-2, 2, 1, 0}},
+        {ncnn::Mat::PIXEL_BGR2RGBA, 3, 4, {2, 1, 0, -1}},
+        {ncnn::Mat::PIXEL_GRAY2RGB, 1, 3, {0, 0, 0, 0}},
+        {ncnn::Mat::PIXEL_GRAY2RGBA, 1, 4, {0, 0, 0, -1}},
+        {ncnn::Mat::PIXEL_RGBA2RGB, 4, 3, {0, 1, 2, 0}},
+        {ncnn::Mat::PIXEL_RGBA2BGR, 4, 3, {2, 1, 0, 0}},
+        {ncnn::Mat::PIXEL_RGBA2GRAY, 4, 1, {-2, 0, 1, 2}},
+        {ncnn::Mat::PIXEL_RGBA2BGRA, 4, 4, {2, 1, 0, 3}},
+        {ncnn::Mat::PIXEL_BGRA2GRAY, 4, 1, {-2, 2, 1, 0}},
+    };
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        const pixel_convert_t& pc = types[t];
+        const int stride = w * pc.src_c + stride_pad;
+
+        ncnn::Mat a = RandomMat(stride, h, 1);
+        ncnn::Mat m = ncnn::Mat::from_pixels(a, pc.type, w, h, stride);
+
+        for (int q = 0; q < pc.dst_c; q++)
+        {
+            for (int y = 0; y < h; y++)
+            {
+                const unsigned char* p = (const unsigned char*)a + y * stride;
+                const float* ptr = m.channel(q).row(y);
+
+                for (int x = 0; x < w; x++)
+                {
+                    const unsigned char* px = p + x * pc.src_c;
+
+                    float v;
+                    if (pc.map[0] == -2)
+                        v = (float)((px[pc.map[1]] * 77 + px[pc.map[2]] * 150 + px[pc.map[3]] * 29) >> 8);
+                    else if (pc.map[q] == -1)
+                        v = 255.f;
+                    else
+                        v = (float)px[pc.map[q]];
+
+                    if (ptr[x] != v)
+                    {
+                        fprintf(stderr, "test_mat_pixel_from_convert failed w=%d h=%d pixel_type=%d c=%d x=%d y=%d  %f vs %f\n", w, h, pc.type, q, x, y, ptr[x], v);
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// scalar reference of every to_pixels convert type, the float values are out of u8 range and fractional
+static int test_mat_pixel_to_convert(int w, int h, int stride_pad)
+{
+    const pixel_convert_t types[] = {
+        {ncnn::Mat::PIXEL_RGB, 3, 3, {0, 1, 2, 0}},
+        {ncnn::Mat::PIXEL_GRAY, 1, 1, {0, 0, 0, 0}},
+        {ncnn::Mat::PIXEL_RGBA, 4, 4, {0, 1, 2, 3}},
+        {ncnn::Mat::PIXEL_RGB2BGR, 3, 3, {2, 1, 0, 0}},
+        {ncnn::Mat::PIXEL_RGB2RGBA, 3, 4, {0, 1, 2, -1}},
+        {ncnn::Mat::PIXEL_BGR2RGBA, 3, 4, {2, 1, 0, -1}},
+        {ncnn::Mat::PIXEL_GRAY2RGBA, 1, 4, {0, 0, 0, -1}},
+        {ncnn::Mat::PIXEL_RGBA2BGRA, 4, 4, {2, 1, 0, 3}},
+    };
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        const pixel_convert_t& pc = types[t];
+        const int stride = w * pc.dst_c + stride_pad;
+
+        ncnn::Mat m(w, h, pc.src_c);
+        for (int i = 0; i < (int)m.total(); i++)
+        {
+            m[i] = (RAND() % 50000) / 100.f - 100.f;
+        }
+
+        ncnn::Mat b = FilledMat(stride, h, 1, 7);
+        m.to_pixels(b, pc.type, stride);
+
+        for (int y = 0; y < h; y++)
+        {
+            const unsigned char* p = (const unsigned char*)b + y * stride;
+
+            for (int x = 0; x < w; x++)
+            {
+                for (int k = 0; k < pc.dst_c; k++)
+                {
+                    int v = 255;
+                    if (pc.map[k] != -1)
+                    {
+                        v = (int)m.channel(pc.map[k]).row(y)[x];
+                        v = v < 0 ? 0 : v > 255 ? 255 : v;
+                    }
+
+                    if (p[x * pc.dst_c + k] != v)
+                    {
+                        fprintf(stderr, "test_mat_pixel_to_convert failed w=%d h=%d pixel_type=%d x=%d y=%d k=%d  %d vs %d\n", w, h, pc.type, x, y, k, p[x * pc.dst_c + k], v);
+                        return -1;
+                    }
+                }
+            }
+
+            for (int x = w * pc.dst_c; x < stride; x++)
+            {
+                if (p[x] != 7)
+                {
+                    fprintf(stderr, "test_mat_pixel_to_convert failed w=%d h=%d pixel_type=%d stride padding overwritten\n", w, h, pc.type);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
 static int test_mat_pixel_0()
 {
     return 0
@@ -428,6 +563,17 @@ static int test_mat_pixel_6()
            || test_mat_pixel_yuv420sp2rgb(6, 6);
 }
 
+static int test_mat_pixel_7()
+{
+    return 0
+           || test_mat_pixel_from_convert(45, 7, 0)
+           || test_mat_pixel_from_convert(45, 7, 5)
+           || test_mat_pixel_from_convert(3, 2, 1)
+           || test_mat_pixel_to_convert(45, 7, 0)
+           || test_mat_pixel_to_convert(45, 7, 5)
+           || test_mat_pixel_to_convert(3, 2, 1);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -439,5 +585,6 @@ int main()
            || test_mat_pixel_3()
            || test_mat_pixel_4()
            || test_mat_pixel_5()
-           || test_mat_pixel_6();
+           || test_mat_pixel_6()
+           || test_mat_pixel_7();
 }
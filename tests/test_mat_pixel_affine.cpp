@@ -487,9 +487,56 @@ static int test_mat_pixel_affine_1()
            || test_mat_pixel_affine_yuv420sp(220, 340);
 }
 
+static int test_mat_pixel_affine_num_threads(int w, int h, int ch)
+{
+    ncnn::Mat a = RandomMat(w, h, ch);
+
+    float tm[6];
+    ncnn::get_rotation_matrix(20.f, 0.8f, w / 2, h / 2, tm);
+
+    ncnn::Mat b(w, h, 1, (size_t)ch, ch);
+    ncnn::Mat c(w, h, 1, (size_t)ch, ch);
+
+    // the banded warpaffine must match the single threaded one exactly
+    if (ch == 1)
+    {
+        ncnn::warpaffine_bilinear_c1(a, w, h, w, b, w, h, w, tm, 0, 0);
+        ncnn::warpaffine_bilinear_c1(a, w, h, w, c, w, h, w, tm, 0, 0, 4);
+    }
+    if (ch == 2)
+    {
+        ncnn::warpaffine_bilinear_c2(a, w, h, w * 2, b, w, h, w * 2, tm, 0, 0);
+        ncnn::warpaffine_bilinear_c2(a, w, h, w * 2, c, w, h, w * 2, tm, 0, 0, 4);
+    }
+    if (ch == 3)
+    {
+        ncnn::warpaffine_bilinear_c3(a, w, h, w * 3, b, w, h, w * 3, tm, 0, 0);
+        ncnn::warpaffine_bilinear_c3(a, w, h, w * 3, c, w, h, w * 3, tm, 0, 0, 4);
+    }
+    if (ch == 4)
+    {
+        ncnn::warpaffine_bilinear_c4(a, w, h, w * 4, b, w, h, w * 4, tm, 0, 0);
+        ncnn::warpaffine_bilinear_c4(a, w, h, w * 4, c, w, h, w * 4, tm, 0, 0, 4);
+    }
+
+    if (memcmp(b, c, w * h * ch) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_affine_num_threads failed w=%d h=%d ch=%d\n", w, h, ch);
+        return -1;
+    }
+
+    return 0;
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_mat_pixel_affine_0() || test_mat_pixel_affine_1();
+    return 0
+           || test_mat_pixel_affine_0()
+           || test_mat_pixel_affine_1()
+           || test_mat_pixel_affine_num_threads(400, 300, 1)
+           || test_mat_pixel_affine_num_threads(400, 300, 2)
+           || test_mat_pixel_affine_num_threads(301, 257, 3)
+           || test_mat_pixel_affine_num_threads(301, 257, 4);
 }
@@ -0,0 +1,372 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "mat.h"
+#include "prng.h"
+
+#include <math.h>
+#include <string.h>
+
+static struct prng_rand_t g_prng_rand_state;
+#define SRAND(seed) prng_srand(seed, &g_prng_rand_state)
+#define RAND()      prng_rand(&g_prng_rand_state)
+
+static void RandomBytes(unsigned char* p, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        p[i] = RAND() % 256;
+    }
+}
+
+static int get_pixel_type_channels(int format)
+{
+    if (format == ncnn::Mat::PIXEL_GRAY)
+        return 1;
+    if (format == ncnn::Mat::PIXEL_RGBA || format == ncnn::Mat::PIXEL_BGRA)
+        return 4;
+    return 3;
+}
+
+// compare fp32 pack1 mats with an absolute tolerance
+static int CompareAbs(const ncnn::Mat& a, const ncnn::Mat& b, float epsilon)
+{
+    if (a.w != b.w || a.h != b.h || a.c != b.c || a.elemsize != b.elemsize || a.elempack != b.elempack)
+    {
+        fprintf(stderr, "shape not match    expect %d %d %d %d %d but got %d %d %d %d %d\n", a.w, a.h, a.c, (int)a.elemsize, a.elempack, b.w, b.h, b.c, (int)b.elemsize, b.elempack);
+        return -1;
+    }
+
+    for (int q = 0; q < a.c; q++)
+    {
+        for (int i = 0; i < a.h; i++)
+        {
+            const float* pa = a.channel(q).row(i);
+            const float* pb = b.channel(q).row(i);
+            for (int j = 0; j < a.w; j++)
+            {
+                if (fabs(pa[j] - pb[j]) > epsilon)
+                {
+                    fprintf(stderr, "value not match  at c:%d h:%d w:%d    expect %f but got %f\n", q, i, j, pa[j], pb[j]);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_preprocess_resize(int w, int h, int type, int target_width, int target_height, int num_threads)
+{
+    const int channels = get_pixel_type_channels(type & ncnn::Mat::PIXEL_FORMAT_MASK);
+    const int stride = w * channels + 3;
+
+    std::vector<unsigned char> pixels(stride * h);
+    RandomBytes(pixels.data(), stride * h);
+
+    const float mean_vals[4] = {104.f, 117.f, 123.f, 127.f};
+    const float norm_vals[4] = {0.017f, 0.018f, 0.019f, 0.02f};
+
+    ncnn::Mat ref = ncnn::Mat::from_pixels_resize(pixels.data(), type, w, h, stride, target_width, target_height);
+    ref.substract_mean_normalize(mean_vals, norm_vals);
+
+    ncnn::PixelPreprocess pp;
+    pp.target_width = target_width;
+    pp.target_height = target_height;
+    pp.mean_vals = mean_vals;
+    pp.norm_vals = norm_vals;
+    pp.num_threads = num_threads;
+
+    ncnn::Mat m = ncnn::from_pixels_preprocess(pixels.data(), type, w, h, stride, pp);
+
+    // the fixed point resize of the reference rounds to bytes
+    if (CompareAbs(ref, m, 1.5f * 0.02f) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_preprocess_resize failed w=%d h=%d type=0x%x target_width=%d target_height=%d num_threads=%d\n", w, h, type, target_width, target_height, num_threads);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_preprocess_yuv420sp(int w, int h, int nv12, int target_width, int target_height)
+{
+    std::vector<unsigned char> yuv(w * h * 3 / 2);
+    RandomBytes(yuv.data(), (int)yuv.size());
+
+    std::vector<unsigned char> rgb(w * h * 3);
+    if (nv12)
+        ncnn::yuv420sp2rgb_nv12(yuv.data(), w, h, rgb.data());
+    else
+        ncnn::yuv420sp2rgb(yuv.data(), w, h, rgb.data());
+
+    ncnn::Mat ref = ncnn::Mat::from_pixels_resize(rgb.data(), ncnn::Mat::PIXEL_RGB2BGR, w, h, target_width, target_height);
+
+    ncnn::PixelPreprocess pp;
+    pp.target_width = target_width;
+    pp.target_height = target_height;
+
+    const int type = nv12 ? ncnn::Mat::PIXEL_YUV420SP_NV12_2BGR : ncnn::Mat::PIXEL_YUV420SP2BGR;
+    ncnn::Mat m = ncnn::from_pixels_preprocess(yuv.data(), type, w, h, w, pp);
+
+    if (CompareAbs(ref, m, 1.5f) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_preprocess_yuv420sp failed w=%d h=%d nv12=%d target_width=%d target_height=%d\n", w, h, nv12, target_width, target_height);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_preprocess_letterbox(int type, int num_threads)
+{
+    // 64x32 into 32x32 is an exact half scale with 8 border rows on top and bottom
+    const int w = 64;
+    const int h = 32;
+    const int channels = get_pixel_type_channels(type & ncnn::Mat::PIXEL_FORMAT_MASK);
+
+    std::vector<unsigned char> pixels(w * h * channels);
+    RandomBytes(pixels.data(), (int)pixels.size());
+
+    ncnn::Mat ref = ncnn::Mat::from_pixels_resize(pixels.data(), type, w, h, 32, 16);
+
+    ncnn::PixelPreprocess pp;
+    pp.target_width = 32;
+    pp.target_height = 32;
+    pp.set_letterbox(w, h);
+    pp.border_vals[0] = 114.f;
+    pp.border_vals[1] = 115.f;
+    pp.border_vals[2] = 116.f;
+    pp.border_vals[3] = 117.f;
+    pp.num_threads = num_threads;
+
+    ncnn::Mat m = ncnn::from_pixels_preprocess(pixels.data(), type, w, h, w * channels, pp);
+    if (m.w != 32 || m.h != 32 || m.c != ref.c)
+    {
+        fprintf(stderr, "test_mat_pixel_preprocess_letterbox shape failed type=0x%x\n", type);
+        return -1;
+    }
+
+    for (int q = 0; q < m.c; q++)
+    {
+        for (int i = 0; i < 32; i++)
+        {
+            const float* ptr = m.channel(q).row(i);
+            const bool border = i < 8 || i >= 24;
+            const float* pref = border ? 0 : (const float*)ref.channel(q).row(i - 8);
+            for (int j = 0; j < 32; j++)
+            {
+                const float expect = border ? pp.border_vals[q] : pref[j];
+                if (fabs(ptr[j] - expect) > 1.5f)
+                {
+                    fprintf(stderr, "test_mat_pixel_preprocess_letterbox failed type=0x%x at c:%d h:%d w:%d    expect %f but got %f\n", type, q, i, j, expect, ptr[j]);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+#if NCNN_PIXEL_AFFINE
+static int test_mat_pixel_preprocess_warpaffine(int w, int h, int target_width, int target_height)
+{
+    std::vector<unsigned char> pixels(w * h * 3);
+    RandomBytes(pixels.data(), (int)pixels.size());
+
+    float tm[6];
+    ncnn::get_rotation_matrix(23.f, 0.8f, w / 2.f, h / 2.f, tm);
+
+    float tm_inv[6];
+    ncnn::invert_affine_transform(tm, tm_inv);
+
+    std::vector<unsigned char> warped(target_width * target_height * 3);
+    ncnn::warpaffine_bilinear_c3(pixels.data(), w, h, warped.data(), target_width, target_height, tm_inv, 0, 0);
+
+    ncnn::PixelPreprocess pp;
+    pp.target_width = target_width;
+    pp.target_height = target_height;
+    memcpy(pp.tm, tm_inv, 6 * sizeof(float));
+
+    ncnn::Mat m = ncnn::from_pixels_preprocess(pixels.data(), ncnn::Mat::PIXEL_RGB, w, h, w * 3, pp);
+
+    // warpaffine_bilinear samples the border differently, only check the interior
+    int bad = 0;
+    for (int y = 0; y < target_height; y++)
+    {
+        for (int x = 0; x < target_width; x++)
+        {
+            const float fx = tm_inv[0] * x + tm_inv[1] * y + tm_inv[2];
+            const float fy = tm_inv[3] * x + tm_inv[4] * y + tm_inv[5];
+            if (fx < 1.f || fx >= w - 2 || fy < 1.f || fy >= h - 2)
+                continue;
+
+            for (int q = 0; q < 3; q++)
+            {
+                const float v = m.channel(q).row(y)[x];
+                if (fabs(v - warped[(y * target_width + x) * 3 + q]) > 1.5f)
+                    bad++;
+            }
+        }
+    }
+
+    if (bad)
+    {
+        fprintf(stderr, "test_mat_pixel_preprocess_warpaffine failed w=%d h=%d target_width=%d target_height=%d bad=%d\n", w, h, target_width, target_height, bad);
+        return -1;
+    }
+
+    return 0;
+}
+#endif // NCNN_PIXEL_AFFINE
+
+static int test_mat_pixel_preprocess_storage(int type, int elempack, int elembits)
+{
+    const int w = 37;
+    const int h = 29;
+    const int channels = get_pixel_type_channels(type & ncnn::Mat::PIXEL_FORMAT_MASK);
+
+    std::vector<unsigned char> pixels(w * h * channels);
+    RandomBytes(pixels.data(), (int)pixels.size());
+
+    const float mean_vals[4] = {127.5f, 127.5f, 127.5f, 127.5f};
+    const float norm_vals[4] = {1 / 127.5f, 1 / 127.5f, 1 / 127.5f, 1 / 127.5f};
+
+    ncnn::PixelPreprocess pp;
+    pp.target_width = 19;
+    pp.target_height = 23;
+    pp.mean_vals = mean_vals;
+    pp.norm_vals = norm_vals;
+
+    ncnn::Mat ref = ncnn::from_pixels_preprocess(pixels.data(), type, w, h, w * channels, pp);
+
+    pp.elempack = elempack;
+    pp.elembits = elembits;
+    pp.int8_scale = 100.f;
+
+    ncnn::Mat m = ncnn::from_pixels_preprocess(pixels.data(), type, w, h, w * channels, pp);
+
+    if (m.elempack != elempack || (int)m.elemsize != elembits / 8 * elempack || m.c * elempack != ref.c)
+    {
+        fprintf(stderr, "test_mat_pixel_preprocess_storage shape failed type=0x%x elempack=%d elembits=%d\n", type, elempack, elembits);
+        return -1;
+    }
+
+    for (int q = 0; q < ref.c; q++)
+    {
+        const ncnn::Mat mq = m.channel(q / elempack);
+        const int k = q % elempack;
+        for (int i = 0; i < ref.h; i++)
+        {
+            const float* pref = ref.channel(q).row(i);
+            for (int j = 0; j < ref.w; j++)
+            {
+                const int index = (i * ref.w + j) * elempack + k;
+
+                bool ok = true;
+                float got = 0.f;
+                if (elembits == 32)
+                {
+                    got = ((const float*)mq.data)[index];
+                    ok = got == pref[j];
+                }
+                if (elembits == 16)
+                {
+                    got = ncnn::float16_to_float32(((const unsigned short*)mq.data)[index]);
+                    ok = fabs(got - pref[j]) < 0.002f;
+                }
+                if (elembits == 8)
+                {
+                    got = ((const signed char*)mq.data)[index];
+                    int expect = (int)round(pref[j] * 100.f);
+                    expect = std::min(std::max(expect, -127), 127);
+                    ok = (int)got == expect;
+                }
+
+                if (!ok)
+                {
+                    fprintf(stderr, "test_mat_pixel_preprocess_storage failed type=0x%x elempack=%d elembits=%d at c:%d h:%d w:%d    expect %f but got %f\n", type, elempack, elembits, q, i, j, pref[j], got);
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_preprocess_0()
+{
+    const int types[] = {
+        ncnn::Mat::PIXEL_RGB,
+        ncnn::Mat::PIXEL_BGR2RGB,
+        ncnn::Mat::PIXEL_RGB2GRAY,
+        ncnn::Mat::PIXEL_GRAY,
+        ncnn::Mat::PIXEL_GRAY2BGR,
+        ncnn::Mat::PIXEL_RGBA,
+        ncnn::Mat::PIXEL_RGBA2BGR,
+        ncnn::Mat::PIXEL_BGRA2GRAY,
+        ncnn::Mat::PIXEL_RGB2RGBA,
+    };
+
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        int ret = 0
+                  || test_mat_pixel_preprocess_resize(24, 18, types[i], 24, 18, 1)
+                  || test_mat_pixel_preprocess_resize(33, 27, types[i], 15, 11, 1)
+                  || test_mat_pixel_preprocess_resize(13, 17, types[i], 40, 35, 2)
+                  || test_mat_pixel_preprocess_resize(7, 5, types[i], 3, 2, 4)
+                  || test_mat_pixel_preprocess_resize(64, 48, types[i], 17, 31, 3);
+
+        if (ret != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int test_mat_pixel_preprocess_1()
+{
+    return 0
+           || test_mat_pixel_preprocess_yuv420sp(32, 24, 0, 32, 24)
+           || test_mat_pixel_preprocess_yuv420sp(32, 24, 1, 32, 24)
+           || test_mat_pixel_preprocess_yuv420sp(64, 48, 0, 19, 23)
+           || test_mat_pixel_preprocess_yuv420sp(30, 22, 1, 47, 33);
+}
+
+static int test_mat_pixel_preprocess_2()
+{
+    return 0
+           || test_mat_pixel_preprocess_letterbox(ncnn::Mat::PIXEL_RGB, 1)
+           || test_mat_pixel_preprocess_letterbox(ncnn::Mat::PIXEL_BGR2RGB, 3)
+           || test_mat_pixel_preprocess_letterbox(ncnn::Mat::PIXEL_RGBA, 2)
+           || test_mat_pixel_preprocess_letterbox(ncnn::Mat::PIXEL_GRAY, 1)
+#if NCNN_PIXEL_AFFINE
+           || test_mat_pixel_preprocess_warpaffine(40, 30, 36, 28)
+           || test_mat_pixel_preprocess_warpaffine(27, 33, 50, 41)
+#endif // NCNN_PIXEL_AFFINE
+           ;
+}
+
+static int test_mat_pixel_preprocess_3()
+{
+    return 0
+           || test_mat_pixel_preprocess_storage(ncnn::Mat::PIXEL_RGBA, 4, 32)
+           || test_mat_pixel_preprocess_storage(ncnn::Mat::PIXEL_BGR2RGBA, 4, 32)
+           || test_mat_pixel_preprocess_storage(ncnn::Mat::PIXEL_RGB, 1, 16)
+           || test_mat_pixel_preprocess_storage(ncnn::Mat::PIXEL_RGBA, 4, 16)
+           || test_mat_pixel_preprocess_storage(ncnn::Mat::PIXEL_BGR, 1, 8)
+           || test_mat_pixel_preprocess_storage(ncnn::Mat::PIXEL_RGBA, 4, 8);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return test_mat_pixel_preprocess_0()
+           || test_mat_pixel_preprocess_1()
+           || test_mat_pixel_preprocess_2()
+           || test_mat_pixel_preprocess_3();
+}
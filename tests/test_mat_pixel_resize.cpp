@@ -282,6 +282,44 @@ static int test_mat_pixel_roi_resize_bgra(int w, int h, int roix, int roiy, int
     return 0;
 }
 
+static int test_mat_pixel_resize_num_threads(int w, int h, int ch, int target_width, int target_height)
+{
+    ncnn::Mat a = RandomMat(w, h, ch);
+
+    ncnn::Mat b(target_width, target_height, 1, (size_t)ch, ch);
+    ncnn::Mat c(target_width, target_height, 1, (size_t)ch, ch);
+
+    // the banded resize must match the single threaded one exactly
+    if (ch == 1)
+    {
+        ncnn::resize_bilinear_c1(a, w, h, w, b, target_width, target_height, target_width);
+        ncnn::resize_bilinear_c1(a, w, h, w, c, target_width, target_height, target_width, 4);
+    }
+    if (ch == 2)
+    {
+        ncnn::resize_bilinear_c2(a, w, h, w * 2, b, target_width, target_height, target_width * 2);
+        ncnn::resize_bilinear_c2(a, w, h, w * 2, c, target_width, target_height, target_width * 2, 4);
+    }
+    if (ch == 3)
+    {
+        ncnn::resize_bilinear_c3(a, w, h, w * 3, b, target_width, target_height, target_width * 3);
+        ncnn::resize_bilinear_c3(a, w, h, w * 3, c, target_width, target_height, target_width * 3, 4);
+    }
+    if (ch == 4)
+    {
+        ncnn::resize_bilinear_c4(a, w, h, w * 4, b, target_width, target_height, target_width * 4);
+        ncnn::resize_bilinear_c4(a, w, h, w * 4, c, target_width, target_height, target_width * 4, 4);
+    }
+
+    if (memcmp(b, c, target_width * target_height * ch) != 0)
+    {
+        fprintf(stderr, "test_mat_pixel_resize_num_threads failed w=%d h=%d ch=%d target_width=%d target_height=%d\n", w, h, ch, target_width, target_height);
+        return -1;
+    }
+
+    return 0;
+}
+
 static int test_mat_pixel_0()
 {
     for (int c = 1; c <= 4; c++)
@@ -320,9 +358,24 @@ static int test_mat_pixel_2()
            || test_mat_pixel_roi_resize_bgra(15, 15, 7, 3, 1, 1, 1, 1);
 }
 
+static int test_mat_pixel_3()
+{
+    for (int c = 1; c <= 4; c++)
+    {
+        int ret = 0
+                  || test_mat_pixel_resize_num_threads(400, 300, c, 320, 240)
+                  || test_mat_pixel_resize_num_threads(257, 301, c, 511, 263);
+
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_mat_pixel_0() || test_mat_pixel_1() || test_mat_pixel_2();
+    return test_mat_pixel_0() || test_mat_pixel_1() || test_mat_pixel_2() || test_mat_pixel_3();
 }
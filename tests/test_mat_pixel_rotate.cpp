@@ -161,7 +161,11 @@ static int test_mat_pixel_rotate_0()
            || test_mat_pixel_rotate_c1(22, 33)
            || test_mat_pixel_rotate_c2(22, 33)
            || test_mat_pixel_rotate_c3(22, 33)
-           || test_mat_pixel_rotate_c4(22, 33);
+           || test_mat_pixel_rotate_c4(22, 33)
+           || test_mat_pixel_rotate_c1(321, 259)
+           || test_mat_pixel_rotate_c2(321, 259)
+           || test_mat_pixel_rotate_c3(321, 259)
+           || test_mat_pixel_rotate_c4(321, 259);
 }
 
 static int test_mat_pixel_rotate_yuv420sp(int w, int h)
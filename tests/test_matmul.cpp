@@ -43,6 +43,29 @@ static int test_matmul_transb(const ncnn::Mat& a, const ncnn::Mat& b)
     return ret;
 }
 
+static int test_matmul_tile(const ncnn::Mat& a, const ncnn::Mat& b, int TILE_M, int TILE_N, int TILE_K)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, 0); // transB
+    pd.set(20, TILE_M);
+    pd.set(21, TILE_N);
+    pd.set(22, TILE_K);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    std::vector<ncnn::Mat> as(2);
+    as[0] = a;
+    as[1] = b;
+
+    int ret = test_layer("MatMul", pd, weights, as);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_matmul_tile failed a.dims=%d a=(%d %d %d %d) b.dims=%d b=(%d %d %d %d) TILE_M=%d TILE_N=%d TILE_K=%d\n", a.dims, a.w, a.h, a.d, a.c, b.dims, b.w, b.h, b.d, b.c, TILE_M, TILE_N, TILE_K);
+    }
+
+    return ret;
+}
+
 static int test_matmul_0()
 {
     return 0
@@ -219,6 +242,14 @@ static int test_matmul_15()
            || test_matmul_transb(RandomMat(14, 20, 8, 18), RandomMat(14, 9, 8, 18));
 }
 
+static int test_matmul_16()
+{
+    return 0
+           || test_matmul_tile(RandomMat(47, 33), RandomMat(29, 47), 8, 8, 16)
+           || test_matmul_tile(RandomMat(64, 40), RandomMat(36, 64), 16, 32, 0)
+           || test_matmul_tile(RandomMat(31, 19, 3), RandomMat(23, 31, 3), 0, 0, 8);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -239,5 +270,6 @@ int main()
            || test_matmul_12()
            || test_matmul_13()
            || test_matmul_14()
-           || test_matmul_15();
+           || test_matmul_15()
+           || test_matmul_16();
 }
@@ -0,0 +1,182 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+// modelwriter.h brings its own random weight helpers, keep them apart from the testutil ones
+#define RandomFloat modelwriter_RandomFloat
+#define Randomize   modelwriter_Randomize
+#include "../tools/modelwriter.h"
+#undef RandomFloat
+#undef Randomize
+#undef SRAND
+#undef RAND
+
+#include <stdio.h>
+#include <string.h>
+
+static int read_file(const char* path, std::vector<unsigned char>& data)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return -1;
+
+    fseek(fp, 0, SEEK_END);
+    data.resize(ftell(fp));
+    rewind(fp);
+
+    size_t nread = data.empty() ? 0 : fread(&data[0], 1, data.size(), fp);
+    fclose(fp);
+
+    return nread == data.size() ? 0 : -1;
+}
+
+// walk the tagged weights and check the weight data after each tag is aligned
+static int check_weight_align(const std::vector<unsigned char>& model, int weight_align, int storage_type)
+{
+    int weight_sizes[4];
+    int bias_sizes[4];
+    const int n = FireWeightSizes(1, 3, weight_sizes, bias_sizes);
+
+    size_t offset = 0;
+    int padding_count = 0;
+    for (int i = 0; i < n; i++)
+    {
+        unsigned int tag = 0;
+        memcpy(&tag, &model[offset], 4);
+        offset += 4;
+
+        while (tag == 0x00444150)
+        {
+            unsigned int padding_size = 0;
+            memcpy(&padding_size, &model[offset], 4);
+            offset += 4 + padding_size;
+
+            memcpy(&tag, &model[offset], 4);
+            offset += 4;
+            padding_count++;
+        }
+
+        const unsigned int expect_tag = storage_type == 1 ? 0x01306B47 : 0;
+        if (tag != expect_tag || offset % weight_align != 0)
+        {
+            fprintf(stderr, "weight %d tag %x at offset %d not aligned to %d\n", i, tag, (int)offset, weight_align);
+            return -1;
+        }
+
+        offset += alignSize(weight_sizes[i] * (storage_type == 1 ? 2 : 4), 4);
+
+        // bias data is written raw
+        offset += bias_sizes[i] * 4;
+    }
+
+    if (offset != model.size() || padding_count == 0)
+    {
+        fprintf(stderr, "model size %d parsed %d padding records %d\n", (int)model.size(), (int)offset, padding_count);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int extract(ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("fire2/concat", out);
+}
+
+// the weight layout of ncnnoptimize flag 2 (storage_type 0) and flag 3 (storage_type 1)
+static int test_model_mmap(int storage_type, int weight_align)
+{
+    std::string param = FireParam();
+    std::vector<unsigned char> model = FireModel();
+
+    const char* parampath = "test_model_mmap.param";
+    const char* binpath = "test_model_mmap.bin";
+
+    {
+        ModelWriter writer;
+        writer.storage_type = storage_type;
+        writer.weight_align = weight_align;
+
+        const unsigned char* param_mem = (const unsigned char*)param.c_str();
+        ncnn::DataReaderFromMemory param_dr(param_mem);
+        writer.load_param(param_dr);
+
+        const unsigned char* model_mem = &model[0];
+        ncnn::DataReaderFromMemory model_dr(model_mem);
+        writer.load_model(model_dr);
+
+        writer.save(parampath, binpath);
+    }
+
+    int ret = 0;
+
+    std::vector<unsigned char> saved;
+    if (read_file(binpath, saved) != 0 || check_weight_align(saved, weight_align, storage_type) != 0)
+    {
+        fprintf(stderr, "test_model_mmap weight layout failed storage_type=%d weight_align=%d\n", storage_type, weight_align);
+        ret = -1;
+    }
+
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    ncnn::Mat ref;
+    if (ret == 0)
+    {
+        ncnn::Net net;
+        net.opt.use_fp16_storage = false;
+        net.opt.use_bf16_storage = false;
+
+        ret = LoadNet(net, param.c_str(), model);
+        if (ret == 0)
+            ret = extract(net, in, ref);
+    }
+
+    // load the padded model by file, by mapping and from memory
+    const float epsilon = storage_type == 1 ? 0.05f : 0.0001f;
+    for (int i = 0; i < 3 && ret == 0; i++)
+    {
+        ncnn::Net net;
+        net.opt.use_fp16_storage = false;
+        net.opt.use_bf16_storage = false;
+
+        ret = net.load_param(parampath);
+        if (ret == 0)
+        {
+            if (i == 0)
+                ret = net.load_model(binpath);
+            if (i == 1)
+                ret = net.load_model_mmap(binpath);
+            if (i == 2)
+                ret = net.load_model(&saved[0]) == (int)saved.size() ? 0 : -1;
+        }
+
+        ncnn::Mat out;
+        if (ret == 0)
+            ret = extract(net, in, out);
+
+        if (ret != 0 || CompareMat(ref, out, epsilon) != 0)
+        {
+            fprintf(stderr, "test_model_mmap failed storage_type=%d weight_align=%d load=%d\n", storage_type, weight_align, i);
+            ret = -1;
+        }
+    }
+
+    remove(parampath);
+    remove(binpath);
+
+    return ret;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_model_mmap(0, 64)
+           || test_model_mmap(1, 64)
+           || test_model_mmap(0, 32)
+           || test_model_mmap(1, 128);
+}
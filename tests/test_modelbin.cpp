@@ -0,0 +1,140 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "datareader.h"
+#include "modelbin.h"
+#include "testutil.h"
+
+static void append(std::vector<unsigned char>& model, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    model.insert(model.end(), p, p + size);
+}
+
+// encode the weight as block sparse like ncnnoptimize does
+static std::vector<unsigned char> encode_sparse(const ncnn::Mat& m, int block_size)
+{
+    const int w = m.w;
+    const int block_count = (w + block_size - 1) / block_size;
+
+    std::vector<unsigned char> mask(ncnn::alignSize((block_count + 7) / 8, 4), 0x00);
+    std::vector<float> values;
+    for (int i = 0; i < block_count; i++)
+    {
+        bool nonzero = false;
+        for (int j = 0; j < block_size && i * block_size + j < w; j++)
+        {
+            nonzero = nonzero || m[i * block_size + j] != 0.f;
+        }
+        if (!nonzero)
+            continue;
+
+        mask[i / 8] |= 1 << (i % 8);
+        for (int j = 0; j < block_size; j++)
+        {
+            values.push_back(i * block_size + j < w ? m[i * block_size + j] : 0.f);
+        }
+    }
+
+    std::vector<unsigned char> model;
+    const unsigned int tag = 0x00535042;
+    const unsigned int header[2] = {(unsigned int)block_size, (unsigned int)(values.size() / block_size)};
+    append(model, &tag, sizeof(tag));
+    append(model, header, sizeof(header));
+    append(model, mask.data(), mask.size());
+    if (!values.empty())
+        append(model, values.data(), values.size() * sizeof(float));
+
+    return model;
+}
+
+static int test_modelbin_sparse(int w, int block_size, float density)
+{
+    ncnn::Mat m = RandomMat(w);
+    for (int i = 0; i < w; i += block_size)
+    {
+        if (RandomFloat(0.f, 1.f) < density)
+            continue;
+
+        for (int j = i; j < i + block_size && j < w; j++)
+        {
+            m[j] = 0.f;
+        }
+    }
+
+    std::vector<unsigned char> model = encode_sparse(m, block_size);
+
+    // two records back to back
+    std::vector<unsigned char> model2 = model;
+    model2.insert(model2.end(), model.begin(), model.end());
+
+    const unsigned char* mem = model2.data();
+    ncnn::DataReaderFromMemory dr(mem);
+    ncnn::ModelBinFromDataReader mb(dr);
+
+    for (int i = 0; i < 2; i++)
+    {
+        ncnn::Mat m2 = mb.load(w, 0);
+        if (m2.empty() || m2.w != w || memcmp(m2.data, m.data, w * sizeof(float)) != 0)
+        {
+            fprintf(stderr, "test_modelbin_sparse failed w=%d block_size=%d density=%f record=%d\n", w, block_size, density, i);
+            return -1;
+        }
+    }
+
+    if (mem != model2.data() + model2.size())
+    {
+        fprintf(stderr, "test_modelbin_sparse consumed %d of %d bytes w=%d block_size=%d density=%f\n", (int)(mem - model2.data()), (int)model2.size(), w, block_size, density);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_modelbin_0()
+{
+    return 0
+           || test_modelbin_sparse(1, 1, 1.f)
+           || test_modelbin_sparse(7, 1, 0.5f)
+           || test_modelbin_sparse(64, 1, 0.1f)
+           || test_modelbin_sparse(64, 4, 0.3f)
+           || test_modelbin_sparse(67, 4, 0.3f)
+           || test_modelbin_sparse(255, 4, 0.f)
+           || test_modelbin_sparse(1000, 4, 0.2f)
+           || test_modelbin_sparse(1001, 1, 0.05f);
+}
+
+static int test_modelbin_1()
+{
+    // nonzero block count larger than the mask
+    ncnn::Mat m = RandomMat(16);
+    std::vector<unsigned char> model = encode_sparse(m, 4);
+    ((unsigned int*)(model.data() + 4))[1] = 5;
+
+    const unsigned char* mem = model.data();
+    ncnn::DataReaderFromMemory dr(mem);
+    ncnn::ModelBinFromDataReader mb(dr);
+
+    ncnn::Mat m2 = mb.load(16, 0);
+    if (!m2.empty())
+    {
+        fprintf(stderr, "test_modelbin invalid sparse header accepted\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_modelbin_0()
+           || test_modelbin_1();
+}
@@ -121,6 +121,282 @@ static int test_multiheadattention_sameqkv(const ncnn::Mat& a, int embed_dim, in
     return ret;
 }
 
+static int test_multiheadattention_kvcache(const ncnn::Mat& q, int past_seqlen, int embed_dim, int num_heads, int attn_mask)
+{
+    const int qdim = q.w;
+    const int embed_dim_per_head = embed_dim / num_heads;
+
+    ncnn::ParamDict pd;
+    pd.set(0, embed_dim);
+    pd.set(1, num_heads);
+    pd.set(2, embed_dim * qdim);
+    pd.set(3, qdim);
+    pd.set(4, qdim);
+    pd.set(5, attn_mask);
+    pd.set(7, 1);
+
+    std::vector<ncnn::Mat> weights(8);
+    weights[0] = RandomMat(embed_dim * qdim);
+    weights[1] = RandomMat(embed_dim);
+    weights[2] = RandomMat(embed_dim * qdim);
+    weights[3] = RandomMat(embed_dim);
+    weights[4] = RandomMat(embed_dim * qdim);
+    weights[5] = RandomMat(embed_dim);
+    weights[6] = RandomMat(qdim * embed_dim);
+    weights[7] = RandomMat(qdim);
+
+    std::vector<ncnn::Mat> as(1);
+    as[0] = q;
+
+    if (attn_mask)
+    {
+        as.push_back(RandomMat(past_seqlen + q.h, q.h));
+    }
+
+    as.push_back(past_seqlen ? RandomMat(embed_dim_per_head, past_seqlen, num_heads) : ncnn::Mat());
+    as.push_back(past_seqlen ? RandomMat(embed_dim_per_head, past_seqlen, num_heads) : ncnn::Mat());
+
+    float epsilon = 0.005;
+
+    int ret = test_layer("MultiHeadAttention", pd, weights, as, 3, epsilon);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_multiheadattention_kvcache failed q=(%d %d) past_seqlen=%d embed_dim=%d num_heads=%d attn_mask=%d\n", q.w, q.h, past_seqlen, embed_dim, num_heads, attn_mask);
+    }
+
+    return ret;
+}
+
+static int test_multiheadattention_kvcache_decode(int qdim, int embed_dim, int num_heads, int seqlen, int kv_cache)
+{
+    // decoding token by token with the cache must match attending over the whole sequence at once
+    ncnn::ParamDict pd;
+    pd.set(0, embed_dim);
+    pd.set(1, num_heads);
+    pd.set(2, embed_dim * qdim);
+    pd.set(3, qdim);
+    pd.set(4, qdim);
+
+    std::vector<ncnn::Mat> weights(8);
+    weights[0] = RandomMat(embed_dim * qdim);
+    weights[1] = RandomMat(embed_dim);
+    weights[2] = RandomMat(embed_dim * qdim);
+    weights[3] = RandomMat(embed_dim);
+    weights[4] = RandomMat(embed_dim * qdim);
+    weights[5] = RandomMat(embed_dim);
+    weights[6] = RandomMat(qdim * embed_dim);
+    weights[7] = RandomMat(qdim);
+
+    ncnn::Mat x = RandomMat(qdim, seqlen);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_packing_layout = false;
+
+    ncnn::Layer* op = ncnn::create_layer_cpu("MultiHeadAttention");
+    op->load_param(pd);
+    op->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+    op->create_pipeline(opt);
+
+    // the last row attends to every token
+    std::vector<ncnn::Mat> full_outputs(1);
+    {
+        std::vector<ncnn::Mat> inputs(3);
+        inputs[0] = x;
+        inputs[1] = x;
+        inputs[2] = x;
+        op->forward(inputs, full_outputs, opt);
+    }
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    pd.set(7, kv_cache);
+
+    op = ncnn::create_layer_cpu("MultiHeadAttention");
+    op->load_param(pd);
+    op->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+    op->create_pipeline(opt);
+
+    ncnn::Mat cache_k;
+    ncnn::Mat cache_v;
+    ncnn::Mat last;
+    for (int i = 0; i < seqlen; i++)
+    {
+        std::vector<ncnn::Mat> inputs(5);
+        inputs[0] = x.row_range(i, 1);
+        inputs[1] = inputs[0];
+        inputs[2] = inputs[0];
+        inputs[3] = cache_k;
+        inputs[4] = cache_v;
+
+        std::vector<ncnn::Mat> outputs(3);
+        op->forward(inputs, outputs, opt);
+
+        last = outputs[0];
+        cache_k = outputs[1];
+        cache_v = outputs[2];
+    }
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    int ret = 0;
+    if (cache_k.h != seqlen || cache_v.h != seqlen)
+    {
+        fprintf(stderr, "cache seqlen %d %d expect %d\n", cache_k.h, cache_v.h, seqlen);
+        ret = -1;
+    }
+    else
+    {
+        ret = CompareMat(last, full_outputs[0].row_range(seqlen - 1, 1).clone(), 0.001);
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_multiheadattention_kvcache_decode failed qdim=%d embed_dim=%d num_heads=%d seqlen=%d kv_cache=%d\n", qdim, embed_dim, num_heads, seqlen, kv_cache);
+    }
+
+    return ret;
+}
+
+static ncnn::Mat concat_rows(const ncnn::Mat& a, const ncnn::Mat& b)
+{
+    ncnn::Mat c(a.w, a.h + b.h);
+    memcpy(c.row(0), a, a.w * a.h * sizeof(float));
+    memcpy(c.row(a.h), b, b.w * b.h * sizeof(float));
+    return c;
+}
+
+// the last output row of attending over the whole sequence at once
+static ncnn::Mat attention_last_row(const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Mat& x, const ncnn::Option& opt)
+{
+    ncnn::Layer* op = ncnn::create_layer_cpu("MultiHeadAttention");
+    op->load_param(pd);
+    op->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+    op->create_pipeline(opt);
+
+    std::vector<ncnn::Mat> inputs(3);
+    inputs[0] = x;
+    inputs[1] = x;
+    inputs[2] = x;
+
+    std::vector<ncnn::Mat> outputs(1);
+    op->forward(inputs, outputs, opt);
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    return outputs[0].row_range(x.h - 1, 1).clone();
+}
+
+static int test_multiheadattention_kvcache_branch(int qdim, int embed_dim, int num_heads, int seqlen)
+{
+    // continuing one past with two different tokens must not let one branch overwrite the other
+    ncnn::ParamDict pd;
+    pd.set(0, embed_dim);
+    pd.set(1, num_heads);
+    pd.set(2, embed_dim * qdim);
+    pd.set(3, qdim);
+    pd.set(4, qdim);
+
+    std::vector<ncnn::Mat> weights(8);
+    weights[0] = RandomMat(embed_dim * qdim);
+    weights[1] = RandomMat(embed_dim);
+    weights[2] = RandomMat(embed_dim * qdim);
+    weights[3] = RandomMat(embed_dim);
+    weights[4] = RandomMat(embed_dim * qdim);
+    weights[5] = RandomMat(embed_dim);
+    weights[6] = RandomMat(qdim * embed_dim);
+    weights[7] = RandomMat(qdim);
+
+    ncnn::Mat x = RandomMat(qdim, seqlen);
+    ncnn::Mat xa = RandomMat(qdim, 1);
+    ncnn::Mat xb = RandomMat(qdim, 1);
+    ncnn::Mat xc = RandomMat(qdim, 1);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_packing_layout = false;
+
+    ncnn::Mat ref_a = attention_last_row(pd, weights, concat_rows(x, xa), opt);
+    ncnn::Mat ref_b = attention_last_row(pd, weights, concat_rows(x, xb), opt);
+    ncnn::Mat ref_ac = attention_last_row(pd, weights, concat_rows(concat_rows(x, xa), xc), opt);
+    ncnn::Mat ref_bc = attention_last_row(pd, weights, concat_rows(concat_rows(x, xb), xc), opt);
+
+    pd.set(7, 1);
+
+    ncnn::Layer* op = ncnn::create_layer_cpu("MultiHeadAttention");
+    op->load_param(pd);
+    op->load_model(ncnn::ModelBinFromMatArray(weights.data()));
+    op->create_pipeline(opt);
+
+    std::vector<ncnn::Mat> prefill(3);
+    std::vector<ncnn::Mat> branch_a(3);
+    std::vector<ncnn::Mat> branch_b(3);
+    std::vector<ncnn::Mat> branch_ac(3);
+    std::vector<ncnn::Mat> branch_bc(3);
+    {
+        std::vector<ncnn::Mat> inputs(5);
+        inputs[0] = x;
+        inputs[1] = x;
+        inputs[2] = x;
+        op->forward(inputs, prefill, opt);
+    }
+    {
+        std::vector<ncnn::Mat> inputs(5);
+        inputs[0] = xa;
+        inputs[1] = xa;
+        inputs[2] = xa;
+        inputs[3] = prefill[1];
+        inputs[4] = prefill[2];
+        op->forward(inputs, branch_a, opt);
+    }
+    {
+        std::vector<ncnn::Mat> inputs(5);
+        inputs[0] = xb;
+        inputs[1] = xb;
+        inputs[2] = xb;
+        inputs[3] = prefill[1];
+        inputs[4] = prefill[2];
+        op->forward(inputs, branch_b, opt);
+    }
+    {
+        std::vector<ncnn::Mat> inputs(5);
+        inputs[0] = xc;
+        inputs[1] = xc;
+        inputs[2] = xc;
+        inputs[3] = branch_a[1];
+        inputs[4] = branch_a[2];
+        op->forward(inputs, branch_ac, opt);
+    }
+    {
+        std::vector<ncnn::Mat> inputs(5);
+        inputs[0] = xc;
+        inputs[1] = xc;
+        inputs[2] = xc;
+        inputs[3] = branch_b[1];
+        inputs[4] = branch_b[2];
+        op->forward(inputs, branch_bc, opt);
+    }
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    int ret = 0
+              || CompareMat(branch_a[0], ref_a, 0.001)
+              || CompareMat(branch_b[0], ref_b, 0.001)
+              || CompareMat(branch_ac[0], ref_ac, 0.001)
+              || CompareMat(branch_bc[0], ref_bc, 0.001);
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_multiheadattention_kvcache_branch failed qdim=%d embed_dim=%d num_heads=%d seqlen=%d\n", qdim, embed_dim, num_heads, seqlen);
+    }
+
+    return ret;
+}
+
 static int test_multiheadattention_0()
 {
     return 0
@@ -152,6 +428,32 @@ static int test_multiheadattention_2()
            || test_multiheadattention_sameqkv(RandomMat(48, 127), 64, 8);
 }
 
+static int test_multiheadattention_3()
+{
+    return 0
+           || test_multiheadattention_kvcache(RandomMat(64, 7), 0, 64, 4, 0)
+           || test_multiheadattention_kvcache(RandomMat(64, 1), 23, 64, 4, 0)
+           || test_multiheadattention_kvcache(RandomMat(48, 3), 16, 64, 8, 1)
+           || test_multiheadattention_kvcache(RandomMat(12, 1), 31, 12, 3, 1)
+           || test_multiheadattention_kvcache_decode(32, 32, 4, 37, 1)
+           || test_multiheadattention_kvcache_decode(20, 24, 3, 18, 1)
+           || test_multiheadattention_kvcache_decode(32, 32, 4, 37, 2)
+           || test_multiheadattention_kvcache_branch(32, 32, 4, 5)
+           || test_multiheadattention_kvcache_branch(20, 24, 3, 18);
+}
+
+static int test_multiheadattention_4()
+{
+    return 0
+           || test_multiheadattention(RandomMat(32, 300), RandomMat(24, 300), RandomMat(20, 300), 32, 2, 0)
+           || test_multiheadattention(RandomMat(24, 257), RandomMat(16, 333), RandomMat(28, 333), 48, 4, 1)
+           || test_multiheadattention(RandomMat(12, 17), RandomMat(20, 256), RandomMat(16, 256), 12, 3, 1)
+           || test_multiheadattention_samekv(RandomMat(20, 65), RandomMat(32, 290), 40, 2)
+           || test_multiheadattention_sameqkv(RandomMat(36, 271), 36, 3)
+           || test_multiheadattention_kvcache(RandomMat(32, 17), 260, 32, 2, 1)
+           || test_multiheadattention_kvcache(RandomMat(24, 40), 231, 24, 4, 0);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -159,5 +461,7 @@ int main()
     return 0
            || test_multiheadattention_0()
            || test_multiheadattention_1()
-           || test_multiheadattention_2();
+           || test_multiheadattention_2()
+           || test_multiheadattention_3()
+           || test_multiheadattention_4();
 }
@@ -0,0 +1,98 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "net.h"
+#include "testutil.h"
+
+static int extract(const ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out, int node)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    if (node >= 0)
+        ex.set_numa_node(node);
+
+    ex.input("data", in);
+    return ex.extract("prob", out);
+}
+
+static int test_numa(const ncnn::Option& _opt)
+{
+    std::vector<unsigned char> model = FireModel();
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    ncnn::Option opt = _opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+
+    ncnn::Mat ref;
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        if (LoadNet(net, FireParam().c_str(), model) != 0 || extract(net, in, ref, -1) != 0)
+            return -1;
+    }
+
+    // two fake numa nodes sharing cpu 0
+    ncnn::set_numa_topology_override("0;0");
+
+    int ret = 0;
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        net.opt.use_numa_replica = true;
+        ret = LoadNet(net, FireParam().c_str(), model);
+
+        if (ret == 0 && (ncnn::get_numa_node_count() != 2 || net.numa_replica_size() == 0))
+        {
+            fprintf(stderr, "numa node count %d replica size %d\n", ncnn::get_numa_node_count(), (int)net.numa_replica_size());
+            ret = -1;
+        }
+
+        // extractors take the nodes in turn, then each node explicitly
+        const int nodes[4] = {-1, -1, 1, 0};
+        for (int i = 0; i < 4 && ret == 0; i++)
+        {
+            ncnn::Mat out;
+            if (extract(net, in, out, nodes[i]) != 0 || CompareMat(ref, out, 0.001) != 0)
+            {
+                fprintf(stderr, "numa extract %d node %d mismatch\n", i, nodes[i]);
+                ret = -1;
+            }
+        }
+    }
+
+    ncnn::set_numa_topology_override(0);
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_numa failed use_packing_layout=%d use_fp16_storage=%d\n", opt.use_packing_layout, opt.use_fp16_storage);
+    }
+
+    return ret;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[2];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_packed = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_packed = true;
+    opts[1].use_fp16_storage = true;
+    opts[1].use_bf16_storage = true;
+
+    for (int i = 0; i < 2; i++)
+    {
+        int ret = test_numa(opts[i]);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
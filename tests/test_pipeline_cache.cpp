@@ -0,0 +1,118 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+
+#include <stdio.h>
+
+static int load_net(ncnn::Net& net, int expand_kernel, const std::vector<unsigned char>& model, const char* cachepath)
+{
+    // fire module, the expand3x3 kernel size changes the weight shape
+    std::string param = FireParam(1, expand_kernel);
+
+    const unsigned char* param_mem = (const unsigned char*)param.c_str();
+    ncnn::DataReaderFromMemory param_dr(param_mem);
+    if (net.load_param(param_dr) != 0)
+        return -1;
+
+    if (cachepath && net.load_pipeline_cache(cachepath) != 0)
+        return -1;
+
+    const unsigned char* model_mem = &model[0];
+    ncnn::DataReaderFromMemory model_dr(model_mem);
+    if (net.load_model(model_dr) != 0)
+        return -1;
+
+    return 0;
+}
+
+static int extract(const ncnn::Option& opt, int expand_kernel, const std::vector<unsigned char>& model, const char* cachepath, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Net net;
+    net.opt = opt;
+    if (load_net(net, expand_kernel, model, cachepath) != 0)
+        return -1;
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("fire2/concat", out);
+}
+
+static int test_pipeline_cache(const ncnn::Option& _opt)
+{
+    ncnn::Option opt = _opt;
+    opt.use_vulkan_compute = false;
+
+    const char* cachepath = "test_pipeline_cache.cache";
+
+    std::vector<unsigned char> model = FireModel(1, 3);
+    std::vector<unsigned char> model_retrained = FireModel(1, 3);
+    std::vector<unsigned char> model_kernel1 = FireModel(1, 1);
+
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        if (load_net(net, 3, model, 0) != 0 || net.save_pipeline_cache(cachepath) != 0)
+        {
+            fprintf(stderr, "save_pipeline_cache failed\n");
+            return -1;
+        }
+    }
+
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    int ret = 0;
+
+    // the same model reuses the cache
+    // the retrained weights and the changed kernel size refuse it and transform the weights again
+    const int expand_kernels[3] = {3, 3, 1};
+    const std::vector<unsigned char>* models[3] = {&model, &model_retrained, &model_kernel1};
+    for (int i = 0; i < 3 && ret == 0; i++)
+    {
+        ncnn::Mat ref;
+        ncnn::Mat out;
+        ret = extract(opt, expand_kernels[i], *models[i], 0, in, ref);
+        if (ret == 0)
+            ret = extract(opt, expand_kernels[i], *models[i], cachepath, in, out);
+
+        if (ret != 0 || CompareMat(ref, out, 0.001) != 0)
+        {
+            fprintf(stderr, "test_pipeline_cache failed model=%d use_packing_layout=%d use_winograd_convolution=%d\n", i, opt.use_packing_layout, opt.use_winograd_convolution);
+            ret = -1;
+        }
+    }
+
+    remove(cachepath);
+
+    return ret;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_storage = false;
+    opts[1].use_bf16_storage = false;
+
+    opts[2].use_packing_layout = true;
+    opts[2].use_winograd_convolution = false;
+    opts[2].use_sgemm_convolution = false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        int ret = test_pipeline_cache(opts[i]);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "profiler.h"
+#include "testutil.h"
+
+static int check_records(const ncnn::Net& net, const std::vector<ncnn::LayerProfile>& records)
+{
+    // every layer but the input runs exactly once
+    const std::vector<ncnn::Layer*>& layers = net.layers();
+    if (records.size() != layers.size() - 1)
+    {
+        fprintf(stderr, "profiler records %d layers %d\n", (int)records.size(), (int)layers.size());
+        return -1;
+    }
+
+    std::vector<int> layer_counts(layers.size(), 0);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const ncnn::LayerProfile& r = records[i];
+        if (r.layer_index < 0 || r.layer_index >= (int)layers.size() || layer_counts[r.layer_index]++ != 0)
+        {
+            fprintf(stderr, "profiler record %d has bad layer index %d\n", (int)i, r.layer_index);
+            return -1;
+        }
+
+        const ncnn::Layer* layer = layers[r.layer_index];
+        if (r.end < r.start || r.bottom_shapes.size() != layer->bottoms.size() || r.top_shapes.size() != layer->tops.size() || r.top_bytes == 0)
+        {
+            fprintf(stderr, "profiler record %s is malformed\n", layer->name.c_str());
+            return -1;
+        }
+
+        if (r.type != layer->type || r.name != layer->name)
+        {
+            fprintf(stderr, "profiler record %s mismatch %s\n", r.name.c_str(), layer->name.c_str());
+            return -1;
+        }
+    }
+
+    const ncnn::LayerProfile& last = records.back();
+    if (last.name != "prob" || last.top_shapes[0].w != 10)
+    {
+        fprintf(stderr, "profiler last record %s top w %d\n", last.name.c_str(), last.top_shapes[0].w);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_profiler(const ncnn::Option& opt)
+{
+    std::vector<unsigned char> model = FireModel(2);
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    ncnn::Net net;
+    net.opt = opt;
+
+    // two fire modules, the expand branches of each are independent
+    if (LoadNet(net, FireParam(2).c_str(), model) != 0)
+        return -1;
+
+    ncnn::Mat ref;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", in);
+        ex.extract("prob", ref);
+    }
+
+    ncnn::Profiler profiler;
+
+    ncnn::Mat out;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_profiler(&profiler);
+
+        ex.input("data", in);
+        ex.extract("prob", out);
+    }
+
+    // profiling does not change the result
+    if (CompareMat(ref, out, 0.001) != 0)
+    {
+        fprintf(stderr, "profiled output mismatch\n");
+        return -1;
+    }
+
+    const std::vector<ncnn::LayerProfile> records = profiler.records();
+    if (check_records(net, records) != 0)
+        return -1;
+
+    // detached profiler records nothing
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_profiler(0);
+
+        ex.input("data", in);
+        ex.extract("prob", out);
+    }
+
+    if (profiler.records().size() != records.size())
+    {
+        fprintf(stderr, "profiler recorded when detached\n");
+        return -1;
+    }
+
+    const char* tracepath = "test_profiler.trace.json";
+    const char* csvpath = "test_profiler.profile.csv";
+
+    int ret = profiler.save_chrome_trace(tracepath) != 0 || profiler.save_csv(csvpath) != 0 ? -1 : 0;
+
+    remove(tracepath);
+    remove(csvpath);
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "profiler save failed\n");
+        return -1;
+    }
+
+    profiler.clear();
+    if (!profiler.records().empty())
+    {
+        fprintf(stderr, "profiler clear failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    for (int i = 0; i < 2; i++)
+    {
+        ncnn::Option opt;
+        opt.num_threads = 4;
+        opt.use_branch_parallel = i == 1;
+        opt.use_vulkan_compute = false;
+
+        int ret = test_profiler(opt);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_profiler failed use_branch_parallel=%d\n", opt.use_branch_parallel);
+            return ret;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "simpleomp.h"
+#include "threadpool.h"
+
+#include <stdio.h>
+#include <vector>
+
+// each index records its value and the thread_num share it ran in
+// the share of thread_num 1 is slowed down so that the other threads claim the pending ones
+static void run_loop(int n, int num_threads, std::vector<int>& values, std::vector<int>& thread_nums)
+{
+    values.assign(n, 0);
+    thread_nums.assign(n, -1);
+
+    int* pvalues = &values[0];
+    int* pthread_nums = &thread_nums[0];
+
+    #pragma omp parallel for num_threads(num_threads)
+    for (int i = 0; i < n; i++)
+    {
+        const int thread_num = omp_get_thread_num();
+
+        if (thread_num == 1)
+        {
+            volatile int spin = 0;
+            for (int j = 0; j < 20000; j++)
+                spin = spin + j;
+        }
+
+        pvalues[i] += i * 3 + 1;
+        pthread_nums[i] = thread_num;
+    }
+}
+
+static int test_simpleomp(int n, int num_threads)
+{
+    // a private team has num_threads workers regardless of the cpu count
+    ncnn::ThreadPool thread_pool(num_threads);
+    ncnn::set_current_thread_pool(&thread_pool);
+
+    std::vector<int> values_ref;
+    std::vector<int> thread_nums_ref;
+
+    ncnn::set_kmp_work_stealing(0);
+    run_loop(n, num_threads, values_ref, thread_nums_ref);
+
+    const int thread_num_ref = omp_get_thread_num();
+
+    std::vector<int> values;
+    std::vector<int> thread_nums;
+
+    ncnn::set_kmp_work_stealing(1);
+    run_loop(n, num_threads, values, thread_nums);
+    ncnn::set_kmp_work_stealing(0);
+
+    const int thread_num = omp_get_thread_num();
+
+    ncnn::set_current_thread_pool(0);
+
+    for (int i = 0; i < n; i++)
+    {
+        // every index runs exactly once in the same share as without stealing
+        if (values_ref[i] != i * 3 + 1 || values[i] != values_ref[i] || thread_nums[i] != thread_nums_ref[i])
+        {
+            fprintf(stderr, "test_simpleomp failed n=%d num_threads=%d at %d value %d %d thread_num %d %d\n", n, num_threads, i, values_ref[i], values[i], thread_nums_ref[i], thread_nums[i]);
+            return -1;
+        }
+    }
+
+    // the shares claimed by the calling thread do not leak out of the parallel region
+    if (thread_num != thread_num_ref)
+    {
+        fprintf(stderr, "test_simpleomp failed n=%d num_threads=%d stale thread_num %d expect %d\n", n, num_threads, thread_num, thread_num_ref);
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    // uneven chunk counts, fewer items than threads and more threads than cpus
+    const int ns[6] = {1, 3, 7, 64, 97, 1001};
+    const int num_threads[5] = {2, 3, 4, 5, 8};
+
+    for (int i = 0; i < 6; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            for (int k = 0; k < 10; k++)
+            {
+                int ret = test_simpleomp(ns[i], num_threads[j]);
+                if (ret != 0)
+                    return ret;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -3,6 +3,8 @@
 
 #include "testutil.h"
 
+#include <math.h>
+
 static int test_spectrogram(int size, int n_fft, int power, int hoplen, int winlen, int window_type, int center, int pad_type, int normalized, int onesided)
 {
     ncnn::Mat a = RandomMat(size);
@@ -39,9 +41,81 @@ static int test_spectrogram_0()
            || test_spectrogram(124, 55, 2, 12, 55, 1, 1, 2, 2, 0);
 }
 
+// compare the complex onesided output against a direct dft in double precision
+static int test_spectrogram_dft(int size, int n_fft, int hoplen)
+{
+    ncnn::Mat a = RandomMat(size);
+
+    ncnn::ParamDict pd;
+    pd.set(0, n_fft);
+    pd.set(1, 0);
+    pd.set(2, hoplen);
+    pd.set(5, 0);
+
+    ncnn::Layer* op = ncnn::create_layer("Spectrogram");
+    op->load_param(pd);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    ncnn::Mat b;
+    op->forward(a, b, opt);
+
+    delete op;
+
+    const int frames = (size - n_fft) / hoplen + 1;
+    const int freqs = n_fft / 2 + 1;
+
+    ncnn::Mat ref(2, frames, freqs);
+    for (int i = 0; i < freqs; i++)
+    {
+        for (int j = 0; j < frames; j++)
+        {
+            const float* ptr = (const float*)a + j * hoplen;
+
+            double re = 0.0;
+            double im = 0.0;
+            for (int k = 0; k < n_fft; k++)
+            {
+                double angle = 2 * 3.14159265358979323846 * ((long)i * k % n_fft) / n_fft;
+                re += ptr[k] * cos(angle);
+                im -= ptr[k] * sin(angle);
+            }
+
+            ref.channel(i).row(j)[0] = (float)re;
+            ref.channel(i).row(j)[1] = (float)im;
+        }
+    }
+
+    int ret = CompareMat(b, ref, 0.001);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_spectrogram_dft failed size=%d n_fft=%d hoplen=%d\n", size, n_fft, hoplen);
+    }
+
+    return ret;
+}
+
+static int test_spectrogram_1()
+{
+    return 0
+           || test_spectrogram_dft(64, 1, 3)
+           || test_spectrogram_dft(64, 2, 3)
+           || test_spectrogram_dft(99, 10, 5)
+           || test_spectrogram_dft(99, 17, 9)
+           || test_spectrogram_dft(200, 22, 11)
+           || test_spectrogram_dft(200, 49, 13)
+           || test_spectrogram_dft(300, 55, 20)
+           || test_spectrogram_dft(1200, 384, 96)
+           || test_spectrogram_dft(1200, 400, 160)
+           || test_spectrogram_dft(1200, 512, 128);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_spectrogram_0();
+    return 0
+           || test_spectrogram_0()
+           || test_spectrogram_1();
 }
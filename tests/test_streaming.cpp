@@ -0,0 +1,316 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "testutil.h"
+
+#include <string.h>
+
+// slice frames [start, end) along w, or along h for 3d mats
+static ncnn::Mat slice_frames(const ncnn::Mat& m, int axis, int start, int end)
+{
+    ncnn::Mat out;
+    if (m.dims == 3)
+    {
+        out.create(m.w, end - start, m.c);
+        for (int q = 0; q < m.c; q++)
+        {
+            memcpy(out.channel(q), m.channel(q).row(start), m.w * (end - start) * sizeof(float));
+        }
+    }
+    else if (axis == 0)
+    {
+        out.create(end - start, m.h);
+        for (int i = 0; i < m.h; i++)
+        {
+            memcpy(out.row(i), m.row(i) + start, (end - start) * sizeof(float));
+        }
+    }
+    else
+    {
+        out = m.row_range(start, end - start).clone();
+    }
+
+    return out;
+}
+
+static int frame_count(const ncnn::Mat& m, int axis)
+{
+    if (m.empty())
+        return 0;
+
+    if (m.dims == 3 || axis == 1)
+        return m.h;
+
+    return m.w;
+}
+
+// feed the input in chunks of chunk_size frames and compare with the output of the whole input
+// frames of the input run along w, frames of the output along w (axis 0) or h (axis 1)
+static int test_streaming(const char* param, const std::vector<unsigned char>& model, const ncnn::Mat& in, int chunk_size, int axis, const ncnn::Option& opt)
+{
+    ncnn::Net net;
+    net.opt = opt;
+    if (LoadNet(net, param, model) != 0)
+    {
+        fprintf(stderr, "LoadNet failed\n");
+        return -1;
+    }
+
+    ncnn::Mat ref;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("in", in);
+        ex.extract("out", ref);
+    }
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.set_streaming(true);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int outpos = 0;
+        for (int i = 0; i < in.w; i += chunk_size)
+        {
+            ncnn::Mat chunk = in.dims == 1 ? in.range(i, chunk_size).clone() : slice_frames(in, 0, i, i + chunk_size);
+
+            ex.input("in", chunk);
+
+            ncnn::Mat out;
+            int ret = ex.extract("out", out);
+            if (ret != 0)
+            {
+                fprintf(stderr, "extract failed at chunk %d\n", i / chunk_size);
+                return -1;
+            }
+
+            const int outsize = frame_count(out, axis);
+            if (outsize == 0)
+                continue;
+
+            if (outpos + outsize > frame_count(ref, axis))
+            {
+                fprintf(stderr, "too many frames %d + %d > %d\n", outpos, outsize, frame_count(ref, axis));
+                return -1;
+            }
+
+            if (CompareMat(out, slice_frames(ref, axis, outpos, outpos + outsize), 0.001) != 0)
+            {
+                fprintf(stderr, "chunk %d frames %d..%d mismatch\n", i / chunk_size, outpos, outpos + outsize);
+                return -1;
+            }
+
+            outpos += outsize;
+        }
+
+        // at most the frames of the right padding are not streamed out
+        if (outpos == 0 || outpos + 8 < frame_count(ref, axis))
+        {
+            fprintf(stderr, "streamed %d of %d frames\n", outpos, frame_count(ref, axis));
+            return -1;
+        }
+
+        // the second pass starts a new stream
+        ex.reset_streaming();
+    }
+
+    return 0;
+}
+
+static int test_streaming_0(const ncnn::Option& opt)
+{
+    // causal conv, dilated strided depthwise conv with odd padding, avgpool, then recurrent layers over time
+    const char param[] = "7767517\n"
+                         "8 8\n"
+                         "Input                  in    0 1 in\n"
+                         "Convolution1D          conv  1 1 in c1 0=16 1=3 3=1 4=2 15=0 5=1 6=192 9=1\n"
+                         "ConvolutionDepthWise1D dw    1 1 c1 c2 0=16 1=5 2=2 3=2 4=3 5=1 6=80 7=16\n"
+                         "Pooling1D              pool  1 1 c2 p1 0=1 1=2 2=1 3=1 14=0 5=1\n"
+                         "Permute                perm  1 1 p1 t1 0=1\n"
+                         "LSTM                   lstm  1 1 t1 l1 0=12 1=768 2=0 3=12\n"
+                         "GRU                    gru   1 1 l1 g1 0=10 1=360 2=0\n"
+                         "RNN                    rnn   1 1 g1 out 0=6 1=60 2=0\n";
+
+    std::vector<unsigned char> model;
+    AppendWeight(model, 192, 0);
+    AppendWeight(model, 16, 1);
+    AppendWeight(model, 80, 0);
+    AppendWeight(model, 16, 1);
+    AppendWeight(model, 16 * 48, 0);
+    AppendWeight(model, 48, 0);
+    AppendWeight(model, 12 * 48, 0);
+    AppendWeight(model, 12 * 30, 0);
+    AppendWeight(model, 40, 0);
+    AppendWeight(model, 10 * 30, 0);
+    AppendWeight(model, 10 * 6, 0);
+    AppendWeight(model, 6, 0);
+    AppendWeight(model, 6 * 6, 0);
+
+    ncnn::Mat in = RandomMat(96, 4);
+
+    return 0
+           || test_streaming(param, model, in, 8, 1, opt)
+           || test_streaming(param, model, in, 12, 1, opt)
+           || test_streaming(param, model, in, 32, 1, opt);
+}
+
+static int test_streaming_1(const ncnn::Option& opt)
+{
+    // centered reflect padded spectrogram, then strided maxpool over frames
+    const char param[] = "7767517\n"
+                         "3 3\n"
+                         "Input       in    0 1 in\n"
+                         "Spectrogram spec  1 1 in s1 0=16 1=2 2=4 4=1 5=1 6=2\n"
+                         "Pooling1D   pool  1 1 s1 out 0=0 1=3 2=2 3=1 14=1\n";
+
+    const char param_complex[] = "7767517\n"
+                                 "2 2\n"
+                                 "Input       in    0 1 in\n"
+                                 "Spectrogram spec  1 1 in out 0=16 1=0 2=4 4=2 5=1 6=0\n";
+
+    std::vector<unsigned char> model;
+
+    ncnn::Mat in = RandomMat(192);
+
+    return 0
+           || test_streaming(param, model, in, 16, 0, opt)
+           || test_streaming(param, model, in, 24, 0, opt)
+           || test_streaming(param_complex, model, in, 12, 1, opt)
+           || test_streaming(param_complex, model, in, 32, 1, opt);
+}
+
+// extract fails on the first chunk when a layer over time does not stream
+static int test_streaming_reject(const char* param, const std::vector<unsigned char>& model, const ncnn::Mat& in, const ncnn::Option& opt)
+{
+    ncnn::Net net;
+    net.opt = opt;
+    if (LoadNet(net, param, model) != 0)
+    {
+        fprintf(stderr, "LoadNet failed\n");
+        return -1;
+    }
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.set_streaming(true);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        ex.input("in", in);
+
+        ncnn::Mat out;
+        if (ex.extract("out", out) == 0)
+        {
+            fprintf(stderr, "extract passed through a non streaming layer\n");
+            return -1;
+        }
+
+        ex.reset_streaming();
+    }
+
+    // the same net runs as a whole without streaming
+    ex.set_streaming(false);
+    ex.input("in", in);
+
+    ncnn::Mat out;
+    if (ex.extract("out", out) != 0)
+    {
+        fprintf(stderr, "extract without streaming failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_streaming_2(const ncnn::Option& opt)
+{
+    // convolution over the time axis
+    const char param_conv[] = "7767517\n"
+                              "3 3\n"
+                              "Input       in    0 1 in\n"
+                              "Reshape     rs    1 1 in r1 0=32 1=1 2=4\n"
+                              "Convolution conv  1 1 r1 out 0=8 1=3 11=1 5=0 6=96\n";
+
+    // attention over all frames after a streaming conv
+    const char param_mha[] = "7767517\n"
+                             "4 4\n"
+                             "Input              in    0 1 in\n"
+                             "Convolution1D      conv  1 1 in c1 0=8 1=1 5=0 6=32\n"
+                             "Permute            perm  1 1 c1 t1 0=1\n"
+                             "MultiHeadAttention attn  1 1 t1 out 0=8 1=2 2=64 3=8 4=8\n";
+
+    // transposed conv over time, the branch with a pointwise relu is fine
+    const char param_deconv[] = "7767517\n"
+                                "5 6\n"
+                                "Input           in     0 1 in\n"
+                                "Split           split  1 2 in s0 s1\n"
+                                "ReLU            relu   1 1 s0 r1\n"
+                                "Deconvolution1D deconv 1 1 s1 d1 0=4 1=3 3=2 5=0 6=48\n"
+                                "Concat          out    2 1 r1 d1 out 0=1\n";
+
+    // reverse direction recurrence
+    const char param_lstm[] = "7767517\n"
+                              "3 3\n"
+                              "Input   in    0 1 in\n"
+                              "Permute perm  1 1 in t1 0=1\n"
+                              "LSTM    lstm  1 1 t1 out 0=6 1=96 2=1\n";
+
+    std::vector<unsigned char> model_conv;
+    AppendWeight(model_conv, 96, 0);
+
+    std::vector<unsigned char> model_mha;
+    AppendWeight(model_mha, 32, 0);
+    for (int i = 0; i < 3; i++)
+    {
+        AppendWeight(model_mha, 64, 0);
+        AppendWeight(model_mha, 8, 1);
+    }
+    AppendWeight(model_mha, 64, 0);
+    AppendWeight(model_mha, 8, 1);
+
+    std::vector<unsigned char> model_deconv;
+    AppendWeight(model_deconv, 48, 0);
+
+    std::vector<unsigned char> model_lstm;
+    AppendWeight(model_lstm, 4 * 24, 0);
+    AppendWeight(model_lstm, 24, 0);
+    AppendWeight(model_lstm, 6 * 24, 0);
+
+    ncnn::Mat in = RandomMat(32, 4);
+
+    return 0
+           || test_streaming_reject(param_conv, model_conv, in, opt)
+           || test_streaming_reject(param_mha, model_mha, in, opt)
+           || test_streaming_reject(param_deconv, model_deconv, in, opt)
+           || test_streaming_reject(param_lstm, model_lstm, in, opt);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+    opts[0].num_threads = 1;
+
+    opts[1].use_packing_layout = true;
+    opts[1].num_threads = 1;
+
+    opts[2].use_packing_layout = true;
+    opts[2].lightmode = false;
+    opts[2].use_blob_arena = true;
+
+    for (int i = 0; i < 3; i++)
+    {
+        const ncnn::Option& opt = opts[i];
+
+        int ret = test_streaming_0(opt) || test_streaming_1(opt) || test_streaming_2(opt);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_streaming failed use_packing_layout=%d lightmode=%d use_blob_arena=%d\n", opt.use_packing_layout, opt.lightmode, opt.use_blob_arena);
+            return ret;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "testutil.h"
+#include "threadpool.h"
+
+struct extract_args
+{
+    const ncnn::Net* net;
+    ncnn::ThreadPool* thread_pool;
+    const ncnn::Mat* in;
+    const ncnn::Mat* ref;
+    int ret;
+};
+
+static void* extract_with_pool(void* args)
+{
+    extract_args* a = (extract_args*)args;
+
+    a->ret = 0;
+    for (int i = 0; i < 4 && a->ret == 0; i++)
+    {
+        ncnn::Extractor ex = a->net->create_extractor();
+        ex.set_thread_pool(a->thread_pool);
+        ex.input("data", *a->in);
+
+        ncnn::Mat out;
+        a->ret = ex.extract("prob", out);
+        if (a->ret == 0)
+            a->ret = CompareMat(*a->ref, out, 0.001);
+
+        // the calling thread is switched back after extract
+        if (ncnn::get_current_thread_pool() != 0)
+            a->ret = -1;
+    }
+
+    return 0;
+}
+
+static int test_thread_pool(const ncnn::Option& _opt)
+{
+    std::vector<unsigned char> model = FireModel();
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    ncnn::Option opt = _opt;
+    opt.num_threads = 2;
+    opt.use_vulkan_compute = false;
+
+    ncnn::Mat ref;
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        if (LoadNet(net, FireParam().c_str(), model) != 0)
+            return -1;
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", in);
+        ex.extract("prob", ref);
+    }
+
+    int ret = 0;
+
+    // a pool carried over to a copy of the extractor
+    {
+        ncnn::ThreadPool thread_pool(2);
+
+        ncnn::Net net;
+        net.opt = opt;
+        if (LoadNet(net, FireParam().c_str(), model) != 0)
+            return -1;
+
+        ncnn::Extractor ex0 = net.create_extractor();
+        ex0.set_thread_pool(&thread_pool);
+
+        ncnn::Extractor ex = ex0;
+        ex.input("data", in);
+
+        ncnn::Mat out;
+        if (ex.extract("prob", out) != 0 || CompareMat(ref, out, 0.001) != 0)
+        {
+            fprintf(stderr, "test_thread_pool extractor copy failed\n");
+            ret = -1;
+        }
+    }
+
+    // one pool per thread, extracting from the same net concurrently
+    if (ret == 0)
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        if (LoadNet(net, FireParam().c_str(), model) != 0)
+            return -1;
+
+        ncnn::ThreadPool thread_pool0(2);
+        ncnn::ThreadPool thread_pool1(3);
+
+        extract_args args[2];
+        args[0].net = &net;
+        args[0].thread_pool = &thread_pool0;
+        args[0].in = &in;
+        args[0].ref = &ref;
+        args[1] = args[0];
+        args[1].thread_pool = &thread_pool1;
+
+        ncnn::Thread t0(extract_with_pool, &args[0]);
+        ncnn::Thread t1(extract_with_pool, &args[1]);
+        t0.join();
+        t1.join();
+
+        if (args[0].ret != 0 || args[1].ret != 0)
+        {
+            fprintf(stderr, "test_thread_pool concurrent failed %d %d\n", args[0].ret, args[1].ret);
+            ret = -1;
+        }
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_thread_pool failed use_packing_layout=%d use_fp16_storage=%d\n", opt.use_packing_layout, opt.use_fp16_storage);
+    }
+
+    return ret;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[2];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_packed = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_packed = true;
+    opts[1].use_fp16_storage = true;
+    opts[1].use_bf16_storage = true;
+
+    for (int i = 0; i < 2; i++)
+    {
+        int ret = test_thread_pool(opts[i]);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+
+static int load_param(ncnn::Net& net)
+{
+    std::string param = FireParam();
+    const unsigned char* param_mem = (const unsigned char*)param.c_str();
+    ncnn::DataReaderFromMemory param_dr(param_mem);
+    return net.load_param(param_dr);
+}
+
+static int load_model(ncnn::Net& net, const std::vector<unsigned char>& model)
+{
+    const unsigned char* model_mem = &model[0];
+    ncnn::DataReaderFromMemory model_dr(model_mem);
+    return net.load_model(model_dr);
+}
+
+static int extract(const ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("prob", out);
+}
+
+// force one convolution algorithm on every layer through a tuning file
+static int test_tuning(const ncnn::Option& _opt, int algorithm_featmask)
+{
+    std::vector<unsigned char> model = FireModel();
+    ncnn::Mat in = RandomMat(24, 24, 3);
+
+    ncnn::Option opt = _opt;
+    opt.num_threads = 1;
+    opt.use_vulkan_compute = false;
+
+    ncnn::Mat ref;
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        if (LoadNet(net, FireParam().c_str(), model) != 0 || extract(net, in, ref) != 0)
+            return -1;
+    }
+
+    const char* tunepath = "test_tuning.tune";
+
+    int ret = 0;
+    {
+        ncnn::Net net0;
+        ret = load_param(net0);
+
+        std::vector<ncnn::Layer*>& layers = net0.mutable_layers();
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            layers[i]->featmask = algorithm_featmask;
+        }
+
+        if (ret == 0)
+            ret = net0.save_tuning(tunepath);
+    }
+
+    if (ret == 0)
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        ret = load_param(net);
+        if (ret == 0)
+            ret = net.load_tuning(tunepath);
+
+        const std::vector<ncnn::Layer*>& layers = net.layers();
+        for (size_t i = 0; i < layers.size() && ret == 0; i++)
+        {
+            if (layers[i]->type == "Convolution" && layers[i]->featmask != algorithm_featmask)
+            {
+                fprintf(stderr, "layer %s featmask %d expect %d\n", layers[i]->name.c_str(), layers[i]->featmask, algorithm_featmask);
+                ret = -1;
+            }
+        }
+
+        if (ret == 0)
+            ret = load_model(net, model);
+
+        ncnn::Mat out;
+        if (ret == 0)
+            ret = extract(net, in, out);
+
+        if (ret == 0)
+            ret = CompareMat(ref, out, 0.01);
+    }
+
+    remove(tunepath);
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_tuning failed algorithm_featmask=%d use_packing_layout=%d use_fp16_storage=%d\n", algorithm_featmask, opt.use_packing_layout, opt.use_fp16_storage);
+    }
+
+    return ret;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[2];
+
+    opts[0].use_packing_layout = false;
+    opts[0].use_fp16_packed = false;
+    opts[0].use_fp16_storage = false;
+    opts[0].use_bf16_storage = false;
+
+    opts[1].use_packing_layout = true;
+    opts[1].use_fp16_packed = true;
+    opts[1].use_fp16_storage = true;
+    opts[1].use_bf16_storage = true;
+
+    // winograd23 winograd43 winograd63 sgemm packed
+    const int algorithm_featmasks[5] = {1536, 1280, 768, 64, 96};
+
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 5; j++)
+        {
+            int ret = test_tuning(opts[i], algorithm_featmasks[j]);
+            if (ret != 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
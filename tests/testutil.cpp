@@ -4,8 +4,10 @@
 #include "testutil.h"
 
 #include "cpu.h"
+#include "datareader.h"
 #include "layer.h"
 #include "mat.h"
+#include "net.h"
 #include "prng.h"
 
 #include <limits.h>
@@ -78,6 +80,24 @@ void RandomizeS8(ncnn::Mat& m)
     }
 }
 
+void Sparsify(ncnn::Mat& m, int w, int h, int block_h, float density)
+{
+    float* ptr = m;
+    for (int i = 0; i < h; i += block_h)
+    {
+        for (int k = 0; k < w; k++)
+        {
+            if (RandomFloat(0.f, 1.f) < density)
+                continue;
+
+            for (int ii = i; ii < i + block_h && ii < h; ii++)
+            {
+                ptr[ii * w + k] = 0.f;
+            }
+        }
+    }
+}
+
 ncnn::Mat RandomMat(int w, float a, float b)
 {
     ncnn::Mat m(w);
@@ -1410,6 +1430,9 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
         opt.use_fp16_arithmetic = options[i][3];
         opt.use_bf16_storage = options[i][4];
 
+        if (flag & TEST_LAYER_ENABLE_SPARSE_WEIGHT)
+            opt.use_sparse_weight = true;
+
         int ret = test_layer_opt(layer_type, pd, weights, opt, a, top_blob_count, epsilon, func, flag);
         if (ret != 0)
             return ret;
@@ -1444,6 +1467,9 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
         opt.use_fp16_arithmetic = options[i][3];
         opt.use_bf16_storage = options[i][4];
 
+        if (flag & TEST_LAYER_ENABLE_SPARSE_WEIGHT)
+            opt.use_sparse_weight = true;
+
         int ret = test_layer_opt(layer_type, pd, weights, opt, a, epsilon, func, flag);
         if (ret != 0)
             return ret;
@@ -1452,6 +1478,117 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
     return 0;
 }
 
+std::string FireParam(int fire_count, int expand_kernel)
+{
+    const int k = expand_kernel;
+    const int p = expand_kernel / 2;
+
+    char buf[2048];
+    std::string param = "7767517\n";
+
+    sprintf(buf, "%d %d\n", fire_count == 2 ? 14 : 9, fire_count == 2 ? 17 : 10);
+    param += buf;
+
+    param += "Input data 0 1 data 0=24 1=24 2=3\n";
+    param += "Convolution conv1 1 1 data conv1 0=16 1=3 4=1 5=1 6=432 9=1\n";
+    param += "Split splitncnn_0 1 2 conv1 conv1_0 conv1_1\n";
+    param += "Convolution fire2/expand1x1 1 1 conv1_0 fire2/expand1x1 0=16 1=1 5=1 6=256 9=1\n";
+    sprintf(buf, "Convolution fire2/expand3x3 1 1 conv1_1 fire2/expand3x3 0=16 1=%d 4=%d 5=1 6=%d 9=1\n", k, p, 16 * 16 * k * k);
+    param += buf;
+    param += "Concat fire2/concat 2 1 fire2/expand1x1 fire2/expand3x3 fire2/concat\n";
+
+    const char* last = "fire2/concat";
+    if (fire_count == 2)
+    {
+        param += "Convolution fire3/squeeze1x1 1 1 fire2/concat fire3/squeeze1x1 0=8 1=1 5=1 6=256 9=1\n";
+        param += "Split splitncnn_1 1 2 fire3/squeeze1x1 fire3/squeeze1x1_0 fire3/squeeze1x1_1\n";
+        param += "Convolution fire3/expand1x1 1 1 fire3/squeeze1x1_0 fire3/expand1x1 0=16 1=1 5=1 6=128 9=1\n";
+        sprintf(buf, "Convolution fire3/expand3x3 1 1 fire3/squeeze1x1_1 fire3/expand3x3 0=16 1=%d 4=%d 5=1 6=%d 9=1\n", k, p, 8 * 16 * k * k);
+        param += buf;
+        param += "Concat fire3/concat 2 1 fire3/expand1x1 fire3/expand3x3 fire3/concat\n";
+        last = "fire3/concat";
+    }
+
+    sprintf(buf, "Pooling pool 1 1 %s pool 0=1 4=1\n", last);
+    param += buf;
+    param += "InnerProduct fc 1 1 pool fc 0=10 1=1 2=320\n";
+    param += "Softmax prob 1 1 fc prob\n";
+
+    return param;
+}
+
+int FireWeightSizes(int fire_count, int expand_kernel, int* weight_sizes, int* bias_sizes)
+{
+    const int kk = expand_kernel * expand_kernel;
+
+    int n = 0;
+    weight_sizes[n] = 432;
+    bias_sizes[n++] = 16;
+    weight_sizes[n] = 256;
+    bias_sizes[n++] = 16;
+    weight_sizes[n] = 16 * 16 * kk;
+    bias_sizes[n++] = 16;
+    if (fire_count == 2)
+    {
+        weight_sizes[n] = 256;
+        bias_sizes[n++] = 8;
+        weight_sizes[n] = 128;
+        bias_sizes[n++] = 16;
+        weight_sizes[n] = 8 * 16 * kk;
+        bias_sizes[n++] = 16;
+    }
+    weight_sizes[n] = 320;
+    bias_sizes[n++] = 10;
+
+    return n;
+}
+
+std::vector<unsigned char> FireModel(int fire_count, int expand_kernel)
+{
+    int weight_sizes[7];
+    int bias_sizes[7];
+    const int n = FireWeightSizes(fire_count, expand_kernel, weight_sizes, bias_sizes);
+
+    std::vector<unsigned char> model;
+    for (int i = 0; i < n; i++)
+    {
+        AppendWeight(model, weight_sizes[i], 0);
+        AppendWeight(model, bias_sizes[i], 1);
+    }
+
+    return model;
+}
+
+void AppendWeight(std::vector<unsigned char>& model, int size, int type)
+{
+    if (type == 0)
+    {
+        // flag for raw float32
+        model.insert(model.end(), 4, 0);
+    }
+
+    ncnn::Mat m = RandomMat(size);
+    const unsigned char* p = m;
+    model.insert(model.end(), p, p + size * sizeof(float));
+}
+
+int LoadNet(ncnn::Net& net, const char* param, const std::vector<unsigned char>& model)
+{
+    const unsigned char* param_mem = (const unsigned char*)param;
+    ncnn::DataReaderFromMemory param_dr(param_mem);
+    int ret = net.load_param(param_dr);
+    if (ret != 0)
+        return ret;
+
+    const unsigned char* model_mem = model.empty() ? 0 : &model[0];
+    ncnn::DataReaderFromMemory model_dr(model_mem);
+    ret = net.load_model(model_dr);
+    if (ret != 0)
+        return -1;
+
+    return 0;
+}
+
 class TestOOMAllocator : public ncnn::UnlockedPoolAllocator
 {
 public:
@@ -7,6 +7,7 @@
 #include "cpu.h"
 #include "layer.h"
 #include "mat.h"
+#include "net.h"
 
 #include <stdio.h>
 #include <stdint.h>
@@ -16,6 +17,7 @@
 #define TEST_LAYER_DISABLE_AUTO_INPUT_CASTING (1 << 1)
 #define TEST_LAYER_DISABLE_GPU_TESTING        (1 << 2)
 #define TEST_LAYER_ENABLE_FORCE_INPUT_PACK8   (1 << 3)
+#define TEST_LAYER_ENABLE_SPARSE_WEIGHT       (1 << 4)
 
 void SRAND(int seed);
 
@@ -33,6 +35,9 @@ void RandomizeInt(ncnn::Mat& m, int a = -10000, int b = 10000);
 
 void RandomizeS8(ncnn::Mat& m);
 
+// zero the weight m of h rows of w in blocks of block_h rows along one column, keeping about density of the blocks
+void Sparsify(ncnn::Mat& m, int w, int h, int block_h, float density);
+
 ncnn::Mat RandomMat(int w, float a = -1.2f, float b = 1.2f);
 
 ncnn::Mat RandomMat(int w, int h, float a = -1.2f, float b = 1.2f);
@@ -95,6 +100,21 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
 
 int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Mat& a, float epsilon = 0.001, void (*func)(ncnn::Layer*) = 0, int flag = 0);
 
+// squeezenet style fire modules with random weights for the net level tests
+// input data 24x24x3 - conv1 - fire2 - fire3 - global pooling - fc 10 - softmax prob
+// fire3 is only present when fire_count is 2, the expand3x3 convolutions use expand_kernel
+std::string FireParam(int fire_count = 1, int expand_kernel = 3);
+
+// weight and bias sizes in floats of the convolution and innerproduct layers in FireParam order, returns the layer count
+int FireWeightSizes(int fire_count, int expand_kernel, int* weight_sizes, int* bias_sizes);
+
+std::vector<unsigned char> FireModel(int fire_count = 1, int expand_kernel = 3);
+
+// append size random floats to model, type 0 with the raw float32 flag as a weight, type 1 without as a bias
+void AppendWeight(std::vector<unsigned char>& model, int size, int type);
+
+int LoadNet(ncnn::Net& net, const char* param, const std::vector<unsigned char>& model);
+
 // oom test
 
 int test_layer_oom_opt(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Option& opt, const std::vector<ncnn::Mat>& a, int top_blob_count = 1, int flag = 0);
@@ -218,6 +218,12 @@ public:
     // 0=fp32 1=fp16
     int storage_type;
 
+    // 0=4-byte aligned, N=pad tagged weight data to N-byte alignment
+    int weight_align;
+
+    // 0=dense 1=store fp32 weight data with zero blocks as block sparse if smaller
+    int sparse_weight;
+
     int gen_random_weight;
 
     // Cut param and bin -1=no cut
@@ -235,6 +241,7 @@ public:
     int fprintf_param_float_array(int id, const ncnn::Mat& m, FILE* pp);
 
     int fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a = -1.2f, float b = 1.2f);
+    int fwrite_weight_sparse_data(const ncnn::Mat& data, FILE* bp);
     int fwrite_weight_data(const ncnn::Mat& data, FILE* bp, float a = -1.2f, float b = 1.2f);
 
     int save(const char* parampath, const char* binpath);
@@ -245,6 +252,9 @@ ModelWriter::ModelWriter()
 {
     opt.lightmode = false;
     has_custom_layer = false;
+    storage_type = 0;
+    weight_align = 0;
+    sparse_weight = 0;
     gen_random_weight = false;
     cutstart = -1;
     cutend = -1;
@@ -611,6 +621,18 @@ int ModelWriter::fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a
     if (gen_random_weight)
         Randomize(data_flattened, a, b);
 
+    if (weight_align > 0 && (p0 + 4) % weight_align != 0)
+    {
+        // padding record so that the data after tag lands on aligned offset
+        const int tag = 0x00444150; // padding magic
+        const int padding_size = (weight_align - (p0 + 12) % weight_align) % weight_align;
+        fwrite(&tag, sizeof(int), 1, bp);
+        fwrite(&padding_size, sizeof(int), 1, bp);
+
+        std::vector<unsigned char> padding(padding_size + 1, 0x00);
+        fwrite(padding.data(), sizeof(unsigned char), padding_size, bp);
+    }
+
     if (data_flattened.elemsize == 4)
     {
         if (storage_type == 1)
@@ -623,10 +645,14 @@ int ModelWriter::fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a
         }
         else
         {
-            const int tag = 0; // fp32 magic
-            fwrite(&tag, sizeof(int), 1, bp);
             replace_denormals_with_zero(data_flattened, data_flattened.w);
-            fwrite(data_flattened.data, data_flattened.elemsize, data_flattened.w, bp);
+
+            if (!sparse_weight || fwrite_weight_sparse_data(data_flattened, bp) != 0)
+            {
+                const int tag = 0; // fp32 magic
+                fwrite(&tag, sizeof(int), 1, bp);
+                fwrite(data_flattened.data, data_flattened.elemsize, data_flattened.w, bp);
+            }
         }
     }
     else if (data_flattened.elemsize == 2)
@@ -655,6 +681,79 @@ int ModelWriter::fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a
     return 0;
 }
 
+int ModelWriter::fwrite_weight_sparse_data(const ncnn::Mat& data, FILE* bp)
+{
+    const int w = data.w;
+    const float* ptr = data;
+
+    // pick the block size giving the smallest encoding
+    int block_size = 0;
+    size_t encoded_size = (size_t)w * sizeof(float);
+    const int block_sizes[2] = {1, 4};
+    for (int t = 0; t < 2; t++)
+    {
+        const int bs = block_sizes[t];
+        const int block_count = (w + bs - 1) / bs;
+
+        int nonzero_block_count = 0;
+        for (int i = 0; i < block_count; i++)
+        {
+            const int size = std::min(bs, w - i * bs);
+            for (int j = 0; j < size; j++)
+            {
+                if (ptr[i * bs + j] != 0.f)
+                {
+                    nonzero_block_count++;
+                    break;
+                }
+            }
+        }
+
+        const size_t size = 8 + alignSize((block_count + 7) / 8, 4) + (size_t)nonzero_block_count * bs * sizeof(float);
+        if (size < encoded_size)
+        {
+            block_size = bs;
+            encoded_size = size;
+        }
+    }
+
+    if (block_size == 0)
+        return -1;
+
+    const int block_count = (w + block_size - 1) / block_size;
+
+    std::vector<unsigned char> mask(alignSize((block_count + 7) / 8, 4), 0x00);
+    std::vector<float> values;
+    for (int i = 0; i < block_count; i++)
+    {
+        const int size = std::min(block_size, w - i * block_size);
+
+        bool nonzero = false;
+        for (int j = 0; j < size; j++)
+        {
+            nonzero = nonzero || ptr[i * block_size + j] != 0.f;
+        }
+        if (!nonzero)
+            continue;
+
+        mask[i / 8] |= 1 << (i % 8);
+        for (int j = 0; j < block_size; j++)
+        {
+            values.push_back(j < size ? ptr[i * block_size + j] : 0.f);
+        }
+    }
+
+    const int tag = 0x00535042; // sparse magic
+    const unsigned int header[2] = {(unsigned int)block_size, (unsigned int)(values.size() / block_size)};
+    fwrite(&tag, sizeof(int), 1, bp);
+    fwrite(header, sizeof(unsigned int), 2, bp);
+    fwrite(mask.data(), sizeof(unsigned char), mask.size(), bp);
+    if (!values.empty())
+        fwrite(values.data(), sizeof(float), values.size(), bp);
+
+    return 0;
+}
+
 int ModelWriter::fwrite_weight_data(const ncnn::Mat& data, FILE* bp, float a, float b)
 {
     int p0 = ftell(bp);
@@ -1279,6 +1378,7 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             }
             fprintf_param_value(" 5=%d", bias_term)
             fprintf_param_value(" 6=%d", weight_data_size)
+            fprintf_param_value(" 8=%d", int8_scale_term)
             fprintf_param_value(" 9=%d", activation_type)
             {
                 if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
@@ -1289,6 +1389,15 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             {
                 fwrite_weight_tag_data(op->weight_data, bp);
                 fwrite_weight_data(op->bias_data, bp);
+
+#if NCNN_INT8
+                // write int8_scale data
+                if (op->int8_scale_term)
+                {
+                    fwrite_weight_data(op->weight_data_int8_scales, bp, 90, 100);
+                    fwrite_weight_data(op->bottom_blob_int8_scales, bp, 0.001, 1);
+                }
+#endif // NCNN_INT8
             }
 
             if (shape_ready)
@@ -1444,6 +1553,7 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             fprintf_param_value(" 5=%d", bias_term)
             fprintf_param_value(" 6=%d", weight_data_size)
             fprintf_param_value(" 7=%d", group)
+            fprintf_param_value(" 8=%d", int8_scale_term)
             fprintf_param_value(" 9=%d", activation_type)
             {
                 if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
@@ -1454,6 +1564,20 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             {
                 fwrite_weight_tag_data(op->weight_data, bp);
                 fwrite_weight_data(op->bias_data, bp);
+
+#if NCNN_INT8
+                // write int8_scale data
+                if (op->int8_scale_term == 2)
+                {
+                    op->weight_data_int8_scales.w = 1;
+                }
+
+                if (op->int8_scale_term)
+                {
+                    fwrite_weight_data(op->weight_data_int8_scales, bp, 90, 100);
+                    fwrite_weight_data(op->bottom_blob_int8_scales, bp, 0.001, 1);
+                }
+#endif // NCNN_INT8
             }
 
             if (shape_ready)
@@ -2015,6 +2139,9 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             ncnn::MatMul* op_default = (ncnn::MatMul*)layer_default;
 
             fprintf_param_value(" 0=%d", transB)
+            fprintf_param_value(" 20=%d", constant_TILE_M)
+            fprintf_param_value(" 21=%d", constant_TILE_N)
+            fprintf_param_value(" 22=%d", constant_TILE_K)
         }
         else if (layer->type == "MemoryData")
         {
@@ -2776,7 +2776,7 @@ int main(int argc, char** argv)
 
     NetOptimize optimizer;
 
-    if (flag == 65536 || flag == 1)
+    if (flag == 65536 || flag == 1 || flag == 3)
     {
         optimizer.storage_type = 1;
     }
@@ -2785,6 +2785,18 @@ int main(int argc, char** argv)
         optimizer.storage_type = 0;
     }
 
+    if (flag == 2 || flag == 3)
+    {
+        // aligned weight data for load_model_mmap
+        optimizer.weight_align = 64;
+    }
+
+    if (flag == 4)
+    {
+        // zero weight blocks stored as block sparse
+        optimizer.sparse_weight = 1;
+    }
+
     optimizer.load_param(inparam);
 
     if (strcmp(inbin, "null") == 0)
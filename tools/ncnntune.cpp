@@ -0,0 +1,722 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_DEPRECATE
+#endif
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// ncnn public header
+#include "cpu.h"
+#include "datareader.h"
+#include "layer.h"
+#include "net.h"
+#include "profiler.h"
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* format, void* p) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+// the convolution algorithms expressed as featmask bits
+//   1<<5 no sgemm   1<<6 no winograd   1<<8 no winograd23   1<<9 no winograd43   1<<10 no winograd63
+struct ConvAlgorithm
+{
+    const char* name;
+    int featmask;
+};
+
+static const ConvAlgorithm g_conv_algorithms[] = {
+    {"default", 0},
+    {"winograd23", (1 << 9) | (1 << 10)},
+    {"winograd43", (1 << 8) | (1 << 10)},
+    {"winograd63", (1 << 8) | (1 << 9)},
+    {"sgemm", (1 << 6)},
+    {"packed", (1 << 5) | (1 << 6)},
+};
+
+static const int g_conv_algorithm_count = sizeof(g_conv_algorithms) / sizeof(g_conv_algorithms[0]);
+
+// the gemm tile sizes swept one dimension after another, 0 keeps the cache based default
+static const int g_tile_m_candidates[] = {0, 16, 32, 48, 64, 96, 128, 192, 256};
+static const int g_tile_n_candidates[] = {0, 16, 32, 48, 64, 96, 128, 192, 256};
+static const int g_tile_k_candidates[] = {0, 32, 64, 128, 192, 256, 384, 512};
+
+// a candidate replaces the default only when it is faster by this ratio
+static const float g_speedup_threshold = 1.03f;
+
+struct LayerTiming
+{
+    double time;
+    std::string kernel;
+};
+
+struct GemmTile
+{
+    int M;
+    int N;
+    int K;
+};
+
+class NetTune
+{
+public:
+    NetTune();
+
+    int load(const char* parampath, const char* binpath);
+
+    int tune_conv(const std::vector<ncnn::Mat>& inputs);
+
+    int tune_gemm(const std::vector<ncnn::Mat>& inputs);
+
+    // write the algorithm choices to tuning file
+    int save_tuning(const char* tunepath) const;
+
+    // write the param file with the gemm tile sizes as constant_TILE_M/N/K
+    int save_param(const char* parampath) const;
+
+public:
+    int loop_count;
+    int num_threads;
+
+protected:
+    bool is_conv_layer(int typeindex) const;
+
+    bool is_gemm_layer(int typeindex) const;
+
+    // param text with tile sizes replaced on gemm layers
+    std::string make_param(const std::vector<GemmTile>& tiles) const;
+
+    int load_net(ncnn::Net& net, const std::string& paramstr, int featmask) const;
+
+    int measure(ncnn::Net& net, const std::vector<ncnn::Mat>& inputs, std::vector<LayerTiming>& timings) const;
+
+protected:
+    const char* parampath;
+    const char* binpath;
+
+    // one line per layer after the magic and count lines
+    std::vector<std::string> param_lines;
+    std::vector<int> layer_typeindexes;
+
+    std::vector<int> conv_typeindexes;
+    std::vector<int> gemm_typeindexes;
+
+    // the winning featmask per layer
+    std::vector<int> featmasks;
+
+    // the winning tile sizes per layer
+    std::vector<GemmTile> tiles;
+};
+
+NetTune::NetTune()
+{
+    loop_count = 8;
+    num_threads = ncnn::get_physical_big_cpu_count();
+    parampath = 0;
+    binpath = 0;
+
+    conv_typeindexes.push_back(ncnn::layer_to_index("Convolution"));
+    conv_typeindexes.push_back(ncnn::layer_to_index("ConvolutionDepthWise"));
+    conv_typeindexes.push_back(ncnn::layer_to_index("Deconvolution"));
+    conv_typeindexes.push_back(ncnn::layer_to_index("DeconvolutionDepthWise"));
+
+    gemm_typeindexes.push_back(ncnn::layer_to_index("Gemm"));
+    gemm_typeindexes.push_back(ncnn::layer_to_index("MatMul"));
+}
+
+int NetTune::load(const char* _parampath, const char* _binpath)
+{
+    parampath = _parampath;
+    binpath = _binpath;
+
+    FILE* fp = fopen(parampath, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", parampath);
+        return -1;
+    }
+
+    param_lines.clear();
+
+    char line[4096];
+    while (fgets(line, sizeof(line), fp))
+    {
+        std::string s(line);
+        while (!s.empty() && (s[s.size() - 1] == '\n' || s[s.size() - 1] == '\r'))
+            s.erase(s.size() - 1);
+
+        if (!s.empty())
+            param_lines.push_back(s);
+    }
+
+    fclose(fp);
+
+    ncnn::Net net;
+    int ret = net.load_param_mem(make_param(std::vector<GemmTile>()).c_str());
+    if (ret != 0)
+        return ret;
+
+    const size_t layer_count = net.layers().size();
+    if (param_lines.size() != layer_count + 2)
+    {
+        fprintf(stderr, "%s is not a plain param file with one layer per line\n", parampath);
+        return -1;
+    }
+
+    layer_typeindexes.resize(layer_count);
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        layer_typeindexes[i] = net.layers()[i]->typeindex;
+    }
+
+    featmasks.resize(layer_count, 0);
+
+    GemmTile tile0 = {0, 0, 0};
+    tiles.resize(layer_count, tile0);
+
+    return 0;
+}
+
+bool NetTune::is_conv_layer(int typeindex) const
+{
+    for (size_t i = 0; i < conv_typeindexes.size(); i++)
+    {
+        if (conv_typeindexes[i] == typeindex)
+            return true;
+    }
+
+    return false;
+}
+
+bool NetTune::is_gemm_layer(int typeindex) const
+{
+    for (size_t i = 0; i < gemm_typeindexes.size(); i++)
+    {
+        if (gemm_typeindexes[i] == typeindex)
+            return true;
+    }
+
+    return false;
+}
+
+std::string NetTune::make_param(const std::vector<GemmTile>& _tiles) const
+{
+    std::string paramstr;
+
+    for (size_t i = 0; i < param_lines.size(); i++)
+    {
+        const std::string& line = param_lines[i];
+
+        // keep the layers without tile sizes as is
+        if (i < 2 || i - 2 >= _tiles.size() || (_tiles[i - 2].M == 0 && _tiles[i - 2].N == 0 && _tiles[i - 2].K == 0))
+        {
+            paramstr += line;
+            paramstr += '\n';
+            continue;
+        }
+
+        const GemmTile& tile = _tiles[i - 2];
+
+        // layer type, name, bottom count, top count, blob names, then key=value pairs
+        std::vector<std::string> tokens;
+        {
+            size_t p = 0;
+            while (p < line.size())
+            {
+                size_t q = line.find_first_of(" \t", p);
+                if (q == std::string::npos)
+                    q = line.size();
+                if (q > p)
+                    tokens.push_back(line.substr(p, q - p));
+                p = q + 1;
+            }
+        }
+
+        const size_t blob_end = tokens.size() < 4 ? tokens.size() : 4 + atoi(tokens[2].c_str()) + atoi(tokens[3].c_str());
+
+        std::string newline;
+        for (size_t j = 0; j < tokens.size(); j++)
+        {
+            const std::string& t = tokens[j];
+            // drop the previous tile sizes
+            if (j >= blob_end && (t.compare(0, 3, "20=") == 0 || t.compare(0, 3, "21=") == 0 || t.compare(0, 3, "22=") == 0))
+                continue;
+
+            if (j > 0)
+                newline += ' ';
+            newline += t;
+        }
+
+        char tilestr[64];
+        sprintf(tilestr, " 20=%d 21=%d 22=%d", tile.M, tile.N, tile.K);
+        newline += tilestr;
+
+        paramstr += newline;
+        paramstr += '\n';
+    }
+
+    return paramstr;
+}
+
+int NetTune::load_net(ncnn::Net& net, const std::string& paramstr, int featmask) const
+{
+    net.opt.num_threads = num_threads;
+    net.opt.lightmode = true;
+
+    int ret = net.load_param_mem(paramstr.c_str());
+    if (ret != 0)
+        return ret;
+
+    std::vector<ncnn::Layer*>& layers = net.mutable_layers();
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (is_conv_layer(layers[i]->typeindex))
+            layers[i]->featmask |= featmask;
+    }
+
+    if (strcmp(binpath, "-") == 0)
+    {
+        DataReaderFromEmpty dr;
+        return net.load_model(dr);
+    }
+
+    return net.load_model(binpath);
+}
+
+int NetTune::measure(ncnn::Net& net, const std::vector<ncnn::Mat>& inputs, std::vector<LayerTiming>& timings) const
+{
+    const std::vector<const char*>& input_names = net.input_names();
+    const std::vector<const char*>& output_names = net.output_names();
+
+    if (input_names.size() > inputs.size())
+    {
+        fprintf(stderr, "input %d tensors while model has %d inputs\n", (int)inputs.size(), (int)input_names.size());
+        return -1;
+    }
+
+    ncnn::Profiler profiler;
+
+    // the first run is warm up
+    for (int i = 0; i < loop_count + 1; i++)
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        if (i > 0)
+            ex.set_profiler(&profiler);
+
+        for (size_t j = 0; j < input_names.size(); j++)
+        {
+            ex.input(input_names[j], inputs[j]);
+        }
+
+        for (size_t j = 0; j < output_names.size(); j++)
+        {
+            ncnn::Mat out;
+            int ret = ex.extract(output_names[j], out);
+            if (ret != 0)
+                return ret;
+        }
+    }
+
+    timings.resize(net.layers().size());
+    for (size_t i = 0; i < timings.size(); i++)
+    {
+        timings[i].time = DBL_MAX;
+        timings[i].kernel.clear();
+    }
+
+    const std::vector<ncnn::LayerProfile> records = profiler.records();
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const ncnn::LayerProfile& r = records[i];
+
+        LayerTiming& t = timings[r.layer_index];
+        t.time = std::min(t.time, r.end - r.start);
+        if (r.kernel)
+            t.kernel = r.kernel;
+    }
+
+    return 0;
+}
+
+int NetTune::tune_conv(const std::vector<ncnn::Mat>& inputs)
+{
+    std::vector<std::vector<LayerTiming> > timings(g_conv_algorithm_count);
+
+    const std::string paramstr = make_param(tiles);
+
+    for (int i = 0; i < g_conv_algorithm_count; i++)
+    {
+        ncnn::Net net;
+        int ret = load_net(net, paramstr, g_conv_algorithms[i].featmask);
+        if (ret != 0)
+        {
+            fprintf(stderr, "load %s %s failed\n", parampath, binpath);
+            return ret;
+        }
+
+        ret = measure(net, inputs, timings[i]);
+        if (ret != 0)
+        {
+            fprintf(stderr, "measure %s failed\n", g_conv_algorithms[i].name);
+            return ret;
+        }
+    }
+
+    ncnn::Net net;
+    net.load_param_mem(paramstr.c_str());
+    const std::vector<ncnn::Layer*>& layers = net.layers();
+
+    double total_default = 0;
+    double total_tuned = 0;
+
+    fprintf(stderr, "%-24s %-28s %9s   %-28s %9s  speedup\n", "layer", "default", "ms", "tuned", "ms");
+
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (!is_conv_layer(layers[i]->typeindex))
+            continue;
+
+        const LayerTiming& t0 = timings[0][i];
+        if (t0.time == DBL_MAX)
+            continue;
+
+        int best = 0;
+        for (int j = 1; j < g_conv_algorithm_count; j++)
+        {
+            const LayerTiming& t = timings[j][i];
+
+            // same kernel as the default, nothing to override
+            if (t.kernel == t0.kernel)
+                continue;
+
+            if (t.time * g_speedup_threshold < timings[best][i].time)
+                best = j;
+        }
+
+        const LayerTiming& tb = timings[best][i];
+
+        featmasks[i] = g_conv_algorithms[best].featmask;
+
+        total_default += t0.time;
+        total_tuned += tb.time;
+
+        fprintf(stderr, "%-24s %-28s %9.3f   %-28s %9.3f  %6.2fx\n", layers[i]->name.c_str(), t0.kernel.c_str(), t0.time, tb.kernel.c_str(), tb.time, t0.time / tb.time);
+    }
+
+    if (total_tuned > 0)
+    {
+        fprintf(stderr, "total %.3f ms -> %.3f ms  %.2fx\n", total_default, total_tuned, total_default / total_tuned);
+    }
+
+    return 0;
+}
+
+int NetTune::tune_gemm(const std::vector<ncnn::Mat>& inputs)
+{
+    const int* candidates[3] = {g_tile_m_candidates, g_tile_n_candidates, g_tile_k_candidates};
+    const int candidate_counts[3] = {
+        (int)(sizeof(g_tile_m_candidates) / sizeof(int)),
+        (int)(sizeof(g_tile_n_candidates) / sizeof(int)),
+        (int)(sizeof(g_tile_k_candidates) / sizeof(int))
+    };
+
+    const size_t layer_count = tiles.size();
+
+    std::vector<GemmTile> best_tiles = tiles;
+    std::vector<LayerTiming> default_timings;
+    std::vector<LayerTiming> best_timings;
+
+    // coordinate descent, the best M is kept while sweeping N, then both while sweeping K
+    for (int d = 0; d < 3; d++)
+    {
+        const std::vector<GemmTile> base_tiles = best_tiles;
+
+        for (int c = 0; c < candidate_counts[d]; c++)
+        {
+            const int v = candidates[d][c];
+
+            // the all default run is measured once
+            if (d > 0 && v == 0)
+                continue;
+
+            std::vector<GemmTile> trial_tiles = base_tiles;
+            for (size_t i = 0; i < layer_count; i++)
+            {
+                if (!is_gemm_layer(layer_typeindexes[i]))
+                    continue;
+
+                GemmTile& tile = trial_tiles[i];
+                if (d == 0) tile.M = v;
+                if (d == 1) tile.N = v;
+                if (d == 2) tile.K = v;
+            }
+
+            ncnn::Net net;
+            int ret = load_net(net, make_param(trial_tiles), 0);
+            if (ret != 0)
+            {
+                fprintf(stderr, "load %s %s failed\n", parampath, binpath);
+                return ret;
+            }
+
+            std::vector<LayerTiming> timings;
+            ret = measure(net, inputs, timings);
+            if (ret != 0)
+            {
+                fprintf(stderr, "measure tile %d=%d failed\n", 20 + d, v);
+                return ret;
+            }
+
+            if (d == 0 && v == 0)
+            {
+                default_timings = timings;
+                best_timings = timings;
+                continue;
+            }
+
+            for (size_t i = 0; i < layer_count; i++)
+            {
+                if (timings[i].time < best_timings[i].time)
+                {
+                    best_timings[i] = timings[i];
+                    best_tiles[i] = trial_tiles[i];
+                }
+            }
+        }
+    }
+
+    ncnn::Net net;
+    net.load_param_mem(make_param(tiles).c_str());
+    const std::vector<ncnn::Layer*>& layers = net.layers();
+
+    double total_default = 0;
+    double total_tuned = 0;
+
+    fprintf(stderr, "%-24s %9s   %-20s %9s  speedup\n", "layer", "ms", "tuned TILE_M/N/K", "ms");
+
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (!is_gemm_layer(layers[i]->typeindex))
+            continue;
+
+        const LayerTiming& t0 = default_timings[i];
+        if (t0.time == DBL_MAX)
+            continue;
+
+        // the tile sizes in param file are measured as default, keep them when nothing beats it
+        if (best_timings[i].time * g_speedup_threshold < t0.time)
+        {
+            tiles[i] = best_tiles[i];
+        }
+        else
+        {
+            best_timings[i] = t0;
+        }
+
+        const LayerTiming& tb = best_timings[i];
+
+        total_default += t0.time;
+        total_tuned += tb.time;
+
+        char tilestr[64];
+        if (tiles[i].M || tiles[i].N || tiles[i].K)
+            sprintf(tilestr, "%d/%d/%d", tiles[i].M, tiles[i].N, tiles[i].K);
+        else
+            sprintf(tilestr, "default");
+
+        fprintf(stderr, "%-24s %9.3f   %-20s %9.3f  %6.2fx\n", layers[i]->name.c_str(), t0.time, tilestr, tb.time, t0.time / tb.time);
+    }
+
+    if (total_tuned > 0)
+    {
+        fprintf(stderr, "total %.3f ms -> %.3f ms  %.2fx\n", total_default, total_tuned, total_default / total_tuned);
+    }
+
+    return 0;
+}
+
+int NetTune::save_tuning(const char* tunepath) const
+{
+    ncnn::Net net;
+    int ret = net.load_param_mem(make_param(tiles).c_str());
+    if (ret != 0)
+        return ret;
+
+    std::vector<ncnn::Layer*>& layers = net.mutable_layers();
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        layers[i]->featmask |= featmasks[i];
+    }
+
+    return net.save_tuning(tunepath);
+}
+
+int NetTune::save_param(const char* outparampath) const
+{
+    FILE* fp = fopen(outparampath, "wb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", outparampath);
+        return -1;
+    }
+
+    const std::string paramstr = make_param(tiles);
+    fwrite(paramstr.c_str(), 1, paramstr.size(), fp);
+
+    int ret = ferror(fp) ? -1 : 0;
+
+    fclose(fp);
+
+    return ret;
+}
+
+static std::vector<ncnn::Mat> parse_shape_list(char* s)
+{
+    std::vector<ncnn::Mat> mats;
+
+    char* pch = strtok(s, "[]");
+    while (pch != NULL)
+    {
+        // parse a,b,c
+        std::vector<int> shape;
+
+        int v;
+        int nconsumed = 0;
+        int nscan = sscanf(pch, "%d%n", &v, &nconsumed);
+        while (nscan == 1)
+        {
+            pch += nconsumed;
+            shape.push_back(v);
+            nscan = sscanf(pch, ",%d%n", &v, &nconsumed);
+        }
+
+        if (shape.size() == 1)
+            mats.push_back(ncnn::Mat(shape[0]));
+        if (shape.size() == 2)
+            mats.push_back(ncnn::Mat(shape[0], shape[1]));
+        if (shape.size() == 3)
+            mats.push_back(ncnn::Mat(shape[0], shape[1], shape[2]));
+        if (shape.size() == 4)
+            mats.push_back(ncnn::Mat(shape[0], shape[1], shape[2], shape[3]));
+
+        pch = strtok(NULL, "[]");
+    }
+
+    for (size_t i = 0; i < mats.size(); i++)
+    {
+        mats[i].fill(0.01f);
+    }
+
+    return mats;
+}
+
+static void show_usage()
+{
+    fprintf(stderr, "Usage: ncnntune [mode] [inparam] [inbin] [out] [(key=value)...]\n");
+    fprintf(stderr, "  mode     conv  write the convolution algorithm choices to tuning file\n");
+    fprintf(stderr, "           gemm  write the param file with Gemm and MatMul tile sizes\n");
+    fprintf(stderr, "  inbin    model.bin or - for zero weights\n");
+    fprintf(stderr, "  shape=[227,227,3],...\n");
+    fprintf(stderr, "  loop=8\n");
+    fprintf(stderr, "  threads=N\n");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 5)
+    {
+        show_usage();
+        return -1;
+    }
+
+    const char* mode = argv[1];
+    const char* inparam = argv[2];
+    const char* inbin = argv[3];
+    const char* outpath = argv[4];
+
+    NetTune tuner;
+    std::vector<ncnn::Mat> inputs;
+
+    for (int i = 5; i < argc; i++)
+    {
+        // key=value
+        char* kv = argv[i];
+
+        char* eqs = strchr(kv, '=');
+        if (eqs == NULL)
+        {
+            fprintf(stderr, "unrecognized arg %s\n", kv);
+            continue;
+        }
+
+        // split k v
+        eqs[0] = '\0';
+        const char* key = kv;
+        char* value = eqs + 1;
+
+        if (strcmp(key, "shape") == 0)
+            inputs = parse_shape_list(value);
+        if (strcmp(key, "loop") == 0)
+            tuner.loop_count = atoi(value);
+        if (strcmp(key, "threads") == 0)
+            tuner.num_threads = atoi(value);
+    }
+
+    if (inputs.empty())
+    {
+        fprintf(stderr, "input tensor shape empty!\n");
+        return -1;
+    }
+
+    if (tuner.load(inparam, inbin) != 0)
+    {
+        fprintf(stderr, "load %s failed\n", inparam);
+        return -1;
+    }
+
+    int ret = 0;
+    if (strcmp(mode, "conv") == 0)
+    {
+        ret = tuner.tune_conv(inputs);
+        if (ret == 0)
+            ret = tuner.save_tuning(outpath);
+    }
+    else if (strcmp(mode, "gemm") == 0)
+    {
+        ret = tuner.tune_gemm(inputs);
+        if (ret == 0)
+            ret = tuner.save_param(outpath);
+    }
+    else
+    {
+        fprintf(stderr, "unknown mode %s\n", mode);
+        show_usage();
+        return -1;
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "tune %s failed\n", mode);
+        return -1;
+    }
+
+    return 0;
+}
@@ -259,6 +259,85 @@ pnnx.Output             output      1 0 out
 
 REGISTER_GLOBAL_PNNX_NCNN_GRAPH_REWRITER_PASS(F_scaled_dot_product_attention_4, 10)
 
+class F_scaled_dot_product_attention_5 : public F_scaled_dot_product_attention
+{
+public:
+    // huggingface style past_key_values, the new key value are appended to the cache along seqlen
+    const char* match_pattern_graph() const
+    {
+        return R"PNNXIR(7767517
+19 18
+pnnx.Input              input_0     0 1 input
+pnnx.Input              input_1     0 1 past_key
+pnnx.Input              input_2     0 1 past_value
+nn.Linear               op_0        1 1 input q bias=%qbias in_features=%qdim out_features=%embed_dim @bias @weight
+nn.Linear               op_1        1 1 input k bias=%kbias in_features=%kdim out_features=%embed_dim @bias @weight
+nn.Linear               op_2        1 1 input v bias=%vbias in_features=%vdim out_features=%embed_dim @bias @weight
+Tensor.view             op_3        1 1 q 10 shape=(%batch,%size,%num_heads,%feat_per_head)
+Tensor.view             op_4        1 1 k 12 shape=(%batch,%size,%num_heads,%feat_per_head)
+Tensor.view             op_5        1 1 v 14 shape=(%batch,%size,%num_heads,%feat_per_head)
+torch.transpose         op_6        1 1 10 16 dim0=1 dim1=2
+torch.transpose         op_7        1 1 12 17 dim0=1 dim1=2
+torch.transpose         op_8        1 1 14 18 dim0=1 dim1=2
+torch.cat               op_9        2 1 past_key 17 key dim=2
+torch.cat               op_10       2 1 past_value 18 value dim=2
+F.scaled_dot_product_attention sdpa 3 1 16 key value 19 %*=%*
+torch.transpose         op_11       1 1 19 20 dim0=1 dim1=2
+Tensor.reshape          op_12       1 1 20 21 shape=(%batch,%size,%embed_dim)
+nn.Linear               out_proj    1 1 21 out bias=%outbias in_features=%embed_dim out_features=%qdim @bias @weight
+pnnx.Output             output      3 0 out key value
+)PNNXIR";
+    }
+
+    void write(Operator* op, const std::map<std::string, Parameter>& captured_params, const std::map<std::string, Attribute>& captured_attrs) const
+    {
+        F_scaled_dot_product_attention::write(op, captured_params, captured_attrs);
+        op->params["5"] = 0;
+        op->params["7"] = 1;
+    }
+};
+
+REGISTER_GLOBAL_PNNX_NCNN_GRAPH_REWRITER_PASS(F_scaled_dot_product_attention_5, 10)
+
+class F_scaled_dot_product_attention_6 : public F_scaled_dot_product_attention
+{
+public:
+    const char* match_pattern_graph() const
+    {
+        return R"PNNXIR(7767517
+20 19
+pnnx.Input              input_0     0 1 input
+pnnx.Input              input_1     0 1 attn_mask
+pnnx.Input              input_2     0 1 past_key
+pnnx.Input              input_3     0 1 past_value
+nn.Linear               op_0        1 1 input q bias=%qbias in_features=%qdim out_features=%embed_dim @bias @weight
+nn.Linear               op_1        1 1 input k bias=%kbias in_features=%kdim out_features=%embed_dim @bias @weight
+nn.Linear               op_2        1 1 input v bias=%vbias in_features=%vdim out_features=%embed_dim @bias @weight
+Tensor.view             op_3        1 1 q 10 shape=(%batch,%size,%num_heads,%feat_per_head)
+Tensor.view             op_4        1 1 k 12 shape=(%batch,%size,%num_heads,%feat_per_head)
+Tensor.view             op_5        1 1 v 14 shape=(%batch,%size,%num_heads,%feat_per_head)
+torch.transpose         op_6        1 1 10 16 dim0=1 dim1=2
+torch.transpose         op_7        1 1 12 17 dim0=1 dim1=2
+torch.transpose         op_8        1 1 14 18 dim0=1 dim1=2
+torch.cat               op_9        2 1 past_key 17 key dim=2
+torch.cat               op_10       2 1 past_value 18 value dim=2
+F.scaled_dot_product_attention sdpa 4 1 16 key value attn_mask 19 %*=%*
+torch.transpose         op_11       1 1 19 20 dim0=1 dim1=2
+Tensor.reshape          op_12       1 1 20 21 shape=(%batch,%size,%embed_dim)
+nn.Linear               out_proj    1 1 21 out bias=%outbias in_features=%embed_dim out_features=%qdim @bias @weight
+pnnx.Output             output      3 0 out key value
+)PNNXIR";
+    }
+
+    void write(Operator* op, const std::map<std::string, Parameter>& captured_params, const std::map<std::string, Attribute>& captured_attrs) const
+    {
+        F_scaled_dot_product_attention::write(op, captured_params, captured_attrs);
+        op->params["7"] = 1;
+    }
+};
+
+REGISTER_GLOBAL_PNNX_NCNN_GRAPH_REWRITER_PASS(F_scaled_dot_product_attention_6, 10)
+
 } // namespace ncnn
 
 } // namespace pnnx
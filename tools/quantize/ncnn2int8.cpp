@@ -116,6 +116,8 @@ public:
 public:
     int quantize_convolution();
     int quantize_convolutiondepthwise();
+    int quantize_deconvolution();
+    int quantize_deconvolutiondepthwise();
     int quantize_innerproduct();
 
     int quantize_rnn();
@@ -254,6 +256,132 @@ int NetQuantize::quantize_convolutiondepthwise()
     return 0;
 }
 
+int NetQuantize::quantize_deconvolution()
+{
+    const int layer_count = static_cast<int>(layers.size());
+    for (int i = 0; i < layer_count; i++)
+    {
+        // find deconvolution layer
+        if (layers[i]->type != "Deconvolution")
+            continue;
+
+        // find deconvolution layer
+        std::map<std::string, ncnn::Mat>::iterator iter_data = blob_int8scale_table.find(layers[i]->name);
+        if (iter_data == blob_int8scale_table.end())
+            continue;
+
+        char key[256];
+        sprintf(key, "%s_param_0", layers[i]->name.c_str());
+
+        std::map<std::string, ncnn::Mat>::iterator iter = weight_int8scale_table.find(key);
+        if (iter == weight_int8scale_table.end())
+        {
+            fprintf(stderr, "this layer need to be quantized, but no scale param!\n");
+            return -1;
+        }
+
+        // Deconvolution - quantize weight from fp32 to int8
+        ncnn::Deconvolution* deconvolution = (ncnn::Deconvolution*)layers[i];
+
+        if (deconvolution->dynamic_weight)
+            continue;
+
+        ncnn::Mat bottom_blob_int8_scales = iter_data->second;
+        ncnn::Mat weight_data_int8_scales = iter->second;
+
+        fprintf(stderr, "quantize_deconvolution %s\n", deconvolution->name.c_str());
+
+        {
+            const int maxk = deconvolution->kernel_w * deconvolution->kernel_h;
+            const int num_input = deconvolution->weight_data_size / deconvolution->num_output / maxk;
+
+            ncnn::Mat weight_data_r2 = deconvolution->weight_data.reshape(maxk, num_input, deconvolution->num_output);
+
+            ncnn::Mat weight_data_int8;
+
+            ncnn::Option opt_q = opt;
+            opt_q.blob_allocator = deconvolution->weight_data.allocator;
+            opt_q.use_packing_layout = false;
+            ncnn::quantize_to_int8(weight_data_r2, weight_data_int8, weight_data_int8_scales, opt_q);
+            if (weight_data_int8.empty())
+                return -100;
+
+            deconvolution->weight_data = weight_data_int8.reshape(deconvolution->weight_data_size);
+        }
+
+        deconvolution->int8_scale_term = 1;
+        deconvolution->weight_data_int8_scales = weight_data_int8_scales;
+        deconvolution->bottom_blob_int8_scales = bottom_blob_int8_scales;
+    }
+
+    return 0;
+}
+
+int NetQuantize::quantize_deconvolutiondepthwise()
+{
+    const int layer_count = static_cast<int>(layers.size());
+    for (int i = 0; i < layer_count; i++)
+    {
+        // find deconvolutiondepthwise layer
+        if (layers[i]->type != "DeconvolutionDepthWise")
+            continue;
+
+        // find deconvolutiondepthwise layer
+        std::map<std::string, ncnn::Mat>::iterator iter_data = blob_int8scale_table.find(layers[i]->name);
+        if (iter_data == blob_int8scale_table.end())
+            continue;
+
+        char key[256];
+        sprintf(key, "%s_param_0", layers[i]->name.c_str());
+
+        std::map<std::string, ncnn::Mat>::iterator iter = weight_int8scale_table.find(key);
+        if (iter == weight_int8scale_table.end())
+        {
+            fprintf(stderr, "this layer need to be quantized, but no scale param!\n");
+            return -1;
+        }
+
+        // DeconvolutionDepthWise - quantize weight from fp32 to int8
+        ncnn::DeconvolutionDepthWise* deconvdw = (ncnn::DeconvolutionDepthWise*)layers[i];
+
+        if (deconvdw->dynamic_weight)
+            continue;
+
+        ncnn::Mat bottom_blob_int8_scales = iter_data->second;
+        ncnn::Mat weight_data_int8_scales = iter->second;
+
+        fprintf(stderr, "quantize_deconvolutiondepthwise %s\n", deconvdw->name.c_str());
+
+        {
+            ncnn::Mat int8_weight_data(deconvdw->weight_data_size, (size_t)1u);
+            if (int8_weight_data.empty())
+                return -100;
+
+            const int weight_data_size_g = deconvdw->weight_data_size / deconvdw->group;
+
+            for (int g = 0; g < deconvdw->group; g++)
+            {
+                ncnn::Option opt_q = opt;
+                opt_q.blob_allocator = int8_weight_data.allocator;
+                opt_q.use_packing_layout = false;
+
+                const ncnn::Mat weight_data_g = deconvdw->weight_data.range(weight_data_size_g * g, weight_data_size_g);
+                ncnn::Mat int8_weight_data_g = int8_weight_data.range(weight_data_size_g * g, weight_data_size_g);
+                const ncnn::Mat weight_data_int8_scales_g = weight_data_int8_scales.range(g, 1);
+                ncnn::quantize_to_int8(weight_data_g, int8_weight_data_g, weight_data_int8_scales_g, opt_q);
+            }
+
+            deconvdw->weight_data = int8_weight_data;
+        }
+
+        deconvdw->int8_scale_term = 1;
+        deconvdw->weight_data_int8_scales = weight_data_int8_scales;
+        deconvdw->bottom_blob_int8_scales = bottom_blob_int8_scales;
+    }
+
+    return 0;
+}
+
 int NetQuantize::quantize_innerproduct()
 {
     const int layer_count = static_cast<int>(layers.size());
@@ -1085,6 +1213,8 @@ int main(int argc, char** argv)
 
     quantizer.quantize_convolution();
     quantizer.quantize_convolutiondepthwise();
+    quantizer.quantize_deconvolution();
+    quantizer.quantize_deconvolutiondepthwise();
     quantizer.quantize_innerproduct();
 
     quantizer.quantize_rnn();